@@ -39,7 +39,7 @@ pub enum HotpathError {
 }
 
 /// 256-bit unsigned integer
-#[repr(C)]
+#[repr(C, align(32))]
 #[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
 pub struct U256 {
     pub limbs: [u64; 4],
@@ -85,8 +85,8 @@ impl From<u128> for U256 {
     }
 }
 
-/// Pool reserves
-#[repr(C)]
+/// Pool reserves (layout-identical to the C++ PoolReserves)
+#[repr(C, align(64))]
 #[derive(Debug, Clone, Copy, Default)]
 pub struct PoolReserves {
     pub reserve0: U256,
@@ -97,6 +97,8 @@ pub struct PoolReserves {
     pub decimals0: u8,
     pub decimals1: u8,
     _padding: [u8; 6],
+    pub token0_hash: u64,
+    pub token1_hash: u64,
 }
 
 impl PoolReserves {
@@ -113,12 +115,14 @@ impl PoolReserves {
             decimals0: 18,
             decimals1: 18,
             _padding: [0; 6],
+            token0_hash: 0,
+            token1_hash: 0,
         }
     }
 }
 
-/// Price calculation result
-#[repr(C)]
+/// Price calculation result (layout-identical to the C++ PriceResult)
+#[repr(C, align(32))]
 #[derive(Debug, Clone, Copy, Default)]
 pub struct PriceResult {
     pub price: U256,
@@ -129,22 +133,27 @@ pub struct PriceResult {
     _padding: [u8; 4],
 }
 
-/// Arbitrage opportunity
-#[repr(C)]
+/// Arbitrage opportunity (layout-identical to the C++ ArbitrageOpportunity)
+#[repr(C, align(64))]
 #[derive(Debug, Clone, Copy, Default)]
 pub struct ArbitrageOpportunity {
     pub buy_pool_id: u32,
     pub buy_dex_id: u32,
     pub sell_pool_id: u32,
     pub sell_dex_id: u32,
+    pub spread_bps: i64,
+    pub timestamp_ms: u64,
     pub buy_price: U256,
     pub sell_price: U256,
-    pub spread_bps: i64,
     pub max_amount: U256,
     pub estimated_profit: U256,
-    pub timestamp_ms: u64,
+    _padding: [u8; 32],
 }
 
+const _: () = assert!(std::mem::size_of::<PoolReserves>() == 128);
+const _: () = assert!(std::mem::size_of::<PriceResult>() == 64);
+const _: () = assert!(std::mem::size_of::<ArbitrageOpportunity>() == 192);
+
 impl ArbitrageOpportunity {
     pub fn is_profitable(&self) -> bool {
         !self.estimated_profit.is_zero()
@@ -441,6 +450,7 @@ impl OpportunityScanner {
             max_amount: trade_size,
             estimated_profit: profit,
             timestamp_ms: std::cmp::max(buy_pool.timestamp_ms, sell_pool.timestamp_ms),
+            _padding: [0; 32],
         }
     }
 }
@@ -7,9 +7,14 @@
 #include "price_calculator.hpp"
 #include "opportunity_scanner.hpp"
 #include "simd_math.hpp"
+#include "../bindings/ffi.hpp"
+#include <algorithm>
 #include <chrono>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <random>
+#include <utility>
 #include <vector>
 #include <iomanip>
 
@@ -95,23 +100,76 @@ void bench_batch_price_calculation() {
         batch.pools[i] = generate_random_pool(rng, static_cast<uint32_t>(i), 1);
     }
 
+    // Deep pools: 1e24..1e27 reserves, where reserve1 * 1e18 needs 256 bits
+    PoolBatch deep = batch;
+    std::uniform_int_distribution<uint64_t> scale(1'000'000, 1'000'000'000);
+    for (size_t i = 0; i < batch_size; ++i) {
+        deep.pools[i].reserve0 = U256::from_u128(static_cast<__uint128_t>(scale(rng)) * PRICE_PRECISION);
+        deep.pools[i].reserve1 = U256::from_u128(static_cast<__uint128_t>(scale(rng)) * PRICE_PRECISION);
+    }
+
+    const std::pair<const char*, const PoolBatch*> profiles[] = {{"1e12..1e18 reserves", &batch},
+                                                                 {"1e24..1e27 reserves", &deep}};
     PriceResult results[SIMD_BATCH_SIZE];
     const int iterations = 100'000;
     Timer timer;
 
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "  Batch size: " << batch_size << "\n";
+    std::cout << "  Iterations: " << iterations << "\n";
+    for (const auto& [name, pools] : profiles) {
+        timer.start();
+        for (int i = 0; i < iterations; ++i) {
+            calculate_prices_batch(*pools, results);
+        }
+        double elapsed = timer.elapsed_us();
+
+        std::cout << "  " << name << ":\n";
+        std::cout << "    Per batch: " << (elapsed * 1000.0 / iterations) << " ns\n";
+        std::cout << "    Per pool: " << (elapsed * 1000.0 / (iterations * batch_size)) << " ns\n";
+        std::cout << "    Pools/sec: " << (iterations * batch_size * 1'000'000.0 / elapsed) << "\n";
+    }
+}
+
+void bench_filtered_price_calculation() {
+    std::cout << "\n=== Filtered Price Calculation (1 in 8 pools moved) ===\n";
+
+    std::mt19937_64 rng(42);
+    BatchPriceCalculator calculator;
+    std::vector<double> references;
+    for (size_t i = 0; i < BatchPriceCalculator::max_capacity(); ++i) {
+        PoolReserves pool = generate_random_pool(rng, static_cast<uint32_t>(i), 1);
+        calculator.add_pool(pool);
+        // Last scan's price, 1% off for every eighth pool
+        const double price = simd::u256_to_double(calculate_price(pool).price);
+        references.push_back(i % 8 == 3 ? price * 1.01 : price);
+    }
+
+    std::vector<PriceResult> results(calculator.pool_count());
+    const int iterations = 10'000;
+    Timer timer;
+    const size_t pools = calculator.pool_count();
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "  Pools: " << pools << "\n";
+
     timer.start();
     for (int i = 0; i < iterations; ++i) {
-        calculate_prices_batch(batch, results);
+        volatile size_t n = calculator.process(results.data());
+        (void)n;
     }
-    double elapsed = timer.elapsed_us();
+    double all = timer.elapsed_us();
 
-    std::cout << std::fixed << std::setprecision(2);
-    std::cout << "  Batch size: " << batch_size << "\n";
-    std::cout << "  Iterations: " << iterations << "\n";
-    std::cout << "  Total time: " << elapsed << " us\n";
-    std::cout << "  Per batch: " << (elapsed * 1000.0 / iterations) << " ns\n";
-    std::cout << "  Per pool: " << (elapsed * 1000.0 / (iterations * batch_size)) << " ns\n";
-    std::cout << "  Pools/sec: " << (iterations * batch_size * 1'000'000.0 / elapsed) << "\n";
+    size_t kept = 0;
+    timer.start();
+    for (int i = 0; i < iterations; ++i) {
+        kept = calculator.process_filtered(references.data(), 50, results.data());
+    }
+    double filtered = timer.elapsed_us();
+
+    std::cout << "  process():          " << (all * 1000.0 / (iterations * pools)) << " ns/pool\n";
+    std::cout << "  process_filtered(): " << (filtered * 1000.0 / (iterations * pools)) << " ns/pool ("
+              << kept << " kept)\n";
 }
 
 void bench_swap_output_calculation() {
@@ -146,9 +204,12 @@ void bench_opportunity_scanning() {
     // Create scanner with many pools
     OpportunityScanner scanner;
 
+    // 25 token pairs, each listed on 4 DEXes
     const size_t pool_count = 100;
     for (size_t i = 0; i < pool_count; ++i) {
         auto pool = generate_random_pool(rng, static_cast<uint32_t>(i), static_cast<uint32_t>(i % 4));
+        pool.token0_hash = 1 + i / 4;
+        pool.token1_hash = 1000;
         scanner.update_pool(pool);
     }
 
@@ -170,6 +231,152 @@ void bench_opportunity_scanning() {
     std::cout << "  Per scan: " << (elapsed / iterations) << " us\n";
     std::cout << "  Scans/sec: " << (iterations * 1'000'000.0 / elapsed) << "\n";
     std::cout << "  Opportunities found (last scan): " << opportunities.size() << "\n";
+
+    // Streaming sinks: std::function vs an inlined lambda
+    size_t hits = 0;
+    const OpportunityScanner::OpportunityCallback callback = [&hits](const ArbitrageOpportunity&) { ++hits; };
+    timer.start();
+    for (int i = 0; i < iterations; ++i) {
+        scanner.scan_with_callback(callback);
+    }
+    double callback_elapsed = timer.elapsed_us();
+
+    timer.start();
+    for (int i = 0; i < iterations; ++i) {
+        scanner.scan_with([&hits](const ArbitrageOpportunity&) { ++hits; });
+    }
+    double sink_elapsed = timer.elapsed_us();
+    std::cout << "  scan_with_callback: " << (callback_elapsed / iterations) << " us/scan\n";
+    std::cout << "  scan_with (lambda): " << (sink_elapsed / iterations) << " us/scan\n";
+
+    // Kept best / top-K reads (no scan)
+    const int reads = 1'000'000;
+    ArbitrageOpportunity best;
+    ArbitrageOpportunity top[8];
+    size_t found = 0;
+    timer.start();
+    for (int i = 0; i < reads; ++i) {
+        found += scanner.get_best_opportunity(best) ? 1 : 0;
+        asm volatile("" : : "r"(&best) : "memory");
+    }
+    double best_elapsed = timer.elapsed_us();
+    timer.start();
+    for (int i = 0; i < reads / 10; ++i) {
+        found += scanner.top_opportunities(top, 8);
+        asm volatile("" : : "r"(top) : "memory");
+    }
+    double top_elapsed = timer.elapsed_us();
+    std::cout << "  get_best_opportunity: " << (best_elapsed * 1000.0 / reads) << " ns\n";
+    std::cout << "  top_opportunities(8): " << (top_elapsed * 10'000.0 / reads) << " ns\n";
+    if (found == 0 || hits == 0) std::cout << "  (no opportunities)\n";
+}
+
+void bench_scanner_updates() {
+    std::cout << "\n=== Scanner Pool Updates ===\n";
+
+    std::mt19937_64 rng(42);
+
+    // Production-sized book: 100k pools over 25k pairs
+    const size_t pool_count = 100'000;
+    ScannerCapacity capacity = default_scanner_capacity();
+    capacity.max_pools = pool_count;
+    capacity.max_pairs = pool_count / 4;
+    OpportunityScanner scanner(default_scanner_config(), capacity);
+
+    std::vector<PoolReserves> pools;
+    pools.reserve(pool_count);
+    for (size_t i = 0; i < pool_count; ++i) {
+        auto pool = generate_random_pool(rng, static_cast<uint32_t>(i), static_cast<uint32_t>(i % 4));
+        pool.token0_hash = 1 + i / 4;
+        pool.token1_hash = pool_count;
+        pools.push_back(pool);
+    }
+
+    Timer timer;
+    timer.start();
+    for (const auto& pool : pools) {
+        scanner.update_pool(pool);
+    }
+    double insert_elapsed = timer.elapsed_us();
+
+    // Reserve updates in random pool order
+    std::vector<uint32_t> order(pool_count);
+    for (size_t i = 0; i < pool_count; ++i) order[i] = static_cast<uint32_t>(i);
+    std::shuffle(order.begin(), order.end(), rng);
+
+    const int rounds = 10;
+    timer.start();
+    for (int r = 0; r < rounds; ++r) {
+        for (uint32_t i : order) {
+            pools[i].reserve1.limbs[0] += 1;
+            scanner.update_pool(pools[i]);
+        }
+    }
+    double update_elapsed = timer.elapsed_us();
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "  Pool count: " << scanner.pool_count() << " (" << scanner.pair_count() << " pairs)\n";
+    std::cout << "  Insert: " << (insert_elapsed * 1000.0 / pool_count) << " ns/pool\n";
+    std::cout << "  Update: " << (update_elapsed * 1000.0 / (rounds * pool_count)) << " ns/pool\n";
+}
+
+void bench_ffi_scanner_updates() {
+    std::cout << "\n=== FFI Scanner Updates (per pool vs batched vs ring) ===\n";
+
+    std::mt19937_64 rng(42);
+
+    const size_t pool_count = 100'000;
+    std::vector<ffi_pool_reserves_t> pools(pool_count);
+    for (size_t i = 0; i < pool_count; ++i) {
+        auto pool = generate_random_pool(rng, static_cast<uint32_t>(i), static_cast<uint32_t>(i % 4));
+        pool.token0_hash = 1 + i / 4;
+        pool.token1_hash = pool_count;
+        std::memcpy(static_cast<void*>(&pools[i]), &pool, sizeof(pool));
+    }
+
+    ffi_scanner_config_t config{};
+    config.min_spread_bps = 10;
+    ffi_scanner_capacity_t capacity{};
+    capacity.max_pools = pool_count;
+    capacity.max_pairs = pool_count / 4;
+
+    constexpr size_t ring_capacity = 4096;
+    const size_t ring_bytes = hotpath_pool_ring_bytes(ring_capacity);
+    void* ring = std::aligned_alloc(64, (ring_bytes + 63) / 64 * 64);
+    hotpath_pool_ring_init(ring, ring_bytes, ring_capacity);
+
+    const int rounds = 5;
+    double per_pool_ns[3] = {};
+    for (int mode = 0; mode < 3; ++mode) {
+        ffi_scanner_handle_t scanner = hotpath_scanner_create_with_capacity(&config, &capacity);
+        hotpath_scanner_update_pools(scanner, pools.data(), pools.size());   // Insert outside the timing
+
+        Timer timer;
+        timer.start();
+        for (int r = 0; r < rounds; ++r) {
+            if (mode == 0) {
+                for (const auto& pool : pools) hotpath_scanner_update_pool(scanner, &pool);
+            } else if (mode == 1) {
+                hotpath_scanner_update_pools(scanner, pools.data(), pools.size());
+            } else {
+                // Producer and consumer interleaved on one thread
+                for (size_t base = 0; base < pool_count; base += ring_capacity) {
+                    const size_t n = std::min(ring_capacity, pool_count - base);
+                    hotpath_pool_ring_push(ring, ring_bytes, pools.data() + base, n);
+                    hotpath_scanner_drain_ring(scanner, ring, ring_bytes, SIZE_MAX);
+                }
+            }
+        }
+        per_pool_ns[mode] = timer.elapsed_us() * 1000.0 / (rounds * pool_count);
+        hotpath_scanner_destroy(scanner);
+    }
+    std::free(ring);
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "  Pool count: " << pool_count << "\n";
+    std::cout << "  hotpath_scanner_update_pool:  " << per_pool_ns[0] << " ns/pool\n";
+    std::cout << "  hotpath_scanner_update_pools: " << per_pool_ns[1] << " ns/pool\n";
+    std::cout << "  ring push + drain:            " << per_pool_ns[2] << " ns/pool\n";
 }
 
 void bench_simd_operations() {
@@ -223,6 +430,62 @@ void bench_simd_operations() {
     std::cout << "  f64x4 div: " << (elapsed_div / iterations) << " ns/op\n";
 }
 
+void bench_batch_kernels() {
+    std::cout << "\n=== Batch Kernels (" << SIMD_BATCH_SIZE << " lanes) ===\n";
+
+    alignas(64) uint64_t a[SIMD_BATCH_SIZE];
+    alignas(64) uint64_t b[SIMD_BATCH_SIZE];
+    alignas(64) uint64_t c[SIMD_BATCH_SIZE];
+    alignas(64) double buy[SIMD_BATCH_SIZE];
+    alignas(64) double sell[SIMD_BATCH_SIZE];
+    alignas(64) double d[SIMD_BATCH_SIZE];
+    alignas(64) int64_t spreads[SIMD_BATCH_SIZE];
+    for (size_t i = 0; i < SIMD_BATCH_SIZE; ++i) {
+        a[i] = 0x123456789ABCDEFULL * (i + 1);
+        b[i] = 0xFEDCBA987654321ULL + i;
+        buy[i] = 1.0 + 0.01 * static_cast<double>(i);
+        sell[i] = 1.02 - 0.001 * static_cast<double>(i);
+    }
+
+    const int iterations = 10'000'000;
+    Timer timer;
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "  Dispatched: " << (simd::detected_level() == simd::SimdLevel::AVX512 ? "AVX-512" : "AVX2") << "\n";
+
+    const simd::SimdLevel levels[] = {simd::SimdLevel::AVX2, simd::SimdLevel::AVX512};
+    for (simd::SimdLevel level : levels) {
+        if (level == simd::SimdLevel::AVX512 && !simd::cpu_has_avx512()) continue;
+        const simd::BatchKernels& k = simd::kernels_for(level);
+        const char* name = level == simd::SimdLevel::AVX512 ? "AVX-512" : "AVX2";
+
+        timer.start();
+        for (int i = 0; i < iterations; ++i) {
+            k.cvt_u64_to_f64(a, d);
+            asm volatile("" : : "r"(d) : "memory");
+        }
+        double elapsed_cvt = timer.elapsed_ns();
+
+        timer.start();
+        for (int i = 0; i < iterations; ++i) {
+            k.mul_u64_low(a, b, c);
+            asm volatile("" : : "r"(c) : "memory");
+        }
+        double elapsed_mul = timer.elapsed_ns();
+
+        timer.start();
+        for (int i = 0; i < iterations; ++i) {
+            k.spread_bps(buy, sell, spreads);
+            asm volatile("" : : "r"(spreads) : "memory");
+        }
+        double elapsed_spread = timer.elapsed_ns();
+
+        std::cout << "  " << name << " cvt_u64_to_f64: " << (elapsed_cvt / iterations) << " ns/batch\n";
+        std::cout << "  " << name << " mul_u64_low: " << (elapsed_mul / iterations) << " ns/batch\n";
+        std::cout << "  " << name << " spread_bps: " << (elapsed_spread / iterations) << " ns/batch\n";
+    }
+}
+
 void bench_u256_operations() {
     std::cout << "\n=== U256 Operations ===\n";
 
@@ -277,11 +540,15 @@ int main() {
     std::cout << "  AVX-512: " << (hotpath_has_avx512() ? "YES" : "NO") << "\n";
 
     bench_simd_operations();
+    bench_batch_kernels();
     bench_u256_operations();
     bench_single_price_calculation();
     bench_batch_price_calculation();
+    bench_filtered_price_calculation();
     bench_swap_output_calculation();
     bench_opportunity_scanning();
+    bench_scanner_updates();
+    bench_ffi_scanner_updates();
 
     std::cout << "\n===========================================\n";
     std::cout << "   Benchmarks Complete\n";
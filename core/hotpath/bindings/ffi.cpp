@@ -7,17 +7,56 @@
 #include "types.hpp"
 #include "price_calculator.hpp"
 #include "opportunity_scanner.hpp"
+#include "simd_math.hpp"
+#include "pool_ring.hpp"
+#include <algorithm>
+#include <cstddef>
 #include <cstring>
 #include <vector>
 
-#ifdef _WIN32
-#include <intrin.h>
-#else
-#include <cpuid.h>
-#endif
-
 namespace {
 
+// ============================================================================
+// LAYOUT CHECKS
+// ============================================================================
+
+template<typename Ffi, typename Cpp>
+constexpr bool same_size_and_alignment = sizeof(Ffi) == sizeof(Cpp) && alignof(Ffi) == alignof(Cpp);
+
+static_assert(same_size_and_alignment<ffi_u256_t, matrix::hotpath::U256>);
+
+static_assert(same_size_and_alignment<ffi_pool_reserves_t, matrix::hotpath::PoolReserves>);
+static_assert(offsetof(ffi_pool_reserves_t, reserve1) == offsetof(matrix::hotpath::PoolReserves, reserve1));
+static_assert(offsetof(ffi_pool_reserves_t, timestamp_ms) == offsetof(matrix::hotpath::PoolReserves, timestamp_ms));
+static_assert(offsetof(ffi_pool_reserves_t, pool_id) == offsetof(matrix::hotpath::PoolReserves, pool_id));
+static_assert(offsetof(ffi_pool_reserves_t, dex_id) == offsetof(matrix::hotpath::PoolReserves, dex_id));
+static_assert(offsetof(ffi_pool_reserves_t, decimals0) == offsetof(matrix::hotpath::PoolReserves, decimals0));
+static_assert(offsetof(ffi_pool_reserves_t, decimals1) == offsetof(matrix::hotpath::PoolReserves, decimals1));
+static_assert(offsetof(ffi_pool_reserves_t, token0_hash) == offsetof(matrix::hotpath::PoolReserves, token0_hash));
+static_assert(offsetof(ffi_pool_reserves_t, token1_hash) == offsetof(matrix::hotpath::PoolReserves, token1_hash));
+
+static_assert(same_size_and_alignment<ffi_price_result_t, matrix::hotpath::PriceResult>);
+static_assert(offsetof(ffi_price_result_t, timestamp_ms) == offsetof(matrix::hotpath::PriceResult, timestamp_ms));
+static_assert(offsetof(ffi_price_result_t, pool_id) == offsetof(matrix::hotpath::PriceResult, pool_id));
+static_assert(offsetof(ffi_price_result_t, dex_id) == offsetof(matrix::hotpath::PriceResult, dex_id));
+static_assert(offsetof(ffi_price_result_t, confidence) == offsetof(matrix::hotpath::PriceResult, confidence));
+
+static_assert(same_size_and_alignment<ffi_arbitrage_opportunity_t, matrix::hotpath::ArbitrageOpportunity>);
+static_assert(offsetof(ffi_arbitrage_opportunity_t, buy_dex_id) == offsetof(matrix::hotpath::ArbitrageOpportunity, buy_dex_id));
+static_assert(offsetof(ffi_arbitrage_opportunity_t, sell_pool_id) == offsetof(matrix::hotpath::ArbitrageOpportunity, sell_pool_id));
+static_assert(offsetof(ffi_arbitrage_opportunity_t, sell_dex_id) == offsetof(matrix::hotpath::ArbitrageOpportunity, sell_dex_id));
+static_assert(offsetof(ffi_arbitrage_opportunity_t, spread_bps) == offsetof(matrix::hotpath::ArbitrageOpportunity, spread_bps));
+static_assert(offsetof(ffi_arbitrage_opportunity_t, timestamp_ms) == offsetof(matrix::hotpath::ArbitrageOpportunity, timestamp_ms));
+static_assert(offsetof(ffi_arbitrage_opportunity_t, buy_price) == offsetof(matrix::hotpath::ArbitrageOpportunity, buy_price));
+static_assert(offsetof(ffi_arbitrage_opportunity_t, sell_price) == offsetof(matrix::hotpath::ArbitrageOpportunity, sell_price));
+static_assert(offsetof(ffi_arbitrage_opportunity_t, max_amount) == offsetof(matrix::hotpath::ArbitrageOpportunity, max_amount));
+static_assert(offsetof(ffi_arbitrage_opportunity_t, estimated_profit) == offsetof(matrix::hotpath::ArbitrageOpportunity, estimated_profit));
+
+static_assert(same_size_and_alignment<ffi_pool_ring_header_t, matrix::hotpath::PoolRingHeader>);
+static_assert(offsetof(ffi_pool_ring_header_t, capacity) == offsetof(matrix::hotpath::PoolRingHeader, capacity));
+static_assert(offsetof(ffi_pool_ring_header_t, head) == offsetof(matrix::hotpath::PoolRingHeader, head));
+static_assert(offsetof(ffi_pool_ring_header_t, tail) == offsetof(matrix::hotpath::PoolRingHeader, tail));
+
 // ============================================================================
 // TYPE CONVERSION HELPERS
 // ============================================================================
@@ -34,40 +73,28 @@ ffi_u256_t to_ffi(const matrix::hotpath::U256& v) {
     return result;
 }
 
+/// Copy n layout-identical objects (one block copy, no per-field conversion)
+template<typename To, typename From>
+void copy_as(To* to, const From* from, size_t n) {
+    static_assert(same_size_and_alignment<To, From>);
+    std::memcpy(static_cast<void*>(to), static_cast<const void*>(from), n * sizeof(To));
+}
+
 matrix::hotpath::PoolReserves from_ffi(const ffi_pool_reserves_t& v) {
     matrix::hotpath::PoolReserves result;
-    result.reserve0 = from_ffi(v.reserve0);
-    result.reserve1 = from_ffi(v.reserve1);
-    result.timestamp_ms = v.timestamp_ms;
-    result.pool_id = v.pool_id;
-    result.dex_id = v.dex_id;
-    result.decimals0 = v.decimals0;
-    result.decimals1 = v.decimals1;
+    copy_as(&result, &v, 1);
     return result;
 }
 
 ffi_price_result_t to_ffi(const matrix::hotpath::PriceResult& v) {
     ffi_price_result_t result;
-    result.price = to_ffi(v.price);
-    result.timestamp_ms = v.timestamp_ms;
-    result.pool_id = v.pool_id;
-    result.dex_id = v.dex_id;
-    result.confidence = v.confidence;
+    copy_as(&result, &v, 1);
     return result;
 }
 
 ffi_arbitrage_opportunity_t to_ffi(const matrix::hotpath::ArbitrageOpportunity& v) {
     ffi_arbitrage_opportunity_t result;
-    result.buy_pool_id = v.buy_pool_id;
-    result.buy_dex_id = v.buy_dex_id;
-    result.sell_pool_id = v.sell_pool_id;
-    result.sell_dex_id = v.sell_dex_id;
-    result.buy_price = to_ffi(v.buy_price);
-    result.sell_price = to_ffi(v.sell_price);
-    result.spread_bps = v.spread_bps;
-    result.max_amount = to_ffi(v.max_amount);
-    result.estimated_profit = to_ffi(v.estimated_profit);
-    result.timestamp_ms = v.timestamp_ms;
+    copy_as(&result, &v, 1);
     return result;
 }
 
@@ -81,36 +108,57 @@ matrix::hotpath::ScannerConfig from_ffi(const ffi_scanner_config_t& v) {
     return result;
 }
 
+matrix::hotpath::ScannerCapacity from_ffi(const ffi_scanner_capacity_t& v) {
+    matrix::hotpath::ScannerCapacity result = matrix::hotpath::default_scanner_capacity();
+    if (v.max_pools != 0) result.max_pools = static_cast<size_t>(v.max_pools);
+    if (v.max_pairs != 0) result.max_pairs = static_cast<size_t>(v.max_pairs);
+    if (v.max_pools_per_pair != 0) result.max_pools_per_pair = static_cast<size_t>(v.max_pools_per_pair);
+    return result;
+}
+
 // ============================================================================
-// CPU FEATURE DETECTION
+// BATCH PRICING
 // ============================================================================
 
-bool detect_avx2() {
-#ifdef _WIN32
-    int cpuInfo[4];
-    __cpuidex(cpuInfo, 7, 0);
-    return (cpuInfo[1] & (1 << 5)) != 0; // AVX2 is bit 5 of EBX
-#else
-    unsigned int eax, ebx, ecx, edx;
-    if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) {
-        return (ebx & (1 << 5)) != 0;
-    }
-    return false;
-#endif
-}
-
-bool detect_avx512() {
-#ifdef _WIN32
-    int cpuInfo[4];
-    __cpuidex(cpuInfo, 7, 0);
-    return (cpuInfo[1] & (1 << 16)) != 0; // AVX-512F is bit 16 of EBX
-#else
-    unsigned int eax, ebx, ecx, edx;
-    if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) {
-        return (ebx & (1 << 16)) != 0;
+/// Transpose FFI pools straight into price lanes (no PoolReserves copy) and
+/// write the kept results, compacted
+size_t price_ffi_pools(
+    const ffi_pool_reserves_t* reserves,
+    size_t count,
+    const double* reference_prices,
+    int64_t min_deviation_bps,
+    ffi_price_result_t* results
+) {
+    using matrix::hotpath::SIMD_BATCH_SIZE;
+
+    matrix::hotpath::detail::ReserveLanes lanes{};
+    matrix::hotpath::detail::LanePrices prices;
+    size_t written = 0;
+
+    for (size_t base = 0; base < count; base += SIMD_BATCH_SIZE) {
+        const size_t block = std::min(SIMD_BATCH_SIZE, count - base);
+        for (size_t i = 0; i < block; ++i) {
+            lanes.set(i, reserves[base + i].reserve0.limbs, reserves[base + i].reserve1.limbs);
+        }
+
+        matrix::hotpath::detail::price_lanes(lanes, block,
+                                             reference_prices ? reference_prices + base : nullptr,
+                                             min_deviation_bps, prices);
+
+        for (size_t i = 0; i < block; ++i) {
+            if ((prices.kept & (1u << i)) == 0) continue;
+            const ffi_pool_reserves_t& pool = reserves[base + i];
+            ffi_price_result_t& result = results[written++];
+            result = ffi_price_result_t{};
+            result.price.limbs[0] = static_cast<uint64_t>(prices.price[i]);
+            result.price.limbs[1] = static_cast<uint64_t>(prices.price[i] >> 64);
+            result.timestamp_ms = pool.timestamp_ms;
+            result.pool_id = pool.pool_id;
+            result.dex_id = pool.dex_id;
+            result.confidence = prices.confidence[i];
+        }
     }
-    return false;
-#endif
+    return written;
 }
 
 } // anonymous namespace
@@ -143,35 +191,18 @@ size_t hotpath_calculate_prices_batch(
     ffi_price_result_t* results
 ) {
     if (!reserves || !results || count == 0) return 0;
+    return price_ffi_pools(reserves, count, nullptr, 0, results);
+}
 
-    try {
-        // Convert to C++ types
-        matrix::hotpath::PoolBatch batch;
-        size_t processed = 0;
-
-        while (processed < count) {
-            batch.count = std::min(matrix::hotpath::SIMD_BATCH_SIZE, count - processed);
-
-            for (size_t i = 0; i < batch.count; ++i) {
-                batch.pools[i] = from_ffi(reserves[processed + i]);
-            }
-
-            // Temporary storage for results
-            matrix::hotpath::PriceResult cpp_results[matrix::hotpath::SIMD_BATCH_SIZE];
-            matrix::hotpath::calculate_prices_batch(batch, cpp_results);
-
-            // Convert back to FFI types
-            for (size_t i = 0; i < batch.count; ++i) {
-                results[processed + i] = to_ffi(cpp_results[i]);
-            }
-
-            processed += batch.count;
-        }
-
-        return processed;
-    } catch (...) {
-        return 0;
-    }
+size_t hotpath_calculate_prices_filtered(
+    const ffi_pool_reserves_t* reserves,
+    size_t count,
+    const double* reference_prices,
+    int64_t min_deviation_bps,
+    ffi_price_result_t* results
+) {
+    if (!reserves || !reference_prices || !results || count == 0) return 0;
+    return price_ffi_pools(reserves, count, reference_prices, min_deviation_bps, results);
 }
 
 int32_t hotpath_calculate_swap_output(
@@ -247,18 +278,13 @@ size_t hotpath_batch_calculator_process(
     if (!handle || !results) return 0;
 
     auto* calc = static_cast<matrix::hotpath::BatchPriceCalculator*>(handle);
-    size_t count = std::min(calc->pool_count(), max_results);
-
-    // Allocate temporary C++ results
-    std::vector<matrix::hotpath::PriceResult> cpp_results(count);
-    size_t processed = calc->process(cpp_results.data());
 
-    // Convert to FFI
-    for (size_t i = 0; i < processed && i < max_results; ++i) {
-        results[i] = to_ffi(cpp_results[i]);
-    }
+    // process() writes every pool's result, so the buffer holds all of them
+    std::vector<matrix::hotpath::PriceResult> cpp_results(calc->pool_count());
+    size_t processed = std::min(calc->process(cpp_results.data()), max_results);
 
-    return std::min(processed, max_results);
+    copy_as(results, cpp_results.data(), processed);
+    return processed;
 }
 
 void hotpath_batch_calculator_clear(ffi_batch_calculator_handle_t handle) {
@@ -287,6 +313,19 @@ ffi_scanner_handle_t hotpath_scanner_create(const ffi_scanner_config_t* config)
     }
 }
 
+ffi_scanner_handle_t hotpath_scanner_create_with_capacity(
+    const ffi_scanner_config_t* config,
+    const ffi_scanner_capacity_t* capacity
+) {
+    try {
+        return new matrix::hotpath::OpportunityScanner(
+            config ? from_ffi(*config) : matrix::hotpath::default_scanner_config(),
+            capacity ? from_ffi(*capacity) : matrix::hotpath::default_scanner_capacity());
+    } catch (...) {
+        return nullptr;
+    }
+}
+
 void hotpath_scanner_destroy(ffi_scanner_handle_t handle) {
     delete static_cast<matrix::hotpath::OpportunityScanner*>(handle);
 }
@@ -301,6 +340,41 @@ void hotpath_scanner_update_pool(
     scanner->update_pool(from_ffi(*reserves));
 }
 
+void hotpath_scanner_update_pools(
+    ffi_scanner_handle_t handle,
+    const ffi_pool_reserves_t* reserves,
+    size_t count
+) {
+    if (!handle || !reserves) return;
+
+    auto* scanner = static_cast<matrix::hotpath::OpportunityScanner*>(handle);
+
+    // Block copies into a stack chunk, then one batched update per chunk
+    constexpr size_t CHUNK = 32;
+    matrix::hotpath::PoolReserves chunk[CHUNK];
+    for (size_t base = 0; base < count; base += CHUNK) {
+        const size_t n = std::min(CHUNK, count - base);
+        copy_as(chunk, reserves + base, n);
+        scanner->update_pools(chunk, n);
+    }
+}
+
+size_t hotpath_scanner_drain_ring(
+    ffi_scanner_handle_t handle,
+    void* ring,
+    size_t ring_bytes,
+    size_t max_pools
+) {
+    if (!handle || !ring) return 0;
+
+    try {
+        matrix::hotpath::PoolRing view(ring, ring_bytes);
+        return static_cast<matrix::hotpath::OpportunityScanner*>(handle)->drain(view, max_pools);
+    } catch (...) {
+        return 0;
+    }
+}
+
 size_t hotpath_scanner_scan(
     ffi_scanner_handle_t handle,
     ffi_arbitrage_opportunity_t* opportunities,
@@ -309,13 +383,13 @@ size_t hotpath_scanner_scan(
     if (!handle || !opportunities) return 0;
 
     auto* scanner = static_cast<matrix::hotpath::OpportunityScanner*>(handle);
-    std::vector<matrix::hotpath::ArbitrageOpportunity> cpp_opps;
+
+    // Reused across calls: no allocation once it has grown
+    thread_local std::vector<matrix::hotpath::ArbitrageOpportunity> cpp_opps;
     scanner->scan(cpp_opps);
 
     size_t count = std::min(cpp_opps.size(), max_opportunities);
-    for (size_t i = 0; i < count; ++i) {
-        opportunities[i] = to_ffi(cpp_opps[i]);
-    }
+    copy_as(opportunities, cpp_opps.data(), count);
 
     return count;
 }
@@ -337,6 +411,23 @@ int32_t hotpath_scanner_get_best(
     return 0;
 }
 
+size_t hotpath_scanner_top_opportunities(
+    ffi_scanner_handle_t handle,
+    ffi_arbitrage_opportunity_t* opportunities,
+    size_t max_opportunities
+) {
+    if (!handle || !opportunities) return 0;
+
+    auto* scanner = static_cast<matrix::hotpath::OpportunityScanner*>(handle);
+
+    // At most one per pair; reused across calls like hotpath_scanner_scan's
+    thread_local std::vector<matrix::hotpath::ArbitrageOpportunity> cpp_opps;
+    cpp_opps.resize(std::min(max_opportunities, scanner->pair_count()));
+    const size_t count = scanner->top_opportunities(cpp_opps.data(), cpp_opps.size());
+    copy_as(opportunities, cpp_opps.data(), count);
+    return count;
+}
+
 void hotpath_scanner_clear(ffi_scanner_handle_t handle) {
     if (!handle) return;
     static_cast<matrix::hotpath::OpportunityScanner*>(handle)->clear();
@@ -357,6 +448,41 @@ void hotpath_scanner_set_config(
     scanner->set_config(from_ffi(*config));
 }
 
+// ============================================================================
+// POOL UPDATE RING
+// ============================================================================
+
+size_t hotpath_pool_ring_bytes(size_t capacity) {
+    return matrix::hotpath::PoolRing::bytes_for(capacity);
+}
+
+int32_t hotpath_pool_ring_init(void* memory, size_t bytes, size_t capacity) {
+    try {
+        matrix::hotpath::PoolRing::format(memory, bytes, capacity);
+        return 0;
+    } catch (...) {
+        return -1;
+    }
+}
+
+size_t hotpath_pool_ring_push(
+    void* ring,
+    size_t ring_bytes,
+    const ffi_pool_reserves_t* reserves,
+    size_t count
+) {
+    if (!ring || !reserves) return 0;
+
+    try {
+        matrix::hotpath::PoolRing view(ring, ring_bytes);
+        // push() only block-copies its input, so the layout-identical FFI
+        // array goes straight in
+        return view.push(reinterpret_cast<const matrix::hotpath::PoolReserves*>(reserves), count);
+    } catch (...) {
+        return 0;
+    }
+}
+
 // ============================================================================
 // UTILITY FUNCTIONS
 // ============================================================================
@@ -366,11 +492,11 @@ const char* hotpath_version() {
 }
 
 int32_t hotpath_has_avx2() {
-    return detect_avx2() ? 1 : 0;
+    return matrix::hotpath::simd::cpu_has_avx2() ? 1 : 0;
 }
 
 int32_t hotpath_has_avx512() {
-    return detect_avx512() ? 1 : 0;
+    return matrix::hotpath::simd::cpu_has_avx512() ? 1 : 0;
 }
 
 } // extern "C"
@@ -26,14 +26,19 @@ extern "C" {
 // ============================================================================
 // FFI TYPES (C-compatible versions of C++ types)
 // ============================================================================
+//
+// The pool, price, opportunity and ring header types are layout-identical
+// to their C++ counterparts (size, alignment and field offsets are checked
+// in ffi.cpp), so arrays of them cross the boundary as one block copy.
+// Bindings must mirror the alignment (e.g. #[repr(C, align(64))] in Rust).
 
 /// 256-bit unsigned integer (C-compatible)
-typedef struct {
+typedef struct alignas(32) {
     uint64_t limbs[4];
 } ffi_u256_t;
 
-/// Pool reserves (C-compatible)
-typedef struct {
+/// Pool reserves (C-compatible, 128 bytes)
+typedef struct alignas(64) {
     ffi_u256_t reserve0;
     ffi_u256_t reserve1;
     uint64_t timestamp_ms;
@@ -42,10 +47,12 @@ typedef struct {
     uint8_t decimals0;
     uint8_t decimals1;
     uint8_t _padding[6];
+    uint64_t token0_hash;   // Hash of token0's address (0 if unknown)
+    uint64_t token1_hash;   // Hash of token1's address (0 if unknown)
 } ffi_pool_reserves_t;
 
-/// Price result (C-compatible)
-typedef struct {
+/// Price result (C-compatible, 64 bytes)
+typedef struct alignas(32) {
     ffi_u256_t price;
     uint64_t timestamp_ms;
     uint32_t pool_id;
@@ -54,20 +61,37 @@ typedef struct {
     uint8_t _padding[4];
 } ffi_price_result_t;
 
-/// Arbitrage opportunity (C-compatible)
-typedef struct {
+/// Arbitrage opportunity (C-compatible, 192 bytes)
+typedef struct alignas(64) {
     uint32_t buy_pool_id;
     uint32_t buy_dex_id;
     uint32_t sell_pool_id;
     uint32_t sell_dex_id;
+    int64_t spread_bps;
+    uint64_t timestamp_ms;
     ffi_u256_t buy_price;
     ffi_u256_t sell_price;
-    int64_t spread_bps;
     ffi_u256_t max_amount;
     ffi_u256_t estimated_profit;
-    uint64_t timestamp_ms;
+    uint8_t _padding[32];
 } ffi_arbitrage_opportunity_t;
 
+/**
+ * Pool update ring header (C-compatible, 192 bytes)
+ *
+ * A ring is one 64-byte aligned region: this header, then capacity
+ * ffi_pool_reserves_t slots. The producer writes slots
+ * [head, head + n) mod capacity, then stores head + n with release
+ * ordering; the consumer reads up to head (acquire) and stores its new
+ * tail (release). Format it with hotpath_pool_ring_init.
+ */
+typedef struct alignas(64) {
+    uint64_t magic;
+    uint64_t capacity;                  // Slots (a power of two)
+    alignas(64) uint64_t head;          // Slots published (producer)
+    alignas(64) uint64_t tail;          // Slots consumed (scanner)
+} ffi_pool_ring_header_t;
+
 /// Scanner configuration (C-compatible)
 typedef struct {
     int64_t min_spread_bps;
@@ -77,6 +101,13 @@ typedef struct {
     uint8_t include_same_dex;
 } ffi_scanner_config_t;
 
+/// Scanner storage limits (C-compatible; 0 keeps a field's default)
+typedef struct {
+    uint64_t max_pools;
+    uint64_t max_pairs;
+    uint64_t max_pools_per_pair;
+} ffi_scanner_capacity_t;
+
 /// Opaque scanner handle
 typedef void* ffi_scanner_handle_t;
 
@@ -100,6 +131,9 @@ HOTPATH_API int32_t hotpath_calculate_price(
 
 /**
  * @brief Calculate prices for a batch of pools
+ *
+ * Exact (same results as hotpath_calculate_price), eight pools per SIMD step.
+ *
  * @param reserves Array of pool reserves
  * @param count Number of pools
  * @param results Output array for results
@@ -111,6 +145,28 @@ HOTPATH_API size_t hotpath_calculate_prices_batch(
     ffi_price_result_t* results
 );
 
+/**
+ * @brief Calculate prices only for pools that moved
+ *
+ * Pools whose approximate price lies within min_deviation_bps of their
+ * reference are skipped before any exact math; a reference <= 0 always
+ * passes. Kept pools are priced exactly, as in hotpath_calculate_prices_batch.
+ *
+ * @param reserves Array of pool reserves
+ * @param count Number of pools
+ * @param reference_prices count reference prices (10^18 scale, like price)
+ * @param min_deviation_bps Deviation a pool must exceed to be kept
+ * @param results Output array (room for count results), compacted in input order
+ * @return Number of results written
+ */
+HOTPATH_API size_t hotpath_calculate_prices_filtered(
+    const ffi_pool_reserves_t* reserves,
+    size_t count,
+    const double* reference_prices,
+    int64_t min_deviation_bps,
+    ffi_price_result_t* results
+);
+
 /**
  * @brief Calculate swap output amount
  * @param reserve_in Input reserve
@@ -203,6 +259,17 @@ HOTPATH_API size_t hotpath_batch_calculator_pool_count(ffi_batch_calculator_hand
  */
 HOTPATH_API ffi_scanner_handle_t hotpath_scanner_create(const ffi_scanner_config_t* config);
 
+/**
+ * @brief Create a new opportunity scanner with explicit storage limits
+ * @param config Scanner configuration (NULL for defaults)
+ * @param capacity Storage limits (NULL for defaults)
+ * @return Scanner handle, or NULL on failure (including invalid limits)
+ */
+HOTPATH_API ffi_scanner_handle_t hotpath_scanner_create_with_capacity(
+    const ffi_scanner_config_t* config,
+    const ffi_scanner_capacity_t* capacity
+);
+
 /**
  * @brief Destroy an opportunity scanner
  * @param handle Scanner handle
@@ -219,6 +286,34 @@ HOTPATH_API void hotpath_scanner_update_pool(
     const ffi_pool_reserves_t* reserves
 );
 
+/**
+ * @brief Update many pools in one call (same as hotpath_scanner_update_pool
+ *        on each, in order)
+ * @param handle Scanner handle
+ * @param reserves Array of pool reserves
+ * @param count Number of pools
+ */
+HOTPATH_API void hotpath_scanner_update_pools(
+    ffi_scanner_handle_t handle,
+    const ffi_pool_reserves_t* reserves,
+    size_t count
+);
+
+/**
+ * @brief Apply pools published to a ring
+ * @param handle Scanner handle
+ * @param ring Ring memory (formatted by hotpath_pool_ring_init)
+ * @param ring_bytes Size of the ring memory
+ * @param max_pools Most pools to apply in this call
+ * @return Pools applied (0 if the ring is empty or invalid)
+ */
+HOTPATH_API size_t hotpath_scanner_drain_ring(
+    ffi_scanner_handle_t handle,
+    void* ring,
+    size_t ring_bytes,
+    size_t max_pools
+);
+
 /**
  * @brief Scan for opportunities
  * @param handle Scanner handle
@@ -233,7 +328,7 @@ HOTPATH_API size_t hotpath_scanner_scan(
 );
 
 /**
- * @brief Get best opportunity
+ * @brief Get best opportunity (kept current by pool updates; no scan)
  * @param handle Scanner handle
  * @param opportunity Output for best opportunity
  * @return 1 if found, 0 if no opportunity
@@ -243,6 +338,19 @@ HOTPATH_API int32_t hotpath_scanner_get_best(
     ffi_arbitrage_opportunity_t* opportunity
 );
 
+/**
+ * @brief Get the best opportunity of each of the most profitable token pairs
+ * @param handle Scanner handle
+ * @param opportunities Output array, most profitable first
+ * @param max_opportunities Most opportunities to return
+ * @return Number written
+ */
+HOTPATH_API size_t hotpath_scanner_top_opportunities(
+    ffi_scanner_handle_t handle,
+    ffi_arbitrage_opportunity_t* opportunities,
+    size_t max_opportunities
+);
+
 /**
  * @brief Clear all pools from scanner
  * @param handle Scanner handle
@@ -266,6 +374,40 @@ HOTPATH_API void hotpath_scanner_set_config(
     const ffi_scanner_config_t* config
 );
 
+// ============================================================================
+// POOL UPDATE RING
+// ============================================================================
+
+/**
+ * @brief Bytes needed for a ring of capacity slots
+ */
+HOTPATH_API size_t hotpath_pool_ring_bytes(size_t capacity);
+
+/**
+ * @brief Format memory as an empty ring
+ * @param memory 64-byte aligned region (heap, or mapped shared memory)
+ * @param bytes Size of the region (at least hotpath_pool_ring_bytes(capacity))
+ * @param capacity Slots (a power of two)
+ * @return 0 on success, non-zero on error
+ */
+HOTPATH_API int32_t hotpath_pool_ring_init(void* memory, size_t bytes, size_t capacity);
+
+/**
+ * @brief Publish pools to a ring (for producers that do not write the
+ *        slots themselves; one producer per ring)
+ * @param ring Ring memory
+ * @param ring_bytes Size of the ring memory
+ * @param reserves Array of pool reserves
+ * @param count Number of pools
+ * @return Pools published: fewer than count once the ring is full
+ */
+HOTPATH_API size_t hotpath_pool_ring_push(
+    void* ring,
+    size_t ring_bytes,
+    const ffi_pool_reserves_t* reserves,
+    size_t count
+);
+
 // ============================================================================
 // UTILITY FUNCTIONS
 // ============================================================================
@@ -283,7 +425,9 @@ HOTPATH_API const char* hotpath_version();
 HOTPATH_API int32_t hotpath_has_avx2();
 
 /**
- * @brief Check if AVX-512 is supported
+ * @brief Check if AVX-512 (F + DQ) is supported
+ *
+ * When it is, the batch kernels run at 8 lanes per instruction instead of 4.
  * @return 1 if supported, 0 if not
  */
 HOTPATH_API int32_t hotpath_has_avx512();
@@ -9,8 +9,11 @@
 
 #include "types.hpp"
 #include "price_calculator.hpp"
-#include <vector>
+#include "pool_ring.hpp"
+#include <algorithm>
 #include <functional>
+#include <iterator>
+#include <vector>
 
 namespace matrix::hotpath {
 
@@ -23,6 +26,25 @@ namespace matrix::hotpath {
  *
  * Scans multiple pools in parallel to find profitable arbitrage opportunities.
  * Uses SIMD instructions for price comparison and profit calculation.
+ *
+ * Pools are found by (pool_id, dex_id) through a flat open-addressing
+ * index, and grouped by their token pair (token0_hash, token1_hash) in a
+ * second one, so an update costs O(1) regardless of the pool count. Only
+ * pools of the same pair are compared. A pool is stored in its pair's
+ * canonical orientation (the lower token hash as token0), so pools listing
+ * the pair the other way round share one price direction; opportunities
+ * report prices in that orientation. Pools without a known pair (equal
+ * token hashes, e.g. both 0) are tracked and priced but never compared.
+ *
+ * All storage is sized from ScannerCapacity up front; updates that would
+ * exceed it are dropped (new pools) or left ungrouped (new pairs, full
+ * groups).
+ *
+ * Each pair's best opportunity is kept current as pools update: a new
+ * price is only compared against the rest of its own pair, and the whole
+ * pair is re-evaluated only when its best involved the updated pool. The
+ * pairs with an opportunity sit in a max-heap on profit, so the best
+ * opportunity is an O(1) read and the best K pairs cost O(K log K).
  */
 class OpportunityScanner {
 public:
@@ -32,8 +54,12 @@ public:
     /**
      * @brief Create scanner with configuration
      * @param config Scanner configuration
+     * @param capacity Storage limits
+     * @throws std::invalid_argument if a capacity is 0 or above MAX_CAPACITY,
+     *         or max_pairs * max_pools_per_pair exceeds UINT32_MAX
      */
-    explicit OpportunityScanner(const ScannerConfig& config = default_scanner_config());
+    explicit OpportunityScanner(const ScannerConfig& config = default_scanner_config(),
+                                const ScannerCapacity& capacity = default_scanner_capacity());
 
     ~OpportunityScanner();
 
@@ -41,15 +67,38 @@ public:
     OpportunityScanner(const OpportunityScanner&) = delete;
     OpportunityScanner& operator=(const OpportunityScanner&) = delete;
 
+    /// Largest supported value of each capacity
+    static constexpr size_t MAX_CAPACITY = size_t{1} << 30;
+
     /**
      * @brief Update pool reserves
      *
      * Updates internal pool state. Should be called whenever new price data arrives.
+     * A pool whose token pair changed moves to the new pair's group.
      *
      * @param reserves New pool reserves
      */
     void update_pool(const PoolReserves& reserves);
 
+    /**
+     * @brief Update many pools (same as update_pool on each, in order)
+     *
+     * Prefetches the index slots of upcoming pools while the current one is
+     * applied, hiding most of the lookup misses at large pool counts.
+     *
+     * @param pools Pool reserves
+     * @param count Number of pools
+     */
+    void update_pools(const PoolReserves* pools, size_t count);
+
+    /**
+     * @brief Apply pools published to a ring (the ring's consumer)
+     * @param ring Ring to drain
+     * @param max_pools Most pools to take in this call
+     * @return Pools applied
+     */
+    size_t drain(PoolRing& ring, size_t max_pools = SIZE_MAX);
+
     /**
      * @brief Scan for arbitrage opportunities
      *
@@ -71,15 +120,41 @@ public:
      */
     size_t scan_with_callback(const OpportunityCallback& callback);
 
+    /**
+     * @brief Scan with an inlinable sink
+     *
+     * Same as scan_with_callback, but sink(const ArbitrageOpportunity&) is
+     * a template parameter, so a lambda is inlined into the scan instead of
+     * being called through std::function per opportunity.
+     *
+     * @param sink Called for each opportunity
+     * @return Number of opportunities found
+     */
+    template<typename Sink>
+    size_t scan_with(Sink&& sink);
+
     /**
      * @brief Get best opportunity (if any)
      *
-     * Returns the most profitable opportunity found in the current state.
+     * Returns the most profitable opportunity in the current state, kept up
+     * to date by update_pool (O(1)).
      *
      * @param out_opportunity Output for best opportunity
      * @return true if an opportunity was found
      */
-    bool get_best_opportunity(ArbitrageOpportunity& out_opportunity);
+    bool get_best_opportunity(ArbitrageOpportunity& out_opportunity) const;
+
+    /**
+     * @brief Get the best opportunity of each of the most profitable pairs
+     *
+     * One opportunity per token pair: opportunities on the same pair
+     * compete for the same price gap.
+     *
+     * @param out Output array, most profitable first
+     * @param max_count Most opportunities to return (K)
+     * @return Number written
+     */
+    size_t top_opportunities(ArbitrageOpportunity* out, size_t max_count) const;
 
     /**
      * @brief Clear all pool data
@@ -91,6 +166,11 @@ public:
      */
     size_t pool_count() const;
 
+    /**
+     * @brief Get number of token pairs with at least one grouped pool
+     */
+    size_t pair_count() const { return pair_groups_.size(); }
+
     /**
      * @brief Update configuration
      */
@@ -101,14 +181,27 @@ public:
      */
     const ScannerConfig& config() const { return config_; }
 
+    /**
+     * @brief Get storage limits
+     */
+    const ScannerCapacity& capacity() const { return capacity_; }
+
 private:
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    /// Groups below this size are compared scalar
+    static constexpr uint32_t SIMD_SCAN_MIN = 4;
+
     struct PoolEntry {
-        PoolReserves reserves;
+        PoolReserves reserves;  // Canonical orientation
         PriceResult price;
+        double price_f64;       // price, for spread comparisons
+        uint32_t group;         // Index into pair_groups_, NONE if ungrouped
+        uint32_t member;        // Slot among the group's members
         bool valid;
     };
 
-    // Token pair identifier for grouping pools
+    // Token pair identifier for grouping pools (token0_hash < token1_hash)
     struct TokenPair {
         uint64_t token0_hash; // Hash of token0 address
         uint64_t token1_hash; // Hash of token1 address
@@ -118,37 +211,88 @@ private:
         }
     };
 
-    struct TokenPairHash {
-        size_t operator()(const TokenPair& p) const {
-            return p.token0_hash ^ (p.token1_hash << 1);
-        }
+    // Index slots (linear probing, no deletion)
+    struct PoolSlot {
+        uint64_t key;     // pool_id << 32 | dex_id
+        uint32_t pool;    // Index into pools_, NONE if empty
     };
 
-    ScannerConfig config_;
-
-    // Pool storage - grouped by token pair for efficient scanning
-    static constexpr size_t MAX_POOLS = 4096;
-    static constexpr size_t MAX_PAIRS = 512;
-
-    // Flat array storage for cache efficiency
-    alignas(64) PoolEntry pools_[MAX_POOLS];
-    size_t pool_count_;
+    struct PairSlot {
+        TokenPair pair;
+        uint32_t group;   // Index into pair_groups_, NONE if empty
+    };
 
-    // Pair grouping for efficient scanning
+    // Members of a group: group_pools_[first, first + count)
     struct PairGroup {
         TokenPair pair;
-        uint32_t pool_indices[32]; // Indices into pools_ array
-        uint8_t count;
+        uint32_t first;
+        uint32_t count;
+    };
+
+    ScannerConfig config_;
+    ScannerCapacity capacity_;
+
+    std::vector<PoolEntry> pools_;
+    std::vector<PoolSlot> pool_index_;
+    std::vector<PairGroup> pair_groups_;
+    std::vector<PairSlot> pair_index_;
+    std::vector<uint32_t> group_pools_;   // max_pools_per_pair slots per group
+    std::vector<double> member_prices_;   // price_f64 of each group_pools_ slot
+
+    // SIMD scan scratch: one group's prices, zero-padded to whole batches
+    std::vector<double> group_prices_;
+
+    // Best opportunity per group (buy == NONE: the group has none)
+    struct GroupBest {
+        ArbitrageOpportunity opportunity;
+        uint32_t buy;     // Pool indices
+        uint32_t sell;
+    };
+    std::vector<GroupBest> group_best_;
+
+    // Groups with an opportunity, as a max-heap on profit. Entries carry
+    // their profit so sifting stays inside the heap array
+    struct HeapEntry {
+        U256 profit;
+        uint32_t group;
     };
-    PairGroup pair_groups_[MAX_PAIRS];
-    size_t pair_count_;
+    std::vector<HeapEntry> best_heap_;
+    std::vector<uint32_t> heap_slot_;     // Group -> position in best_heap_, NONE if absent
+    mutable std::vector<uint32_t> top_frontier_;
 
     // Internal methods
+    static uint64_t pool_key(uint32_t pool_id, uint32_t dex_id) {
+        return (static_cast<uint64_t>(pool_id) << 32) | dex_id;
+    }
+    uint32_t find_or_add_pool(uint32_t pool_id, uint32_t dex_id);
+    uint32_t find_or_add_group(const TokenPair& pair);
+    void add_to_group(uint32_t pool_index, const TokenPair& pair);
+    void remove_from_group(uint32_t pool_index);
     void recalculate_price(size_t pool_index);
-    void scan_pair_group(const PairGroup& group, std::vector<ArbitrageOpportunity>& out);
-    void scan_pair_group_simd(const PairGroup& group, const OpportunityCallback& callback);
-    int64_t calculate_spread_bps(const PriceResult& buy, const PriceResult& sell);
+    const uint32_t* members(const PairGroup& group) const { return group_pools_.data() + group.first; }
+    const double* member_prices(const PairGroup& group) const { return member_prices_.data() + group.first; }
+
+    /// Calls hit(buy, sell, spread_bps) for every ordered pair of the
+    /// group's pools whose spread reaches min_spread_bps
+    template<typename Hit>
+    void for_each_spread(const PairGroup& group, Hit&& hit);
+
+    /// Builds the buy -> sell opportunity; false if it fails the criteria
+    bool make_opportunity(uint32_t buy, uint32_t sell, int64_t spread_bps, ArbitrageOpportunity& out) const;
     bool meets_criteria(const ArbitrageOpportunity& opp) const;
+
+    // Incremental best-opportunity maintenance
+    void refresh_group(uint32_t group_index);
+    void refresh_pool(uint32_t group_index, uint32_t pool_index);
+    void refresh_all();
+    void offer(uint32_t buy, uint32_t sell, int64_t spread_bps, GroupBest& best) const;
+    static bool better(const HeapEntry& a, const HeapEntry& b) {
+        return simd::cmp_u256(a.profit, b.profit) > 0;
+    }
+    void heap_update(uint32_t group_index);
+    void heap_remove(uint32_t position);
+    void heap_sift_up(uint32_t position);
+    void heap_sift_down(uint32_t position);
 };
 
 // ============================================================================
@@ -164,7 +308,8 @@ inline int64_t spread_bps_fast(double buy_price, double sell_price) {
     return static_cast<int64_t>((sell_price - buy_price) / buy_price * 10000.0);
 }
 
-/// SIMD spread calculation for 4 price pairs
+/// SIMD spread calculation for 4 price pairs (0 where buy_price <= 0,
+/// like spread_bps_fast); simd::spread_bps_x8 does 8 at the CPU's width
 inline void spread_bps_x4(
     const double* buy_prices,
     const double* sell_prices,
@@ -178,15 +323,74 @@ inline void spread_bps_x4(
     f64x4 ratio = simd::div_f64x4(diff, buy);
     f64x4 bps = simd::mul_f64x4(ratio, _mm256_set1_pd(10000.0));
 
-    // Convert to int64 (scalar, as AVX2 doesn't have direct f64->i64)
-    alignas(32) double bps_vals[4];
-    simd::store_f64x4(bps_vals, bps);
+    f64x4 valid = _mm256_cmp_pd(buy, _mm256_setzero_pd(), _CMP_GT_OQ);
+    u64x4 spreads = simd::and_u64x4(simd::cvt_f64x4_to_i64x4(bps), _mm256_castpd_si256(valid));
+    simd::store_unaligned(reinterpret_cast<uint64_t*>(spreads_out), spreads);
+}
+
+} // namespace detail
+
+// ============================================================================
+// TEMPLATE IMPLEMENTATION
+// ============================================================================
 
-    for (int i = 0; i < 4; ++i) {
-        spreads_out[i] = static_cast<int64_t>(bps_vals[i]);
+template<typename Sink>
+size_t OpportunityScanner::scan_with(Sink&& sink) {
+    size_t count = 0;
+    ArbitrageOpportunity opp;
+
+    for (const auto& group : pair_groups_) {
+        if (group.count < 2) continue;
+        for_each_spread(group, [&](uint32_t buy, uint32_t sell, int64_t spread) {
+            if (make_opportunity(buy, sell, spread, opp)) {
+                sink(static_cast<const ArbitrageOpportunity&>(opp));
+                ++count;
+            }
+        });
     }
+
+    return count;
 }
 
-} // namespace detail
+template<typename Hit>
+void OpportunityScanner::for_each_spread(const PairGroup& group, Hit&& hit) {
+    const uint32_t* pool_indices = members(group);
+    const double* member_price = member_prices(group);
+    const uint32_t count = group.count;
+
+    if (count < SIMD_SCAN_MIN) {
+        // Scalar for small groups
+        for (uint32_t a = 0; a < count; ++a) {
+            for (uint32_t b = 0; b < count; ++b) {
+                if (a == b) continue;
+                const int64_t spread = detail::spread_bps_fast(member_price[a], member_price[b]);
+                if (spread >= config_.min_spread_bps) hit(pool_indices[a], pool_indices[b], spread);
+            }
+        }
+        return;
+    }
+
+    // Extract prices (zero-padded to whole batches)
+    double* prices = group_prices_.data();
+    std::copy(member_price, member_price + count, prices);
+    std::fill(prices + count, prices + (count + SIMD_BATCH_SIZE - 1) / SIMD_BATCH_SIZE * SIMD_BATCH_SIZE, 0.0);
+
+    // Compare prices SIMD_BATCH_SIZE at a time at the CPU's vector width
+    for (uint32_t a = 0; a < count; ++a) {
+        alignas(64) double price_a[SIMD_BATCH_SIZE];
+        std::fill(std::begin(price_a), std::end(price_a), prices[a]);
+
+        for (uint32_t b = 0; b < count; b += SIMD_BATCH_SIZE) {
+            // Spreads: (price_b - price_a) / price_a * 10000
+            alignas(64) int64_t spreads[SIMD_BATCH_SIZE];
+            simd::spread_bps_x8(price_a, &prices[b], spreads);
+
+            for (uint32_t i = 0; i < SIMD_BATCH_SIZE && b + i < count; ++i) {
+                if (b + i == a) continue;
+                if (spreads[i] >= config_.min_spread_bps) hit(pool_indices[a], pool_indices[b + i], spreads[i]);
+            }
+        }
+    }
+}
 
 } // namespace matrix::hotpath
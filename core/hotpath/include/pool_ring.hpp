@@ -0,0 +1,180 @@
+#pragma once
+/**
+ * @file pool_ring.hpp
+ * @brief Single-producer / single-consumer ring of pool updates
+ *
+ * Lets another thread or process (the Rust orchestrator) hand reserves to
+ * the scanner without a call per update: the producer writes PoolReserves
+ * into the ring's slots and publishes them by advancing head, the consumer
+ * reads them in place and releases them by advancing tail.
+ *
+ * The ring is plain memory (heap, shm_open/mmap, memfd) laid out as a
+ * PoolRingHeader followed by capacity slots, so both sides only need the
+ * address. Indices count up forever and are reduced by the power-of-two
+ * capacity mask; head - tail is the fill level.
+ */
+
+#include "types.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+namespace matrix::hotpath {
+
+/// Marks formatted ring memory ("HOTPRING")
+constexpr uint64_t POOL_RING_MAGIC = 0x474E495250544F48ULL;
+
+/// Shared ring state; head and tail sit on their own cache lines
+struct alignas(64) PoolRingHeader {
+    uint64_t magic;
+    uint64_t capacity;              // Slots (a power of two)
+    alignas(64) uint64_t head;      // Slots published (producer writes)
+    alignas(64) uint64_t tail;      // Slots released (consumer writes)
+};
+
+static_assert(sizeof(PoolRingHeader) == 192, "PoolRingHeader must be 192 bytes");
+
+// ============================================================================
+// POOL RING
+// ============================================================================
+
+/**
+ * @brief View of a pool ring in caller-owned memory
+ *
+ * One view per side: push() on the producer's, drain() on the consumer's.
+ * Each side caches the other's index and only reloads it when the ring
+ * looks full (producer) or empty (consumer).
+ */
+class PoolRing {
+public:
+    /// Bytes needed for a ring of capacity slots
+    static constexpr size_t bytes_for(size_t capacity) {
+        return sizeof(PoolRingHeader) + capacity * sizeof(PoolReserves);
+    }
+
+    /**
+     * @brief Format memory as an empty ring
+     * @param memory 64-byte aligned region of at least bytes_for(capacity)
+     * @throws std::invalid_argument on a bad region or a capacity that is
+     *         not a power of two
+     */
+    static PoolRing format(void* memory, size_t bytes, size_t capacity) {
+        if (capacity == 0 || (capacity & (capacity - 1)) != 0) {
+            throw std::invalid_argument("PoolRing: capacity must be a power of two");
+        }
+        check_region(memory, bytes, capacity);
+
+        auto* header = static_cast<PoolRingHeader*>(memory);
+        std::memset(header, 0, sizeof(PoolRingHeader));
+        header->capacity = capacity;
+        std::atomic_ref<uint64_t>(header->magic).store(POOL_RING_MAGIC, std::memory_order_release);
+        return PoolRing(memory, bytes);
+    }
+
+    /**
+     * @brief Attach to a formatted ring
+     * @throws std::invalid_argument if memory does not hold one that fits in bytes
+     */
+    PoolRing(void* memory, size_t bytes)
+        : header_(static_cast<PoolRingHeader*>(memory))
+    {
+        if (!memory || bytes < sizeof(PoolRingHeader) ||
+            std::atomic_ref<uint64_t>(header_->magic).load(std::memory_order_acquire) != POOL_RING_MAGIC) {
+            throw std::invalid_argument("PoolRing: memory is not a formatted ring");
+        }
+        const size_t capacity = header_->capacity;
+        if (capacity == 0 || (capacity & (capacity - 1)) != 0) {
+            throw std::invalid_argument("PoolRing: corrupt capacity");
+        }
+        check_region(memory, bytes, capacity);
+
+        slots_ = reinterpret_cast<PoolReserves*>(static_cast<uint8_t*>(memory) + sizeof(PoolRingHeader));
+        mask_ = capacity - 1;
+        cached_head_ = head().load(std::memory_order_acquire);
+        cached_tail_ = tail().load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Publish pools (producer side)
+     * @return Pools written: fewer than count once the ring is full
+     */
+    size_t push(const PoolReserves* pools, size_t count) {
+        const uint64_t h = head().load(std::memory_order_relaxed);
+        if (count > capacity() - static_cast<size_t>(h - cached_tail_)) {
+            cached_tail_ = tail().load(std::memory_order_acquire);
+        }
+        const size_t n = std::min<size_t>(count, capacity() - static_cast<size_t>(h - cached_tail_));
+        if (n == 0) return 0;
+
+        // Up to two contiguous runs (the second after wrapping)
+        const size_t start = static_cast<size_t>(h) & mask_;
+        const size_t first = std::min(n, capacity() - start);
+        std::memcpy(static_cast<void*>(slots_ + start), pools, first * sizeof(PoolReserves));
+        std::memcpy(static_cast<void*>(slots_), pools + first, (n - first) * sizeof(PoolReserves));
+
+        head().store(h + n, std::memory_order_release);
+        return n;
+    }
+
+    /**
+     * @brief Consume published pools in place (consumer side)
+     *
+     * Calls consume(const PoolReserves* pools, size_t count) for up to two
+     * contiguous runs, then releases their slots to the producer.
+     *
+     * @return Pools consumed (at most max_pools)
+     */
+    template<typename Consume>
+    size_t drain(Consume&& consume, size_t max_pools = SIZE_MAX) {
+        const uint64_t t = tail().load(std::memory_order_relaxed);
+        if (cached_head_ == t) {
+            cached_head_ = head().load(std::memory_order_acquire);
+        }
+        const size_t n = std::min<size_t>(max_pools, static_cast<size_t>(cached_head_ - t));
+        if (n == 0) return 0;
+
+        const size_t start = static_cast<size_t>(t) & mask_;
+        const size_t first = std::min(n, capacity() - start);
+        consume(static_cast<const PoolReserves*>(slots_ + start), first);
+        if (first < n) {
+            consume(static_cast<const PoolReserves*>(slots_), n - first);
+        }
+
+        tail().store(t + n, std::memory_order_release);
+        return n;
+    }
+
+    /// Slots in the ring
+    size_t capacity() const { return mask_ + 1; }
+
+    /// Pools published but not yet consumed (a snapshot)
+    size_t size() const {
+        return static_cast<size_t>(std::atomic_ref<uint64_t>(header_->head).load(std::memory_order_acquire) -
+                                   std::atomic_ref<uint64_t>(header_->tail).load(std::memory_order_acquire));
+    }
+
+private:
+    static void check_region(void* memory, size_t bytes, size_t capacity) {
+        if (!memory || reinterpret_cast<uintptr_t>(memory) % alignof(PoolRingHeader) != 0) {
+            throw std::invalid_argument("PoolRing: memory must be 64-byte aligned");
+        }
+        if (capacity > (SIZE_MAX - sizeof(PoolRingHeader)) / sizeof(PoolReserves) ||
+            bytes < bytes_for(capacity)) {
+            throw std::invalid_argument("PoolRing: region too small for its capacity");
+        }
+    }
+
+    std::atomic_ref<uint64_t> head() const { return std::atomic_ref<uint64_t>(header_->head); }
+    std::atomic_ref<uint64_t> tail() const { return std::atomic_ref<uint64_t>(header_->tail); }
+
+    PoolRingHeader* header_;
+    PoolReserves* slots_ = nullptr;
+    size_t mask_ = 0;
+    uint64_t cached_head_ = 0;   // Consumer's last view of head
+    uint64_t cached_tail_ = 0;   // Producer's last view of tail
+};
+
+} // namespace matrix::hotpath
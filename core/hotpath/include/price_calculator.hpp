@@ -9,9 +9,13 @@
 
 #include "types.hpp"
 #include "simd_math.hpp"
+#include "swap_math.hpp"
 
 namespace matrix::hotpath {
 
+/// Fee tier assumed by the U256 swap helpers (0.3%)
+constexpr uint32_t DEFAULT_FEE_BPS = 30;
+
 // ============================================================================
 // PRICE CALCULATION FUNCTIONS
 // ============================================================================
@@ -19,7 +23,12 @@ namespace matrix::hotpath {
 /**
  * @brief Calculate price from pool reserves (single pool)
  *
- * Price = reserve1 / reserve0 * 10^18 (normalized to 18 decimals)
+ * Price = floor(reserve1 * 10^18 / reserve0) over the low 128 bits of
+ * each reserve, exact, saturating at 2^128 - 1. A zero reserve0 gives
+ * price 0 and confidence 0.
+ *
+ * Confidence tiers follow liquidity depth sqrt(reserve0 * reserve1):
+ * >= 1e24 -> 10000, >= 1e21 -> 9000, >= 1e18 -> 7000, else 3000.
  *
  * @param reserves Pool reserves
  * @return PriceResult with calculated price
@@ -29,18 +38,43 @@ PriceResult calculate_price(const PoolReserves& reserves);
 /**
  * @brief Calculate prices for a batch of pools using SIMD
  *
- * Processes up to SIMD_BATCH_SIZE pools in parallel using AVX2 instructions.
+ * Same results as calculate_price. The reserves are transposed into
+ * lanes, a vectorized double estimate of every price is corrected to
+ * the exact quotient with integer multiplies (no division), and the
+ * confidence tier comes from the same vectorized pass.
  *
  * @param batch Batch of pool reserves
  * @param results Output array for results (must have space for batch.count elements)
  */
 void calculate_prices_batch(const PoolBatch& batch, PriceResult* results);
 
+/**
+ * @brief Calculate prices only for pools that moved
+ *
+ * Like calculate_prices_batch, but each pool's approximate price is first
+ * compared with reference_prices[i] (same 10^18 scale as PriceResult::price);
+ * pools within min_deviation_bps of it are dropped before any exact math.
+ * A reference <= 0 always passes.
+ *
+ * @param batch Batch of pool reserves
+ * @param reference_prices batch.count reference prices
+ * @param min_deviation_bps Deviation a pool must exceed to be kept
+ * @param results Output, compacted: the kept pools in batch order
+ * @return Number of results written
+ */
+size_t calculate_prices_filtered(
+    const PoolBatch& batch,
+    const double* reference_prices,
+    int64_t min_deviation_bps,
+    PriceResult* results
+);
+
 /**
  * @brief Calculate output amount for a swap (constant product AMM)
  *
  * Uses the formula: amountOut = (reserveOut * amountIn * 997) / (reserveIn * 1000 + amountIn * 997)
- * The 0.3% fee is accounted for in the calculation.
+ * The 0.3% fee is accounted for in the calculation. Exact for reserves and
+ * amounts below 2^112 (see swap_math.hpp).
  *
  * @param reserve_in Input token reserve
  * @param reserve_out Output token reserve
@@ -52,6 +86,8 @@ U256 calculate_swap_output(const U256& reserve_in, const U256& reserve_out, cons
 /**
  * @brief Calculate swap output for batch of amounts
  *
+ * Exact (same results as calculate_swap_output), four amounts per step.
+ *
  * @param reserve_in Input token reserve
  * @param reserve_out Output token reserve
  * @param amounts_in Array of input amounts
@@ -79,24 +115,46 @@ int64_t calculate_slippage_bps(const U256& reserve_in, const U256& reserve_out,
 /**
  * @brief Calculate optimal trade size to capture arbitrage
  *
+ * The buy pool is the one with the lower price (token1 per token0): token1
+ * buys token0 there, which is sold back for token1 in the sell pool. The
+ * size maximizes that round trip's profit (closed form for two 0.3%-fee
+ * constant-product pools), 0 if no size profits.
+ *
  * @param reserve0_buy Buy pool reserve0
  * @param reserve1_buy Buy pool reserve1
  * @param reserve0_sell Sell pool reserve0
  * @param reserve1_sell Sell pool reserve1
- * @return Optimal trade size
+ * @return Optimal trade size (token1)
  */
 U256 calculate_optimal_trade_size(
     const U256& reserve0_buy, const U256& reserve1_buy,
     const U256& reserve0_sell, const U256& reserve1_sell
 );
 
+/**
+ * @brief Upper bound on the round trip's profit at any size
+ *
+ * The closed-form maximum of calculate_optimal_trade_size's round trip,
+ * widened past its rounding: calculate_arbitrage_profit never exceeds it
+ * (its swaps round down), so a candidate whose bound cannot beat a known
+ * profit needs no exact evaluation.
+ *
+ * @param buy_reserves Buy pool reserves
+ * @param sell_reserves Sell pool reserves
+ * @return Profit bound in token1 (0 if no size profits)
+ */
+double arbitrage_profit_bound(const PoolReserves& buy_reserves, const PoolReserves& sell_reserves);
+
 /**
  * @brief Calculate profit from arbitrage opportunity
  *
+ * Swaps trade_size of token1 for token0 in the buy pool, then that token0
+ * back to token1 in the sell pool (see calculate_optimal_trade_size).
+ *
  * @param buy_reserves Buy pool reserves
  * @param sell_reserves Sell pool reserves
- * @param trade_size Amount to trade
- * @return Estimated profit (may be negative)
+ * @param trade_size Amount to trade (token1)
+ * @return Estimated profit in token1 (0 if the round trip loses)
  */
 U256 calculate_arbitrage_profit(
     const PoolReserves& buy_reserves,
@@ -104,6 +162,57 @@ U256 calculate_arbitrage_profit(
     const U256& trade_size
 );
 
+// ============================================================================
+// PRICE LANES
+// ============================================================================
+
+namespace detail {
+
+/// SIMD_BATCH_SIZE pools' reserves transposed into columns: the low 128
+/// bits of each reserve as two 64-bit halves
+struct alignas(64) ReserveLanes {
+    uint64_t reserve0_lo[SIMD_BATCH_SIZE];
+    uint64_t reserve0_hi[SIMD_BATCH_SIZE];
+    uint64_t reserve1_lo[SIMD_BATCH_SIZE];
+    uint64_t reserve1_hi[SIMD_BATCH_SIZE];
+
+    /// Set a lane from little-endian 256-bit reserve limbs
+    void set(size_t lane, const uint64_t* reserve0_limbs, const uint64_t* reserve1_limbs) {
+        reserve0_lo[lane] = reserve0_limbs[0];
+        reserve0_hi[lane] = reserve0_limbs[1];
+        reserve1_lo[lane] = reserve1_limbs[0];
+        reserve1_hi[lane] = reserve1_limbs[1];
+    }
+
+    void set(size_t lane, const PoolReserves& reserves) {
+        set(lane, reserves.reserve0.limbs, reserves.reserve1.limbs);
+    }
+};
+
+/// Per-lane output of price_lanes
+struct LanePrices {
+    __uint128_t price[SIMD_BATCH_SIZE];
+    int64_t confidence[SIMD_BATCH_SIZE];
+    uint32_t kept;          // Bit i set: lane i passed the filter and was priced
+};
+
+/**
+ * @brief Exact prices and confidence of the first count lanes
+ *
+ * With reference_prices, lanes whose approximate price lies within
+ * min_deviation_bps of their reference (> 0) are left out of kept and
+ * not priced; without, every lane is kept.
+ */
+void price_lanes(
+    const ReserveLanes& lanes,
+    size_t count,
+    const double* reference_prices,
+    int64_t min_deviation_bps,
+    LanePrices& out
+);
+
+} // namespace detail
+
 // ============================================================================
 // BATCH PRICE CALCULATION CLASS
 // ============================================================================
@@ -111,8 +220,8 @@ U256 calculate_arbitrage_profit(
 /**
  * @brief High-performance batch price calculator
  *
- * Maintains internal buffers for efficient SIMD processing of large
- * numbers of price calculations.
+ * Keeps pools as transposed reserve lanes plus metadata columns, so a
+ * process() call runs the batch pipeline without copying any pool.
  */
 class BatchPriceCalculator {
 public:
@@ -137,6 +246,15 @@ public:
      */
     size_t process(PriceResult* results);
 
+    /**
+     * @brief Process only the pools that moved (see calculate_prices_filtered)
+     * @param reference_prices pool_count() reference prices, in add order
+     * @param min_deviation_bps Deviation a pool must exceed to be kept
+     * @param results Output array (capacity for pool_count() elements), compacted
+     * @return Number of results written
+     */
+    size_t process_filtered(const double* reference_prices, int64_t min_deviation_bps, PriceResult* results);
+
     /**
      * @brief Clear the batch
      */
@@ -154,9 +272,15 @@ public:
 
 private:
     static constexpr size_t MAX_POOLS = 1024;
+    static constexpr size_t MAX_BLOCKS = MAX_POOLS / SIMD_BATCH_SIZE;
+
+    size_t process_lanes(const double* reference_prices, int64_t min_deviation_bps, PriceResult* results);
 
-    // SIMD-aligned storage
-    alignas(64) PoolReserves pools_[MAX_POOLS];
+    // Reserves transposed on add_pool, so process() reads whole lanes
+    detail::ReserveLanes lanes_[MAX_BLOCKS];
+    uint64_t timestamps_[MAX_POOLS];
+    uint32_t pool_ids_[MAX_POOLS];
+    uint32_t dex_ids_[MAX_POOLS];
     size_t pool_count_;
 };
 
@@ -4,6 +4,12 @@
  * @brief SIMD-optimized mathematical operations
  *
  * AVX2/AVX-512 accelerated math for high-frequency trading calculations.
+ *
+ * The inline 4-lane helpers below are AVX2, the library's baseline. The
+ * SIMD_BATCH_SIZE-lane batch kernels at the end are built twice, for AVX2
+ * and for AVX-512 (F + DQ), and the best one the CPU supports is picked
+ * once at load time, so a single binary uses the full vector width on
+ * AVX-512 hosts and still runs everywhere else.
  */
 
 #include "types.hpp"
@@ -51,12 +57,13 @@ inline u64x4 sub_u64x4(u64x4 a, u64x4 b) {
 }
 
 /// Multiply 4 x 64-bit integers (lower 64 bits of result)
-/// Note: AVX2 doesn't have native 64-bit multiply, we use 32-bit
+/// AVX2 has no 64-bit multiply: a*b mod 2^64 = lo*lo + ((hi*lo + lo*hi) << 32)
 inline u64x4 mul_u64x4_low(u64x4 a, u64x4 b) {
-    // Use _mm256_mul_epu32 for lower 32 bits, then shift and add
-    __m256i a_lo = _mm256_and_si256(a, _mm256_set1_epi64x(0xFFFFFFFF));
-    __m256i b_lo = _mm256_and_si256(b, _mm256_set1_epi64x(0xFFFFFFFF));
-    return _mm256_mul_epu32(a_lo, b_lo);
+    const __m256i low = _mm256_mul_epu32(a, b);   // Low 32 bits of each lane
+    const __m256i cross = _mm256_add_epi64(
+        _mm256_mul_epu32(_mm256_srli_epi64(a, 32), b),
+        _mm256_mul_epu32(a, _mm256_srli_epi64(b, 32)));
+    return _mm256_add_epi64(low, _mm256_slli_epi64(cross, 32));
 }
 
 /// Bitwise AND
@@ -134,17 +141,30 @@ inline f64x4 fma_f64x4(f64x4 a, f64x4 b, f64x4 c) {
     return _mm256_fmadd_pd(a, b, c);
 }
 
-/// Convert 4 x uint64 to 4 x double (approximate, loses precision for large values)
+/// Convert 4 x uint64 to 4 x double, rounded to nearest like static_cast
+/// AVX2 has no u64->f64: each 32-bit half is planted in the mantissa of
+/// 2^52 / 2^84, the offsets cancel exactly and the final add rounds once
 inline f64x4 cvt_u64x4_to_f64x4(u64x4 v) {
-    // Extract to scalar and convert (AVX2 doesn't have direct u64->f64)
-    alignas(32) uint64_t vals[4];
-    store_aligned(vals, v);
-    return _mm256_set_pd(
-        static_cast<double>(vals[3]),
-        static_cast<double>(vals[2]),
-        static_cast<double>(vals[1]),
-        static_cast<double>(vals[0])
-    );
+    const __m256i low = _mm256_blend_epi32(v, _mm256_set1_epi64x(0x4330000000000000LL), 0b10101010);
+    const __m256i high = _mm256_or_si256(_mm256_srli_epi64(v, 32), _mm256_set1_epi64x(0x4530000000000000LL));
+    const __m256d high_f = _mm256_sub_pd(_mm256_castsi256_pd(high),
+                                         _mm256_set1_pd(19342813118337666422669312.0));  // 2^84 + 2^52
+    return _mm256_add_pd(high_f, _mm256_castsi256_pd(low));
+}
+
+/// Largest magnitude cvt_f64x4_to_i64x4 converts; beyond it lanes saturate
+constexpr double F64_TO_I64_LIMIT = 2251799813685247.0;  // 2^51 - 1
+
+/// Convert 4 x double to 4 x int64, truncated toward zero like static_cast
+/// within +-F64_TO_I64_LIMIT (saturating outside it, NaN to the low bound).
+/// AVX2 has no f64->i64: adding 2^52 + 2^51 leaves the integer in the low
+/// mantissa bits
+inline u64x4 cvt_f64x4_to_i64x4(f64x4 v) {
+    const __m256d magic = _mm256_set1_pd(6755399441055744.0);  // 2^52 + 2^51
+    __m256d t = _mm256_max_pd(v, _mm256_set1_pd(-F64_TO_I64_LIMIT));
+    t = _mm256_min_pd(t, _mm256_set1_pd(F64_TO_I64_LIMIT));
+    t = _mm256_round_pd(t, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+    return _mm256_sub_epi64(_mm256_castpd_si256(_mm256_add_pd(t, magic)), _mm256_castpd_si256(magic));
 }
 
 // ============================================================================
@@ -277,4 +297,74 @@ inline U256 double_to_u256(double v) {
     return result;
 }
 
+// ============================================================================
+// BATCH KERNELS (SIMD_BATCH_SIZE lanes, dispatched at run time)
+// ============================================================================
+
+/// Instruction set a batch kernel table was built for
+enum class SimdLevel : uint8_t {
+    AVX2 = 0,       // Two 4-lane halves per batch
+    AVX512 = 1,     // One 8-lane register (AVX-512F + AVX-512DQ)
+};
+
+/// One SimdLevel's batch kernels. Every array holds SIMD_BATCH_SIZE
+/// elements; no alignment is required. All levels give identical results.
+struct BatchKernels {
+    SimdLevel level;
+    void (*cvt_u64_to_f64)(const uint64_t* in, double* out);                    // See cvt_u64x4_to_f64x4
+    void (*mul_u64_low)(const uint64_t* a, const uint64_t* b, uint64_t* out);   // a * b mod 2^64
+    void (*cvt_f64_to_i64)(const double* in, int64_t* out);                     // See cvt_f64x4_to_i64x4
+    void (*spread_bps)(const double* buy, const double* sell, int64_t* out);    // 0 where buy <= 0
+
+    /// 128-bit lanes given as (lo, hi) halves: reciprocal = 1 / den,
+    /// ratio = num * scale * reciprocal and product = num * den, in double
+    /// (inf / NaN where den is 0)
+    void (*ratio_u128)(const uint64_t* num_lo, const uint64_t* num_hi,
+                       const uint64_t* den_lo, const uint64_t* den_hi, double scale,
+                       double* ratio, double* reciprocal, double* product);
+};
+
+/// CPU and OS support AVX2 (YMM state enabled)
+bool cpu_has_avx2();
+
+/// CPU and OS support AVX-512F and AVX-512DQ (ZMM state enabled)
+bool cpu_has_avx512();
+
+/// Best level this CPU supports
+SimdLevel detected_level();
+
+/// Kernels of a given level (tests and benchmarks; the AVX-512 table must
+/// only be called where cpu_has_avx512())
+const BatchKernels& kernels_for(SimdLevel level);
+
+/// Kernels of detected_level(), resolved once
+const BatchKernels& batch_kernels();
+
+/// Convert SIMD_BATCH_SIZE x uint64 to double (vcvtuqq2pd on AVX-512)
+inline void cvt_u64x8_to_f64x8(const uint64_t* in, double* out) {
+    batch_kernels().cvt_u64_to_f64(in, out);
+}
+
+/// Multiply SIMD_BATCH_SIZE x uint64, low 64 bits (vpmullq on AVX-512)
+inline void mul_u64x8_low(const uint64_t* a, const uint64_t* b, uint64_t* out) {
+    batch_kernels().mul_u64_low(a, b, out);
+}
+
+/// Convert SIMD_BATCH_SIZE x double to int64, truncated (vcvttpd2qq on AVX-512)
+inline void cvt_f64x8_to_i64x8(const double* in, int64_t* out) {
+    batch_kernels().cvt_f64_to_i64(in, out);
+}
+
+/// (sell - buy) / buy * 10000 for SIMD_BATCH_SIZE price pairs, truncated
+inline void spread_bps_x8(const double* buy, const double* sell, int64_t* out) {
+    batch_kernels().spread_bps(buy, sell, out);
+}
+
+/// Ratios and products of SIMD_BATCH_SIZE 128-bit lanes (see BatchKernels)
+inline void ratio_u128x8(const uint64_t* num_lo, const uint64_t* num_hi,
+                         const uint64_t* den_lo, const uint64_t* den_hi, double scale,
+                         double* ratio, double* reciprocal, double* product) {
+    batch_kernels().ratio_u128(num_lo, num_hi, den_lo, den_hi, scale, ratio, reciprocal, product);
+}
+
 } // namespace matrix::hotpath::simd
@@ -0,0 +1,205 @@
+#pragma once
+/**
+ * @file swap_math.hpp
+ * @brief Exact constant-product swap kernel on 128-bit integers
+ *
+ * Shared by the core library (calculate_swap_output) and the hot path
+ * order book / calculator (PoolState::get_amount_out). Header-only and
+ * dependency-free so both trees can include it.
+ *
+ * All values are raw token units. Reserves and amounts must stay below
+ * 2^112 (Uniswap V2's uint112 reserve bound); then amount * (10000 - fee)
+ * and the denominator fit in 128 bits and only the numerator needs the
+ * 256-bit product, which is divided out exactly.
+ */
+
+#include <cstddef>
+#include <cstdint>
+
+namespace matrix::hotpath::swap {
+
+using u128 = __uint128_t;
+
+/// Fee denominator (fees are in basis points)
+constexpr uint32_t FEE_DENOMINATOR = 10000;
+
+// ============================================================================
+// 256-BIT INTERMEDIATES
+// ============================================================================
+
+/// Full product of two 128-bit values
+struct Wide {
+    u128 hi;
+    u128 lo;
+};
+
+/// a * b as a 256-bit (hi, lo) pair
+inline Wide mul_wide(u128 a, u128 b) noexcept {
+    const uint64_t a0 = static_cast<uint64_t>(a), a1 = static_cast<uint64_t>(a >> 64);
+    const uint64_t b0 = static_cast<uint64_t>(b), b1 = static_cast<uint64_t>(b >> 64);
+
+    const u128 p00 = static_cast<u128>(a0) * b0;
+    const u128 p01 = static_cast<u128>(a0) * b1;
+    const u128 p10 = static_cast<u128>(a1) * b0;
+    const u128 p11 = static_cast<u128>(a1) * b1;
+
+    // Middle column: high half of p00 plus the low halves of the cross terms
+    const u128 mid = (p00 >> 64) + static_cast<uint64_t>(p01) + static_cast<uint64_t>(p10);
+
+    Wide r;
+    r.lo = (mid << 64) | static_cast<uint64_t>(p00);
+    r.hi = p11 + (p01 >> 64) + (p10 >> 64) + (mid >> 64);
+    return r;
+}
+
+namespace detail {
+
+/// Count leading zeros of a non-zero 64-bit value
+inline int clz64(uint64_t v) noexcept {
+    return __builtin_clzll(v);
+}
+
+/**
+ * (u2:u1:u0) / (v1:v0) for a normalized divisor (top bit of v1 set) and
+ * u2:u1 < v1:v0, so the quotient digit fits in 64 bits. On return
+ * (u1:u0) holds the remainder. Knuth D: the estimate from the top two
+ * digits is at most two too large.
+ */
+inline uint64_t div_3by2(uint64_t& u2, uint64_t& u1, uint64_t& u0,
+                         uint64_t v1, uint64_t v0) noexcept {
+    const u128 top = (static_cast<u128>(u2) << 64) | u1;
+    u128 qhat = u2 >= v1 ? ~static_cast<uint64_t>(0) : top / v1;
+    u128 rhat = top - qhat * v1;
+
+    while (rhat >> 64 == 0 &&
+           qhat * v0 > ((rhat << 64) | u0)) {
+        --qhat;
+        rhat += v1;
+    }
+
+    // (u2:u1:u0) -= qhat * (v1:v0), adding back once if it went negative
+    const u128 p0 = qhat * v0;
+    const u128 p1 = qhat * v1 + static_cast<uint64_t>(p0 >> 64);
+    u128 r = static_cast<u128>(u0) - static_cast<uint64_t>(p0);
+    u0 = static_cast<uint64_t>(r);
+    r = static_cast<u128>(u1) - static_cast<uint64_t>(p1) - static_cast<uint64_t>(r >> 127);
+    u1 = static_cast<uint64_t>(r);
+    r = static_cast<u128>(u2) - static_cast<uint64_t>(p1 >> 64) - static_cast<uint64_t>(r >> 127);
+    u2 = 0;  // The remainder is below the divisor, so two digits hold it
+    if (r >> 127) {
+        --qhat;
+        const u128 s0 = static_cast<u128>(u0) + v0;
+        u0 = static_cast<uint64_t>(s0);
+        u1 = static_cast<uint64_t>(static_cast<u128>(u1) + v1 + static_cast<uint64_t>(s0 >> 64));
+    }
+    return static_cast<uint64_t>(qhat);
+}
+
+} // namespace detail
+
+/**
+ * floor((hi:lo) / d) for hi < d (the quotient fits in 128 bits)
+ */
+inline u128 div_wide(u128 hi, u128 lo, u128 d) noexcept {
+    const auto d1 = static_cast<uint64_t>(d >> 64);
+
+    if (d1 == 0) {
+        // Single-digit divisor: two chained 128/64 divisions
+        const auto d0 = static_cast<uint64_t>(d);
+        const u128 q1 = ((hi << 64) | static_cast<uint64_t>(lo >> 64)) / d0;
+        const u128 r1 = ((hi << 64) | static_cast<uint64_t>(lo >> 64)) - q1 * d0;
+        const u128 q0 = ((r1 << 64) | static_cast<uint64_t>(lo)) / d0;
+        return (q1 << 64) | static_cast<uint64_t>(q0);
+    }
+
+    // Normalize so the divisor's top bit is set
+    const int s = detail::clz64(d1);
+    const u128 dn = d << s;
+    const auto v1 = static_cast<uint64_t>(dn >> 64);
+    const auto v0 = static_cast<uint64_t>(dn);
+
+    uint64_t u3, u2, u1, u0;
+    if (s == 0) {
+        u3 = static_cast<uint64_t>(hi >> 64);
+        u2 = static_cast<uint64_t>(hi);
+    } else {
+        const u128 hn = (hi << s) | (lo >> (128 - s));
+        u3 = static_cast<uint64_t>(hn >> 64);
+        u2 = static_cast<uint64_t>(hn);
+    }
+    const u128 ln = lo << s;
+    u1 = static_cast<uint64_t>(ln >> 64);
+    u0 = static_cast<uint64_t>(ln);
+
+    const uint64_t q1 = detail::div_3by2(u3, u2, u1, v1, v0);
+    const uint64_t q0 = detail::div_3by2(u2, u1, u0, v1, v0);
+    return (static_cast<u128>(q1) << 64) | q0;
+}
+
+/**
+ * floor(a * b / d), exact; saturates to all-ones if the quotient does not
+ * fit in 128 bits, 0 if d == 0
+ */
+inline u128 mul_div(u128 a, u128 b, u128 d) noexcept {
+    if (d == 0) return 0;
+    const Wide p = mul_wide(a, b);
+    if (p.hi == 0) return p.lo / d;       // Common case: product fits
+    if (p.hi >= d) return ~static_cast<u128>(0);
+    return div_wide(p.hi, p.lo, d);
+}
+
+// ============================================================================
+// SWAP KERNEL
+// ============================================================================
+
+/**
+ * Constant-product output amount, Uniswap V2 rounding:
+ *   out = floor(a*g*R_out / (R_in*10000 + a*g)),  g = 10000 - fee_bps
+ *
+ * Branch-light: the only data-dependent branch is mul_div's product-fits
+ * check.
+ */
+inline u128 get_amount_out(u128 amount_in, u128 reserve_in, u128 reserve_out,
+                           uint32_t fee_bps) noexcept {
+    const u128 amount_with_fee = amount_in * (FEE_DENOMINATOR - fee_bps);
+    const u128 denominator = reserve_in * FEE_DENOMINATOR + amount_with_fee;
+    if (amount_in == 0 || reserve_in == 0) return 0;
+    return mul_div(amount_with_fee, reserve_out, denominator);
+}
+
+/**
+ * 64-bit convenience form (the output never exceeds reserve_out)
+ */
+inline uint64_t get_amount_out(uint64_t amount_in, uint64_t reserve_in, uint64_t reserve_out,
+                               uint32_t fee_bps) noexcept {
+    return static_cast<uint64_t>(get_amount_out(
+        static_cast<u128>(amount_in), static_cast<u128>(reserve_in),
+        static_cast<u128>(reserve_out), fee_bps));
+}
+
+/**
+ * Evaluate N candidate input amounts against one pool
+ *
+ * The per-pool terms are hoisted and the N divisions are independent, so
+ * they overlap in the pipeline instead of queueing behind each other;
+ * intended for sizing searches with N = 4 or 8.
+ */
+template<size_t N, typename T>
+inline void get_amounts_out(const T (&amounts_in)[N], T reserve_in, T reserve_out,
+                            uint32_t fee_bps, T (&amounts_out)[N]) noexcept {
+    const u128 fee_mult = FEE_DENOMINATOR - fee_bps;
+    const u128 base = static_cast<u128>(reserve_in) * FEE_DENOMINATOR;
+
+    u128 with_fee[N];
+    u128 denominator[N];
+    for (size_t i = 0; i < N; ++i) {
+        with_fee[i] = static_cast<u128>(amounts_in[i]) * fee_mult;
+        denominator[i] = base + with_fee[i];
+    }
+    for (size_t i = 0; i < N; ++i) {
+        const u128 out = mul_div(with_fee[i], static_cast<u128>(reserve_out), denominator[i]);
+        amounts_out[i] = (amounts_in[i] == 0 || reserve_in == 0) ? T{0} : static_cast<T>(out);
+    }
+}
+
+} // namespace matrix::hotpath::swap
@@ -37,6 +37,10 @@ struct alignas(32) U256 {
 
     explicit U256(uint64_t value) : limbs{value, 0, 0, 0} {}
 
+    static U256 from_u128(__uint128_t value) {
+        return U256(static_cast<uint64_t>(value), static_cast<uint64_t>(value >> 64), 0, 0);
+    }
+
     U256(uint64_t l0, uint64_t l1, uint64_t l2, uint64_t l3)
         : limbs{l0, l1, l2, l3} {}
 
@@ -60,7 +64,9 @@ struct alignas(64) PoolReserves {
     uint32_t dex_id;       // DEX identifier
     uint8_t decimals0;     // Token0 decimals
     uint8_t decimals1;     // Token1 decimals
-    uint8_t _padding[6];   // Padding to 64-byte alignment
+    uint8_t _padding[6];
+    uint64_t token0_hash;  // Hash of token0's address (0 if unknown)
+    uint64_t token1_hash;  // Hash of token1's address (0 if unknown)
 };
 
 static_assert(sizeof(PoolReserves) == 128, "PoolReserves must be 128 bytes");
@@ -89,13 +95,14 @@ struct alignas(64) ArbitrageOpportunity {
     uint32_t buy_dex_id;
     uint32_t sell_pool_id;
     uint32_t sell_dex_id;
+    int64_t spread_bps;   // Spread in basis points
+    uint64_t timestamp_ms;
+    // 32-byte aligned from here; scalars above keep U256 padding out
     U256 buy_price;       // Price to buy at
     U256 sell_price;      // Price to sell at
-    int64_t spread_bps;   // Spread in basis points
     U256 max_amount;      // Maximum executable amount
     U256 estimated_profit;// Estimated profit
-    uint64_t timestamp_ms;
-    uint8_t _padding[8];
+    uint8_t _padding[32];
 };
 
 static_assert(sizeof(ArbitrageOpportunity) == 192, "ArbitrageOpportunity size check");
@@ -137,10 +144,26 @@ inline ScannerConfig default_scanner_config() {
     ScannerConfig config{};
     config.min_spread_bps = 10;        // 0.1%
     config.max_slippage_bps = 50;      // 0.5%
-    config.min_liquidity = U256(100'000'000'000'000'000'000ULL); // ~$100 min
-    config.max_position_size = U256(10'000'000'000'000'000'000'000ULL); // ~$10k max
+    config.min_liquidity = U256::from_u128(static_cast<__uint128_t>(100) * PRICE_PRECISION); // ~$100 min
+    config.max_position_size = U256::from_u128(static_cast<__uint128_t>(10'000) * PRICE_PRECISION); // ~$10k max
     config.include_same_dex = false;
     return config;
 }
 
+/// Scanner storage limits (allocated once, when the scanner is created)
+struct ScannerCapacity {
+    size_t max_pools;           // Pools tracked; updates for further pools are dropped
+    size_t max_pairs;           // Distinct token pairs grouped
+    size_t max_pools_per_pair;  // Pools compared within one token pair
+};
+
+/// Default scanner capacity
+inline ScannerCapacity default_scanner_capacity() {
+    ScannerCapacity capacity{};
+    capacity.max_pools = 4096;
+    capacity.max_pairs = 512;
+    capacity.max_pools_per_pair = 32;
+    return capacity;
+}
+
 } // namespace matrix::hotpath
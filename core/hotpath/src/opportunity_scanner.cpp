@@ -5,21 +5,67 @@
 
 #include "opportunity_scanner.hpp"
 #include <algorithm>
-#include <cstring>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <utility>
 
 namespace matrix::hotpath {
 
+namespace {
+
+/// 64-bit finalizer (splitmix64): spreads clustered ids over the index
+inline uint64_t mix64(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+/// Pools ahead of the current one whose index slot update_pools prefetches
+constexpr size_t PREFETCH_DISTANCE = 8;
+
+/// Index slot count for n entries: a power of two, at most half full
+size_t index_size(size_t n) {
+    size_t size = 16;
+    while (size < 2 * n) size <<= 1;
+    return size;
+}
+
+} // anonymous namespace
+
 // ============================================================================
 // CONSTRUCTOR / DESTRUCTOR
 // ============================================================================
 
-OpportunityScanner::OpportunityScanner(const ScannerConfig& config)
+OpportunityScanner::OpportunityScanner(const ScannerConfig& config, const ScannerCapacity& capacity)
     : config_(config)
-    , pool_count_(0)
-    , pair_count_(0)
+    , capacity_(capacity)
 {
-    std::memset(pools_, 0, sizeof(pools_));
-    std::memset(pair_groups_, 0, sizeof(pair_groups_));
+    if (capacity.max_pools == 0 || capacity.max_pools > MAX_CAPACITY ||
+        capacity.max_pairs == 0 || capacity.max_pairs > MAX_CAPACITY ||
+        capacity.max_pools_per_pair == 0 || capacity.max_pools_per_pair > MAX_CAPACITY) {
+        throw std::invalid_argument("OpportunityScanner: capacities must be 1.." + std::to_string(MAX_CAPACITY));
+    }
+    // Group member offsets are uint32_t: every group's slots must fit
+    if (capacity.max_pairs * capacity.max_pools_per_pair > UINT32_MAX) {
+        throw std::invalid_argument("OpportunityScanner: max_pairs * max_pools_per_pair must fit in 32 bits");
+    }
+
+    pools_.reserve(capacity.max_pools);
+    pool_index_.resize(index_size(capacity.max_pools));
+    pair_groups_.reserve(capacity.max_pairs);
+    pair_index_.resize(index_size(capacity.max_pairs));
+    group_pools_.resize(capacity.max_pairs * capacity.max_pools_per_pair);
+    member_prices_.resize(group_pools_.size());
+    group_prices_.resize((capacity.max_pools_per_pair + SIMD_BATCH_SIZE - 1) / SIMD_BATCH_SIZE * SIMD_BATCH_SIZE);
+    group_best_.reserve(capacity.max_pairs);
+    best_heap_.reserve(capacity.max_pairs);
+    heap_slot_.reserve(capacity.max_pairs);
+    top_frontier_.reserve(64);
+    clear();
 }
 
 OpportunityScanner::~OpportunityScanner() = default;
@@ -28,87 +74,147 @@ OpportunityScanner::~OpportunityScanner() = default;
 // POOL MANAGEMENT
 // ============================================================================
 
-void OpportunityScanner::update_pool(const PoolReserves& reserves) {
-    // Find existing pool or add new one
-    size_t pool_idx = MAX_POOLS;
-
-    for (size_t i = 0; i < pool_count_; ++i) {
-        if (pools_[i].reserves.pool_id == reserves.pool_id &&
-            pools_[i].reserves.dex_id == reserves.dex_id) {
-            pool_idx = i;
-            break;
+uint32_t OpportunityScanner::find_or_add_pool(uint32_t pool_id, uint32_t dex_id) {
+    const uint64_t key = pool_key(pool_id, dex_id);
+    const size_t mask = pool_index_.size() - 1;
+
+    for (size_t slot = mix64(key) & mask;; slot = (slot + 1) & mask) {
+        PoolSlot& entry = pool_index_[slot];
+        if (entry.pool == NONE) {
+            if (pools_.size() >= capacity_.max_pools) return NONE; // At capacity
+            entry.key = key;
+            entry.pool = static_cast<uint32_t>(pools_.size());
+            PoolEntry& pool = pools_.emplace_back();
+            pool.group = NONE;
+            return entry.pool;
         }
+        if (entry.key == key) return entry.pool;
     }
+}
 
-    if (pool_idx == MAX_POOLS) {
-        // New pool
-        if (pool_count_ >= MAX_POOLS) {
-            return; // At capacity
+uint32_t OpportunityScanner::find_or_add_group(const TokenPair& pair) {
+    const size_t mask = pair_index_.size() - 1;
+
+    for (size_t slot = mix64(pair.token0_hash ^ mix64(pair.token1_hash)) & mask;; slot = (slot + 1) & mask) {
+        PairSlot& entry = pair_index_[slot];
+        if (entry.group == NONE) {
+            if (pair_groups_.size() >= capacity_.max_pairs) return NONE;
+            entry.pair = pair;
+            entry.group = static_cast<uint32_t>(pair_groups_.size());
+            pair_groups_.push_back({pair, static_cast<uint32_t>(entry.group * capacity_.max_pools_per_pair), 0});
+            group_best_.push_back({ArbitrageOpportunity{}, NONE, NONE});
+            heap_slot_.push_back(NONE);
+            return entry.group;
         }
-        pool_idx = pool_count_++;
+        if (entry.pair == pair) return entry.group;
     }
+}
 
-    // Update pool data
-    pools_[pool_idx].reserves = reserves;
-    pools_[pool_idx].valid = true;
+void OpportunityScanner::add_to_group(uint32_t pool_index, const TokenPair& pair) {
+    if (pair.token0_hash == pair.token1_hash) return; // Pair unknown
+
+    const uint32_t group_idx = find_or_add_group(pair);
+    if (group_idx == NONE) return;
+    PairGroup& group = pair_groups_[group_idx];
+    if (group.count >= capacity_.max_pools_per_pair) return;
+    PoolEntry& entry = pools_[pool_index];
+    entry.group = group_idx;
+    entry.member = group.count++;
+    group_pools_[group.first + entry.member] = pool_index;
+    member_prices_[group.first + entry.member] = entry.price_f64;
+}
+
+void OpportunityScanner::remove_from_group(uint32_t pool_index) {
+    PoolEntry& entry = pools_[pool_index];
+    PairGroup& group = pair_groups_[entry.group];
+
+    // The last member takes the vacated slot
+    const uint32_t last = group.first + --group.count;
+    const uint32_t slot = group.first + entry.member;
+    group_pools_[slot] = group_pools_[last];
+    member_prices_[slot] = member_prices_[last];
+    pools_[group_pools_[slot]].member = entry.member;
+    entry.group = NONE;
+}
+
+void OpportunityScanner::update_pool(const PoolReserves& reserves) {
+    const uint32_t pool_idx = find_or_add_pool(reserves.pool_id, reserves.dex_id);
+    if (pool_idx == NONE) return;
+
+    // Update pool data, in the pair's canonical orientation
+    PoolEntry& entry = pools_[pool_idx];
+    entry.reserves = reserves;
+    if (reserves.token0_hash > reserves.token1_hash) {
+        std::swap(entry.reserves.reserve0, entry.reserves.reserve1);
+        std::swap(entry.reserves.decimals0, entry.reserves.decimals1);
+        std::swap(entry.reserves.token0_hash, entry.reserves.token1_hash);
+    }
+    entry.valid = true;
 
     // Recalculate price
     recalculate_price(pool_idx);
 
-    // Update pair grouping if new pool
-    // (Simplified - in production would use hash map)
-    // For now, linear search through pairs
-    TokenPair pair;
-    // Simple hash of addresses (would use actual address hash in production)
-    pair.token0_hash = reserves.pool_id; // Placeholder
-    pair.token1_hash = reserves.dex_id;  // Placeholder
-
-    bool found_pair = false;
-    for (size_t i = 0; i < pair_count_; ++i) {
-        if (pair_groups_[i].pair == pair) {
-            // Add to existing group if not already present
-            auto& group = pair_groups_[i];
-            bool already_in = false;
-            for (uint8_t j = 0; j < group.count; ++j) {
-                if (group.pool_indices[j] == static_cast<uint32_t>(pool_idx)) {
-                    already_in = true;
-                    break;
-                }
-            }
-            if (!already_in && group.count < 32) {
-                group.pool_indices[group.count++] = static_cast<uint32_t>(pool_idx);
-            }
-            found_pair = true;
-            break;
-        }
+    // Regroup if the pool is new, or its pair changed
+    const TokenPair pair{entry.reserves.token0_hash, entry.reserves.token1_hash};
+    if (entry.group != NONE && !(pair_groups_[entry.group].pair == pair)) {
+        const uint32_t old_group = entry.group;
+        remove_from_group(pool_idx);
+        refresh_group(old_group);
+    }
+    if (entry.group == NONE) {
+        add_to_group(pool_idx, pair);
     }
 
-    if (!found_pair && pair_count_ < MAX_PAIRS) {
-        // Create new pair group
-        auto& group = pair_groups_[pair_count_++];
-        group.pair = pair;
-        group.count = 1;
-        group.pool_indices[0] = static_cast<uint32_t>(pool_idx);
+    // Only the pool's own pair can have gained or lost an opportunity
+    if (entry.group != NONE) {
+        member_prices_[pair_groups_[entry.group].first + entry.member] = entry.price_f64;
+        refresh_pool(entry.group, pool_idx);
     }
 }
 
+void OpportunityScanner::update_pools(const PoolReserves* pools, size_t count) {
+    const size_t mask = pool_index_.size() - 1;
+    for (size_t i = 0; i < count; ++i) {
+        if (i + PREFETCH_DISTANCE < count) {
+            const PoolReserves& ahead = pools[i + PREFETCH_DISTANCE];
+            _mm_prefetch(reinterpret_cast<const char*>(&pool_index_[mix64(pool_key(ahead.pool_id, ahead.dex_id)) & mask]),
+                         _MM_HINT_T0);
+        }
+        update_pool(pools[i]);
+    }
+}
+
+size_t OpportunityScanner::drain(PoolRing& ring, size_t max_pools) {
+    return ring.drain([this](const PoolReserves* pools, size_t count) {
+        update_pools(pools, count);
+    }, max_pools);
+}
+
 void OpportunityScanner::recalculate_price(size_t pool_index) {
-    pools_[pool_index].price = calculate_price(pools_[pool_index].reserves);
+    PoolEntry& entry = pools_[pool_index];
+    entry.price = calculate_price(entry.reserves);
+    entry.price_f64 = simd::u256_to_double(entry.price.price);
 }
 
 void OpportunityScanner::clear() {
-    pool_count_ = 0;
-    pair_count_ = 0;
-    std::memset(pools_, 0, sizeof(pools_));
-    std::memset(pair_groups_, 0, sizeof(pair_groups_));
+    pools_.clear();
+    pair_groups_.clear();
+    group_best_.clear();
+    best_heap_.clear();
+    heap_slot_.clear();
+    std::fill(pool_index_.begin(), pool_index_.end(), PoolSlot{0, NONE});
+    std::fill(pair_index_.begin(), pair_index_.end(), PairSlot{{0, 0}, NONE});
 }
 
 size_t OpportunityScanner::pool_count() const {
-    return pool_count_;
+    return pools_.size();
 }
 
 void OpportunityScanner::set_config(const ScannerConfig& config) {
     config_ = config;
+
+    // Every kept opportunity was judged by the old criteria
+    refresh_all();
 }
 
 // ============================================================================
@@ -118,12 +224,9 @@ void OpportunityScanner::set_config(const ScannerConfig& config) {
 size_t OpportunityScanner::scan(std::vector<ArbitrageOpportunity>& opportunities) {
     opportunities.clear();
 
-    // Scan each pair group for opportunities
-    for (size_t i = 0; i < pair_count_; ++i) {
-        if (pair_groups_[i].count >= 2) {
-            scan_pair_group(pair_groups_[i], opportunities);
-        }
-    }
+    scan_with([&](const ArbitrageOpportunity& opp) {
+        opportunities.push_back(opp);
+    });
 
     // Sort by profit (descending)
     std::sort(opportunities.begin(), opportunities.end(),
@@ -135,276 +238,88 @@ size_t OpportunityScanner::scan(std::vector<ArbitrageOpportunity>& opportunities
 }
 
 size_t OpportunityScanner::scan_with_callback(const OpportunityCallback& callback) {
-    size_t count = 0;
-
-    for (size_t i = 0; i < pair_count_; ++i) {
-        if (pair_groups_[i].count >= 2) {
-            // Use SIMD-optimized scanning
-            scan_pair_group_simd(pair_groups_[i], [&](const ArbitrageOpportunity& opp) {
-                callback(opp);
-                ++count;
-            });
-        }
-    }
+    return scan_with(callback);
+}
 
-    return count;
+bool OpportunityScanner::get_best_opportunity(ArbitrageOpportunity& out_opportunity) const {
+    if (best_heap_.empty()) return false;
+    out_opportunity = group_best_[best_heap_[0].group].opportunity;
+    return true;
 }
 
-bool OpportunityScanner::get_best_opportunity(ArbitrageOpportunity& out_opportunity) {
-    ArbitrageOpportunity best;
-    bool found = false;
-
-    for (size_t i = 0; i < pair_count_; ++i) {
-        if (pair_groups_[i].count < 2) continue;
-
-        const auto& group = pair_groups_[i];
-
-        // Compare all pairs of pools
-        for (uint8_t a = 0; a < group.count; ++a) {
-            for (uint8_t b = a + 1; b < group.count; ++b) {
-                const auto& pool_a = pools_[group.pool_indices[a]];
-                const auto& pool_b = pools_[group.pool_indices[b]];
-
-                if (!pool_a.valid || !pool_b.valid) continue;
-
-                // Check both directions
-                int64_t spread_ab = calculate_spread_bps(pool_a.price, pool_b.price);
-                int64_t spread_ba = calculate_spread_bps(pool_b.price, pool_a.price);
-
-                ArbitrageOpportunity opp;
-
-                if (spread_ab >= config_.min_spread_bps) {
-                    opp.buy_pool_id = pool_a.reserves.pool_id;
-                    opp.buy_dex_id = pool_a.reserves.dex_id;
-                    opp.sell_pool_id = pool_b.reserves.pool_id;
-                    opp.sell_dex_id = pool_b.reserves.dex_id;
-                    opp.buy_price = pool_a.price.price;
-                    opp.sell_price = pool_b.price.price;
-                    opp.spread_bps = spread_ab;
-                    opp.timestamp_ms = std::max(pool_a.reserves.timestamp_ms,
-                                                pool_b.reserves.timestamp_ms);
-
-                    // Calculate optimal size and profit
-                    opp.max_amount = calculate_optimal_trade_size(
-                        pool_a.reserves.reserve0, pool_a.reserves.reserve1,
-                        pool_b.reserves.reserve0, pool_b.reserves.reserve1
-                    );
-                    opp.estimated_profit = calculate_arbitrage_profit(
-                        pool_a.reserves, pool_b.reserves, opp.max_amount
-                    );
-
-                    if (meets_criteria(opp)) {
-                        if (!found || simd::cmp_u256(opp.estimated_profit, best.estimated_profit) > 0) {
-                            best = opp;
-                            found = true;
-                        }
-                    }
-                }
-
-                if (spread_ba >= config_.min_spread_bps) {
-                    opp.buy_pool_id = pool_b.reserves.pool_id;
-                    opp.buy_dex_id = pool_b.reserves.dex_id;
-                    opp.sell_pool_id = pool_a.reserves.pool_id;
-                    opp.sell_dex_id = pool_a.reserves.dex_id;
-                    opp.buy_price = pool_b.price.price;
-                    opp.sell_price = pool_a.price.price;
-                    opp.spread_bps = spread_ba;
-                    opp.timestamp_ms = std::max(pool_a.reserves.timestamp_ms,
-                                                pool_b.reserves.timestamp_ms);
-
-                    opp.max_amount = calculate_optimal_trade_size(
-                        pool_b.reserves.reserve0, pool_b.reserves.reserve1,
-                        pool_a.reserves.reserve0, pool_a.reserves.reserve1
-                    );
-                    opp.estimated_profit = calculate_arbitrage_profit(
-                        pool_b.reserves, pool_a.reserves, opp.max_amount
-                    );
-
-                    if (meets_criteria(opp)) {
-                        if (!found || simd::cmp_u256(opp.estimated_profit, best.estimated_profit) > 0) {
-                            best = opp;
-                            found = true;
-                        }
-                    }
-                }
+size_t OpportunityScanner::top_opportunities(ArbitrageOpportunity* out, size_t max_count) const {
+    if (!out || max_count == 0 || best_heap_.empty()) return 0;
+
+    // Best-first walk of the heap: the next best is always the frontier's
+    // best, and popping one adds at most its two children
+    auto frontier_less = [this](uint32_t a, uint32_t b) {
+        return better(best_heap_[b], best_heap_[a]);
+    };
+    top_frontier_.clear();
+    top_frontier_.push_back(0);
+
+    size_t written = 0;
+    while (written < max_count && !top_frontier_.empty()) {
+        std::pop_heap(top_frontier_.begin(), top_frontier_.end(), frontier_less);
+        const uint32_t position = top_frontier_.back();
+        top_frontier_.pop_back();
+        out[written++] = group_best_[best_heap_[position].group].opportunity;
+
+        for (uint32_t child = 2 * position + 1; child <= 2 * position + 2; ++child) {
+            if (child < best_heap_.size()) {
+                top_frontier_.push_back(child);
+                std::push_heap(top_frontier_.begin(), top_frontier_.end(), frontier_less);
             }
         }
     }
-
-    if (found) {
-        out_opportunity = best;
-    }
-    return found;
+    return written;
 }
 
 // ============================================================================
 // INTERNAL METHODS
 // ============================================================================
 
-void OpportunityScanner::scan_pair_group(
-    const PairGroup& group,
-    std::vector<ArbitrageOpportunity>& out
-) {
-    // Compare all pairs of pools in the group
-    for (uint8_t a = 0; a < group.count; ++a) {
-        for (uint8_t b = a + 1; b < group.count; ++b) {
-            const auto& pool_a = pools_[group.pool_indices[a]];
-            const auto& pool_b = pools_[group.pool_indices[b]];
-
-            if (!pool_a.valid || !pool_b.valid) continue;
-
-            // Skip same-DEX if configured
-            if (!config_.include_same_dex &&
-                pool_a.reserves.dex_id == pool_b.reserves.dex_id) {
-                continue;
-            }
+bool OpportunityScanner::make_opportunity(
+    uint32_t buy,
+    uint32_t sell,
+    int64_t spread_bps,
+    ArbitrageOpportunity& out
+) const {
+    const auto& pool_a = pools_[buy];
+    const auto& pool_b = pools_[sell];
 
-            // Check both directions
-            int64_t spread_ab = calculate_spread_bps(pool_a.price, pool_b.price);
-            int64_t spread_ba = calculate_spread_bps(pool_b.price, pool_a.price);
-
-            if (spread_ab >= config_.min_spread_bps) {
-                ArbitrageOpportunity opp;
-                opp.buy_pool_id = pool_a.reserves.pool_id;
-                opp.buy_dex_id = pool_a.reserves.dex_id;
-                opp.sell_pool_id = pool_b.reserves.pool_id;
-                opp.sell_dex_id = pool_b.reserves.dex_id;
-                opp.buy_price = pool_a.price.price;
-                opp.sell_price = pool_b.price.price;
-                opp.spread_bps = spread_ab;
-                opp.timestamp_ms = std::max(pool_a.reserves.timestamp_ms,
-                                            pool_b.reserves.timestamp_ms);
-
-                opp.max_amount = calculate_optimal_trade_size(
-                    pool_a.reserves.reserve0, pool_a.reserves.reserve1,
-                    pool_b.reserves.reserve0, pool_b.reserves.reserve1
-                );
-                opp.estimated_profit = calculate_arbitrage_profit(
-                    pool_a.reserves, pool_b.reserves, opp.max_amount
-                );
-
-                if (meets_criteria(opp)) {
-                    out.push_back(opp);
-                }
-            }
-
-            if (spread_ba >= config_.min_spread_bps) {
-                ArbitrageOpportunity opp;
-                opp.buy_pool_id = pool_b.reserves.pool_id;
-                opp.buy_dex_id = pool_b.reserves.dex_id;
-                opp.sell_pool_id = pool_a.reserves.pool_id;
-                opp.sell_dex_id = pool_a.reserves.dex_id;
-                opp.buy_price = pool_b.price.price;
-                opp.sell_price = pool_a.price.price;
-                opp.spread_bps = spread_ba;
-                opp.timestamp_ms = std::max(pool_a.reserves.timestamp_ms,
-                                            pool_b.reserves.timestamp_ms);
-
-                opp.max_amount = calculate_optimal_trade_size(
-                    pool_b.reserves.reserve0, pool_b.reserves.reserve1,
-                    pool_a.reserves.reserve0, pool_a.reserves.reserve1
-                );
-                opp.estimated_profit = calculate_arbitrage_profit(
-                    pool_b.reserves, pool_a.reserves, opp.max_amount
-                );
-
-                if (meets_criteria(opp)) {
-                    out.push_back(opp);
-                }
-            }
-        }
-    }
-}
+    if (!pool_a.valid || !pool_b.valid) return false;
 
-void OpportunityScanner::scan_pair_group_simd(
-    const PairGroup& group,
-    const OpportunityCallback& callback
-) {
-    // SIMD-optimized scanning for groups with many pools
-    // Process 4 price comparisons at once
-
-    if (group.count < 4) {
-        // Fall back to scalar for small groups
-        std::vector<ArbitrageOpportunity> opps;
-        scan_pair_group(group, opps);
-        for (const auto& opp : opps) {
-            callback(opp);
-        }
-        return;
-    }
-
-    // Extract prices into aligned arrays
-    alignas(32) double prices[32];
-    for (uint8_t i = 0; i < group.count && i < 32; ++i) {
-        prices[i] = simd::u256_to_double(pools_[group.pool_indices[i]].price.price);
+    // Skip same-DEX if configured
+    if (!config_.include_same_dex &&
+        pool_a.reserves.dex_id == pool_b.reserves.dex_id) {
+        return false;
     }
 
-    // Compare prices using SIMD
-    for (uint8_t a = 0; a < group.count; ++a) {
-        // Load price_a into all lanes
-        f64x4 price_a = _mm256_set1_pd(prices[a]);
-
-        // Process 4 pools at a time
-        for (uint8_t b = 0; b + 4 <= group.count; b += 4) {
-            if (b == a || b + 1 == a || b + 2 == a || b + 3 == a) {
-                // Skip if a is in this batch (handle individually)
-                continue;
-            }
-
-            f64x4 price_b = simd::load_f64x4(&prices[b]);
-
-            // Calculate spreads: (price_b - price_a) / price_a * 10000
-            f64x4 diff = simd::sub_f64x4(price_b, price_a);
-            f64x4 ratio = simd::div_f64x4(diff, price_a);
-            f64x4 bps = simd::mul_f64x4(ratio, _mm256_set1_pd(10000.0));
-
-            // Extract and check spreads
-            alignas(32) double spreads[4];
-            simd::store_f64x4(spreads, bps);
-
-            for (int i = 0; i < 4; ++i) {
-                int64_t spread = static_cast<int64_t>(spreads[i]);
-                if (spread >= config_.min_spread_bps) {
-                    const auto& pool_a = pools_[group.pool_indices[a]];
-                    const auto& pool_b = pools_[group.pool_indices[b + i]];
-
-                    if (!config_.include_same_dex &&
-                        pool_a.reserves.dex_id == pool_b.reserves.dex_id) {
-                        continue;
-                    }
-
-                    ArbitrageOpportunity opp;
-                    opp.buy_pool_id = pool_a.reserves.pool_id;
-                    opp.buy_dex_id = pool_a.reserves.dex_id;
-                    opp.sell_pool_id = pool_b.reserves.pool_id;
-                    opp.sell_dex_id = pool_b.reserves.dex_id;
-                    opp.buy_price = pool_a.price.price;
-                    opp.sell_price = pool_b.price.price;
-                    opp.spread_bps = spread;
-                    opp.timestamp_ms = std::max(pool_a.reserves.timestamp_ms,
-                                                pool_b.reserves.timestamp_ms);
-
-                    opp.max_amount = calculate_optimal_trade_size(
-                        pool_a.reserves.reserve0, pool_a.reserves.reserve1,
-                        pool_b.reserves.reserve0, pool_b.reserves.reserve1
-                    );
-                    opp.estimated_profit = calculate_arbitrage_profit(
-                        pool_a.reserves, pool_b.reserves, opp.max_amount
-                    );
-
-                    if (meets_criteria(opp)) {
-                        callback(opp);
-                    }
-                }
-            }
-        }
+    out.buy_pool_id = pool_a.reserves.pool_id;
+    out.buy_dex_id = pool_a.reserves.dex_id;
+    out.sell_pool_id = pool_b.reserves.pool_id;
+    out.sell_dex_id = pool_b.reserves.dex_id;
+    out.buy_price = pool_a.price.price;
+    out.sell_price = pool_b.price.price;
+    out.spread_bps = spread_bps;
+    out.timestamp_ms = std::max(pool_a.reserves.timestamp_ms,
+                                pool_b.reserves.timestamp_ms);
+
+    out.max_amount = calculate_optimal_trade_size(
+        pool_a.reserves.reserve0, pool_a.reserves.reserve1,
+        pool_b.reserves.reserve0, pool_b.reserves.reserve1
+    );
+
+    // Reject on size before simulating the swaps (no size: no profit)
+    if (out.max_amount.is_zero() || simd::cmp_u256(out.max_amount, config_.max_position_size) > 0) {
+        return false;
     }
-}
+    out.estimated_profit = calculate_arbitrage_profit(
+        pool_a.reserves, pool_b.reserves, out.max_amount
+    );
 
-int64_t OpportunityScanner::calculate_spread_bps(const PriceResult& buy, const PriceResult& sell) {
-    double buy_price = simd::u256_to_double(buy.price);
-    double sell_price = simd::u256_to_double(sell.price);
-    return detail::spread_bps_fast(buy_price, sell_price);
+    return meets_criteria(out);
 }
 
 bool OpportunityScanner::meets_criteria(const ArbitrageOpportunity& opp) const {
@@ -426,4 +341,145 @@ bool OpportunityScanner::meets_criteria(const ArbitrageOpportunity& opp) const {
     return true;
 }
 
+// ============================================================================
+// BEST OPPORTUNITY TRACKING
+// ============================================================================
+
+void OpportunityScanner::offer(uint32_t buy, uint32_t sell, int64_t spread_bps, GroupBest& best) const {
+    // Most candidates cannot beat the kept best: skip their exact profit
+    if (best.buy != NONE &&
+        !(arbitrage_profit_bound(pools_[buy].reserves, pools_[sell].reserves) >
+          simd::u256_to_double(best.opportunity.estimated_profit))) {
+        return;
+    }
+
+    ArbitrageOpportunity candidate;
+    if (!make_opportunity(buy, sell, spread_bps, candidate)) return;
+    if (best.buy == NONE ||
+        simd::cmp_u256(candidate.estimated_profit, best.opportunity.estimated_profit) > 0) {
+        best.opportunity = candidate;
+        best.buy = buy;
+        best.sell = sell;
+    }
+}
+
+void OpportunityScanner::refresh_group(uint32_t group_index) {
+    GroupBest& best = group_best_[group_index];
+    best.buy = NONE;
+    best.sell = NONE;
+
+    const PairGroup& group = pair_groups_[group_index];
+    if (group.count >= 2) {
+        for_each_spread(group, [&](uint32_t buy, uint32_t sell, int64_t spread) {
+            offer(buy, sell, spread, best);
+        });
+    }
+    heap_update(group_index);
+}
+
+void OpportunityScanner::refresh_pool(uint32_t group_index, uint32_t pool_index) {
+    GroupBest& best = group_best_[group_index];
+
+    // The old best may have been this pool's: only a full pass finds the
+    // runner-up
+    if (best.buy == pool_index || best.sell == pool_index) {
+        refresh_group(group_index);
+        return;
+    }
+
+    // Otherwise every other pair is unchanged; compare this pool with them
+    const PairGroup& group = pair_groups_[group_index];
+    const uint32_t* pool_indices = members(group);
+    const double* member_price = member_prices(group);
+    const double price = pools_[pool_index].price_f64;
+    for (uint32_t i = 0; i < group.count; ++i) {
+        const uint32_t other = pool_indices[i];
+        if (other == pool_index) continue;
+
+        const int64_t spread_buy = detail::spread_bps_fast(price, member_price[i]);
+        if (spread_buy >= config_.min_spread_bps) offer(pool_index, other, spread_buy, best);
+
+        const int64_t spread_sell = detail::spread_bps_fast(member_price[i], price);
+        if (spread_sell >= config_.min_spread_bps) offer(other, pool_index, spread_sell, best);
+    }
+    heap_update(group_index);
+}
+
+void OpportunityScanner::refresh_all() {
+    for (uint32_t g = 0; g < pair_groups_.size(); ++g) {
+        refresh_group(g);
+    }
+}
+
+void OpportunityScanner::heap_update(uint32_t group_index) {
+    const uint32_t position = heap_slot_[group_index];
+    const GroupBest& best = group_best_[group_index];
+
+    if (best.buy == NONE) {
+        if (position != NONE) heap_remove(position);
+        return;
+    }
+
+    if (position == NONE) {
+        heap_slot_[group_index] = static_cast<uint32_t>(best_heap_.size());
+        best_heap_.push_back({best.opportunity.estimated_profit, group_index});
+        heap_sift_up(heap_slot_[group_index]);
+        return;
+    }
+
+    // Most updates leave the pair's best profit where it was
+    HeapEntry& entry = best_heap_[position];
+    const int order = simd::cmp_u256(best.opportunity.estimated_profit, entry.profit);
+    if (order == 0) return;
+    entry.profit = best.opportunity.estimated_profit;
+    if (order > 0) {
+        heap_sift_up(position);
+    } else {
+        heap_sift_down(position);
+    }
+}
+
+void OpportunityScanner::heap_remove(uint32_t position) {
+    const uint32_t removed = best_heap_[position].group;
+    const HeapEntry last = best_heap_.back();
+    best_heap_.pop_back();
+    heap_slot_[removed] = NONE;
+
+    if (position < best_heap_.size()) {
+        best_heap_[position] = last;
+        heap_slot_[last.group] = position;
+        heap_sift_up(position);
+        heap_sift_down(heap_slot_[last.group]);
+    }
+}
+
+void OpportunityScanner::heap_sift_up(uint32_t position) {
+    const HeapEntry entry = best_heap_[position];
+    while (position > 0) {
+        const uint32_t parent = (position - 1) / 2;
+        if (!better(entry, best_heap_[parent])) break;
+        best_heap_[position] = best_heap_[parent];
+        heap_slot_[best_heap_[position].group] = position;
+        position = parent;
+    }
+    best_heap_[position] = entry;
+    heap_slot_[entry.group] = position;
+}
+
+void OpportunityScanner::heap_sift_down(uint32_t position) {
+    const HeapEntry entry = best_heap_[position];
+    const auto size = static_cast<uint32_t>(best_heap_.size());
+    for (;;) {
+        uint32_t child = 2 * position + 1;
+        if (child >= size) break;
+        if (child + 1 < size && better(best_heap_[child + 1], best_heap_[child])) ++child;
+        if (!better(best_heap_[child], entry)) break;
+        best_heap_[position] = best_heap_[child];
+        heap_slot_[best_heap_[position].group] = position;
+        position = child;
+    }
+    best_heap_[position] = entry;
+    heap_slot_[entry.group] = position;
+}
+
 } // namespace matrix::hotpath
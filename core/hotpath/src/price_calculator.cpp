@@ -9,6 +9,190 @@
 
 namespace matrix::hotpath {
 
+namespace {
+
+using u128 = __uint128_t;
+using i128 = __int128;
+
+constexpr double TWO_64 = 18446744073709551616.0;
+constexpr double PRICE_SCALE = static_cast<double>(PRICE_PRECISION);
+
+// Prices below this (with margin) have a 64-bit quotient: one hardware
+// 128 / 64 division when reserve0 fits in 64 bits
+constexpr double NARROW_PRICE_LIMIT = 18e18;
+
+// Below these the remainder of a double estimate stays far inside signed
+// 128 bits (reserves < 2^112, estimate < 2^100), so it can be refined from
+// wrapped low halves; anything else takes the full 256-bit division.
+// Quotients below 2^62 are refined in 64-bit arithmetic.
+constexpr u128 EXACT_RESERVE_LIMIT = static_cast<u128>(1) << 112;
+constexpr double SHORT_PRICE_LIMIT = 4611686018427387904.0;                // 2^62
+constexpr double EXACT_PRICE_LIMIT = 1267650600228229401496703205376.0;   // 2^100
+constexpr int MAX_FIXUPS = 4;
+
+inline double to_double(u128 v) {
+    return static_cast<double>(static_cast<uint64_t>(v >> 64)) * TWO_64 +
+           static_cast<double>(static_cast<uint64_t>(v));
+}
+
+inline double to_double(i128 v) {
+    return static_cast<double>(static_cast<int64_t>(v >> 64)) * TWO_64 +
+           static_cast<double>(static_cast<uint64_t>(v));
+}
+
+/// Truncation of a non-negative double below 2^100
+inline u128 to_u128(double v) {
+    const auto hi = static_cast<uint64_t>(v * (1.0 / TWO_64));
+    // Exact: the difference is a multiple of v's ulp below 2^64
+    const auto lo = static_cast<uint64_t>(v - static_cast<double>(hi) * TWO_64);
+    return (static_cast<u128>(hi) << 64) | lo;
+}
+
+/// n / d for a quotient known to fit in 64 bits
+inline uint64_t div_narrow(u128 n, uint64_t d) {
+#if defined(__x86_64__)
+    uint64_t q, r;
+    __asm__("divq %4" : "=a"(q), "=d"(r) : "a"(static_cast<uint64_t>(n)), "d"(static_cast<uint64_t>(n >> 64)), "rm"(d));
+    return q;
+#else
+    return static_cast<uint64_t>(n / d);
+#endif
+}
+
+/// Full 256-by-128-bit division, kept out of line so the lane loop stays small
+[[gnu::noinline]] u128 wide_price(u128 r0, u128 r1) {
+    return swap::mul_div(r1, PRICE_PRECISION, r0);
+}
+
+/// Bring rem = num - q * r0 into [0, r0), false if the estimate was
+/// further off than a few units
+template<typename Q>
+inline bool settle(Q& q, i128& rem, u128 r0) {
+    for (int fixup = 0; fixup < MAX_FIXUPS; ++fixup) {
+        if (rem < 0) {
+            --q;
+            rem += static_cast<i128>(r0);
+        } else if (rem >= static_cast<i128>(r0)) {
+            ++q;
+            rem -= static_cast<i128>(r0);
+        } else {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * floor(r1 * 10^18 / r0) for r0 != 0, from a double estimate of it and of
+ * 1 / r0
+ *
+ * A 64-bit quotient over a 64-bit r0 is one hardware division. Otherwise
+ * the estimate is close to 2^-49 relative, so num - q * r0 fits in signed
+ * 128 bits and the wrapped low halves of both products give it exactly;
+ * one reciprocal step and a few +-1 fixups land on the quotient without
+ * dividing. Only reserves or prices beyond those bounds take the 256-bit
+ * division.
+ */
+inline u128 exact_price(u128 r0, u128 r1, double estimate, double reciprocal) {
+    if ((r0 >> 64) == 0 && estimate < NARROW_PRICE_LIMIT) {
+        return div_narrow(r1 * PRICE_PRECISION, static_cast<uint64_t>(r0));
+    }
+
+    if (r0 < EXACT_RESERVE_LIMIT && r1 < EXACT_RESERVE_LIMIT) {
+        const u128 num = r1 * PRICE_PRECISION;
+
+        if (estimate < SHORT_PRICE_LIMIT) {
+            auto q = static_cast<int64_t>(estimate);
+            auto rem = static_cast<i128>(num - static_cast<u128>(q) * r0);
+            const auto step = static_cast<int64_t>(to_double(rem) * reciprocal);
+            q += step;
+            rem -= static_cast<i128>(step) * static_cast<i128>(r0);
+            if (settle(q, rem, r0)) return static_cast<u128>(q);
+        } else if (estimate < EXACT_PRICE_LIMIT) {
+            u128 q = to_u128(estimate);
+            auto rem = static_cast<i128>(num - q * r0);
+            const auto step = static_cast<i128>(static_cast<int64_t>(to_double(rem) * reciprocal));
+            q += static_cast<u128>(step);
+            rem = static_cast<i128>(num - q * r0);
+            if (settle(q, rem, r0)) return q;
+        }
+    }
+    return wide_price(r0, r1);
+}
+
+/// Liquidity tier from reserve0 * reserve1 (the squares of the
+/// sqrt(reserve0 * reserve1) thresholds, so no sqrt is needed)
+inline int64_t confidence_tier(double reserve_product) {
+    if (reserve_product >= 1e48) return 10000;  // 100%
+    if (reserve_product >= 1e42) return 9000;   // 90%
+    if (reserve_product >= 1e36) return 7000;   // 70%
+    return 3000;                                // 30%
+}
+
+inline u128 lane_reserve(const uint64_t* lo, const uint64_t* hi, size_t lane) {
+    return (static_cast<u128>(hi[lane]) << 64) | lo[lane];
+}
+
+inline void set_result(PriceResult& result, const detail::LanePrices& prices, size_t lane,
+                       uint64_t timestamp_ms, uint32_t pool_id, uint32_t dex_id) {
+    result.price = U256::from_u128(prices.price[lane]);
+    result.timestamp_ms = timestamp_ms;
+    result.pool_id = pool_id;
+    result.dex_id = dex_id;
+    result.confidence = prices.confidence[lane];
+}
+
+/// Price one batch's lanes and write the kept ones, compacted
+size_t price_batch(const PoolBatch& batch, const double* reference_prices,
+                   int64_t min_deviation_bps, PriceResult* results) {
+    detail::ReserveLanes lanes{};
+    for (size_t i = 0; i < batch.count; ++i) {
+        lanes.set(i, batch.pools[i]);
+    }
+
+    detail::LanePrices prices;
+    detail::price_lanes(lanes, batch.count, reference_prices, min_deviation_bps, prices);
+
+    size_t written = 0;
+    for (size_t i = 0; i < batch.count; ++i) {
+        if ((prices.kept & (1u << i)) == 0) continue;
+        const auto& pool = batch.pools[i];
+        set_result(results[written++], prices, i, pool.timestamp_ms, pool.pool_id, pool.dex_id);
+    }
+    return written;
+}
+
+// ============================================================================
+// ROUND TRIP
+// ============================================================================
+
+constexpr double ROUND_TRIP_FEE_FACTOR = 0.997; // Per swap
+
+// Both swaps as one virtual constant-product pool (token1 in, token1
+// out): x = x1 * x2 / (x2 + g * y1), y = g * y1 * y2 / (x2 + g * y1)
+struct VirtualPool {
+    double in;
+    double out;
+};
+
+bool virtual_pool(const U256& reserve0_buy, const U256& reserve1_buy,
+                  const U256& reserve0_sell, const U256& reserve1_sell, VirtualPool& pool) {
+    double x1 = simd::u256_to_double(reserve1_buy);   // token1 in
+    double y1 = simd::u256_to_double(reserve0_buy);   // token0 out
+    double x2 = simd::u256_to_double(reserve0_sell);  // token0 in
+    double y2 = simd::u256_to_double(reserve1_sell);  // token1 out
+
+    const double denominator = x2 + ROUND_TRIP_FEE_FACTOR * y1;
+    if (denominator <= 0) {
+        return false;
+    }
+    pool.in = x1 * x2 / denominator;
+    pool.out = ROUND_TRIP_FEE_FACTOR * y1 * y2 / denominator;
+    return true;
+}
+
+} // anonymous namespace
+
 // ============================================================================
 // SINGLE POOL PRICE CALCULATION
 // ============================================================================
@@ -19,63 +203,22 @@ PriceResult calculate_price(const PoolReserves& reserves) {
     result.dex_id = reserves.dex_id;
     result.timestamp_ms = reserves.timestamp_ms;
 
-    // Handle zero reserves
-    if (reserves.reserve0.is_zero()) {
-        result.price = U256(0);
-        result.confidence = 0;
-        return result;
-    }
-
-    // Calculate price = reserve1 / reserve0 * 10^18
     // For most DeFi pools, reserves fit in 128 bits
-    // Use __uint128_t for intermediate calculation
-
-    __uint128_t r0 = reserves.reserve0.low128();
-    __uint128_t r1 = reserves.reserve1.low128();
+    const u128 r0 = reserves.reserve0.low128();
+    const u128 r1 = reserves.reserve1.low128();
 
+    // Handle zero reserves
     if (r0 == 0) {
         result.price = U256(0);
         result.confidence = 0;
         return result;
     }
 
-    // Multiply by precision first to avoid precision loss
-    __uint128_t precision = PRICE_PRECISION;
-    __uint128_t price_128;
-
-    // Check for overflow: if r1 * precision would overflow 128 bits
-    if (r1 > (static_cast<__uint128_t>(-1) / precision)) {
-        // Scale down both to avoid overflow
-        __uint128_t scale = r1 / (static_cast<__uint128_t>(1) << 64);
-        if (scale == 0) scale = 1;
-        r1 /= scale;
-        r0 /= scale;
-        if (r0 == 0) r0 = 1;
-    }
-
-    price_128 = (r1 * precision) / r0;
-
-    // Store in U256
-    result.price.limbs[0] = static_cast<uint64_t>(price_128);
-    result.price.limbs[1] = static_cast<uint64_t>(price_128 >> 64);
-
-    // Calculate confidence based on liquidity depth
-    // geometric_mean = sqrt(reserve0 * reserve1)
-    double r0_d = static_cast<double>(reserves.reserve0.low64());
-    double r1_d = static_cast<double>(reserves.reserve1.low64());
-    double liquidity = std::sqrt(r0_d * r1_d);
-
-    // Confidence scoring (simplified)
-    if (liquidity >= 1e24) {
-        result.confidence = 10000; // 100%
-    } else if (liquidity >= 1e21) {
-        result.confidence = 9000;  // 90%
-    } else if (liquidity >= 1e18) {
-        result.confidence = 7000;  // 70%
-    } else {
-        result.confidence = 3000;  // 30%
-    }
-
+    const double r0_d = to_double(r0);
+    const double r1_d = to_double(r1);
+    const double reciprocal = 1.0 / r0_d;
+    result.price = U256::from_u128(exact_price(r0, r1, r1_d * PRICE_SCALE * reciprocal, reciprocal));
+    result.confidence = confidence_tier(r0_d * r1_d);
     return result;
 }
 
@@ -83,45 +226,66 @@ PriceResult calculate_price(const PoolReserves& reserves) {
 // BATCH PRICE CALCULATION
 // ============================================================================
 
-void calculate_prices_batch(const PoolBatch& batch, PriceResult* results) {
-    // Process in groups of 4 for SIMD efficiency
-    size_t i = 0;
-
-    // SIMD path: process 4 pools at a time using approximate double math
-    // for the fast path, then refine with exact calculation if needed
-    for (; i + 4 <= batch.count; i += 4) {
-        alignas(32) uint64_t reserve0_lows[4];
-        alignas(32) uint64_t reserve1_lows[4];
-        alignas(32) double prices_approx[4];
+namespace detail {
 
-        // Extract low 64 bits of reserves
-        for (int j = 0; j < 4; ++j) {
-            reserve0_lows[j] = batch.pools[i + j].reserve0.low64();
-            reserve1_lows[j] = batch.pools[i + j].reserve1.low64();
+void price_lanes(
+    const ReserveLanes& lanes,
+    size_t count,
+    const double* reference_prices,
+    int64_t min_deviation_bps,
+    LanePrices& out
+) {
+    // Every lane's estimate and reserve product in one dispatched pass
+    alignas(64) double estimates[SIMD_BATCH_SIZE];
+    alignas(64) double reciprocals[SIMD_BATCH_SIZE];
+    alignas(64) double products[SIMD_BATCH_SIZE];
+    simd::ratio_u128x8(lanes.reserve1_lo, lanes.reserve1_hi, lanes.reserve0_lo, lanes.reserve0_hi,
+                       PRICE_SCALE, estimates, reciprocals, products);
+
+    uint32_t kept = (1u << count) - 1;
+
+    // Early reject on the estimates, before any integer work
+    if (reference_prices) {
+        const double tolerance = static_cast<double>(min_deviation_bps) / BPS_PRECISION;
+        kept = 0;
+        for (size_t i = 0; i < count; ++i) {
+            const bool empty = (lanes.reserve0_lo[i] | lanes.reserve0_hi[i]) == 0;
+            const double approx = empty ? 0.0 : estimates[i];
+            const double reference = reference_prices[i];
+            if (!(reference > 0.0) || std::fabs(approx - reference) > tolerance * reference) {
+                kept |= 1u << i;
+            }
         }
+    }
 
-        // Fast SIMD price approximation
-        detail::fast_price_approx_x4(reserve0_lows, reserve1_lows, prices_approx);
-
-        // Convert to full precision results
-        for (int j = 0; j < 4; ++j) {
-            const auto& pool = batch.pools[i + j];
-            auto& result = results[i + j];
-
-            result.pool_id = pool.pool_id;
-            result.dex_id = pool.dex_id;
-            result.timestamp_ms = pool.timestamp_ms;
-
-            // Use exact calculation for the final result
-            // The SIMD approximation was for potential early filtering
-            result = calculate_price(pool);
+    for (uint32_t pending = kept; pending != 0; pending &= pending - 1) {
+        const auto i = static_cast<size_t>(__builtin_ctz(pending));
+        const u128 r0 = lane_reserve(lanes.reserve0_lo, lanes.reserve0_hi, i);
+        if (r0 == 0) {
+            out.price[i] = 0;
+            out.confidence[i] = 0;
+            continue;
         }
+        const u128 r1 = lane_reserve(lanes.reserve1_lo, lanes.reserve1_hi, i);
+        out.price[i] = exact_price(r0, r1, estimates[i], reciprocals[i]);
+        out.confidence[i] = confidence_tier(products[i]);
     }
+    out.kept = kept;
+}
 
-    // Scalar remainder
-    for (; i < batch.count; ++i) {
-        results[i] = calculate_price(batch.pools[i]);
-    }
+} // namespace detail
+
+void calculate_prices_batch(const PoolBatch& batch, PriceResult* results) {
+    price_batch(batch, nullptr, 0, results);
+}
+
+size_t calculate_prices_filtered(
+    const PoolBatch& batch,
+    const double* reference_prices,
+    int64_t min_deviation_bps,
+    PriceResult* results
+) {
+    return price_batch(batch, reference_prices, min_deviation_bps, results);
 }
 
 // ============================================================================
@@ -131,36 +295,14 @@ void calculate_prices_batch(const PoolBatch& batch, PriceResult* results) {
 U256 calculate_swap_output(const U256& reserve_in, const U256& reserve_out, const U256& amount_in) {
     // Constant product AMM formula with 0.3% fee:
     // amountOut = (reserveOut * amountIn * 997) / (reserveIn * 1000 + amountIn * 997)
+    // (9970 / 10000 in the shared kernel - same result, exact 256-bit numerator)
 
     if (reserve_in.is_zero() || amount_in.is_zero()) {
         return U256(0);
     }
 
-    // Use 128-bit math for most cases
-    __uint128_t r_in = reserve_in.low128();
-    __uint128_t r_out = reserve_out.low128();
-    __uint128_t a_in = amount_in.low128();
-
-    // amountIn * 997
-    __uint128_t amount_in_with_fee = a_in * 997;
-
-    // numerator = reserveOut * amountIn * 997
-    __uint128_t numerator = r_out * amount_in_with_fee;
-
-    // denominator = reserveIn * 1000 + amountIn * 997
-    __uint128_t denominator = r_in * 1000 + amount_in_with_fee;
-
-    if (denominator == 0) {
-        return U256(0);
-    }
-
-    __uint128_t result = numerator / denominator;
-
-    U256 output;
-    output.limbs[0] = static_cast<uint64_t>(result);
-    output.limbs[1] = static_cast<uint64_t>(result >> 64);
-
-    return output;
+    return U256::from_u128(swap::get_amount_out(
+        amount_in.low128(), reserve_in.low128(), reserve_out.low128(), DEFAULT_FEE_BPS));
 }
 
 void calculate_swap_outputs_batch(
@@ -170,44 +312,22 @@ void calculate_swap_outputs_batch(
     U256* amounts_out,
     size_t count
 ) {
-    // For batch processing, we can use SIMD for the main calculation
-    // but need to be careful with 128-bit overflow
+    const __uint128_t r_in = reserve_in.low128();
+    const __uint128_t r_out = reserve_out.low128();
 
-    __uint128_t r_in = reserve_in.low128();
-    __uint128_t r_out = reserve_out.low128();
-
-    // Process 4 at a time using SIMD for the multiplications
+    // Four independent exact divisions per step
     size_t i = 0;
     for (; i + 4 <= count; i += 4) {
-        // Extract amounts
-        alignas(32) uint64_t a_in_low[4];
+        __uint128_t a_in[4];
+        __uint128_t a_out[4];
         for (int j = 0; j < 4; ++j) {
-            a_in_low[j] = amounts_in[i + j].low64();
+            a_in[j] = amounts_in[i + j].low128();
         }
 
-        // SIMD multiply by 997 (using double approximation for speed)
-        f64x4 amounts = simd::cvt_u64x4_to_f64x4(simd::load_aligned(a_in_low));
-        f64x4 fee_mult = _mm256_set1_pd(997.0);
-        f64x4 r_out_vec = _mm256_set1_pd(static_cast<double>(r_out));
-        f64x4 r_in_vec = _mm256_set1_pd(static_cast<double>(r_in));
-
-        // numerator = r_out * amount * 997
-        f64x4 numerator = simd::mul_f64x4(simd::mul_f64x4(r_out_vec, amounts), fee_mult);
-
-        // denominator = r_in * 1000 + amount * 997
-        f64x4 denominator = simd::add_f64x4(
-            simd::mul_f64x4(r_in_vec, _mm256_set1_pd(1000.0)),
-            simd::mul_f64x4(amounts, fee_mult)
-        );
-
-        f64x4 result = simd::div_f64x4(numerator, denominator);
-
-        // Store results
-        alignas(32) double results_d[4];
-        simd::store_f64x4(results_d, result);
+        swap::get_amounts_out(a_in, r_in, r_out, DEFAULT_FEE_BPS, a_out);
 
         for (int j = 0; j < 4; ++j) {
-            amounts_out[i + j] = simd::double_to_u256(results_d[j]);
+            amounts_out[i + j] = U256::from_u128(a_out[j]);
         }
     }
 
@@ -253,27 +373,40 @@ U256 calculate_optimal_trade_size(
     const U256& reserve0_buy, const U256& reserve1_buy,
     const U256& reserve0_sell, const U256& reserve1_sell
 ) {
-    // Optimal arbitrage size formula (simplified):
-    // sqrt(reserve0_buy * reserve1_buy * reserve0_sell * reserve1_sell * 997^2 / 1000^2)
-    // - reserve0_buy
-
-    double r0_buy = simd::u256_to_double(reserve0_buy);
-    double r1_buy = simd::u256_to_double(reserve1_buy);
-    double r0_sell = simd::u256_to_double(reserve0_sell);
-    double r1_sell = simd::u256_to_double(reserve1_sell);
-
-    double fee_factor = 0.997 * 0.997; // Two swaps
+    // The virtual pool's optimal input is (sqrt(g * x * y) - x) / g
+    VirtualPool pool;
+    if (!virtual_pool(reserve0_buy, reserve1_buy, reserve0_sell, reserve1_sell, pool)) {
+        return U256(0);
+    }
 
-    double geometric_mean = std::sqrt(r0_buy * r1_buy * r0_sell * r1_sell * fee_factor);
-    double optimal = geometric_mean - r0_buy;
+    constexpr double g = ROUND_TRIP_FEE_FACTOR;
+    double optimal = (std::sqrt(g * pool.in * pool.out) - pool.in) / g;
 
-    if (optimal <= 0) {
+    if (!(optimal > 0)) {
         return U256(0);
     }
 
     return simd::double_to_u256(optimal);
 }
 
+double arbitrage_profit_bound(const PoolReserves& buy_reserves, const PoolReserves& sell_reserves) {
+    VirtualPool pool;
+    if (!virtual_pool(buy_reserves.reserve0, buy_reserves.reserve1,
+                      sell_reserves.reserve0, sell_reserves.reserve1, pool)) {
+        return 0.0;
+    }
+
+    // At the optimal input (sqrt(g * x * y) - x) / g the profit is
+    // y + (x - 2 * sqrt(g * x * y)) / g; with no positive optimum it is 0.
+    // The margin covers the double rounding, which scales with the terms
+    // rather than their (possibly tiny) difference
+    constexpr double g = ROUND_TRIP_FEE_FACTOR;
+    const double root = std::sqrt(g * pool.in * pool.out);
+    const double profit = root > pool.in ? pool.out + (pool.in - 2.0 * root) / g : 0.0;
+    const double margin = 1e-9 * (pool.out + (pool.in + 2.0 * root) / g) + 1.0;
+    return std::max(profit, 0.0) + margin;
+}
+
 // ============================================================================
 // ARBITRAGE PROFIT
 // ============================================================================
@@ -283,23 +416,23 @@ U256 calculate_arbitrage_profit(
     const PoolReserves& sell_reserves,
     const U256& trade_size
 ) {
-    // 1. Buy token1 with token0 at buy_pool
-    U256 token1_received = calculate_swap_output(
-        buy_reserves.reserve0,
+    // 1. Buy token0 with token1 at buy_pool
+    U256 token0_received = calculate_swap_output(
         buy_reserves.reserve1,
+        buy_reserves.reserve0,
         trade_size
     );
 
-    // 2. Sell token1 for token0 at sell_pool
-    U256 token0_received = calculate_swap_output(
-        sell_reserves.reserve1,
+    // 2. Sell token0 for token1 at sell_pool
+    U256 token1_received = calculate_swap_output(
         sell_reserves.reserve0,
-        token1_received
+        sell_reserves.reserve1,
+        token0_received
     );
 
-    // 3. Profit = token0_received - trade_size
-    if (simd::cmp_u256(token0_received, trade_size) > 0) {
-        return simd::sub_u256(token0_received, trade_size);
+    // 3. Profit = token1_received - trade_size
+    if (simd::cmp_u256(token1_received, trade_size) > 0) {
+        return simd::sub_u256(token1_received, trade_size);
     }
 
     return U256(0);
@@ -309,10 +442,12 @@ U256 calculate_arbitrage_profit(
 // BATCH PRICE CALCULATOR CLASS
 // ============================================================================
 
-BatchPriceCalculator::BatchPriceCalculator() : pool_count_(0) {
-    // Initialize pools to zero
-    std::memset(pools_, 0, sizeof(pools_));
-}
+BatchPriceCalculator::BatchPriceCalculator()
+    : lanes_{}
+    , timestamps_{}
+    , pool_ids_{}
+    , dex_ids_{}
+    , pool_count_(0) {}
 
 BatchPriceCalculator::~BatchPriceCalculator() = default;
 
@@ -320,28 +455,43 @@ bool BatchPriceCalculator::add_pool(const PoolReserves& reserves) {
     if (pool_count_ >= MAX_POOLS) {
         return false;
     }
-    pools_[pool_count_++] = reserves;
+    lanes_[pool_count_ / SIMD_BATCH_SIZE].set(pool_count_ % SIMD_BATCH_SIZE, reserves);
+    timestamps_[pool_count_] = reserves.timestamp_ms;
+    pool_ids_[pool_count_] = reserves.pool_id;
+    dex_ids_[pool_count_] = reserves.dex_id;
+    ++pool_count_;
     return true;
 }
 
 size_t BatchPriceCalculator::process(PriceResult* results) {
-    // Process in batches of SIMD_BATCH_SIZE
-    size_t processed = 0;
+    return process_lanes(nullptr, 0, results);
+}
 
-    while (processed < pool_count_) {
-        size_t batch_size = std::min(SIMD_BATCH_SIZE, pool_count_ - processed);
+size_t BatchPriceCalculator::process_filtered(const double* reference_prices, int64_t min_deviation_bps,
+                                              PriceResult* results) {
+    return process_lanes(reference_prices, min_deviation_bps, results);
+}
 
-        PoolBatch batch;
-        batch.count = batch_size;
-        for (size_t i = 0; i < batch_size; ++i) {
-            batch.pools[i] = pools_[processed + i];
+size_t BatchPriceCalculator::process_lanes(const double* reference_prices, int64_t min_deviation_bps,
+                                           PriceResult* results) {
+    // One lane block per SIMD_BATCH_SIZE pools, straight from storage
+    size_t written = 0;
+    detail::LanePrices prices;
+
+    for (size_t base = 0; base < pool_count_; base += SIMD_BATCH_SIZE) {
+        const size_t count = std::min(SIMD_BATCH_SIZE, pool_count_ - base);
+        detail::price_lanes(lanes_[base / SIMD_BATCH_SIZE], count,
+                            reference_prices ? reference_prices + base : nullptr,
+                            min_deviation_bps, prices);
+
+        for (size_t i = 0; i < count; ++i) {
+            if ((prices.kept & (1u << i)) == 0) continue;
+            set_result(results[written++], prices, i,
+                       timestamps_[base + i], pool_ids_[base + i], dex_ids_[base + i]);
         }
-
-        calculate_prices_batch(batch, results + processed);
-        processed += batch_size;
     }
 
-    return pool_count_;
+    return written;
 }
 
 void BatchPriceCalculator::clear() {
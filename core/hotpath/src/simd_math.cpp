@@ -1,17 +1,228 @@
 /**
  * @file simd_math.cpp
  * @brief SIMD math implementation
+ *
+ * CPU feature detection and the per-level batch kernel tables. The
+ * AVX-512 kernels carry a target attribute, so they are compiled into
+ * every build (including ones without -march=native) and only run when
+ * the CPU has them.
  */
 
 #include "simd_math.hpp"
+#include <algorithm>
 #include <cstring>
 
+#ifdef _WIN32
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#define HOTPATH_TARGET_AVX2
+#define HOTPATH_TARGET_AVX512
+#else
+#define HOTPATH_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#define HOTPATH_TARGET_AVX512 __attribute__((target("avx2,fma,avx512f,avx512dq")))
+#endif
+
 namespace matrix::hotpath::simd {
 
-// Most SIMD operations are inline in the header for performance.
-// This file contains any non-inlined helpers.
+namespace {
+
+// ============================================================================
+// CPU FEATURE DETECTION
+// ============================================================================
+
+struct CpuFeatures {
+    bool avx2 = false;
+    bool avx512 = false;
+};
+
+void cpuid(uint32_t leaf, uint32_t subleaf, uint32_t (&regs)[4]) {
+#ifdef _WIN32
+    int info[4];
+    __cpuidex(info, static_cast<int>(leaf), static_cast<int>(subleaf));
+    for (int i = 0; i < 4; ++i) regs[i] = static_cast<uint32_t>(info[i]);
+#else
+    if (!__get_cpuid_count(leaf, subleaf, &regs[0], &regs[1], &regs[2], &regs[3])) {
+        regs[0] = regs[1] = regs[2] = regs[3] = 0;
+    }
+#endif
+}
+
+uint64_t xgetbv0() {
+#ifdef _WIN32
+    return _xgetbv(0);
+#else
+    uint32_t eax, edx;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (static_cast<uint64_t>(edx) << 32) | eax;
+#endif
+}
+
+CpuFeatures detect_features() {
+    CpuFeatures features;
+    uint32_t regs[4];
+
+    cpuid(0, 0, regs);
+    if (regs[0] < 7) return features;
+
+    // The OS must save the vector state before any of it may be used
+    cpuid(1, 0, regs);
+    if ((regs[2] & (1u << 27)) == 0) return features;      // OSXSAVE
+    const uint64_t xcr0 = xgetbv0();
+    const bool ymm_state = (xcr0 & 0x6) == 0x6;            // SSE + AVX
+    const bool zmm_state = (xcr0 & 0xE6) == 0xE6;          // + opmask, ZMM low/high
+
+    cpuid(7, 0, regs);
+    features.avx2 = ymm_state && (regs[1] & (1u << 5)) != 0;
+    features.avx512 = zmm_state && features.avx2 &&
+                      (regs[1] & (1u << 16)) != 0 &&       // AVX-512F
+                      (regs[1] & (1u << 17)) != 0;         // AVX-512DQ
+    return features;
+}
+
+const CpuFeatures& cpu_features() {
+    static const CpuFeatures features = detect_features();
+    return features;
+}
+
+// ============================================================================
+// AVX2 KERNELS (two 4-lane halves)
+// ============================================================================
+
+static_assert(SIMD_BATCH_SIZE == 8, "batch kernels are written for 8 lanes");
+
+HOTPATH_TARGET_AVX2 void cvt_u64_to_f64_avx2(const uint64_t* in, double* out) {
+    for (size_t h = 0; h < SIMD_BATCH_SIZE; h += 4) {
+        store_f64x4(out + h, cvt_u64x4_to_f64x4(load_unaligned(in + h)));
+    }
+}
+
+HOTPATH_TARGET_AVX2 void mul_u64_low_avx2(const uint64_t* a, const uint64_t* b, uint64_t* out) {
+    for (size_t h = 0; h < SIMD_BATCH_SIZE; h += 4) {
+        store_unaligned(out + h, mul_u64x4_low(load_unaligned(a + h), load_unaligned(b + h)));
+    }
+}
+
+HOTPATH_TARGET_AVX2 void cvt_f64_to_i64_avx2(const double* in, int64_t* out) {
+    for (size_t h = 0; h < SIMD_BATCH_SIZE; h += 4) {
+        store_unaligned(reinterpret_cast<uint64_t*>(out + h), cvt_f64x4_to_i64x4(load_f64x4(in + h)));
+    }
+}
+
+HOTPATH_TARGET_AVX2 void spread_bps_avx2(const double* buy, const double* sell, int64_t* out) {
+    for (size_t h = 0; h < SIMD_BATCH_SIZE; h += 4) {
+        const f64x4 b = load_f64x4(buy + h);
+        const f64x4 bps = mul_f64x4(div_f64x4(sub_f64x4(load_f64x4(sell + h), b), b), _mm256_set1_pd(10000.0));
+        // NaN and non-positive buy prices compare false: those lanes are 0
+        const f64x4 valid = _mm256_cmp_pd(b, _mm256_setzero_pd(), _CMP_GT_OQ);
+        const u64x4 spread = _mm256_and_si256(cvt_f64x4_to_i64x4(bps), _mm256_castpd_si256(valid));
+        store_unaligned(reinterpret_cast<uint64_t*>(out + h), spread);
+    }
+}
+
+HOTPATH_TARGET_AVX2 void ratio_u128_avx2(const uint64_t* num_lo, const uint64_t* num_hi,
+                                         const uint64_t* den_lo, const uint64_t* den_hi, double scale,
+                                         double* ratio, double* reciprocal, double* product) {
+    const f64x4 two64 = _mm256_set1_pd(18446744073709551616.0);
+    for (size_t h = 0; h < SIMD_BATCH_SIZE; h += 4) {
+        const f64x4 num = fma_f64x4(cvt_u64x4_to_f64x4(load_unaligned(num_hi + h)), two64,
+                                    cvt_u64x4_to_f64x4(load_unaligned(num_lo + h)));
+        const f64x4 den = fma_f64x4(cvt_u64x4_to_f64x4(load_unaligned(den_hi + h)), two64,
+                                    cvt_u64x4_to_f64x4(load_unaligned(den_lo + h)));
+        const f64x4 inv = div_f64x4(_mm256_set1_pd(1.0), den);
+        store_f64x4(ratio + h, mul_f64x4(mul_f64x4(num, _mm256_set1_pd(scale)), inv));
+        store_f64x4(reciprocal + h, inv);
+        store_f64x4(product + h, mul_f64x4(num, den));
+    }
+}
+
+// ============================================================================
+// AVX-512 KERNELS (one 8-lane register)
+// ============================================================================
+
+HOTPATH_TARGET_AVX512 void cvt_u64_to_f64_avx512(const uint64_t* in, double* out) {
+    _mm512_storeu_pd(out, _mm512_cvtepu64_pd(_mm512_loadu_si512(in)));
+}
+
+HOTPATH_TARGET_AVX512 void mul_u64_low_avx512(const uint64_t* a, const uint64_t* b, uint64_t* out) {
+    _mm512_storeu_si512(out, _mm512_mullo_epi64(_mm512_loadu_si512(a), _mm512_loadu_si512(b)));
+}
+
+// Same saturation as the AVX2 magic-number conversion
+HOTPATH_TARGET_AVX512 __m512i cvt_f64x8_to_i64x8_avx512(__m512d v) {
+    __m512d t = _mm512_max_pd(v, _mm512_set1_pd(-F64_TO_I64_LIMIT));
+    t = _mm512_min_pd(t, _mm512_set1_pd(F64_TO_I64_LIMIT));
+    return _mm512_cvttpd_epi64(t);
+}
+
+HOTPATH_TARGET_AVX512 void cvt_f64_to_i64_avx512(const double* in, int64_t* out) {
+    _mm512_storeu_si512(out, cvt_f64x8_to_i64x8_avx512(_mm512_loadu_pd(in)));
+}
+
+HOTPATH_TARGET_AVX512 void spread_bps_avx512(const double* buy, const double* sell, int64_t* out) {
+    const __m512d b = _mm512_loadu_pd(buy);
+    const __m512d bps = _mm512_mul_pd(_mm512_div_pd(_mm512_sub_pd(_mm512_loadu_pd(sell), b), b),
+                                      _mm512_set1_pd(10000.0));
+    const __mmask8 valid = _mm512_cmp_pd_mask(b, _mm512_setzero_pd(), _CMP_GT_OQ);
+    _mm512_storeu_si512(out, _mm512_maskz_mov_epi64(valid, cvt_f64x8_to_i64x8_avx512(bps)));
+}
+
+HOTPATH_TARGET_AVX512 void ratio_u128_avx512(const uint64_t* num_lo, const uint64_t* num_hi,
+                                             const uint64_t* den_lo, const uint64_t* den_hi, double scale,
+                                             double* ratio, double* reciprocal, double* product) {
+    const __m512d two64 = _mm512_set1_pd(18446744073709551616.0);
+    const __m512d num = _mm512_fmadd_pd(_mm512_cvtepu64_pd(_mm512_loadu_si512(num_hi)), two64,
+                                        _mm512_cvtepu64_pd(_mm512_loadu_si512(num_lo)));
+    const __m512d den = _mm512_fmadd_pd(_mm512_cvtepu64_pd(_mm512_loadu_si512(den_hi)), two64,
+                                        _mm512_cvtepu64_pd(_mm512_loadu_si512(den_lo)));
+    const __m512d inv = _mm512_div_pd(_mm512_set1_pd(1.0), den);
+    _mm512_storeu_pd(ratio, _mm512_mul_pd(_mm512_mul_pd(num, _mm512_set1_pd(scale)), inv));
+    _mm512_storeu_pd(reciprocal, inv);
+    _mm512_storeu_pd(product, _mm512_mul_pd(num, den));
+}
+
+constexpr BatchKernels AVX2_KERNELS = {
+    SimdLevel::AVX2,
+    cvt_u64_to_f64_avx2,
+    mul_u64_low_avx2,
+    cvt_f64_to_i64_avx2,
+    spread_bps_avx2,
+    ratio_u128_avx2,
+};
+
+constexpr BatchKernels AVX512_KERNELS = {
+    SimdLevel::AVX512,
+    cvt_u64_to_f64_avx512,
+    mul_u64_low_avx512,
+    cvt_f64_to_i64_avx512,
+    spread_bps_avx512,
+    ratio_u128_avx512,
+};
+
+} // anonymous namespace
+
+bool cpu_has_avx2() {
+    return cpu_features().avx2;
+}
+
+bool cpu_has_avx512() {
+    return cpu_features().avx512;
+}
+
+SimdLevel detected_level() {
+    return cpu_has_avx512() ? SimdLevel::AVX512 : SimdLevel::AVX2;
+}
+
+const BatchKernels& kernels_for(SimdLevel level) {
+    return level == SimdLevel::AVX512 ? AVX512_KERNELS : AVX2_KERNELS;
+}
 
-// Placeholder for any non-inline implementations
-// Currently all critical operations are inlined for maximum performance.
+const BatchKernels& batch_kernels() {
+    static const BatchKernels& kernels = kernels_for(detected_level());
+    return kernels;
+}
 
 } // namespace matrix::hotpath::simd
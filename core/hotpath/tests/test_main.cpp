@@ -8,9 +8,14 @@
 #include "price_calculator.hpp"
 #include "opportunity_scanner.hpp"
 #include "../bindings/ffi.hpp"
+#include <algorithm>
 #include <iostream>
 #include <cassert>
 #include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+#include <vector>
 
 using namespace matrix::hotpath;
 
@@ -188,6 +193,157 @@ TEST(batch_price_calculation) {
     }
 }
 
+TEST(price_calculation_exact_for_large_reserves) {
+    const __uint128_t one_e24 = static_cast<__uint128_t>(1'000'000'000'000ULL) * 1'000'000'000'000ULL;
+    const __uint128_t max128 = ~static_cast<__uint128_t>(0);
+
+    // {reserve0, reserve1, confidence}: r1 * 1e18 overflows 128 bits in
+    // most of these, and the last ones take the wide-division fallback
+    struct Case { __uint128_t r0, r1; int64_t confidence; };
+    const Case cases[] = {
+        {one_e24 * 3, one_e24 * 7, 10000},
+        {one_e24 / 1000, one_e24 * 5, 9000},                     // sqrt(5e45) ~ 7e22
+        {1'000'000'000ULL, 3'000'000'000'000ULL, 3000},
+        {one_e24, 1, 3000},
+        {static_cast<__uint128_t>(1) << 115, (static_cast<__uint128_t>(1) << 120) + 12345, 10000},
+        {3, max128, 7000},                                       // Saturates
+    };
+    for (const Case& c : cases) {
+        PoolReserves pool{};
+        pool.reserve0 = U256::from_u128(c.r0);
+        pool.reserve1 = U256::from_u128(c.r1);
+        PriceResult result = calculate_price(pool);
+        ASSERT_TRUE(result.price.low128() == swap::mul_div(c.r1, PRICE_PRECISION, c.r0));
+        ASSERT_EQ(result.confidence, c.confidence);
+    }
+    // confidence 9000 and 7000: sqrt(r0 * r1) of 1e21 and 1e18
+    PoolReserves pool{};
+    pool.reserve0 = U256(1'000'000'000'000'000'000ULL);
+    pool.reserve1 = U256(1'000'000'000'000'000'000ULL);
+    ASSERT_EQ(calculate_price(pool).confidence, 7000);
+    pool.reserve1 = U256::from_u128(one_e24);
+    ASSERT_EQ(calculate_price(pool).confidence, 9000);
+}
+
+TEST(batch_prices_match_scalar) {
+    // Reserves from a few units to beyond 2^112, in full and partial batches
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+    auto next = [&state]() {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    };
+    auto reserve = [&next]() {
+        const unsigned bits = static_cast<unsigned>(next() % 120) + 1;
+        const __uint128_t v = (static_cast<__uint128_t>(next()) << 64) | next();
+        return bits >= 128 ? v : v & ((static_cast<__uint128_t>(1) << bits) - 1);
+    };
+
+    BatchPriceCalculator calculator;
+    std::vector<PoolReserves> all;
+    for (int round = 0; round < 200; ++round) {
+        PoolBatch batch;
+        batch.count = round % 3 == 0 ? 5 : SIMD_BATCH_SIZE;
+        for (size_t i = 0; i < batch.count; ++i) {
+            PoolReserves& pool = batch.pools[i];
+            pool = PoolReserves{};
+            pool.reserve0 = U256::from_u128(i == 2 && round % 5 == 0 ? 0 : reserve());
+            pool.reserve1 = U256::from_u128(reserve());
+            pool.pool_id = static_cast<uint32_t>(round * 8 + i);
+            pool.dex_id = static_cast<uint32_t>(i);
+            pool.timestamp_ms = static_cast<uint64_t>(round);
+            if (all.size() < BatchPriceCalculator::max_capacity()) all.push_back(pool);
+        }
+
+        PriceResult results[SIMD_BATCH_SIZE];
+        calculate_prices_batch(batch, results);
+        for (size_t i = 0; i < batch.count; ++i) {
+            const PriceResult expected = calculate_price(batch.pools[i]);
+            ASSERT_TRUE(simd::cmp_u256(results[i].price, expected.price) == 0);
+            ASSERT_EQ(results[i].confidence, expected.confidence);
+            ASSERT_EQ(results[i].pool_id, batch.pools[i].pool_id);
+            ASSERT_EQ(results[i].timestamp_ms, batch.pools[i].timestamp_ms);
+
+            const __uint128_t r0 = batch.pools[i].reserve0.low128();
+            const __uint128_t r1 = batch.pools[i].reserve1.low128();
+            ASSERT_TRUE(results[i].price.low128() == (r0 == 0 ? 0 : swap::mul_div(r1, PRICE_PRECISION, r0)));
+        }
+    }
+
+    // The calculator's stored lanes give the same results
+    for (const PoolReserves& pool : all) ASSERT_TRUE(calculator.add_pool(pool));
+    ASSERT_TRUE(!calculator.add_pool(all.front()));
+    std::vector<PriceResult> results(all.size());
+    ASSERT_EQ(calculator.process(results.data()), all.size());
+    for (size_t i = 0; i < all.size(); ++i) {
+        const PriceResult expected = calculate_price(all[i]);
+        ASSERT_TRUE(simd::cmp_u256(results[i].price, expected.price) == 0);
+        ASSERT_EQ(results[i].confidence, expected.confidence);
+        ASSERT_EQ(results[i].pool_id, all[i].pool_id);
+        ASSERT_EQ(results[i].dex_id, all[i].dex_id);
+    }
+}
+
+TEST(filtered_prices_keep_only_moved_pools) {
+    PoolBatch batch;
+    batch.count = 7;
+    double reference[SIMD_BATCH_SIZE];
+    for (size_t i = 0; i < batch.count; ++i) {
+        batch.pools[i] = PoolReserves{};
+        batch.pools[i].reserve0 = U256(1'000'000'000'000'000'000ULL);
+        batch.pools[i].reserve1 = U256(2'000'000'000'000'000'000ULL);  // Price 2e18
+        batch.pools[i].pool_id = static_cast<uint32_t>(i);
+        reference[i] = 2e18;
+    }
+    reference[1] = 2e18 * 1.02;     // 196 bps away: kept
+    reference[3] = 2e18 * 1.004;    // 40 bps away: dropped
+    reference[4] = 0.0;             // No reference: kept
+    batch.pools[5].reserve0 = U256(0);   // Price 0 against 2e18: kept
+    reference[6] = 2e18 * 0.98;     // 204 bps away: kept
+
+    PriceResult results[SIMD_BATCH_SIZE];
+    const size_t kept = calculate_prices_filtered(batch, reference, 50, results);
+    ASSERT_EQ(kept, 4UL);
+    const uint32_t expected_ids[] = {1, 4, 5, 6};
+    for (size_t i = 0; i < kept; ++i) {
+        ASSERT_EQ(results[i].pool_id, expected_ids[i]);
+        ASSERT_TRUE(simd::cmp_u256(results[i].price, calculate_price(batch.pools[expected_ids[i]]).price) == 0);
+    }
+    ASSERT_TRUE(results[2].price.is_zero());
+
+    // A 100% band only lets the unreferenced pool through
+    ASSERT_EQ(calculate_prices_filtered(batch, reference, 10000, results), 1UL);
+    ASSERT_EQ(results[0].pool_id, 4u);
+
+    // Calculator and FFI agree, across block boundaries
+    BatchPriceCalculator calculator;
+    std::vector<double> references;
+    std::vector<ffi_pool_reserves_t> ffi_pools;
+    for (int copy = 0; copy < 3; ++copy) {
+        for (size_t i = 0; i < batch.count; ++i) {
+            calculator.add_pool(batch.pools[i]);
+            references.push_back(reference[i]);
+            ffi_pool_reserves_t pool{};
+            std::memcpy(pool.reserve0.limbs, batch.pools[i].reserve0.limbs, sizeof(pool.reserve0.limbs));
+            std::memcpy(pool.reserve1.limbs, batch.pools[i].reserve1.limbs, sizeof(pool.reserve1.limbs));
+            pool.pool_id = batch.pools[i].pool_id;
+            ffi_pools.push_back(pool);
+        }
+    }
+    std::vector<PriceResult> all(references.size());
+    ASSERT_EQ(calculator.process_filtered(references.data(), 50, all.data()), 12UL);
+    std::vector<ffi_price_result_t> ffi_results(references.size());
+    ASSERT_EQ(hotpath_calculate_prices_filtered(ffi_pools.data(), ffi_pools.size(), references.data(), 50,
+                                                ffi_results.data()), 12UL);
+    for (size_t i = 0; i < 12; ++i) {
+        ASSERT_EQ(all[i].pool_id, expected_ids[i % 4]);
+        ASSERT_EQ(ffi_results[i].pool_id, expected_ids[i % 4]);
+        ASSERT_EQ(ffi_results[i].price.limbs[0], all[i].price.limbs[0]);
+        ASSERT_EQ(ffi_results[i].confidence, all[i].confidence);
+    }
+}
+
 // ============================================================================
 // SWAP CALCULATION TESTS
 // ============================================================================
@@ -214,6 +370,50 @@ TEST(swap_output_zero_input) {
     ASSERT_TRUE(amount_out.is_zero());
 }
 
+TEST(swap_math_mul_div_wide) {
+    const __uint128_t one_e24 = static_cast<__uint128_t>(1'000'000'000'000ULL) * 1'000'000'000'000ULL;
+
+    // (1e24 * 1e24) / 1e24 needs the full 256-bit product
+    ASSERT_TRUE(swap::mul_div(one_e24, one_e24, one_e24) == one_e24);
+    ASSERT_TRUE(swap::mul_div(one_e24 * 3, one_e24 * 7, one_e24 * 21) == one_e24);
+    ASSERT_TRUE(swap::mul_div(~static_cast<__uint128_t>(0), 2, 4) == ~static_cast<__uint128_t>(0) / 2);
+    ASSERT_TRUE(swap::mul_div(one_e24, one_e24, 1) == ~static_cast<__uint128_t>(0));  // Saturates
+    ASSERT_TRUE(swap::mul_div(1, 1, 0) == 0);
+}
+
+TEST(swap_output_large_reserves) {
+    // 1e30-unit reserves (2e30 / 3e30), where amount * 997 * reserve_out overflows 128 bits
+    const __uint128_t one_e30 = static_cast<__uint128_t>(1'000'000'000'000'000ULL) * 1'000'000'000'000'000ULL;
+    const __uint128_t one_e24 = static_cast<__uint128_t>(1'000'000'000'000ULL) * 1'000'000'000'000ULL;
+    const U256 reserve_in = U256::from_u128(one_e30 * 3);
+    const U256 reserve_out = U256::from_u128(one_e30 * 2);
+
+    U256 amount_out = calculate_swap_output(reserve_in, reserve_out, U256::from_u128(one_e24));
+    // floor(1e24 * 997 * 2e30 / (3e30 * 1000 + 1e24 * 997))
+    const __uint128_t expected = static_cast<__uint128_t>(664'666'445'775ULL) * 1'000'000'000'000ULL
+                               + 851'187'158'788ULL;
+    ASSERT_TRUE(amount_out.low128() == expected);
+}
+
+TEST(swap_output_batch_matches_scalar) {
+    const __uint128_t one_e24 = static_cast<__uint128_t>(1'000'000'000'000ULL) * 1'000'000'000'000ULL;
+    const U256 reserve_in = U256::from_u128(one_e24 * 500'000);
+    const U256 reserve_out = U256::from_u128(one_e24 * 250'000);
+
+    U256 amounts_in[7];
+    U256 amounts_out[7];
+    for (int i = 0; i < 7; ++i) {
+        amounts_in[i] = U256::from_u128(one_e24 * (i * 1'000 + 1));
+    }
+    amounts_in[3] = U256(0);
+
+    calculate_swap_outputs_batch(reserve_in, reserve_out, amounts_in, amounts_out, 7);
+    for (int i = 0; i < 7; ++i) {
+        ASSERT_TRUE(simd::cmp_u256(amounts_out[i], calculate_swap_output(reserve_in, reserve_out, amounts_in[i])) == 0);
+    }
+    ASSERT_TRUE(amounts_out[3].is_zero());
+}
+
 TEST(slippage_calculation) {
     U256 reserve_in(1'000'000'000'000'000'000ULL);
     U256 reserve_out(1'000'000'000'000'000'000ULL);
@@ -277,6 +477,274 @@ TEST(scanner_clear) {
     ASSERT_EQ(scanner.pool_count(), 0UL);
 }
 
+namespace {
+
+PoolReserves pair_pool(uint32_t pool_id, uint32_t dex_id, uint64_t token0, uint64_t token1,
+                       uint64_t reserve0, uint64_t reserve1) {
+    PoolReserves pool{};
+    pool.reserve0 = U256::from_u128(static_cast<__uint128_t>(reserve0) * PRICE_PRECISION);
+    pool.reserve1 = U256::from_u128(static_cast<__uint128_t>(reserve1) * PRICE_PRECISION);
+    pool.pool_id = pool_id;
+    pool.dex_id = dex_id;
+    pool.token0_hash = token0;
+    pool.token1_hash = token1;
+    return pool;
+}
+
+} // anonymous namespace
+
+TEST(scanner_groups_by_token_pair) {
+    ScannerConfig config = default_scanner_config();
+    config.max_position_size = U256::from_u128(~static_cast<__uint128_t>(0));
+    OpportunityScanner scanner(config);
+
+    // Same pair on two DEXes, the second listing it the other way round
+    // (price 2.0 vs 1 / (1000 / 2100) = 2.1); a third pool of another pair
+    scanner.update_pool(pair_pool(1, 1, 0xA, 0xB, 1000, 2000));
+    scanner.update_pool(pair_pool(2, 2, 0xB, 0xA, 2100, 1000));
+    scanner.update_pool(pair_pool(3, 3, 0xA, 0xC, 1000, 3000));
+    ASSERT_EQ(scanner.pool_count(), 3UL);
+    ASSERT_EQ(scanner.pair_count(), 2UL);
+
+    std::vector<ArbitrageOpportunity> opps;
+    ASSERT_EQ(scanner.scan(opps), 1UL);
+    ASSERT_EQ(opps[0].buy_pool_id, 1u);
+    ASSERT_EQ(opps[0].sell_pool_id, 2u);
+    ASSERT_TRUE(opps[0].spread_bps >= 490 && opps[0].spread_bps <= 500);
+
+    // The reported size is the round trip's optimum (in token1)
+    const PoolReserves buy = pair_pool(1, 1, 0xA, 0xB, 1000, 2000);
+    const PoolReserves sell = pair_pool(2, 2, 0xA, 0xB, 1000, 2100);
+    const __uint128_t size = opps[0].max_amount.low128();
+    const __uint128_t profit = calculate_arbitrage_profit(buy, sell, opps[0].max_amount).low128();
+    ASSERT_TRUE(profit > 0);
+    ASSERT_TRUE(profit == opps[0].estimated_profit.low128());
+    ASSERT_TRUE(calculate_arbitrage_profit(buy, sell, U256::from_u128(size / 2)).low128() < profit);
+    ASSERT_TRUE(calculate_arbitrage_profit(buy, sell, U256::from_u128(size * 3 / 2)).low128() < profit);
+    ASSERT_TRUE(calculate_optimal_trade_size(sell.reserve0, sell.reserve1, buy.reserve0, buy.reserve1).is_zero());
+
+    // The pruning bound covers the exact profit, and not by much
+    const double bound = arbitrage_profit_bound(buy, sell);
+    ASSERT_TRUE(bound >= simd::u256_to_double(opps[0].estimated_profit));
+    ASSERT_TRUE(bound <= simd::u256_to_double(opps[0].estimated_profit) * 1.0001);
+    ASSERT_TRUE(arbitrage_profit_bound(sell, buy) < simd::u256_to_double(buy.reserve1) * 1e-8);
+
+    size_t streamed = scanner.scan_with_callback([](const ArbitrageOpportunity&) {});
+    ASSERT_EQ(streamed, 1UL);
+
+    // Pool 3 joins the pair at a price between the two: no new opportunity
+    // it wins, but the pair now has three members to compare
+    scanner.update_pool(pair_pool(3, 3, 0xA, 0xB, 1000, 2050));
+    ASSERT_EQ(scanner.pool_count(), 3UL);
+    ASSERT_EQ(scanner.scan(opps), 3UL);
+
+    // Pools without tokens are tracked but never compared
+    scanner.update_pool(pair_pool(4, 4, 0, 0, 1000, 9000));
+    ASSERT_EQ(scanner.pool_count(), 4UL);
+    ASSERT_EQ(scanner.scan(opps), 3UL);
+}
+
+TEST(scanner_tracks_best_opportunities) {
+    ScannerConfig config = default_scanner_config();
+    config.max_position_size = U256::from_u128(~static_cast<__uint128_t>(0));
+    OpportunityScanner scanner(config);
+
+    ArbitrageOpportunity best;
+    ASSERT_TRUE(!scanner.get_best_opportunity(best));
+
+    // 12 pairs on 5 DEXes; random reserve updates, pair moves and a
+    // config change, with the kept state checked against full scans
+    constexpr uint32_t pairs = 12;
+    constexpr uint32_t dexes = 5;
+    uint64_t rng = 0x9E3779B97F4A7C15ULL;
+    auto next = [&rng] {
+        rng ^= rng << 13;
+        rng ^= rng >> 7;
+        rng ^= rng << 17;
+        return rng;
+    };
+    std::vector<uint64_t> pair_of(pairs * dexes);
+
+    std::vector<ArbitrageOpportunity> all;
+    std::vector<ArbitrageOpportunity> top(pairs + 1);
+    for (int step = 0; step < 3000; ++step) {
+        const auto pool = static_cast<uint32_t>(next() % (pairs * dexes));
+        // Some pools hop to another pair now and then
+        const uint64_t pair = (step % 97 == 0) ? next() % pairs : pool % pairs;
+        pair_of[pool] = pair;
+        scanner.update_pool(pair_pool(pool, pool / pairs, 1 + pair, 1000, 1000, 1900 + next() % 200));
+        if (step == 1500) {
+            config.min_spread_bps = 150;
+            scanner.set_config(config);
+        }
+
+        // Expected: the best profit of every pair, from a full scan
+        ASSERT_EQ(scanner.scan(all), scanner.scan_with([](const ArbitrageOpportunity&) {}));
+        std::vector<__uint128_t> pair_best(pairs, 0);
+        for (const auto& opp : all) {
+            const uint64_t p = pair_of[opp.buy_pool_id];
+            pair_best[p] = std::max(pair_best[p], opp.estimated_profit.low128());
+        }
+        std::vector<__uint128_t> expected;
+        for (auto profit : pair_best) {
+            if (profit != 0) expected.push_back(profit);
+        }
+        std::sort(expected.rbegin(), expected.rend());
+
+        ASSERT_EQ(scanner.get_best_opportunity(best), !expected.empty());
+        if (!expected.empty()) {
+            ASSERT_TRUE(best.estimated_profit.low128() == expected[0]);
+        }
+        const size_t k = step % 4 == 0 ? top.size() : 3;
+        const size_t got = scanner.top_opportunities(top.data(), k);
+        ASSERT_EQ(got, std::min(k, expected.size()));
+        for (size_t i = 0; i < got; ++i) {
+            ASSERT_TRUE(top[i].estimated_profit.low128() == expected[i]);
+        }
+    }
+
+    scanner.clear();
+    ASSERT_TRUE(!scanner.get_best_opportunity(best));
+    ASSERT_EQ(scanner.top_opportunities(top.data(), top.size()), 0UL);
+}
+
+TEST(scanner_capacity_limits) {
+    ScannerCapacity capacity = default_scanner_capacity();
+    capacity.max_pools = 3;
+    capacity.max_pairs = 1;
+    capacity.max_pools_per_pair = 2;
+    OpportunityScanner scanner(default_scanner_config(), capacity);
+
+    scanner.update_pool(pair_pool(1, 1, 1, 2, 1000, 2000));
+    scanner.update_pool(pair_pool(2, 2, 1, 2, 1000, 2100));
+    scanner.update_pool(pair_pool(3, 3, 1, 2, 1000, 2200));    // Group full
+    scanner.update_pool(pair_pool(4, 4, 1, 2, 1000, 2300));    // Scanner full
+    ASSERT_EQ(scanner.pool_count(), 3UL);
+    ASSERT_EQ(scanner.pair_count(), 1UL);
+
+    bool threw = false;
+    try {
+        capacity.max_pairs = 0;
+        OpportunityScanner invalid(default_scanner_config(), capacity);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    ASSERT_TRUE(threw);
+
+    // Each capacity in range, but their product overflows the 32-bit
+    // group offsets
+    threw = false;
+    try {
+        capacity.max_pairs = size_t{1} << 17;
+        capacity.max_pools_per_pair = size_t{1} << 16;
+        OpportunityScanner invalid(default_scanner_config(), capacity);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    ASSERT_TRUE(threw);
+
+    // Beyond the old fixed limits
+    capacity.max_pools = 20'000;
+    capacity.max_pairs = 5'000;
+    capacity.max_pools_per_pair = 64;
+    OpportunityScanner large(default_scanner_config(), capacity);
+    for (uint32_t i = 0; i < 20'000; ++i) {
+        large.update_pool(pair_pool(i, i % 7, 1 + i % 5'000, 100'000, 1000, 2000 + i % 3));
+    }
+    ASSERT_EQ(large.pool_count(), 20'000UL);
+    ASSERT_EQ(large.pair_count(), 5'000UL);
+    for (uint32_t i = 0; i < 20'000; ++i) {
+        large.update_pool(pair_pool(i, i % 7, 1 + i % 5'000, 100'000, 1000, 2000));
+    }
+    ASSERT_EQ(large.pool_count(), 20'000UL);
+}
+
+// ============================================================================
+// SIMD KERNEL TESTS
+// ============================================================================
+
+TEST(simd_avx2_helpers_are_exact) {
+    const uint64_t values[] = {0, 1, 0xFFFFFFFFULL, 0x100000000ULL, (1ULL << 53) + 1,
+                               0x123456789ABCDEF1ULL, 0xFFFFFFFFFFFFFFFFULL, 1'000'000'000'000'000'000ULL};
+    for (size_t i = 0; i < 8; i += 4) {
+        alignas(32) double converted[4];
+        alignas(32) uint64_t product[4];
+        simd::store_f64x4(converted, simd::cvt_u64x4_to_f64x4(simd::load_unaligned(values + i)));
+        simd::store_aligned(product, simd::mul_u64x4_low(simd::load_unaligned(values + i),
+                                                         simd::load_unaligned(values + (i + 4) % 8)));
+        for (size_t j = 0; j < 4; ++j) {
+            ASSERT_TRUE(converted[j] == static_cast<double>(values[i + j]));   // Rounded like the cast
+            ASSERT_EQ(product[j], values[i + j] * values[(i + 4) % 8 + j]);    // All 64 low bits
+        }
+    }
+
+    alignas(32) double reals[4] = {-2.75, 1234.9, -0.5, 1e300};
+    alignas(32) int64_t truncated[4];
+    simd::store_unaligned(reinterpret_cast<uint64_t*>(truncated), simd::cvt_f64x4_to_i64x4(simd::load_f64x4(reals)));
+    ASSERT_EQ(truncated[0], -2);
+    ASSERT_EQ(truncated[1], 1234);
+    ASSERT_EQ(truncated[2], 0);
+    ASSERT_EQ(truncated[3], static_cast<int64_t>(simd::F64_TO_I64_LIMIT));   // Saturates
+}
+
+TEST(simd_batch_kernels_match_scalar_at_every_level) {
+    alignas(64) uint64_t a[SIMD_BATCH_SIZE] = {0, 7, 0xFFFFFFFFULL, (1ULL << 53) + 1,
+                                               0x123456789ABCDEF1ULL, 0xFFFFFFFFFFFFFFFFULL,
+                                               1'000'000'000'000'000'000ULL, 0x8000000000000001ULL};
+    alignas(64) uint64_t b[SIMD_BATCH_SIZE] = {5, 0xFFFFFFFFFFFFFFFFULL, 0x100000001ULL, 3,
+                                               0xFEDCBA9876543210ULL, 2, 997, 0x7FFFFFFFFFFFFFFFULL};
+    alignas(64) double buy[SIMD_BATCH_SIZE] = {1.0, 2.0, 0.0, -1.0, 1.5, 100.0, 1e-9, 3.0};
+    alignas(64) double sell[SIMD_BATCH_SIZE] = {1.01, 1.9, 5.0, 2.0, 1.5, 100.5, 2e-9, 2.97};
+
+    const simd::SimdLevel levels[] = {simd::SimdLevel::AVX2, simd::SimdLevel::AVX512};
+    for (simd::SimdLevel level : levels) {
+        if (level == simd::SimdLevel::AVX512 && !simd::cpu_has_avx512()) continue;
+        const simd::BatchKernels& k = simd::kernels_for(level);
+        ASSERT_TRUE(k.level == level);
+
+        double converted[SIMD_BATCH_SIZE];
+        uint64_t product[SIMD_BATCH_SIZE];
+        int64_t truncated[SIMD_BATCH_SIZE];
+        int64_t spreads[SIMD_BATCH_SIZE];
+        k.cvt_u64_to_f64(a, converted);
+        k.mul_u64_low(a, b, product);
+        k.cvt_f64_to_i64(sell, truncated);
+        k.spread_bps(buy, sell, spreads);
+
+        // (hi, lo) = (b, a): lanes of up to 128 bits over b:a with halves swapped
+        double ratio[SIMD_BATCH_SIZE];
+        double inverse[SIMD_BATCH_SIZE];
+        double reserve_product[SIMD_BATCH_SIZE];
+        k.ratio_u128(a, b, b, a, 1e18, ratio, inverse, reserve_product);
+
+        for (size_t i = 0; i < SIMD_BATCH_SIZE; ++i) {
+            ASSERT_TRUE(converted[i] == static_cast<double>(a[i]));
+            ASSERT_EQ(product[i], a[i] * b[i]);
+            ASSERT_EQ(truncated[i], static_cast<int64_t>(sell[i]));
+            ASSERT_EQ(spreads[i], detail::spread_bps_fast(buy[i], sell[i]));
+
+            const double num = static_cast<double>(b[i]) * 18446744073709551616.0 + static_cast<double>(a[i]);
+            const double den = static_cast<double>(a[i]) * 18446744073709551616.0 + static_cast<double>(b[i]);
+            ASSERT_NEAR(ratio[i] / (num * 1e18 / den), 1.0, 1e-15);
+            ASSERT_NEAR(inverse[i] * den, 1.0, 1e-15);
+            ASSERT_NEAR(reserve_product[i] / (num * den), 1.0, 1e-15);
+        }
+    }
+
+    // The dispatched entry points use the best level the CPU has
+    ASSERT_TRUE(simd::batch_kernels().level == simd::detected_level());
+    ASSERT_EQ(simd::cpu_has_avx512() ? 1 : 0, hotpath_has_avx512());
+    int64_t spreads[SIMD_BATCH_SIZE];
+    simd::spread_bps_x8(buy, sell, spreads);
+    ASSERT_EQ(spreads[0], 100);
+    ASSERT_EQ(spreads[2], 0);   // No buy price
+    ASSERT_EQ(spreads[3], 0);
+
+    int64_t spreads_x4[4];
+    detail::spread_bps_x4(buy, sell, spreads_x4);
+    for (size_t i = 0; i < 4; ++i) ASSERT_EQ(spreads_x4[i], spreads[i]);
+}
+
 // ============================================================================
 // FFI TESTS
 // ============================================================================
@@ -330,7 +798,7 @@ TEST(ffi_scanner) {
     ffi_scanner_handle_t scanner = hotpath_scanner_create(nullptr);
     ASSERT_TRUE(scanner != nullptr);
 
-    ffi_pool_reserves_t pool;
+    ffi_pool_reserves_t pool{};
     pool.reserve0.limbs[0] = 1'000'000'000'000'000'000ULL;
     pool.reserve0.limbs[1] = 0;
     pool.reserve0.limbs[2] = 0;
@@ -349,6 +817,123 @@ TEST(ffi_scanner) {
     ASSERT_EQ(hotpath_scanner_pool_count(scanner), 0UL);
 
     hotpath_scanner_destroy(scanner);
+
+    // Explicit limits; zero fields keep their default
+    ffi_scanner_capacity_t capacity{};
+    capacity.max_pools = 1;
+    scanner = hotpath_scanner_create_with_capacity(nullptr, &capacity);
+    ASSERT_TRUE(scanner != nullptr);
+    hotpath_scanner_update_pool(scanner, &pool);
+    pool.pool_id = 2;
+    hotpath_scanner_update_pool(scanner, &pool);
+    ASSERT_EQ(hotpath_scanner_pool_count(scanner), 1UL);
+    hotpath_scanner_destroy(scanner);
+}
+
+TEST(ffi_scanner_batched_updates) {
+    ScannerConfig config = default_scanner_config();
+    config.max_position_size = U256::from_u128(~static_cast<__uint128_t>(0));
+    OpportunityScanner reference(config);
+
+    ffi_scanner_config_t ffi_config{};
+    ffi_config.min_spread_bps = config.min_spread_bps;
+    ffi_config.max_slippage_bps = config.max_slippage_bps;
+    std::memcpy(ffi_config.min_liquidity.limbs, config.min_liquidity.limbs, sizeof(ffi_config.min_liquidity.limbs));
+    std::memset(ffi_config.max_position_size.limbs, 0xFF, sizeof(ffi_config.max_position_size.limbs));
+    ffi_scanner_handle_t scanner = hotpath_scanner_create(&ffi_config);
+    ASSERT_TRUE(scanner != nullptr);
+
+    // 50 pairs on 3 DEXes, with prices a few percent apart
+    std::vector<PoolReserves> pools;
+    for (uint32_t i = 0; i < 150; ++i) {
+        pools.push_back(pair_pool(i, i % 3, 1 + i / 3, 1000, 1000, 2000 + 40 * (i % 3) + i / 3));
+    }
+    std::vector<ffi_pool_reserves_t> ffi_pools(pools.size());
+    std::memcpy(static_cast<void*>(ffi_pools.data()), pools.data(), pools.size() * sizeof(PoolReserves));
+    ASSERT_EQ(ffi_pools[149].token0_hash, pools[149].token0_hash);
+
+    reference.update_pools(pools.data(), pools.size());
+    hotpath_scanner_update_pools(scanner, ffi_pools.data(), ffi_pools.size());
+    ASSERT_EQ(hotpath_scanner_pool_count(scanner), reference.pool_count());
+
+    std::vector<ArbitrageOpportunity> expected;
+    reference.scan(expected);
+    ASSERT_TRUE(expected.size() >= 150);
+
+    std::vector<ffi_arbitrage_opportunity_t> got(expected.size() + 8);
+    ASSERT_EQ(hotpath_scanner_scan(scanner, got.data(), got.size()), expected.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        ASSERT_EQ(got[i].buy_pool_id, expected[i].buy_pool_id);
+        ASSERT_EQ(got[i].sell_pool_id, expected[i].sell_pool_id);
+        ASSERT_EQ(got[i].spread_bps, expected[i].spread_bps);
+        ASSERT_TRUE(std::memcmp(got[i].estimated_profit.limbs, expected[i].estimated_profit.limbs,
+                                sizeof(got[i].estimated_profit.limbs)) == 0);
+    }
+    ASSERT_EQ(hotpath_scanner_scan(scanner, got.data(), 3), 3UL);
+
+    hotpath_scanner_destroy(scanner);
+}
+
+TEST(pool_ring_drains_into_scanner) {
+    constexpr size_t capacity = 64;
+    std::vector<uint8_t> storage(hotpath_pool_ring_bytes(capacity) + 64);
+    void* memory = storage.data() + (64 - reinterpret_cast<uintptr_t>(storage.data()) % 64) % 64;
+    const size_t bytes = hotpath_pool_ring_bytes(capacity);
+
+    ASSERT_EQ(hotpath_pool_ring_init(memory, bytes, 48), -1);        // Not a power of two
+    ASSERT_EQ(hotpath_pool_ring_init(memory, bytes - 1, capacity), -1);
+    ASSERT_EQ(hotpath_pool_ring_init(static_cast<uint8_t*>(memory) + 8, bytes, capacity), -1);
+    ASSERT_EQ(hotpath_pool_ring_init(memory, bytes, capacity), 0);
+
+    // Fill past capacity, drain part, refill across the wrap point
+    std::vector<ffi_pool_reserves_t> updates(100);
+    for (uint32_t i = 0; i < updates.size(); ++i) {
+        updates[i] = ffi_pool_reserves_t{};
+        updates[i].reserve0.limbs[0] = 1'000'000;
+        updates[i].reserve1.limbs[0] = 2'000'000 + i;
+        updates[i].pool_id = i;
+        updates[i].dex_id = 1;
+    }
+    ffi_scanner_handle_t scanner = hotpath_scanner_create(nullptr);
+    ASSERT_EQ(hotpath_pool_ring_push(memory, bytes, updates.data(), updates.size()), capacity);
+    ASSERT_EQ(hotpath_scanner_drain_ring(scanner, memory, bytes, 40), 40UL);
+    ASSERT_EQ(hotpath_pool_ring_push(memory, bytes, updates.data() + capacity, updates.size() - capacity), 36UL);
+    ASSERT_EQ(hotpath_scanner_drain_ring(scanner, memory, bytes, SIZE_MAX), 60UL);
+    ASSERT_EQ(hotpath_scanner_drain_ring(scanner, memory, bytes, SIZE_MAX), 0UL);
+    ASSERT_EQ(hotpath_scanner_pool_count(scanner), 100UL);
+    hotpath_scanner_destroy(scanner);
+
+    // A producer thread streaming updates while the scanner drains
+    PoolRing producer = PoolRing::format(memory, bytes, capacity);
+    OpportunityScanner consumer;
+    PoolRing ring(memory, bytes);
+    constexpr uint32_t total = 20'000;
+    std::thread thread([&producer] {
+        PoolReserves pool{};
+        pool.reserve0 = U256(1'000'000);
+        pool.dex_id = 1;
+        for (uint32_t i = 0; i < total;) {
+            pool.pool_id = i % 500;
+            pool.reserve1 = U256(1'000'000 + i);
+            if (producer.push(&pool, 1) == 1) ++i;
+        }
+    });
+    size_t drained = 0;
+    while (drained < total) drained += consumer.drain(ring);
+    thread.join();
+
+    ASSERT_EQ(drained, static_cast<size_t>(total));
+    ASSERT_EQ(consumer.pool_count(), 500UL);
+    ASSERT_EQ(ring.size(), 0UL);
+
+    bool threw = false;
+    try {
+        std::memset(memory, 0, sizeof(PoolRingHeader));
+        PoolRing unformatted(memory, bytes);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    ASSERT_TRUE(threw);
 }
 
 // ============================================================================
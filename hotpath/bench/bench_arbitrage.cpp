@@ -0,0 +1,132 @@
+/**
+ * Arbitrage benchmarks - scans over a block-burst book, and whole-trace
+ * replays through queue -> book -> calculator -> composer
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+#include "arbitrage/Calculator.hpp"
+#include "memory/Arena.hpp"
+#include "orderbook/OrderBook.hpp"
+#include "runtime/Replay.hpp"
+
+using namespace matrix;
+using namespace matrix::arbitrage;
+using namespace matrix::orderbook;
+using namespace matrix::runtime;
+
+namespace {
+
+SyntheticTraceConfig burst_config(size_t pools) {
+    SyntheticTraceConfig config;
+    config.pools = pools;
+    config.tokens = pools / 8;
+    return config;
+}
+
+// MATRIX_REPLAY_TRACE points the replay benchmarks at a recorded trace
+std::vector<PriceUpdate> replay_trace() {
+    if (const char* path = std::getenv("MATRIX_REPLAY_TRACE")) return load_trace(path);
+    return synthesize_trace(burst_config(256));
+}
+
+} // namespace
+
+// ============================================================================
+// Calculator scans (book seeded from the first block of a burst trace)
+// ============================================================================
+
+// Args: pools, scan threads
+static void BM_Calculator_ScanFull(benchmark::State& state) {
+    const auto trace = synthesize_trace(burst_config(static_cast<size_t>(state.range(0))));
+    memory::Arena arena;
+    OrderBook book(arena);
+    for (const auto& update : trace) book.update_pool(update);
+    CalculatorConfig config;
+    config.scan_threads = static_cast<size_t>(state.range(1));
+    Calculator calculator(book, config);
+    OpportunityBuffer out(Calculator::MAX_OPPORTUNITIES);
+    calculator.scan(out, ChainId::ETHEREUM);   // Builds the graph and cycle index
+
+    for (auto _ : state) {
+        calculator.scan(out, ChainId::ETHEREUM);
+        benchmark::DoNotOptimize(out.size());
+    }
+    state.counters["cycles"] = static_cast<double>(calculator.cycles().cycle_count());
+}
+BENCHMARK(BM_Calculator_ScanFull)->Args({256, 1})->Args({1024, 1})->Args({1024, 4})->UseRealTime();
+
+// One block's burst: re-scan only the cycles its updates touched
+static void BM_Calculator_ScanIncrementalBurst(benchmark::State& state) {
+    const auto config = burst_config(static_cast<size_t>(state.range(0)));
+    const auto trace = synthesize_trace(config);
+    memory::Arena arena;
+    OrderBook book(arena);
+    for (size_t i = 0; i < config.pools; ++i) book.update_pool(trace[i]);
+    Calculator calculator(book);
+    OpportunityBuffer out(Calculator::MAX_OPPORTUNITIES);
+    calculator.scan_incremental(book.dirty_pools(), out);
+
+    size_t next = config.pools;
+    for (auto _ : state) {
+        state.PauseTiming();
+        book.clear_dirty();
+        for (size_t i = 0; i < config.updates_per_block; ++i) {
+            book.update_pool(trace[next++]);
+            if (next == trace.size()) next = config.pools;
+        }
+        state.ResumeTiming();
+        calculator.scan_incremental(book.dirty_pools(), out);
+        benchmark::DoNotOptimize(out.size());
+    }
+}
+BENCHMARK(BM_Calculator_ScanIncrementalBurst)->Arg(256)->Arg(1024);
+
+// Bellman-Ford over the same book: cost follows edges, not cycles
+static void BM_Calculator_ScanNegativeCycles(benchmark::State& state) {
+    const auto trace = synthesize_trace(burst_config(static_cast<size_t>(state.range(0))));
+    memory::Arena arena;
+    OrderBook book(arena);
+    for (const auto& update : trace) book.update_pool(update);
+    Calculator calculator(book);
+    OpportunityBuffer out(Calculator::MAX_OPPORTUNITIES);
+    calculator.scan_negative_cycles(out, ChainId::ETHEREUM);   // Builds the edge columns
+
+    for (auto _ : state) {
+        calculator.scan_negative_cycles(out, ChainId::ETHEREUM);
+        benchmark::DoNotOptimize(out.size());
+    }
+    state.counters["edges"] = static_cast<double>(calculator.graph().edge_count());
+}
+BENCHMARK(BM_Calculator_ScanNegativeCycles)->Arg(256)->Arg(1024)->Arg(8192);
+
+// ============================================================================
+// Replay: every stage, recorded bursts at full speed
+// ============================================================================
+
+static void BM_Replay_Trace(benchmark::State& state) {
+    const auto trace = replay_trace();
+    ReplayConfig config;
+    config.gas_price_gwei = 0;                 // Compose whatever the scans keep
+    auto harness = std::make_unique<ReplayHarness>(config);
+
+    ReplayReport report;
+    for (auto _ : state) {
+        report = harness->run(trace);
+        benchmark::DoNotOptimize(report.checksum);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(trace.size()));
+
+    telemetry::Snapshot stages;
+    telemetry::LatencyHistogram::Snapshot end_to_end;
+    harness->snapshot(stages, end_to_end);
+    state.counters["batch_p50_ns"] = static_cast<double>(end_to_end.percentile(0.5));
+    state.counters["batch_p99_ns"] = static_cast<double>(end_to_end.percentile(0.99));
+    state.counters["scan_p99_ns"] = static_cast<double>(stages[static_cast<size_t>(telemetry::Stage::SCAN)].percentile(0.99));
+    state.counters["txs"] = static_cast<double>(report.transactions);
+}
+BENCHMARK(BM_Replay_Trace)->Unit(benchmark::kMillisecond);
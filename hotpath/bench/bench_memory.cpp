@@ -0,0 +1,135 @@
+/**
+ * Memory benchmarks - arena bump allocation, pools, pmr over the arena
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+#include "memory/Arena.hpp"
+#include "memory/ArenaResource.hpp"
+#include "memory/ConcurrentObjectPool.hpp"
+
+using namespace matrix;
+using namespace matrix::memory;
+
+namespace {
+
+struct Order {
+    uint64_t id;
+    uint64_t price;
+    uint64_t amount;
+    uint64_t flags;
+};
+
+} // namespace
+
+// ============================================================================
+// Arenas
+// ============================================================================
+
+static void BM_Arena_Allocate64(benchmark::State& state) {
+    Arena arena(16 << 20);
+    for (auto _ : state) {
+        void* ptr = arena.allocate(64);
+        if (!ptr) {
+            arena.reset();
+            ptr = arena.allocate(64);
+        }
+        benchmark::DoNotOptimize(ptr);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Arena_Allocate64);
+
+static void BM_ThreadArena_Allocate64(benchmark::State& state) {
+    Arena parent(16 << 20);
+    ThreadArena arena(parent, 8 << 20);
+    for (auto _ : state) {
+        void* ptr = arena.allocate(64);
+        if (!ptr) {
+            arena.reset();
+            ptr = arena.allocate(64);
+        }
+        benchmark::DoNotOptimize(ptr);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ThreadArena_Allocate64);
+
+// ============================================================================
+// Object pools: acquire + release of one object
+// ============================================================================
+
+static void BM_New_Delete(benchmark::State& state) {
+    for (auto _ : state) {
+        auto* order = new Order{1, 2, 3, 4};
+        benchmark::DoNotOptimize(order);
+        delete order;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_New_Delete);
+
+static void BM_ObjectPool_AcquireRelease(benchmark::State& state) {
+    auto pool = std::make_unique<ObjectPool<Order, 4096>>();
+    for (auto _ : state) {
+        Order* order = pool->acquire(Order{1, 2, 3, 4});
+        benchmark::DoNotOptimize(order);
+        pool->release(order);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ObjectPool_AcquireRelease);
+
+static void BM_ConcurrentObjectPool_AcquireRelease(benchmark::State& state) {
+    ConcurrentObjectPool<Order> pool(4096);
+    for (auto _ : state) {
+        Order* order = pool.acquire(Order{1, 2, 3, 4});
+        benchmark::DoNotOptimize(order);
+        pool.release(order);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ConcurrentObjectPool_AcquireRelease);
+
+static void BM_ConcurrentObjectPool_CachedAcquireRelease(benchmark::State& state) {
+    ConcurrentObjectPool<Order> pool(4096);
+    ConcurrentObjectPool<Order>::Cache cache(pool);
+    for (auto _ : state) {
+        Order* order = cache.acquire(Order{1, 2, 3, 4});
+        benchmark::DoNotOptimize(order);
+        cache.release(order);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ConcurrentObjectPool_CachedAcquireRelease);
+
+// ============================================================================
+// pmr containers: default heap vs the arena
+// ============================================================================
+
+static void BM_PmrVector_Heap(benchmark::State& state) {
+    for (auto _ : state) {
+        std::pmr::vector<uint64_t> values(std::pmr::new_delete_resource());
+        for (uint64_t i = 0; i < 1024; ++i) values.push_back(i);
+        benchmark::DoNotOptimize(values.data());
+    }
+    state.SetItemsProcessed(state.iterations() * 1024);
+}
+BENCHMARK(BM_PmrVector_Heap);
+
+static void BM_PmrVector_Arena(benchmark::State& state) {
+    Arena arena(16 << 20);
+    ArenaResource resource(arena);
+    for (auto _ : state) {
+        arena.reset();
+        std::pmr::vector<uint64_t> values(&resource);
+        for (uint64_t i = 0; i < 1024; ++i) values.push_back(i);
+        benchmark::DoNotOptimize(values.data());
+    }
+    state.SetItemsProcessed(state.iterations() * 1024);
+}
+BENCHMARK(BM_PmrVector_Arena);
@@ -0,0 +1,111 @@
+/**
+ * Feed ingestion benchmarks - log notification decoding (messages/s on one core)
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "memory/Arena.hpp"
+#include "network/FeedDecoder.hpp"
+#include "orderbook/SPSCQueue.hpp"
+
+using namespace matrix;
+using namespace matrix::network;
+
+namespace {
+
+constexpr std::string_view SYNC = "0x1c411e9a96e071241c2f21f7726b17ae89e3cab4c78be50e062b03a9fffbbad1";
+constexpr std::string_view V3_SWAP = "0xc42079f94a6350d7e6235f29174924f928cc2ac818eb64fed8004e115fbcca67";
+constexpr size_t POOLS = 1024;
+
+std::string pool_address(size_t i) {
+    char buf[43];
+    std::snprintf(buf, sizeof(buf), "0x%040zx", static_cast<size_t>(i * 0x9E3779B97F4A7C15ULL));
+    return buf;
+}
+
+std::string word(uint64_t value) {
+    char buf[65];
+    std::snprintf(buf, sizeof(buf), "%064llx", static_cast<unsigned long long>(value));
+    return buf;
+}
+
+// A realistic eth_subscription notification (geth field order)
+std::string log_message(const std::string& address, std::string_view topic0, const std::string& data) {
+    return R"({"jsonrpc":"2.0","method":"eth_subscription","params":{"subscription":"0x9ce59a13059e417087c02d3236a0b1cc",)"
+           R"("result":{"address":")" + address + R"(","topics":[")" + std::string(topic0) +
+           R"(","0x0000000000000000000000003fc91a3afd70395cd496c647d5a6cc9d4b2b7fad"],"data":"0x)" + data +
+           R"(","blockNumber":"0x12a05f2","transactionHash":"0x6f2c7a1e4d8b9f0a3c5e7d9b1a2c4e6f8a0b2d4c6e8f0a1b3c5d7e9f1a2b3c4d",)"
+           R"("transactionIndex":"0x4","blockHash":"0x1b4e8f2a6c0d3e5f7a9b1c3d5e7f9a0b2c4d6e8f0a1b3c5d7e9f1a2b3c4d5e6f",)"
+           R"("logIndex":"0x1a","removed":false}}})";
+}
+
+struct Feed {
+    memory::Arena arena{1 << 20};
+    FeedDecoder decoder{orderbook::ChainId::ETHEREUM, arena, POOLS};
+    std::vector<std::string> messages;
+
+    explicit Feed(PoolEvent event) {
+        for (size_t i = 0; i < POOLS; ++i) {
+            PoolInfo info{};
+            info.token0 = 2 * i;
+            info.token1 = 2 * i + 1;
+            info.dex = event == PoolEvent::V2_SYNC ? orderbook::DexId::SUSHISWAP : orderbook::DexId::UNISWAP_V3;
+            info.event = event;
+            decoder.add_pool(pool_address(i), info);
+
+            const std::string data = event == PoolEvent::V2_SYNC
+                ? word(1'000'000 + i) + word(2'000'000 + i)
+                : word(5) + word(7) + word((1ULL << 48) + i) + word(1'000'000'000 + i) + word(0x1f4);
+            messages.push_back(log_message(pool_address(i), event == PoolEvent::V2_SYNC ? SYNC : V3_SWAP, data));
+        }
+    }
+};
+
+void run_decode(benchmark::State& state, PoolEvent event) {
+    Feed feed(event);
+    orderbook::PriceUpdate update{};
+    size_t i = 0;
+    size_t bytes = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(feed.decoder.decode(feed.messages[i], i, update));
+        benchmark::DoNotOptimize(update);
+        bytes += feed.messages[i].size();
+        if (++i == POOLS) i = 0;
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(static_cast<int64_t>(bytes));
+}
+
+} // namespace
+
+// ============================================================================
+// FeedDecoder
+// ============================================================================
+
+static void BM_FeedDecoder_V2Sync(benchmark::State& state) {
+    run_decode(state, PoolEvent::V2_SYNC);
+}
+BENCHMARK(BM_FeedDecoder_V2Sync);
+
+static void BM_FeedDecoder_V3Swap(benchmark::State& state) {
+    run_decode(state, PoolEvent::V3_SWAP);
+}
+BENCHMARK(BM_FeedDecoder_V3Swap);
+
+static void BM_FeedDecoder_DecodeIntoQueue(benchmark::State& state) {
+    Feed feed(PoolEvent::V2_SYNC);
+    auto queue = std::make_unique<orderbook::PriceQueue>();
+    size_t i = 0;
+    for (auto _ : state) {
+        feed.decoder.decode_into(feed.messages[i], i, *queue);
+        queue->consume([](orderbook::PriceUpdate& u) noexcept { benchmark::DoNotOptimize(u); }, 1);
+        if (++i == POOLS) i = 0;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_FeedDecoder_DecodeIntoQueue);
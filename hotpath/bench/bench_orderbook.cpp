@@ -0,0 +1,254 @@
+/**
+ * Order book benchmarks - flat indexes vs std::unordered_map
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <memory>
+#include <random>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "memory/Arena.hpp"
+#include "orderbook/BookSnapshot.hpp"
+#include "orderbook/FlatHashMap.hpp"
+#include "orderbook/OrderBook.hpp"
+
+using namespace matrix;
+using namespace matrix::orderbook;
+
+namespace {
+
+std::vector<uint64_t> random_keys(size_t count, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::vector<uint64_t> keys(count);
+    for (auto& k : keys) k = rng();
+    return keys;
+}
+
+std::vector<PriceUpdate> random_updates(size_t pools, size_t tokens, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::vector<PriceUpdate> updates(pools);
+    for (size_t i = 0; i < pools; ++i) {
+        auto& u = updates[i];
+        u.timestamp_ns = i;
+        u.pool_hash = rng();
+        u.chain_id = static_cast<uint32_t>(ChainId::ETHEREUM);
+        u.dex_id = static_cast<uint32_t>(DexId::UNISWAP_V3);
+        u.token0 = 0x1000 + rng() % tokens;
+        u.token1 = 0x1000 + (u.token0 + 1 + rng() % (tokens - 1)) % tokens;
+        u.reserve0 = rng() >> 8;
+        u.reserve1 = rng() >> 8;
+    }
+    return updates;
+}
+
+} // namespace
+
+// ============================================================================
+// Pool hash -> index lookups
+// ============================================================================
+
+static void BM_FlatHashMap_Find(benchmark::State& state) {
+    const auto n = static_cast<size_t>(state.range(0));
+    memory::Arena arena;
+    FlatHashMap<uint64_t, uint32_t, U64Hash> map(arena, n);
+    const auto keys = random_keys(n, 42);
+    for (size_t i = 0; i < n; ++i) map.insert(keys[i], static_cast<uint32_t>(i));
+
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(map.find(keys[i]));
+        if (++i == n) i = 0;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_FlatHashMap_Find)->Arg(1000)->Arg(100000);
+
+static void BM_UnorderedMap_Find(benchmark::State& state) {
+    const auto n = static_cast<size_t>(state.range(0));
+    std::unordered_map<uint64_t, size_t> map;
+    map.reserve(n);
+    const auto keys = random_keys(n, 42);
+    for (size_t i = 0; i < n; ++i) map[keys[i]] = i;
+
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(map.find(keys[i]));
+        if (++i == n) i = 0;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_UnorderedMap_Find)->Arg(1000)->Arg(100000);
+
+// ============================================================================
+// OrderBook::update_pool
+// ============================================================================
+
+static void BM_OrderBook_UpdateExistingPool(benchmark::State& state) {
+    memory::Arena arena;
+    auto book = std::make_unique<OrderBook>(arena);
+    auto updates = random_updates(static_cast<size_t>(state.range(0)), 5000, 7);
+    for (const auto& u : updates) book->update_pool(u);
+
+    size_t i = 0;
+    for (auto _ : state) {
+        updates[i].reserve0 += 1;
+        book->update_pool(updates[i]);
+        if (++i == updates.size()) i = 0;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_OrderBook_UpdateExistingPool)->Arg(1000)->Arg(50000);
+
+// Seqlocked reads from a scanner thread while a writer re-prices the same
+// pools; arg = 1 runs the writer, 0 measures the uncontended read
+static void BM_OrderBook_ReadDuringUpdates(benchmark::State& state) {
+    memory::Arena arena;
+    auto book = std::make_unique<OrderBook>(arena);
+    auto updates = random_updates(1000, 200, 7);
+    for (const auto& u : updates) book->update_pool(u);
+
+    std::atomic<bool> done{false};
+    std::thread writer;
+    if (state.range(0)) {
+        writer = std::thread([&] {
+            for (size_t i = 0; !done.load(std::memory_order_relaxed); i = (i + 1) % updates.size()) {
+                updates[i].reserve0 += 1;
+                book->update_pool(updates[i]);
+            }
+        });
+    }
+
+    uint32_t id = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(book->pool(id));
+        if (++id == updates.size()) id = 0;
+    }
+    done.store(true, std::memory_order_relaxed);
+    if (writer.joinable()) writer.join();
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_OrderBook_ReadDuringUpdates)->Arg(0)->Arg(1)->UseRealTime();
+
+static void BM_OrderBook_InsertPools(benchmark::State& state) {
+    const auto n = static_cast<size_t>(state.range(0));
+    const auto updates = random_updates(n, 5000, 11);
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto arena = std::make_unique<memory::Arena>();
+        auto book = std::make_unique<OrderBook>(*arena);
+        state.ResumeTiming();
+
+        for (const auto& u : updates) book->update_pool(u);
+        benchmark::DoNotOptimize(book->pool_count());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(n));
+}
+BENCHMARK(BM_OrderBook_InsertPools)->Arg(10000);
+
+// Warm start: the same pools as InsertPools, adopted from a sealed image
+static void BM_OrderBook_RestoreSnapshot(benchmark::State& state) {
+    const auto n = static_cast<size_t>(state.range(0));
+    const auto updates = random_updates(n, 5000, 11);
+    std::vector<std::byte> image;
+    {
+        memory::Arena arena;
+        auto book = std::make_unique<OrderBook>(arena);
+        for (const auto& u : updates) book->update_pool(u);
+        image.resize(book->snapshot_size());
+        book->write_snapshot(image);
+        seal_snapshot(image);
+    }
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto arena = std::make_unique<memory::Arena>();
+        auto book = std::make_unique<OrderBook>(*arena);
+        state.ResumeTiming();
+
+        benchmark::DoNotOptimize(book->restore_snapshot(image));
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(n));
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(image.size()));
+}
+BENCHMARK(BM_OrderBook_RestoreSnapshot)->Arg(10000);
+
+// The copy SnapshotWriter's thread makes per capture() (off the book's thread)
+static void BM_OrderBook_WriteSnapshot(benchmark::State& state) {
+    const auto n = static_cast<size_t>(state.range(0));
+    memory::Arena arena;
+    auto book = std::make_unique<OrderBook>(arena);
+    for (const auto& u : random_updates(n, 5000, 11)) book->update_pool(u);
+    std::vector<std::byte> image(book->max_snapshot_size());
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(book->write_snapshot(image));
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(book->snapshot_size()));
+}
+BENCHMARK(BM_OrderBook_WriteSnapshot)->Arg(10000);
+
+static void BM_OrderBook_GetBestPrice(benchmark::State& state) {
+    memory::Arena arena;
+    auto book = std::make_unique<OrderBook>(arena);
+    const auto updates = random_updates(20000, 200, 13);
+    for (const auto& u : updates) book->update_pool(u);
+
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(book->get_best_price(updates[i].token0, updates[i].token1));
+        if (++i == updates.size()) i = 0;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_OrderBook_GetBestPrice);
+
+// ============================================================================
+// Best-pool selection kernel
+// ============================================================================
+
+static void BM_ArgMaxOutput(benchmark::State& state) {
+    const auto n = static_cast<size_t>(state.range(0));
+    const auto rin = random_keys(n, 17);
+    const auto rout = random_keys(n, 19);
+    const std::vector<uint32_t> fee(n, 30);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(kernels::argmax_output(rin.data(), rout.data(), fee.data(), n));
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(n));
+}
+BENCHMARK(BM_ArgMaxOutput)->Arg(8)->Arg(64)->Arg(1024);
+
+// ============================================================================
+// SPSC queue: per-item vs bulk transfer (single thread, hot cache)
+// ============================================================================
+
+static void BM_SPSC_PushPopSingle(benchmark::State& state) {
+    auto queue = std::make_unique<PriceQueue>();
+    const auto updates = random_updates(256, 64, 29);
+    PriceUpdate out;
+
+    for (auto _ : state) {
+        for (const auto& u : updates) (void)queue->push(u);
+        while (queue->try_pop(out)) benchmark::DoNotOptimize(out);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(updates.size()));
+}
+BENCHMARK(BM_SPSC_PushPopSingle);
+
+static void BM_SPSC_PushBulkConsume(benchmark::State& state) {
+    auto queue = std::make_unique<PriceQueue>();
+    const auto updates = random_updates(256, 64, 29);
+
+    for (auto _ : state) {
+        (void)queue->push_bulk(updates);
+        queue->consume([](const PriceUpdate& u) { benchmark::DoNotOptimize(u.reserve0); });
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(updates.size()));
+}
+BENCHMARK(BM_SPSC_PushBulkConsume);
@@ -0,0 +1,58 @@
+/**
+ * Instrumentation benchmarks - cost of a timestamp and of a recorded sample
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <cstdint>
+
+#include "telemetry/Telemetry.hpp"
+
+using namespace matrix;
+
+namespace {
+
+void BM_SteadyClock_Now(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(std::chrono::steady_clock::now());
+    }
+}
+BENCHMARK(BM_SteadyClock_Now);
+
+void BM_Clock_Ticks(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(telemetry::Clock::ticks());
+    }
+}
+BENCHMARK(BM_Clock_Ticks);
+
+void BM_Clock_NowNs(benchmark::State& state) {
+    telemetry::Clock::calibrate();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(telemetry::Clock::now_ns());
+    }
+}
+BENCHMARK(BM_Clock_NowNs);
+
+void BM_Histogram_Record(benchmark::State& state) {
+    telemetry::LatencyHistogram histogram;
+    uint64_t x = 0x9E3779B97F4A7C15ULL;
+    for (auto _ : state) {
+        x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+        histogram.record(x & 0xFFFFF);
+    }
+    benchmark::DoNotOptimize(histogram);
+}
+BENCHMARK(BM_Histogram_Record);
+
+// What an instrumented stage pays: two TSC reads, a conversion, a record
+void BM_StageTimer(benchmark::State& state) {
+    telemetry::Clock::calibrate();
+    for (auto _ : state) {
+        telemetry::StageTimer timer(telemetry::Stage::COMPOSE);
+    }
+}
+BENCHMARK(BM_StageTimer);
+
+} // namespace
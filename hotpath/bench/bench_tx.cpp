@@ -0,0 +1,137 @@
+/**
+ * Transaction composition benchmarks - arbitrage calldata (transactions/s on one core)
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <vector>
+
+#include "memory/Arena.hpp"
+#include "tx/Composer.hpp"
+#include "tx/RouteCache.hpp"
+#include "tx/Keccak.hpp"
+
+using namespace matrix;
+using namespace matrix::tx;
+
+namespace {
+
+constexpr size_t ROUTES = 16;    // Hot set: a handful of routes recur
+
+std::array<uint8_t, 20> address_of(uint64_t i) {
+    std::array<uint8_t, 20> a{};
+    for (size_t b = 0; b < 8; ++b) a[19 - b] = static_cast<uint8_t>(i >> (8 * b));
+    a[0] = 0x42;
+    return a;
+}
+
+Composer make_composer() {
+    ComposerConfig config;
+    config.chain_id = 42161;
+    config.flash_loan_pool = address_of(0xAA);
+    config.executor = address_of(0xEE);
+    return Composer(config);
+}
+
+// ROUTES distinct cycles of `hops` swaps each
+std::vector<std::vector<SwapParams>> make_routes(size_t hops) {
+    std::vector<std::vector<SwapParams>> routes(ROUTES);
+    for (size_t r = 0; r < ROUTES; ++r) {
+        for (size_t h = 0; h < hops; ++h) {
+            SwapParams swap{};
+            swap.pool = address_of(1000 + r * 8 + h);
+            swap.token_in = address_of(h);
+            swap.token_out = address_of((h + 1) % hops);
+            swap.amount_in = 1'000'000 + h;
+            swap.min_amount_out = 990'000 + h;
+            swap.fee = 500;
+            routes[r].push_back(swap);
+        }
+    }
+    return routes;
+}
+
+} // namespace
+
+// ============================================================================
+// Composer
+// ============================================================================
+
+static void BM_Composer_ComposeArbitrage(benchmark::State& state) {
+    const Composer composer = make_composer();
+    const auto routes = make_routes(static_cast<size_t>(state.range(0)));
+    uint8_t buf[4096];
+    ByteWriter calldata(buf, sizeof(buf));
+    size_t i = 0;
+    for (auto _ : state) {
+        calldata.clear();
+        const auto& route = routes[i];
+        auto tx = composer.compose_arbitrage({route[0].token_in, i + 1}, route, 600'000, 1'000'000,
+                                             2'000'000'000, calldata, 1'700'000'000);
+        benchmark::DoNotOptimize(tx);
+        if (++i == ROUTES) i = 0;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Composer_ComposeArbitrage)->Arg(2)->Arg(4);
+
+static void BM_RouteCache_ComposeArbitrage(benchmark::State& state) {
+    const Composer composer = make_composer();
+    memory::Arena arena(16 << 20);
+    RouteCache cache(composer, arena, ROUTES);
+    const auto routes = make_routes(static_cast<size_t>(state.range(0)));
+    uint8_t buf[4096];
+    ByteWriter calldata(buf, sizeof(buf));
+    size_t i = 0;
+    for (auto _ : state) {
+        calldata.clear();
+        const auto& route = routes[i];
+        auto tx = cache.compose_arbitrage({route[0].token_in, i + 1}, route, 600'000, 1'000'000,
+                                          2'000'000'000, calldata, 1'700'000'000);
+        benchmark::DoNotOptimize(tx);
+        if (++i == ROUTES) i = 0;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_RouteCache_ComposeArbitrage)->Arg(2)->Arg(4);
+
+// ============================================================================
+// Hashing and signing
+// ============================================================================
+
+static void BM_Keccak256_Calldata(benchmark::State& state) {
+    std::vector<uint8_t> payload(Composer::arbitrage_calldata_bytes(3));
+    for (auto _ : state) {
+        auto hash = keccak256(payload);
+        benchmark::DoNotOptimize(hash);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Keccak256_Calldata);
+
+static void BM_Keccak256_x4_Calldata(benchmark::State& state) {
+    std::vector<uint8_t> payload(Composer::arbitrage_calldata_bytes(3));
+    const std::array<std::span<const uint8_t>, 4> inputs = {payload, payload, payload, payload};
+    std::array<Hash256, 4> out;
+    for (auto _ : state) {
+        keccak256_x4(inputs, out);
+        benchmark::DoNotOptimize(out);
+    }
+    state.SetItemsProcessed(state.iterations() * 4);
+}
+BENCHMARK(BM_Keccak256_x4_Calldata);
+
+static void BM_Signer_SignHash(benchmark::State& state) {
+    std::array<uint8_t, 32> key;
+    key.fill(0x46);
+    const Signer signer(key);
+    Hash256 hash{};
+    for (auto _ : state) {
+        auto sig = signer.sign_hash(hash);
+        hash[0] = sig.r[0];   // Fresh message (and nonce) each time
+        benchmark::DoNotOptimize(sig);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Signer_SignHash);
@@ -3,11 +3,16 @@
 #include <cstdint>
 #include <vector>
 #include <array>
+#include <memory>
+#include <memory_resource>
 #include <optional>
-#include <unordered_map>
-#include <unordered_set>
+#include <span>
 
 #include "../orderbook/OrderBook.hpp"
+#include "../runtime/WorkStealingPool.hpp"
+#include "CycleIndex.hpp"
+#include "NegativeCycleDetector.hpp"
+#include "TokenGraph.hpp"
 
 namespace matrix::arbitrage {
 
@@ -15,13 +20,30 @@ namespace matrix::arbitrage {
 using orderbook::ChainId;
 using orderbook::OrderBook;
 
+/**
+ * a - b as a signed amount, clamped to the int64 range instead of wrapping
+ */
+[[nodiscard]] constexpr int64_t saturating_difference(uint64_t a, uint64_t b) noexcept {
+    constexpr uint64_t INT64_LIMIT = uint64_t{1} << 63;
+    if (a >= b) return a - b >= INT64_LIMIT ? INT64_MAX : static_cast<int64_t>(a - b);
+    return b - a >= INT64_LIMIT ? INT64_MIN : -static_cast<int64_t>(b - a);
+}
+
+/**
+ * Aave's 0.05% flash loan premium, floor(amount * 5 / 10000) without the
+ * product overflowing
+ */
+[[nodiscard]] constexpr uint64_t flash_loan_premium(uint64_t amount) noexcept {
+    return amount / 10000 * 5 + amount % 10000 * 5 / 10000;
+}
+
 /**
  * Arbitrage Opportunity
  */
 struct Opportunity {
     uint64_t id;                          // Unique opportunity ID
-    uint64_t timestamp_ns;                // Detection timestamp
-    uint64_t profit_wei;                  // Expected profit in wei
+    uint64_t timestamp_ns;                // Detection timestamp (scan start, realtime ns)
+    uint64_t profit_wei;                  // Expected profit in native wei (see Calculator)
     uint32_t gas_estimate;                // Estimated gas cost
     ChainId chain;                        // Target chain
 
@@ -39,65 +61,229 @@ struct Opportunity {
 
     // Flash loan details
     uint64_t flash_loan_token;            // Token to borrow
-    uint64_t flash_loan_amount;           // Amount to borrow
-    uint64_t flash_loan_fee;              // Fee in wei
+    uint64_t flash_loan_amount;           // Amount to borrow, in flash_loan_token units
+    uint64_t flash_loan_fee;              // Fee in native wei
 
     /**
      * Calculate net profit after gas and fees
      */
     [[nodiscard]] int64_t net_profit(uint64_t gas_price_gwei) const noexcept {
-        const uint64_t gas_cost = static_cast<uint64_t>(gas_estimate) * gas_price_gwei * 1'000'000'000ULL;
-        return static_cast<int64_t>(profit_wei) - static_cast<int64_t>(gas_cost + flash_loan_fee);
+        // 128-bit cost, saturated: extreme gas prices never wrap to a profit
+        const unsigned __int128 cost = static_cast<unsigned __int128>(gas_estimate) * gas_price_gwei *
+                                       1'000'000'000ULL + flash_loan_fee;
+        return saturating_difference(profit_wei, cost > UINT64_MAX ? UINT64_MAX : static_cast<uint64_t>(cost));
     }
 
     /**
      * Check if opportunity is profitable at given gas price
      */
     [[nodiscard]] bool is_profitable(uint64_t gas_price_gwei, uint64_t min_profit_wei = 0) const noexcept {
-        return net_profit(gas_price_gwei) > static_cast<int64_t>(min_profit_wei);
+        const int64_t net = net_profit(gas_price_gwei);
+        return net > 0 && static_cast<uint64_t>(net) > min_profit_wei;
     }
 };
 
 /**
- * Token Graph Node - represents a token and its connected pools
+ * Opportunity Buffer - caller-owned scan output that keeps the best K
+ *
+ * Storage is reserved once (from any memory resource, e.g. an
+ * ArenaResource over the scan thread's arena), and the buffer is reused
+ * scan after scan, so scanning into it never allocates. Offers append
+ * until it is full; from then on it is a min-heap on profit and an offer
+ * only displaces the current worst, so the best K of N candidates cost
+ * O(N log K) with no full sort. finish() orders the survivors.
  */
-struct TokenNode {
-    uint64_t token_hash;
-    std::vector<uint64_t> connected_pools;
-    std::vector<uint64_t> connected_tokens;
+class OpportunityBuffer {
+public:
+    explicit OpportunityBuffer(
+        size_t capacity,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource()
+    );
+
+    void clear() noexcept {
+        items_.clear();
+        heap_ = false;
+    }
+
+    /**
+     * Keep `opp` if there is room or it beats the worst one kept
+     * @return false if it was discarded
+     */
+    bool offer(const Opportunity& opp) noexcept;
+
+    /**
+     * Order the kept opportunities by profit, best first
+     */
+    void finish() noexcept;
+
+    [[nodiscard]] std::span<const Opportunity> view() const noexcept { return items_; }
+    [[nodiscard]] const Opportunity& operator[](size_t i) const noexcept { return items_[i]; }
+    [[nodiscard]] auto begin() const noexcept { return items_.begin(); }
+    [[nodiscard]] auto end() const noexcept { return items_.end(); }
+    [[nodiscard]] size_t size() const noexcept { return items_.size(); }
+    [[nodiscard]] bool empty() const noexcept { return items_.empty(); }
+    [[nodiscard]] size_t capacity() const noexcept { return capacity_; }
+
+    /**
+     * Offers dropped or displaced because the buffer was full (cumulative)
+     */
+    [[nodiscard]] uint64_t discarded() const noexcept { return discarded_; }
+
+private:
+    std::pmr::vector<Opportunity> items_;
+    size_t capacity_;
+    bool heap_ = false;                   // items_ is a min-heap on profit
+    uint64_t discarded_ = 0;
 };
 
+// Token address hashes (lower 64 bits of keccak256 hash used for lookup)
+// These are placeholder hash values representing the actual token addresses
+inline constexpr uint64_t WETH_MAINNET = 0xC02aaA39b223FE8DULL;    // WETH on Ethereum
+inline constexpr uint64_t USDC_MAINNET = 0xA0b86991c6218b36ULL;    // USDC on Ethereum
+inline constexpr uint64_t USDT_MAINNET = 0xdAC17F958D2ee523ULL;    // USDT on Ethereum
+
+inline constexpr uint64_t WETH_ARBITRUM = 0x82aF49447D8a07e3ULL;   // WETH on Arbitrum
+inline constexpr uint64_t USDC_ARBITRUM = 0xaf88d065e77c8cC2ULL;   // USDC on Arbitrum
+inline constexpr uint64_t USDT_ARBITRUM = 0xFd086bC7CD5C481DULL;   // USDT on Arbitrum
+
+inline constexpr uint64_t WETH_BASE = 0x4200000000000006ULL;       // WETH on Base
+inline constexpr uint64_t USDC_BASE = 0x833589fCD6eDb6E0ULL;       // USDC on Base
+
+// OP Stack predeploy: the same address, so the same book token, as
+// WETH_BASE; cycle search and native pricing only follow the chain's pools
+inline constexpr uint64_t WETH_OPTIMISM = 0x4200000000000006ULL;   // WETH on Optimism
+inline constexpr uint64_t USDC_OPTIMISM = 0x0b2C639c533813f4ULL;   // USDC on Optimism
+
+inline constexpr uint64_t WBNB_BSC = 0xbb4CdB9CBd36B01bULL;        // WBNB on BSC
+inline constexpr uint64_t USDT_BSC = 0x55d398326f99059fULL;        // USDT on BSC
+
 /**
- * Arbitrage Calculator - SIMD-optimized cycle detection
- *
- * Uses Bellman-Ford variant for negative cycle detection in the price graph.
- * Optimized with SIMD (AVX2) for parallel price comparisons.
+ * Each chain's wrapped native token, the unit gas is paid and profit is
+ * ranked in
+ */
+[[nodiscard]] constexpr uint64_t wrapped_native(ChainId chain) noexcept {
+    switch (chain) {
+        case ChainId::ETHEREUM: return WETH_MAINNET;
+        case ChainId::ARBITRUM: return WETH_ARBITRUM;
+        case ChainId::BASE: return WETH_BASE;
+        case ChainId::OPTIMISM: return WETH_OPTIMISM;
+        case ChainId::BSC: return WBNB_BSC;
+    }
+    return 0;
+}
+
+// Default flash loan base tokens: each chain's wrapped native token and
+// deepest stablecoins (WETH_BASE / WETH_OPTIMISM name one token, searched
+// once per chain over that chain's pools)
+inline constexpr std::array<BaseToken, 12> BASE_TOKENS = {{
+    {WETH_MAINNET, ChainId::ETHEREUM},
+    {USDC_MAINNET, ChainId::ETHEREUM},
+    {USDT_MAINNET, ChainId::ETHEREUM},
+    {WETH_ARBITRUM, ChainId::ARBITRUM},
+    {USDC_ARBITRUM, ChainId::ARBITRUM},
+    {USDT_ARBITRUM, ChainId::ARBITRUM},
+    {WETH_BASE, ChainId::BASE},
+    {USDC_BASE, ChainId::BASE},
+    {WETH_OPTIMISM, ChainId::OPTIMISM},
+    {USDC_OPTIMISM, ChainId::OPTIMISM},
+    {WBNB_BSC, ChainId::BSC},
+    {USDT_BSC, ChainId::BSC},
+}};
+
+struct CalculatorConfig {
+    std::vector<BaseToken> bases{BASE_TOKENS.begin(), BASE_TOKENS.end()};   // Cycles start and end here
+    size_t scan_threads = 1;              // Workers for scan(), the calling thread included
+    size_t relax_passes = NegativeCycleDetector::DEFAULT_MAX_PASSES;   // Bellman-Ford budget per chain
+};
+
+/**
+ * Arbitrage Calculator - cycle detection and sizing
  *
  * Performance target: <50us per full scan
  *
  * Research: Triangular arbitrage is most common (3-hop cycles).
  * We also check 4-hop cycles for less competitive opportunities.
+ *
+ * Full scans search 3- and 4-hop cycles from every configured base token
+ * as one task per (base token, first edge), fanned out over a
+ * work-stealing pool; each worker keeps its own top-K and the survivors
+ * are merged into the caller's buffer.
+ *
+ * scan_negative_cycles() instead runs a bounded Bellman-Ford over each
+ * chain's log prices (NegativeCycleDetector), whose cost does not grow
+ * with the number of cycles a dense token graph holds; the cycles it
+ * proves are sized like any other.
+ *
+ * Profit and flash fees are reported in the chain's native wei, so they
+ * compare against gas and MIN_PROFIT_WEI and rank across base tokens: a
+ * cycle through another base (USDC, USDT) is valued at the spot price of
+ * its best base -> wrapped_native() pool on the cycle's own chain, and
+ * is dropped while the book has no such pool.
  */
 class Calculator {
 public:
     static constexpr size_t MAX_OPPORTUNITIES = 1000;
     static constexpr uint64_t MIN_PROFIT_WEI = 10'000'000'000'000'000ULL;  // 0.01 ETH
 
-    explicit Calculator(const OrderBook& orderbook);
+    /**
+     * @throws std::invalid_argument for zero scan threads
+     */
+    explicit Calculator(const OrderBook& orderbook, CalculatorConfig config = {});
 
     /**
-     * Scan for arbitrage opportunities
+     * Scan every 3- and 4-hop cycle through the base tokens into a reused
+     * buffer (cleared first; the best out.capacity() are kept, sorted by
+     * profit; with several scan threads each keeps at most
+     * MAX_OPPORTUNITIES before the merge)
      * @param chain Target chain (or all chains if nullopt)
-     * @return Vector of profitable opportunities, sorted by profit
+     */
+    void scan(OpportunityBuffer& out, std::optional<ChainId> chain = std::nullopt) noexcept;
+
+    /**
+     * scan() into a fresh vector (allocates; tests and tools)
      */
     [[nodiscard]] std::vector<Opportunity> scan(
         std::optional<ChainId> chain = std::nullopt
     ) noexcept;
 
+    /**
+     * Re-evaluate only the indexed 3- and 4-hop cycles that swap through
+     * the given pools (typically OrderBook::dirty_pools())
+     *
+     * Work scales with the number of updated pools and their cycles, not
+     * with the size of the book. `out` is cleared first and ends up
+     * holding the best opportunities of the affected cycles, sorted by
+     * profit.
+     */
+    void scan_incremental(std::span<const uint32_t> dirty_pools, OpportunityBuffer& out) noexcept;
+
+    [[nodiscard]] std::vector<Opportunity> scan_incremental(
+        std::span<const uint32_t> dirty_pools
+    ) noexcept;
+
+    /**
+     * Detect arbitrage as negative cycles of -log(rate after fee) on each
+     * base token chain and size the ones an Opportunity can route (3 to
+     * MAX_HOPS hops through a base token, once per base token on it)
+     *
+     * `out` is cleared first and ends up holding the best opportunities,
+     * sorted by profit. Cost per chain is at most relax_passes passes over
+     * its edges, whatever the cycle count.
+     * @param chain Target chain (or every base token chain if nullopt)
+     */
+    void scan_negative_cycles(OpportunityBuffer& out, std::optional<ChainId> chain = std::nullopt) noexcept;
+
+    [[nodiscard]] std::vector<Opportunity> scan_negative_cycles(
+        std::optional<ChainId> chain = std::nullopt
+    ) noexcept;
+
     /**
      * Scan for triangular arbitrage (3 hops)
-     * Most common and fastest to detect
+     * Most common and fastest to detect. Offers every profitable triangle
+     * to `out` without clearing or sorting it.
      */
+    void scan_triangular(ChainId chain, uint64_t base_token, OpportunityBuffer& out) noexcept;
+
     [[nodiscard]] std::vector<Opportunity> scan_triangular(
         ChainId chain,
         uint64_t base_token
@@ -105,7 +291,11 @@ public:
 
     /**
      * Calculate optimal input amount for a path
-     * Uses binary search to find profit-maximizing input
+     *
+     * Constant-product hops compose into one virtual x*y=k curve, whose
+     * profit-maximizing input has a closed form; other DEXes fall back to a
+     * bounded ternary search over simulate_path.
+     * @return Profit-maximizing input in [0, max_input], 0 if none profits
      */
     [[nodiscard]] uint64_t optimize_amount(
         const std::array<Opportunity::Hop, 4>& path,
@@ -114,7 +304,8 @@ public:
     ) const noexcept;
 
     /**
-     * Simulate a swap path and return final output
+     * Simulate a swap path hop by hop with each pool's reserves and fee
+     * @return Final output, 0 if any hop's pool is unknown
      */
     [[nodiscard]] uint64_t simulate_path(
         const std::array<Opportunity::Hop, 4>& path,
@@ -122,6 +313,19 @@ public:
         uint64_t input_amount
     ) const noexcept;
 
+    /**
+     * Token graph as of the last scan
+     */
+    [[nodiscard]] const TokenGraph& graph() const noexcept { return graph_; }
+
+    /**
+     * Cycle membership index as of the last scan
+     */
+    [[nodiscard]] const CycleIndex& cycles() const noexcept { return cycles_; }
+
+    [[nodiscard]] std::span<const BaseToken> bases() const noexcept { return bases_; }
+    [[nodiscard]] size_t scan_threads() const noexcept { return workers_ ? workers_->workers() : 1; }
+
     /**
      * Statistics
      */
@@ -129,55 +333,146 @@ public:
     [[nodiscard]] uint64_t opportunity_count() const noexcept { return opportunity_count_; }
     [[nodiscard]] uint64_t last_scan_duration_ns() const noexcept { return last_scan_ns_; }
 
+    /**
+     * Negative cycles detected, and those no Opportunity could route
+     * (too short, too long or through no base token; cumulative)
+     */
+    [[nodiscard]] uint64_t negative_cycle_count() const noexcept { return negative_cycles_; }
+    [[nodiscard]] uint64_t unroutable_cycle_count() const noexcept { return unroutable_cycles_; }
+
 private:
+    /**
+     * One unit of a full scan: every cycle leaving `base` over `first`
+     */
+    struct ScanTask {
+        uint32_t base;                       // Dense token id
+        ChainId chain;
+        Edge first;
+    };
+
     const OrderBook& orderbook_;
+    std::vector<BaseToken> bases_;
+
+    // Token graph for cycle detection (CSR, synced incrementally)
+    TokenGraph graph_;
+
+    // Cycles through base tokens and pool -> cycle membership
+    CycleIndex cycles_;
+    std::vector<uint32_t> cycle_mark_;       // Dedup stamp per cycle
+    uint32_t cycle_epoch_ = 0;
 
-    // Token graph for cycle detection
-    std::unordered_map<uint64_t, TokenNode> token_graph_;
+    // Full scan fan-out (null when scanning on the calling thread only)
+    std::unique_ptr<runtime::WorkStealingPool> workers_;
+    std::vector<ScanTask> tasks_;                                // Reused every scan
+    std::vector<std::unique_ptr<OpportunityBuffer>> worker_results_;   // Per-worker top-K
+
+    // One Bellman-Ford engine per base token chain
+    std::vector<NegativeCycleDetector> detectors_;
+
+    // Backs the vector-returning overloads
+    OpportunityBuffer results_;
+    uint64_t sequence_ = 0;                  // Opportunity ids within a scan
+    uint64_t detected_ns_ = 0;               // Stamped into every opportunity of a scan
 
     // Statistics
     uint64_t scan_count_ = 0;
     uint64_t opportunity_count_ = 0;
     uint64_t last_scan_ns_ = 0;
+    uint64_t negative_cycles_ = 0;
+    uint64_t unroutable_cycles_ = 0;
 
     /**
-     * Build token graph from order book
+     * Bring the token graph and cycle index up to date with the order book
+     * (merges pools created since the last call; no-op otherwise)
      */
     void build_graph() noexcept;
 
     /**
-     * Find cycles starting from a token using DFS
+     * Swap path with every hop's pool looked up once
      */
-    void find_cycles(
-        uint64_t start_token,
-        uint64_t current_token,
-        std::vector<uint64_t>& path,
-        std::vector<Opportunity>& opportunities,
-        ChainId chain,
-        int depth
+    struct ResolvedPath {
+        std::array<orderbook::PoolState, Opportunity::MAX_HOPS> pools;
+        std::array<bool, Opportunity::MAX_HOPS> zero_for_one;
+        uint8_t length = 0;
+        bool constant_product = true;    // Closed-form sizing applies
+    };
+
+    // Search budget for non constant-product paths
+    static constexpr int MAX_SEARCH_ITERATIONS = 64;
+
+    // Candidate input amounts evaluated per batched simulation
+    static constexpr size_t SEARCH_LANES = 4;
+
+    [[nodiscard]] std::optional<ResolvedPath> resolve_path(
+        const std::array<Opportunity::Hop, 4>& path,
+        uint8_t path_length
+    ) const noexcept;
+
+    [[nodiscard]] ResolvedPath resolve_cycle(const Cycle& cycle) const noexcept;
+
+    /**
+     * Chain get_amount_out over the resolved pools
+     * @param hops Optional per-hop amounts out
+     */
+    [[nodiscard]] static uint64_t simulate(
+        const ResolvedPath& path,
+        uint64_t input_amount,
+        Opportunity::Hop* hops = nullptr
     ) noexcept;
 
     /**
-     * SIMD-optimized price comparison for multiple pools
-     * Compares 4 pools at once using AVX2
+     * simulate() for SEARCH_LANES input amounts at once (independent
+     * divisions per hop, see swap::get_amounts_out)
      */
-    void compare_prices_simd(
-        const std::array<uint64_t, 4>& prices,
-        const std::array<uint64_t, 4>& thresholds,
-        std::array<bool, 4>& results
+    static void simulate_batch(
+        const ResolvedPath& path,
+        const uint64_t (&input_amounts)[SEARCH_LANES],
+        uint64_t (&output_amounts)[SEARCH_LANES]
     ) noexcept;
-};
 
-// Token address hashes (lower 64 bits of keccak256 hash used for lookup)
-// These are placeholder hash values representing the actual token addresses
-inline constexpr uint64_t WETH_MAINNET = 0xC02aaA39b223FE8DULL;    // WETH on Ethereum
-inline constexpr uint64_t USDC_MAINNET = 0xA0b86991c6218b36ULL;    // USDC on Ethereum
-inline constexpr uint64_t USDT_MAINNET = 0xdAC17F958D2ee523ULL;    // USDT on Ethereum
+    [[nodiscard]] static uint64_t optimal_input(const ResolvedPath& path, uint64_t max_input) noexcept;
 
-inline constexpr uint64_t WETH_ARBITRUM = 0x82aF49447D8a07e3ULL;   // WETH on Arbitrum
-inline constexpr uint64_t USDC_ARBITRUM = 0xaf88d065e77c8cC2ULL;   // USDC on Arbitrum
+    /**
+     * Price base token amounts in native wei (identity for the native
+     * token itself)
+     * @return false if the book has no base/native pool to price them by
+     */
+    [[nodiscard]] bool to_native_wei(ChainId chain, uint64_t base_token,
+                                     std::span<uint64_t> amounts) const noexcept;
 
-inline constexpr uint64_t WETH_BASE = 0x4200000000000006ULL;       // WETH on Base
-inline constexpr uint64_t USDC_BASE = 0x833589fCD6eDb6E0ULL;       // USDC on Base
+    /**
+     * Size and price a cycle
+     * @return Opportunity, nullopt if no input amount is profitable
+     */
+    [[nodiscard]] std::optional<Opportunity> evaluate_cycle(const Cycle& cycle, uint64_t sequence) const noexcept;
+
+    /**
+     * Sort the kept opportunities and record scan statistics
+     */
+    void finish_scan(OpportunityBuffer& opportunities, uint64_t start_ticks) noexcept;
+
+    /**
+     * Depth-first search from partial.tokens[hop] for simple cycles back
+     * to partial.tokens[0] of 3 to MAX_HOPS hops, offering every
+     * profitable one (hops before `hop` are fixed)
+     */
+    void find_cycles(
+        Cycle& partial,
+        uint8_t hop,
+        OpportunityBuffer& opportunities,
+        uint64_t& sequence
+    ) const noexcept;
+
+    /**
+     * Offer a detected cycle once per base token on it, rotated to start
+     * there
+     * @return false if it cannot be routed
+     */
+    bool offer_detected(
+        const NegativeCycleDetector& detector,
+        size_t cycle,
+        OpportunityBuffer& opportunities
+    ) noexcept;
+};
 
 } // namespace matrix::arbitrage
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace matrix::arbitrage {
+
+/**
+ * Append-only compressed sparse row lists
+ *
+ * Row r's values are one contiguous run of values_, with slack behind it.
+ * Rows and values are only ever added: merge() appends a batch of
+ * (row, value) entries after each row's existing values, in batch order.
+ * An append lands in the row's slack; a full row moves to the end of
+ * values_ with twice the capacity, so a batch costs O(batch + new rows)
+ * amortized rather than a rebuild. Outgrown runs are reclaimed by a
+ * compaction (O(rows + values), leaving every row 50% slack) only when
+ * values_ would otherwise outgrow its reserved capacity. Reads are one
+ * row record load and a linear run.
+ */
+template<typename T>
+class CsrLists {
+public:
+    struct Entry {
+        uint32_t row;
+        T value;
+    };
+
+    /**
+     * Pre-size for the largest expected lists (no allocation below these;
+     * values get twice the room, for slack and outgrown runs)
+     */
+    void reserve(size_t max_rows, size_t max_values) {
+        rows_.reserve(max_rows);
+        scratch_rows_.reserve(max_rows);
+        values_.reserve(2 * max_values);
+        scratch_values_.reserve(2 * max_values);
+    }
+
+    [[nodiscard]] std::span<const T> row(uint32_t r) const noexcept {
+        if (r >= row_count()) return {};
+        return {values_.data() + rows_[r].first, rows_[r].size};
+    }
+
+    [[nodiscard]] size_t row_count() const noexcept { return rows_.size(); }
+    [[nodiscard]] size_t value_count() const noexcept { return value_count_; }
+
+    /**
+     * Append a batch of entries and grow to at least `rows` rows
+     * (every entry's row must be < max(rows, row_count()))
+     */
+    void merge(std::span<const Entry> batch, size_t rows) {
+        if (rows > rows_.size()) rows_.resize(rows, Row{0, 0, 0});
+        for (const auto& e : batch) append(e.row, e.value);
+    }
+
+private:
+    struct Row {
+        uint32_t first;
+        uint32_t size;
+        uint32_t capacity;
+    };
+
+    void append(uint32_t r, const T& value) {
+        if (rows_[r].size == rows_[r].capacity) {
+            const uint32_t capacity = std::max<uint32_t>(2, 2 * rows_[r].capacity);
+            if (values_.size() + capacity > values_.capacity() && outgrown_ > 0) {
+                compact();
+            }
+            if (rows_[r].size == rows_[r].capacity) relocate(r, capacity);
+        }
+        Row& row = rows_[r];
+        values_[row.first + row.size++] = value;
+        ++value_count_;
+    }
+
+    // Move a full row to a fresh run at the end; its old run is outgrown
+    void relocate(uint32_t r, uint32_t capacity) {
+        Row& row = rows_[r];
+        const auto first = static_cast<uint32_t>(values_.size());
+        values_.resize(values_.size() + capacity);
+        std::copy_n(values_.begin() + row.first, row.size, values_.begin() + first);
+        outgrown_ += row.capacity;
+        row.first = first;
+        row.capacity = capacity;
+    }
+
+    // Repack every row into scratch with 50% slack, then swap it in
+    void compact() {
+        size_t total = 0;
+        for (const Row& row : rows_) total += row.size + row.size / 2;
+        scratch_values_.resize(total);
+        scratch_rows_.resize(rows_.size());
+
+        uint32_t out = 0;
+        for (size_t r = 0; r < rows_.size(); ++r) {
+            const Row& row = rows_[r];
+            std::copy_n(values_.begin() + row.first, row.size, scratch_values_.begin() + out);
+            scratch_rows_[r] = {out, row.size, row.size + row.size / 2};
+            out += scratch_rows_[r].capacity;
+        }
+
+        rows_.swap(scratch_rows_);
+        values_.swap(scratch_values_);
+        outgrown_ = 0;
+    }
+
+    std::vector<Row> rows_;
+    std::vector<T> values_;                  // Runs, slack and outgrown runs
+    size_t value_count_ = 0;
+    size_t outgrown_ = 0;                    // values_ slots no row owns
+
+    // Compaction buffers, swapped with the live arrays
+    std::vector<Row> scratch_rows_;
+    std::vector<T> scratch_values_;
+};
+
+} // namespace matrix::arbitrage
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "../orderbook/OrderBook.hpp"
+#include "CsrLists.hpp"
+#include "TokenGraph.hpp"
+
+namespace matrix::arbitrage {
+
+/**
+ * Token a chain's cycles start and end at (what the flash loan borrows)
+ */
+struct BaseToken {
+    uint64_t token_hash;
+    orderbook::ChainId chain;
+};
+
+/**
+ * Closed swap path base -> ... -> base, one pool per hop
+ */
+struct Cycle {
+    static constexpr size_t MAX_HOPS = 4;
+
+    std::array<uint32_t, MAX_HOPS> pool_ids;       // Stable OrderBook pool ids
+    std::array<uint32_t, MAX_HOPS + 1> tokens;     // Dense token ids, tokens[length] == tokens[0]
+    uint8_t length;                                // 3 (triangular) or 4
+    orderbook::ChainId chain;
+};
+
+/**
+ * Cycle Index - every 3- and 4-hop cycle through a base token, plus the
+ * pool -> cycle membership lists used to re-evaluate only the cycles a
+ * batch of pool updates can have changed
+ *
+ * Like the token graph it is append-only and synced incrementally: a cycle
+ * is enumerated exactly once, when the newest of its pools is added (every
+ * other hop is restricted to older pools), so a sync only searches around
+ * the new pools. All pools of a cycle are on the base token's chain.
+ *
+ * Cycles are enumerated per pool, not per token pair, so parallel pools on
+ * one pair multiply the cycle count; enumeration stops at max_cycles and
+ * counts what it had to drop.
+ */
+class CycleIndex {
+public:
+    static constexpr size_t DEFAULT_MAX_CYCLES = 250'000;
+
+    explicit CycleIndex(
+        size_t max_pools = orderbook::OrderBook::MAX_POOLS,
+        size_t max_cycles = DEFAULT_MAX_CYCLES
+    );
+
+    /**
+     * Index cycles closed by pools the graph gained since the last sync
+     * @param graph Token graph, already synced with the book
+     * @return Number of cycles added
+     */
+    size_t sync(
+        const orderbook::OrderBook& book,
+        const TokenGraph& graph,
+        std::span<const BaseToken> bases
+    ) noexcept;
+
+    [[nodiscard]] const Cycle& cycle(uint32_t cycle_id) const noexcept { return cycles_[cycle_id]; }
+
+    /**
+     * Ids of the cycles that swap through a pool
+     */
+    [[nodiscard]] std::span<const uint32_t> cycles_of(uint32_t pool_id) const noexcept {
+        return membership_.row(pool_id);
+    }
+
+    [[nodiscard]] size_t cycle_count() const noexcept { return cycles_.size(); }
+    [[nodiscard]] size_t pools_seen() const noexcept { return pools_seen_; }
+    [[nodiscard]] uint64_t dropped_cycles() const noexcept { return dropped_cycles_; }
+
+private:
+    /**
+     * Enumerate the cycles of `length` hops from `base` in which `forced`
+     * is the newest pool (every other hop uses an older pool)
+     */
+    void find_cycles_through(
+        const orderbook::OrderBook& book,
+        const TokenGraph& graph,
+        uint32_t base,
+        orderbook::ChainId chain,
+        uint32_t from,
+        const Edge& forced,
+        uint8_t length
+    ) noexcept;
+
+    void extend(
+        const orderbook::OrderBook& book,
+        const TokenGraph& graph,
+        Cycle& partial,
+        uint8_t hop,
+        uint8_t forced_hop,
+        uint32_t from,
+        const Edge& forced
+    ) noexcept;
+
+    void record(const Cycle& cycle) noexcept;
+
+    std::vector<Cycle> cycles_;
+    CsrLists<uint32_t> membership_;          // Pool id -> cycle ids
+    std::vector<CsrLists<uint32_t>::Entry> pending_;
+
+    size_t max_cycles_;
+    size_t pools_seen_ = 0;
+    uint64_t dropped_cycles_ = 0;
+};
+
+} // namespace matrix::arbitrage
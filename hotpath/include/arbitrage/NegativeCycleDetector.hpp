@@ -0,0 +1,144 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "../orderbook/OrderBook.hpp"
+#include "TokenGraph.hpp"
+
+namespace matrix::arbitrage {
+
+/**
+ * One swap of a detected cycle
+ */
+struct CycleEdge {
+    uint32_t from;          // Dense token id sold
+    uint32_t to;            // Dense token id bought
+    uint32_t pool_id;       // Stable OrderBook pool id
+    bool zero_for_one;
+};
+
+/**
+ * Negative Cycle Detector - Bellman-Ford over one chain's log prices
+ *
+ * Every directed swap edge weighs -log(g * R_out / R_in), its marginal
+ * rate after fee, so a cycle whose rates multiply to more than 1 (an
+ * arbitrage) is a negative cycle, of any length.
+ *
+ * Edges are stored pull-style: each token's incoming edges are one
+ * contiguous run of SoA columns (source id, weight, pool, direction), so a
+ * pass computes min(dist[src] + w) per token with gathers (8 lanes with
+ * AVX-512, 4 with AVX2, scalar otherwise). Distances start at 0 for every
+ * token (a virtual source) and are updated in place. A pass that changes
+ * nothing ends the search - the graph holds no arbitrage - and otherwise
+ * the search stops after max_passes, so its cost is bounded per block.
+ * Cycles are then read off the predecessor edges: any cycle there is
+ * negative.
+ *
+ * Like any Bellman-Ford it proves some negative cycles, not all of them;
+ * disjoint arbitrages are found together, overlapping ones may hide each
+ * other until the better one is taken.
+ *
+ * The columns mirror the token graph and are only rebuilt when its
+ * topology changes; reweigh() refreshes the weights from the book.
+ */
+class NegativeCycleDetector {
+public:
+    static constexpr size_t DEFAULT_MAX_PASSES = 16;
+
+    explicit NegativeCycleDetector(orderbook::ChainId chain, size_t max_passes = DEFAULT_MAX_PASSES);
+
+    /**
+     * Rebuild the edge columns if the graph changed since the last call
+     * @return true if they were rebuilt
+     */
+    bool sync(const orderbook::OrderBook& book, const TokenGraph& graph);
+
+    /**
+     * Recompute every edge weight from the book's current reserves
+     * (pools without liquidity get infinite weight)
+     */
+    void reweigh(const orderbook::OrderBook& book) noexcept;
+
+    /**
+     * Run relaxation passes and extract the negative cycles they prove
+     * @return Number of cycles found
+     */
+    size_t detect() noexcept;
+
+    /**
+     * sync() + reweigh() + detect()
+     */
+    size_t detect(const orderbook::OrderBook& book, const TokenGraph& graph);
+
+    /**
+     * Cycles found by the last detect(), each starting at an arbitrary
+     * token (cycle(i)[0].from == cycle(i)[n - 1].to)
+     */
+    [[nodiscard]] size_t cycle_count() const noexcept { return cycle_offsets_.size() - 1; }
+    [[nodiscard]] std::span<const CycleEdge> cycle(size_t i) const noexcept {
+        return {cycle_edges_.data() + cycle_offsets_[i], cycle_edges_.data() + cycle_offsets_[i + 1]};
+    }
+
+    /**
+     * Sum of a found cycle's edge weights (negative: -log of its rate product)
+     */
+    [[nodiscard]] double cycle_weight(size_t i) const noexcept { return cycle_weights_[i]; }
+
+    [[nodiscard]] orderbook::ChainId chain() const noexcept { return chain_; }
+    [[nodiscard]] size_t node_count() const noexcept { return node_count_; }
+    [[nodiscard]] size_t edge_count() const noexcept { return src_.size(); }
+    [[nodiscard]] size_t max_passes() const noexcept { return max_passes_; }
+
+    /**
+     * Passes the last detect() ran (fewer than max_passes() if it converged)
+     */
+    [[nodiscard]] size_t last_passes() const noexcept { return last_passes_; }
+
+private:
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    // Minimum improvement a relaxation must make (absorbs rounding)
+    static constexpr double EPSILON = 1e-12;
+
+    /**
+     * One pass over every token's incoming edges
+     * @return Number of tokens whose distance improved
+     */
+    size_t relax_pass() noexcept;
+
+    void extract_cycles() noexcept;
+
+    orderbook::ChainId chain_;
+    size_t max_passes_;
+    uint64_t graph_version_ = UINT64_MAX;
+    size_t node_count_ = 0;
+
+    // Incoming edges of token v: [in_offsets_[v], in_offsets_[v + 1])
+    std::vector<uint32_t> in_offsets_;
+    std::vector<int32_t> src_;               // Gather indices into dist_
+    std::vector<double> weight_;
+    std::vector<uint32_t> pool_;
+    std::vector<uint8_t> zero_for_one_;
+
+    // Chain pools and the edge positions of both of their directions
+    std::vector<uint32_t> pools_;
+    std::vector<uint32_t> forward_edge_;     // token0 -> token1
+    std::vector<uint32_t> backward_edge_;    // token1 -> token0
+
+    // Relaxation state
+    std::vector<double> dist_;
+    std::vector<uint32_t> pred_;             // Edge that last improved a token
+    std::vector<uint32_t> walk_;             // Predecessor walk that reached a token
+
+    // Found cycles, flattened
+    std::vector<CycleEdge> cycle_edges_;
+    std::vector<uint32_t> cycle_offsets_{0};
+    std::vector<double> cycle_weights_;
+
+    size_t last_passes_ = 0;
+};
+
+} // namespace matrix::arbitrage
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "../orderbook/OrderBook.hpp"
+#include "CsrLists.hpp"
+
+namespace matrix::arbitrage {
+
+/**
+ * Directed swap edge - selling the source token into one pool
+ */
+struct Edge {
+    uint32_t to;            // Dense token id bought
+    uint32_t pool_id;       // Stable OrderBook pool id
+    bool zero_for_one;      // True if this sells the pool's token0
+};
+
+/**
+ * Token Graph - compressed sparse row adjacency over the order book
+ *
+ * Nodes are the order book's dense token ids; every pool contributes one
+ * edge in each direction. A token's edges are one contiguous run, in pool
+ * creation order.
+ *
+ * The graph only mirrors topology. Reserves are read from the order book
+ * when edges are evaluated, so reserve-only updates never touch it. New
+ * pools are picked up by sync(), which appends their edges into per-token
+ * slack in O(new edges) amortized, within pre-reserved buffers - no
+ * allocation after construction.
+ */
+class TokenGraph {
+public:
+    explicit TokenGraph(
+        size_t max_tokens = orderbook::OrderBook::MAX_TOKENS,
+        size_t max_pools = orderbook::OrderBook::MAX_POOLS
+    );
+
+    /**
+     * Merge pools created since the last sync
+     * @return Number of pools added (0 means the topology is unchanged)
+     */
+    size_t sync(const orderbook::OrderBook& book) noexcept;
+
+    /**
+     * Outgoing edges of a token (empty for unknown ids)
+     */
+    [[nodiscard]] std::span<const Edge> edges(uint32_t token) const noexcept {
+        return adjacency_.row(token);
+    }
+
+    [[nodiscard]] size_t node_count() const noexcept { return adjacency_.row_count(); }
+    [[nodiscard]] size_t edge_count() const noexcept { return adjacency_.value_count(); }
+    [[nodiscard]] size_t pools_seen() const noexcept { return pools_seen_; }
+
+    /** Incremented on every sync that changes the topology */
+    [[nodiscard]] uint64_t version() const noexcept { return version_; }
+
+private:
+    CsrLists<Edge> adjacency_;               // Token id -> outgoing edges
+    std::vector<CsrLists<Edge>::Entry> pending_;
+
+    size_t pools_seen_ = 0;                  // Cursor into OrderBook pool ids
+    uint64_t version_ = 0;
+};
+
+} // namespace matrix::arbitrage
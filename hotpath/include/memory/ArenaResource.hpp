@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+#include <new>
+
+#include "Arena.hpp"
+
+namespace matrix::memory {
+
+/**
+ * Arena Resource - std::pmr::memory_resource over an Arena or ThreadArena
+ *
+ * Lets std::pmr containers (vector, string, unordered_map, ...) take their
+ * storage from an arena: allocation is a bump, deallocation is a no-op and
+ * memory comes back with the arena's reset() or an ArenaScope. Reserve up
+ * front; a growing container leaves its old buffers behind in the arena.
+ *
+ * Throws std::bad_alloc when the arena is exhausted (the memory_resource
+ * contract), rather than falling back to the heap.
+ */
+template<typename ArenaT>
+class ArenaResource final : public std::pmr::memory_resource {
+public:
+    explicit ArenaResource(ArenaT& arena) noexcept : arena_(arena) {}
+
+    ArenaResource(const ArenaResource&) = delete;
+    ArenaResource& operator=(const ArenaResource&) = delete;
+
+    [[nodiscard]] ArenaT& arena() const noexcept { return arena_; }
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        void* ptr = arena_.allocate(bytes, alignment);
+        if (!ptr) throw std::bad_alloc();
+        return ptr;
+    }
+
+    void do_deallocate(void*, size_t, size_t) noexcept override {}
+
+    [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+    ArenaT& arena_;
+};
+
+template<typename ArenaT>
+ArenaResource(ArenaT&) -> ArenaResource<ArenaT>;
+
+} // namespace matrix::memory
@@ -0,0 +1,267 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+
+#include "Arena.hpp"
+
+namespace matrix::memory {
+
+/**
+ * Concurrent Object Pool - ObjectPool for objects that change threads
+ *
+ * Free slots sit on a lock-free (Treiber) stack. Its head packs the slot
+ * pointer with a 16-bit version tag (user-space pointers fit in 48 bits),
+ * so a pop racing another thread's pop + push of the same slot fails its
+ * CAS instead of linking a slot that is in use.
+ *
+ * Threads that acquire or release in bursts go through a Cache: a private
+ * magazine that refills from and spills to the shared stack half a
+ * magazine at a time, so most calls touch no shared cache line. An
+ * opportunity acquired on a scan thread and released on the submit thread
+ * migrates between the two threads' caches through the stack.
+ *
+ * Built over an Arena, the pool grows on demand in slabs up to a maximum;
+ * slabs are returned with the arena. Destructors of objects still out when
+ * the pool dies are not run.
+ */
+template<typename T>
+class ConcurrentObjectPool {
+    union Slot {
+        alignas(T) uint8_t data[sizeof(T)];
+        Slot* next;
+    };
+
+public:
+    static constexpr size_t MAGAZINE = 32;
+    static constexpr size_t CACHE_LINE_SIZE = Arena::CACHE_LINE_SIZE;
+
+    class Cache;
+
+    /**
+     * Fixed capacity, heap storage allocated up front
+     */
+    explicit ConcurrentObjectPool(size_t capacity)
+        : owned_(std::make_unique<Slot[]>(capacity))
+        , max_capacity_(capacity) {
+        if (capacity == 0) return;
+        link(owned_.get(), capacity);
+        push_chain(&owned_[0], &owned_[capacity - 1], capacity);
+        capacity_.store(capacity, std::memory_order_relaxed);
+    }
+
+    /**
+     * Grow from `arena` in slabs of `slab` objects, up to `max_capacity`
+     * (the first slab is taken now)
+     * @throws std::bad_alloc if the arena cannot supply the first slab
+     */
+    ConcurrentObjectPool(Arena& arena, size_t slab, size_t max_capacity)
+        : arena_(&arena)
+        , slab_(slab)
+        , max_capacity_(max_capacity) {
+        Slot* slot = grow();
+        if (!slot) throw std::bad_alloc();
+        push_chain(slot, slot, 1);
+    }
+
+    ConcurrentObjectPool(const ConcurrentObjectPool&) = delete;
+    ConcurrentObjectPool& operator=(const ConcurrentObjectPool&) = delete;
+
+    /**
+     * Acquire straight from the shared stack (any thread)
+     * @return nullptr if the pool is exhausted and cannot grow
+     */
+    template<typename... Args>
+    [[nodiscard]] T* acquire(Args&&... args) noexcept {
+        Slot* slot = pop();
+        if (slot) {
+            free_.fetch_sub(1, std::memory_order_relaxed);
+        } else if (!(slot = grow())) {
+            return nullptr;
+        }
+        note_usage();
+        return new(slot->data) T(std::forward<Args>(args)...);
+    }
+
+    /**
+     * Release to the shared stack (any thread, not only the acquirer's)
+     */
+    void release(T* obj) noexcept {
+        if (!obj) return;
+        obj->~T();
+        Slot* slot = reinterpret_cast<Slot*>(obj);
+        push_chain(slot, slot, 1);
+    }
+
+    /**
+     * O(1) monitoring counters (relaxed). Objects parked in a Cache count
+     * as in use; high_water() is sampled when slots leave the shared stack.
+     */
+    [[nodiscard]] size_t available() const noexcept { return free_.load(std::memory_order_relaxed); }
+    [[nodiscard]] size_t capacity() const noexcept { return capacity_.load(std::memory_order_relaxed); }
+    [[nodiscard]] size_t max_capacity() const noexcept { return max_capacity_; }
+    [[nodiscard]] size_t in_use() const noexcept {
+        const size_t cap = capacity();
+        const size_t free = available();
+        return free < cap ? cap - free : 0;
+    }
+    [[nodiscard]] size_t high_water() const noexcept { return high_water_.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr uint64_t POINTER_MASK = (uint64_t{1} << 48) - 1;
+    static constexpr uint64_t TAG_ONE = uint64_t{1} << 48;
+    static_assert(sizeof(void*) == 8, "tagged head needs 64-bit pointers");
+
+    static Slot* pointer_of(uint64_t head) noexcept {
+        return reinterpret_cast<Slot*>(static_cast<uintptr_t>(head & POINTER_MASK));
+    }
+    static uint64_t next_head(uint64_t head, Slot* slot) noexcept {
+        return ((head & ~POINTER_MASK) + TAG_ONE) | reinterpret_cast<uintptr_t>(slot);
+    }
+
+    static void link(Slot* slots, size_t count) noexcept {
+        for (size_t i = 0; i + 1 < count; ++i) slots[i].next = &slots[i + 1];
+    }
+
+    // Push first..last (already linked through next); counted before the
+    // CAS so that a racing pop never drives free_ below zero
+    void push_chain(Slot* first, Slot* last, size_t count) noexcept {
+        free_.fetch_add(count, std::memory_order_relaxed);
+        uint64_t head = head_.load(std::memory_order_relaxed);
+        do {
+            std::atomic_ref<Slot*>(last->next).store(pointer_of(head), std::memory_order_relaxed);
+        } while (!head_.compare_exchange_weak(head, next_head(head, first),
+                                              std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    // Caller adjusts free_. slot->next may be read after another thread
+    // took the slot; the tag makes that CAS fail.
+    Slot* pop() noexcept {
+        uint64_t head = head_.load(std::memory_order_acquire);
+        while (true) {
+            Slot* slot = pointer_of(head);
+            if (!slot) return nullptr;
+            Slot* next = std::atomic_ref<Slot*>(slot->next).load(std::memory_order_relaxed);
+            if (head_.compare_exchange_weak(head, next_head(head, next),
+                                            std::memory_order_acquire, std::memory_order_acquire)) {
+                return slot;
+            }
+        }
+    }
+
+    // Reserve and carve a slab; keeps the first slot, pushes the rest
+    Slot* grow() noexcept {
+        if (!arena_) return nullptr;
+        size_t cap = capacity_.load(std::memory_order_relaxed);
+        do {
+            if (slab_ == 0 || cap + slab_ > max_capacity_) return nullptr;
+        } while (!capacity_.compare_exchange_weak(cap, cap + slab_, std::memory_order_relaxed));
+
+        auto* slots = static_cast<Slot*>(arena_->allocate(sizeof(Slot) * slab_, alignof(Slot)));
+        if (!slots) {
+            capacity_.fetch_sub(slab_, std::memory_order_relaxed);
+            return nullptr;
+        }
+        if (slab_ > 1) {
+            link(slots + 1, slab_ - 1);
+            push_chain(&slots[1], &slots[slab_ - 1], slab_ - 1);
+        }
+        return &slots[0];
+    }
+
+    void note_usage() noexcept {
+        const size_t used = in_use();
+        size_t peak = high_water_.load(std::memory_order_relaxed);
+        while (used > peak && !high_water_.compare_exchange_weak(peak, used, std::memory_order_relaxed)) {}
+    }
+
+    std::unique_ptr<Slot[]> owned_;
+    Arena* arena_ = nullptr;
+    size_t slab_ = 0;
+    size_t max_capacity_;
+
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> head_{0};
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> free_{0};
+    std::atomic<size_t> capacity_{0};
+    std::atomic<size_t> high_water_{0};
+};
+
+/**
+ * Per-thread magazine over a ConcurrentObjectPool
+ *
+ * Not thread-safe; one per thread. Objects may be released through any
+ * thread's cache (or the pool). Must be destroyed before the pool; the
+ * destructor returns the cached slots.
+ */
+template<typename T>
+class ConcurrentObjectPool<T>::Cache {
+public:
+    explicit Cache(ConcurrentObjectPool& pool) noexcept : pool_(pool) {}
+    ~Cache() { flush(); }
+
+    Cache(const Cache&) = delete;
+    Cache& operator=(const Cache&) = delete;
+
+    /**
+     * @return nullptr if the pool is exhausted and cannot grow
+     */
+    template<typename... Args>
+    [[nodiscard]] T* acquire(Args&&... args) noexcept {
+        if (count_ == 0 && !refill()) return nullptr;
+        Slot* slot = slots_[--count_];
+        return new(slot->data) T(std::forward<Args>(args)...);
+    }
+
+    void release(T* obj) noexcept {
+        if (!obj) return;
+        obj->~T();
+        if (count_ == MAGAZINE) spill(MAGAZINE / 2);
+        slots_[count_++] = reinterpret_cast<Slot*>(obj);
+    }
+
+    /**
+     * Return every cached slot to the pool
+     */
+    void flush() noexcept { spill(count_); }
+
+    [[nodiscard]] size_t cached() const noexcept { return count_; }
+
+private:
+    bool refill() noexcept {
+        size_t popped = 0;
+        while (count_ < MAGAZINE / 2) {
+            Slot* slot = pool_.pop();
+            if (slot) {
+                ++popped;
+            } else if (!(slot = pool_.grow())) {
+                break;
+            }
+            slots_[count_++] = slot;
+        }
+        pool_.free_.fetch_sub(popped, std::memory_order_relaxed);
+        pool_.note_usage();
+        return count_ != 0;
+    }
+
+    // Hand the top n cached slots back as one chain (one CAS)
+    void spill(size_t n) noexcept {
+        if (n == 0) return;
+        Slot** top = slots_.data() + count_ - n;
+        for (size_t i = 0; i + 1 < n; ++i) {
+            std::atomic_ref<Slot*>(top[i]->next).store(top[i + 1], std::memory_order_relaxed);
+        }
+        pool_.push_chain(top[0], top[n - 1], n);
+        count_ -= n;
+    }
+
+    ConcurrentObjectPool& pool_;
+    size_t count_ = 0;
+    std::array<Slot*, MAGAZINE> slots_;
+};
+
+} // namespace matrix::memory
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#include "../memory/Arena.hpp"
+#include "../orderbook/FlatHashMap.hpp"
+#include "../orderbook/OrderBook.hpp"
+
+namespace matrix::network {
+
+/**
+ * 64-bit pool/token id from a 20-byte address (all bytes folded, so
+ * vanity addresses with long zero prefixes do not collide)
+ */
+[[nodiscard]] inline uint64_t address_hash(const uint8_t (&address)[20]) noexcept {
+    uint64_t w0, w1;
+    uint32_t w2;
+    std::memcpy(&w0, address, 8);
+    std::memcpy(&w1, address + 8, 8);
+    std::memcpy(&w2, address + 16, 4);
+    return orderbook::mix64(w0 ^ orderbook::mix64(w1 ^ w2));
+}
+
+/**
+ * Parse "0x" + 40 hex digits
+ * @return false if `hex` is not an address
+ */
+[[nodiscard]] bool parse_address(std::string_view hex, uint8_t (&out)[20]) noexcept;
+
+/**
+ * Event a watched pool's state arrives in
+ */
+enum class PoolEvent : uint8_t {
+    V2_SYNC,        // Sync(uint112 reserve0, uint112 reserve1)
+    V3_SWAP         // Swap(..., uint160 sqrtPriceX96, uint128 liquidity, int24 tick)
+};
+
+/**
+ * Static facts about a watched pool (the log itself only carries reserves)
+ */
+struct PoolInfo {
+    uint64_t token0;
+    uint64_t token1;
+    orderbook::DexId dex;
+    PoolEvent event;
+    uint64_t scale0 = 1;        // Raw reserve / scale -> PriceUpdate units
+    uint64_t scale1 = 1;
+};
+
+enum class DecodeStatus : uint8_t {
+    DECODED,
+    NOT_A_LOG,          // Subscription ack, other RPC traffic
+    IGNORED,            // Other event, or a log removed by a reorg
+    UNKNOWN_POOL,
+    OUT_OF_RANGE,       // Scaled reserve does not fit 64 bits
+    MALFORMED
+};
+
+struct DecodeStats {
+    uint64_t messages = 0;
+    uint64_t decoded = 0;
+    uint64_t not_a_log = 0;
+    uint64_t ignored = 0;
+    uint64_t unknown_pool = 0;
+    uint64_t out_of_range = 0;
+    uint64_t malformed = 0;
+    uint64_t queue_full = 0;
+};
+
+/**
+ * Feed Decoder - eth_subscribe("logs") notifications -> PriceUpdate
+ *
+ * No DOM: a SIMD pass indexes the quotes of the payload, then only the
+ * "address", "topics", "data" and "removed" members are looked at and the
+ * data words are hex-decoded straight into the update. Nothing allocates
+ * after construction.
+ *
+ * V3 pools are reported as their in-range virtual reserves
+ * (L / sqrtP, L * sqrtP), matching how the order book quotes them.
+ *
+ * One decoder per chain connection; not thread-safe.
+ */
+class FeedDecoder {
+public:
+    // Largest log notification accepted (quotes in the payload)
+    static constexpr size_t MAX_QUOTES = 256;
+
+    /**
+     * @throws std::bad_alloc if the arena cannot hold the pool registry
+     */
+    FeedDecoder(orderbook::ChainId chain, memory::Arena& arena, size_t max_pools);
+
+    /**
+     * Watch a pool by address
+     * @return false if the address is malformed or the registry is full
+     */
+    bool add_pool(std::string_view pool_address, const PoolInfo& info) noexcept;
+
+    /**
+     * Decode one WebSocket message
+     * @param timestamp_ns Stamped into the update (receive time)
+     */
+    [[nodiscard]] DecodeStatus decode(std::string_view message, uint64_t timestamp_ns,
+                                      orderbook::PriceUpdate& out) noexcept;
+
+    /**
+     * Decode and push into a price queue (PriceQueue, or a PriceFeedQueue
+     * producer handle)
+     * @return true if an update was pushed
+     */
+    template<typename Queue>
+    bool decode_into(std::string_view message, uint64_t timestamp_ns, Queue& queue) noexcept {
+        orderbook::PriceUpdate update;
+        if (decode(message, timestamp_ns, update) != DecodeStatus::DECODED) return false;
+        if (!queue.push(update)) {
+            ++stats_.queue_full;
+            return false;
+        }
+        return true;
+    }
+
+    [[nodiscard]] const DecodeStats& stats() const noexcept { return stats_; }
+    [[nodiscard]] size_t pool_count() const noexcept { return pools_.size(); }
+
+private:
+    DecodeStatus decode_log(std::string_view message, uint64_t timestamp_ns,
+                            orderbook::PriceUpdate& out) noexcept;
+
+    orderbook::ChainId chain_;
+    orderbook::FlatHashMap<uint64_t, PoolInfo, orderbook::U64Hash> pools_;
+    DecodeStats stats_;
+    uint32_t quotes_[MAX_QUOTES];
+};
+
+} // namespace matrix::network
@@ -0,0 +1,296 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <span>
+
+namespace matrix::network::ws {
+
+/**
+ * WebSocket frame opcodes (RFC 6455 section 5.2)
+ */
+enum class Opcode : uint8_t {
+    CONTINUATION = 0x0,
+    TEXT = 0x1,
+    BINARY = 0x2,
+    CLOSE = 0x8,
+    PING = 0x9,
+    PONG = 0xA
+};
+
+[[nodiscard]] constexpr bool is_control(Opcode op) noexcept {
+    return (static_cast<uint8_t>(op) & 0x8) != 0;
+}
+
+// Largest header: 2 bytes + 8-byte extended length + 4-byte mask
+inline constexpr size_t MAX_HEADER_BYTES = 14;
+
+struct FrameHeader {
+    bool fin;
+    Opcode opcode;
+    bool masked;
+    uint8_t mask[4];
+    uint64_t payload_len;
+    size_t header_len;
+};
+
+enum class ParseStatus : uint8_t {
+    NEED_MORE,          // Header incomplete
+    OK,
+    PROTOCOL_ERROR      // Reserved bits/opcode, bad control frame, bad length
+};
+
+/**
+ * Decode a frame header from the first `len` bytes of `data`
+ */
+[[nodiscard]] inline ParseStatus parse_header(const uint8_t* data, size_t len, FrameHeader& out) noexcept {
+    if (len < 2) return ParseStatus::NEED_MORE;
+
+    const uint8_t b0 = data[0];
+    const uint8_t b1 = data[1];
+    if (b0 & 0x70) return ParseStatus::PROTOCOL_ERROR;  // RSV1-3: no extensions negotiated
+
+    out.fin = (b0 & 0x80) != 0;
+    out.opcode = static_cast<Opcode>(b0 & 0x0F);
+    out.masked = (b1 & 0x80) != 0;
+
+    switch (out.opcode) {
+        case Opcode::CONTINUATION: case Opcode::TEXT: case Opcode::BINARY:
+        case Opcode::CLOSE: case Opcode::PING: case Opcode::PONG:
+            break;
+        default:
+            return ParseStatus::PROTOCOL_ERROR;
+    }
+
+    size_t pos = 2;
+    uint64_t payload_len = b1 & 0x7F;
+    if (payload_len == 126) {
+        if (len < pos + 2) return ParseStatus::NEED_MORE;
+        payload_len = (static_cast<uint64_t>(data[2]) << 8) | data[3];
+        pos += 2;
+    } else if (payload_len == 127) {
+        if (len < pos + 8) return ParseStatus::NEED_MORE;
+        payload_len = 0;
+        for (size_t i = 0; i < 8; ++i) payload_len = (payload_len << 8) | data[2 + i];
+        if (payload_len >> 63) return ParseStatus::PROTOCOL_ERROR;
+        pos += 8;
+    }
+
+    if (is_control(out.opcode) && (!out.fin || payload_len > 125)) {
+        return ParseStatus::PROTOCOL_ERROR;
+    }
+
+    if (out.masked) {
+        if (len < pos + 4) return ParseStatus::NEED_MORE;
+        std::memcpy(out.mask, data + pos, 4);
+        pos += 4;
+    }
+
+    out.payload_len = payload_len;
+    out.header_len = pos;
+    return ParseStatus::OK;
+}
+
+/**
+ * XOR `len` bytes with the 4-byte mask in place, eight bytes per step
+ */
+inline void unmask(uint8_t* payload, size_t len, const uint8_t (&mask)[4]) noexcept {
+    uint32_t m32;
+    std::memcpy(&m32, mask, 4);
+    const uint64_t m64 = (static_cast<uint64_t>(m32) << 32) | m32;
+
+    size_t i = 0;
+    for (; i + 8 <= len; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, payload + i, 8);
+        word ^= m64;
+        std::memcpy(payload + i, &word, 8);
+    }
+    for (; i < len; ++i) {
+        payload[i] ^= mask[i & 3];
+    }
+}
+
+/**
+ * Encode a final frame header; `mask` is required for client frames
+ * @return Header length (<= MAX_HEADER_BYTES)
+ */
+inline size_t encode_header(uint8_t* out, Opcode opcode, uint64_t payload_len, const uint8_t* mask) noexcept {
+    size_t pos = 0;
+    out[pos++] = static_cast<uint8_t>(0x80 | static_cast<uint8_t>(opcode));
+    const uint8_t mask_bit = mask ? 0x80 : 0x00;
+
+    if (payload_len < 126) {
+        out[pos++] = static_cast<uint8_t>(mask_bit | payload_len);
+    } else if (payload_len <= 0xFFFF) {
+        out[pos++] = static_cast<uint8_t>(mask_bit | 126);
+        out[pos++] = static_cast<uint8_t>(payload_len >> 8);
+        out[pos++] = static_cast<uint8_t>(payload_len);
+    } else {
+        out[pos++] = static_cast<uint8_t>(mask_bit | 127);
+        for (int shift = 56; shift >= 0; shift -= 8) {
+            out[pos++] = static_cast<uint8_t>(payload_len >> shift);
+        }
+    }
+
+    if (mask) {
+        std::memcpy(out + pos, mask, 4);
+        pos += 4;
+    }
+    return pos;
+}
+
+/**
+ * Receive Buffer - socket bytes land here and frames are parsed in place
+ *
+ * The socket reads straight into writable(); process() walks the complete
+ * frames, unmasks them where they lie and hands each message out as a span
+ * into the buffer. Fragmented messages are made contiguous by sliding every
+ * continuation payload down behind the previous one, so a message is always
+ * one span no matter how it was framed. Spans are valid until the callback
+ * returns.
+ *
+ * Consumed bytes are reclaimed by resetting to the start when everything
+ * is consumed, or by moving the (small) unparsed tail down once free space
+ * runs low; a message larger than the buffer is a protocol error.
+ */
+class RxBuffer {
+public:
+    enum class Status : uint8_t {
+        OK,
+        PROTOCOL_ERROR,
+        MESSAGE_TOO_BIG
+    };
+
+    explicit RxBuffer(size_t capacity)
+        : data_(std::make_unique<uint8_t[]>(capacity))
+        , capacity_(capacity) {}
+
+    /**
+     * Free space the next read may fill
+     */
+    [[nodiscard]] std::span<uint8_t> writable() noexcept {
+        return {data_.get() + end_, capacity_ - end_};
+    }
+
+    /**
+     * Account for `n` bytes read into writable()
+     */
+    void commit(size_t n) noexcept { end_ += n; }
+
+    /**
+     * Append bytes (handshake leftovers)
+     * @return false if they do not fit
+     */
+    bool append(const uint8_t* bytes, size_t n) noexcept {
+        if (n > capacity_ - end_) return false;
+        std::memcpy(data_.get() + end_, bytes, n);
+        end_ += n;
+        return true;
+    }
+
+    /**
+     * Parse every complete frame
+     * @param on_message fn(Opcode, std::span<const uint8_t>) for each data
+     *        message (TEXT/BINARY) and each control frame
+     */
+    template<typename F>
+    Status process(F&& on_message) {
+        while (true) {
+            FrameHeader h;
+            const size_t avail = end_ - parse_pos_;
+            const ParseStatus ps = parse_header(data_.get() + parse_pos_, avail, h);
+            if (ps == ParseStatus::PROTOCOL_ERROR) return Status::PROTOCOL_ERROR;
+            if (ps == ParseStatus::NEED_MORE) {
+                pending_ = MAX_HEADER_BYTES;
+                break;
+            }
+
+            const uint64_t total = h.header_len + h.payload_len;
+            if (total > capacity_ || (in_message_ && msg_len_ + total > capacity_)) {
+                return Status::MESSAGE_TOO_BIG;
+            }
+            if (avail < total) {
+                pending_ = static_cast<size_t>(total);
+                break;
+            }
+
+            uint8_t* payload = data_.get() + parse_pos_ + h.header_len;
+            const auto len = static_cast<size_t>(h.payload_len);
+            if (h.masked) unmask(payload, len, h.mask);
+
+            if (is_control(h.opcode)) {
+                // May arrive between the fragments of a message
+                on_message(h.opcode, std::span<const uint8_t>(payload, len));
+            } else if (h.opcode != Opcode::CONTINUATION) {
+                if (in_message_) return Status::PROTOCOL_ERROR;
+                if (h.fin) {
+                    on_message(h.opcode, std::span<const uint8_t>(payload, len));
+                } else {
+                    in_message_ = true;
+                    msg_opcode_ = h.opcode;
+                    msg_start_ = static_cast<size_t>(payload - data_.get());
+                    msg_len_ = len;
+                }
+            } else {
+                if (!in_message_) return Status::PROTOCOL_ERROR;
+                // Slide the fragment down behind the assembled part
+                uint8_t* dest = data_.get() + msg_start_ + msg_len_;
+                if (dest != payload) std::memmove(dest, payload, len);
+                msg_len_ += len;
+                if (h.fin) {
+                    in_message_ = false;
+                    on_message(msg_opcode_, std::span<const uint8_t>(data_.get() + msg_start_, msg_len_));
+                }
+            }
+            parse_pos_ += static_cast<size_t>(total);
+        }
+
+        reclaim();
+        return Status::OK;
+    }
+
+    [[nodiscard]] size_t capacity() const noexcept { return capacity_; }
+    [[nodiscard]] size_t buffered() const noexcept { return end_ - parse_pos_; }
+
+    void reset() noexcept {
+        end_ = parse_pos_ = msg_start_ = msg_len_ = pending_ = 0;
+        in_message_ = false;
+    }
+
+private:
+    void reclaim() noexcept {
+        const size_t kept = in_message_ ? msg_len_ : 0;   // Assembled fragments
+        const size_t tail = end_ - parse_pos_;            // Unparsed bytes
+        if (kept == 0 && tail == 0) {
+            end_ = parse_pos_ = msg_start_ = 0;
+            return;
+        }
+        // Compact only when free space runs low or the pending frame
+        // cannot complete where it starts
+        const bool low = capacity_ - end_ < capacity_ / 4;
+        if (!low && parse_pos_ + pending_ <= capacity_) return;
+        if (kept + tail == end_) return;                  // Nothing to reclaim
+
+        // Move the assembled part to the front, the unparsed tail right behind
+        if (kept != 0) std::memmove(data_.get(), data_.get() + msg_start_, kept);
+        std::memmove(data_.get() + kept, data_.get() + parse_pos_, tail);
+        msg_start_ = 0;
+        parse_pos_ = kept;
+        end_ = kept + tail;
+    }
+
+    std::unique_ptr<uint8_t[]> data_;
+    size_t capacity_;
+    size_t end_ = 0;            // Bytes received
+    size_t parse_pos_ = 0;      // Start of the first unparsed frame
+    bool in_message_ = false;   // Between the first and final fragment
+    Opcode msg_opcode_ = Opcode::TEXT;
+    size_t msg_start_ = 0;      // Assembled fragment payload [start, start + len)
+    size_t msg_len_ = 0;
+    size_t pending_ = 0;        // Bytes the first unparsed frame needs
+};
+
+} // namespace matrix::network::ws
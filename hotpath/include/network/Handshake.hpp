@@ -0,0 +1,94 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+namespace matrix::network::ws {
+
+/**
+ * SHA-1 digest (only used for the Sec-WebSocket-Accept check, never for
+ * anything security relevant)
+ */
+[[nodiscard]] inline std::array<uint8_t, 20> sha1(std::string_view input) noexcept {
+    uint32_t h[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+    const auto rol = [](uint32_t v, int n) { return (v << n) | (v >> (32 - n)); };
+
+    const uint64_t bit_len = static_cast<uint64_t>(input.size()) * 8;
+    const size_t padded = ((input.size() + 8) / 64 + 1) * 64;
+
+    for (size_t block = 0; block < padded; block += 64) {
+        uint8_t chunk[64];
+        for (size_t i = 0; i < 64; ++i) {
+            const size_t pos = block + i;
+            if (pos < input.size()) {
+                chunk[i] = static_cast<uint8_t>(input[pos]);
+            } else if (pos == input.size()) {
+                chunk[i] = 0x80;
+            } else if (pos >= padded - 8) {
+                chunk[i] = static_cast<uint8_t>(bit_len >> (8 * (padded - 1 - pos)));
+            } else {
+                chunk[i] = 0;
+            }
+        }
+
+        uint32_t w[80];
+        for (int i = 0; i < 16; ++i) {
+            w[i] = (static_cast<uint32_t>(chunk[4 * i]) << 24) | (static_cast<uint32_t>(chunk[4 * i + 1]) << 16) |
+                   (static_cast<uint32_t>(chunk[4 * i + 2]) << 8) | chunk[4 * i + 3];
+        }
+        for (int i = 16; i < 80; ++i) w[i] = rol(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+
+        uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+        for (int i = 0; i < 80; ++i) {
+            uint32_t f, k;
+            if (i < 20)      { f = (b & c) | (~b & d);          k = 0x5A827999; }
+            else if (i < 40) { f = b ^ c ^ d;                   k = 0x6ED9EBA1; }
+            else if (i < 60) { f = (b & c) | (b & d) | (c & d); k = 0x8F1BBCDC; }
+            else             { f = b ^ c ^ d;                   k = 0xCA62C1D6; }
+            const uint32_t t = rol(a, 5) + f + e + k + w[i];
+            e = d; d = c; c = rol(b, 30); b = a; a = t;
+        }
+        h[0] += a; h[1] += b; h[2] += c; h[3] += d; h[4] += e;
+    }
+
+    std::array<uint8_t, 20> digest;
+    for (int i = 0; i < 5; ++i) {
+        digest[4 * i] = static_cast<uint8_t>(h[i] >> 24);
+        digest[4 * i + 1] = static_cast<uint8_t>(h[i] >> 16);
+        digest[4 * i + 2] = static_cast<uint8_t>(h[i] >> 8);
+        digest[4 * i + 3] = static_cast<uint8_t>(h[i]);
+    }
+    return digest;
+}
+
+[[nodiscard]] inline std::string base64(const uint8_t* data, size_t len) {
+    static constexpr char ALPHABET[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string out;
+    out.reserve((len + 2) / 3 * 4);
+    for (size_t i = 0; i < len; i += 3) {
+        const uint32_t n = (static_cast<uint32_t>(data[i]) << 16) |
+                           (i + 1 < len ? static_cast<uint32_t>(data[i + 1]) << 8 : 0) |
+                           (i + 2 < len ? data[i + 2] : 0);
+        out += ALPHABET[(n >> 18) & 63];
+        out += ALPHABET[(n >> 12) & 63];
+        out += i + 1 < len ? ALPHABET[(n >> 6) & 63] : '=';
+        out += i + 2 < len ? ALPHABET[n & 63] : '=';
+    }
+    return out;
+}
+
+/**
+ * Sec-WebSocket-Accept value the server must answer `client_key` with
+ */
+[[nodiscard]] inline std::string accept_key(std::string_view client_key) {
+    std::string material(client_key);
+    material += "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+    const auto digest = sha1(material);
+    return base64(digest.data(), digest.size());
+}
+
+} // namespace matrix::network::ws
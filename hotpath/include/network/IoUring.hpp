@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <linux/io_uring.h>
+
+namespace matrix::network {
+
+/**
+ * IoUring - minimal io_uring ring over the raw syscalls
+ *
+ * Just what the feed sockets need: one SQ/CQ pair, fetch/submit SQEs,
+ * submit-and-wait with a timeout in a single io_uring_enter, reap CQEs and
+ * register the socket as a fixed file. Owned and driven by one thread.
+ *
+ * Requires IORING_FEAT_EXT_ARG (Linux 5.11+) for the timed wait.
+ */
+class IoUring {
+public:
+    /**
+     * @throws std::system_error if the kernel refuses the ring or lacks
+     *         the features above (callers fall back to epoll)
+     */
+    explicit IoUring(unsigned entries = 8);
+    ~IoUring();
+
+    IoUring(const IoUring&) = delete;
+    IoUring& operator=(const IoUring&) = delete;
+
+    /**
+     * Next free SQE (zeroed), nullptr if the SQ is full
+     */
+    [[nodiscard]] io_uring_sqe* get_sqe() noexcept;
+
+    /**
+     * Submit queued SQEs and wait up to timeout_ms for one completion
+     * @return Number submitted, -ETIME on timeout, or -errno
+     */
+    int submit_and_wait(int timeout_ms) noexcept;
+
+    /**
+     * Oldest unreaped completion, nullptr if none
+     */
+    [[nodiscard]] io_uring_cqe* peek_cqe() noexcept;
+
+    /**
+     * Release the completion returned by peek_cqe()
+     */
+    void cqe_seen() noexcept;
+
+    /**
+     * Register `count` fds as fixed files (index i -> fds[i])
+     * @return 0 or -errno
+     */
+    int register_files(const int* fds, unsigned count) noexcept;
+    int unregister_files() noexcept;
+
+private:
+    int ring_fd_ = -1;
+    unsigned entries_ = 0;
+
+    // Submission queue
+    unsigned* sq_head_ = nullptr;
+    unsigned* sq_tail_ = nullptr;
+    unsigned sq_mask_ = 0;
+    io_uring_sqe* sqes_ = nullptr;
+    unsigned sqe_tail_ = 0;         // Local tail, published by submit
+    unsigned sqe_submitted_ = 0;
+
+    // Completion queue
+    unsigned* cq_head_ = nullptr;
+    unsigned* cq_tail_ = nullptr;
+    unsigned cq_mask_ = 0;
+    io_uring_cqe* cqes_ = nullptr;
+
+    void* ring_ptr_ = nullptr;      // SQ and CQ rings (IORING_FEAT_SINGLE_MMAP)
+    size_t ring_bytes_ = 0;
+    void* sqes_ptr_ = nullptr;
+    size_t sqes_bytes_ = 0;
+};
+
+} // namespace matrix::network
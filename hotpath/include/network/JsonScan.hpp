@@ -0,0 +1,172 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__AVX2__) || defined(__AVX512BW__)
+#include <immintrin.h>
+#endif
+
+namespace matrix::network::scan {
+
+// ============================================================================
+// Structural index (quotes)
+// ============================================================================
+
+namespace detail {
+
+/**
+ * Bitmask of '"' and '\' bytes in a 64-byte block
+ */
+inline void classify_block(const char* block, uint64_t& quotes, uint64_t& backslashes) noexcept {
+#if defined(__AVX512BW__)
+    const __m512i v = _mm512_loadu_si512(block);
+    quotes = _mm512_cmpeq_epi8_mask(v, _mm512_set1_epi8('"'));
+    backslashes = _mm512_cmpeq_epi8_mask(v, _mm512_set1_epi8('\\'));
+#elif defined(__AVX2__)
+    const __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+    const __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + 32));
+    const __m256i q = _mm256_set1_epi8('"');
+    const __m256i b = _mm256_set1_epi8('\\');
+    quotes = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, q))) |
+             static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, q)))) << 32;
+    backslashes = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, b))) |
+                  static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, b)))) << 32;
+#else
+    quotes = backslashes = 0;
+    for (int i = 0; i < 64; ++i) {
+        quotes |= static_cast<uint64_t>(block[i] == '"') << i;
+        backslashes |= static_cast<uint64_t>(block[i] == '\\') << i;
+    }
+#endif
+}
+
+/**
+ * Bytes escaped by a preceding odd run of backslashes (simdjson stage 1);
+ * `carry` holds whether the previous block ended mid-escape
+ */
+inline uint64_t escaped_bytes(uint64_t backslashes, uint64_t& carry) noexcept {
+    constexpr uint64_t EVEN_BITS = 0x5555555555555555ULL;
+    if (backslashes == 0) {
+        const uint64_t escaped = carry;
+        carry = 0;
+        return escaped;
+    }
+    backslashes &= ~carry;
+    const uint64_t follows_escape = (backslashes << 1) | carry;
+    const uint64_t odd_starts = backslashes & ~EVEN_BITS & ~follows_escape;
+    uint64_t even_starts;
+    carry = __builtin_add_overflow(odd_starts, backslashes, &even_starts) ? 1 : 0;
+    const uint64_t invert_mask = even_starts << 1;
+    return (EVEN_BITS ^ invert_mask) & follows_escape;
+}
+
+} // namespace detail
+
+/**
+ * Offsets of every unescaped '"' in a JSON text, 64 bytes per step
+ *
+ * In valid JSON these alternate open/close, so string i spans
+ * (quotes[2i], quotes[2i+1]) - that is all the structure the feed decoder
+ * needs; everything else is found by looking next to a quote.
+ *
+ * @return Number of quotes, or SIZE_MAX if more than `max_quotes`
+ */
+inline size_t index_quotes(const char* json, size_t len, uint32_t* quotes, size_t max_quotes) noexcept {
+    size_t count = 0;
+    uint64_t carry = 0;
+
+    for (size_t base = 0; base < len; base += 64) {
+        uint64_t q, bs;
+        if (len - base >= 64) {
+            detail::classify_block(json + base, q, bs);
+        } else {
+            alignas(64) char tail[64] = {};
+            std::memcpy(tail, json + base, len - base);
+            detail::classify_block(tail, q, bs);
+        }
+        q &= ~detail::escaped_bytes(bs, carry);
+
+        if (count + static_cast<size_t>(__builtin_popcountll(q)) > max_quotes) return SIZE_MAX;
+        while (q != 0) {
+            quotes[count++] = static_cast<uint32_t>(base + static_cast<size_t>(__builtin_ctzll(q)));
+            q &= q - 1;
+        }
+    }
+    return count;
+}
+
+// ============================================================================
+// Hex decoding
+// ============================================================================
+
+namespace detail {
+
+inline int hex_value(char c) noexcept {
+    if (c >= '0' && c <= '9') return c - '0';
+    const char lower = static_cast<char>(c | 0x20);
+    if (lower >= 'a' && lower <= 'f') return lower - 'a' + 10;
+    return -1;
+}
+
+#if defined(__AVX2__)
+/**
+ * 32 hex digits -> 16 bytes; false on any non-hex digit
+ */
+inline bool decode_hex32(const char* in, uint8_t* out) noexcept {
+    const __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in));
+    const __m256i lower = _mm256_or_si256(c, _mm256_set1_epi8(0x20));
+
+    const __m256i digit = _mm256_and_si256(_mm256_cmpgt_epi8(c, _mm256_set1_epi8('0' - 1)),
+                                           _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), c));
+    const __m256i alpha = _mm256_and_si256(_mm256_cmpgt_epi8(lower, _mm256_set1_epi8('a' - 1)),
+                                           _mm256_cmpgt_epi8(_mm256_set1_epi8('f' + 1), lower));
+    if (_mm256_movemask_epi8(_mm256_or_si256(digit, alpha)) != -1) return false;
+
+    // '0'-'9' -> low nibble; 'a'-'f' / 'A'-'F' -> low nibble + 9 (bit 6 set)
+    const __m256i nibble = _mm256_add_epi8(
+        _mm256_and_si256(c, _mm256_set1_epi8(0x0F)),
+        _mm256_and_si256(alpha, _mm256_set1_epi8(9)));
+
+    // (hi, lo) nibble pairs -> hi * 16 + lo in 16-bit lanes, then narrow
+    const __m256i pairs = _mm256_maddubs_epi16(nibble, _mm256_set1_epi16(0x0110));
+    const __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(pairs, pairs), 0x08);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm256_castsi256_si128(packed));
+    return true;
+}
+#endif
+
+} // namespace detail
+
+/**
+ * Decode 2 * `bytes` hex digits into `out`
+ * @return false on any non-hex digit
+ */
+inline bool decode_hex(const char* in, size_t bytes, uint8_t* out) noexcept {
+    size_t i = 0;
+#if defined(__AVX2__)
+    for (; i + 16 <= bytes; i += 16) {
+        if (!detail::decode_hex32(in + 2 * i, out + i)) return false;
+    }
+#endif
+    for (; i < bytes; ++i) {
+        const int hi = detail::hex_value(in[2 * i]);
+        const int lo = detail::hex_value(in[2 * i + 1]);
+        if ((hi | lo) < 0) return false;
+        out[i] = static_cast<uint8_t>((hi << 4) | lo);
+    }
+    return true;
+}
+
+/**
+ * Big-endian bytes -> integer (at most sizeof(T) bytes)
+ */
+template<typename T>
+[[nodiscard]] inline T load_be(const uint8_t* bytes, size_t len) noexcept {
+    T value = 0;
+    for (size_t i = 0; i < len; ++i) value = static_cast<T>((value << 8) | bytes[i]);
+    return value;
+}
+
+} // namespace matrix::network::scan
@@ -1,9 +1,11 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <functional>
 #include <memory>
 #include <atomic>
+#include <cstdint>
 
 namespace matrix::network {
 
@@ -13,11 +15,20 @@ namespace matrix::network {
  * Uses io_uring for kernel bypass on Linux for minimal latency.
  * Falls back to epoll on systems without io_uring support.
  *
+ * Frames are received into one ring-style buffer, unmasked and parsed in
+ * place; the message callback gets a view into that buffer that is valid
+ * until it returns (copy it to keep it). latency_ns() is kernel receive
+ * timestamp (SO_TIMESTAMPNS) to callback.
+ *
+ * Threading: connect/disconnect/poll on one owner thread, which is also
+ * where callbacks run; send() may be called from any thread.
+ * Only ws:// is supported (no TLS).
+ *
  * Performance target: <1ms message latency
  */
 class WebSocketClient {
 public:
-    using MessageCallback = std::function<void(const std::string& message)>;
+    using MessageCallback = std::function<void(std::string_view message)>;
     using ErrorCallback = std::function<void(const std::string& error)>;
     using ConnectCallback = std::function<void()>;
 
@@ -27,18 +38,25 @@ public:
         int ping_interval_ms = 30000;
         int timeout_ms = 5000;
         bool use_io_uring = true;
+        size_t rx_buffer_bytes = 1 << 20;   // Largest message accepted
     };
 
     explicit WebSocketClient(const Config& config);
     ~WebSocketClient();
 
-    // Connection management
+    // Connection management (failures are reported via on_error)
     void connect();
     void disconnect();
     [[nodiscard]] bool is_connected() const noexcept;
 
-    // Send message
-    void send(const std::string& message);
+    /**
+     * Wait up to timeout_ms for data and dispatch every complete message
+     * @return Number of messages delivered
+     */
+    size_t poll(int timeout_ms);
+
+    // Send a text message
+    void send(std::string_view message);
 
     // Callbacks
     void on_message(MessageCallback callback);
@@ -50,7 +68,14 @@ public:
     [[nodiscard]] uint64_t bytes_received() const noexcept;
     [[nodiscard]] uint64_t latency_ns() const noexcept;
 
+    // Transport in use for the current connection
+    [[nodiscard]] bool using_io_uring() const noexcept;
+
+    [[nodiscard]] const Config& config() const noexcept { return config_; }
+
 private:
+    void report_error(const std::string& error);
+
     Config config_;
     std::atomic<bool> connected_{false};
 
@@ -58,9 +83,9 @@ private:
     ErrorCallback error_callback_;
     ConnectCallback connect_callback_;
 
-    uint64_t messages_received_ = 0;
-    uint64_t bytes_received_ = 0;
-    uint64_t last_latency_ns_ = 0;
+    std::atomic<uint64_t> messages_received_{0};
+    std::atomic<uint64_t> bytes_received_{0};
+    std::atomic<uint64_t> last_latency_ns_{0};
 
     // Implementation details (platform-specific)
     struct Impl;
@@ -71,6 +96,8 @@ private:
  * WebSocket Manager - Manages multiple WebSocket connections
  *
  * Used to connect to multiple price feed sources simultaneously.
+ * start_all() gives every connection its own reader thread, which
+ * reconnects after reconnect_delay_ms; callbacks run on that thread.
  */
 class WebSocketManager {
 public:
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <thread>
+
+#include "OrderBook.hpp"
+
+namespace matrix::orderbook {
+
+/**
+ * Book snapshot file - OrderBook::write_snapshot() image as written to disk
+ *
+ * Layout: this header, then SECTIONS sections at 64-byte aligned offsets
+ * from the start of the file (pool columns, pool id -> slot and tokens,
+ * token hashes, pair segments, then the pool / token / pair hash index
+ * tables). Everything is offsets and dense ids, so a mapped file is
+ * restored with one memcpy per section. `layout` pins the capacities and
+ * record sizes of the build that wrote it; the checksum covers every byte
+ * up to total_bytes (with the checksum field zeroed).
+ */
+struct BookSnapshotHeader {
+    static constexpr uint32_t VERSION = 1;
+    static constexpr size_t SECTIONS = 19;
+    static constexpr std::array<char, 8> MAGIC = {'M', 'X', 'B', 'O', 'O', 'K', 0, 0};
+
+    struct Section {
+        uint64_t offset;
+        uint64_t bytes;
+    };
+
+    std::array<char, 8> magic;
+    uint32_t version;
+    uint32_t section_count;
+    uint64_t total_bytes;
+    uint64_t checksum;                   // 0 until seal_snapshot()
+    uint64_t layout;
+    uint64_t created_ns;                 // CLOCK_REALTIME when written
+    uint64_t last_update_ns;             // Newest update the book had applied
+    uint64_t pool_count;
+    uint64_t token_count;
+    uint64_t pair_count;
+    uint64_t slot_count;
+    std::array<Section, SECTIONS> sections;
+};
+
+/**
+ * Compute and store an image's checksum (off the hot path: reads it all)
+ * @return false if the image is too short to be a snapshot
+ */
+bool seal_snapshot(std::span<std::byte> image) noexcept;
+
+/**
+ * Check an image's header and checksum (not its layout)
+ */
+[[nodiscard]] bool verify_snapshot(std::span<const std::byte> image) noexcept;
+
+/**
+ * Write an image to `path` via a temporary file and rename, so a reader
+ * never maps a partial snapshot
+ * @return false if the file could not be written
+ */
+bool write_snapshot_file(const std::string& path, std::span<const std::byte> image);
+
+/**
+ * Snapshot `book` to `path` (allocates an image; tools and shutdown)
+ */
+bool save_snapshot(const OrderBook& book, const std::string& path);
+
+/**
+ * Restore an empty `book` from a snapshot file
+ * @return false if the file is missing, corrupt or from another layout
+ */
+bool load_snapshot(OrderBook& book, const std::string& path) noexcept;
+
+/**
+ * Mapped Snapshot - a snapshot file mapped read-only (read into memory
+ * where mmap is unavailable)
+ */
+class MappedSnapshot {
+public:
+    /**
+     * @throws std::runtime_error if the file cannot be opened or mapped
+     */
+    explicit MappedSnapshot(const std::string& path);
+    ~MappedSnapshot();
+
+    MappedSnapshot(const MappedSnapshot&) = delete;
+    MappedSnapshot& operator=(const MappedSnapshot&) = delete;
+
+    [[nodiscard]] std::span<const std::byte> bytes() const noexcept { return {data_, size_}; }
+
+private:
+    const std::byte* data_ = nullptr;
+    size_t size_ = 0;
+    std::unique_ptr<std::byte[]> copy_;  // Fallback without mmap
+};
+
+/**
+ * Snapshot Writer - periodic snapshots without blocking the book's thread
+ *
+ * capture() only flags a request and wakes the writer thread (one atomic
+ * exchange and a futex wake, no copy and no I/O on the caller). The writer
+ * copies the book as a reader (OrderBook::write_snapshot(): every live
+ * section plus the full-size index tables, ~11 MB and ~2 ms at 10k pools
+ * in BM_OrderBook_WriteSnapshot), seals it and writes the file. The
+ * owner thread's only cost is coherence traffic: a line the copy has just
+ * read costs its next store an invalidation. A capture requested while
+ * the previous one is still being copied or written is skipped instead of
+ * waiting. The buffer is sized for a full book up front and its pages are
+ * only touched as the book grows.
+ */
+class SnapshotWriter {
+public:
+    /**
+     * @param book Book to copy; must outlive the writer
+     * @throws std::bad_alloc if the buffer cannot be allocated
+     */
+    SnapshotWriter(const OrderBook& book, std::string path);
+
+    /**
+     * Write out a pending capture and join the writer thread
+     */
+    ~SnapshotWriter();
+
+    SnapshotWriter(const SnapshotWriter&) = delete;
+    SnapshotWriter& operator=(const SnapshotWriter&) = delete;
+
+    /**
+     * Ask the writer thread to copy the book and write it out
+     * @return false if skipped because the previous capture is unfinished
+     */
+    bool capture() noexcept;
+
+    [[nodiscard]] uint64_t written() const noexcept { return written_.load(std::memory_order_relaxed); }
+    [[nodiscard]] uint64_t skipped() const noexcept { return skipped_.load(std::memory_order_relaxed); }
+    [[nodiscard]] uint64_t failed() const noexcept { return failed_.load(std::memory_order_relaxed); }
+
+private:
+    void run() noexcept;
+
+    const OrderBook& book_;
+    std::string path_;
+    size_t buffer_bytes_;
+    std::unique_ptr<std::byte[]> buffer_;
+
+    std::atomic<bool> pending_{false};   // Requested, not yet written out
+    std::atomic<uint32_t> signal_{0};    // Futex word: bumped per capture / on stop
+    std::atomic<bool> running_{true};
+    std::atomic<uint64_t> written_{0};
+    std::atomic<uint64_t> skipped_{0};
+    std::atomic<uint64_t> failed_{0};
+    std::thread writer_;
+};
+
+} // namespace matrix::orderbook
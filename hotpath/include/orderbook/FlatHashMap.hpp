@@ -0,0 +1,193 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "../memory/Arena.hpp"
+
+namespace matrix::orderbook {
+
+/**
+ * 64-bit finalizer (splitmix64) - spreads truncated address hashes and
+ * sequential token ids evenly over the slot array
+ */
+[[nodiscard]] inline uint64_t mix64(uint64_t x) noexcept {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+struct U64Hash {
+    size_t operator()(uint64_t key) const noexcept {
+        return static_cast<size_t>(mix64(key));
+    }
+};
+
+/**
+ * Flat Hash Map - Open-addressing index with Robin Hood probing
+ *
+ * Keys and values live inline in one flat slot array carved from the
+ * Arena, so a lookup touches one or two cache lines and an insert never
+ * calls malloc. The table is sized once from the expected entry count
+ * (load factor <= 50%) and never rehashes or erases, which matches how
+ * the order book only ever adds pools, tokens and pairs.
+ *
+ * Performance: ~5-20ns per lookup vs ~50-100ns for std::unordered_map
+ *
+ * Research: Robin Hood displacement bounds the probe sequence variance,
+ * so misses terminate as soon as we pass a slot richer than the key.
+ *
+ * Concurrency: single writer. size() may be read from any thread, and
+ * find() may race an insert() when the caller validates the result with a
+ * seqlock (as OrderBook does): slots are trivially copyable and the probe
+ * always ends at an empty slot, so a torn read is only a wrong answer to
+ * retry, never a fault.
+ */
+template<typename Key, typename Value, typename Hash>
+class FlatHashMap {
+    static_assert(std::is_trivially_copyable_v<Key>, "Key must be trivially copyable");
+    static_assert(std::is_trivially_copyable_v<Value>, "Value must be trivially copyable");
+
+public:
+    /**
+     * @param arena Backing memory for the slot array
+     * @param max_entries Number of entries the table must hold
+     * @throws std::bad_alloc if the arena cannot hold the slot array
+     */
+    FlatHashMap(memory::Arena& arena, size_t max_entries)
+        : capacity_(slot_count_for(max_entries))
+        , mask_(capacity_ - 1)
+        , max_entries_(max_entries) {
+        void* mem = arena.allocate(capacity_ * sizeof(Slot), alignof(Slot) > 64 ? alignof(Slot) : 64);
+        if (!mem) {
+            throw std::bad_alloc();
+        }
+        slots_ = static_cast<Slot*>(mem);
+        clear();
+    }
+
+    // Non-copyable (slots are owned by the arena, not by us)
+    FlatHashMap(const FlatHashMap&) = delete;
+    FlatHashMap& operator=(const FlatHashMap&) = delete;
+
+    /**
+     * Find value for key
+     * @return Pointer to the stored value, nullptr if absent
+     */
+    [[nodiscard]] const Value* find(const Key& key) const noexcept {
+        size_t pos = Hash{}(key) & mask_;
+        uint32_t dist = 1;
+
+        while (true) {
+            const Slot& slot = slots_[pos];
+            // Empty slot, or a resident closer to home than we are: key absent
+            if (slot.dist < dist) return nullptr;
+            if (slot.dist == dist && slot.key == key) return &slot.value;
+            pos = (pos + 1) & mask_;
+            ++dist;
+        }
+    }
+
+    [[nodiscard]] Value* find(const Key& key) noexcept {
+        return const_cast<Value*>(std::as_const(*this).find(key));
+    }
+
+    /**
+     * Insert key if absent
+     * @return {pointer to stored value, true if inserted}; {existing, false}
+     *         if already present; {nullptr, false} if the table is full
+     */
+    std::pair<Value*, bool> insert(const Key& key, const Value& value) noexcept {
+        if (Value* existing = find(key)) {
+            return {existing, false};
+        }
+        if (size_ >= max_entries_) {
+            return {nullptr, false};
+        }
+
+        Slot incoming{key, value, 1};
+        Value* placed = nullptr;
+        size_t pos = Hash{}(key) & mask_;
+
+        while (true) {
+            Slot& slot = slots_[pos];
+            if (slot.dist == 0) {
+                slot = incoming;
+                if (!placed) placed = &slot.value;
+                break;
+            }
+            // Robin Hood: steal the slot from a richer resident
+            if (slot.dist < incoming.dist) {
+                std::swap(slot, incoming);
+                if (!placed) placed = &slot.value;
+            }
+            pos = (pos + 1) & mask_;
+            ++incoming.dist;
+        }
+
+        std::atomic_ref<size_t>(size_).store(size_ + 1, std::memory_order_release);
+        return {placed, true};
+    }
+
+    /**
+     * Remove all entries (slot array is kept)
+     */
+    void clear() noexcept {
+        std::memset(static_cast<void*>(slots_), 0, capacity_ * sizeof(Slot));
+        size_ = 0;
+    }
+
+    [[nodiscard]] size_t size() const noexcept {
+        return std::atomic_ref<size_t>(const_cast<size_t&>(size_)).load(std::memory_order_acquire);
+    }
+    [[nodiscard]] size_t capacity() const noexcept { return capacity_; }
+    [[nodiscard]] size_t max_entries() const noexcept { return max_entries_; }
+    [[nodiscard]] bool full() const noexcept { return size_ >= max_entries_; }
+
+    /**
+     * Raw slot table, for snapshots: slots hold no pointers, so a map of
+     * the same max_entries can adopt the bytes with assign_table()
+     */
+    [[nodiscard]] const void* table_data() const noexcept { return slots_; }
+    [[nodiscard]] size_t table_bytes() const noexcept { return capacity_ * sizeof(Slot); }
+
+    /**
+     * Replace every slot with a table_data() image holding `size` entries
+     * @return false (map unchanged) if the image does not fit this table
+     */
+    bool assign_table(const void* data, size_t bytes, size_t size) noexcept {
+        if (bytes != table_bytes() || size > max_entries_) return false;
+        std::memcpy(static_cast<void*>(slots_), data, bytes);
+        size_ = size;
+        return true;
+    }
+
+private:
+    struct Slot {
+        Key key;
+        Value value;
+        uint32_t dist;  // Probe distance + 1 (0 = empty)
+    };
+
+    Slot* slots_ = nullptr;
+    size_t capacity_;
+    size_t mask_;
+    size_t max_entries_;
+    size_t size_ = 0;
+
+    [[nodiscard]] static size_t slot_count_for(size_t max_entries) noexcept {
+        size_t n = 16;
+        while (n < max_entries * 2) n <<= 1;
+        return n;
+    }
+};
+
+} // namespace matrix::orderbook
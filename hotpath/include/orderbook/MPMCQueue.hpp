@@ -0,0 +1,263 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+
+#include "SPSCQueue.hpp"
+
+namespace matrix::orderbook {
+
+/**
+ * Bounded Lock-Free Multi-Producer Multi-Consumer (MPMC) Queue
+ *
+ * Vyukov's bounded queue: every slot carries a sequence number telling
+ * producers and consumers whose turn it is, so each side claims a position
+ * with one CAS on its own padded index and never touches the other's.
+ *
+ * Used where several feeds (one WebSocket per chain / RPC provider) merge
+ * into one stream. Producers register for a handle; each handle owns a
+ * padded counter pair so a feed flooding the queue shows up in its own
+ * rejected-push count.
+ *
+ * Consumers may park() like on SPSCQueue; close() releases them.
+ */
+template<typename T, size_t Capacity = 65536, size_t MaxProducers = 16>
+class MPMCQueue {
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be power of 2");
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+    static constexpr size_t MASK = Capacity - 1;
+
+public:
+    /**
+     * Per-producer backpressure counters (snapshot)
+     */
+    struct ProducerStats {
+        uint64_t pushed;
+        uint64_t rejected;      // Push found the queue full
+    };
+
+    /**
+     * Producer handle - cheap to copy, usable from one thread at a time
+     */
+    class Producer {
+    public:
+        template<typename U>
+        [[nodiscard]] bool push(U&& item) noexcept {
+            return queue_->push(id_, std::forward<U>(item));
+        }
+
+        [[nodiscard]] uint32_t id() const noexcept { return id_; }
+
+    private:
+        friend class MPMCQueue;
+        Producer(MPMCQueue* queue, uint32_t id) noexcept : queue_(queue), id_(id) {}
+
+        MPMCQueue* queue_;
+        uint32_t id_;
+    };
+
+    MPMCQueue() {
+        // Slot i is writable for position i
+        for (size_t i = 0; i < Capacity; ++i) {
+            buffer_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MPMCQueue(const MPMCQueue&) = delete;
+    MPMCQueue& operator=(const MPMCQueue&) = delete;
+
+    /**
+     * Register a producer
+     * @throws std::length_error once MaxProducers handles are out
+     */
+    [[nodiscard]] Producer add_producer() {
+        const uint32_t id = producer_count_.fetch_add(1, std::memory_order_relaxed);
+        if (id >= MaxProducers) {
+            producer_count_.fetch_sub(1, std::memory_order_relaxed);
+            throw std::length_error("MPMCQueue: too many producers");
+        }
+        return Producer(this, id);
+    }
+
+    /**
+     * Push on behalf of producer `producer_id` (any thread)
+     * @return false if the queue is full
+     */
+    template<typename U>
+    [[nodiscard]] bool push(uint32_t producer_id, U&& item) noexcept {
+        ProducerCounters& counters = producers_[producer_id];
+
+        size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        Slot* slot;
+        while (true) {
+            slot = &buffer_[pos & MASK];
+            const size_t seq = slot->sequence.load(std::memory_order_acquire);
+            const intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+
+            if (diff == 0) {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                counters.rejected.fetch_add(1, std::memory_order_relaxed);
+                return false;  // Queue full
+            } else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+
+        slot->data = std::forward<U>(item);
+        slot->sequence.store(pos + 1, std::memory_order_release);
+        counters.pushed.fetch_add(1, std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_seq_cst);  // Pairs with park()
+        if (waiters_.load(std::memory_order_relaxed) != 0) {
+            signal_.fetch_add(1, std::memory_order_release);
+            signal_.notify_all();
+        }
+        return true;
+    }
+
+    /**
+     * Pop one item (any thread)
+     */
+    [[nodiscard]] bool try_pop(T& item) noexcept {
+        auto take = [&](T& slot_item) noexcept { item = std::move(slot_item); };
+        return consume_one(take);
+    }
+
+    [[nodiscard]] std::optional<T> pop() noexcept {
+        T item;
+        if (!try_pop(item)) return std::nullopt;
+        return item;
+    }
+
+    /**
+     * Hand up to max_items items to fn(T&) in place, one claimed slot at a
+     * time (any thread). fn must not touch the queue.
+     * @return Number of items consumed
+     */
+    template<typename F>
+    size_t consume(F&& fn, size_t max_items = Capacity) noexcept(noexcept(fn(std::declval<T&>()))) {
+        size_t count = 0;
+        while (count < max_items && consume_one(fn)) {
+            ++count;
+        }
+        return count;
+    }
+
+    /**
+     * Sleep until the queue is non-empty or closed; may return spuriously
+     */
+    void park() noexcept {
+        const uint32_t signal = signal_.load(std::memory_order_acquire);
+        waiters_.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);  // Pairs with push()
+
+        if (empty() && !closed_.load(std::memory_order_relaxed)) {
+            signal_.wait(signal, std::memory_order_acquire);
+        }
+        waiters_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * Release parked consumers and keep park() from blocking again
+     */
+    void close() noexcept {
+        closed_.store(true, std::memory_order_relaxed);
+        signal_.fetch_add(1, std::memory_order_release);
+        signal_.notify_all();
+    }
+
+    [[nodiscard]] bool closed() const noexcept { return closed_.load(std::memory_order_relaxed); }
+
+    /**
+     * Check if queue is empty (approximate; claimed-but-unwritten pushes count)
+     */
+    [[nodiscard]] bool empty() const noexcept {
+        return dequeue_pos_.load(std::memory_order_relaxed) ==
+               enqueue_pos_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Get approximate size
+     */
+    [[nodiscard]] size_t size() const noexcept {
+        const size_t h = dequeue_pos_.load(std::memory_order_relaxed);
+        const size_t t = enqueue_pos_.load(std::memory_order_relaxed);
+        return t >= h ? t - h : 0;
+    }
+
+    [[nodiscard]] static constexpr size_t capacity() noexcept { return Capacity; }
+
+    [[nodiscard]] size_t producer_count() const noexcept {
+        return producer_count_.load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] ProducerStats producer_stats(uint32_t producer_id) const noexcept {
+        const ProducerCounters& counters = producers_[producer_id];
+        return {counters.pushed.load(std::memory_order_relaxed),
+                counters.rejected.load(std::memory_order_relaxed)};
+    }
+
+private:
+    struct Slot {
+        std::atomic<size_t> sequence;
+        T data;
+    };
+
+    struct alignas(CACHE_LINE_SIZE) ProducerCounters {
+        std::atomic<uint64_t> pushed{0};
+        std::atomic<uint64_t> rejected{0};
+    };
+
+    /**
+     * Claim the oldest published slot, run fn on it, hand it back to producers
+     */
+    template<typename F>
+    bool consume_one(F& fn) noexcept(noexcept(fn(std::declval<T&>()))) {
+        size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+        Slot* slot;
+        while (true) {
+            slot = &buffer_[pos & MASK];
+            const size_t seq = slot->sequence.load(std::memory_order_acquire);
+            const intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+
+            if (diff == 0) {
+                if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;  // Queue empty
+            } else {
+                pos = dequeue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+
+        fn(slot->data);
+        slot->sequence.store(pos + Capacity, std::memory_order_release);
+        return true;
+    }
+
+    // Pad to prevent false sharing
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> enqueue_pos_{0};
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> dequeue_pos_{0};
+
+    alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> waiters_{0};
+    std::atomic<uint32_t> signal_{0};
+    std::atomic<bool> closed_{false};
+    std::atomic<uint32_t> producer_count_{0};
+
+    std::array<ProducerCounters, MaxProducers> producers_;
+    alignas(CACHE_LINE_SIZE) std::array<Slot, Capacity> buffer_;
+};
+
+// Feed queue several price sources push into
+using PriceFeedQueue = MPMCQueue<PriceUpdate, 65536>;
+
+} // namespace matrix::orderbook
@@ -1,14 +1,21 @@
 #pragma once
 
+#include <atomic>
 #include <cstdint>
-#include <unordered_map>
-#include <unordered_set>
 #include <vector>
 #include <array>
+#include <cstddef>
+#include <iterator>
+#include <optional>
+#include <span>
 #include <string_view>
 
 #include "SPSCQueue.hpp"
+#include "FlatHashMap.hpp"
+#include "PoolKernels.hpp"
+#include "SeqLock.hpp"
 #include "../memory/Arena.hpp"
+#include "swap_math.hpp"
 
 namespace matrix::orderbook {
 
@@ -37,8 +44,19 @@ enum class DexId : uint32_t {
     AERODROME = 8
 };
 
+/**
+ * True for DEXes quoted with the x*y=k curve (V3 pools are tracked by their
+ * in-range virtual reserves); Curve and Balancer use other invariants
+ */
+[[nodiscard]] constexpr bool is_constant_product(DexId dex) noexcept {
+    return dex != DexId::CURVE && dex != DexId::BALANCER;
+}
+
 /**
  * Pool state - represents a DEX liquidity pool
+ *
+ * Value type: the order book keeps pools as structure-of-arrays columns and
+ * materializes a PoolState on demand, in the pool's own token order.
  */
 struct PoolState {
     uint64_t pool_address_hash;     // Keccak hash of pool address
@@ -70,29 +88,28 @@ struct PoolState {
      * @return Output amount after fees
      */
     [[nodiscard]] uint64_t get_amount_out(uint64_t amount_in, bool is_token0_in) const noexcept {
-        if (amount_in == 0) return 0;
-
         const uint64_t reserve_in = is_token0_in ? reserve0 : reserve1;
         const uint64_t reserve_out = is_token0_in ? reserve1 : reserve0;
 
-        // Apply fee: amount_in_with_fee = amount_in * (10000 - fee_bps)
-        const uint64_t amount_in_with_fee = amount_in * (10000 - fee_bps);
-
-        // Constant product formula: dy = (dx * y) / (x + dx)
-        const uint64_t numerator = amount_in_with_fee * reserve_out;
-        const uint64_t denominator = reserve_in * 10000 + amount_in_with_fee;
-
-        return numerator / denominator;
+        // Constant product formula: dy = (dx * y) / (x + dx), exact 128-bit math
+        return hotpath::swap::get_amount_out(amount_in, reserve_in, reserve_out, fee_bps);
     }
 };
 
 /**
  * Token pair key for hash map
+ *
+ * Always stored in canonical order (token0 < token1) so both swap
+ * directions resolve to the same pool list.
  */
 struct PairKey {
     uint64_t token0;
     uint64_t token1;
 
+    [[nodiscard]] static PairKey canonical(uint64_t a, uint64_t b) noexcept {
+        return a < b ? PairKey{a, b} : PairKey{b, a};
+    }
+
     bool operator==(const PairKey& other) const noexcept {
         return token0 == other.token0 && token1 == other.token1;
     }
@@ -100,88 +117,458 @@ struct PairKey {
 
 struct PairKeyHash {
     size_t operator()(const PairKey& key) const noexcept {
-        return key.token0 ^ (key.token1 << 1);
+        return static_cast<size_t>(mix64(key.token0 ^ mix64(key.token1)));
     }
 };
 
+/**
+ * Dense token ids of a pool, in the pool's own token order
+ */
+struct PoolTokenIds {
+    uint32_t token0;
+    uint32_t token1;
+};
+
+class OrderBook;
+
+/**
+ * Pools trading a token pair - view over the pair's contiguous column
+ * segment as of get_pools()
+ *
+ * Stays safe to iterate while the writer keeps going: a segment moved by a
+ * later pool creation is abandoned in place, never reused, so the view
+ * keeps reading consistent (but no longer updated) pools. Fetch a fresh
+ * range per scan.
+ */
+class PoolRange {
+public:
+    class iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = PoolState;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = PoolState;
+
+        iterator() = default;
+        iterator(const OrderBook* book, uint32_t slot) noexcept : book_(book), slot_(slot) {}
+
+        reference operator*() const noexcept;
+        iterator& operator++() noexcept { ++slot_; return *this; }
+        iterator operator++(int) noexcept { iterator tmp = *this; ++slot_; return tmp; }
+
+        bool operator==(const iterator& other) const noexcept { return slot_ == other.slot_; }
+        bool operator!=(const iterator& other) const noexcept { return slot_ != other.slot_; }
+
+    private:
+        const OrderBook* book_ = nullptr;
+        uint32_t slot_ = 0;
+    };
+
+    PoolRange() = default;
+    PoolRange(const OrderBook* book, uint32_t first_slot, uint32_t count) noexcept
+        : book_(book), first_slot_(first_slot), count_(count) {}
+
+    [[nodiscard]] iterator begin() const noexcept { return iterator(book_, first_slot_); }
+    [[nodiscard]] iterator end() const noexcept { return iterator(book_, first_slot_ + count_); }
+    [[nodiscard]] size_t size() const noexcept { return count_; }
+    [[nodiscard]] bool empty() const noexcept { return count_ == 0; }
+
+    /** First column slot of the segment (see OrderBook::columns()) */
+    [[nodiscard]] uint32_t first_slot() const noexcept { return first_slot_; }
+
+private:
+    const OrderBook* book_ = nullptr;
+    uint32_t first_slot_ = 0;
+    uint32_t count_ = 0;
+};
+
+/**
+ * Pool columns - structure-of-arrays pool storage
+ *
+ * Each pair owns one contiguous segment of slots, so scanning every pool of
+ * a pair is a straight run of vector loads. Reserves, decimals and flags are
+ * stored in the pair's canonical orientation (reserve0 belongs to the
+ * smaller token hash); FLAG_REVERSED marks pools whose on-chain token0 is the
+ * pair's token1.
+ */
+struct PoolColumns {
+    static constexpr uint8_t FLAG_REVERSED = 0x01;
+
+    uint64_t* pool_hash;
+    uint64_t* reserve0;
+    uint64_t* reserve1;
+    uint64_t* last_update_ns;
+    uint32_t* fee_bps;
+    ChainId* chain;
+    DexId* dex;
+    uint32_t* pool_id;       // Stable pool id stored in this slot
+    uint32_t* pair_id;       // Owning pair
+    uint8_t* decimals0;
+    uint8_t* decimals1;
+    uint8_t* flags;
+    uint32_t* seq;           // Seqlock over reserve0 / reserve1 / last_update_ns
+};
+
 /**
  * Order Book - Aggregated view of all pools across all chains/DEXs
  *
- * Maintains a hash map from token pairs to all available pools.
+ * Maintains flat open-addressing indexes (pool hash -> pool, token ->
+ * dense token id, token pair -> pool segment) and structure-of-arrays pool
+ * columns, all carved from the Arena, so update_pool() never allocates.
  * Updated by consuming from the price queue.
  *
+ * Pools have a stable id (creation order) and a column slot. When a pair's
+ * segment fills up it is copied to a fresh segment of twice the capacity,
+ * which moves its pools to new slots but never changes their ids.
+ *
+ * Pools and tokens are never removed and a pool's tokens never change, so
+ * the topology is append-only: pools [n, pool_count()) are exactly the ones
+ * created since pool_count() was n. Consumers that mirror the topology
+ * (e.g. arbitrage::TokenGraph) keep that count as their cursor.
+ *
+ * Concurrency: one writer thread (update_pool(), process_updates(), the
+ * dirty set, restore_snapshot()) and any number of reader threads running
+ * the const lookups at the same time, without locks on either side:
+ * - Reserves and timestamps are guarded by a per-slot seqlock, so pool(),
+ *   find_pool(), PoolRange and the best-pool queries always return a
+ *   pool's reserves from one update, never a torn pair. The best-pool
+ *   queries also score each pool on one update's reserves; the pool they
+ *   return is re-read, so it may carry a newer update than the one scored.
+ * - Pool creation (index inserts, segment moves) runs under a book-wide
+ *   topology seqlock that the index lookups validate against; pools
+ *   created while a lookup runs make it retry, reserve updates do not.
+ * - pool_count() is published last, so every id below it is fully built.
+ * - write_snapshot() combines both, so a snapshot can be copied off-thread.
+ * Segments are never freed, so no reader needs an epoch or grace period.
+ * Raw columns() reads and the stats other than the counts are owner-thread
+ * only.
+ *
  * Performance target: <10us per update
  */
 class OrderBook {
 public:
     static constexpr size_t MAX_POOLS = 100000;
     static constexpr size_t MAX_TOKENS = 10000;
+    static constexpr size_t MAX_PAIRS = MAX_POOLS;      // Each pool adds at most one pair
+    // Doubling leaves a pair of n pools 2 * capacity - 1 < 4n slots (its
+    // live segment plus every one it outgrew), so columns never run out
+    // before MAX_POOLS does
+    static constexpr size_t MAX_SLOTS = 4 * MAX_POOLS;
+    static constexpr uint32_t INVALID_INDEX = UINT32_MAX;
 
     explicit OrderBook(memory::Arena& arena);
 
     /**
-     * Process price updates from the queue
+     * Process price updates from the queue (SPSCQueue or MPMCQueue)
+     * Changed pools accumulate in dirty_pools() until clear_dirty()
      * @param queue Source of price updates
      * @return Number of updates processed
      */
-    size_t process_updates(PriceQueue& queue) noexcept;
+    template<typename Queue>
+    size_t process_updates(Queue& queue) noexcept {
+        // Apply in place from the ring; no copy out of the slot
+        return queue.consume([this](const PriceUpdate& update) noexcept {
+            update_pool(update);
+        });
+    }
 
     /**
-     * Update a single pool's state
+     * Update a single pool's state (and add it to the dirty set)
+     *
+     * Last writer wins: repeated updates of a pool within one dirty batch
+     * overwrite its reserves in place and are counted in coalesced_updates().
      */
     void update_pool(const PriceUpdate& update) noexcept;
 
     /**
-     * Get all pools for a token pair
+     * Ids of pools updated or created since the last clear_dirty(),
+     * each listed once, in first-update order
+     */
+    [[nodiscard]] std::span<const uint32_t> dirty_pools() const noexcept {
+        return {dirty_ids_, dirty_count_};
+    }
+
+    /**
+     * Start a new dirty batch (O(1))
+     */
+    void clear_dirty() noexcept;
+
+    /**
+     * Get all pools for a token pair (either token order)
      * @param token0 First token hash
      * @param token1 Second token hash
-     * @return Vector of pool pointers (may be empty)
+     * @return Range of pools (may be empty)
+     */
+    [[nodiscard]] PoolRange get_pools(uint64_t token0, uint64_t token1) const noexcept;
+
+    /**
+     * Look up a pool by address hash
+     * @return Pool state, nullopt if the pool has never been seen
+     */
+    [[nodiscard]] std::optional<PoolState> find_pool(uint64_t pool_hash) const noexcept;
+
+    /**
+     * Look up a pool's stable id by address hash
+     * @return Pool id, INVALID_INDEX if the pool has never been seen
+     */
+    [[nodiscard]] uint32_t find_pool_id(uint64_t pool_hash) const noexcept;
+
+    /**
+     * Materialize a pool by stable id (id < pool_count())
+     */
+    [[nodiscard]] PoolState pool(uint32_t pool_id) const noexcept;
+
+    /**
+     * Dense token ids of a pool (id < pool_count())
+     */
+    [[nodiscard]] PoolTokenIds pool_token_ids(uint32_t pool_id) const noexcept {
+        return pool_tokens_[pool_id];
+    }
+
+    /**
+     * Chain of a pool (id < pool_count())
+     */
+    [[nodiscard]] ChainId pool_chain(uint32_t pool_id) const noexcept {
+        return cols_.chain[slot_of(pool_id)];
+    }
+
+    /**
+     * Dense token id of a token address hash
+     * @return Token id, INVALID_INDEX if the token has never been seen
      */
-    [[nodiscard]] const std::vector<PoolState*>& get_pools(uint64_t token0, uint64_t token1) const noexcept;
+    [[nodiscard]] uint32_t token_id(uint64_t token_hash) const noexcept;
+
+    /**
+     * Token address hash of a dense token id (id < token_count())
+     */
+    [[nodiscard]] uint64_t token_hash(uint32_t token_id) const noexcept {
+        return token_hashes_[token_id];
+    }
 
     /**
      * Get best price for a swap
-     * @return Best pool for the swap, nullptr if none available
+     * @param token_in Token sold
+     * @param token_out Token bought
+     * @return Pool with the highest output per input after fee, nullopt if none
      */
-    [[nodiscard]] const PoolState* get_best_price(uint64_t token0, uint64_t token1) const noexcept;
+    [[nodiscard]] std::optional<PoolState> get_best_price(uint64_t token_in, uint64_t token_out) const noexcept;
+
+    /**
+     * get_best_price() among one chain's pools only (a token hash shared
+     * across chains, e.g. an OP Stack predeploy, is one book token)
+     */
+    [[nodiscard]] std::optional<PoolState> get_best_price(
+        uint64_t token_in,
+        uint64_t token_out,
+        ChainId chain
+    ) const noexcept;
+
+    /**
+     * Get the pool returning the most token_out for a given input size
+     * (accounts for price impact, unlike get_best_price)
+     */
+    [[nodiscard]] std::optional<PoolState> get_best_pool_for_amount(
+        uint64_t token_in,
+        uint64_t token_out,
+        uint64_t amount_in
+    ) const noexcept;
 
     /**
      * Get all pools on a specific chain
      */
-    [[nodiscard]] std::vector<const PoolState*> get_pools_by_chain(ChainId chain) const noexcept;
+    [[nodiscard]] std::vector<PoolState> get_pools_by_chain(ChainId chain) const noexcept;
+
+    /**
+     * get_pools_by_chain() into a reused vector (cleared first; no
+     * allocation once it has grown to the chain's pool count)
+     * @return Number of pools written
+     */
+    size_t get_pools_by_chain(ChainId chain, std::vector<PoolState>& out) const noexcept;
+
+    /**
+     * Raw column access for vectorized scans (plain loads: owner thread,
+     * or re-read the chosen pool through pool())
+     */
+    [[nodiscard]] const PoolColumns& columns() const noexcept { return cols_; }
 
     /**
      * Statistics
      */
-    [[nodiscard]] size_t pool_count() const noexcept { return pool_count_; }
-    [[nodiscard]] size_t token_count() const noexcept { return token_set_.size(); }
+    [[nodiscard]] size_t pool_count() const noexcept {
+        return std::atomic_ref<size_t>(const_cast<size_t&>(pool_count_)).load(std::memory_order_acquire);
+    }
+    [[nodiscard]] size_t token_count() const noexcept { return token_index_.size(); }
+    [[nodiscard]] size_t pair_count() const noexcept { return pair_index_.size(); }
+    [[nodiscard]] size_t slots_used() const noexcept { return slot_top_; }
+    [[nodiscard]] uint64_t rejected_updates() const noexcept { return rejected_updates_; }
+    [[nodiscard]] uint64_t coalesced_updates() const noexcept { return coalesced_updates_; }
     [[nodiscard]] uint64_t last_update_ns() const noexcept { return last_update_ns_; }
 
+    // ------------------------------------------------------------------------
+    // Snapshots (file format and background writer: BookSnapshot.hpp)
+    // ------------------------------------------------------------------------
+
+    /**
+     * Bytes write_snapshot() needs for the current contents
+     */
+    [[nodiscard]] size_t snapshot_size() const noexcept;
+
+    /**
+     * Snapshot size of a full book; a buffer this big never has to grow
+     */
+    [[nodiscard]] size_t max_snapshot_size() const noexcept;
+
+    /**
+     * Write a flat image of the pool columns, id maps, token table, pair
+     * segments and hash indexes: a header of section offsets, then each
+     * section's live bytes. Nothing in it is a pointer.
+     *
+     * Safe on a reader thread while the owner keeps updating: each pool's
+     * reserves come from one update (per-slot seqlock), and pool creation
+     * during the copy restarts it, up to SNAPSHOT_ATTEMPTS times.
+     * @return Bytes written, 0 if `out` is smaller than snapshot_size() or
+     *         pools kept being created under every attempt
+     */
+    size_t write_snapshot(std::span<std::byte> out) const noexcept;
+
+    /**
+     * Adopt a sealed write_snapshot() image (seal_snapshot()) of a book
+     * with this build's layout. Each section is copied into place as is,
+     * with no per-pool decoding or rehashing. Every restored pool starts
+     * out dirty.
+     * @return false (book unchanged) if this book has pools or the image
+     *         is invalid
+     */
+    bool restore_snapshot(std::span<const std::byte> image) noexcept;
+
 private:
+    friend class PoolRange;
+
+    struct SnapshotArray {
+        void* data;
+        size_t bytes;
+    };
+    static constexpr size_t SNAPSHOT_ARRAYS = 16;
+    static constexpr int SNAPSHOT_ATTEMPTS = 4;
+
+    /**
+     * Arrays a snapshot carries, in file order, sized for the given counts
+     * (the three hash index tables follow them)
+     */
+    [[nodiscard]] std::array<SnapshotArray, SNAPSHOT_ARRAYS> snapshot_arrays(
+        size_t slots, size_t pools, size_t tokens, size_t pairs) const noexcept;
+
+    /**
+     * Capacities and record sizes an image must have been written with
+     */
+    [[nodiscard]] uint64_t snapshot_layout() const noexcept;
+
+    /**
+     * Pair bucket - the pair's column segment [first_slot, first_slot + count)
+     */
+    struct PairEntry {
+        PairKey key;
+        uint32_t first_slot;
+        uint32_t count;
+        uint32_t capacity;
+    };
+
     memory::Arena& arena_;
 
-    // Pool storage (pre-allocated)
-    std::array<PoolState, MAX_POOLS> pools_;
+    // Pool storage (pre-allocated columns, grouped per pair)
+    PoolColumns cols_{};
+    uint32_t* slot_of_ = nullptr;   // Pool id -> column slot
+    PoolTokenIds* pool_tokens_ = nullptr;  // Pool id -> dense token ids
     size_t pool_count_ = 0;
+    size_t slot_top_ = 0;           // Next unreserved slot
+
+    // Pool address -> stable pool id
+    FlatHashMap<uint64_t, uint32_t, U64Hash> pool_index_;
 
-    // Token pair -> pools mapping
-    std::unordered_map<PairKey, std::vector<PoolState*>, PairKeyHash> pair_pools_;
+    // Token address -> dense token id (insertion order)
+    FlatHashMap<uint64_t, uint32_t, U64Hash> token_index_;
+    uint64_t* token_hashes_ = nullptr;  // Dense token id -> address hash
 
-    // Pool address -> pool index mapping
-    std::unordered_map<uint64_t, size_t> pool_index_;
+    // Canonical token pair -> index into pair_entries_
+    FlatHashMap<PairKey, uint32_t, PairKeyHash> pair_index_;
+    PairEntry* pair_entries_ = nullptr;
 
-    // Set of known tokens
-    std::unordered_set<uint64_t> token_set_;
+    // Odd while create_pool() is changing indexes, segments or slot_of_
+    uint32_t topology_seq_ = 0;
 
-    // Empty vector for returning when no pools exist
-    static const std::vector<PoolState*> empty_pools_;
+    // Dirty set: a pool is in it iff dirty_mark_[id] == dirty_epoch_
+    uint32_t* dirty_ids_ = nullptr;
+    uint32_t* dirty_mark_ = nullptr;
+    size_t dirty_count_ = 0;
+    uint32_t dirty_epoch_ = 1;
 
+    uint64_t rejected_updates_ = 0;
+    uint64_t coalesced_updates_ = 0;      // Updates to a pool already in the dirty batch
     uint64_t last_update_ns_ = 0;
 
     /**
-     * Get or create pool by address hash
+     * Register a first-seen pool: index its tokens and reserve a slot in
+     * its pair's segment
+     * @return Column slot, INVALID_INDEX if any index is at capacity
+     */
+    uint32_t create_pool(const PriceUpdate& update) noexcept;
+
+    /**
+     * Dense id of a token, assigning the next id on first sight
+     */
+    uint32_t intern_token(uint64_t token_hash) noexcept;
+
+    /**
+     * Reserve a slot at the end of a pair's segment, moving the segment to
+     * a segment of twice the capacity when it is full
+     * @return Column slot, INVALID_INDEX if column storage is exhausted
      */
-    PoolState* get_or_create_pool(uint64_t pool_hash) noexcept;
+    uint32_t reserve_slot(PairEntry& entry) noexcept;
+
+    /**
+     * Store an update's reserves and timestamp in a slot (seqlocked)
+     */
+    void write_reserves(uint32_t slot, const PriceUpdate& update) noexcept;
+
+    [[nodiscard]] PoolState pool_at_slot(uint32_t slot) const noexcept;
+
+    /**
+     * Current slot of a pool (moves publish the new slot last)
+     */
+    [[nodiscard]] uint32_t slot_of(uint32_t pool_id) const noexcept {
+        return std::atomic_ref<uint32_t>(slot_of_[pool_id]).load(std::memory_order_acquire);
+    }
+
+    /**
+     * Run an index lookup until no pool creation overlapped it
+     */
+    template<typename F>
+    [[nodiscard]] auto read_topology(F&& lookup) const noexcept {
+        for (;;) {
+            const uint32_t seq = seqlock::read_begin(topology_seq_);
+            auto result = lookup();
+            if (!seqlock::read_retry(topology_seq_, seq)) return result;
+        }
+    }
+
+    [[nodiscard]] std::optional<PoolState> select_best(
+        uint64_t token_in,
+        uint64_t token_out,
+        uint64_t amount_in,
+        std::optional<ChainId> chain = std::nullopt
+    ) const noexcept;
+
+    template<typename T>
+    [[nodiscard]] T* allocate_array(size_t count);
 };
 
+// ============================================================================
+// PoolRange inline implementation
+// ============================================================================
+
+inline PoolState PoolRange::iterator::operator*() const noexcept {
+    return book_->pool_at_slot(slot_);
+}
+
 } // namespace matrix::orderbook
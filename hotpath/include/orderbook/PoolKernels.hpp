@@ -0,0 +1,178 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+namespace matrix::orderbook::kernels {
+
+/**
+ * Result of a best-pool selection over a pair's pool columns
+ */
+struct ArgMax {
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    uint32_t index = NONE;  // Offset into the scanned columns
+    double value = 0.0;     // Output per input (amount_in == 0) or amount out
+};
+
+/**
+ * Score one pool: reserve_out * g / (reserve_in + amount_in * g),
+ * g = (10000 - fee_bps) / 10000.
+ *
+ * amount_in == 0 gives the marginal (spot) price after fee; otherwise the
+ * constant-product amount out for amount_in. Evaluated in double - this is
+ * for *selecting* a pool, exact integer math happens afterwards.
+ * Returns a negative score for unusable pools (no liquidity).
+ */
+[[nodiscard]] inline double score_pool(uint64_t reserve_in, uint64_t reserve_out,
+                                       uint32_t fee_bps, double amount_in) noexcept {
+    const double g = static_cast<double>(10000u - fee_bps) * 1e-4;
+    const double den = amount_in * g + static_cast<double>(reserve_in);
+    if (!(den > 0.0) || reserve_out == 0) return -1.0;
+    if (amount_in == 0.0) return static_cast<double>(reserve_out) * g / den;
+    return static_cast<double>(reserve_out) * (amount_in * g) / den;
+}
+
+namespace detail {
+
+inline ArgMax argmax_scalar(const uint64_t* reserve_in, const uint64_t* reserve_out,
+                            const uint32_t* fee_bps, size_t begin, size_t n,
+                            double amount_in, ArgMax best) noexcept {
+    for (size_t i = begin; i < n; ++i) {
+        const double v = score_pool(reserve_in[i], reserve_out[i], fee_bps[i], amount_in);
+        if (v >= 0.0 && (best.index == ArgMax::NONE || v > best.value)) {
+            best.index = static_cast<uint32_t>(i);
+            best.value = v;
+        }
+    }
+    return best;
+}
+
+#if defined(__AVX2__) && !(defined(__AVX512F__) && defined(__AVX512DQ__))
+/// Exact uint64 -> double for 4 lanes (AVX2 has no vcvtuqq2pd)
+inline __m256d cvt_u64_f64(__m256i v) noexcept {
+    const __m256i lo = _mm256_blend_epi32(v, _mm256_castpd_si256(_mm256_set1_pd(0x1p52)), 0xAA);
+    __m256i hi = _mm256_srli_epi64(v, 32);
+    hi = _mm256_or_si256(hi, _mm256_castpd_si256(_mm256_set1_pd(0x1p84)));
+    const __m256d hi_d = _mm256_sub_pd(_mm256_castsi256_pd(hi), _mm256_set1_pd(0x1p84 + 0x1p52));
+    return _mm256_add_pd(hi_d, _mm256_castsi256_pd(lo));
+}
+#endif
+
+} // namespace detail
+
+/**
+ * Index of the pool with the highest score (see score_pool)
+ *
+ * The columns are a pair's contiguous pool segment, so each iteration is
+ * a handful of straight vector loads: 8 pools per step on AVX-512, 4 on
+ * AVX2, scalar otherwise. Ties resolve to the lowest index on every path.
+ */
+[[nodiscard]] inline ArgMax argmax_output(const uint64_t* reserve_in, const uint64_t* reserve_out,
+                                          const uint32_t* fee_bps, size_t n,
+                                          uint64_t amount_in = 0) noexcept {
+    const double a = static_cast<double>(amount_in);
+    ArgMax best;
+    size_t i = 0;
+
+#if defined(__AVX512F__) && defined(__AVX512DQ__)
+    if (n >= 8) {
+        const __m512d va = _mm512_set1_pd(a);
+        const __m512d zero = _mm512_setzero_pd();
+        __m512d best_v = _mm512_set1_pd(-1.0);
+        __m512i best_i = _mm512_set1_epi64(-1);
+        __m512i idx = _mm512_setr_epi64(0, 1, 2, 3, 4, 5, 6, 7);
+
+        for (; i + 8 <= n; i += 8) {
+            const __m512d rin = _mm512_cvtepu64_pd(_mm512_loadu_si512(reserve_in + i));
+            const __m512i rout_i = _mm512_loadu_si512(reserve_out + i);
+            const __m512d rout = _mm512_cvtepu64_pd(rout_i);
+            const __m256i fee = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(fee_bps + i));
+            // All-lanes maskz: GCC 12's unmasked form (and the reduce_*
+            // helpers) trip -Wmaybe-uninitialized on its own headers
+            const __m512d g = _mm512_mul_pd(
+                _mm512_maskz_cvtepi32_pd(0xFF, _mm256_sub_epi32(_mm256_set1_epi32(10000), fee)),
+                _mm512_set1_pd(1e-4));
+
+            const __m512d den = _mm512_add_pd(_mm512_mul_pd(va, g), rin);
+            const __m512d num = a == 0.0 ? _mm512_mul_pd(rout, g)
+                                         : _mm512_mul_pd(rout, _mm512_mul_pd(va, g));
+            const __m512d v = _mm512_div_pd(num, den);
+
+            const __mmask8 valid = _mm512_cmp_pd_mask(den, zero, _CMP_GT_OQ) &
+                                   _mm512_test_epi64_mask(rout_i, rout_i);
+            const __mmask8 better = _mm512_mask_cmp_pd_mask(valid, v, best_v, _CMP_GT_OQ);
+            best_v = _mm512_mask_blend_pd(better, best_v, v);
+            best_i = _mm512_mask_blend_epi64(better, best_i, idx);
+            idx = _mm512_add_epi64(idx, _mm512_set1_epi64(8));
+        }
+
+        alignas(64) double vals[8];
+        alignas(64) int64_t idxs[8];
+        _mm512_store_pd(vals, best_v);
+        _mm512_store_si512(idxs, best_i);
+        for (int lane = 0; lane < 8; ++lane) {
+            if (vals[lane] < 0.0) continue;
+            const auto lane_idx = static_cast<uint32_t>(idxs[lane]);
+            if (best.index == ArgMax::NONE || vals[lane] > best.value ||
+                (vals[lane] == best.value && lane_idx < best.index)) {
+                best.index = lane_idx;
+                best.value = vals[lane];
+            }
+        }
+    }
+#elif defined(__AVX2__)
+    if (n >= 4) {
+        const __m256d va = _mm256_set1_pd(a);
+        const __m256d zero = _mm256_setzero_pd();
+        __m256d best_v = _mm256_set1_pd(-1.0);
+        __m256d best_i = _mm256_set1_pd(-1.0);
+        __m256d idx = _mm256_setr_pd(0.0, 1.0, 2.0, 3.0);
+
+        for (; i + 4 <= n; i += 4) {
+            const __m256d rin = detail::cvt_u64_f64(
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(reserve_in + i)));
+            const __m256d rout = detail::cvt_u64_f64(
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(reserve_out + i)));
+            const __m128i fee = _mm_loadu_si128(reinterpret_cast<const __m128i*>(fee_bps + i));
+            const __m256d g = _mm256_mul_pd(
+                _mm256_cvtepi32_pd(_mm_sub_epi32(_mm_set1_epi32(10000), fee)),
+                _mm256_set1_pd(1e-4));
+
+            const __m256d den = _mm256_add_pd(_mm256_mul_pd(va, g), rin);
+            const __m256d num = a == 0.0 ? _mm256_mul_pd(rout, g)
+                                         : _mm256_mul_pd(rout, _mm256_mul_pd(va, g));
+            const __m256d v = _mm256_div_pd(num, den);
+
+            const __m256d valid = _mm256_and_pd(_mm256_cmp_pd(den, zero, _CMP_GT_OQ),
+                                                _mm256_cmp_pd(rout, zero, _CMP_GT_OQ));
+            const __m256d better = _mm256_and_pd(valid, _mm256_cmp_pd(v, best_v, _CMP_GT_OQ));
+            best_v = _mm256_blendv_pd(best_v, v, better);
+            best_i = _mm256_blendv_pd(best_i, idx, better);
+            idx = _mm256_add_pd(idx, _mm256_set1_pd(4.0));
+        }
+
+        alignas(32) double vals[4];
+        alignas(32) double idxs[4];
+        _mm256_store_pd(vals, best_v);
+        _mm256_store_pd(idxs, best_i);
+        for (int lane = 0; lane < 4; ++lane) {
+            if (vals[lane] < 0.0) continue;
+            const auto lane_idx = static_cast<uint32_t>(idxs[lane]);
+            if (best.index == ArgMax::NONE || vals[lane] > best.value ||
+                (vals[lane] == best.value && lane_idx < best.index)) {
+                best.index = lane_idx;
+                best.value = vals[lane];
+            }
+        }
+    }
+#endif
+
+    return detail::argmax_scalar(reserve_in, reserve_out, fee_bps, i, n, a, best);
+}
+
+} // namespace matrix::orderbook::kernels
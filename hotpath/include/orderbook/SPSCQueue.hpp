@@ -1,10 +1,13 @@
 #pragma once
 
+#include <algorithm>
 #include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <optional>
 #include <array>
+#include <span>
+#include <utility>
 
 namespace matrix::orderbook {
 
@@ -18,18 +21,27 @@ namespace matrix::orderbook {
  *
  * Research: SPSC queues are the fastest inter-thread communication
  * mechanism. We use this for price feed → order book updates.
+ *
+ * Lamport ring with cached indices: each side keeps a private copy of the
+ * other side's index and only reloads it (one acquire) when the copy says
+ * the ring is full / empty. The bulk operations publish a whole batch with
+ * one release store.
+ *
+ * A consumer with nothing to do may park() on a futex; producers wake it
+ * when they publish. close() releases a parked consumer for shutdown.
  */
 template<typename T, size_t Capacity = 65536>
 class SPSCQueue {
     static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be power of 2");
     static constexpr size_t CACHE_LINE_SIZE = 64;
+    static constexpr size_t MASK = Capacity - 1;
 
 public:
-    SPSCQueue() : head_(0), tail_(0) {
-        for (auto& slot : buffer_) {
-            slot.sequence.store(0, std::memory_order_relaxed);
-        }
-    }
+    SPSCQueue() = default;
+
+    // ------------------------------------------------------------------------
+    // Producer side
+    // ------------------------------------------------------------------------
 
     /**
      * Push an item to the queue (producer only)
@@ -37,55 +49,147 @@ public:
      */
     template<typename U>
     [[nodiscard]] bool push(U&& item) noexcept {
-        const size_t pos = tail_.load(std::memory_order_relaxed);
-        Slot& slot = buffer_[pos & (Capacity - 1)];
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_cache_ == Capacity) {
+            head_cache_ = head_.load(std::memory_order_acquire);
+            if (tail - head_cache_ == Capacity) {
+                return false;  // Queue full
+            }
+        }
 
-        const size_t seq = slot.sequence.load(std::memory_order_acquire);
-        const intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+        buffer_[tail & MASK] = std::forward<U>(item);
+        publish(tail + 1);
+        return true;
+    }
 
-        if (diff != 0) {
-            return false;  // Queue full
+    /**
+     * Push as many items as fit, in order (producer only)
+     * @return Number of items pushed
+     */
+    [[nodiscard]] size_t push_bulk(std::span<const T> items) noexcept {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        size_t free_slots = Capacity - (tail - head_cache_);
+        if (free_slots < items.size()) {
+            head_cache_ = head_.load(std::memory_order_acquire);
+            free_slots = Capacity - (tail - head_cache_);
         }
 
-        slot.data = std::forward<U>(item);
-        slot.sequence.store(pos + 1, std::memory_order_release);
-        tail_.store(pos + 1, std::memory_order_relaxed);
-        return true;
+        const size_t count = std::min(items.size(), free_slots);
+        if (count == 0) return 0;
+
+        // At most two contiguous runs: up to the end of the ring, then from 0
+        const size_t start = tail & MASK;
+        const size_t first = std::min(count, Capacity - start);
+        std::copy_n(items.data(), first, buffer_.data() + start);
+        std::copy_n(items.data() + first, count - first, buffer_.data());
+
+        publish(tail + count);
+        return count;
     }
 
+    // ------------------------------------------------------------------------
+    // Consumer side
+    // ------------------------------------------------------------------------
+
     /**
      * Pop an item from the queue (consumer only)
      * @return The item if available, std::nullopt if queue is empty
      */
     [[nodiscard]] std::optional<T> pop() noexcept {
-        const size_t pos = head_.load(std::memory_order_relaxed);
-        Slot& slot = buffer_[pos & (Capacity - 1)];
-
-        const size_t seq = slot.sequence.load(std::memory_order_acquire);
-        const intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
-
-        if (diff != 0) {
+        T item;
+        if (!try_pop(item)) {
             return std::nullopt;  // Queue empty
         }
-
-        T item = std::move(slot.data);
-        slot.sequence.store(pos + Capacity, std::memory_order_release);
-        head_.store(pos + 1, std::memory_order_relaxed);
         return item;
     }
 
     /**
-     * Try to pop without blocking
+     * Try to pop without blocking (consumer only)
      */
     [[nodiscard]] bool try_pop(T& item) noexcept {
-        auto result = pop();
-        if (result) {
-            item = std::move(*result);
-            return true;
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_cache_) {
+            tail_cache_ = tail_.load(std::memory_order_acquire);
+            if (head == tail_cache_) {
+                return false;
+            }
+        }
+
+        item = std::move(buffer_[head & MASK]);
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Pop up to out.size() items (consumer only)
+     * @return Number of items written to out
+     */
+    [[nodiscard]] size_t pop_bulk(std::span<T> out) noexcept {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        const size_t count = available(head, out.size());
+        if (count == 0) return 0;
+
+        const size_t start = head & MASK;
+        const size_t first = std::min(count, Capacity - start);
+        std::move(buffer_.data() + start, buffer_.data() + start + first, out.data());
+        std::move(buffer_.data(), buffer_.data() + (count - first), out.data() + first);
+
+        head_.store(head + count, std::memory_order_release);
+        return count;
+    }
+
+    /**
+     * Hand up to max_items queued items to fn(T&) in place, then release
+     * their slots at once (consumer only). fn must not touch the queue.
+     * @return Number of items consumed
+     */
+    template<typename F>
+    size_t consume(F&& fn, size_t max_items = Capacity) noexcept(noexcept(fn(std::declval<T&>()))) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        const size_t count = available(head, max_items);
+
+        for (size_t i = 0; i < count; ++i) {
+            fn(buffer_[(head + i) & MASK]);
+        }
+
+        if (count != 0) {
+            head_.store(head + count, std::memory_order_release);
+        }
+        return count;
+    }
+
+    /**
+     * Sleep until the queue is non-empty or closed (consumer only)
+     *
+     * Returns immediately if either already holds; may return spuriously.
+     */
+    void park() noexcept {
+        const uint32_t signal = signal_.load(std::memory_order_acquire);
+        waiting_.store(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);  // Pairs with publish()
+
+        if (empty() && !closed_.load(std::memory_order_relaxed)) {
+            signal_.wait(signal, std::memory_order_acquire);
         }
-        return false;
+        waiting_.store(0, std::memory_order_relaxed);
+    }
+
+    // ------------------------------------------------------------------------
+    // Any thread
+    // ------------------------------------------------------------------------
+
+    /**
+     * Release a parked consumer and keep park() from blocking again
+     * (pushes and pops still work)
+     */
+    void close() noexcept {
+        closed_.store(true, std::memory_order_relaxed);
+        signal_.fetch_add(1, std::memory_order_release);
+        signal_.notify_all();
     }
 
+    [[nodiscard]] bool closed() const noexcept { return closed_.load(std::memory_order_relaxed); }
+
     /**
      * Check if queue is empty (approximate)
      */
@@ -103,20 +207,46 @@ public:
         return t >= h ? t - h : 0;
     }
 
+    [[nodiscard]] static constexpr size_t capacity() noexcept { return Capacity; }
+
 private:
-    struct Slot {
-        std::atomic<size_t> sequence;
-        T data;
-    };
+    /**
+     * Make slots below `tail` visible and wake a parked consumer
+     */
+    void publish(size_t tail) noexcept {
+        tail_.store(tail, std::memory_order_release);
+        std::atomic_thread_fence(std::memory_order_seq_cst);  // Pairs with park()
+        if (waiting_.load(std::memory_order_relaxed)) {
+            signal_.fetch_add(1, std::memory_order_release);
+            signal_.notify_one();
+        }
+    }
+
+    /**
+     * Items ready for the consumer (at most `wanted`), reloading the tail
+     * only when the cached copy has fewer than that
+     */
+    [[nodiscard]] size_t available(size_t head, size_t wanted) noexcept {
+        if (tail_cache_ - head < wanted) {
+            tail_cache_ = tail_.load(std::memory_order_acquire);
+        }
+        return std::min(wanted, tail_cache_ - head);
+    }
+
+    // Consumer line: its index plus its view of the producer's
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> head_{0};
+    size_t tail_cache_ = 0;
 
-    // Pad to prevent false sharing
-    alignas(CACHE_LINE_SIZE) std::atomic<size_t> head_;
-    char pad1_[CACHE_LINE_SIZE - sizeof(std::atomic<size_t>)];
+    // Producer line
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> tail_{0};
+    size_t head_cache_ = 0;
 
-    alignas(CACHE_LINE_SIZE) std::atomic<size_t> tail_;
-    char pad2_[CACHE_LINE_SIZE - sizeof(std::atomic<size_t>)];
+    // Parking (touched by the producer only through the waiting_ load)
+    alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> waiting_{0};
+    std::atomic<uint32_t> signal_{0};
+    std::atomic<bool> closed_{false};
 
-    std::array<Slot, Capacity> buffer_;
+    alignas(CACHE_LINE_SIZE) std::array<T, Capacity> buffer_;
 };
 
 /**
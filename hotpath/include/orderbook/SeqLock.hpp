@@ -0,0 +1,86 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+
+#include "WaitStrategy.hpp"
+
+namespace matrix::orderbook::seqlock {
+
+/**
+ * Seqlock primitives over plain sequence words
+ *
+ * One writer, any number of readers that retry instead of ever blocking
+ * it. A sequence word is even while its data is stable and odd while the
+ * writer is changing it. The words are ordinary integers accessed through
+ * std::atomic_ref, so a whole arena column of them costs 4 bytes per entry
+ * and needs no constructor.
+ *
+ * Writer:
+ *     const uint32_t s = write_begin(seq);
+ *     store(data, v);                 // Relaxed stores
+ *     write_end(seq, s);
+ *
+ * Reader:
+ *     uint32_t s;
+ *     do {
+ *         s = read_begin(seq);
+ *         v = load(data);             // Relaxed loads, may be torn
+ *     } while (read_retry(seq, s));   // ...in which case they are discarded
+ *
+ * Research: Boehm, "Can Seqlocks Get Along With Programming Language
+ * Memory Models?" (fence placement for relaxed data accesses).
+ */
+
+template<typename T>
+[[nodiscard]] inline T load(const T& field) noexcept {
+    static_assert(std::is_trivially_copyable_v<T>);
+    return std::atomic_ref<T>(const_cast<T&>(field)).load(std::memory_order_relaxed);
+}
+
+template<typename T>
+inline void store(T& field, T value) noexcept {
+    std::atomic_ref<T>(field).store(value, std::memory_order_relaxed);
+}
+
+/**
+ * Mark `seq` as being written (writer only)
+ * @return Token for write_end()
+ */
+inline uint32_t write_begin(uint32_t& seq) noexcept {
+    std::atomic_ref<uint32_t> word(seq);
+    const uint32_t odd = word.load(std::memory_order_relaxed) + 1;
+    word.store(odd, std::memory_order_relaxed);
+    // Data stores below may not be seen before the odd sequence
+    std::atomic_thread_fence(std::memory_order_release);
+    return odd;
+}
+
+inline void write_end(uint32_t& seq, uint32_t token) noexcept {
+    std::atomic_ref<uint32_t>(seq).store(token + 1, std::memory_order_release);
+}
+
+/**
+ * Wait out a write in progress
+ * @return Token for read_retry()
+ */
+[[nodiscard]] inline uint32_t read_begin(const uint32_t& seq) noexcept {
+    std::atomic_ref<uint32_t> word(const_cast<uint32_t&>(seq));
+    for (;;) {
+        const uint32_t seen = word.load(std::memory_order_acquire);
+        if ((seen & 1) == 0) return seen;
+        cpu_relax();
+    }
+}
+
+/**
+ * @return true if a write overlapped the reads since read_begin()
+ */
+[[nodiscard]] inline bool read_retry(const uint32_t& seq, uint32_t token) noexcept {
+    // Data loads above may not be satisfied after the sequence re-check
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return std::atomic_ref<uint32_t>(const_cast<uint32_t&>(seq)).load(std::memory_order_relaxed) != token;
+}
+
+} // namespace matrix::orderbook::seqlock
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "FlatHashMap.hpp"
+#include "SPSCQueue.hpp"
+
+namespace matrix::orderbook {
+
+/**
+ * Update Coalescer - last-writer-wins batch of price updates keyed by pool
+ *
+ * During bursts (block boundaries) the same pool shows up many times in
+ * one drain and only its last reserve snapshot matters. Updates are staged
+ * here in first-seen order; a repeat overwrites the staged snapshot in
+ * place, so the batch carries each pool at most once.
+ *
+ * The pool index is a small linear-probe table with epoch stamps, so
+ * clear() is O(1) instead of a memset per batch.
+ */
+template<size_t Capacity>
+class UpdateCoalescer {
+    static_assert(Capacity > 0 && Capacity <= UINT32_MAX, "Capacity must fit a uint32_t index");
+
+    // Power of two, >= 2x Capacity: load factor <= 50%
+    static constexpr size_t TABLE_SIZE = [] {
+        size_t n = 1;
+        while (n < 2 * Capacity) n <<= 1;
+        return n;
+    }();
+    static constexpr size_t TABLE_MASK = TABLE_SIZE - 1;
+
+public:
+    UpdateCoalescer() = default;
+
+    /**
+     * Stage an update, replacing any staged update for the same pool
+     * @return false if the batch is full and the pool is not staged yet
+     */
+    bool add(const PriceUpdate& update) noexcept {
+        size_t pos = mix64(update.pool_hash) & TABLE_MASK;
+        while (table_[pos].epoch == epoch_) {
+            if (table_[pos].pool_hash == update.pool_hash) {
+                updates_[table_[pos].index] = update;
+                ++conflated_;
+                return true;
+            }
+            pos = (pos + 1) & TABLE_MASK;
+        }
+
+        if (count_ == Capacity) return false;
+        table_[pos] = {update.pool_hash, static_cast<uint32_t>(count_), epoch_};
+        updates_[count_++] = update;
+        return true;
+    }
+
+    /**
+     * Staged updates, one per pool, in first-seen order
+     */
+    [[nodiscard]] std::span<const PriceUpdate> updates() const noexcept {
+        return {updates_.data(), count_};
+    }
+
+    [[nodiscard]] size_t size() const noexcept { return count_; }
+    [[nodiscard]] bool empty() const noexcept { return count_ == 0; }
+    [[nodiscard]] bool full() const noexcept { return count_ == Capacity; }
+    [[nodiscard]] static constexpr size_t capacity() noexcept { return Capacity; }
+
+    /**
+     * Updates overwritten in place since construction
+     */
+    [[nodiscard]] uint64_t conflated() const noexcept { return conflated_; }
+
+    /**
+     * Start a new batch (O(1))
+     */
+    void clear() noexcept {
+        count_ = 0;
+        if (++epoch_ == 0) {
+            // Epoch wrapped: stale stamps could alias the new epoch
+            table_.fill({});
+            epoch_ = 1;
+        }
+    }
+
+private:
+    struct Entry {
+        uint64_t pool_hash = 0;
+        uint32_t index = 0;          // Into updates_
+        uint32_t epoch = 0;          // Live iff == epoch_
+    };
+
+    std::array<PriceUpdate, Capacity> updates_{};
+    std::array<Entry, TABLE_SIZE> table_{};
+    size_t count_ = 0;
+    uint32_t epoch_ = 1;
+    uint64_t conflated_ = 0;
+};
+
+} // namespace matrix::orderbook
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstdint>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace matrix::orderbook {
+
+/**
+ * Hint to the core that we are in a spin loop (frees pipeline resources
+ * for the sibling hyperthread and avoids the memory-order exit penalty)
+ */
+inline void cpu_relax() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield" ::: "memory");
+#endif
+}
+
+/**
+ * How an idle consumer waits for its queue
+ */
+enum class WaitKind : uint8_t {
+    SPIN,       // Re-poll immediately (dedicated core, lowest latency)
+    PAUSE,      // Re-poll after a pause instruction
+    YIELD,      // Give the core to other runnable threads
+    PARK        // Spin briefly, then sleep on the queue's futex
+};
+
+/**
+ * Wait Strategy - the back-off a consumer applies between empty polls
+ *
+ * Usage: call wait(queue) each time a poll finds nothing and reset() once
+ * it finds work. Only PARK ever leaves the CPU for long; it wakes as soon
+ * as the producer publishes instead of after a fixed sleep.
+ */
+class WaitStrategy {
+public:
+    // Empty polls PARK spends spinning before it parks (~ tens of us)
+    static constexpr uint32_t PARK_SPIN_LIMIT = 2048;
+
+    constexpr explicit WaitStrategy(WaitKind kind = WaitKind::PARK) noexcept : kind_(kind) {}
+
+    void reset() noexcept { idle_polls_ = 0; }
+
+    /**
+     * Back off after an empty poll of `queue` (its consumer thread only)
+     */
+    template<typename Queue>
+    void wait(Queue& queue) noexcept {
+        if (kind_ == WaitKind::PARK && idle_polls_ >= PARK_SPIN_LIMIT) {
+            queue.park();
+            return;
+        }
+        wait();
+    }
+
+    /**
+     * Back off without a queue to park on (PARK degrades to YIELD once
+     * its spin budget is spent)
+     */
+    void wait() noexcept {
+        switch (kind_) {
+            case WaitKind::SPIN:
+                break;
+            case WaitKind::PAUSE:
+                cpu_relax();
+                break;
+            case WaitKind::YIELD:
+                std::this_thread::yield();
+                break;
+            case WaitKind::PARK:
+                if (idle_polls_ < PARK_SPIN_LIMIT) {
+                    ++idle_polls_;
+                    cpu_relax();
+                } else {
+                    std::this_thread::yield();
+                }
+                break;
+        }
+    }
+
+    [[nodiscard]] WaitKind kind() const noexcept { return kind_; }
+
+private:
+    WaitKind kind_;
+    uint32_t idle_polls_ = 0;
+};
+
+} // namespace matrix::orderbook
@@ -0,0 +1,173 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "../arbitrage/Calculator.hpp"
+#include "../orderbook/SPSCQueue.hpp"
+#include "../telemetry/Telemetry.hpp"
+#include "Pipeline.hpp"
+
+namespace matrix::runtime {
+
+enum class LogKind : uint8_t {
+    OPPORTUNITY,
+    SHARD_STATS,
+    STAGE_LATENCY
+};
+
+/**
+ * One fixed-size log entry, copied as is into the ring and the journal
+ */
+struct LogRecord {
+    uint64_t logged_ns;                  // Clock::now_ns() when logged
+    LogKind kind;
+    uint8_t reserved[3];
+    uint32_t chain;                      // ChainId (0 for STAGE_LATENCY)
+
+    struct OpportunityEntry {
+        uint64_t id;
+        uint64_t detected_ns;            // Opportunity::timestamp_ns
+        uint64_t profit_wei;
+        uint64_t flash_loan_amount;
+        uint64_t flash_loan_fee;
+        uint32_t gas_estimate;
+        uint8_t path_length;
+    };
+    struct StatsEntry {
+        uint64_t updates_processed;
+        uint64_t updates_dropped;
+        uint64_t updates_conflated;      // Conflated + coalesced
+        uint64_t scans;
+        uint64_t last_scan_ns;
+        uint32_t pool_count;
+    };
+    struct LatencyEntry {
+        uint64_t count;
+        uint64_t p50;
+        uint64_t p99;
+        uint64_t p999;
+        uint64_t max;
+        telemetry::Stage stage;
+    };
+
+    union {
+        OpportunityEntry opportunity;
+        StatsEntry stats;
+        LatencyEntry latency;
+    };
+
+    [[nodiscard]] static LogRecord from(const arbitrage::Opportunity& opp) noexcept;
+    [[nodiscard]] static LogRecord from(orderbook::ChainId chain, const ShardStats& stats) noexcept;
+    [[nodiscard]] static LogRecord from(telemetry::Stage stage,
+                                        const telemetry::LatencyHistogram::Snapshot& latency) noexcept;
+};
+
+static_assert(sizeof(LogRecord) == 64, "LogRecord should fill one cache line");
+
+struct EventLogConfig {
+    std::FILE* text = stdout;            // Formatted output, nullptr = none
+    std::string journal_path;            // Binary journal, empty = none
+    int cpu = -1;                        // CPU for the writer thread, -1 = unpinned
+};
+
+/**
+ * Event Log - asynchronous logging off the hot path
+ *
+ * The logging thread copies a 64-byte record into an SPSC ring and moves
+ * on: no formatting, no locks, no system calls. A writer thread drains the
+ * ring every FLUSH_INTERVAL, formats each record as a text line and
+ * appends it raw to an optional binary journal that replay() reads back.
+ *
+ * The writer polls instead of parking on the ring, so a record never costs
+ * the producer a futex wake. A full ring drops the record (counted) rather
+ * than stall the caller.
+ */
+class EventLog {
+public:
+    static constexpr size_t CAPACITY = 16384;
+    static constexpr auto FLUSH_INTERVAL = std::chrono::milliseconds(1);
+
+    /**
+     * Start the writer thread
+     * @throws std::runtime_error if the journal cannot be opened
+     */
+    explicit EventLog(EventLogConfig config = {});
+    ~EventLog();
+
+    EventLog(const EventLog&) = delete;
+    EventLog& operator=(const EventLog&) = delete;
+
+    /**
+     * Queue one record (single producer: one thread only)
+     * @return false if the ring is full (the record is dropped)
+     */
+    bool log(const LogRecord& record) noexcept;
+
+    template<typename... Args>
+    bool log(const Args&... args) noexcept { return log(LogRecord::from(args...)); }
+
+    /**
+     * Write out everything queued so far and join the writer (idempotent)
+     */
+    void stop() noexcept;
+
+    [[nodiscard]] uint64_t written() const noexcept { return written_.load(std::memory_order_relaxed); }
+    [[nodiscard]] uint64_t dropped() const noexcept { return dropped_.load(std::memory_order_relaxed); }
+
+    /**
+     * Format one record as a text line (no trailing newline)
+     * @return Characters written, truncated to size - 1
+     */
+    static size_t format(const LogRecord& record, char* out, size_t size) noexcept;
+
+    /**
+     * Hand every record of a journal to fn(const LogRecord&), in order
+     * @return Records read, or -1 if the file is missing or not a journal
+     */
+    template<typename F>
+    static int64_t replay(const std::string& path, F&& fn);
+
+private:
+    using Ring = orderbook::SPSCQueue<LogRecord, CAPACITY>;
+
+    void run() noexcept;
+    size_t drain() noexcept;
+
+    [[nodiscard]] static bool read_header(std::FILE* file) noexcept;
+
+    EventLogConfig config_;
+    std::unique_ptr<Ring> ring_;
+    std::FILE* journal_ = nullptr;
+    std::atomic<bool> running_{true};
+    std::atomic<uint64_t> written_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::thread writer_;
+};
+
+template<typename F>
+int64_t EventLog::replay(const std::string& path, F&& fn) {
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) return -1;
+    if (!read_header(file)) {
+        std::fclose(file);
+        return -1;
+    }
+
+    int64_t count = 0;
+    LogRecord record;
+    while (std::fread(&record, sizeof(record), 1, file) == 1) {
+        fn(static_cast<const LogRecord&>(record));
+        ++count;
+    }
+    std::fclose(file);
+    return count;
+}
+
+} // namespace matrix::runtime
@@ -0,0 +1,192 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <latch>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../arbitrage/Calculator.hpp"
+#include "../memory/Arena.hpp"
+#include "../orderbook/BookSnapshot.hpp"
+#include "../orderbook/MPMCQueue.hpp"
+#include "../orderbook/OrderBook.hpp"
+#include "../orderbook/SPSCQueue.hpp"
+#include "../orderbook/UpdateCoalescer.hpp"
+#include "../orderbook/WaitStrategy.hpp"
+
+namespace matrix::runtime {
+
+/**
+ * Pin the calling thread to one CPU
+ * @return false if the CPU does not exist or pinning is unsupported
+ */
+bool pin_current_thread(int cpu) noexcept;
+
+/**
+ * One chain's slice of the pipeline
+ */
+struct ShardConfig {
+    orderbook::ChainId chain;
+    int cpu = -1;                                    // CPU to pin to, -1 = unpinned
+    size_t arena_bytes = memory::Arena::DEFAULT_SIZE;
+    memory::ArenaOptions arena_options{};            // Huge pages / prefault for the shard arena
+    std::string snapshot_path{};                     // Book snapshot to warm start from and refresh, empty = none
+    uint32_t snapshot_interval_ms = 10'000;          // Between background snapshots (0 = only on stop)
+};
+
+struct PipelineConfig {
+    std::vector<ShardConfig> shards;
+    int router_cpu = -1;                             // CPU for the feed router, -1 = unpinned
+    orderbook::WaitKind wait = orderbook::WaitKind::PARK;  // How idle router / shard threads wait
+};
+
+/**
+ * Counters a shard publishes for other threads (relaxed, monitoring only)
+ */
+struct ShardStats {
+    uint64_t updates_processed;
+    uint64_t updates_dropped;                        // Router found the shard queue full
+    uint64_t updates_conflated;                      // Superseded within one router batch
+    uint64_t updates_coalesced;                      // Superseded within one scan batch (in the book)
+    uint64_t scans;
+    uint64_t opportunities;                          // Found by scans
+    uint64_t opportunities_dropped;                  // Output queue full
+    uint64_t last_scan_ns;
+    size_t pool_count;
+    size_t restored_pools;                           // Loaded from the snapshot at start
+    uint64_t snapshots_written;
+    bool pinned;                                     // Running on config.cpu
+};
+
+/**
+ * Pipeline - per-chain scan runtime
+ *
+ * Every chain gets its own shard: an OrderBook, a Calculator and a thread,
+ * optionally pinned to a dedicated CPU, fed by its own SPSC queue. A router
+ * thread drains the multi-producer feed queue and demuxes updates by
+ * chain_id, so a deep pool set on one chain never delays scans on another.
+ *
+ * Shard state is constructed on the shard's own thread after pinning, so
+ * the arena and cycle index pages are first touched on that CPU.
+ * Opportunities come back through one SPSC queue per shard, drained by the
+ * thread that owns the Pipeline.
+ *
+ * The router conflates repeated updates of a pool within its batch (last
+ * writer wins), so a burst reaches the shard as one snapshot per pool. A
+ * shard that cannot keep up drops updates (counted) instead of stalling
+ * the router and with it every other chain.
+ */
+class Pipeline {
+public:
+    using ShardQueue = orderbook::PriceQueue;
+    using OpportunityQueue = orderbook::SPSCQueue<arbitrage::Opportunity, 1024>;
+
+    explicit Pipeline(PipelineConfig config);
+    ~Pipeline();
+
+    Pipeline(const Pipeline&) = delete;
+    Pipeline& operator=(const Pipeline&) = delete;
+
+    /**
+     * Start the shard threads and a router draining `feed`, the queue the
+     * price sources push into (the router is its only consumer)
+     * Blocks until every shard has built its order book; rethrows if a
+     * shard failed to (e.g. arena allocation). A pipeline starts once;
+     * stop() closes `feed` to release a parked router.
+     */
+    void start(orderbook::PriceFeedQueue& feed);
+
+    /**
+     * Start the shard threads only; updates are fed through route()
+     */
+    void start();
+
+    /**
+     * Stop and join all threads (idempotent)
+     */
+    void stop() noexcept;
+
+    /**
+     * Forward one update to its chain's shard (single producer: call from
+     * one thread, and not while a router thread is running)
+     * @return false if no shard serves the chain or its queue is full
+     */
+    bool route(const orderbook::PriceUpdate& update) noexcept;
+
+    /**
+     * Hand every queued opportunity to `sink` (owner thread only)
+     * @return Number of opportunities drained
+     */
+    template<typename Sink>
+    size_t drain_opportunities(Sink&& sink) {
+        size_t drained = 0;
+        for (auto& shard : shards_) {
+            drained += shard->opportunities.consume([&](const arbitrage::Opportunity& opp) { sink(opp); });
+        }
+        return drained;
+    }
+
+    [[nodiscard]] size_t shard_count() const noexcept { return shards_.size(); }
+    [[nodiscard]] const ShardConfig& shard_config(size_t index) const noexcept {
+        return shards_[index]->config;
+    }
+    [[nodiscard]] ShardStats shard_stats(size_t index) const noexcept;
+
+    /**
+     * Updates whose chain has no shard
+     */
+    [[nodiscard]] uint64_t unrouted_updates() const noexcept {
+        return unrouted_.load(std::memory_order_relaxed);
+    }
+
+    [[nodiscard]] bool running() const noexcept { return running_.load(std::memory_order_acquire); }
+
+private:
+    // Feed updates the router coalesces per shard before one bulk push
+    static constexpr size_t ROUTER_BATCH = 256;
+
+    struct Shard {
+        ShardConfig config;
+        ShardQueue input;
+        OpportunityQueue opportunities;
+
+        std::atomic<uint64_t> updates_processed{0};
+        std::atomic<uint64_t> updates_dropped{0};
+        std::atomic<uint64_t> updates_conflated{0};
+        std::atomic<uint64_t> updates_coalesced{0};
+        std::atomic<uint64_t> scans{0};
+        std::atomic<uint64_t> found{0};
+        std::atomic<uint64_t> opportunities_dropped{0};
+        std::atomic<uint64_t> last_scan_ns{0};
+        std::atomic<size_t> pool_count{0};
+        std::atomic<size_t> restored_pools{0};
+        std::atomic<uint64_t> snapshots_written{0};
+        std::atomic<bool> pinned{false};
+
+        std::exception_ptr startup_error;    // Written before the ready count-down
+        orderbook::UpdateCoalescer<ROUTER_BATCH> staged;  // Router thread only
+        std::thread thread;
+    };
+
+    [[nodiscard]] Shard* shard_for(uint32_t chain_id) noexcept;
+
+    void launch_shards();
+    void run_shard(Shard& shard);
+    void run_router(orderbook::PriceFeedQueue& feed);
+
+    PipelineConfig config_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+    std::unique_ptr<std::latch> ready_;      // Shards built; outlives the threads
+    std::thread router_;
+    orderbook::PriceFeedQueue* feed_ = nullptr;
+    bool started_ = false;
+    std::atomic<bool> running_{false};
+    std::atomic<uint64_t> unrouted_{0};
+};
+
+} // namespace matrix::runtime
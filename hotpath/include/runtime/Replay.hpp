@@ -0,0 +1,147 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "../arbitrage/Calculator.hpp"
+#include "../memory/Arena.hpp"
+#include "../orderbook/OrderBook.hpp"
+#include "../orderbook/SPSCQueue.hpp"
+#include "../telemetry/Telemetry.hpp"
+#include "../tx/Composer.hpp"
+
+namespace matrix::runtime {
+
+// ============================================================================
+// Feed traces
+// ============================================================================
+
+/**
+ * Write a PriceUpdate stream as a feed trace: a 16-byte header, then the
+ * raw updates in arrival order
+ * @return false if the file could not be written
+ */
+bool save_trace(const std::string& path, std::span<const orderbook::PriceUpdate> updates);
+
+/**
+ * Read a feed trace written by save_trace()
+ * @throws std::runtime_error if the file is missing or not a trace
+ */
+[[nodiscard]] std::vector<orderbook::PriceUpdate> load_trace(const std::string& path);
+
+/**
+ * Block-boundary bursts on one chain: every pool is seeded in the first
+ * block, then each block re-prices a random subset of them back to back
+ * (the shape of a feed right after a block lands). Pools connect the
+ * chain's base token and `tokens` others; re-pricing drifts each pool
+ * around a shared token price, so some cycles open and close.
+ * The same config always yields the same trace.
+ */
+struct SyntheticTraceConfig {
+    orderbook::ChainId chain = orderbook::ChainId::ETHEREUM;
+    uint64_t base_token = arbitrage::WETH_MAINNET;
+    size_t tokens = 24;                       // Non-base tokens
+    size_t pools = 256;
+    size_t blocks = 64;
+    size_t updates_per_block = 96;
+    uint64_t block_interval_ns = 250'000'000;
+    uint64_t update_spacing_ns = 2'000;       // Within a burst
+    uint64_t start_ns = 1'700'000'000'000'000'000ULL;
+    uint64_t seed = 1;
+};
+
+/**
+ * @throws std::invalid_argument for fewer than two tokens or no pools
+ */
+[[nodiscard]] std::vector<orderbook::PriceUpdate> synthesize_trace(const SyntheticTraceConfig& config);
+
+// ============================================================================
+// Replay harness
+// ============================================================================
+
+struct ReplayConfig {
+    double speed = 0.0;                       // 0 = as fast as possible, 1 = recorded pace, 2 = twice that
+    size_t batch = 256;                       // Most updates pushed and scanned at once
+    uint64_t block_gap_ns = 1'000'000;        // A larger timestamp gap starts a new batch
+    size_t arena_bytes = memory::Arena::DEFAULT_SIZE;
+    uint64_t gas_price_gwei = 50;             // Opportunities profitable at this price are composed
+    tx::ComposerConfig composer{};
+    std::optional<std::array<uint8_t, 32>> signing_key;   // Also sign every composed transaction
+};
+
+struct ReplayReport {
+    uint64_t updates = 0;
+    uint64_t batches = 0;
+    uint64_t opportunities = 0;               // Kept by scans
+    uint64_t transactions = 0;                // Composed (and signed, if a key is set)
+    uint64_t wall_ns = 0;
+    uint64_t checksum = 0;                    // Over opportunities and calldata; equal for equal runs
+
+    [[nodiscard]] double updates_per_second() const noexcept {
+        return wall_ns == 0 ? 0.0 : static_cast<double>(updates) * 1e9 / static_cast<double>(wall_ns);
+    }
+};
+
+/**
+ * Replay Harness - pumps a feed trace through the hot path on one thread
+ *
+ * Each batch goes PriceQueue -> OrderBook -> Calculator::scan_incremental
+ * -> Composer (-> Signer), the same steps a shard takes, with every stage
+ * timed into the harness's own histograms. Batches are cut from the trace
+ * by count and timestamp gap only, so the work done (and the checksum)
+ * does not depend on the replay speed or the machine.
+ *
+ * State persists across run() calls: replaying a trace again re-prices
+ * the pools the first run created.
+ */
+class ReplayHarness {
+public:
+    /**
+     * @throws std::bad_alloc if the arena cannot be mapped
+     * @throws std::invalid_argument for a zero batch or an invalid signing key
+     */
+    explicit ReplayHarness(ReplayConfig config = {});
+    ~ReplayHarness();
+
+    ReplayHarness(const ReplayHarness&) = delete;
+    ReplayHarness& operator=(const ReplayHarness&) = delete;
+
+    ReplayReport run(std::span<const orderbook::PriceUpdate> trace);
+
+    /**
+     * Per-stage latency since construction (QUEUE_PUSH, BOOK_UPDATE, SCAN,
+     * COMPOSE, SIGN) and batch arrival -> last transaction built
+     */
+    void snapshot(telemetry::Snapshot& stages, telemetry::LatencyHistogram::Snapshot& end_to_end) const noexcept;
+
+    [[nodiscard]] const orderbook::OrderBook& book() const noexcept { return *book_; }
+
+private:
+    struct Histograms {
+        std::array<telemetry::LatencyHistogram, telemetry::STAGE_COUNT> stages;
+        telemetry::LatencyHistogram end_to_end;
+    };
+
+    void record(telemetry::Stage stage, uint64_t start_ticks) noexcept;
+    void pace(uint64_t offset_ns, uint64_t wall_start) const noexcept;
+    size_t compose_batch(uint64_t& checksum);
+
+    ReplayConfig config_;
+    std::unique_ptr<memory::Arena> arena_;
+    std::unique_ptr<orderbook::OrderBook> book_;
+    std::unique_ptr<arbitrage::Calculator> calculator_;
+    std::unique_ptr<arbitrage::OpportunityBuffer> opportunities_;
+    std::unique_ptr<orderbook::PriceQueue> queue_;
+    tx::Composer composer_;
+    std::unique_ptr<tx::Signer> signer_;
+    std::unique_ptr<Histograms> histograms_;
+    std::array<uint8_t, 4096> calldata_{};
+};
+
+} // namespace matrix::runtime
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace matrix::runtime {
+
+/**
+ * Work-Stealing Pool - fork/join over a batch of independent tasks
+ *
+ * run(n, fn) deals task indices [0, n) out as one contiguous range per
+ * worker. A worker pops tasks off the front of its own range; once it is
+ * empty it steals the back half of another worker's range, so a few
+ * expensive tasks (e.g. a hub token's first edges) spread over every
+ * core instead of stalling one of them. Ranges are single packed words
+ * updated by CAS: no locks and no allocation per run.
+ *
+ * The calling thread is worker 0 and run() returns once every task has
+ * finished, so a pool of one worker runs everything inline. Helper
+ * threads park on a futex between runs.
+ */
+class WorkStealingPool {
+public:
+    static constexpr size_t MAX_WORKERS = 64;
+
+    /**
+     * @param workers Threads working on a run, the caller included
+     * @throws std::invalid_argument for 0 or more than MAX_WORKERS workers
+     */
+    explicit WorkStealingPool(size_t workers);
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    /**
+     * Call fn(worker, task) once for every task in [0, tasks), on any
+     * worker; blocks until all calls have returned. One run at a time.
+     * fn must not throw.
+     */
+    template<typename F>
+    void run(size_t tasks, F&& fn) noexcept {
+        using Fn = std::remove_reference_t<F>;
+        dispatch(tasks, [](void* ctx, size_t worker, size_t task) noexcept {
+            (*static_cast<Fn*>(ctx))(worker, task);
+        }, const_cast<void*>(static_cast<const void*>(&fn)));
+    }
+
+    [[nodiscard]] size_t workers() const noexcept { return workers_; }
+
+    /**
+     * Ranges taken from another worker (cumulative)
+     */
+    [[nodiscard]] uint64_t steals() const noexcept { return steals_.load(std::memory_order_relaxed); }
+
+private:
+    using TaskFn = void (*)(void* ctx, size_t worker, size_t task) noexcept;
+
+    // [begin, end) of a worker's remaining tasks, begin in the high half
+    struct alignas(64) Range {
+        std::atomic<uint64_t> bounds{0};
+    };
+
+    void dispatch(size_t tasks, TaskFn fn, void* ctx) noexcept;
+    void work(size_t worker) noexcept;
+    [[nodiscard]] bool take(size_t worker, uint32_t& task) noexcept;
+    void helper_main(size_t worker) noexcept;
+    void stop() noexcept;
+
+    size_t workers_;
+    std::unique_ptr<Range[]> ranges_;
+    TaskFn fn_ = nullptr;
+    void* ctx_ = nullptr;
+
+    std::atomic<uint32_t> generation_{0};    // Futex word: bumped per run / on shutdown
+    std::atomic<uint32_t> active_{0};        // Futex word: helpers still in the current run
+    std::atomic<bool> running_{true};
+    std::atomic<uint64_t> steals_{0};
+    std::vector<std::thread> helpers_;
+};
+
+} // namespace matrix::runtime
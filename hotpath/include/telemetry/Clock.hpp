@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace matrix::telemetry {
+
+/**
+ * Clock - TSC timestamps calibrated to CLOCK_REALTIME nanoseconds
+ *
+ * ticks() is a single rdtsc, cheap enough to stamp every pipeline stage
+ * (clock_gettime through the vDSO costs several times more). Ticks become
+ * nanoseconds with one 128-bit multiply and shift against a calibration
+ * taken once per process. now_ns() is anchored to CLOCK_REALTIME, so it
+ * compares directly with kernel receive timestamps (SO_TIMESTAMPNS) and
+ * PriceUpdate stamps.
+ *
+ * Assumes an invariant TSC (constant rate, synchronized across cores), as
+ * on any current x86-64 server. Elsewhere ticks() is CLOCK_REALTIME itself.
+ */
+class Clock {
+public:
+    [[nodiscard]] static uint64_t ticks() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return realtime_ns();
+#endif
+    }
+
+    /**
+     * Convert a tick count (a duration) to nanoseconds
+     */
+    [[nodiscard]] static uint64_t to_ns(uint64_t ticks) noexcept;
+
+    [[nodiscard]] static uint64_t elapsed_ns(uint64_t start_ticks) noexcept {
+        return to_ns(ticks() - start_ticks);
+    }
+
+    /**
+     * Realtime nanoseconds since the epoch, from the TSC
+     */
+    [[nodiscard]] static uint64_t now_ns() noexcept;
+
+    /**
+     * CLOCK_REALTIME via clock_gettime (the slow reference)
+     */
+    [[nodiscard]] static uint64_t realtime_ns() noexcept;
+
+    /**
+     * Calibrate now (~10 ms busy wait) instead of on first use; call at
+     * startup, off the hot path
+     */
+    static void calibrate() noexcept;
+
+    [[nodiscard]] static double ticks_per_ns() noexcept;
+};
+
+} // namespace matrix::telemetry
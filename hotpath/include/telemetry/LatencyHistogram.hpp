@@ -0,0 +1,121 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+namespace matrix::telemetry {
+
+/**
+ * Latency Histogram - log-linear (HDR-style) histogram of nanoseconds
+ *
+ * Values below 2^SUB_BITS get a bucket each; above that every power of two
+ * is split into 2^SUB_BITS linear sub-buckets, so a bucket is never wider
+ * than 1/32 of its values (~3% worst-case error) from 1 ns up to ~68 s, in
+ * 1024 counters. record() is a count-leading-zeros, a shift, two plain
+ * increments and a max.
+ *
+ * Single writer: record() only from the owning thread. Counters are relaxed
+ * atomics written with load + store (no locked instructions), so any
+ * thread may read a snapshot while the owner records.
+ */
+class LatencyHistogram {
+public:
+    static constexpr unsigned SUB_BITS = 5;
+    static constexpr unsigned MAX_BITS = 36;
+    static constexpr uint64_t MAX_VALUE = (uint64_t{1} << MAX_BITS) - 1;   // Larger values clamp here
+    static constexpr size_t BUCKETS = size_t{MAX_BITS - SUB_BITS + 1} << SUB_BITS;
+
+    [[nodiscard]] static constexpr size_t bucket_of(uint64_t value) noexcept {
+        value = std::min(value, MAX_VALUE);
+        if (value < (uint64_t{1} << SUB_BITS)) return static_cast<size_t>(value);
+        const unsigned shift = static_cast<unsigned>(std::bit_width(value)) - 1 - SUB_BITS;
+        return (size_t{shift + 1} << SUB_BITS) | static_cast<size_t>((value >> shift) & ((1u << SUB_BITS) - 1));
+    }
+
+    /**
+     * Smallest and largest value that land in a bucket
+     */
+    [[nodiscard]] static constexpr uint64_t bucket_lower(size_t bucket) noexcept {
+        if (bucket < (size_t{1} << SUB_BITS)) return bucket;
+        const unsigned shift = static_cast<unsigned>(bucket >> SUB_BITS) - 1;
+        return (uint64_t{(1u << SUB_BITS) | (bucket & ((1u << SUB_BITS) - 1))}) << shift;
+    }
+    [[nodiscard]] static constexpr uint64_t bucket_upper(size_t bucket) noexcept {
+        if (bucket < (size_t{1} << SUB_BITS)) return bucket;
+        const unsigned shift = static_cast<unsigned>(bucket >> SUB_BITS) - 1;
+        return bucket_lower(bucket) + (uint64_t{1} << shift) - 1;
+    }
+
+    void record(uint64_t ns) noexcept {
+        bump(counts_[bucket_of(ns)], 1);
+        bump(sum_, ns);
+        if (ns > max_.load(std::memory_order_relaxed)) max_.store(ns, std::memory_order_relaxed);
+    }
+
+    /**
+     * Copyable view of a histogram; merge() several to aggregate threads
+     */
+    struct Snapshot {
+        std::array<uint64_t, BUCKETS> counts{};
+        uint64_t count = 0;
+        uint64_t sum = 0;
+        uint64_t max = 0;
+
+        void merge(const Snapshot& other) noexcept {
+            for (size_t i = 0; i < BUCKETS; ++i) counts[i] += other.counts[i];
+            count += other.count;
+            sum += other.sum;
+            max = std::max(max, other.max);
+        }
+
+        /**
+         * Value at quantile q in [0, 1]: upper bound of the bucket holding
+         * that rank (never above the recorded max), 0 when empty
+         */
+        [[nodiscard]] uint64_t percentile(double q) const noexcept {
+            if (count == 0) return 0;
+            const double clamped = std::clamp(q, 0.0, 1.0);
+            const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(clamped * static_cast<double>(count) + 0.5));
+            uint64_t seen = 0;
+            for (size_t i = 0; i < BUCKETS; ++i) {
+                seen += counts[i];
+                if (seen >= rank) return std::min(bucket_upper(i), max);
+            }
+            return max;
+        }
+
+        [[nodiscard]] double mean() const noexcept {
+            return count == 0 ? 0.0 : static_cast<double>(sum) / static_cast<double>(count);
+        }
+    };
+
+    /**
+     * Add this histogram's counters into `out` (any thread)
+     */
+    void add_to(Snapshot& out) const noexcept {
+        uint64_t bucket_total = 0;
+        for (size_t i = 0; i < BUCKETS; ++i) {
+            const uint64_t n = counts_[i].load(std::memory_order_relaxed);
+            out.counts[i] += n;
+            bucket_total += n;
+        }
+        out.count += bucket_total;     // Consistent with the buckets read
+        out.sum += sum_.load(std::memory_order_relaxed);
+        out.max = std::max(out.max, max_.load(std::memory_order_relaxed));
+    }
+
+private:
+    static void bump(std::atomic<uint64_t>& counter, uint64_t by) noexcept {
+        counter.store(counter.load(std::memory_order_relaxed) + by, std::memory_order_relaxed);
+    }
+
+    std::array<std::atomic<uint64_t>, BUCKETS> counts_{};
+    std::atomic<uint64_t> sum_{0};
+    std::atomic<uint64_t> max_{0};
+};
+
+} // namespace matrix::telemetry
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "Clock.hpp"
+#include "LatencyHistogram.hpp"
+
+namespace matrix::telemetry {
+
+/**
+ * Instrumented hot-path stages
+ */
+enum class Stage : uint8_t {
+    FEED_RECEIVE,       // Kernel receive timestamp -> WebSocket message delivered
+    QUEUE_PUSH,         // Age of the newest update in a batch the router hands to a shard
+    QUEUE_POP,          // Age of the newest update in a batch a shard applies
+    BOOK_UPDATE,        // Applying one batch to the order book
+    SCAN,               // One Calculator scan
+    COMPOSE,            // Building one arbitrage transaction
+    SIGN,               // One ECDSA signature
+    COUNT
+};
+
+inline constexpr size_t STAGE_COUNT = static_cast<size_t>(Stage::COUNT);
+
+[[nodiscard]] const char* stage_name(Stage stage) noexcept;
+
+/**
+ * Recorder - one thread's histograms, one per stage
+ */
+class Recorder {
+public:
+    void record(Stage stage, uint64_t ns) noexcept { histograms_[static_cast<size_t>(stage)].record(ns); }
+
+    [[nodiscard]] const LatencyHistogram& histogram(Stage stage) const noexcept {
+        return histograms_[static_cast<size_t>(stage)];
+    }
+
+private:
+    std::array<LatencyHistogram, STAGE_COUNT> histograms_{};
+};
+
+/**
+ * Per-thread recorders live in a fixed process-wide registry
+ */
+inline constexpr size_t MAX_THREADS = 128;
+
+/**
+ * The calling thread's recorder, claimed from the registry on first use
+ * @return nullptr once MAX_THREADS threads hold one (recording is dropped)
+ */
+[[nodiscard]] Recorder* thread_recorder() noexcept;
+
+inline void record(Stage stage, uint64_t ns) noexcept {
+    if (Recorder* recorder = thread_recorder()) recorder->record(stage, ns);
+}
+
+/**
+ * Record how long ago a realtime stamp was taken (0 = no stamp)
+ */
+inline void record_age(Stage stage, uint64_t stamp_ns) noexcept {
+    if (stamp_ns == 0) return;
+    const uint64_t now = Clock::now_ns();
+    record(stage, now > stamp_ns ? now - stamp_ns : 0);
+}
+
+/**
+ * Stage Timer - records its scope's duration
+ *
+ *     { telemetry::StageTimer timer(telemetry::Stage::SIGN); ... }
+ */
+class StageTimer {
+public:
+    explicit StageTimer(Stage stage) noexcept : stage_(stage), start_(Clock::ticks()) {}
+    ~StageTimer() { record(stage_, Clock::elapsed_ns(start_)); }
+
+    StageTimer(const StageTimer&) = delete;
+    StageTimer& operator=(const StageTimer&) = delete;
+
+private:
+    Stage stage_;
+    uint64_t start_;
+};
+
+using Snapshot = std::array<LatencyHistogram::Snapshot, STAGE_COUNT>;
+
+/**
+ * Merge every thread's histograms, per stage (any thread, off the hot
+ * path: reads ~60 KiB per registered thread)
+ */
+void snapshot(Snapshot& out) noexcept;
+
+[[nodiscard]] size_t registered_threads() noexcept;
+
+/**
+ * Prometheus text exposition of a snapshot: one summary per stage,
+ * matrix_hotpath_stage_latency_ns{stage=...,quantile="0.5|0.99|0.999"}
+ */
+[[nodiscard]] std::string render_prometheus(const Snapshot& snapshot);
+
+/**
+ * Write render_prometheus() for node_exporter's textfile collector
+ * (temporary file + rename, so a scrape never sees a partial file)
+ * @return false if the file could not be written
+ */
+bool write_prometheus_file(const std::string& path, const Snapshot& snapshot);
+
+} // namespace matrix::telemetry
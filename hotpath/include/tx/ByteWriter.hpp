@@ -0,0 +1,98 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <span>
+
+#include "../memory/Arena.hpp"
+
+namespace matrix::tx {
+
+/**
+ * Byte Writer - append-only view over a caller-provided byte buffer
+ *
+ * The composer never owns memory: callers hand it a buffer (usually carved
+ * once from an Arena) and the encoders claim exact-sized ranges from it.
+ * Every encoder sizes its output first and claims it in one go, so a
+ * buffer that is too small fails cleanly instead of leaving half a
+ * transaction behind.
+ */
+class ByteWriter {
+public:
+    ByteWriter(uint8_t* data, size_t capacity) noexcept
+        : data_(data)
+        , capacity_(capacity) {}
+
+    /**
+     * @throws std::bad_alloc if the arena cannot hold `capacity` bytes
+     */
+    ByteWriter(memory::Arena& arena, size_t capacity)
+        : data_(static_cast<uint8_t*>(arena.allocate(capacity)))
+        , capacity_(capacity) {
+        if (!data_) throw std::bad_alloc();
+    }
+
+    /**
+     * Claim the next `n` bytes
+     * @return Start of the range, nullptr if it does not fit (nothing claimed)
+     */
+    [[nodiscard]] uint8_t* claim(size_t n) noexcept {
+        if (n > capacity_ - size_) return nullptr;
+        uint8_t* p = data_ + size_;
+        size_ += n;
+        return p;
+    }
+
+    /**
+     * Bytes written since `mark` (a previous size())
+     */
+    [[nodiscard]] std::span<const uint8_t> since(size_t mark) const noexcept {
+        return {data_ + mark, size_ - mark};
+    }
+
+    [[nodiscard]] std::span<const uint8_t> bytes() const noexcept { return {data_, size_}; }
+    [[nodiscard]] uint8_t* data() noexcept { return data_; }
+    [[nodiscard]] size_t size() const noexcept { return size_; }
+    [[nodiscard]] size_t capacity() const noexcept { return capacity_; }
+    [[nodiscard]] size_t remaining() const noexcept { return capacity_ - size_; }
+
+    /**
+     * Drop everything after `size` bytes
+     */
+    void truncate(size_t size) noexcept { size_ = size < size_ ? size : size_; }
+    void clear() noexcept { size_ = 0; }
+
+private:
+    uint8_t* data_;
+    size_t capacity_;
+    size_t size_ = 0;
+};
+
+// ============================================================================
+// ABI word stores (32-byte big-endian slots)
+// ============================================================================
+
+namespace abi {
+
+inline constexpr size_t WORD = 32;
+
+[[nodiscard]] constexpr size_t padded(size_t n) noexcept {
+    return (n + WORD - 1) / WORD * WORD;
+}
+
+inline void store_u64(uint8_t* word, uint64_t value) noexcept {
+    std::memset(word, 0, WORD - 8);
+    for (int i = 0; i < 8; ++i) word[WORD - 1 - i] = static_cast<uint8_t>(value >> (8 * i));
+}
+
+inline void store_address(uint8_t* word, const std::array<uint8_t, 20>& address) noexcept {
+    std::memset(word, 0, WORD - 20);
+    std::memcpy(word + WORD - 20, address.data(), 20);
+}
+
+} // namespace abi
+
+} // namespace matrix::tx
@@ -2,8 +2,13 @@
 
 #include <cstdint>
 #include <array>
-#include <vector>
-#include <string>
+#include <optional>
+#include <span>
+
+#include "ByteWriter.hpp"
+#include "Keccak.hpp"
+#include "Secp256k1.hpp"
+#include "../orderbook/OrderBook.hpp"
 
 namespace matrix::tx {
 
@@ -16,25 +21,36 @@ enum class TxType : uint8_t {
     EIP1559 = 2   // Dynamic fee
 };
 
+/**
+ * Access list entry (EIP-2930)
+ */
+struct AccessListEntry {
+    std::array<uint8_t, 20> address;
+    std::span<const std::array<uint8_t, 32>> storage_keys;
+};
+
 /**
  * Raw Transaction Data
+ *
+ * A view: calldata and access list point into caller-owned memory (the
+ * ByteWriter the composer encoded into), so building one never allocates.
  */
 struct RawTransaction {
     TxType type = TxType::EIP1559;
     uint64_t chain_id = 1;
     uint64_t nonce = 0;
     uint64_t max_priority_fee_per_gas = 0;
-    uint64_t max_fee_per_gas = 0;
+    uint64_t max_fee_per_gas = 0;         // Also the gas price of LEGACY/EIP2930
     uint64_t gas_limit = 0;
-    std::array<uint8_t, 20> to;
+    std::array<uint8_t, 20> to{};
     uint64_t value = 0;
-    std::vector<uint8_t> data;
-    std::vector<std::pair<std::array<uint8_t, 20>, std::vector<std::array<uint8_t, 32>>>> access_list;
+    std::span<const uint8_t> data;
+    std::span<const AccessListEntry> access_list;
 
-    // Signature
+    // Signature; v is the y parity (0/1), LEGACY encoding derives EIP-155 v
     uint8_t v = 0;
-    std::array<uint8_t, 32> r;
-    std::array<uint8_t, 32> s;
+    std::array<uint8_t, 32> r{};
+    std::array<uint8_t, 32> s{};
 };
 
 /**
@@ -43,7 +59,6 @@ struct RawTransaction {
 struct FlashLoanParams {
     std::array<uint8_t, 20> asset;        // Token to borrow
     uint64_t amount;                       // Amount to borrow
-    std::vector<uint8_t> callback_data;   // Data for callback
 };
 
 /**
@@ -55,6 +70,17 @@ struct SwapParams {
     std::array<uint8_t, 20> token_out;    // Output token
     uint64_t amount_in;                    // Input amount
     uint64_t min_amount_out;              // Minimum output (slippage protection)
+    uint32_t fee = 3000;                   // V3 fee tier (hundredths of a bip)
+    orderbook::DexId dex = orderbook::DexId::UNISWAP_V3;   // Router the hop is encoded for
+};
+
+/**
+ * Composer configuration - the fixed parties of every arbitrage transaction
+ */
+struct ComposerConfig {
+    uint64_t chain_id = 1;
+    std::array<uint8_t, 20> flash_loan_pool{};    // Aave V3 Pool (transaction target)
+    std::array<uint8_t, 20> executor{};           // Our flash loan receiver / swap recipient
 };
 
 /**
@@ -64,99 +90,209 @@ struct SwapParams {
  * Uses direct byte manipulation instead of ABI encoding libraries
  * for maximum performance.
  *
- * Performance target: <100us per transaction composition
+ * Every encoder writes into a caller-provided ByteWriter and returns the
+ * bytes it wrote (empty if they did not fit); nothing allocates. ABI calls
+ * are copied from templates built at construction (selector, executor,
+ * constant words) and only the variable words are patched. RLP list
+ * headers are sized in a pre-pass, so every byte is written once.
+ *
+ * Performance target: <5us per transaction composition
  */
 class Composer {
 public:
-    Composer();
+    explicit Composer(const ComposerConfig& config = {});
 
     /**
-     * Compose a flash loan arbitrage transaction
+     * Compose a flash loan arbitrage transaction: flashLoanSimple on the
+     * Aave pool whose callback params are a multicall of exactInputSingle
+     * swaps, one per entry of `swaps`
      * @param flash_loan Flash loan parameters
-     * @param swaps Vector of swaps to execute
+     * @param swaps Swaps to execute, in order
      * @param gas_limit Maximum gas to use
      * @param max_priority_fee Priority fee in wei
      * @param max_fee Maximum fee in wei
-     * @return Raw transaction ready for signing
+     * @param calldata Receives the calldata the returned transaction views
+     * @param deadline Unix time the swaps must execute by (multicall with
+     *        deadline); 0 = no deadline
+     * @return Unsigned transaction; nullopt if swaps is empty or calldata
+     *         is too small
      */
-    [[nodiscard]] RawTransaction compose_arbitrage(
+    [[nodiscard]] std::optional<RawTransaction> compose_arbitrage(
         const FlashLoanParams& flash_loan,
-        const std::vector<SwapParams>& swaps,
+        std::span<const SwapParams> swaps,
+        uint64_t gas_limit,
+        uint64_t max_priority_fee,
+        uint64_t max_fee,
+        ByteWriter& calldata,
+        uint64_t deadline = 0
+    ) const noexcept;
+
+    /**
+     * Transaction fields of an arbitrage whose calldata is already encoded
+     */
+    [[nodiscard]] RawTransaction arbitrage_transaction(
+        std::span<const uint8_t> calldata,
         uint64_t gas_limit,
         uint64_t max_priority_fee,
         uint64_t max_fee
-    ) const;
+    ) const noexcept;
 
     /**
-     * Encode transaction to RLP bytes
+     * Encode the signed transaction (EIP-2718 envelope for typed types)
      */
-    [[nodiscard]] std::vector<uint8_t> encode_rlp(const RawTransaction& tx) const;
+    std::span<const uint8_t> encode_rlp(const RawTransaction& tx, ByteWriter& out) const noexcept;
 
     /**
-     * Calculate transaction hash (for signing)
+     * Encode the signing preimage (EIP-155 fields for LEGACY)
      */
-    [[nodiscard]] std::array<uint8_t, 32> hash_for_signing(const RawTransaction& tx) const;
+    std::span<const uint8_t> encode_signing_payload(const RawTransaction& tx, ByteWriter& out) const noexcept;
+
+    /**
+     * Size of encode_signing_payload(tx)
+     */
+    [[nodiscard]] static size_t signing_payload_bytes(const RawTransaction& tx) noexcept;
+
+    /**
+     * Calculate transaction hash (for signing): keccak256 of the signing
+     * payload, encoded on the stack (heap only past 4 KiB of payload)
+     */
+    [[nodiscard]] Hash256 hash_for_signing(const RawTransaction& tx) const;
 
     /**
      * Encode Aave V3 flashLoanSimple call
      */
-    [[nodiscard]] std::vector<uint8_t> encode_aave_flash_loan(
+    std::span<const uint8_t> encode_aave_flash_loan(
         const std::array<uint8_t, 20>& receiver,
         const std::array<uint8_t, 20>& asset,
         uint64_t amount,
-        const std::vector<uint8_t>& params
-    ) const;
+        std::span<const uint8_t> params,
+        ByteWriter& out
+    ) const noexcept;
 
     /**
-     * Encode Uniswap V3 exactInputSingle call
+     * Encode Uniswap V3 (SwapRouter02) exactInputSingle call, recipient =
+     * executor
      */
-    [[nodiscard]] std::vector<uint8_t> encode_uniswap_swap(
+    std::span<const uint8_t> encode_uniswap_swap(
         const std::array<uint8_t, 20>& token_in,
         const std::array<uint8_t, 20>& token_out,
         uint32_t fee,
         uint64_t amount_in,
-        uint64_t amount_out_min
-    ) const;
+        uint64_t amount_out_min,
+        ByteWriter& out
+    ) const noexcept;
 
     /**
      * Encode multicall for batching multiple operations
+     * @param deadline Non-zero selects multicall(uint256 deadline, bytes[])
      */
-    [[nodiscard]] std::vector<uint8_t> encode_multicall(
-        const std::vector<std::vector<uint8_t>>& calls
-    ) const;
+    std::span<const uint8_t> encode_multicall(
+        std::span<const std::span<const uint8_t>> calls,
+        ByteWriter& out,
+        uint64_t deadline = 0
+    ) const noexcept;
+
+    [[nodiscard]] const ComposerConfig& config() const noexcept { return config_; }
+
+    // Calldata sizes of the fixed-shape calls
+    static constexpr size_t SWAP_CALL_BYTES = 4 + 7 * abi::WORD;
+    static constexpr size_t FLASH_LOAN_HEAD_BYTES = 4 + 6 * abi::WORD;   // Up to the params payload
+
+    [[nodiscard]] static constexpr size_t multicall_head_bytes(bool deadline) noexcept {
+        return 4 + (deadline ? 3 : 2) * abi::WORD;   // Selector, [deadline], offset, length
+    }
+
+    [[nodiscard]] static constexpr size_t multicall_bytes(size_t calls, size_t padded_call_bytes,
+                                                          bool deadline = false) noexcept {
+        return multicall_head_bytes(deadline) + calls * (2 * abi::WORD + padded_call_bytes);
+    }
+
+    [[nodiscard]] static constexpr size_t arbitrage_calldata_bytes(size_t swaps, bool deadline = false) noexcept {
+        return FLASH_LOAN_HEAD_BYTES + abi::padded(multicall_bytes(swaps, abi::padded(SWAP_CALL_BYTES), deadline));
+    }
+
+    // Where the variable words of arbitrage calldata live (byte offsets)
+    static constexpr size_t FLASH_LOAN_AMOUNT_OFFSET = 4 + 2 * abi::WORD;
+    static constexpr size_t DEADLINE_OFFSET = FLASH_LOAN_HEAD_BYTES + 4;
+    static constexpr size_t SWAP_AMOUNT_IN_WORD = 4;           // Words into an exactInputSingle call
+    static constexpr size_t SWAP_MIN_OUT_WORD = 5;
+
+    [[nodiscard]] static constexpr size_t swap_call_offset(size_t swaps, size_t i, bool deadline = false) noexcept {
+        constexpr size_t call_slot = abi::WORD + abi::padded(SWAP_CALL_BYTES);   // Length word + padded call
+        return FLASH_LOAN_HEAD_BYTES + multicall_head_bytes(deadline) + swaps * abi::WORD + i * call_slot + abi::WORD;
+    }
+
+    [[nodiscard]] static constexpr size_t swap_word_offset(size_t swaps, size_t i, size_t word,
+                                                           bool deadline = false) noexcept {
+        return swap_call_offset(swaps, i, deadline) + 4 + word * abi::WORD;
+    }
 
 private:
     // Function selectors (precomputed keccak256 hashes)
     static constexpr std::array<uint8_t, 4> FLASH_LOAN_SIMPLE_SELECTOR = {0x42, 0xb0, 0xb7, 0x7c};
     static constexpr std::array<uint8_t, 4> EXACT_INPUT_SINGLE_SELECTOR = {0x04, 0xe4, 0x5a, 0xaf};
     static constexpr std::array<uint8_t, 4> MULTICALL_SELECTOR = {0xac, 0x96, 0x50, 0xd8};
+    static constexpr std::array<uint8_t, 4> MULTICALL_DEADLINE_SELECTOR = {0x5a, 0xe4, 0x01, 0xdc};
+
+    // Field-by-field writers over a pre-sized range
+    void write_swap(uint8_t* out, const std::array<uint8_t, 20>& token_in, const std::array<uint8_t, 20>& token_out,
+                    uint32_t fee, uint64_t amount_in, uint64_t amount_out_min) const noexcept;
+    void write_flash_loan_head(uint8_t* out, const std::array<uint8_t, 20>& receiver,
+                               const std::array<uint8_t, 20>& asset, uint64_t amount,
+                               size_t params_bytes) const noexcept;
+
+    static uint8_t* write_multicall_head(uint8_t* out, size_t calls, uint64_t deadline) noexcept;
 
-    // RLP encoding helpers
-    [[nodiscard]] std::vector<uint8_t> rlp_encode_uint(uint64_t value) const;
-    [[nodiscard]] std::vector<uint8_t> rlp_encode_bytes(const std::vector<uint8_t>& data) const;
-    [[nodiscard]] std::vector<uint8_t> rlp_encode_list(const std::vector<std::vector<uint8_t>>& items) const;
+    struct FieldSizes {
+        size_t payload;     // RLP list payload
+        size_t total;       // Including list header and type byte
+    };
+    static FieldSizes field_sizes(const RawTransaction& tx, bool with_signature) noexcept;
+
+    std::span<const uint8_t> encode_fields(const RawTransaction& tx, bool with_signature, ByteWriter& out) const noexcept;
+
+    ComposerConfig config_;
+    std::array<uint8_t, SWAP_CALL_BYTES> swap_template_{};
+    std::array<uint8_t, FLASH_LOAN_HEAD_BYTES> flash_loan_template_{};
 };
 
 /**
  * Transaction Signer - Signs transactions with private key
  *
- * Uses secp256k1 for ECDSA signing.
+ * Uses secp256k1 for ECDSA signing. The precomputed generator table is
+ * the process-wide secp256k1::Context, built once and shared, so a Signer
+ * is cheap to construct and signing does no per-call setup.
  */
 class Signer {
 public:
+    /**
+     * @throws std::invalid_argument if the key is zero or not below the curve order
+     */
     explicit Signer(const std::array<uint8_t, 32>& private_key);
 
     /**
-     * Sign a transaction
+     * Sign a transaction (fills v, r, s)
      */
     void sign(RawTransaction& tx) const;
 
+    /**
+     * Sign a precomputed hash_for_signing
+     */
+    [[nodiscard]] secp256k1::Signature sign_hash(const Hash256& hash) const noexcept;
+
+    /**
+     * Store a signature into a transaction
+     */
+    static void apply(const secp256k1::Signature& signature, RawTransaction& tx) noexcept;
+
     /**
      * Get the public address
      */
     [[nodiscard]] std::array<uint8_t, 20> address() const;
 
 private:
+    const secp256k1::Context& context_;
+    Composer encoder_;
     std::array<uint8_t, 32> private_key_;
     std::array<uint8_t, 20> address_;
 };
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace matrix::tx {
+
+using Hash256 = std::array<uint8_t, 32>;
+
+/**
+ * Keccak-f[1600] permutation (24 rounds) over a 5x5 lane state
+ */
+void keccak_f1600(uint64_t (&state)[25]) noexcept;
+
+/**
+ * Keccak-256 as used by Ethereum (original 0x01 padding, not SHA3-256)
+ */
+[[nodiscard]] Hash256 keccak256(std::span<const uint8_t> data) noexcept;
+
+/**
+ * Four independent Keccak-256 hashes in one pass
+ *
+ * With AVX2 the four states are interleaved one per 64-bit lane, so a
+ * single permutation advances all of them; inputs of different lengths
+ * finish at different blocks and are read out as they do. Without AVX2
+ * this is four scalar hashes.
+ */
+void keccak256_x4(const std::array<std::span<const uint8_t>, 4>& inputs,
+                  std::array<Hash256, 4>& out) noexcept;
+
+} // namespace matrix::tx
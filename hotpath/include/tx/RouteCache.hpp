@@ -0,0 +1,116 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+
+#include "Composer.hpp"
+#include "../memory/Arena.hpp"
+#include "../orderbook/FlatHashMap.hpp"
+
+namespace matrix::tx {
+
+struct RouteCacheStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;        // Template compiled
+    uint64_t uncached = 0;      // Composed directly: route too long, cache full or key collision
+};
+
+/**
+ * Route Cache - precompiled arbitrage calldata per route
+ *
+ * Between two opportunities on the same route only the amounts, min-outs
+ * and deadline change; selectors, offsets, tokens, fee tiers and the
+ * executor are identical. The first composition of a route (chain, pool
+ * sequence, DEX types, borrowed asset) is encoded by the Composer into a
+ * template, together with the byte offsets of its variable words; every
+ * later one is a memcpy of the template plus a few 32-byte patches.
+ *
+ * The hash key covers the chain, pools, DEX types and asset; the full
+ * route (tokens and fee tiers included) is compared on a hit, so a key
+ * collision falls back to direct composition instead of wrong calldata.
+ * Output is byte-identical to Composer::compose_arbitrage.
+ *
+ * Templates are carved from the Arena at construction and never evicted.
+ * Not thread-safe; one cache per composing thread.
+ */
+class RouteCache {
+public:
+    static constexpr size_t MAX_HOPS = 4;   // Same as arbitrage::Opportunity::MAX_HOPS
+    static constexpr size_t DEFAULT_MAX_ROUTES = 4096;
+
+    /**
+     * @param composer Encodes templates; must outlive the cache
+     * @throws std::bad_alloc if the arena cannot hold `max_routes` templates
+     */
+    RouteCache(const Composer& composer, memory::Arena& arena, size_t max_routes = DEFAULT_MAX_ROUTES);
+
+    RouteCache(const RouteCache&) = delete;
+    RouteCache& operator=(const RouteCache&) = delete;
+
+    /**
+     * Same contract as Composer::compose_arbitrage
+     */
+    [[nodiscard]] std::optional<RawTransaction> compose_arbitrage(
+        const FlashLoanParams& flash_loan,
+        std::span<const SwapParams> swaps,
+        uint64_t gas_limit,
+        uint64_t max_priority_fee,
+        uint64_t max_fee,
+        ByteWriter& calldata,
+        uint64_t deadline = 0
+    ) noexcept;
+
+    [[nodiscard]] const RouteCacheStats& stats() const noexcept { return stats_; }
+    [[nodiscard]] size_t size() const noexcept { return size_; }
+    [[nodiscard]] size_t max_routes() const noexcept { return max_routes_; }
+
+private:
+    // Everything baked into a template
+    struct Hop {
+        std::array<uint8_t, 20> pool;
+        std::array<uint8_t, 20> token_in;
+        std::array<uint8_t, 20> token_out;
+        uint32_t fee;
+        orderbook::DexId dex;
+    };
+
+    struct Route {
+        uint64_t chain_id;
+        std::array<uint8_t, 20> asset;
+        uint32_t hops;
+        bool deadline;              // multicall with deadline
+        std::array<Hop, MAX_HOPS> hop;
+    };
+
+    static constexpr size_t MAX_CALLDATA_BYTES = Composer::arbitrage_calldata_bytes(MAX_HOPS, true);
+
+    struct alignas(64) Template {
+        Route route;
+        uint16_t size;
+        uint16_t deadline_offset;   // 0 = no deadline word
+        uint16_t amount_offset;     // Flash loan amount
+        std::array<uint16_t, MAX_HOPS> amount_in_offsets;
+        std::array<uint16_t, MAX_HOPS> min_out_offsets;
+        alignas(64) uint8_t bytes[MAX_CALLDATA_BYTES];
+    };
+
+    static uint64_t route_key(uint64_t chain_id, const FlashLoanParams& flash_loan,
+                              std::span<const SwapParams> swaps, bool deadline) noexcept;
+    static bool matches(const Route& route, const FlashLoanParams& flash_loan,
+                        std::span<const SwapParams> swaps, bool deadline) noexcept;
+
+    const Template* compile(uint64_t key, const FlashLoanParams& flash_loan,
+                            std::span<const SwapParams> swaps, uint64_t deadline) noexcept;
+
+    const Composer& composer_;
+    orderbook::FlatHashMap<uint64_t, uint32_t, orderbook::U64Hash> index_;
+    Template* templates_;
+    size_t max_routes_;
+    size_t size_ = 0;
+    RouteCacheStats stats_;
+};
+
+} // namespace matrix::tx
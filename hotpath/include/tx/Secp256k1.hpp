@@ -0,0 +1,71 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace matrix::tx::secp256k1 {
+
+using Scalar = std::array<uint8_t, 32>;     // Big-endian
+
+struct Signature {
+    std::array<uint8_t, 32> r;
+    std::array<uint8_t, 32> s;              // Low-s (EIP-2)
+    uint8_t v;                              // y parity of R
+};
+
+/**
+ * secp256k1 Context - precomputed generator table, built once per process
+ *
+ * k*G is 64 additions of table entries j * 16^i * G (64 windows x 16
+ * entries, 64 KiB), with no doublings at sign time. Every entry of a
+ * window is read and masked in, and the complete projective addition law
+ * (Renes-Costello-Batina) has no identity/doubling branches, so neither
+ * timing nor memory access depends on the key or nonce. Inversions are
+ * fixed exponentiations. Nonces are RFC 6979 (HMAC-SHA256), so signatures
+ * are deterministic and match other Ethereum signers byte for byte.
+ *
+ * Read-only after construction; shared by every Signer on every thread.
+ */
+class Context {
+public:
+    static constexpr size_t WINDOWS = 64;
+    static constexpr size_t ENTRIES = 16;
+
+    /**
+     * Process-wide context (built on first use, thread-safe)
+     */
+    [[nodiscard]] static const Context& instance();
+
+    /**
+     * True if 0 < key < n
+     */
+    [[nodiscard]] static bool valid_private_key(const Scalar& key) noexcept;
+
+    /**
+     * Uncompressed public key X || Y (no 0x04 prefix)
+     * @pre valid_private_key(key)
+     */
+    [[nodiscard]] std::array<uint8_t, 64> public_key(const Scalar& key) const noexcept;
+
+    /**
+     * ECDSA signature of a 32-byte message hash
+     * @pre valid_private_key(key)
+     */
+    [[nodiscard]] Signature sign(const Scalar& key, const std::array<uint8_t, 32>& hash) const noexcept;
+
+    Context(const Context&) = delete;
+    Context& operator=(const Context&) = delete;
+
+private:
+    Context();
+
+    struct AffinePoint {
+        uint64_t x[4];          // Little-endian limbs; entry 0 of a window is (0, 1), the identity
+        uint64_t y[4];
+    };
+
+    std::array<std::array<AffinePoint, ENTRIES>, WINDOWS> table_;
+};
+
+} // namespace matrix::tx::secp256k1
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "Composer.hpp"
+
+namespace matrix::tx {
+
+/**
+ * Speculative Signer - signs the top-K candidates while the winner is picked
+ *
+ * ECDSA is the long pole between detecting an opportunity and sending it,
+ * so it is started before the final profitability check. start() hashes
+ * every candidate's signing payload (four at a time with keccak256_x4) and
+ * hands the signing to the worker threads; the caller runs its last check
+ * and then calls wait(winner), which helps sign whatever is still queued
+ * until the winner's signature is in. Losers are signed and dropped.
+ *
+ * One round in flight at a time; start(), wait() and finish() are called
+ * from one owner thread. Idle workers spin briefly, then sleep on a futex.
+ */
+class SpeculativeSigner {
+public:
+    static constexpr size_t MAX_CANDIDATES = 16;
+    static constexpr size_t DEFAULT_SCRATCH_BYTES = 64 * 1024;   // Signing payloads of one round
+
+    /**
+     * @param signer Must outlive this object
+     * @param workers Signing threads besides the owner (0: wait() signs everything)
+     */
+    SpeculativeSigner(const Signer& signer, size_t workers, size_t scratch_bytes = DEFAULT_SCRATCH_BYTES);
+    ~SpeculativeSigner();
+
+    SpeculativeSigner(const SpeculativeSigner&) = delete;
+    SpeculativeSigner& operator=(const SpeculativeSigner&) = delete;
+
+    /**
+     * Begin signing `candidates` in place (finishes any previous round first).
+     * The candidates must stay put and unread until wait()/finish().
+     * @return false (nothing started) if there are more than MAX_CANDIDATES
+     *         or their payloads do not fit the scratch buffer
+     */
+    bool start(std::span<RawTransaction> candidates) noexcept;
+
+    /**
+     * Block until candidates[index] of the current round is signed
+     */
+    const RawTransaction& wait(size_t index) noexcept;
+
+    /**
+     * Block until every candidate of the current round is signed
+     */
+    void finish() noexcept;
+
+    [[nodiscard]] size_t workers() const noexcept { return threads_.size(); }
+
+private:
+    // ticket_ = round << 16 | count << 8 | next index
+    static constexpr uint64_t ROUND_SHIFT = 16;
+
+    void worker_loop() noexcept;
+    bool sign_next(uint32_t round) noexcept;
+
+    const Signer& signer_;
+    Composer encoder_;
+    std::unique_ptr<uint8_t[]> scratch_;
+    size_t scratch_bytes_;
+
+    RawTransaction* candidates_ = nullptr;
+    std::array<Hash256, MAX_CANDIDATES> hashes_{};
+    std::array<std::atomic<uint32_t>, MAX_CANDIDATES> done_{};
+    std::atomic<uint32_t> pending_{0};
+    std::atomic<uint64_t> ticket_{0};
+    std::atomic<uint32_t> round_{0};              // 32-bit: waited on directly as a futex
+    std::atomic<bool> stop_{false};
+    std::vector<std::thread> threads_;
+};
+
+} // namespace matrix::tx
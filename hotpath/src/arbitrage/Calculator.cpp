@@ -1,166 +1,289 @@
 #include "arbitrage/Calculator.hpp"
 #include <algorithm>
-#include <chrono>
+#include <cmath>
+#include <stdexcept>
+
+#include "telemetry/Telemetry.hpp"
 
 namespace matrix::arbitrage {
 
 using namespace orderbook;
 
-Calculator::Calculator(const OrderBook& orderbook) : orderbook_(orderbook) {
-    token_graph_.reserve(10000);
+OpportunityBuffer::OpportunityBuffer(size_t capacity, std::pmr::memory_resource* resource)
+    : items_(resource)
+    , capacity_(capacity) {
+    items_.reserve(capacity);
 }
 
-std::vector<Opportunity> Calculator::scan(std::optional<ChainId> chain) noexcept {
-    auto start = std::chrono::high_resolution_clock::now();
+namespace {
 
-    build_graph();
+// Heap order with the least profitable opportunity on top
+bool more_profitable(const Opportunity& a, const Opportunity& b) noexcept {
+    return a.profit_wei > b.profit_wei;
+}
 
-    std::vector<Opportunity> opportunities;
-    opportunities.reserve(MAX_OPPORTUNITIES);
+} // namespace
 
-    // Scan for triangular arbitrage on each chain
-    std::array<ChainId, 5> chains = {
-        ChainId::ETHEREUM,
-        ChainId::ARBITRUM,
-        ChainId::OPTIMISM,
-        ChainId::BASE,
-        ChainId::BSC
-    };
+bool OpportunityBuffer::offer(const Opportunity& opp) noexcept {
+    if (items_.size() < capacity_) {
+        items_.push_back(opp);  // Within the reserved capacity
+        return true;
+    }
+
+    ++discarded_;
+    if (capacity_ == 0) return false;
+    if (!heap_) {
+        std::make_heap(items_.begin(), items_.end(), more_profitable);
+        heap_ = true;
+    }
+    if (opp.profit_wei <= items_.front().profit_wei) return false;
 
-    for (auto c : chains) {
-        if (chain.has_value() && chain.value() != c) continue;
-
-        // Use major base tokens for each chain
-        uint64_t base_token = 0;
-        switch (c) {
-            case ChainId::ETHEREUM:
-                base_token = WETH_MAINNET;
-                break;
-            case ChainId::ARBITRUM:
-                base_token = WETH_ARBITRUM;
-                break;
-            case ChainId::BASE:
-                base_token = WETH_BASE;
-                break;
-            default:
-                continue;
+    std::pop_heap(items_.begin(), items_.end(), more_profitable);
+    items_.back() = opp;
+    std::push_heap(items_.begin(), items_.end(), more_profitable);
+    return true;
+}
+
+void OpportunityBuffer::finish() noexcept {
+    // At most capacity() entries, whatever the number offered
+    if (heap_) {
+        std::sort_heap(items_.begin(), items_.end(), more_profitable);
+        heap_ = false;
+    } else {
+        std::sort(items_.begin(), items_.end(), more_profitable);
+    }
+}
+
+Calculator::Calculator(const OrderBook& orderbook, CalculatorConfig config)
+    : orderbook_(orderbook)
+    , bases_(std::move(config.bases))
+    , results_(MAX_OPPORTUNITIES) {
+    if (config.scan_threads == 0) {
+        throw std::invalid_argument("Calculator: scan_threads must be at least 1");
+    }
+    if (config.scan_threads > 1) {
+        workers_ = std::make_unique<runtime::WorkStealingPool>(config.scan_threads);
+        worker_results_.reserve(config.scan_threads);
+        for (size_t w = 0; w < config.scan_threads; ++w) {
+            worker_results_.push_back(std::make_unique<OpportunityBuffer>(MAX_OPPORTUNITIES));
         }
+    }
+    for (const BaseToken& base : bases_) {
+        const bool known = std::any_of(detectors_.begin(), detectors_.end(),
+            [&](const NegativeCycleDetector& d) { return d.chain() == base.chain; });
+        if (!known) detectors_.emplace_back(base.chain, config.relax_passes);
+    }
+}
 
-        auto chain_opps = scan_triangular(c, base_token);
-        opportunities.insert(opportunities.end(), chain_opps.begin(), chain_opps.end());
+void Calculator::scan(OpportunityBuffer& out, std::optional<ChainId> chain) noexcept {
+    const uint64_t start = telemetry::Clock::ticks();
+
+    build_graph();
+    out.clear();
+    detected_ns_ = telemetry::Clock::now_ns();
+
+    // One task per first edge out of each base token (grows to the
+    // largest scan once, then reused)
+    tasks_.clear();
+    for (const BaseToken& base : bases_) {
+        if (chain.has_value() && chain.value() != base.chain) continue;
+        const uint32_t base_id = orderbook_.token_id(base.token_hash);
+        if (base_id == OrderBook::INVALID_INDEX) continue;
+        for (const Edge& first : graph_.edges(base_id)) {
+            if (orderbook_.pool_chain(first.pool_id) == base.chain) {
+                tasks_.push_back({base_id, base.chain, first});
+            }
+        }
     }
 
-    // Sort by profit (descending)
-    std::sort(opportunities.begin(), opportunities.end(),
-        [](const Opportunity& a, const Opportunity& b) {
-            return a.profit_wei > b.profit_wei;
+    const auto run_task = [this](const ScanTask& task, OpportunityBuffer& sink, uint64_t& sequence) {
+        Cycle partial{};
+        partial.chain = task.chain;
+        partial.tokens[0] = task.base;
+        partial.tokens[1] = task.first.to;
+        partial.pool_ids[0] = task.first.pool_id;
+        find_cycles(partial, 1, sink, sequence);
+    };
+
+    if (!workers_) {
+        for (const ScanTask& task : tasks_) run_task(task, out, sequence_);
+    } else {
+        for (auto& results : worker_results_) results->clear();
+        workers_->run(tasks_.size(), [&](size_t worker, size_t task) noexcept {
+            uint64_t unused = 0;   // Ids are assigned in the merge
+            run_task(tasks_[task], *worker_results_[worker], unused);
         });
 
-    // Limit results
-    if (opportunities.size() > MAX_OPPORTUNITIES) {
-        opportunities.resize(MAX_OPPORTUNITIES);
+        // Merge the per-worker top-K; only these survivors are copied
+        for (const auto& results : worker_results_) {
+            for (Opportunity opp : *results) {
+                opp.id = scan_count_ * 1000000 + sequence_++;
+                out.offer(opp);
+            }
+        }
     }
 
-    auto end = std::chrono::high_resolution_clock::now();
-    last_scan_ns_ = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
-    scan_count_++;
-    opportunity_count_ += opportunities.size();
+    finish_scan(out, start);
+}
 
-    return opportunities;
+std::vector<Opportunity> Calculator::scan(std::optional<ChainId> chain) noexcept {
+    scan(results_, chain);
+    return {results_.begin(), results_.end()};
 }
 
-std::vector<Opportunity> Calculator::scan_triangular(ChainId chain, uint64_t base_token) noexcept {
-    std::vector<Opportunity> opportunities;
-
-    auto it = token_graph_.find(base_token);
-    if (it == token_graph_.end()) return opportunities;
-
-    const auto& base_node = it->second;
-
-    // For each token connected to base
-    for (size_t i = 0; i < base_node.connected_tokens.size(); ++i) {
-        uint64_t token_a = base_node.connected_tokens[i];
-
-        auto it_a = token_graph_.find(token_a);
-        if (it_a == token_graph_.end()) continue;
-
-        const auto& node_a = it_a->second;
-
-        // For each token connected to token_a
-        for (size_t j = 0; j < node_a.connected_tokens.size(); ++j) {
-            uint64_t token_b = node_a.connected_tokens[j];
-            if (token_b == base_token) continue;
-
-            // Check if token_b connects back to base
-            auto it_b = token_graph_.find(token_b);
-            if (it_b == token_graph_.end()) continue;
-
-            const auto& node_b = it_b->second;
-            bool connects_to_base = std::find(
-                node_b.connected_tokens.begin(),
-                node_b.connected_tokens.end(),
-                base_token
-            ) != node_b.connected_tokens.end();
-
-            if (!connects_to_base) continue;
-
-            // Found a triangular path: base -> A -> B -> base
-            // TODO: Calculate actual profit with optimal amounts
-            Opportunity opp{};
-            opp.id = scan_count_ * 1000000 + opportunities.size();
-            opp.timestamp_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
-                std::chrono::high_resolution_clock::now().time_since_epoch()
-            ).count();
-            opp.chain = chain;
-            opp.path_length = 3;
-            opp.flash_loan_token = base_token;
-            opp.flash_loan_amount = 1'000'000'000'000'000'000ULL;  // 1 ETH
-            opp.flash_loan_fee = 500'000'000'000'000ULL;  // 0.0005 ETH (Aave fee)
-            opp.gas_estimate = 500000;
-
-            // Simplified profit calculation (placeholder)
-            opp.profit_wei = 0;  // Will be calculated by simulate_path
-
-            opportunities.push_back(opp);
+void Calculator::scan_incremental(std::span<const uint32_t> dirty_pools, OpportunityBuffer& out) noexcept {
+    const uint64_t start = telemetry::Clock::ticks();
+
+    build_graph();
+    out.clear();
+    detected_ns_ = telemetry::Clock::now_ns();
+
+    // A cycle through several dirty pools is evaluated once
+    cycle_mark_.resize(cycles_.cycle_count(), 0);
+    if (++cycle_epoch_ == 0) {
+        std::fill(cycle_mark_.begin(), cycle_mark_.end(), 0u);
+        cycle_epoch_ = 1;
+    }
+
+    for (const uint32_t pool_id : dirty_pools) {
+        for (const uint32_t cycle_id : cycles_.cycles_of(pool_id)) {
+            if (cycle_mark_[cycle_id] == cycle_epoch_) continue;
+            cycle_mark_[cycle_id] = cycle_epoch_;
+
+            if (auto opp = evaluate_cycle(cycles_.cycle(cycle_id), sequence_++)) {
+                out.offer(*opp);
+            }
         }
     }
 
-    return opportunities;
+    finish_scan(out, start);
 }
 
-uint64_t Calculator::optimize_amount(
-    const std::array<Opportunity::Hop, 4>& path,
-    uint8_t path_length,
-    uint64_t max_input
-) const noexcept {
-    // Binary search for optimal input amount
-    uint64_t low = 0;
-    uint64_t high = max_input;
-    uint64_t best_amount = 0;
-    int64_t best_profit = 0;
+std::vector<Opportunity> Calculator::scan_incremental(std::span<const uint32_t> dirty_pools) noexcept {
+    scan_incremental(dirty_pools, results_);
+    return {results_.begin(), results_.end()};
+}
 
-    while (low <= high) {
-        uint64_t mid = low + (high - low) / 2;
-        uint64_t output = simulate_path(path, path_length, mid);
-        int64_t profit = static_cast<int64_t>(output) - static_cast<int64_t>(mid);
+void Calculator::scan_negative_cycles(OpportunityBuffer& out, std::optional<ChainId> chain) noexcept {
+    const uint64_t start = telemetry::Clock::ticks();
 
-        if (profit > best_profit) {
-            best_profit = profit;
-            best_amount = mid;
+    build_graph();
+    out.clear();
+    detected_ns_ = telemetry::Clock::now_ns();
+
+    for (NegativeCycleDetector& detector : detectors_) {
+        if (chain.has_value() && chain.value() != detector.chain()) continue;
+
+        // Column rebuilds only happen when the topology changed
+        const size_t found = detector.detect(orderbook_, graph_);
+        negative_cycles_ += found;
+        for (size_t c = 0; c < found; ++c) {
+            if (!offer_detected(detector, c, out)) ++unroutable_cycles_;
         }
+    }
 
-        // Adjust search range
-        uint64_t output_high = simulate_path(path, path_length, mid + 1);
-        int64_t profit_high = static_cast<int64_t>(output_high) - static_cast<int64_t>(mid + 1);
+    finish_scan(out, start);
+}
+
+std::vector<Opportunity> Calculator::scan_negative_cycles(std::optional<ChainId> chain) noexcept {
+    scan_negative_cycles(results_, chain);
+    return {results_.begin(), results_.end()};
+}
 
-        if (profit_high > profit) {
-            low = mid + 1;
-        } else {
-            high = mid - 1;
+bool Calculator::offer_detected(
+    const NegativeCycleDetector& detector,
+    size_t cycle,
+    OpportunityBuffer& opportunities
+) noexcept {
+    const std::span<const CycleEdge> edges = detector.cycle(cycle);
+    if (edges.size() < 3 || edges.size() > Cycle::MAX_HOPS) return false;
+
+    bool routed = false;
+    for (const BaseToken& base : bases_) {
+        if (base.chain != detector.chain()) continue;
+        const uint32_t base_id = orderbook_.token_id(base.token_hash);
+
+        // A simple cycle passes a token at most once
+        const auto at = std::find_if(edges.begin(), edges.end(),
+            [&](const CycleEdge& e) { return e.from == base_id; });
+        if (at == edges.end()) continue;
+        routed = true;
+
+        Cycle rotated{};
+        rotated.chain = detector.chain();
+        rotated.length = static_cast<uint8_t>(edges.size());
+        const auto offset = static_cast<size_t>(at - edges.begin());
+        for (size_t h = 0; h < edges.size(); ++h) {
+            const CycleEdge& e = edges[(offset + h) % edges.size()];
+            rotated.pool_ids[h] = e.pool_id;
+            rotated.tokens[h] = e.from;
+        }
+        rotated.tokens[rotated.length] = base_id;
+
+        // Sized on the exact curves: the marginal rates only proved the
+        // cycle profitable for an infinitesimal input
+        if (auto opp = evaluate_cycle(rotated, sequence_++)) {
+            opportunities.offer(*opp);
         }
     }
+    return routed;
+}
 
-    return best_amount;
+void Calculator::scan_triangular(ChainId chain, uint64_t base_token, OpportunityBuffer& out) noexcept {
+    build_graph();  // No-op unless pools were created since the last sync
+    detected_ns_ = telemetry::Clock::now_ns();
+
+    const uint32_t base = orderbook_.token_id(base_token);
+    if (base == OrderBook::INVALID_INDEX) return;
+
+    const auto on_chain = [&](const Edge& e) {
+        return orderbook_.pool_chain(e.pool_id) == chain;
+    };
+
+    Cycle cycle{};
+    cycle.length = 3;
+    cycle.chain = chain;
+    cycle.tokens[0] = base;
+    cycle.tokens[3] = base;
+
+    // base -> A -> B -> base, one pool per hop
+    for (const Edge& first : graph_.edges(base)) {
+        if (!on_chain(first)) continue;
+        cycle.tokens[1] = first.to;
+        cycle.pool_ids[0] = first.pool_id;
+
+        for (const Edge& second : graph_.edges(first.to)) {
+            if (second.to == base || !on_chain(second)) continue;
+            cycle.tokens[2] = second.to;
+            cycle.pool_ids[1] = second.pool_id;
+
+            for (const Edge& third : graph_.edges(second.to)) {
+                if (third.to != base || !on_chain(third)) continue;
+                cycle.pool_ids[2] = third.pool_id;
+
+                // Found a triangular path: base -> A -> B -> base
+                if (auto opp = evaluate_cycle(cycle, sequence_++)) {
+                    out.offer(*opp);
+                }
+            }
+        }
+    }
+}
+
+std::vector<Opportunity> Calculator::scan_triangular(ChainId chain, uint64_t base_token) noexcept {
+    results_.clear();
+    scan_triangular(chain, base_token, results_);
+    return {results_.begin(), results_.end()};
+}
+
+uint64_t Calculator::optimize_amount(
+    const std::array<Opportunity::Hop, 4>& path,
+    uint8_t path_length,
+    uint64_t max_input
+) const noexcept {
+    const auto resolved = resolve_path(path, path_length);
+    if (!resolved) return 0;
+    return optimal_input(*resolved, max_input);
 }
 
 uint64_t Calculator::simulate_path(
@@ -168,65 +291,278 @@ uint64_t Calculator::simulate_path(
     uint8_t path_length,
     uint64_t input_amount
 ) const noexcept {
+    const auto resolved = resolve_path(path, path_length);
+    if (!resolved) return 0;
+    return simulate(*resolved, input_amount);
+}
+
+std::optional<Calculator::ResolvedPath> Calculator::resolve_path(
+    const std::array<Opportunity::Hop, 4>& path,
+    uint8_t path_length
+) const noexcept {
+    ResolvedPath resolved;
+    resolved.length = std::min<uint8_t>(path_length, Opportunity::MAX_HOPS);
+
+    for (uint8_t i = 0; i < resolved.length; ++i) {
+        const auto pool = orderbook_.find_pool(path[i].pool_hash);
+        if (!pool) return std::nullopt;
+        resolved.pools[i] = *pool;
+        resolved.zero_for_one[i] = path[i].token_in == pool->token0_hash;
+        resolved.constant_product &= is_constant_product(pool->dex);
+    }
+
+    return resolved;
+}
+
+Calculator::ResolvedPath Calculator::resolve_cycle(const Cycle& cycle) const noexcept {
+    ResolvedPath resolved;
+    resolved.length = cycle.length;
+
+    for (uint8_t i = 0; i < cycle.length; ++i) {
+        const PoolState pool = orderbook_.pool(cycle.pool_ids[i]);
+        resolved.pools[i] = pool;
+        resolved.zero_for_one[i] = orderbook_.pool_token_ids(cycle.pool_ids[i]).token0 == cycle.tokens[i];
+        resolved.constant_product &= is_constant_product(pool.dex);
+    }
+
+    return resolved;
+}
+
+uint64_t Calculator::simulate(
+    const ResolvedPath& path,
+    uint64_t input_amount,
+    Opportunity::Hop* hops
+) noexcept {
     uint64_t current_amount = input_amount;
 
-    for (uint8_t i = 0; i < path_length && i < 4; ++i) {
-        // Look up pool and calculate output
-        // Simplified: would need actual pool lookup
-        current_amount = current_amount * 997 / 1000;  // Approximate with 0.3% fee
+    for (uint8_t i = 0; i < path.length; ++i) {
+        const uint64_t amount_in = current_amount;
+        current_amount = path.pools[i].get_amount_out(amount_in, path.zero_for_one[i]);
+        if (hops) {
+            hops[i].amount_in = amount_in;
+            hops[i].amount_out = current_amount;
+        }
     }
 
     return current_amount;
 }
 
-void Calculator::build_graph() noexcept {
-    token_graph_.clear();
+void Calculator::simulate_batch(
+    const ResolvedPath& path,
+    const uint64_t (&input_amounts)[SEARCH_LANES],
+    uint64_t (&output_amounts)[SEARCH_LANES]
+) noexcept {
+    uint64_t current[SEARCH_LANES];
+    for (size_t k = 0; k < SEARCH_LANES; ++k) current[k] = input_amounts[k];
+
+    for (uint8_t i = 0; i < path.length; ++i) {
+        const PoolState& pool = path.pools[i];
+        const bool zf1 = path.zero_for_one[i];
+        hotpath::swap::get_amounts_out(
+            current,
+            zf1 ? pool.reserve0 : pool.reserve1,
+            zf1 ? pool.reserve1 : pool.reserve0,
+            pool.fee_bps,
+            current
+        );
+    }
 
-    // Build graph from order book
-    // This would iterate through all pools and build adjacency list
-    // Simplified implementation for now
+    for (size_t k = 0; k < SEARCH_LANES; ++k) output_amounts[k] = current[k];
 }
 
-void Calculator::find_cycles(
-    uint64_t start_token,
-    uint64_t current_token,
-    std::vector<uint64_t>& path,
-    std::vector<Opportunity>& opportunities,
-    ChainId chain,
-    int depth
-) noexcept {
-    if (depth > 4) return;  // Max 4 hops
+uint64_t Calculator::optimal_input(const ResolvedPath& path, uint64_t max_input) noexcept {
+    if (path.length == 0 || max_input == 0) return 0;
+
+    // Profit of each candidate, clamped to [1, max_input] (0 = not a candidate)
+    uint64_t best_amount = 0;
+    int64_t best_profit = 0;
+    const auto evaluate = [&](uint64_t (&candidates)[SEARCH_LANES], int64_t (&profits)[SEARCH_LANES]) {
+        uint64_t outputs[SEARCH_LANES];
+        simulate_batch(path, candidates, outputs);
+        for (size_t k = 0; k < SEARCH_LANES; ++k) {
+            const bool valid = candidates[k] != 0 && candidates[k] <= max_input;
+            profits[k] = valid ? saturating_difference(outputs[k], candidates[k]) : INT64_MIN;
+            if (profits[k] > best_profit) {
+                best_profit = profits[k];
+                best_amount = candidates[k];
+            }
+        }
+    };
 
-    if (depth >= 3 && current_token == start_token) {
-        // Found a cycle - calculate profitability
-        // ... create opportunity ...
-        return;
+    if (path.constant_product) {
+        // Each hop is x -> p*x / (q + r*x) with p = g*R_out, q = R_in, r = g.
+        // Composing two such maps gives the same form:
+        //   p = p1*p2,  q = q1*q2,  r = q2*r1 + r2*p1
+        // Profit p*x/(q + r*x) - x peaks where the slope p*q/(q + r*x)^2 is 1.
+        double p = 1.0, q = 1.0, r = 0.0;
+        for (uint8_t i = 0; i < path.length; ++i) {
+            const PoolState& pool = path.pools[i];
+            const bool zf1 = path.zero_for_one[i];
+            const double g = static_cast<double>(10000 - pool.fee_bps) * 1e-4;
+            const double reserve_in = static_cast<double>(zf1 ? pool.reserve0 : pool.reserve1);
+            const double reserve_out = static_cast<double>(zf1 ? pool.reserve1 : pool.reserve0);
+
+            r = reserve_in * r + g * p;
+            p *= g * reserve_out;
+            q *= reserve_in;
+        }
+        if (!(p > q) || !(r > 0.0)) return 0;  // Marginal rate <= 1: never profitable
+
+        const double x = (std::sqrt(p) * std::sqrt(q) - q) / r;
+        if (!(x >= 1.0)) return 0;
+        const uint64_t center = x >= static_cast<double>(max_input)
+            ? max_input
+            : static_cast<uint64_t>(x);
+
+        // Snap to the best integer neighbour under exact integer rounding
+        uint64_t candidates[SEARCH_LANES] = {center - 1, center, center + 1, center + 2};
+        int64_t profits[SEARCH_LANES];
+        evaluate(candidates, profits);
+        return best_amount;
     }
 
-    auto it = token_graph_.find(current_token);
-    if (it == token_graph_.end()) return;
+    // Bounded search over SEARCH_LANES interior points per round (profit is
+    // unimodal for any sane AMM curve): keep the two gaps around the best
+    // point, shrinking the bracket to 2/5 per round
+    uint64_t low = 1;
+    uint64_t high = max_input;
+    for (int iter = 0; iter < MAX_SEARCH_ITERATIONS && high - low > 2 * SEARCH_LANES; ++iter) {
+        const uint64_t step = (high - low) / (SEARCH_LANES + 1);
+        uint64_t candidates[SEARCH_LANES];
+        int64_t profits[SEARCH_LANES];
+        for (size_t k = 0; k < SEARCH_LANES; ++k) candidates[k] = low + step * (k + 1);
+        evaluate(candidates, profits);
+
+        size_t best = 0;
+        for (size_t k = 1; k < SEARCH_LANES; ++k) {
+            if (profits[k] > profits[best]) best = k;
+        }
+        const uint64_t new_low = best == 0 ? low : candidates[best - 1];
+        high = best + 1 == SEARCH_LANES ? high : candidates[best + 1];
+        low = new_low;
+    }
 
-    for (uint64_t next_token : it->second.connected_tokens) {
-        // Avoid visiting same token twice (except returning to start)
-        if (next_token != start_token &&
-            std::find(path.begin(), path.end(), next_token) != path.end()) {
-            continue;
+    // Sweep what is left of the bracket
+    for (uint64_t start = low; start <= high; start += SEARCH_LANES) {
+        uint64_t candidates[SEARCH_LANES];
+        int64_t profits[SEARCH_LANES];
+        for (size_t k = 0; k < SEARCH_LANES; ++k) {
+            const uint64_t candidate = start + k;
+            candidates[k] = candidate <= high ? candidate : 0;
         }
+        evaluate(candidates, profits);
+    }
+    return best_amount;
+}
 
-        path.push_back(next_token);
-        find_cycles(start_token, next_token, path, opportunities, chain, depth + 1);
-        path.pop_back();
+void Calculator::build_graph() noexcept {
+    // Topology only changes when the order book creates pools; reserve
+    // updates are read straight from the book when edges are evaluated
+    if (graph_.sync(orderbook_) > 0) {
+        cycles_.sync(orderbook_, graph_, bases_);
     }
 }
 
-void Calculator::compare_prices_simd(
-    const std::array<uint64_t, 4>& prices,
-    const std::array<uint64_t, 4>& thresholds,
-    std::array<bool, 4>& results
-) noexcept {
-    // Simplified non-SIMD version (SIMD would use _mm256_cmpgt_epi64)
-    for (int i = 0; i < 4; ++i) {
-        results[i] = prices[i] > thresholds[i];
+std::optional<Opportunity> Calculator::evaluate_cycle(const Cycle& cycle, uint64_t sequence) const noexcept {
+    const ResolvedPath path = resolve_cycle(cycle);
+
+    // Never size past the first pool's own input reserve
+    const PoolState& first = path.pools[0];
+    const uint64_t max_input = path.zero_for_one[0] ? first.reserve0 : first.reserve1;
+
+    const uint64_t amount = optimal_input(path, max_input);
+    if (amount == 0) return std::nullopt;
+
+    Opportunity opp{};
+    const uint64_t output = simulate(path, amount, opp.path.data());
+    if (output <= amount) return std::nullopt;
+
+    opp.id = scan_count_ * 1000000 + sequence;
+    opp.timestamp_ns = detected_ns_;
+    opp.chain = cycle.chain;
+    opp.path_length = cycle.length;
+
+    for (uint8_t h = 0; h < cycle.length; ++h) {
+        auto& hop = opp.path[h];
+        hop.pool_hash = path.pools[h].pool_address_hash;
+        hop.token_in = orderbook_.token_hash(cycle.tokens[h]);
+        hop.token_out = orderbook_.token_hash(cycle.tokens[h + 1]);
+    }
+
+    opp.flash_loan_token = orderbook_.token_hash(cycle.tokens[0]);
+    opp.flash_loan_amount = amount;
+    opp.gas_estimate = cycle.length == 3 ? 500000 : 650000;
+
+    uint64_t values[2] = {output - amount, flash_loan_premium(amount)};
+    if (!to_native_wei(cycle.chain, opp.flash_loan_token, values)) return std::nullopt;
+    opp.profit_wei = values[0];
+    opp.flash_loan_fee = values[1];
+
+    return opp;
+}
+
+bool Calculator::to_native_wei(ChainId chain, uint64_t base_token, std::span<uint64_t> amounts) const noexcept {
+    const uint64_t native = wrapped_native(chain);
+    if (base_token == native) return true;
+
+    // Spot price of the chain's pool the base would best be sold into
+    const auto pool = orderbook_.get_best_price(base_token, native, chain);
+    if (!pool) return false;
+    const bool base_is_token0 = pool->token0_hash == base_token;
+    const uint64_t reserve_base = base_is_token0 ? pool->reserve0 : pool->reserve1;
+    const uint64_t reserve_native = base_is_token0 ? pool->reserve1 : pool->reserve0;
+    if (reserve_base == 0) return false;
+
+    for (uint64_t& amount : amounts) {
+        const auto wei = hotpath::swap::mul_div(amount, reserve_native, reserve_base);
+        amount = wei > UINT64_MAX ? UINT64_MAX : static_cast<uint64_t>(wei);
+    }
+    return true;
+}
+
+void Calculator::finish_scan(OpportunityBuffer& opportunities, uint64_t start_ticks) noexcept {
+    // Only the best capacity() kept are sorted
+    opportunities.finish();
+
+    last_scan_ns_ = telemetry::Clock::elapsed_ns(start_ticks);
+    telemetry::record(telemetry::Stage::SCAN, last_scan_ns_);
+    scan_count_++;
+    sequence_ = 0;
+    opportunity_count_ += opportunities.size();
+}
+
+void Calculator::find_cycles(
+    Cycle& partial,
+    uint8_t hop,
+    OpportunityBuffer& opportunities,
+    uint64_t& sequence
+) const noexcept {
+    const uint32_t start_token = partial.tokens[0];
+
+    for (const Edge& edge : graph_.edges(partial.tokens[hop])) {
+        if (orderbook_.pool_chain(edge.pool_id) != partial.chain) continue;
+
+        const uint32_t next_token = edge.to;
+        partial.pool_ids[hop] = edge.pool_id;
+        partial.tokens[hop + 1] = next_token;
+
+        if (next_token == start_token) {
+            // Back at the base: a cycle once it has at least 3 hops
+            if (hop + 1 < 3) continue;
+            partial.length = static_cast<uint8_t>(hop + 1);
+            if (auto opp = evaluate_cycle(partial, sequence++)) {
+                opportunities.offer(*opp);
+            }
+            continue;
+        }
+        if (hop + 1 == Cycle::MAX_HOPS) continue;  // Last hop must close the cycle
+
+        // Avoid visiting same token twice (except returning to start)
+        bool visited = false;
+        for (uint8_t k = 1; k <= hop; ++k) visited |= partial.tokens[k] == next_token;
+        if (visited) continue;
+
+        find_cycles(partial, static_cast<uint8_t>(hop + 1), opportunities, sequence);
     }
 }
 
@@ -0,0 +1,127 @@
+#include "arbitrage/CycleIndex.hpp"
+
+namespace matrix::arbitrage {
+
+using namespace orderbook;
+
+CycleIndex::CycleIndex(size_t max_pools, size_t max_cycles) : max_cycles_(max_cycles) {
+    cycles_.reserve(max_cycles);
+    membership_.reserve(max_pools, Cycle::MAX_HOPS * max_cycles);
+    pending_.reserve(Cycle::MAX_HOPS * max_cycles);
+}
+
+size_t CycleIndex::sync(
+    const OrderBook& book,
+    const TokenGraph& graph,
+    std::span<const BaseToken> bases
+) noexcept {
+    const size_t pool_count = graph.pools_seen();
+    if (pool_count == pools_seen_) return 0;
+
+    const size_t before = cycles_.size();
+    pending_.clear();
+
+    for (size_t id = pools_seen_; id < pool_count; ++id) {
+        const auto pool_id = static_cast<uint32_t>(id);
+        const PoolTokenIds tokens = book.pool_token_ids(pool_id);
+        if (tokens.token0 == tokens.token1) continue;
+        const ChainId chain = book.pool_chain(pool_id);
+
+        for (const BaseToken& base : bases) {
+            if (base.chain != chain) continue;
+            const uint32_t base_id = book.token_id(base.token_hash);
+            if (base_id == OrderBook::INVALID_INDEX) continue;
+
+            // The new pool can be crossed in either direction
+            const Edge forward{tokens.token1, pool_id, true};
+            const Edge backward{tokens.token0, pool_id, false};
+            for (uint8_t length = 3; length <= Cycle::MAX_HOPS; ++length) {
+                find_cycles_through(book, graph, base_id, chain, tokens.token0, forward, length);
+                find_cycles_through(book, graph, base_id, chain, tokens.token1, backward, length);
+            }
+        }
+    }
+
+    membership_.merge(pending_, pool_count);
+    pools_seen_ = pool_count;
+    return cycles_.size() - before;
+}
+
+void CycleIndex::find_cycles_through(
+    const OrderBook& book,
+    const TokenGraph& graph,
+    uint32_t base,
+    ChainId chain,
+    uint32_t from,
+    const Edge& forced,
+    uint8_t length
+) noexcept {
+    Cycle partial{};
+    partial.tokens[0] = base;
+    partial.length = length;
+    partial.chain = chain;
+
+    // The new pool sits at exactly one hop of any cycle containing it
+    for (uint8_t forced_hop = 0; forced_hop < length; ++forced_hop) {
+        extend(book, graph, partial, 0, forced_hop, from, forced);
+    }
+}
+
+void CycleIndex::extend(
+    const OrderBook& book,
+    const TokenGraph& graph,
+    Cycle& partial,
+    uint8_t hop,
+    uint8_t forced_hop,
+    uint32_t from,
+    const Edge& forced
+) noexcept {
+    const uint32_t current = partial.tokens[hop];
+    const bool last = hop + 1 == partial.length;
+
+    const auto take = [&](const Edge& edge) {
+        // Simple cycle: only the last hop may return to the base
+        const uint32_t next = edge.to;
+        if (last) {
+            if (next != partial.tokens[0]) return;
+        } else {
+            for (uint8_t k = 0; k <= hop; ++k) {
+                if (partial.tokens[k] == next) return;
+            }
+        }
+
+        partial.pool_ids[hop] = edge.pool_id;
+        partial.tokens[hop + 1] = next;
+        if (last) {
+            record(partial);
+        } else {
+            extend(book, graph, partial, hop + 1, forced_hop, from, forced);
+        }
+    };
+
+    if (hop == forced_hop) {
+        if (current == from) take(forced);
+        return;
+    }
+
+    for (const Edge& edge : graph.edges(current)) {
+        if (edge.pool_id >= forced.pool_id) break;  // Runs are in pool id order
+        if (book.pool_chain(edge.pool_id) != partial.chain) continue;
+        take(edge);
+    }
+}
+
+void CycleIndex::record(const Cycle& cycle) noexcept {
+    if (cycles_.size() >= max_cycles_) {
+        ++dropped_cycles_;
+        return;
+    }
+
+    const auto cycle_id = static_cast<uint32_t>(cycles_.size());
+    cycles_.push_back(cycle);
+    for (uint8_t h = 0; h < cycle.length; ++h) {
+        pending_.push_back({cycle.pool_ids[h], cycle_id});
+    }
+}
+
+} // namespace matrix::arbitrage
@@ -0,0 +1,263 @@
+#include "arbitrage/NegativeCycleDetector.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+namespace matrix::arbitrage {
+
+using namespace orderbook;
+
+namespace {
+
+constexpr double INF = std::numeric_limits<double>::infinity();
+
+/**
+ * Cheapest way into a token: min(dist[src[i]] + weight[i]) over i < n
+ */
+struct MinEdge {
+    double value = INF;
+    uint32_t index = UINT32_MAX;  // First offset attaining value (none if infinite)
+};
+
+[[nodiscard]] MinEdge min_incoming(const double* dist, const int32_t* src,
+                                   const double* weight, size_t n) noexcept {
+    MinEdge best;
+    size_t i = 0;
+
+#if defined(__AVX512F__) && defined(__AVX512DQ__)
+    if (n >= 8) {
+        __m512d best_v = _mm512_set1_pd(INF);
+        __m512i best_i = _mm512_set1_epi64(-1);
+        __m512i idx = _mm512_setr_epi64(0, 1, 2, 3, 4, 5, 6, 7);
+
+        for (; i + 8 <= n; i += 8) {
+            const __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+            const __m512d v = _mm512_add_pd(_mm512_i32gather_pd(s, dist, 8), _mm512_loadu_pd(weight + i));
+            const __mmask8 better = _mm512_cmp_pd_mask(v, best_v, _CMP_LT_OQ);
+            best_v = _mm512_mask_blend_pd(better, best_v, v);
+            best_i = _mm512_mask_blend_epi64(better, best_i, idx);
+            idx = _mm512_add_epi64(idx, _mm512_set1_epi64(8));
+        }
+
+        const double low = _mm512_reduce_min_pd(best_v);
+        if (low < INF) {
+            const __mmask8 at_low = _mm512_cmp_pd_mask(best_v, _mm512_set1_pd(low), _CMP_EQ_OQ);
+            best.index = static_cast<uint32_t>(_mm512_mask_reduce_min_epu64(at_low, best_i));
+            best.value = low;
+        }
+    }
+#elif defined(__AVX2__)
+    if (n >= 4) {
+        __m256d best_v = _mm256_set1_pd(INF);
+        __m256d best_i = _mm256_set1_pd(-1.0);
+        __m256d idx = _mm256_setr_pd(0.0, 1.0, 2.0, 3.0);
+
+        for (; i + 4 <= n; i += 4) {
+            const __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            const __m256d v = _mm256_add_pd(_mm256_i32gather_pd(dist, s, 8), _mm256_loadu_pd(weight + i));
+            const __m256d better = _mm256_cmp_pd(v, best_v, _CMP_LT_OQ);
+            best_v = _mm256_blendv_pd(best_v, v, better);
+            best_i = _mm256_blendv_pd(best_i, idx, better);
+            idx = _mm256_add_pd(idx, _mm256_set1_pd(4.0));
+        }
+
+        alignas(32) double vals[4];
+        alignas(32) double idxs[4];
+        _mm256_store_pd(vals, best_v);
+        _mm256_store_pd(idxs, best_i);
+        for (int lane = 0; lane < 4; ++lane) {
+            if (!(vals[lane] < INF)) continue;
+            const auto lane_idx = static_cast<uint32_t>(idxs[lane]);
+            if (vals[lane] < best.value || (vals[lane] == best.value && lane_idx < best.index)) {
+                best.index = lane_idx;
+                best.value = vals[lane];
+            }
+        }
+    }
+#endif
+
+    // Tail (or everything without SIMD)
+    for (; i < n; ++i) {
+        const double v = dist[src[i]] + weight[i];
+        if (v < best.value) {
+            best.value = v;
+            best.index = static_cast<uint32_t>(i);
+        }
+    }
+    return best;
+}
+
+} // namespace
+
+NegativeCycleDetector::NegativeCycleDetector(ChainId chain, size_t max_passes)
+    : chain_(chain)
+    , max_passes_(max_passes) {}
+
+bool NegativeCycleDetector::sync(const OrderBook& book, const TokenGraph& graph) {
+    if (graph.version() == graph_version_) return false;
+    graph_version_ = graph.version();
+    node_count_ = graph.node_count();
+
+    // This chain's pools, in id order
+    pools_.clear();
+    in_offsets_.assign(node_count_ + 1, 0);
+    for (size_t id = 0; id < graph.pools_seen(); ++id) {
+        const auto pool_id = static_cast<uint32_t>(id);
+        if (book.pool_chain(pool_id) != chain_) continue;
+        const PoolTokenIds tokens = book.pool_token_ids(pool_id);
+        if (tokens.token0 == tokens.token1) continue;
+        pools_.push_back(pool_id);
+        ++in_offsets_[tokens.token1 + 1];
+        ++in_offsets_[tokens.token0 + 1];
+    }
+    for (size_t v = 0; v < node_count_; ++v) in_offsets_[v + 1] += in_offsets_[v];
+
+    // Counting sort of both directions into their destination's run
+    const size_t edges = 2 * pools_.size();
+    src_.resize(edges);
+    weight_.assign(edges, INF);
+    pool_.resize(edges);
+    zero_for_one_.resize(edges);
+    forward_edge_.resize(pools_.size());
+    backward_edge_.resize(pools_.size());
+
+    walk_.assign(in_offsets_.begin(), in_offsets_.end() - 1);   // Fill cursors
+    for (size_t k = 0; k < pools_.size(); ++k) {
+        const PoolTokenIds tokens = book.pool_token_ids(pools_[k]);
+
+        const uint32_t fwd = walk_[tokens.token1]++;
+        src_[fwd] = static_cast<int32_t>(tokens.token0);
+        pool_[fwd] = pools_[k];
+        zero_for_one_[fwd] = 1;
+        forward_edge_[k] = fwd;
+
+        const uint32_t bwd = walk_[tokens.token0]++;
+        src_[bwd] = static_cast<int32_t>(tokens.token1);
+        pool_[bwd] = pools_[k];
+        zero_for_one_[bwd] = 0;
+        backward_edge_[k] = bwd;
+    }
+
+    dist_.assign(node_count_, 0.0);
+    pred_.assign(node_count_, NONE);
+    walk_.assign(node_count_, NONE);
+
+    // Predecessor cycles are disjoint, so they never hold more than every token
+    cycle_edges_.reserve(node_count_);
+    cycle_offsets_.reserve(node_count_ + 1);
+    cycle_weights_.reserve(node_count_);
+    cycle_edges_.clear();
+    cycle_offsets_.assign(1, 0);
+    cycle_weights_.clear();
+    return true;
+}
+
+void NegativeCycleDetector::reweigh(const OrderBook& book) noexcept {
+    for (size_t k = 0; k < pools_.size(); ++k) {
+        const PoolState pool = book.pool(pools_[k]);
+        double forward = INF;
+        double backward = INF;
+        if (pool.reserve0 != 0 && pool.reserve1 != 0 && pool.fee_bps < 10000) {
+            const double g = static_cast<double>(10000 - pool.fee_bps) * 1e-4;
+            const double r0 = static_cast<double>(pool.reserve0);
+            const double r1 = static_cast<double>(pool.reserve1);
+            forward = -std::log(g * r1 / r0);
+            backward = -std::log(g * r0 / r1);
+        }
+        weight_[forward_edge_[k]] = forward;
+        weight_[backward_edge_[k]] = backward;
+    }
+}
+
+size_t NegativeCycleDetector::detect(const OrderBook& book, const TokenGraph& graph) {
+    sync(book, graph);
+    reweigh(book);
+    return detect();
+}
+
+size_t NegativeCycleDetector::detect() noexcept {
+    std::fill(dist_.begin(), dist_.end(), 0.0);
+    std::fill(pred_.begin(), pred_.end(), NONE);
+    cycle_edges_.clear();
+    cycle_offsets_.resize(1);
+    cycle_weights_.clear();
+
+    bool converged = false;
+    last_passes_ = 0;
+    while (last_passes_ < max_passes_) {
+        ++last_passes_;
+        if (relax_pass() == 0) {
+            converged = true;
+            break;
+        }
+    }
+
+    // Shortest paths exist: no negative cycle anywhere
+    if (!converged) extract_cycles();
+    return cycle_count();
+}
+
+size_t NegativeCycleDetector::relax_pass() noexcept {
+    size_t changed = 0;
+    for (size_t v = 0; v < node_count_; ++v) {
+        const uint32_t begin = in_offsets_[v];
+        const uint32_t end = in_offsets_[v + 1];
+        if (begin == end) continue;
+
+        // In place: later tokens already see this pass's improvements
+        const MinEdge best = min_incoming(dist_.data(), src_.data() + begin, weight_.data() + begin, end - begin);
+        if (best.value < dist_[v] - EPSILON) {
+            dist_[v] = best.value;
+            pred_[v] = begin + best.index;
+            ++changed;
+        }
+    }
+    return changed;
+}
+
+void NegativeCycleDetector::extract_cycles() noexcept {
+    std::fill(walk_.begin(), walk_.end(), NONE);
+
+    // Every token has at most one predecessor, so each walk either runs
+    // into an earlier walk, a token without one, or closes its own cycle;
+    // every token is visited once overall
+    for (uint32_t start = 0; start < node_count_; ++start) {
+        if (pred_[start] == NONE || walk_[start] != NONE) continue;
+
+        uint32_t v = start;
+        while (v != NONE && walk_[v] == NONE) {
+            walk_[v] = start;
+            v = pred_[v] == NONE ? NONE : static_cast<uint32_t>(src_[pred_[v]]);
+        }
+        if (v == NONE || walk_[v] != start) continue;
+
+        // v is on the cycle: follow predecessors round it, then reverse
+        // into swap order
+        const size_t first = cycle_edges_.size();
+        double weight = 0.0;
+        uint32_t u = v;
+        do {
+            const uint32_t e = pred_[u];
+            const auto from = static_cast<uint32_t>(src_[e]);
+            cycle_edges_.push_back({from, u, pool_[e], zero_for_one_[e] != 0});
+            weight += weight_[e];
+            u = from;
+        } while (u != v);
+        std::reverse(cycle_edges_.begin() + static_cast<ptrdiff_t>(first), cycle_edges_.end());
+
+        // Rounding could in principle leave a cycle that is not a real one
+        if (!(weight < 0.0)) {
+            cycle_edges_.resize(first);
+            continue;
+        }
+        cycle_offsets_.push_back(static_cast<uint32_t>(cycle_edges_.size()));
+        cycle_weights_.push_back(weight);
+    }
+}
+
+} // namespace matrix::arbitrage
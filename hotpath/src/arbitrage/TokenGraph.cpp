@@ -0,0 +1,33 @@
+#include "arbitrage/TokenGraph.hpp"
+
+namespace matrix::arbitrage {
+
+using namespace orderbook;
+
+TokenGraph::TokenGraph(size_t max_tokens, size_t max_pools) {
+    adjacency_.reserve(max_tokens, 2 * max_pools);
+    pending_.reserve(2 * max_pools);
+}
+
+size_t TokenGraph::sync(const OrderBook& book) noexcept {
+    const size_t pool_count = book.pool_count();
+    if (pool_count == pools_seen_) return 0;
+
+    // Collect both directions of every new pool
+    pending_.clear();
+    for (size_t id = pools_seen_; id < pool_count; ++id) {
+        const auto pool_id = static_cast<uint32_t>(id);
+        const PoolTokenIds tokens = book.pool_token_ids(pool_id);
+        if (tokens.token0 == tokens.token1) continue;  // Degenerate pool, no swap
+        pending_.push_back({tokens.token0, {tokens.token1, pool_id, true}});
+        pending_.push_back({tokens.token1, {tokens.token0, pool_id, false}});
+    }
+    adjacency_.merge(pending_, book.token_count());
+
+    const size_t added = pool_count - pools_seen_;
+    pools_seen_ = pool_count;
+    ++version_;
+    return added;
+}
+
+} // namespace matrix::arbitrage
@@ -14,11 +14,20 @@
 #include <thread>
 #include <csignal>
 #include <atomic>
+#include <memory>
+#include <cstdlib>
+#include <exception>
+#include <string>
 
-#include "memory/Arena.hpp"
 #include "orderbook/OrderBook.hpp"
+#include "orderbook/MPMCQueue.hpp"
 #include "orderbook/SPSCQueue.hpp"
+#include "orderbook/WaitStrategy.hpp"
 #include "arbitrage/Calculator.hpp"
+#include "runtime/EventLog.hpp"
+#include "runtime/Pipeline.hpp"
+#include "runtime/Replay.hpp"
+#include "telemetry/Telemetry.hpp"
 
 using namespace matrix;
 
@@ -30,7 +39,78 @@ void signal_handler(int signal) {
     g_shutdown.store(true, std::memory_order_release);
 }
 
+/**
+ * Replay mode: hotpath_runner --replay <trace> [--speed <x>] [--gas-price <gwei>]
+ * (--synthesize <trace> writes a synthetic block-burst trace to replay)
+ */
+int replay_main(int argc, char* argv[]) {
+    std::string trace_path;
+    std::string synthesize_path;
+    runtime::ReplayConfig config;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        const std::string flag = argv[i];
+        if (flag == "--replay") trace_path = argv[i + 1];
+        else if (flag == "--synthesize") synthesize_path = argv[i + 1];
+        else if (flag == "--speed") config.speed = std::strtod(argv[i + 1], nullptr);
+        else if (flag == "--gas-price") config.gas_price_gwei = std::strtoull(argv[i + 1], nullptr, 10);
+        else {
+            std::cerr << "Unknown option " << flag << "\n";
+            return 2;
+        }
+    }
+
+    if (!synthesize_path.empty()) {
+        const auto trace = runtime::synthesize_trace({});
+        if (!runtime::save_trace(synthesize_path, trace)) {
+            std::cerr << "[REPLAY] Cannot write " << synthesize_path << "\n";
+            return 1;
+        }
+        std::cout << "[REPLAY] Wrote " << trace.size() << " updates to " << synthesize_path << "\n";
+        if (trace_path.empty()) return 0;
+    }
+
+    telemetry::Clock::calibrate();
+    const auto trace = runtime::load_trace(trace_path);
+    runtime::ReplayHarness harness(config);
+    const runtime::ReplayReport report = harness.run(trace);
+
+    std::cout << "[REPLAY] Updates=" << report.updates
+              << " Batches=" << report.batches
+              << " Opportunities=" << report.opportunities
+              << " Transactions=" << report.transactions
+              << " Wall=" << report.wall_ns / 1000 << "us"
+              << " Throughput=" << static_cast<uint64_t>(report.updates_per_second()) << " updates/s"
+              << " Checksum=" << std::hex << report.checksum << std::dec << "\n";
+
+    auto stages = std::make_unique<telemetry::Snapshot>();
+    telemetry::LatencyHistogram::Snapshot end_to_end;
+    harness.snapshot(*stages, end_to_end);
+    const auto print = [](const char* name, const telemetry::LatencyHistogram::Snapshot& stage) {
+        if (stage.count == 0) return;
+        std::cout << "[LATENCY] " << name
+                  << " n=" << stage.count
+                  << " p50=" << stage.percentile(0.5)
+                  << " p99=" << stage.percentile(0.99)
+                  << " p99.9=" << stage.percentile(0.999)
+                  << " max=" << stage.max << "ns\n";
+    };
+    for (size_t s = 0; s < telemetry::STAGE_COUNT; ++s) {
+        print(telemetry::stage_name(static_cast<telemetry::Stage>(s)), (*stages)[s]);
+    }
+    print("end_to_end", end_to_end);
+    return 0;
+}
+
 int main(int argc, char* argv[]) {
+    if (argc > 1) {
+        try {
+            return replay_main(argc, argv);
+        } catch (const std::exception& e) {
+            std::cerr << "[REPLAY] " << e.what() << "\n";
+            return 1;
+        }
+    }
+
     std::cout << "==============================================\n";
     std::cout << "  FLASH LOAN ARBITRAGE BOT - HOT PATH CORE\n";
     std::cout << "  Codename: THE MATRIX\n";
@@ -40,71 +120,99 @@ int main(int argc, char* argv[]) {
     std::signal(SIGINT, signal_handler);
     std::signal(SIGTERM, signal_handler);
 
-    // Initialize memory arena (64 MB pre-allocated)
-    memory::Arena arena(64 * 1024 * 1024);
-    std::cout << "[MEMORY] Arena initialized: " << arena.capacity() / (1024 * 1024) << " MB\n";
-
-    // Initialize price queue
-    orderbook::PriceQueue price_queue;
-    std::cout << "[QUEUE] Price queue initialized\n";
-
-    // Initialize order book
-    orderbook::OrderBook orderbook(arena);
-    std::cout << "[ORDERBOOK] Order book initialized\n";
+    // Calibrate the TSC before any stage takes a timestamp
+    telemetry::Clock::calibrate();
+    std::cout << "[TELEMETRY] TSC " << telemetry::Clock::ticks_per_ns() << " ticks/ns\n";
+
+    // Optional node_exporter textfile, rewritten with every stats report
+    const char* metrics_env = std::getenv("MATRIX_METRICS_FILE");
+    const std::string metrics_file = metrics_env ? metrics_env : "";
+
+    // Opportunity / stats output is formatted on a writer thread; with
+    // MATRIX_JOURNAL_FILE set it is also journaled in binary for replay
+    runtime::EventLogConfig log_config;
+    if (const char* journal = std::getenv("MATRIX_JOURNAL_FILE")) log_config.journal_path = journal;
+    runtime::EventLog event_log(std::move(log_config));
+
+    // Initialize the feed queue (one producer handle per feed connection)
+    auto price_feed = std::make_unique<orderbook::PriceFeedQueue>();
+    std::cout << "[QUEUE] Price feed queue initialized\n";
+
+    // One shard per chain: router on CPU 0, shards on the next CPUs while
+    // there are cores to spare. With MATRIX_SNAPSHOT_DIR set each shard
+    // warm starts from (and periodically refreshes) book-<chain>.snap there
+    const int cpus = static_cast<int>(std::thread::hardware_concurrency());
+    const char* snapshot_dir = std::getenv("MATRIX_SNAPSHOT_DIR");
+    runtime::PipelineConfig config;
+    config.router_cpu = cpus > 1 ? 0 : -1;
+    for (const auto chain : {orderbook::ChainId::ETHEREUM, orderbook::ChainId::ARBITRUM, orderbook::ChainId::BASE}) {
+        const int cpu = static_cast<int>(config.shards.size()) + 1;
+        runtime::ShardConfig shard{chain, cpu < cpus ? cpu : -1};
+        if (snapshot_dir) {
+            shard.snapshot_path = std::string(snapshot_dir) + "/book-" +
+                                  std::to_string(static_cast<int>(chain)) + ".snap";
+        }
+        config.shards.push_back(std::move(shard));
+    }
 
-    // Initialize arbitrage calculator
-    arbitrage::Calculator calculator(orderbook);
-    std::cout << "[CALCULATOR] Arbitrage calculator initialized\n";
+    runtime::Pipeline pipeline(std::move(config));
+    pipeline.start(*price_feed);
+    for (size_t i = 0; i < pipeline.shard_count(); ++i) {
+        const auto& shard = pipeline.shard_config(i);
+        const auto stats = pipeline.shard_stats(i);
+        std::cout << "[PIPELINE] Chain=" << static_cast<int>(shard.chain)
+                  << " CPU=" << shard.cpu
+                  << (stats.pinned ? " (pinned)" : "");
+        if (stats.restored_pools > 0) std::cout << " Restored=" << stats.restored_pools << " pools";
+        std::cout << "\n";
+    }
 
     std::cout << "\n[STATUS] Hot path core ready. Waiting for price feeds...\n\n";
 
-    // Main loop
-    uint64_t cycle_count = 0;
+    // Main loop: report what the shards find
+    uint64_t opportunity_count = 0;
+    orderbook::WaitStrategy waiter(orderbook::WaitKind::PARK);
     auto last_stats = std::chrono::steady_clock::now();
+    auto latency = std::make_unique<telemetry::Snapshot>();
 
     while (!g_shutdown.load(std::memory_order_acquire)) {
-        auto cycle_start = std::chrono::high_resolution_clock::now();
-
-        // Process price updates
-        size_t updates = orderbook.process_updates(price_queue);
-
-        // Scan for opportunities if we have updates
-        if (updates > 0) {
-            auto opportunities = calculator.scan();
-
-            // Log profitable opportunities
-            for (const auto& opp : opportunities) {
-                if (opp.is_profitable(50)) {  // 50 gwei gas price
-                    std::cout << "[OPPORTUNITY] Chain=" << static_cast<int>(opp.chain)
-                              << " Profit=" << opp.profit_wei / 1'000'000'000'000'000ULL << " finney"
-                              << " Path=" << static_cast<int>(opp.path_length) << " hops\n";
-                }
+        const size_t drained = pipeline.drain_opportunities([&](const arbitrage::Opportunity& opp) {
+            if (opp.is_profitable(50)) {  // 50 gwei gas price
+                event_log.log(opp);
             }
-        }
-
-        auto cycle_end = std::chrono::high_resolution_clock::now();
-        auto cycle_duration = std::chrono::duration_cast<std::chrono::microseconds>(
-            cycle_end - cycle_start
-        ).count();
-
-        cycle_count++;
+        });
+        opportunity_count += drained;
 
         // Print stats every 10 seconds
         auto now = std::chrono::steady_clock::now();
         if (std::chrono::duration_cast<std::chrono::seconds>(now - last_stats).count() >= 10) {
-            std::cout << "[STATS] Cycles=" << cycle_count
-                      << " Pools=" << orderbook.pool_count()
-                      << " LastCycle=" << cycle_duration << "us"
-                      << " Arena=" << arena.used() / 1024 << "KB\n";
+            for (size_t i = 0; i < pipeline.shard_count(); ++i) {
+                event_log.log(pipeline.shard_config(i).chain, pipeline.shard_stats(i));
+            }
+
+            telemetry::snapshot(*latency);
+            for (size_t s = 0; s < telemetry::STAGE_COUNT; ++s) {
+                if ((*latency)[s].count == 0) continue;
+                event_log.log(static_cast<telemetry::Stage>(s), (*latency)[s]);
+            }
+            if (!metrics_file.empty() && !telemetry::write_prometheus_file(metrics_file, *latency)) {
+                std::cerr << "[TELEMETRY] Failed to write " << metrics_file << "\n";
+            }
             last_stats = now;
         }
 
-        // Small sleep to prevent busy-waiting when no data
-        if (updates == 0) {
-            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        // Spin briefly, then yield: no fixed sleep between an opportunity
+        // landing in a shard queue and us seeing it
+        if (drained == 0) {
+            waiter.wait();
+        } else {
+            waiter.reset();
         }
     }
 
-    std::cout << "\n[SHUTDOWN] Hot path core stopped. Total cycles: " << cycle_count << "\n";
+    pipeline.stop();
+    event_log.stop();
+    std::cout << "\n[SHUTDOWN] Hot path core stopped. Opportunities: " << opportunity_count
+              << " Log records: " << event_log.written() << " (" << event_log.dropped() << " dropped)\n";
     return 0;
 }
@@ -1,32 +1,68 @@
 #include "memory/Arena.hpp"
-#include <cstdlib>
-#include <cstring>
+#include <new>
 
 #ifdef _WIN32
-#include <malloc.h>
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
 #endif
 
 namespace matrix::memory {
 
-Arena::Arena(size_t size) : size_(size) {
-    // Allocate aligned memory (platform-specific)
+namespace {
+
+size_t round_up(size_t n, size_t multiple) noexcept {
+    return (n + multiple - 1) / multiple * multiple;
+}
+
+} // namespace
+
+Arena::Arena(size_t size, ArenaOptions options) : size_(size) {
+    // Fresh anonymous pages read as zero, so no memset: each page is
+    // faulted in (zeroed by the kernel) on first touch
 #ifdef _WIN32
-    memory_ = static_cast<uint8_t*>(_aligned_malloc(size, CACHE_LINE_SIZE));
-#else
-    memory_ = static_cast<uint8_t*>(std::aligned_alloc(CACHE_LINE_SIZE, size));
-#endif
+    (void)options;
+    mapped_ = size;
+    memory_ = static_cast<uint8_t*>(VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE));
     if (!memory_) {
         throw std::bad_alloc();
     }
-    // Zero-initialize
-    std::memset(memory_, 0, size);
+#else
+    const int populate = options.prefault ? MAP_POPULATE : 0;
+    void* block = MAP_FAILED;
+    if (options.huge_pages) {
+        // Reserved hugetlbfs pages first; fails fast if none are configured
+        mapped_ = round_up(size, HUGE_PAGE_SIZE);
+        block = mmap(nullptr, mapped_, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | populate, -1, 0);
+        huge_pages_ = block != MAP_FAILED;
+    }
+    if (block == MAP_FAILED) {
+        mapped_ = round_up(size, static_cast<size_t>(sysconf(_SC_PAGESIZE)));
+        block = mmap(nullptr, mapped_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (block == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+#ifdef MADV_HUGEPAGE
+        // Transparent huge pages: the kernel backs aligned 2 MiB runs on fault
+        if (options.huge_pages) huge_pages_ = madvise(block, mapped_, MADV_HUGEPAGE) == 0;
+#endif
+        if (options.prefault) {
+            // Write-fault now (after madvise, so THP can apply)
+            const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+            for (size_t i = 0; i < mapped_; i += page) static_cast<volatile uint8_t*>(block)[i] = 0;
+        }
+    }
+    memory_ = static_cast<uint8_t*>(block);
+#endif
 }
 
 Arena::~Arena() {
 #ifdef _WIN32
-    _aligned_free(memory_);
+    VirtualFree(memory_, 0, MEM_RELEASE);
 #else
-    std::free(memory_);
+    munmap(memory_, mapped_);
 #endif
 }
 
@@ -55,4 +91,17 @@ void Arena::reset() noexcept {
     offset_.store(0, std::memory_order_release);
 }
 
+void Arena::rewind(size_t mark) noexcept {
+    assert(mark <= used());
+    offset_.store(mark, std::memory_order_release);
+}
+
+ThreadArena::ThreadArena(Arena& parent, size_t size)
+    : memory_(static_cast<uint8_t*>(parent.allocate(size)))
+    , size_(size) {
+    if (!memory_) {
+        throw std::bad_alloc();
+    }
+}
+
 } // namespace matrix::memory
@@ -0,0 +1,191 @@
+#include "network/FeedDecoder.hpp"
+#include "network/JsonScan.hpp"
+
+#include <cstring>
+
+#include "swap_math.hpp"
+
+namespace matrix::network {
+
+using namespace orderbook;
+
+namespace {
+
+using u128 = hotpath::swap::u128;
+
+constexpr size_t WORD_BYTES = 32;
+
+// keccak256("Sync(uint112,uint112)")
+constexpr uint8_t SYNC_TOPIC[WORD_BYTES] = {
+    0x1c, 0x41, 0x1e, 0x9a, 0x96, 0xe0, 0x71, 0x24, 0x1c, 0x2f, 0x21, 0xf7, 0x72, 0x6b, 0x17, 0xae,
+    0x89, 0xe3, 0xca, 0xb4, 0xc7, 0x8b, 0xe5, 0x0e, 0x06, 0x2b, 0x03, 0xa9, 0xff, 0xfb, 0xba, 0xd1};
+
+// keccak256("Swap(address,address,int256,int256,uint160,uint128,int24)")
+constexpr uint8_t V3_SWAP_TOPIC[WORD_BYTES] = {
+    0xc4, 0x20, 0x79, 0xf9, 0x4a, 0x63, 0x50, 0xd7, 0xe6, 0x23, 0x5f, 0x29, 0x17, 0x49, 0x24, 0xf9,
+    0x28, 0xcc, 0x2a, 0xc8, 0x18, 0xeb, 0x64, 0xfe, 0xd8, 0x00, 0x4e, 0x11, 0x5f, 0xbc, 0xca, 0x67};
+
+constexpr u128 PRICE_SCALE = 1'000'000'000'000'000'000ULL;   // Same 1e18 as PoolState::spot_price
+
+size_t skip_ws(std::string_view s, size_t pos) noexcept {
+    while (pos < s.size() && (s[pos] == ' ' || s[pos] == '\t' || s[pos] == '\n' || s[pos] == '\r')) ++pos;
+    return pos;
+}
+
+bool is_zero(const uint8_t* bytes, size_t len) noexcept {
+    uint8_t acc = 0;
+    for (size_t i = 0; i < len; ++i) acc |= bytes[i];
+    return acc == 0;
+}
+
+/**
+ * Big-endian 256-bit word that must fit 128 bits
+ */
+bool word_u128(const uint8_t* word, u128& out) noexcept {
+    if (!is_zero(word, 16)) return false;
+    out = scan::load_be<u128>(word + 16, 16);
+    return true;
+}
+
+/**
+ * In-range virtual reserves of a V3 pool: L / sqrtP and L * sqrtP
+ */
+void v3_virtual_reserves(const uint8_t* sqrt_price_word, u128 liquidity, u128& reserve0, u128& reserve1) noexcept {
+    // uint160 sqrtPriceX96 -> 128 bits by dropping k low bits from it and from 2^96
+    const auto high = scan::load_be<uint32_t>(sqrt_price_word + 12, 4);
+    const u128 low = scan::load_be<u128>(sqrt_price_word + 16, 16);
+    const int k = high == 0 ? 0 : 32 - __builtin_clz(high);
+    const u128 sqrt_price = k == 0 ? low : (static_cast<u128>(high) << (128 - k)) | (low >> k);
+    const u128 q96 = static_cast<u128>(1) << (96 - k);
+
+    if (sqrt_price == 0 || liquidity == 0) {
+        reserve0 = reserve1 = 0;
+        return;
+    }
+    reserve0 = hotpath::swap::mul_div(liquidity, q96, sqrt_price);
+    reserve1 = hotpath::swap::mul_div(liquidity, sqrt_price, q96);
+}
+
+} // namespace
+
+bool parse_address(std::string_view hex, uint8_t (&out)[20]) noexcept {
+    if (hex.size() != 42 || hex[0] != '0' || (hex[1] | 0x20) != 'x') return false;
+    return scan::decode_hex(hex.data() + 2, 20, out);
+}
+
+FeedDecoder::FeedDecoder(ChainId chain, memory::Arena& arena, size_t max_pools)
+    : chain_(chain)
+    , pools_(arena, max_pools) {}
+
+bool FeedDecoder::add_pool(std::string_view pool_address, const PoolInfo& info) noexcept {
+    uint8_t address[20];
+    if (!parse_address(pool_address, address) || info.scale0 == 0 || info.scale1 == 0) return false;
+    return pools_.insert(address_hash(address), info).first != nullptr;
+}
+
+DecodeStatus FeedDecoder::decode(std::string_view message, uint64_t timestamp_ns, PriceUpdate& out) noexcept {
+    ++stats_.messages;
+    const DecodeStatus status = decode_log(message, timestamp_ns, out);
+    switch (status) {
+        case DecodeStatus::DECODED:      ++stats_.decoded;      break;
+        case DecodeStatus::NOT_A_LOG:    ++stats_.not_a_log;    break;
+        case DecodeStatus::IGNORED:      ++stats_.ignored;      break;
+        case DecodeStatus::UNKNOWN_POOL: ++stats_.unknown_pool; break;
+        case DecodeStatus::OUT_OF_RANGE: ++stats_.out_of_range; break;
+        case DecodeStatus::MALFORMED:    ++stats_.malformed;    break;
+    }
+    return status;
+}
+
+DecodeStatus FeedDecoder::decode_log(std::string_view message, uint64_t timestamp_ns, PriceUpdate& out) noexcept {
+    const size_t quotes = scan::index_quotes(message.data(), message.size(), quotes_, MAX_QUOTES);
+    if (quotes == SIZE_MAX || (quotes & 1) != 0) return DecodeStatus::MALFORMED;
+
+    const auto string_at = [&](size_t q) {
+        return message.substr(quotes_[q] + 1, quotes_[q + 1] - quotes_[q] - 1);
+    };
+
+    // Walk string tokens; a string followed by ':' is a key
+    std::string_view address, topic0, data;
+    bool has_topics = false;
+    bool removed = false;
+    for (size_t q = 0; q + 1 < quotes; q += 2) {
+        const size_t colon = skip_ws(message, quotes_[q + 1] + 1);
+        if (colon >= message.size() || message[colon] != ':') continue;
+
+        const std::string_view key = string_at(q);
+        const size_t value = skip_ws(message, colon + 1);
+        const bool string_value = q + 2 < quotes && quotes_[q + 2] == value;
+
+        if (key == "address") {
+            if (!string_value) return DecodeStatus::MALFORMED;
+            address = string_at(q + 2);
+        } else if (key == "data") {
+            if (!string_value) return DecodeStatus::MALFORMED;
+            data = string_at(q + 2);
+        } else if (key == "topics") {
+            if (value >= message.size() || message[value] != '[') return DecodeStatus::MALFORMED;
+            has_topics = true;
+            if (q + 2 < quotes && quotes_[q + 2] == skip_ws(message, value + 1)) topic0 = string_at(q + 2);
+        } else if (key == "removed") {
+            removed = value < message.size() && message[value] == 't';
+        }
+    }
+
+    if (address.empty() || !has_topics) return DecodeStatus::NOT_A_LOG;
+    if (removed) return DecodeStatus::IGNORED;
+
+    uint8_t pool_address[20];
+    if (!parse_address(address, pool_address)) return DecodeStatus::MALFORMED;
+    const uint64_t pool_hash = address_hash(pool_address);
+    const PoolInfo* info = pools_.find(pool_hash);
+    if (!info) return DecodeStatus::UNKNOWN_POOL;
+
+    // Pools emit other events too (Mint, Burn, Transfer, ...)
+    uint8_t topic[WORD_BYTES];
+    if (topic0.size() != 2 + 2 * WORD_BYTES || !scan::decode_hex(topic0.data() + 2, WORD_BYTES, topic)) {
+        return DecodeStatus::MALFORMED;
+    }
+    const bool v2 = info->event == PoolEvent::V2_SYNC;
+    if (std::memcmp(topic, v2 ? SYNC_TOPIC : V3_SWAP_TOPIC, WORD_BYTES) != 0) return DecodeStatus::IGNORED;
+
+    // Only the two words we read are decoded: Sync (reserve0, reserve1),
+    // V3 Swap (amount0, amount1, sqrtPriceX96, liquidity, tick) words 2-3
+    const size_t first_word = v2 ? 0 : 2;
+    const size_t hex_end = 2 + 2 * WORD_BYTES * (first_word + 2);
+    if (data.size() < hex_end || data[0] != '0' || (data[1] | 0x20) != 'x') return DecodeStatus::MALFORMED;
+
+    uint8_t words[2 * WORD_BYTES];
+    if (!scan::decode_hex(data.data() + 2 + 2 * WORD_BYTES * first_word, 2 * WORD_BYTES, words)) {
+        return DecodeStatus::MALFORMED;
+    }
+
+    u128 reserve0, reserve1;
+    if (v2) {
+        if (!word_u128(words, reserve0) || !word_u128(words + WORD_BYTES, reserve1)) {
+            return DecodeStatus::MALFORMED;
+        }
+    } else {
+        u128 liquidity;
+        if (!is_zero(words, 12) || !word_u128(words + WORD_BYTES, liquidity)) return DecodeStatus::MALFORMED;
+        v3_virtual_reserves(words, liquidity, reserve0, reserve1);
+    }
+
+    if (info->scale0 != 1) reserve0 /= info->scale0;
+    if (info->scale1 != 1) reserve1 /= info->scale1;
+    if ((reserve0 >> 64) != 0 || (reserve1 >> 64) != 0) return DecodeStatus::OUT_OF_RANGE;
+
+    out.timestamp_ns = timestamp_ns;
+    out.pool_hash = pool_hash;
+    out.chain_id = static_cast<uint32_t>(chain_);
+    out.dex_id = static_cast<uint32_t>(info->dex);
+    out.token0 = info->token0;
+    out.token1 = info->token1;
+    out.reserve0 = static_cast<uint64_t>(reserve0);
+    out.reserve1 = static_cast<uint64_t>(reserve1);
+    const u128 price = reserve0 == 0 ? 0 : hotpath::swap::mul_div(reserve1, PRICE_SCALE, reserve0);
+    out.price = (price >> 64) != 0 ? UINT64_MAX : static_cast<uint64_t>(price);
+    return DecodeStatus::DECODED;
+}
+
+} // namespace matrix::network
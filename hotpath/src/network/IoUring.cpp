@@ -0,0 +1,144 @@
+#include "network/IoUring.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <system_error>
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace matrix::network {
+
+namespace {
+
+int sys_setup(unsigned entries, io_uring_params* params) noexcept {
+    return static_cast<int>(::syscall(__NR_io_uring_setup, entries, params));
+}
+
+int sys_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags,
+              const void* arg, size_t arg_size) noexcept {
+    return static_cast<int>(::syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, arg, arg_size));
+}
+
+int sys_register(int fd, unsigned opcode, const void* arg, unsigned nr_args) noexcept {
+    return static_cast<int>(::syscall(__NR_io_uring_register, fd, opcode, arg, nr_args));
+}
+
+template<typename T>
+T* at(void* base, uint32_t offset) noexcept {
+    return reinterpret_cast<T*>(static_cast<char*>(base) + offset);
+}
+
+} // namespace
+
+IoUring::IoUring(unsigned entries) {
+    io_uring_params params{};
+    ring_fd_ = sys_setup(entries, &params);
+    if (ring_fd_ < 0) {
+        throw std::system_error(errno, std::generic_category(), "io_uring_setup");
+    }
+
+    constexpr unsigned REQUIRED = IORING_FEAT_SINGLE_MMAP | IORING_FEAT_EXT_ARG;
+    if ((params.features & REQUIRED) != REQUIRED) {
+        ::close(ring_fd_);
+        throw std::system_error(ENOSYS, std::generic_category(), "io_uring: kernel too old");
+    }
+
+    entries_ = params.sq_entries;
+    ring_bytes_ = std::max(params.sq_off.array + params.sq_entries * sizeof(unsigned),
+                           params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe));
+    ring_ptr_ = ::mmap(nullptr, ring_bytes_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                       ring_fd_, IORING_OFF_SQ_RING);
+    if (ring_ptr_ == MAP_FAILED) {
+        const int err = errno;
+        ::close(ring_fd_);
+        throw std::system_error(err, std::generic_category(), "io_uring: mmap rings");
+    }
+
+    sqes_bytes_ = params.sq_entries * sizeof(io_uring_sqe);
+    sqes_ptr_ = ::mmap(nullptr, sqes_bytes_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                       ring_fd_, IORING_OFF_SQES);
+    if (sqes_ptr_ == MAP_FAILED) {
+        const int err = errno;
+        ::munmap(ring_ptr_, ring_bytes_);
+        ::close(ring_fd_);
+        throw std::system_error(err, std::generic_category(), "io_uring: mmap sqes");
+    }
+
+    sq_head_ = at<unsigned>(ring_ptr_, params.sq_off.head);
+    sq_tail_ = at<unsigned>(ring_ptr_, params.sq_off.tail);
+    sq_mask_ = *at<unsigned>(ring_ptr_, params.sq_off.ring_mask);
+    sqes_ = static_cast<io_uring_sqe*>(sqes_ptr_);
+
+    // Identity SQ index array: SQE i always sits in slot i
+    unsigned* array = at<unsigned>(ring_ptr_, params.sq_off.array);
+    for (unsigned i = 0; i < params.sq_entries; ++i) array[i] = i;
+
+    cq_head_ = at<unsigned>(ring_ptr_, params.cq_off.head);
+    cq_tail_ = at<unsigned>(ring_ptr_, params.cq_off.tail);
+    cq_mask_ = *at<unsigned>(ring_ptr_, params.cq_off.ring_mask);
+    cqes_ = at<io_uring_cqe>(ring_ptr_, params.cq_off.cqes);
+
+    sqe_tail_ = sqe_submitted_ = *sq_tail_;
+}
+
+IoUring::~IoUring() {
+    ::munmap(sqes_ptr_, sqes_bytes_);
+    ::munmap(ring_ptr_, ring_bytes_);
+    ::close(ring_fd_);
+}
+
+io_uring_sqe* IoUring::get_sqe() noexcept {
+    const unsigned head = std::atomic_ref<unsigned>(*sq_head_).load(std::memory_order_acquire);
+    if (sqe_tail_ - head >= entries_) return nullptr;
+
+    io_uring_sqe* sqe = &sqes_[sqe_tail_ & sq_mask_];
+    std::memset(sqe, 0, sizeof(*sqe));
+    ++sqe_tail_;
+    return sqe;
+}
+
+int IoUring::submit_and_wait(int timeout_ms) noexcept {
+    const unsigned to_submit = sqe_tail_ - sqe_submitted_;
+    std::atomic_ref<unsigned>(*sq_tail_).store(sqe_tail_, std::memory_order_release);
+    sqe_submitted_ = sqe_tail_;
+
+    __kernel_timespec ts{};
+    ts.tv_sec = timeout_ms / 1000;
+    ts.tv_nsec = static_cast<long long>(timeout_ms % 1000) * 1'000'000;
+
+    io_uring_getevents_arg arg{};
+    arg.sigmask_sz = _NSIG / 8;
+    arg.ts = reinterpret_cast<uint64_t>(&ts);
+
+    const int ret = sys_enter(ring_fd_, to_submit, 1, IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG,
+                              &arg, sizeof(arg));
+    return ret < 0 ? -errno : ret;
+}
+
+io_uring_cqe* IoUring::peek_cqe() noexcept {
+    const unsigned head = *cq_head_;   // Only this thread advances it
+    const unsigned tail = std::atomic_ref<unsigned>(*cq_tail_).load(std::memory_order_acquire);
+    if (head == tail) return nullptr;
+    return &cqes_[head & cq_mask_];
+}
+
+void IoUring::cqe_seen() noexcept {
+    std::atomic_ref<unsigned>(*cq_head_).store(*cq_head_ + 1, std::memory_order_release);
+}
+
+int IoUring::register_files(const int* fds, unsigned count) noexcept {
+    const int ret = sys_register(ring_fd_, IORING_REGISTER_FILES, fds, count);
+    return ret < 0 ? -errno : 0;
+}
+
+int IoUring::unregister_files() noexcept {
+    const int ret = sys_register(ring_fd_, IORING_UNREGISTER_FILES, nullptr, 0);
+    return ret < 0 ? -errno : 0;
+}
+
+} // namespace matrix::network
@@ -1,15 +1,741 @@
 #include "network/WebSocket.hpp"
+#include "network/FrameParser.hpp"
+#include "network/Handshake.hpp"
+#include "network/IoUring.hpp"
+#include "telemetry/Telemetry.hpp"
 
-// Stub implementation - will be expanded with actual WebSocket client
-// using libwebsockets or similar library
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <ctime>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
 
 namespace matrix::network {
 
-// WebSocket client implementation will go here
-// Key features:
-// - Async connection management
-// - Automatic reconnection
-// - Message parsing for price feeds
-// - io_uring integration for kernel bypass
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr uint64_t RECV_TAG = 1;
+constexpr size_t MAX_HANDSHAKE_BYTES = 16 * 1024;
+constexpr size_t CONTROL_BYTES = CMSG_SPACE(sizeof(timespec));
+
+struct Endpoint {
+    std::string host;
+    std::string port;
+    std::string path;
+};
+
+/**
+ * Split ws://host[:port][/path]; hosts may be bracketed IPv6 literals
+ */
+std::optional<Endpoint> parse_url(std::string_view url, std::string& error) {
+    constexpr std::string_view SCHEME = "ws://";
+    if (url.starts_with("wss://")) {
+        error = "wss:// is not supported (no TLS)";
+        return std::nullopt;
+    }
+    if (!url.starts_with(SCHEME)) {
+        error = "URL must start with ws://";
+        return std::nullopt;
+    }
+    url.remove_prefix(SCHEME.size());
+
+    const size_t slash = url.find('/');
+    std::string_view authority = url.substr(0, slash);
+
+    Endpoint endpoint;
+    endpoint.path = slash == std::string_view::npos ? "/" : std::string(url.substr(slash));
+    endpoint.port = "80";
+
+    std::string_view port;
+    if (authority.starts_with('[')) {
+        const size_t close = authority.find(']');
+        if (close == std::string_view::npos) {
+            error = "URL has an unterminated IPv6 host";
+            return std::nullopt;
+        }
+        endpoint.host = std::string(authority.substr(1, close - 1));
+        if (close + 1 < authority.size() && authority[close + 1] == ':') port = authority.substr(close + 2);
+    } else {
+        const size_t colon = authority.rfind(':');
+        endpoint.host = std::string(authority.substr(0, colon));
+        if (colon != std::string_view::npos) port = authority.substr(colon + 1);
+    }
+
+    if (!port.empty()) endpoint.port = std::string(port);
+    if (endpoint.host.empty()) {
+        error = "URL has no host";
+        return std::nullopt;
+    }
+    return endpoint;
+}
+
+uint64_t realtime_ns() noexcept {
+    timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1'000'000'000ULL + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+int remaining_ms(Clock::time_point deadline) noexcept {
+    const auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - Clock::now()).count();
+    return left > 0 ? static_cast<int>(left) : 0;
+}
+
+bool wait_fd(int fd, short events, int timeout_ms) noexcept {
+    pollfd pfd{fd, events, 0};
+    int ret;
+    do {
+        ret = ::poll(&pfd, 1, timeout_ms);
+    } while (ret < 0 && errno == EINTR);
+    return ret > 0;
+}
+
+/**
+ * Write everything to a non-blocking socket, waiting for POLLOUT as needed
+ */
+bool send_all(int fd, const uint8_t* data, size_t len, int timeout_ms) noexcept {
+    const auto deadline = Clock::now() + std::chrono::milliseconds(timeout_ms);
+    while (len > 0) {
+        const ssize_t n = ::send(fd, data, len, MSG_NOSIGNAL);
+        if (n > 0) {
+            data += n;
+            len -= static_cast<size_t>(n);
+        } else if (n < 0 && errno == EINTR) {
+            continue;
+        } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            if (!wait_fd(fd, POLLOUT, remaining_ms(deadline))) return false;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Non-blocking TCP connect to the first address that answers in time
+ */
+int open_socket(const Endpoint& endpoint, int timeout_ms, std::string& error) {
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+
+    addrinfo* result = nullptr;
+    const int rc = ::getaddrinfo(endpoint.host.c_str(), endpoint.port.c_str(), &hints, &result);
+    if (rc != 0) {
+        error = "resolve " + endpoint.host + ": " + ::gai_strerror(rc);
+        return -1;
+    }
+
+    int fd = -1;
+    error = "connect " + endpoint.host + ":" + endpoint.port + ": no address answered";
+    for (addrinfo* ai = result; ai != nullptr && fd < 0; ai = ai->ai_next) {
+        const int s = ::socket(ai->ai_family, ai->ai_socktype | SOCK_NONBLOCK | SOCK_CLOEXEC, ai->ai_protocol);
+        if (s < 0) continue;
+
+        if (::connect(s, ai->ai_addr, ai->ai_addrlen) == 0) {
+            fd = s;
+        } else if (errno == EINPROGRESS && wait_fd(s, POLLOUT, timeout_ms)) {
+            int so_error = 0;
+            socklen_t so_len = sizeof(so_error);
+            ::getsockopt(s, SOL_SOCKET, SO_ERROR, &so_error, &so_len);
+            if (so_error == 0) {
+                fd = s;
+            } else {
+                error = "connect " + endpoint.host + ":" + endpoint.port + ": " + std::strerror(so_error);
+            }
+        }
+        if (fd < 0) ::close(s);
+    }
+    ::freeaddrinfo(result);
+    return fd;
+}
+
+bool iequals(std::string_view a, std::string_view b) noexcept {
+    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+        return (x | 0x20) == (y | 0x20);
+    });
+}
+
+/**
+ * Value of HTTP header `name` (case-insensitive), empty if absent
+ */
+std::string_view header_value(std::string_view head, std::string_view name) noexcept {
+    size_t pos = head.find("\r\n");
+    while (pos != std::string_view::npos && pos + 2 < head.size()) {
+        const size_t start = pos + 2;
+        const size_t end = head.find("\r\n", start);
+        const std::string_view line = head.substr(start, end - start);
+        const size_t colon = line.find(':');
+        if (colon != std::string_view::npos && iequals(line.substr(0, colon), name)) {
+            std::string_view value = line.substr(colon + 1);
+            while (!value.empty() && value.front() == ' ') value.remove_prefix(1);
+            while (!value.empty() && value.back() == ' ') value.remove_suffix(1);
+            return value;
+        }
+        pos = end;
+    }
+    return {};
+}
+
+/**
+ * HTTP upgrade (RFC 6455 section 4.1); bytes the server sent after the
+ * response head are frames and go to `rx`
+ */
+bool handshake(int fd, const Endpoint& endpoint, ws::RxBuffer& rx, int timeout_ms, std::string& error) {
+    const auto deadline = Clock::now() + std::chrono::milliseconds(timeout_ms);
+
+    std::random_device rd;
+    uint8_t nonce[16];
+    for (uint8_t& b : nonce) b = static_cast<uint8_t>(rd());
+    const std::string key = ws::base64(nonce, sizeof(nonce));
+
+    const std::string request =
+        "GET " + endpoint.path + " HTTP/1.1\r\n"
+        "Host: " + endpoint.host + ":" + endpoint.port + "\r\n"
+        "Upgrade: websocket\r\n"
+        "Connection: Upgrade\r\n"
+        "Sec-WebSocket-Key: " + key + "\r\n"
+        "Sec-WebSocket-Version: 13\r\n\r\n";
+    if (!send_all(fd, reinterpret_cast<const uint8_t*>(request.data()), request.size(), timeout_ms)) {
+        error = "handshake: send failed";
+        return false;
+    }
+
+    std::string response;
+    size_t head_end;
+    while ((head_end = response.find("\r\n\r\n")) == std::string::npos) {
+        if (response.size() > MAX_HANDSHAKE_BYTES) {
+            error = "handshake: response head too large";
+            return false;
+        }
+        if (!wait_fd(fd, POLLIN, remaining_ms(deadline))) {
+            error = "handshake: timed out";
+            return false;
+        }
+        char buf[4096];
+        const ssize_t n = ::recv(fd, buf, sizeof(buf), 0);
+        if (n < 0 && (errno == EAGAIN || errno == EINTR)) continue;
+        if (n <= 0) {
+            error = "handshake: connection closed";
+            return false;
+        }
+        response.append(buf, static_cast<size_t>(n));
+    }
+
+    const std::string_view head(response.data(), head_end + 2);
+    if (!head.starts_with("HTTP/1.1 101")) {
+        error = "handshake rejected: " + std::string(head.substr(0, head.find("\r\n")));
+        return false;
+    }
+    if (!iequals(header_value(head, "Upgrade"), "websocket") ||
+        header_value(head, "Sec-WebSocket-Accept") != ws::accept_key(key)) {
+        error = "handshake: bad upgrade response";
+        return false;
+    }
+
+    const size_t leftover = response.size() - (head_end + 4);
+    if (!rx.append(reinterpret_cast<const uint8_t*>(response.data()) + head_end + 4, leftover)) {
+        error = "handshake: first frames exceed rx buffer";
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+// ============================================================================
+// WebSocketClient
+// ============================================================================
+
+struct WebSocketClient::Impl {
+    Impl(WebSocketClient& owner, size_t rx_bytes) : owner(owner), rx(rx_bytes) {
+        std::random_device rd;
+        mask_state = (static_cast<uint64_t>(rd()) << 32) | rd() | 1;
+    }
+
+    ~Impl() {
+        if (epoll_fd >= 0) ::close(epoll_fd);
+        if (fd >= 0) ::close(fd);
+    }
+
+    WebSocketClient& owner;
+    ws::RxBuffer rx;
+    int fd = -1;
+    bool unprocessed = false;       // Handshake leftovers not dispatched yet
+    bool close_pending = false;     // Tear down once the current batch is dispatched
+
+    // io_uring transport; recvmsg state stays put while a recv is in flight
+    std::unique_ptr<IoUring> ring;
+    bool ring_failed = false;
+    bool fixed_file = false;
+    bool recv_armed = false;
+    msghdr msg{};
+    iovec iov{};
+    alignas(cmsghdr) uint8_t control[CONTROL_BYTES];
+
+    // epoll fallback
+    int epoll_fd = -1;
+
+    // Sending (any thread)
+    std::mutex send_mutex;
+    std::vector<uint8_t> tx;
+    uint64_t mask_state;
+    Clock::time_point last_ping;
+
+    void prepare_msg() noexcept {
+        const std::span<uint8_t> space = rx.writable();
+        iov = {space.data(), space.size()};
+        msg = {};
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+    }
+
+    /**
+     * SO_TIMESTAMPNS of the last segment read, 0 if the kernel gave none
+     */
+    [[nodiscard]] uint64_t receive_timestamp() noexcept {
+        for (cmsghdr* c = CMSG_FIRSTHDR(&msg); c != nullptr; c = CMSG_NXTHDR(&msg, c)) {
+            if (c->cmsg_level == SOL_SOCKET && c->cmsg_type == SCM_TIMESTAMPNS) {
+                timespec ts;
+                std::memcpy(&ts, CMSG_DATA(c), sizeof(ts));
+                return static_cast<uint64_t>(ts.tv_sec) * 1'000'000'000ULL + static_cast<uint64_t>(ts.tv_nsec);
+            }
+        }
+        return 0;
+    }
+
+    /**
+     * Masked single-frame send (client frames must be masked)
+     */
+    bool send_frame(ws::Opcode opcode, std::span<const uint8_t> payload) {
+        std::lock_guard lock(send_mutex);
+        if (fd < 0) return false;
+
+        mask_state ^= mask_state << 13;
+        mask_state ^= mask_state >> 7;
+        mask_state ^= mask_state << 17;
+        uint8_t mask[4];
+        std::memcpy(mask, &mask_state, sizeof(mask));
+
+        tx.resize(ws::MAX_HEADER_BYTES + payload.size());   // Capacity is kept between sends
+        const size_t header = ws::encode_header(tx.data(), opcode, payload.size(), mask);
+        if (!payload.empty()) std::memcpy(tx.data() + header, payload.data(), payload.size());
+        ws::unmask(tx.data() + header, payload.size(), mask);
+
+        if (!send_all(fd, tx.data(), header + payload.size(), owner.config_.timeout_ms)) {
+            ::shutdown(fd, SHUT_RDWR);   // The reader sees EOF and tears down
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * Parse and deliver every complete message in rx
+     */
+    size_t dispatch(uint64_t rx_timestamp_ns) {
+        size_t delivered = 0;
+        const ws::RxBuffer::Status status = rx.process([&](ws::Opcode opcode, std::span<const uint8_t> payload) {
+            switch (opcode) {
+                case ws::Opcode::TEXT:
+                case ws::Opcode::BINARY:
+                    ++delivered;
+                    if (owner.message_callback_) {
+                        owner.message_callback_(
+                            std::string_view(reinterpret_cast<const char*>(payload.data()), payload.size()));
+                    }
+                    break;
+                case ws::Opcode::PING:
+                    send_frame(ws::Opcode::PONG, payload);
+                    break;
+                case ws::Opcode::CLOSE:
+                    if (!close_pending) send_frame(ws::Opcode::CLOSE, payload.first(std::min<size_t>(payload.size(), 2)));
+                    close_pending = true;
+                    break;
+                default:
+                    break;
+            }
+        });
+
+        if (status == ws::RxBuffer::Status::PROTOCOL_ERROR) {
+            owner.report_error("WebSocket protocol error");
+            close_pending = true;
+        } else if (status == ws::RxBuffer::Status::MESSAGE_TOO_BIG) {
+            owner.report_error("WebSocket message exceeds rx_buffer_bytes");
+            close_pending = true;
+        }
+
+        if (delivered > 0) {
+            owner.messages_received_.fetch_add(delivered, std::memory_order_relaxed);
+            if (rx_timestamp_ns != 0) {
+                const uint64_t now = realtime_ns();
+                const uint64_t latency = now > rx_timestamp_ns ? now - rx_timestamp_ns : 0;
+                owner.last_latency_ns_.store(latency, std::memory_order_relaxed);
+                telemetry::record(telemetry::Stage::FEED_RECEIVE, latency);
+            }
+        }
+        return delivered;
+    }
+
+    /**
+     * Handle one recvmsg result (bytes or -errno)
+     */
+    size_t on_receive(int64_t result) {
+        if (result == 0) {
+            owner.report_error("WebSocket closed by peer");
+            close_pending = true;
+            return 0;
+        }
+        if (result < 0) {
+            if (result == -EAGAIN || result == -EINTR) return 0;
+            owner.report_error(std::string("WebSocket recv: ") + std::strerror(static_cast<int>(-result)));
+            close_pending = true;
+            return 0;
+        }
+        rx.commit(static_cast<size_t>(result));
+        owner.bytes_received_.fetch_add(static_cast<uint64_t>(result), std::memory_order_relaxed);
+        return dispatch(receive_timestamp());
+    }
+
+    size_t poll_uring(int timeout_ms) {
+        if (!recv_armed) {
+            io_uring_sqe* sqe = ring->get_sqe();
+            prepare_msg();
+            sqe->opcode = IORING_OP_RECVMSG;
+            sqe->fd = fixed_file ? 0 : fd;
+            if (fixed_file) sqe->flags |= IOSQE_FIXED_FILE;
+            sqe->addr = reinterpret_cast<uint64_t>(&msg);
+            sqe->len = 1;
+            sqe->user_data = RECV_TAG;
+            recv_armed = true;
+        }
+
+        const int ret = ring->submit_and_wait(timeout_ms);
+        if (ret < 0 && ret != -ETIME && ret != -EINTR) {
+            owner.report_error(std::string("io_uring_enter: ") + std::strerror(-ret));
+            close_pending = true;
+            return 0;
+        }
+
+        size_t delivered = 0;
+        while (io_uring_cqe* cqe = ring->peek_cqe()) {
+            const int result = cqe->res;
+            ring->cqe_seen();
+            recv_armed = false;
+            delivered += on_receive(result);
+        }
+        return delivered;
+    }
+
+    size_t poll_epoll(int timeout_ms) {
+        epoll_event event;
+        if (::epoll_wait(epoll_fd, &event, 1, timeout_ms) <= 0) return 0;
+
+        size_t delivered = 0;
+        while (!close_pending) {
+            prepare_msg();
+            const ssize_t n = ::recvmsg(fd, &msg, 0);
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+            delivered += on_receive(n < 0 ? -errno : n);
+        }
+        return delivered;
+    }
+
+    void teardown() {
+        {
+            std::lock_guard lock(send_mutex);
+            if (fd >= 0) ::shutdown(fd, SHUT_RDWR);
+        }
+
+        // The in-flight recv completes once the socket is shut down
+        const auto deadline = Clock::now() + std::chrono::milliseconds(owner.config_.timeout_ms);
+        while (recv_armed && Clock::now() < deadline) {
+            ring->submit_and_wait(remaining_ms(deadline));
+            while (ring->peek_cqe()) {
+                ring->cqe_seen();
+                recv_armed = false;
+            }
+        }
+        if (recv_armed) {
+            ring.reset();   // Closing the ring cancels the request
+            recv_armed = false;
+        } else if (fixed_file) {
+            ring->unregister_files();
+        }
+        fixed_file = false;
+
+        if (epoll_fd >= 0) ::close(epoll_fd);
+        epoll_fd = -1;
+        {
+            std::lock_guard lock(send_mutex);
+            if (fd >= 0) ::close(fd);
+            fd = -1;
+        }
+
+        rx.reset();
+        unprocessed = false;
+        close_pending = false;
+        owner.connected_.store(false, std::memory_order_release);
+    }
+};
+
+WebSocketClient::WebSocketClient(const Config& config)
+    : config_(config)
+    , impl_(std::make_unique<Impl>(*this, config.rx_buffer_bytes)) {}
+
+WebSocketClient::~WebSocketClient() {
+    disconnect();
+}
+
+void WebSocketClient::connect() {
+    if (connected_.load(std::memory_order_acquire)) return;
+
+    std::string error;
+    const std::optional<Endpoint> endpoint = parse_url(config_.url, error);
+    if (!endpoint) {
+        report_error(error);
+        return;
+    }
+
+    const int fd = open_socket(*endpoint, config_.timeout_ms, error);
+    if (fd < 0) {
+        report_error(error);
+        return;
+    }
+
+    impl_->rx.reset();
+    if (!handshake(fd, *endpoint, impl_->rx, config_.timeout_ms, error)) {
+        ::close(fd);
+        impl_->rx.reset();
+        report_error(error);
+        return;
+    }
+
+    const int one = 1;
+    ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    ::setsockopt(fd, SOL_SOCKET, SO_TIMESTAMPNS, &one, sizeof(one));
+
+    if (config_.use_io_uring && !impl_->ring && !impl_->ring_failed) {
+        try {
+            impl_->ring = std::make_unique<IoUring>();
+        } catch (const std::system_error&) {
+            impl_->ring_failed = true;   // Stay on epoll for this client
+        }
+    }
+
+    if (config_.use_io_uring && impl_->ring) {
+        impl_->fixed_file = impl_->ring->register_files(&fd, 1) == 0;
+    } else {
+        impl_->epoll_fd = ::epoll_create1(EPOLL_CLOEXEC);
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        if (impl_->epoll_fd < 0 || ::epoll_ctl(impl_->epoll_fd, EPOLL_CTL_ADD, fd, &event) < 0) {
+            if (impl_->epoll_fd >= 0) ::close(impl_->epoll_fd);
+            impl_->epoll_fd = -1;
+            ::close(fd);
+            report_error(std::string("epoll: ") + std::strerror(errno));
+            return;
+        }
+    }
+
+    {
+        std::lock_guard lock(impl_->send_mutex);
+        impl_->fd = fd;
+    }
+    impl_->unprocessed = impl_->rx.buffered() > 0;
+    bytes_received_.fetch_add(impl_->rx.buffered(), std::memory_order_relaxed);
+    impl_->last_ping = Clock::now();
+    connected_.store(true, std::memory_order_release);
+
+    if (connect_callback_) connect_callback_();
+}
+
+void WebSocketClient::disconnect() {
+    if (!connected_.load(std::memory_order_acquire)) return;
+
+    const uint8_t normal_closure[2] = {0x03, 0xE8};   // 1000
+    impl_->send_frame(ws::Opcode::CLOSE, normal_closure);
+    impl_->teardown();
+}
+
+bool WebSocketClient::is_connected() const noexcept {
+    return connected_.load(std::memory_order_acquire);
+}
+
+size_t WebSocketClient::poll(int timeout_ms) {
+    if (!connected_.load(std::memory_order_acquire)) return 0;
+
+    size_t delivered = 0;
+    if (impl_->unprocessed) {
+        impl_->unprocessed = false;
+        delivered += impl_->dispatch(0);
+    }
+
+    if (config_.ping_interval_ms > 0 &&
+        Clock::now() - impl_->last_ping >= std::chrono::milliseconds(config_.ping_interval_ms)) {
+        impl_->send_frame(ws::Opcode::PING, {});
+        impl_->last_ping = Clock::now();
+    }
+
+    if (!impl_->close_pending) {
+        const int wait_ms = delivered > 0 ? 0 : timeout_ms;
+        delivered += impl_->ring ? impl_->poll_uring(wait_ms) : impl_->poll_epoll(wait_ms);
+    }
+
+    if (impl_->close_pending) impl_->teardown();
+    return delivered;
+}
+
+void WebSocketClient::send(std::string_view message) {
+    if (!connected_.load(std::memory_order_acquire)) {
+        report_error("WebSocket send: not connected");
+        return;
+    }
+    const auto* bytes = reinterpret_cast<const uint8_t*>(message.data());
+    if (!impl_->send_frame(ws::Opcode::TEXT, std::span<const uint8_t>(bytes, message.size()))) {
+        report_error("WebSocket send failed");
+    }
+}
+
+void WebSocketClient::on_message(MessageCallback callback) {
+    message_callback_ = std::move(callback);
+}
+
+void WebSocketClient::on_error(ErrorCallback callback) {
+    error_callback_ = std::move(callback);
+}
+
+void WebSocketClient::on_connect(ConnectCallback callback) {
+    connect_callback_ = std::move(callback);
+}
+
+uint64_t WebSocketClient::messages_received() const noexcept {
+    return messages_received_.load(std::memory_order_relaxed);
+}
+
+uint64_t WebSocketClient::bytes_received() const noexcept {
+    return bytes_received_.load(std::memory_order_relaxed);
+}
+
+uint64_t WebSocketClient::latency_ns() const noexcept {
+    return last_latency_ns_.load(std::memory_order_relaxed);
+}
+
+bool WebSocketClient::using_io_uring() const noexcept {
+    return impl_->ring != nullptr && impl_->epoll_fd < 0;
+}
+
+void WebSocketClient::report_error(const std::string& error) {
+    if (error_callback_) error_callback_(error);
+}
+
+// ============================================================================
+// WebSocketManager
+// ============================================================================
+
+namespace {
+constexpr int READER_POLL_MS = 100;     // Bounds stop() latency
+} // namespace
+
+struct WebSocketManager::Impl {
+    std::mutex mutex;
+    std::map<std::string, std::unique_ptr<WebSocketClient>> clients;
+    std::vector<std::thread> readers;
+    std::atomic<bool> running{false};
+
+    void read_loop(WebSocketClient& client) {
+        while (running.load(std::memory_order_acquire)) {
+            if (!client.is_connected()) {
+                client.connect();
+                if (!client.is_connected()) {
+                    const auto retry_at = Clock::now() + std::chrono::milliseconds(client.config().reconnect_delay_ms);
+                    while (running.load(std::memory_order_acquire) && Clock::now() < retry_at) {
+                        std::this_thread::sleep_for(std::chrono::milliseconds(
+                            std::min(remaining_ms(retry_at), READER_POLL_MS)));
+                    }
+                    continue;
+                }
+            }
+            client.poll(READER_POLL_MS);
+        }
+        client.disconnect();
+    }
+};
+
+WebSocketManager::WebSocketManager() : impl_(std::make_unique<Impl>()) {}
+
+WebSocketManager::~WebSocketManager() {
+    stop_all();
+}
+
+void WebSocketManager::add_connection(const std::string& name, const WebSocketClient::Config& config) {
+    std::lock_guard lock(impl_->mutex);
+    if (impl_->running.load(std::memory_order_relaxed)) {
+        throw std::logic_error("WebSocketManager: add_connection while running");
+    }
+    if (!impl_->clients.emplace(name, std::make_unique<WebSocketClient>(config)).second) {
+        throw std::invalid_argument("WebSocketManager: duplicate connection name");
+    }
+}
+
+void WebSocketManager::remove_connection(const std::string& name) {
+    std::lock_guard lock(impl_->mutex);
+    if (impl_->running.load(std::memory_order_relaxed)) {
+        throw std::logic_error("WebSocketManager: remove_connection while running");
+    }
+    impl_->clients.erase(name);
+}
+
+WebSocketClient* WebSocketManager::get_connection(const std::string& name) {
+    std::lock_guard lock(impl_->mutex);
+    const auto it = impl_->clients.find(name);
+    return it == impl_->clients.end() ? nullptr : it->second.get();
+}
+
+void WebSocketManager::start_all() {
+    std::lock_guard lock(impl_->mutex);
+    if (impl_->running.exchange(true, std::memory_order_acq_rel)) return;
+    for (auto& [name, client] : impl_->clients) {
+        impl_->readers.emplace_back([impl = impl_.get(), c = client.get()] { impl->read_loop(*c); });
+    }
+}
+
+void WebSocketManager::stop_all() {
+    std::lock_guard lock(impl_->mutex);
+    impl_->running.store(false, std::memory_order_release);
+    impl_->running.notify_all();
+    for (std::thread& reader : impl_->readers) {
+        if (reader.joinable()) reader.join();
+    }
+    impl_->readers.clear();
+}
+
+void WebSocketManager::run() {
+    // Returns at once if not started
+    impl_->running.wait(true, std::memory_order_acquire);
+}
+
+void WebSocketManager::stop() {
+    stop_all();
+}
 
 } // namespace matrix::network
@@ -0,0 +1,432 @@
+#include "orderbook/BookSnapshot.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define MATRIX_HAS_MMAP 1
+#endif
+
+namespace matrix::orderbook {
+
+namespace {
+
+constexpr size_t SECTION_ALIGN = 64;
+
+constexpr size_t align_up(size_t n) noexcept {
+    return (n + SECTION_ALIGN - 1) & ~(SECTION_ALIGN - 1);
+}
+
+constexpr size_t HEADER_BYTES = align_up(sizeof(BookSnapshotHeader));
+
+// Multiply-xor hash over four interleaved word lanes (independent multiply
+// chains, so it runs at memory speed): enough to catch a torn or truncated
+// file without dominating the restore
+uint64_t hash_bytes(const std::byte* data, size_t size) noexcept {
+    constexpr uint64_t PRIME = 0x100000001b3ULL;
+    uint64_t lanes[4] = {0x9E3779B97F4A7C15ULL ^ size, 0xC2B2AE3D27D4EB4FULL,
+                         0x165667B19E3779F9ULL, 0x27D4EB2F165667C5ULL};
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        for (size_t lane = 0; lane < 4; ++lane) {
+            uint64_t word;
+            std::memcpy(&word, data + i + lane * 8, sizeof(word));
+            lanes[lane] = (lanes[lane] ^ word) * PRIME;
+        }
+    }
+    uint64_t h = mix64(lanes[0]) ^ mix64(lanes[1] + 1) ^ mix64(lanes[2] + 2) ^ mix64(lanes[3] + 3);
+    for (; i + 8 <= size; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, data + i, sizeof(word));
+        h = (h ^ mix64(word)) * PRIME;
+    }
+    uint64_t tail = 0;
+    std::memcpy(&tail, data + i, size - i);
+    return mix64(h ^ tail);
+}
+
+uint64_t image_checksum(std::span<const std::byte> image, uint64_t total) noexcept {
+    // Hash with the checksum field read as zero
+    constexpr size_t field = offsetof(BookSnapshotHeader, checksum);
+    std::byte head[HEADER_BYTES];
+    std::memcpy(head, image.data(), HEADER_BYTES);
+    std::memset(head + field, 0, sizeof(uint64_t));
+    return mix64(hash_bytes(head, HEADER_BYTES) ^ hash_bytes(image.data() + HEADER_BYTES, total - HEADER_BYTES));
+}
+
+bool read_header(std::span<const std::byte> image, BookSnapshotHeader& header) noexcept {
+    if (image.size() < HEADER_BYTES) return false;
+    std::memcpy(&header, image.data(), sizeof(header));
+    return header.magic == BookSnapshotHeader::MAGIC &&
+           header.version == BookSnapshotHeader::VERSION &&
+           header.section_count == BookSnapshotHeader::SECTIONS &&
+           header.total_bytes >= HEADER_BYTES &&
+           header.total_bytes <= image.size();
+}
+
+uint64_t realtime_ns() noexcept {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+}
+
+} // namespace
+
+// ============================================================================
+// OrderBook snapshot image
+// ============================================================================
+
+std::array<OrderBook::SnapshotArray, OrderBook::SNAPSHOT_ARRAYS> OrderBook::snapshot_arrays(
+    size_t slots, size_t pools, size_t tokens, size_t pairs) const noexcept {
+    const auto array = [](const auto* data, size_t count) {
+        return SnapshotArray{const_cast<void*>(static_cast<const void*>(data)), count * sizeof(*data)};
+    };
+    return {{
+        array(cols_.pool_hash, slots),
+        array(cols_.reserve0, slots),
+        array(cols_.reserve1, slots),
+        array(cols_.last_update_ns, slots),
+        array(cols_.fee_bps, slots),
+        array(cols_.chain, slots),
+        array(cols_.dex, slots),
+        array(cols_.pool_id, slots),
+        array(cols_.pair_id, slots),
+        array(cols_.decimals0, slots),
+        array(cols_.decimals1, slots),
+        array(cols_.flags, slots),
+        array(slot_of_, pools),
+        array(pool_tokens_, pools),
+        array(token_hashes_, tokens),
+        array(pair_entries_, pairs),
+    }};
+}
+
+uint64_t OrderBook::snapshot_layout() const noexcept {
+    uint64_t h = 0;
+    for (const uint64_t v : {uint64_t{MAX_POOLS}, uint64_t{MAX_TOKENS}, uint64_t{MAX_PAIRS}, uint64_t{MAX_SLOTS},
+                             uint64_t{sizeof(PairEntry)}, uint64_t{sizeof(PoolTokenIds)},
+                             uint64_t{sizeof(ChainId)}, uint64_t{sizeof(DexId)},
+                             uint64_t{pool_index_.table_bytes()}, uint64_t{token_index_.table_bytes()},
+                             uint64_t{pair_index_.table_bytes()}}) {
+        h = mix64(h ^ v);
+    }
+    return h;
+}
+
+size_t OrderBook::snapshot_size() const noexcept {
+    size_t size = HEADER_BYTES;
+    const size_t slots = seqlock::load(slot_top_);
+    for (const SnapshotArray& array : snapshot_arrays(slots, pool_count(), token_count(), pair_count())) {
+        size += align_up(array.bytes);
+    }
+    size += align_up(pool_index_.table_bytes());
+    size += align_up(token_index_.table_bytes());
+    size += align_up(pair_index_.table_bytes());
+    return size;
+}
+
+size_t OrderBook::max_snapshot_size() const noexcept {
+    size_t size = HEADER_BYTES;
+    for (const SnapshotArray& array : snapshot_arrays(MAX_SLOTS, MAX_POOLS, MAX_TOKENS, MAX_PAIRS)) {
+        size += align_up(array.bytes);
+    }
+    size += align_up(pool_index_.table_bytes());
+    size += align_up(token_index_.table_bytes());
+    size += align_up(pair_index_.table_bytes());
+    return size;
+}
+
+size_t OrderBook::write_snapshot(std::span<std::byte> out) const noexcept {
+    // Reserves are copied per slot under their seqlocks; everything else
+    // only changes with pool creation, which makes the whole copy retry
+    constexpr size_t RESERVE0 = 1, RESERVE1 = 2, UPDATED = 3;
+
+    for (int attempt = 0; attempt < SNAPSHOT_ATTEMPTS; ++attempt) {
+        const uint32_t topology = seqlock::read_begin(topology_seq_);
+        const size_t slots = seqlock::load(slot_top_);
+        const size_t pools = pool_count();
+        const size_t tokens = token_count();
+        const size_t pairs = pair_count();
+        const auto arrays = snapshot_arrays(slots, pools, tokens, pairs);
+
+        size_t total = HEADER_BYTES;
+        for (const SnapshotArray& array : arrays) total += align_up(array.bytes);
+        total += align_up(pool_index_.table_bytes());
+        total += align_up(token_index_.table_bytes());
+        total += align_up(pair_index_.table_bytes());
+        if (out.size() < total) return 0;
+
+        BookSnapshotHeader header{};
+        header.magic = BookSnapshotHeader::MAGIC;
+        header.version = BookSnapshotHeader::VERSION;
+        header.section_count = BookSnapshotHeader::SECTIONS;
+        header.total_bytes = total;
+        header.layout = snapshot_layout();
+        header.created_ns = realtime_ns();
+        header.last_update_ns = seqlock::load(last_update_ns_);
+        header.pool_count = pools;
+        header.token_count = tokens;
+        header.pair_count = pairs;
+        header.slot_count = slots;
+
+        size_t offset = HEADER_BYTES;
+        size_t section = 0;
+        const auto emit = [&](const void* data, size_t bytes) {
+            header.sections[section++] = {offset, bytes};
+            if (data) std::memcpy(out.data() + offset, data, bytes);
+            // Zero the alignment padding so equal books give equal images
+            std::memset(out.data() + offset + bytes, 0, align_up(bytes) - bytes);
+            offset += align_up(bytes);
+        };
+        for (size_t a = 0; a < SNAPSHOT_ARRAYS; ++a) {
+            emit(a >= RESERVE0 && a <= UPDATED ? nullptr : arrays[a].data, arrays[a].bytes);
+        }
+        emit(pool_index_.table_data(), pool_index_.table_bytes());
+        emit(token_index_.table_data(), token_index_.table_bytes());
+        emit(pair_index_.table_data(), pair_index_.table_bytes());
+
+        auto* reserve0 = reinterpret_cast<uint64_t*>(out.data() + header.sections[RESERVE0].offset);
+        auto* reserve1 = reinterpret_cast<uint64_t*>(out.data() + header.sections[RESERVE1].offset);
+        auto* updated = reinterpret_cast<uint64_t*>(out.data() + header.sections[UPDATED].offset);
+        for (size_t slot = 0; slot < slots; ++slot) {
+            uint32_t seq;
+            do {
+                seq = seqlock::read_begin(cols_.seq[slot]);
+                reserve0[slot] = seqlock::load(cols_.reserve0[slot]);
+                reserve1[slot] = seqlock::load(cols_.reserve1[slot]);
+                updated[slot] = seqlock::load(cols_.last_update_ns[slot]);
+            } while (seqlock::read_retry(cols_.seq[slot], seq));
+        }
+
+        if (seqlock::read_retry(topology_seq_, topology)) continue;
+        std::memset(out.data(), 0, HEADER_BYTES);
+        std::memcpy(out.data(), &header, sizeof(header));
+        return total;
+    }
+    return 0;
+}
+
+bool OrderBook::restore_snapshot(std::span<const std::byte> image) noexcept {
+    if (pool_count_ != 0) return false;
+
+    BookSnapshotHeader header;
+    if (!verify_snapshot(image) || !read_header(image, header)) return false;
+    if (header.layout != snapshot_layout() ||
+        header.pool_count > MAX_POOLS || header.token_count > MAX_TOKENS ||
+        header.pair_count > MAX_PAIRS || header.slot_count > MAX_SLOTS) {
+        return false;
+    }
+
+    // Every section must be exactly the size these counts imply
+    const auto arrays = snapshot_arrays(header.slot_count, header.pool_count, header.token_count, header.pair_count);
+    const size_t tables[3] = {pool_index_.table_bytes(), token_index_.table_bytes(), pair_index_.table_bytes()};
+    for (size_t s = 0; s < BookSnapshotHeader::SECTIONS; ++s) {
+        const auto& section = header.sections[s];
+        const size_t expected = s < SNAPSHOT_ARRAYS ? arrays[s].bytes : tables[s - SNAPSHOT_ARRAYS];
+        if (section.bytes != expected || section.offset < HEADER_BYTES ||
+            section.offset > header.total_bytes || section.bytes > header.total_bytes - section.offset) {
+            return false;
+        }
+    }
+
+    const auto section_data = [&](size_t s) { return image.data() + header.sections[s].offset; };
+    const auto& tail = header.sections;
+    constexpr size_t POOLS = SNAPSHOT_ARRAYS, TOKENS = SNAPSHOT_ARRAYS + 1, PAIRS = SNAPSHOT_ARRAYS + 2;
+    if (!pool_index_.assign_table(section_data(POOLS), tail[POOLS].bytes, header.pool_count) ||
+        !token_index_.assign_table(section_data(TOKENS), tail[TOKENS].bytes, header.token_count) ||
+        !pair_index_.assign_table(section_data(PAIRS), tail[PAIRS].bytes, header.pair_count)) {
+        pool_index_.clear();
+        token_index_.clear();
+        pair_index_.clear();
+        return false;
+    }
+    for (size_t s = 0; s < SNAPSHOT_ARRAYS; ++s) {
+        std::memcpy(arrays[s].data, section_data(s), arrays[s].bytes);
+    }
+
+    // Ids and slots index other arrays unchecked later: bound them now
+    bool consistent = true;
+    for (size_t id = 0; id < header.pool_count; ++id) {
+        consistent &= slot_of_[id] < header.slot_count &&
+                      pool_tokens_[id].token0 < header.token_count &&
+                      pool_tokens_[id].token1 < header.token_count;
+    }
+    for (size_t p = 0; p < header.pair_count; ++p) {
+        const PairEntry& entry = pair_entries_[p];
+        consistent &= entry.count <= entry.capacity && entry.first_slot <= header.slot_count &&
+                      entry.capacity <= header.slot_count - entry.first_slot;
+    }
+    if (!consistent) {
+        pool_index_.clear();
+        token_index_.clear();
+        pair_index_.clear();
+        return false;
+    }
+
+    std::fill_n(cols_.seq, header.slot_count, 0u);
+    std::atomic_ref<size_t>(pool_count_).store(header.pool_count, std::memory_order_release);
+    slot_top_ = header.slot_count;
+    last_update_ns_ = header.last_update_ns;
+
+    // Everything restored is unscanned: one dirty batch of every pool
+    dirty_count_ = 0;
+    dirty_epoch_ = 1;
+    for (uint32_t id = 0; id < pool_count_; ++id) {
+        dirty_mark_[id] = dirty_epoch_;
+        dirty_ids_[dirty_count_++] = id;
+    }
+    return true;
+}
+
+// ============================================================================
+// Images and files
+// ============================================================================
+
+bool seal_snapshot(std::span<std::byte> image) noexcept {
+    BookSnapshotHeader header;
+    if (!read_header(image, header)) return false;
+    const uint64_t checksum = image_checksum(image, header.total_bytes);
+    std::memcpy(image.data() + offsetof(BookSnapshotHeader, checksum), &checksum, sizeof(checksum));
+    return true;
+}
+
+bool verify_snapshot(std::span<const std::byte> image) noexcept {
+    BookSnapshotHeader header;
+    return read_header(image, header) && header.checksum == image_checksum(image, header.total_bytes);
+}
+
+bool write_snapshot_file(const std::string& path, std::span<const std::byte> image) {
+    const std::string tmp = path + ".tmp";
+    std::FILE* file = std::fopen(tmp.c_str(), "wb");
+    if (!file) return false;
+    const bool written = std::fwrite(image.data(), 1, image.size(), file) == image.size();
+    if (std::fclose(file) != 0 || !written) {
+        std::remove(tmp.c_str());
+        return false;
+    }
+    return std::rename(tmp.c_str(), path.c_str()) == 0;
+}
+
+bool save_snapshot(const OrderBook& book, const std::string& path) {
+    auto image = std::make_unique<std::byte[]>(book.snapshot_size());
+    const std::span<std::byte> bytes(image.get(), book.snapshot_size());
+    const size_t length = book.write_snapshot(bytes);
+    return length != 0 && seal_snapshot(bytes) && write_snapshot_file(path, bytes.first(length));
+}
+
+bool load_snapshot(OrderBook& book, const std::string& path) noexcept {
+    try {
+        const MappedSnapshot mapped(path);
+        return book.restore_snapshot(mapped.bytes());
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+// ============================================================================
+// MappedSnapshot
+// ============================================================================
+
+MappedSnapshot::MappedSnapshot(const std::string& path) {
+#ifdef MATRIX_HAS_MMAP
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw std::runtime_error("MappedSnapshot: cannot open " + path);
+    struct stat st{};
+    if (::fstat(fd, &st) != 0 || st.st_size <= 0) {
+        ::close(fd);
+        throw std::runtime_error("MappedSnapshot: empty or unreadable " + path);
+    }
+    size_ = static_cast<size_t>(st.st_size);
+#ifdef MAP_POPULATE
+    constexpr int flags = MAP_PRIVATE | MAP_POPULATE;   // One pass of read-ahead, no page faults in restore
+#else
+    constexpr int flags = MAP_PRIVATE;
+#endif
+    void* mem = ::mmap(nullptr, size_, PROT_READ, flags, fd, 0);
+    ::close(fd);   // The mapping keeps the file referenced
+    if (mem == MAP_FAILED) throw std::runtime_error("MappedSnapshot: cannot map " + path);
+    data_ = static_cast<const std::byte*>(mem);
+#else
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) throw std::runtime_error("MappedSnapshot: cannot open " + path);
+    std::fseek(file, 0, SEEK_END);
+    const long length = std::ftell(file);
+    std::fseek(file, 0, SEEK_SET);
+    if (length <= 0) {
+        std::fclose(file);
+        throw std::runtime_error("MappedSnapshot: empty or unreadable " + path);
+    }
+    size_ = static_cast<size_t>(length);
+    copy_ = std::make_unique<std::byte[]>(size_);
+    const bool read = std::fread(copy_.get(), 1, size_, file) == size_;
+    std::fclose(file);
+    if (!read) throw std::runtime_error("MappedSnapshot: short read " + path);
+    data_ = copy_.get();
+#endif
+}
+
+MappedSnapshot::~MappedSnapshot() {
+#ifdef MATRIX_HAS_MMAP
+    if (data_) ::munmap(const_cast<std::byte*>(data_), size_);
+#endif
+}
+
+// ============================================================================
+// SnapshotWriter
+// ============================================================================
+
+SnapshotWriter::SnapshotWriter(const OrderBook& book, std::string path)
+    : book_(book), path_(std::move(path)), buffer_bytes_(book.max_snapshot_size()) {
+    // Uninitialized: pages are committed as copies first reach them
+    buffer_.reset(new std::byte[buffer_bytes_]);
+    writer_ = std::thread([this] { run(); });
+}
+
+SnapshotWriter::~SnapshotWriter() {
+    running_.store(false, std::memory_order_seq_cst);
+    signal_.fetch_add(1, std::memory_order_release);
+    signal_.notify_one();
+    if (writer_.joinable()) writer_.join();
+}
+
+bool SnapshotWriter::capture() noexcept {
+    if (pending_.exchange(true, std::memory_order_seq_cst)) {
+        skipped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    signal_.fetch_add(1, std::memory_order_release);
+    signal_.notify_one();
+    return true;
+}
+
+void SnapshotWriter::run() noexcept {
+    for (;;) {
+        const uint32_t seen = signal_.load(std::memory_order_acquire);
+        if (!pending_.load(std::memory_order_seq_cst)) {
+            if (!running_.load(std::memory_order_seq_cst)) return;
+            signal_.wait(seen, std::memory_order_acquire);
+            continue;
+        }
+
+        const size_t length = book_.write_snapshot({buffer_.get(), buffer_bytes_});
+        const std::span<std::byte> image(buffer_.get(), length);
+        bool ok = length != 0 && seal_snapshot(image);
+        try {
+            ok = ok && write_snapshot_file(path_, image);
+        } catch (...) {
+            ok = false;
+        }
+        (ok ? written_ : failed_).fetch_add(1, std::memory_order_relaxed);
+        pending_.store(false, std::memory_order_seq_cst);
+    }
+}
+
+} // namespace matrix::orderbook
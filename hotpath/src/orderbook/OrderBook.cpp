@@ -1,119 +1,366 @@
 #include "orderbook/OrderBook.hpp"
 #include <algorithm>
+#include <new>
 
 namespace matrix::orderbook {
 
-const std::vector<PoolState*> OrderBook::empty_pools_;
+OrderBook::OrderBook(memory::Arena& arena)
+    : arena_(arena)
+    , pool_index_(arena, MAX_POOLS)
+    , token_index_(arena, MAX_TOKENS)
+    , pair_index_(arena, MAX_PAIRS) {
+    // One cache-line-aligned column per field
+    cols_.pool_hash = allocate_array<uint64_t>(MAX_SLOTS);
+    cols_.reserve0 = allocate_array<uint64_t>(MAX_SLOTS);
+    cols_.reserve1 = allocate_array<uint64_t>(MAX_SLOTS);
+    cols_.last_update_ns = allocate_array<uint64_t>(MAX_SLOTS);
+    cols_.fee_bps = allocate_array<uint32_t>(MAX_SLOTS);
+    cols_.chain = allocate_array<ChainId>(MAX_SLOTS);
+    cols_.dex = allocate_array<DexId>(MAX_SLOTS);
+    cols_.pool_id = allocate_array<uint32_t>(MAX_SLOTS);
+    cols_.pair_id = allocate_array<uint32_t>(MAX_SLOTS);
+    cols_.decimals0 = allocate_array<uint8_t>(MAX_SLOTS);
+    cols_.decimals1 = allocate_array<uint8_t>(MAX_SLOTS);
+    cols_.flags = allocate_array<uint8_t>(MAX_SLOTS);
+    cols_.seq = allocate_array<uint32_t>(MAX_SLOTS);
 
-OrderBook::OrderBook(memory::Arena& arena) : arena_(arena) {
-    // Reserve space in hash maps
-    pair_pools_.reserve(10000);
-    pool_index_.reserve(MAX_POOLS);
-    token_set_.reserve(MAX_TOKENS);
+    slot_of_ = allocate_array<uint32_t>(MAX_POOLS);
+    pool_tokens_ = allocate_array<PoolTokenIds>(MAX_POOLS);
+    token_hashes_ = allocate_array<uint64_t>(MAX_TOKENS);
+    dirty_ids_ = allocate_array<uint32_t>(MAX_POOLS);
+    dirty_mark_ = allocate_array<uint32_t>(MAX_POOLS);
+    pair_entries_ = allocate_array<PairEntry>(MAX_PAIRS);
 }
 
-size_t OrderBook::process_updates(PriceQueue& queue) noexcept {
-    size_t count = 0;
-    PriceUpdate update;
-
-    while (queue.try_pop(update)) {
-        update_pool(update);
-        count++;
+template<typename T>
+T* OrderBook::allocate_array(size_t count) {
+    void* mem = arena_.allocate(count * sizeof(T), alignof(T) > 64 ? alignof(T) : 64);
+    if (!mem) {
+        throw std::bad_alloc();
     }
-
-    return count;
+    return static_cast<T*>(mem);
 }
 
 void OrderBook::update_pool(const PriceUpdate& update) noexcept {
-    // Get or create pool
-    PoolState* pool = get_or_create_pool(update.pool_hash);
-    if (!pool) return;
+    // Fast path: known pool, reserves-only update (one probe, no allocation)
+    uint32_t id;
+    uint32_t slot;
+    if (const uint32_t* found = pool_index_.find(update.pool_hash)) {
+        id = *found;
+        slot = slot_of_[id];
+    } else {
+        // Lookups on other threads retry until the pool is fully built
+        const uint32_t topology = seqlock::write_begin(topology_seq_);
+        slot = create_pool(update);
+        seqlock::write_end(topology_seq_, topology);
+        if (slot == INVALID_INDEX) {
+            ++rejected_updates_;
+            return;
+        }
+        id = cols_.pool_id[slot];
+    }
+
+    // A pool already dirty has an unread snapshot: this one replaces it
+    if (dirty_mark_[id] != dirty_epoch_) {
+        dirty_mark_[id] = dirty_epoch_;
+        dirty_ids_[dirty_count_++] = id;
+    } else {
+        ++coalesced_updates_;
+    }
 
-    // Update pool state
-    pool->chain = static_cast<ChainId>(update.chain_id);
-    pool->dex = static_cast<DexId>(update.dex_id);
-    pool->token0_hash = update.token0;
-    pool->token1_hash = update.token1;
-    pool->reserve0 = update.reserve0;
-    pool->reserve1 = update.reserve1;
-    pool->last_update_ns = update.timestamp_ns;
+    write_reserves(slot, update);
+    seqlock::store(last_update_ns_, update.timestamp_ns);  // Read by snapshots off-thread
+}
 
-    // Update token set
-    token_set_.insert(update.token0);
-    token_set_.insert(update.token1);
+void OrderBook::write_reserves(uint32_t slot, const PriceUpdate& update) noexcept {
+    // Store reserves in the pair's canonical orientation
+    const bool reversed = update.token0 > update.token1;
+    const uint32_t seq = seqlock::write_begin(cols_.seq[slot]);
+    seqlock::store(cols_.reserve0[slot], reversed ? update.reserve1 : update.reserve0);
+    seqlock::store(cols_.reserve1[slot], reversed ? update.reserve0 : update.reserve1);
+    seqlock::store(cols_.last_update_ns[slot], update.timestamp_ns);
+    seqlock::write_end(cols_.seq[slot], seq);
+}
 
-    // Update pair mapping
-    PairKey key{update.token0, update.token1};
-    auto& pools = pair_pools_[key];
-    if (std::find(pools.begin(), pools.end(), pool) == pools.end()) {
-        pools.push_back(pool);
+void OrderBook::clear_dirty() noexcept {
+    dirty_count_ = 0;
+    if (++dirty_epoch_ == 0) {
+        // Epoch wrapped: stale marks could alias the new epoch
+        std::fill_n(dirty_mark_, pool_count_, 0u);
+        dirty_epoch_ = 1;
     }
+}
 
-    // Also add reverse pair
-    PairKey reverse_key{update.token1, update.token0};
-    auto& reverse_pools = pair_pools_[reverse_key];
-    if (std::find(reverse_pools.begin(), reverse_pools.end(), pool) == reverse_pools.end()) {
-        reverse_pools.push_back(pool);
-    }
+PoolRange OrderBook::get_pools(uint64_t token0, uint64_t token1) const noexcept {
+    const PairKey key = PairKey::canonical(token0, token1);
+    return read_topology([&] {
+        const uint32_t* pair = pair_index_.find(key);
+        if (!pair) {
+            return PoolRange(this, 0, 0);
+        }
+        const PairEntry& entry = pair_entries_[*pair];
+        return PoolRange(this, entry.first_slot, entry.count);
+    });
+}
 
-    last_update_ns_ = update.timestamp_ns;
+uint32_t OrderBook::find_pool_id(uint64_t pool_hash) const noexcept {
+    return read_topology([&] {
+        const uint32_t* id = pool_index_.find(pool_hash);
+        return id ? *id : INVALID_INDEX;
+    });
 }
 
-const std::vector<PoolState*>& OrderBook::get_pools(uint64_t token0, uint64_t token1) const noexcept {
-    PairKey key{token0, token1};
-    auto it = pair_pools_.find(key);
-    if (it != pair_pools_.end()) {
-        return it->second;
+uint32_t OrderBook::token_id(uint64_t token_hash) const noexcept {
+    return read_topology([&] {
+        const uint32_t* id = token_index_.find(token_hash);
+        return id ? *id : INVALID_INDEX;
+    });
+}
+
+PoolState OrderBook::pool(uint32_t pool_id) const noexcept {
+    // A pool moved mid-read is re-read at its new slot, which the writer
+    // updates from then on
+    for (;;) {
+        const uint32_t slot = slot_of(pool_id);
+        const PoolState state = pool_at_slot(slot);
+        if (slot_of(pool_id) == slot) return state;
     }
-    return empty_pools_;
 }
 
-const PoolState* OrderBook::get_best_price(uint64_t token0, uint64_t token1) const noexcept {
-    const auto& pools = get_pools(token0, token1);
-    if (pools.empty()) return nullptr;
+std::optional<PoolState> OrderBook::find_pool(uint64_t pool_hash) const noexcept {
+    const uint32_t id = find_pool_id(pool_hash);
+    if (id == INVALID_INDEX) return std::nullopt;
+    return pool(id);
+}
 
-    const PoolState* best = nullptr;
-    uint64_t best_price = 0;
+std::optional<PoolState> OrderBook::get_best_price(uint64_t token_in, uint64_t token_out) const noexcept {
+    return select_best(token_in, token_out, 0);
+}
 
-    for (const auto* pool : pools) {
-        uint64_t price = pool->spot_price();
-        if (price > best_price) {
-            best_price = price;
-            best = pool;
-        }
-    }
+std::optional<PoolState> OrderBook::get_best_price(
+    uint64_t token_in,
+    uint64_t token_out,
+    ChainId chain
+) const noexcept {
+    return select_best(token_in, token_out, 0, chain);
+}
 
-    return best;
+std::optional<PoolState> OrderBook::get_best_pool_for_amount(
+    uint64_t token_in,
+    uint64_t token_out,
+    uint64_t amount_in
+) const noexcept {
+    return select_best(token_in, token_out, amount_in);
 }
 
-std::vector<const PoolState*> OrderBook::get_pools_by_chain(ChainId chain) const noexcept {
-    std::vector<const PoolState*> result;
-    result.reserve(1000);
+std::optional<PoolState> OrderBook::select_best(
+    uint64_t token_in,
+    uint64_t token_out,
+    uint64_t amount_in,
+    std::optional<ChainId> chain
+) const noexcept {
+    const PoolRange pools = get_pools(token_in, token_out);
+    if (pools.empty()) return std::nullopt;
+
+    // The writer keeps storing reserves: score seqlocked copies, a chunk at
+    // a time (fees never change once a pool is published, so they are read
+    // in place). Canonical columns: selling token0 reads reserve0 as input.
+    constexpr size_t CHUNK = 64;
+    alignas(64) uint64_t reserve_in[CHUNK];
+    alignas(64) uint64_t reserve_out[CHUNK];
+    const uint32_t first = pools.first_slot();
+    const bool sell_token0 = token_in < token_out;
 
-    for (size_t i = 0; i < pool_count_; ++i) {
-        if (pools_[i].chain == chain) {
-            result.push_back(&pools_[i]);
+    kernels::ArgMax best;
+    for (size_t base = 0; base < pools.size(); base += CHUNK) {
+        const size_t n = std::min(CHUNK, pools.size() - base);
+        for (size_t i = 0; i < n; ++i) {
+            const size_t slot = first + base + i;
+            uint64_t reserve0, reserve1;
+            uint32_t seq;
+            do {
+                seq = seqlock::read_begin(cols_.seq[slot]);
+                reserve0 = seqlock::load(cols_.reserve0[slot]);
+                reserve1 = seqlock::load(cols_.reserve1[slot]);
+            } while (seqlock::read_retry(cols_.seq[slot], seq));
+            reserve_in[i] = sell_token0 ? reserve0 : reserve1;
+            reserve_out[i] = sell_token0 ? reserve1 : reserve0;
+            // No output scores a pool as unusable: how other chains drop out
+            if (chain && cols_.chain[slot] != *chain) reserve_out[i] = 0;
+        }
+
+        // Strictly better only, so ties keep the lowest slot
+        const kernels::ArgMax chunk = kernels::argmax_output(
+            reserve_in, reserve_out, cols_.fee_bps + first + base, n, amount_in);
+        if (chunk.index != kernels::ArgMax::NONE &&
+            (best.index == kernels::ArgMax::NONE || chunk.value > best.value)) {
+            best.index = static_cast<uint32_t>(base + chunk.index);
+            best.value = chunk.value;
         }
     }
+    if (best.index == kernels::ArgMax::NONE) return std::nullopt;
+
+    return pool_at_slot(first + best.index);
+}
 
+std::vector<PoolState> OrderBook::get_pools_by_chain(ChainId chain) const noexcept {
+    std::vector<PoolState> result;
+    get_pools_by_chain(chain, result);
     return result;
 }
 
-PoolState* OrderBook::get_or_create_pool(uint64_t pool_hash) noexcept {
-    auto it = pool_index_.find(pool_hash);
-    if (it != pool_index_.end()) {
-        return &pools_[it->second];
+size_t OrderBook::get_pools_by_chain(ChainId chain, std::vector<PoolState>& out) const noexcept {
+    out.clear();
+
+    // Size exactly first: one allocation at most, none when reused
+    const auto pools = static_cast<uint32_t>(pool_count());
+    size_t count = 0;
+    for (uint32_t id = 0; id < pools; ++id) {
+        count += pool_chain(id) == chain;
     }
+    out.reserve(count);
 
+    for (uint32_t id = 0; id < pools; ++id) {
+        if (pool_chain(id) == chain) {
+            out.push_back(pool(id));
+        }
+    }
+    return out.size();
+}
+
+PoolState OrderBook::pool_at_slot(uint32_t slot) const noexcept {
+    PoolState pool{};
+    pool.pool_address_hash = cols_.pool_hash[slot];
+    pool.chain = cols_.chain[slot];
+    pool.dex = cols_.dex[slot];
+    pool.fee_bps = cols_.fee_bps[slot];
+
+    // Reserves from a single update
+    uint64_t reserve0, reserve1;
+    uint32_t seq;
+    do {
+        seq = seqlock::read_begin(cols_.seq[slot]);
+        reserve0 = seqlock::load(cols_.reserve0[slot]);
+        reserve1 = seqlock::load(cols_.reserve1[slot]);
+        pool.last_update_ns = seqlock::load(cols_.last_update_ns[slot]);
+    } while (seqlock::read_retry(cols_.seq[slot], seq));
+
+    // Restore the pool's own token order
+    const bool reversed = (cols_.flags[slot] & PoolColumns::FLAG_REVERSED) != 0;
+    const PairKey& key = pair_entries_[cols_.pair_id[slot]].key;
+    pool.token0_hash = reversed ? key.token1 : key.token0;
+    pool.token1_hash = reversed ? key.token0 : key.token1;
+    pool.reserve0 = reversed ? reserve1 : reserve0;
+    pool.reserve1 = reversed ? reserve0 : reserve1;
+    pool.decimals0 = reversed ? cols_.decimals1[slot] : cols_.decimals0[slot];
+    pool.decimals1 = reversed ? cols_.decimals0[slot] : cols_.decimals1[slot];
+    return pool;
+}
+
+uint32_t OrderBook::create_pool(const PriceUpdate& update) noexcept {
     if (pool_count_ >= MAX_POOLS) {
-        return nullptr;  // Pool storage exhausted
+        return INVALID_INDEX;  // Pool storage exhausted
+    }
+
+    // Check every index has room before mutating any of them, so a rejected
+    // pool never leaves a half-registered token or pair behind
+    const PairKey key = PairKey::canonical(update.token0, update.token1);
+    const bool new_token0 = token_index_.find(update.token0) == nullptr;
+    const bool new_token1 = update.token1 != update.token0 &&
+                            token_index_.find(update.token1) == nullptr;
+    const size_t new_tokens = static_cast<size_t>(new_token0) + static_cast<size_t>(new_token1);
+    if (token_index_.size() + new_tokens > token_index_.max_entries()) {
+        return INVALID_INDEX;
+    }
+    const uint32_t* pair = pair_index_.find(key);
+    if (!pair && pair_index_.full()) {
+        return INVALID_INDEX;
+    }
+
+    // Reserve a column slot in the pair's segment (pool tokens never change
+    // after creation, so this is the only place the topology grows)
+    const auto pair_id = pair ? *pair : static_cast<uint32_t>(pair_index_.size());
+    PairEntry fresh{key, 0, 0, 0};
+    const uint32_t slot = reserve_slot(pair ? pair_entries_[pair_id] : fresh);
+    if (slot == INVALID_INDEX) {
+        return INVALID_INDEX;
     }
+    if (!pair) {
+        pair_index_.insert(key, pair_id);
+        pair_entries_[pair_id] = fresh;
+    }
+
+    const auto id = static_cast<uint32_t>(pool_count_);
+    pool_index_.insert(update.pool_hash, id);
+    slot_of_[id] = slot;
+    dirty_mark_[id] = 0;  // Arena memory is not guaranteed to be zeroed
+    pool_tokens_[id] = {intern_token(update.token0), intern_token(update.token1)};
 
-    size_t index = pool_count_++;
-    pools_[index].pool_address_hash = pool_hash;
-    pool_index_[pool_hash] = index;
+    cols_.pool_hash[slot] = update.pool_hash;
+    cols_.pool_id[slot] = id;
+    cols_.pair_id[slot] = pair_id;
+    cols_.fee_bps[slot] = 30;  // PriceUpdate carries no fee; assume the 0.3% tier
+    cols_.decimals0[slot] = 18;
+    cols_.decimals1[slot] = 18;
+    cols_.flags[slot] = update.token0 > update.token1 ? PoolColumns::FLAG_REVERSED : 0;
+    cols_.chain[slot] = static_cast<ChainId>(update.chain_id);  // Fixed for the pool's lifetime
+    cols_.dex[slot] = static_cast<DexId>(update.dex_id);
+    cols_.seq[slot] = 0;
+    write_reserves(slot, update);
+
+    // Publish last: readers below pool_count() see a complete pool
+    std::atomic_ref<size_t>(pool_count_).store(pool_count_ + 1, std::memory_order_release);
+    return slot;
+}
+
+uint32_t OrderBook::intern_token(uint64_t token_hash) noexcept {
+    const auto next_id = static_cast<uint32_t>(token_index_.size());
+    auto [id, inserted] = token_index_.insert(token_hash, next_id);
+    if (inserted) {
+        token_hashes_[next_id] = token_hash;
+    }
+    return *id;  // Capacity was checked by create_pool
+}
+
+uint32_t OrderBook::reserve_slot(PairEntry& entry) noexcept {
+    if (entry.count < entry.capacity) {
+        return entry.first_slot + entry.count++;
+    }
+
+    const uint32_t new_capacity = entry.capacity ? entry.capacity * 2 : 1;
+    if (slot_top_ + new_capacity > MAX_SLOTS) {
+        return INVALID_INDEX;  // Column storage exhausted
+    }
+    const auto new_first = static_cast<uint32_t>(slot_top_);
+    seqlock::store(slot_top_, slot_top_ + new_capacity);
+
+    // Move the segment; the old slots are abandoned
+    const uint32_t old_first = entry.first_slot;
+    const uint32_t n = entry.count;
+    const auto move = [&](auto* column) {
+        std::copy_n(column + old_first, n, column + new_first);
+    };
+    move(cols_.pool_hash);
+    move(cols_.reserve0);
+    move(cols_.reserve1);
+    move(cols_.last_update_ns);
+    move(cols_.fee_bps);
+    move(cols_.chain);
+    move(cols_.dex);
+    move(cols_.pool_id);
+    move(cols_.pair_id);
+    move(cols_.decimals0);
+    move(cols_.decimals1);
+    move(cols_.flags);
+    move(cols_.seq);
+    for (uint32_t i = 0; i < n; ++i) {
+        std::atomic_ref<uint32_t>(slot_of_[cols_.pool_id[new_first + i]])
+            .store(new_first + i, std::memory_order_release);
+    }
 
-    return &pools_[index];
+    entry.first_slot = new_first;
+    entry.capacity = new_capacity;
+    return entry.first_slot + entry.count++;
 }
 
 } // namespace matrix::orderbook
@@ -0,0 +1,191 @@
+#include "runtime/EventLog.hpp"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstring>
+#include <stdexcept>
+
+namespace matrix::runtime {
+
+namespace {
+
+// Journal layout: this header, then raw LogRecords
+struct JournalHeader {
+    char magic[8];
+    uint32_t record_size;
+    uint32_t reserved;
+};
+
+constexpr char JOURNAL_MAGIC[8] = {'M', 'X', 'E', 'V', 'L', 'O', 'G', '1'};
+
+LogRecord make_record(LogKind kind, uint32_t chain) noexcept {
+    LogRecord record;
+    std::memset(&record, 0, sizeof(record));
+    record.logged_ns = telemetry::Clock::now_ns();
+    record.kind = kind;
+    record.chain = chain;
+    return record;
+}
+
+} // namespace
+
+// ============================================================================
+// LogRecord
+// ============================================================================
+
+LogRecord LogRecord::from(const arbitrage::Opportunity& opp) noexcept {
+    LogRecord record = make_record(LogKind::OPPORTUNITY, static_cast<uint32_t>(opp.chain));
+    record.opportunity.id = opp.id;
+    record.opportunity.detected_ns = opp.timestamp_ns;
+    record.opportunity.profit_wei = opp.profit_wei;
+    record.opportunity.flash_loan_amount = opp.flash_loan_amount;
+    record.opportunity.flash_loan_fee = opp.flash_loan_fee;
+    record.opportunity.gas_estimate = opp.gas_estimate;
+    record.opportunity.path_length = opp.path_length;
+    return record;
+}
+
+LogRecord LogRecord::from(orderbook::ChainId chain, const ShardStats& stats) noexcept {
+    LogRecord record = make_record(LogKind::SHARD_STATS, static_cast<uint32_t>(chain));
+    record.stats.updates_processed = stats.updates_processed;
+    record.stats.updates_dropped = stats.updates_dropped;
+    record.stats.updates_conflated = stats.updates_conflated + stats.updates_coalesced;
+    record.stats.scans = stats.scans;
+    record.stats.last_scan_ns = stats.last_scan_ns;
+    record.stats.pool_count = static_cast<uint32_t>(stats.pool_count);
+    return record;
+}
+
+LogRecord LogRecord::from(telemetry::Stage stage, const telemetry::LatencyHistogram::Snapshot& latency) noexcept {
+    LogRecord record = make_record(LogKind::STAGE_LATENCY, 0);
+    record.latency.count = latency.count;
+    record.latency.p50 = latency.percentile(0.5);
+    record.latency.p99 = latency.percentile(0.99);
+    record.latency.p999 = latency.percentile(0.999);
+    record.latency.max = latency.max;
+    record.latency.stage = stage;
+    return record;
+}
+
+// ============================================================================
+// EventLog
+// ============================================================================
+
+EventLog::EventLog(EventLogConfig config)
+    : config_(std::move(config)), ring_(std::make_unique<Ring>()) {
+    if (!config_.journal_path.empty()) {
+        journal_ = std::fopen(config_.journal_path.c_str(), "ab");
+        if (!journal_) {
+            throw std::runtime_error("EventLog: cannot open journal " + config_.journal_path);
+        }
+        // A new journal gets a header; an existing one is appended to
+        if (std::ftell(journal_) == 0) {
+            JournalHeader header{};
+            std::memcpy(header.magic, JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC));
+            header.record_size = sizeof(LogRecord);
+            std::fwrite(&header, sizeof(header), 1, journal_);
+        }
+    }
+    writer_ = std::thread([this] {
+        if (config_.cpu >= 0) pin_current_thread(config_.cpu);
+        run();
+    });
+}
+
+EventLog::~EventLog() {
+    stop();
+}
+
+bool EventLog::log(const LogRecord& record) noexcept {
+    if (ring_->push(record)) return true;
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+void EventLog::stop() noexcept {
+    if (!running_.exchange(false, std::memory_order_acq_rel)) return;
+    if (writer_.joinable()) writer_.join();
+    if (journal_) {
+        std::fclose(journal_);
+        journal_ = nullptr;
+    }
+}
+
+void EventLog::run() noexcept {
+    while (running_.load(std::memory_order_acquire)) {
+        if (drain() == 0) std::this_thread::sleep_for(FLUSH_INTERVAL);
+    }
+    // Everything logged before stop() returns
+    while (drain() != 0) {}
+}
+
+size_t EventLog::drain() noexcept {
+    char line[256];
+    const size_t count = ring_->consume([&](const LogRecord& record) {
+        if (config_.text) {
+            const size_t length = format(record, line, sizeof(line) - 1);
+            line[length] = '\n';
+            std::fwrite(line, 1, length + 1, config_.text);
+        }
+        if (journal_) std::fwrite(&record, sizeof(record), 1, journal_);
+    });
+    if (count != 0) {
+        if (config_.text) std::fflush(config_.text);
+        if (journal_) std::fflush(journal_);
+        written_.fetch_add(count, std::memory_order_relaxed);
+    }
+    return count;
+}
+
+size_t EventLog::format(const LogRecord& record, char* out, size_t size) noexcept {
+    if (size == 0) return 0;
+    int length = 0;
+    switch (record.kind) {
+        case LogKind::OPPORTUNITY: {
+            const auto& opp = record.opportunity;
+            length = std::snprintf(out, size,
+                                   "[OPPORTUNITY] Chain=%" PRIu32 " Id=%" PRIu64 " Profit=%" PRIu64
+                                   " finney Path=%u hops Gas=%" PRIu32 " Age=%" PRIu64 "us",
+                                   record.chain, opp.id, opp.profit_wei / uint64_t{1'000'000'000'000'000},
+                                   static_cast<unsigned>(opp.path_length), opp.gas_estimate,
+                                   record.logged_ns > opp.detected_ns ? (record.logged_ns - opp.detected_ns) / 1000 : 0);
+            break;
+        }
+        case LogKind::SHARD_STATS: {
+            const auto& stats = record.stats;
+            length = std::snprintf(out, size,
+                                   "[STATS] Chain=%" PRIu32 " Updates=%" PRIu64 " Dropped=%" PRIu64
+                                   " Conflated=%" PRIu64 " Scans=%" PRIu64 " Pools=%" PRIu32 " LastScan=%" PRIu64 "us",
+                                   record.chain, stats.updates_processed, stats.updates_dropped,
+                                   stats.updates_conflated, stats.scans, stats.pool_count,
+                                   stats.last_scan_ns / 1000);
+            break;
+        }
+        case LogKind::STAGE_LATENCY: {
+            const auto& latency = record.latency;
+            length = std::snprintf(out, size,
+                                   "[LATENCY] %s n=%" PRIu64 " p50=%" PRIu64 " p99=%" PRIu64
+                                   " p99.9=%" PRIu64 " max=%" PRIu64 "ns",
+                                   telemetry::stage_name(latency.stage), latency.count,
+                                   latency.p50, latency.p99, latency.p999, latency.max);
+            break;
+        }
+        default:
+            length = std::snprintf(out, size, "[UNKNOWN] Kind=%u", static_cast<unsigned>(record.kind));
+            break;
+    }
+    if (length < 0) {
+        out[0] = '\0';
+        return 0;
+    }
+    return std::min(static_cast<size_t>(length), size - 1);
+}
+
+bool EventLog::read_header(std::FILE* file) noexcept {
+    JournalHeader header;
+    if (std::fread(&header, sizeof(header), 1, file) != 1) return false;
+    return std::memcmp(header.magic, JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC)) == 0 &&
+           header.record_size == sizeof(LogRecord);
+}
+
+} // namespace matrix::runtime
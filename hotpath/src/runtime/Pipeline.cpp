@@ -0,0 +1,253 @@
+#include "runtime/Pipeline.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "memory/ArenaResource.hpp"
+#include "telemetry/Telemetry.hpp"
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace matrix::runtime {
+
+using namespace orderbook;
+
+bool pin_current_thread(int cpu) noexcept {
+#ifdef __linux__
+    if (cpu < 0 || cpu >= CPU_SETSIZE) return false;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    (void)cpu;
+    return false;
+#endif
+}
+
+Pipeline::Pipeline(PipelineConfig config) : config_(std::move(config)) {
+    shards_.reserve(config_.shards.size());
+    for (const ShardConfig& shard_config : config_.shards) {
+        for (const auto& existing : shards_) {
+            if (existing->config.chain == shard_config.chain) {
+                throw std::invalid_argument("Pipeline: duplicate shard for chain");
+            }
+        }
+        auto shard = std::make_unique<Shard>();
+        shard->config = shard_config;
+        shards_.push_back(std::move(shard));
+    }
+}
+
+Pipeline::~Pipeline() {
+    stop();
+}
+
+void Pipeline::start(PriceFeedQueue& feed) {
+    launch_shards();
+    feed_ = &feed;
+    router_ = std::thread([this, &feed] {
+        if (config_.router_cpu >= 0) pin_current_thread(config_.router_cpu);
+        run_router(feed);
+    });
+}
+
+void Pipeline::start() {
+    launch_shards();
+}
+
+void Pipeline::launch_shards() {
+    if (started_) {
+        throw std::logic_error("Pipeline: already started");
+    }
+    started_ = true;
+    running_.store(true, std::memory_order_release);
+
+    ready_ = std::make_unique<std::latch>(static_cast<std::ptrdiff_t>(shards_.size()));
+    for (auto& shard : shards_) {
+        shard->thread = std::thread([this, s = shard.get()] { run_shard(*s); });
+    }
+    ready_->wait();
+
+    for (const auto& shard : shards_) {
+        if (shard->startup_error) {
+            stop();
+            std::rethrow_exception(shard->startup_error);
+        }
+    }
+}
+
+void Pipeline::stop() noexcept {
+    running_.store(false, std::memory_order_release);
+
+    // Release parked threads; they see running_ == false on waking
+    if (feed_) feed_->close();
+    if (router_.joinable()) router_.join();
+    for (auto& shard : shards_) {
+        shard->input.close();
+        if (shard->thread.joinable()) shard->thread.join();
+    }
+}
+
+bool Pipeline::route(const PriceUpdate& update) noexcept {
+    Shard* shard = shard_for(update.chain_id);
+    if (!shard) {
+        unrouted_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    if (!shard->input.push(update)) {
+        shard->updates_dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+ShardStats Pipeline::shard_stats(size_t index) const noexcept {
+    const Shard& shard = *shards_[index];
+    ShardStats stats{};
+    stats.updates_processed = shard.updates_processed.load(std::memory_order_relaxed);
+    stats.updates_dropped = shard.updates_dropped.load(std::memory_order_relaxed);
+    stats.updates_conflated = shard.updates_conflated.load(std::memory_order_relaxed);
+    stats.updates_coalesced = shard.updates_coalesced.load(std::memory_order_relaxed);
+    stats.scans = shard.scans.load(std::memory_order_relaxed);
+    stats.opportunities = shard.found.load(std::memory_order_relaxed);
+    stats.opportunities_dropped = shard.opportunities_dropped.load(std::memory_order_relaxed);
+    stats.last_scan_ns = shard.last_scan_ns.load(std::memory_order_relaxed);
+    stats.pool_count = shard.pool_count.load(std::memory_order_relaxed);
+    stats.restored_pools = shard.restored_pools.load(std::memory_order_relaxed);
+    stats.snapshots_written = shard.snapshots_written.load(std::memory_order_relaxed);
+    stats.pinned = shard.pinned.load(std::memory_order_relaxed);
+    return stats;
+}
+
+Pipeline::Shard* Pipeline::shard_for(uint32_t chain_id) noexcept {
+    // A handful of chains: a linear scan beats any map
+    for (auto& shard : shards_) {
+        if (static_cast<uint32_t>(shard->config.chain) == chain_id) return shard.get();
+    }
+    return nullptr;
+}
+
+void Pipeline::run_shard(Shard& shard) {
+    // Pin first so the shard's memory is first touched on its own CPU
+    std::unique_ptr<memory::Arena> arena;
+    std::unique_ptr<OrderBook> book;
+    std::unique_ptr<arbitrage::Calculator> calculator;
+    std::unique_ptr<memory::ArenaResource<memory::Arena>> scratch;
+    std::unique_ptr<arbitrage::OpportunityBuffer> opportunities;
+    std::unique_ptr<SnapshotWriter> snapshots;
+    try {
+        if (shard.config.cpu >= 0) {
+            shard.pinned.store(pin_current_thread(shard.config.cpu), std::memory_order_relaxed);
+        }
+        arena = std::make_unique<memory::Arena>(shard.config.arena_bytes, shard.config.arena_options);
+        book = std::make_unique<OrderBook>(*arena);
+        calculator = std::make_unique<arbitrage::Calculator>(*book);
+        // Scan output lives in the shard's arena and is reused every scan
+        scratch = std::make_unique<memory::ArenaResource<memory::Arena>>(*arena);
+        opportunities = std::make_unique<arbitrage::OpportunityBuffer>(
+            arbitrage::Calculator::MAX_OPPORTUNITIES, scratch.get());
+
+        // Warm start: adopt the last snapshot and index its cycles now; the
+        // restored pools stay dirty, so the first batch re-scans all of them
+        if (!shard.config.snapshot_path.empty()) {
+            if (load_snapshot(*book, shard.config.snapshot_path)) {
+                shard.restored_pools.store(book->pool_count(), std::memory_order_relaxed);
+                shard.pool_count.store(book->pool_count(), std::memory_order_relaxed);
+                calculator->scan_incremental({}, *opportunities);
+            }
+            snapshots = std::make_unique<SnapshotWriter>(*book, shard.config.snapshot_path);
+        }
+    } catch (...) {
+        shard.startup_error = std::current_exception();
+        ready_->count_down();
+        return;
+    }
+    ready_->count_down();
+
+    const uint64_t snapshot_interval_ns = uint64_t{shard.config.snapshot_interval_ms} * 1'000'000;
+    uint64_t last_snapshot = telemetry::Clock::ticks();
+
+    WaitStrategy waiter(config_.wait);
+    while (running_.load(std::memory_order_acquire)) {
+        const uint64_t apply_start = telemetry::Clock::ticks();
+        const size_t updates = book->process_updates(shard.input);
+        if (updates == 0) {
+            waiter.wait(shard.input);
+            continue;
+        }
+        telemetry::record(telemetry::Stage::BOOK_UPDATE, telemetry::Clock::elapsed_ns(apply_start));
+        telemetry::record_age(telemetry::Stage::QUEUE_POP, book->last_update_ns());
+        waiter.reset();
+        shard.updates_processed.fetch_add(updates, std::memory_order_relaxed);
+
+        // Re-evaluate only the cycles touched by this batch (timed by the calculator)
+        calculator->scan_incremental(book->dirty_pools(), *opportunities);
+        book->clear_dirty();
+
+        const size_t published = shard.opportunities.push_bulk(opportunities->view());
+        if (published < opportunities->size()) {
+            shard.opportunities_dropped.fetch_add(opportunities->size() - published, std::memory_order_relaxed);
+        }
+
+        shard.scans.fetch_add(1, std::memory_order_relaxed);
+        shard.found.fetch_add(opportunities->size(), std::memory_order_relaxed);
+        shard.last_scan_ns.store(calculator->last_scan_duration_ns(), std::memory_order_relaxed);
+        shard.pool_count.store(book->pool_count(), std::memory_order_relaxed);
+        shard.updates_coalesced.store(book->coalesced_updates(), std::memory_order_relaxed);
+
+        // Only wakes the writer thread, which copies the book itself as a
+        // reader (skipped while the previous snapshot is still in flight)
+        if (snapshots && snapshot_interval_ns != 0 &&
+            telemetry::Clock::elapsed_ns(last_snapshot) >= snapshot_interval_ns) {
+            snapshots->capture();
+            last_snapshot = telemetry::Clock::ticks();
+            shard.snapshots_written.store(snapshots->written(), std::memory_order_relaxed);
+        }
+    }
+
+    // Final snapshot; the writer's destructor copies and writes it out
+    if (snapshots) {
+        snapshots->capture();
+        snapshots.reset();
+    }
+}
+
+void Pipeline::run_router(PriceFeedQueue& feed) {
+    WaitStrategy waiter(config_.wait);
+    while (running_.load(std::memory_order_acquire)) {
+        // Coalesce a batch per shard, then hand each shard its run in one push
+        // (the batch is no larger than a coalescer, so add() cannot fail)
+        uint64_t newest = 0;
+        const size_t routed = feed.consume([this, &newest](const PriceUpdate& update) noexcept {
+            newest = std::max(newest, update.timestamp_ns);
+            if (Shard* shard = shard_for(update.chain_id)) {
+                shard->staged.add(update);
+            } else {
+                unrouted_.fetch_add(1, std::memory_order_relaxed);
+            }
+        }, ROUTER_BATCH);
+
+        if (routed == 0) {
+            waiter.wait(feed);
+            continue;
+        }
+        waiter.reset();
+
+        for (auto& shard : shards_) {
+            if (shard->staged.empty()) continue;
+            const size_t pushed = shard->input.push_bulk(shard->staged.updates());
+            if (pushed < shard->staged.size()) {
+                shard->updates_dropped.fetch_add(shard->staged.size() - pushed, std::memory_order_relaxed);
+            }
+            shard->updates_conflated.store(shard->staged.conflated(), std::memory_order_relaxed);
+            shard->staged.clear();
+        }
+        telemetry::record_age(telemetry::Stage::QUEUE_PUSH, newest);
+    }
+}
+
+} // namespace matrix::runtime
@@ -0,0 +1,314 @@
+#include "runtime/Replay.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+#include <thread>
+
+#include "orderbook/WaitStrategy.hpp"
+
+namespace matrix::runtime {
+
+using namespace orderbook;
+
+namespace {
+
+// ============================================================================
+// Trace file
+// ============================================================================
+
+struct TraceHeader {
+    char magic[8];
+    uint32_t record_size;
+    uint32_t reserved;
+};
+
+constexpr char TRACE_MAGIC[8] = {'M', 'X', 'F', 'E', 'E', 'D', '0', '1'};
+
+// ============================================================================
+// Deterministic generation (the raw engine output is fixed by the standard;
+// the library distributions are not)
+// ============================================================================
+
+class TraceRng {
+public:
+    explicit TraceRng(uint64_t seed) noexcept : engine_(seed) {}
+
+    uint64_t below(uint64_t n) noexcept { return engine_() % n; }
+
+    // Uniform in [-1, 1)
+    double symmetric() noexcept { return static_cast<double>(engine_() >> 11) * 0x1.0p-52 - 1.0; }
+
+private:
+    std::mt19937_64 engine_;
+};
+
+struct TracePool {
+    uint64_t hash;
+    uint32_t token0;
+    uint32_t token1;
+    double liquidity;
+    double skew;         // Log deviation from the fair price, drifts per update
+};
+
+// ============================================================================
+// Composition
+// ============================================================================
+
+// The book keys tokens and pools by 64-bit hash; stand in an address for each
+std::array<uint8_t, 20> address_of(uint64_t hash) noexcept {
+    std::array<uint8_t, 20> address{};
+    for (size_t b = 0; b < 8; ++b) address[19 - b] = static_cast<uint8_t>(hash >> (8 * b));
+    return address;
+}
+
+constexpr uint64_t FNV_OFFSET = 0xcbf29ce484222325ULL;
+constexpr uint64_t FNV_PRIME = 0x100000001b3ULL;
+
+void mix(uint64_t& hash, const void* data, size_t size) noexcept {
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ bytes[i]) * FNV_PRIME;
+    }
+}
+
+void mix(uint64_t& hash, uint64_t value) noexcept {
+    mix(hash, &value, sizeof(value));
+}
+
+} // namespace
+
+// ============================================================================
+// Feed traces
+// ============================================================================
+
+bool save_trace(const std::string& path, std::span<const PriceUpdate> updates) {
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) return false;
+
+    TraceHeader header{};
+    std::memcpy(header.magic, TRACE_MAGIC, sizeof(TRACE_MAGIC));
+    header.record_size = sizeof(PriceUpdate);
+    bool written = std::fwrite(&header, sizeof(header), 1, file) == 1;
+    written = written && std::fwrite(updates.data(), sizeof(PriceUpdate), updates.size(), file) == updates.size();
+    return std::fclose(file) == 0 && written;
+}
+
+std::vector<PriceUpdate> load_trace(const std::string& path) {
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) throw std::runtime_error("load_trace: cannot open " + path);
+
+    TraceHeader header;
+    if (std::fread(&header, sizeof(header), 1, file) != 1 ||
+        std::memcmp(header.magic, TRACE_MAGIC, sizeof(TRACE_MAGIC)) != 0 ||
+        header.record_size != sizeof(PriceUpdate)) {
+        std::fclose(file);
+        throw std::runtime_error("load_trace: not a feed trace: " + path);
+    }
+
+    std::vector<PriceUpdate> updates;
+    PriceUpdate chunk[1024];
+    size_t read;
+    while ((read = std::fread(chunk, sizeof(PriceUpdate), std::size(chunk), file)) != 0) {
+        updates.insert(updates.end(), chunk, chunk + read);
+    }
+    std::fclose(file);
+    return updates;
+}
+
+std::vector<PriceUpdate> synthesize_trace(const SyntheticTraceConfig& config) {
+    if (config.tokens < 2 || config.pools == 0) {
+        throw std::invalid_argument("synthesize_trace: need at least two tokens and one pool");
+    }
+    TraceRng rng(config.seed);
+    const size_t token_count = config.tokens + 1;       // Token 0 is the base
+
+    // Fair prices in base units; pools price around them with a small skew
+    std::vector<double> price(token_count, 1.0);
+    std::vector<uint64_t> token_hash(token_count, config.base_token);
+    for (size_t t = 1; t < token_count; ++t) {
+        price[t] = std::exp(2.0 * rng.symmetric());
+        token_hash[t] = 0x7000'0000'0000'0000ULL + config.seed * 0x10000 + t;
+    }
+
+    // Every token gets a base pool first, so cycles through the base exist
+    std::vector<TracePool> pools(config.pools);
+    for (size_t p = 0; p < pools.size(); ++p) {
+        TracePool& pool = pools[p];
+        pool.hash = 0x5000'0000'0000'0000ULL + config.seed * 0x100000 + p;
+        pool.token0 = p < config.tokens ? 0 : static_cast<uint32_t>(1 + rng.below(config.tokens));
+        do {
+            pool.token1 = static_cast<uint32_t>(1 + (p < config.tokens ? p : rng.below(config.tokens)));
+        } while (pool.token1 == pool.token0);
+        pool.liquidity = 1e9 * std::exp(rng.symmetric());
+        pool.skew = 0.004 * rng.symmetric();
+    }
+
+    const auto make_update = [&](const TracePool& pool, uint64_t timestamp) {
+        PriceUpdate update{};
+        update.timestamp_ns = timestamp;
+        update.pool_hash = pool.hash;
+        update.chain_id = static_cast<uint32_t>(config.chain);
+        update.dex_id = static_cast<uint32_t>(DexId::UNISWAP_V3);
+        update.token0 = token_hash[pool.token0];
+        update.token1 = token_hash[pool.token1];
+        // reserve1 / reserve0 = price0 / price1, off by the pool's skew
+        const double reserve0 = pool.liquidity / std::sqrt(price[pool.token0]);
+        const double reserve1 = pool.liquidity * price[pool.token0] / price[pool.token1] * std::exp(pool.skew) /
+                                std::sqrt(price[pool.token0]);
+        update.reserve0 = std::max<uint64_t>(1, static_cast<uint64_t>(reserve0));
+        update.reserve1 = std::max<uint64_t>(1, static_cast<uint64_t>(reserve1));
+        return update;
+    };
+
+    std::vector<PriceUpdate> trace;
+    trace.reserve(pools.size() + config.blocks * config.updates_per_block);
+
+    uint64_t block_start = config.start_ns;
+    for (size_t i = 0; i < pools.size(); ++i) {
+        trace.push_back(make_update(pools[i], block_start + i * config.update_spacing_ns));
+    }
+    for (size_t block = 0; block < config.blocks; ++block) {
+        block_start += config.block_interval_ns;
+        for (size_t i = 0; i < config.updates_per_block; ++i) {
+            TracePool& pool = pools[rng.below(pools.size())];
+            pool.skew = std::clamp(pool.skew + 0.002 * rng.symmetric(), -0.012, 0.012);
+            trace.push_back(make_update(pool, block_start + i * config.update_spacing_ns));
+        }
+    }
+    return trace;
+}
+
+// ============================================================================
+// ReplayHarness
+// ============================================================================
+
+ReplayHarness::ReplayHarness(ReplayConfig config)
+    : config_(std::move(config)),
+      composer_(config_.composer),
+      histograms_(std::make_unique<Histograms>()) {
+    if (config_.batch == 0 || config_.batch > PriceQueue::capacity()) {
+        throw std::invalid_argument("ReplayHarness: batch must be in [1, queue capacity]");
+    }
+    arena_ = std::make_unique<memory::Arena>(config_.arena_bytes);
+    book_ = std::make_unique<OrderBook>(*arena_);
+    calculator_ = std::make_unique<arbitrage::Calculator>(*book_);
+    opportunities_ = std::make_unique<arbitrage::OpportunityBuffer>(arbitrage::Calculator::MAX_OPPORTUNITIES);
+    queue_ = std::make_unique<PriceQueue>();
+    if (config_.signing_key) {
+        signer_ = std::make_unique<tx::Signer>(*config_.signing_key);
+    }
+}
+
+ReplayHarness::~ReplayHarness() = default;
+
+ReplayReport ReplayHarness::run(std::span<const PriceUpdate> trace) {
+    ReplayReport report;
+    report.checksum = FNV_OFFSET;
+    const uint64_t wall_start = telemetry::Clock::ticks();
+    const uint64_t trace_start = trace.empty() ? 0 : trace.front().timestamp_ns;
+
+    size_t begin = 0;
+    while (begin < trace.size()) {
+        size_t end = begin + 1;
+        while (end < trace.size() && end - begin < config_.batch &&
+               trace[end].timestamp_ns - trace[end - 1].timestamp_ns <= config_.block_gap_ns) {
+            ++end;
+        }
+        if (config_.speed > 0.0) pace(trace[begin].timestamp_ns - trace_start, wall_start);
+
+        const uint64_t arrival = telemetry::Clock::ticks();
+        const size_t pushed = queue_->push_bulk(trace.subspan(begin, end - begin));
+        record(telemetry::Stage::QUEUE_PUSH, arrival);
+
+        const uint64_t apply = telemetry::Clock::ticks();
+        report.updates += book_->process_updates(*queue_);
+        record(telemetry::Stage::BOOK_UPDATE, apply);
+
+        const uint64_t scan = telemetry::Clock::ticks();
+        calculator_->scan_incremental(book_->dirty_pools(), *opportunities_);
+        book_->clear_dirty();
+        record(telemetry::Stage::SCAN, scan);
+
+        report.opportunities += opportunities_->size();
+        report.transactions += compose_batch(report.checksum);
+        histograms_->end_to_end.record(telemetry::Clock::elapsed_ns(arrival));
+
+        ++report.batches;
+        begin += pushed;
+    }
+
+    report.wall_ns = telemetry::Clock::elapsed_ns(wall_start);
+    return report;
+}
+
+size_t ReplayHarness::compose_batch(uint64_t& checksum) {
+    size_t composed = 0;
+    for (const arbitrage::Opportunity& opp : *opportunities_) {
+        mix(checksum, opp.profit_wei);
+        for (size_t h = 0; h < opp.path_length; ++h) {
+            mix(checksum, opp.path[h].pool_hash);
+            mix(checksum, opp.path[h].amount_in);
+        }
+        if (!opp.is_profitable(config_.gas_price_gwei)) continue;
+
+        std::array<tx::SwapParams, arbitrage::Opportunity::MAX_HOPS> swaps;
+        for (size_t h = 0; h < opp.path_length; ++h) {
+            const auto& hop = opp.path[h];
+            swaps[h] = {address_of(hop.pool_hash), address_of(hop.token_in), address_of(hop.token_out),
+                        hop.amount_in, hop.amount_out};
+        }
+
+        const uint64_t start = telemetry::Clock::ticks();
+        tx::ByteWriter calldata(calldata_.data(), calldata_.size());
+        auto tx = composer_.compose_arbitrage({address_of(opp.flash_loan_token), opp.flash_loan_amount},
+                                              std::span(swaps.data(), opp.path_length),
+                                              opp.gas_estimate, 1'000'000'000,
+                                              config_.gas_price_gwei * 1'000'000'000ULL, calldata);
+        record(telemetry::Stage::COMPOSE, start);
+        if (!tx) continue;
+
+        if (signer_) {
+            const uint64_t sign = telemetry::Clock::ticks();
+            signer_->sign(*tx);
+            record(telemetry::Stage::SIGN, sign);
+        }
+        mix(checksum, tx->data.data(), tx->data.size());
+        ++composed;
+    }
+    return composed;
+}
+
+void ReplayHarness::record(telemetry::Stage stage, uint64_t start_ticks) noexcept {
+    histograms_->stages[static_cast<size_t>(stage)].record(telemetry::Clock::elapsed_ns(start_ticks));
+}
+
+void ReplayHarness::pace(uint64_t offset_ns, uint64_t wall_start) const noexcept {
+    const auto due = static_cast<uint64_t>(static_cast<double>(offset_ns) / config_.speed);
+    for (;;) {
+        const uint64_t elapsed = telemetry::Clock::elapsed_ns(wall_start);
+        if (elapsed >= due) return;
+        // Sleep through long gaps, spin the last stretch
+        if (due - elapsed > 200'000) {
+            std::this_thread::sleep_for(std::chrono::nanoseconds(due - elapsed - 100'000));
+        } else {
+            cpu_relax();
+        }
+    }
+}
+
+void ReplayHarness::snapshot(telemetry::Snapshot& stages,
+                             telemetry::LatencyHistogram::Snapshot& end_to_end) const noexcept {
+    for (size_t s = 0; s < telemetry::STAGE_COUNT; ++s) {
+        stages[s] = {};
+        histograms_->stages[s].add_to(stages[s]);
+    }
+    end_to_end = {};
+    histograms_->end_to_end.add_to(end_to_end);
+}
+
+} // namespace matrix::runtime
@@ -0,0 +1,142 @@
+#include "runtime/WorkStealingPool.hpp"
+
+#include <stdexcept>
+#include <string>
+
+#include "orderbook/WaitStrategy.hpp"
+
+namespace matrix::runtime {
+
+namespace {
+
+constexpr uint64_t pack(uint32_t begin, uint32_t end) noexcept {
+    return (uint64_t{begin} << 32) | end;
+}
+
+constexpr uint32_t range_begin(uint64_t bounds) noexcept { return static_cast<uint32_t>(bounds >> 32); }
+constexpr uint32_t range_end(uint64_t bounds) noexcept { return static_cast<uint32_t>(bounds); }
+
+// Spins before the caller parks on the helpers (a run's tail is short)
+constexpr int JOIN_SPINS = 4096;
+
+} // namespace
+
+WorkStealingPool::WorkStealingPool(size_t workers) : workers_(workers) {
+    if (workers == 0 || workers > MAX_WORKERS) {
+        throw std::invalid_argument("WorkStealingPool: worker count must be 1.." + std::to_string(MAX_WORKERS));
+    }
+    ranges_ = std::make_unique<Range[]>(workers);
+    helpers_.reserve(workers - 1);
+    try {
+        for (size_t w = 1; w < workers; ++w) {
+            helpers_.emplace_back([this, w] { helper_main(w); });
+        }
+    } catch (...) {
+        stop();
+        throw;
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    stop();
+}
+
+void WorkStealingPool::stop() noexcept {
+    running_.store(false, std::memory_order_release);
+    generation_.fetch_add(1, std::memory_order_release);
+    generation_.notify_all();
+    for (auto& helper : helpers_) {
+        if (helper.joinable()) helper.join();
+    }
+}
+
+void WorkStealingPool::dispatch(size_t tasks, TaskFn fn, void* ctx) noexcept {
+    if (tasks == 0) return;
+    const auto count = static_cast<uint32_t>(tasks);
+
+    // An even split; stealing evens out whatever the tasks cost
+    for (size_t w = 0; w < workers_; ++w) {
+        const auto begin = static_cast<uint32_t>(uint64_t{count} * w / workers_);
+        const auto end = static_cast<uint32_t>(uint64_t{count} * (w + 1) / workers_);
+        ranges_[w].bounds.store(pack(begin, end), std::memory_order_relaxed);
+    }
+    fn_ = fn;
+    ctx_ = ctx;
+
+    if (workers_ > 1) {
+        active_.store(static_cast<uint32_t>(workers_ - 1), std::memory_order_relaxed);
+        generation_.fetch_add(1, std::memory_order_release);   // Publishes the ranges and fn
+        generation_.notify_all();
+    }
+
+    work(0);
+
+    // Every task is taken once the caller runs dry, but helpers may still
+    // be finishing theirs
+    for (int spin = 0; spin < JOIN_SPINS; ++spin) {
+        if (active_.load(std::memory_order_acquire) == 0) return;
+        orderbook::cpu_relax();
+    }
+    for (uint32_t left; (left = active_.load(std::memory_order_acquire)) != 0;) {
+        active_.wait(left, std::memory_order_acquire);
+    }
+}
+
+void WorkStealingPool::work(size_t worker) noexcept {
+    uint32_t task;
+    while (take(worker, task)) {
+        fn_(ctx_, worker, task);
+    }
+}
+
+bool WorkStealingPool::take(size_t worker, uint32_t& task) noexcept {
+    // Own range: pop the front
+    std::atomic<uint64_t>& own = ranges_[worker].bounds;
+    uint64_t bounds = own.load(std::memory_order_acquire);
+    while (range_begin(bounds) < range_end(bounds)) {
+        if (own.compare_exchange_weak(bounds, pack(range_begin(bounds) + 1, range_end(bounds)),
+                                      std::memory_order_acq_rel, std::memory_order_acquire)) {
+            task = range_begin(bounds);
+            return true;
+        }
+    }
+
+    // Steal the back half of the next non-empty range
+    for (size_t k = 1; k < workers_; ++k) {
+        std::atomic<uint64_t>& victim = ranges_[(worker + k) % workers_].bounds;
+        uint64_t theirs = victim.load(std::memory_order_acquire);
+        while (range_begin(theirs) < range_end(theirs)) {
+            const uint32_t begin = range_begin(theirs);
+            const uint32_t end = range_end(theirs);
+            const uint32_t mid = begin + (end - begin) / 2;
+            if (victim.compare_exchange_weak(theirs, pack(begin, mid),
+                                             std::memory_order_acq_rel, std::memory_order_acquire)) {
+                // Run the first stolen task now, the rest become ours (only
+                // stealers touch an empty range, and they skip it)
+                task = mid;
+                own.store(pack(mid + 1, end), std::memory_order_release);
+                steals_.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void WorkStealingPool::helper_main(size_t worker) noexcept {
+    // Not the current value: the first run may be dispatched before this
+    // thread gets to look
+    uint32_t seen = 0;
+    for (;;) {
+        generation_.wait(seen, std::memory_order_acquire);
+        seen = generation_.load(std::memory_order_acquire);
+        if (!running_.load(std::memory_order_acquire)) return;
+
+        work(worker);
+        if (active_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            active_.notify_one();
+        }
+    }
+}
+
+} // namespace matrix::runtime
@@ -0,0 +1,90 @@
+#include "telemetry/Clock.hpp"
+
+#include <ctime>
+
+namespace matrix::telemetry {
+
+namespace {
+
+using u128 = unsigned __int128;
+
+constexpr unsigned SHIFT = 32;
+
+uint64_t monotonic_raw_ns() noexcept {
+    timespec ts;
+#ifdef CLOCK_MONOTONIC_RAW
+    clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+#else
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+#endif
+    return static_cast<uint64_t>(ts.tv_sec) * 1'000'000'000ULL + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+struct Calibration {
+    uint64_t mult;              // ns = ticks * mult >> SHIFT
+    uint64_t base_ticks;
+    uint64_t base_ns;           // CLOCK_REALTIME at base_ticks
+    double ticks_per_ns;
+
+    Calibration() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+        // Rate against the undisciplined monotonic clock over ~10 ms
+        constexpr uint64_t WINDOW_NS = 10'000'000;
+        const uint64_t t0 = monotonic_raw_ns();
+        const uint64_t c0 = Clock::ticks();
+        uint64_t t1, c1;
+        do {
+            t1 = monotonic_raw_ns();
+            c1 = Clock::ticks();
+        } while (t1 - t0 < WINDOW_NS);
+        ticks_per_ns = static_cast<double>(c1 - c0) / static_cast<double>(t1 - t0);
+        mult = static_cast<uint64_t>(static_cast<double>(uint64_t{1} << SHIFT) / ticks_per_ns);
+
+        // Anchor: the TSC read bracketed by the realtime read
+        const uint64_t before = Clock::ticks();
+        base_ns = Clock::realtime_ns();
+        const uint64_t after = Clock::ticks();
+        base_ticks = before + (after - before) / 2;
+#else
+        ticks_per_ns = 1.0;
+        mult = uint64_t{1} << SHIFT;
+        base_ticks = 0;
+        base_ns = 0;
+#endif
+    }
+};
+
+const Calibration& calibration() noexcept {
+    static const Calibration instance;
+    return instance;
+}
+
+} // namespace
+
+uint64_t Clock::to_ns(uint64_t ticks) noexcept {
+    return static_cast<uint64_t>((static_cast<u128>(ticks) * calibration().mult) >> SHIFT);
+}
+
+uint64_t Clock::now_ns() noexcept {
+    const Calibration& cal = calibration();
+    const uint64_t now = ticks();
+    // A core's TSC read may trail the anchor by a few ticks
+    return now >= cal.base_ticks ? cal.base_ns + to_ns(now - cal.base_ticks)
+                                 : cal.base_ns - to_ns(cal.base_ticks - now);
+}
+
+uint64_t Clock::realtime_ns() noexcept {
+    timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1'000'000'000ULL + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+void Clock::calibrate() noexcept {
+    (void)calibration();
+}
+
+double Clock::ticks_per_ns() noexcept {
+    return calibration().ticks_per_ns;
+}
+
+} // namespace matrix::telemetry
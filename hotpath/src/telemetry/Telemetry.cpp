@@ -0,0 +1,121 @@
+#include "telemetry/Telemetry.hpp"
+
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <new>
+
+namespace matrix::telemetry {
+
+namespace {
+
+struct Registry {
+    std::array<std::atomic<Recorder*>, MAX_THREADS> recorders{};
+    std::atomic<size_t> claimed{0};
+};
+
+// Never destroyed: threads may still record during static destruction
+Registry& registry() noexcept {
+    static Registry* instance = new Registry;
+    return *instance;
+}
+
+Recorder* claim_recorder() noexcept {
+    Registry& reg = registry();
+    const size_t index = reg.claimed.fetch_add(1, std::memory_order_relaxed);
+    if (index >= MAX_THREADS) return nullptr;
+    Recorder* recorder = new (std::nothrow) Recorder;
+    reg.recorders[index].store(recorder, std::memory_order_release);
+    return recorder;
+}
+
+constexpr std::array<double, 3> QUANTILES = {0.5, 0.99, 0.999};
+
+} // namespace
+
+const char* stage_name(Stage stage) noexcept {
+    switch (stage) {
+        case Stage::FEED_RECEIVE: return "feed_receive";
+        case Stage::QUEUE_PUSH:   return "queue_push";
+        case Stage::QUEUE_POP:    return "queue_pop";
+        case Stage::BOOK_UPDATE:  return "book_update";
+        case Stage::SCAN:         return "scan";
+        case Stage::COMPOSE:      return "compose";
+        case Stage::SIGN:         return "sign";
+        case Stage::COUNT:        break;
+    }
+    return "unknown";
+}
+
+Recorder* thread_recorder() noexcept {
+    // Claimed once per thread; recorders outlive their thread so its
+    // samples stay in the totals
+    thread_local Recorder* recorder = claim_recorder();
+    return recorder;
+}
+
+void snapshot(Snapshot& out) noexcept {
+    for (auto& stage : out) stage = {};
+    const Registry& reg = registry();
+    for (const auto& slot : reg.recorders) {
+        const Recorder* recorder = slot.load(std::memory_order_acquire);
+        if (!recorder) continue;
+        for (size_t s = 0; s < STAGE_COUNT; ++s) {
+            recorder->histogram(static_cast<Stage>(s)).add_to(out[s]);
+        }
+    }
+}
+
+size_t registered_threads() noexcept {
+    return std::min(registry().claimed.load(std::memory_order_relaxed), MAX_THREADS);
+}
+
+std::string render_prometheus(const Snapshot& snapshot) {
+    std::string text;
+    text.reserve(STAGE_COUNT * 512);
+    text += "# HELP matrix_hotpath_stage_latency_ns Hot path stage latency in nanoseconds\n";
+    text += "# TYPE matrix_hotpath_stage_latency_ns summary\n";
+
+    char line[160];
+    for (size_t s = 0; s < STAGE_COUNT; ++s) {
+        const auto& hist = snapshot[s];
+        const char* name = stage_name(static_cast<Stage>(s));
+        for (const double q : QUANTILES) {
+            std::snprintf(line, sizeof(line),
+                          "matrix_hotpath_stage_latency_ns{stage=\"%s\",quantile=\"%g\"} %llu\n",
+                          name, q, static_cast<unsigned long long>(hist.percentile(q)));
+            text += line;
+        }
+        std::snprintf(line, sizeof(line), "matrix_hotpath_stage_latency_ns_sum{stage=\"%s\"} %llu\n",
+                      name, static_cast<unsigned long long>(hist.sum));
+        text += line;
+        std::snprintf(line, sizeof(line), "matrix_hotpath_stage_latency_ns_count{stage=\"%s\"} %llu\n",
+                      name, static_cast<unsigned long long>(hist.count));
+        text += line;
+    }
+
+    text += "# HELP matrix_hotpath_stage_latency_max_ns Largest sample per stage since start\n";
+    text += "# TYPE matrix_hotpath_stage_latency_max_ns gauge\n";
+    for (size_t s = 0; s < STAGE_COUNT; ++s) {
+        std::snprintf(line, sizeof(line), "matrix_hotpath_stage_latency_max_ns{stage=\"%s\"} %llu\n",
+                      stage_name(static_cast<Stage>(s)), static_cast<unsigned long long>(snapshot[s].max));
+        text += line;
+    }
+    return text;
+}
+
+bool write_prometheus_file(const std::string& path, const Snapshot& snapshot) {
+    const std::string text = render_prometheus(snapshot);
+    const std::string tmp = path + ".tmp";
+
+    std::FILE* file = std::fopen(tmp.c_str(), "w");
+    if (!file) return false;
+    const bool written = std::fwrite(text.data(), 1, text.size(), file) == text.size();
+    if (std::fclose(file) != 0 || !written) {
+        std::remove(tmp.c_str());
+        return false;
+    }
+    return std::rename(tmp.c_str(), path.c_str()) == 0;
+}
+
+} // namespace matrix::telemetry
@@ -1,14 +1,362 @@
 #include "tx/Composer.hpp"
 
-// Stub implementation - will be expanded with actual transaction composition
-// Key features:
-// - Raw transaction byte manipulation
-// - EIP-1559 transaction encoding
-// - Flash loan callback encoding
-// - Multi-call bundling
+#include <cstring>
+#include <memory>
+
+#include "telemetry/Telemetry.hpp"
 
 namespace matrix::tx {
 
-// Transaction composer implementation will go here
+namespace {
+
+// ============================================================================
+// RLP (sizes first, then writers over a pre-sized range)
+// ============================================================================
+
+namespace rlp {
+
+constexpr uint8_t STRING = 0x80;
+constexpr uint8_t LIST = 0xc0;
+
+size_t be_bytes(uint64_t v) noexcept {
+    return v == 0 ? 0 : 8 - static_cast<size_t>(__builtin_clzll(v)) / 8;
+}
+
+size_t header_size(size_t payload) noexcept {
+    return payload <= 55 ? 1 : 1 + be_bytes(payload);
+}
+
+size_t string_size(const uint8_t* data, size_t len) noexcept {
+    if (len == 1 && data[0] < 0x80) return 1;
+    return header_size(len) + len;
+}
+
+size_t uint_size(uint64_t v) noexcept {
+    return v < 0x80 && v != 0 ? 1 : 1 + be_bytes(v);
+}
+
+// uint256 scalar (r, s): big-endian with leading zeros stripped
+std::span<const uint8_t> scalar(const std::array<uint8_t, 32>& word) noexcept {
+    size_t skip = 0;
+    while (skip < word.size() && word[skip] == 0) ++skip;
+    return {word.data() + skip, word.size() - skip};
+}
+
+uint8_t* put_be(uint8_t* p, uint64_t v, size_t n) noexcept {
+    for (size_t i = n; i-- > 0;) *p++ = static_cast<uint8_t>(v >> (8 * i));
+    return p;
+}
+
+uint8_t* put_header(uint8_t* p, size_t payload, uint8_t base) noexcept {
+    if (payload <= 55) {
+        *p++ = static_cast<uint8_t>(base + payload);
+        return p;
+    }
+    const size_t n = be_bytes(payload);
+    *p++ = static_cast<uint8_t>(base + 55 + n);
+    return put_be(p, payload, n);
+}
+
+uint8_t* put_string(uint8_t* p, const uint8_t* data, size_t len) noexcept {
+    if (len == 1 && data[0] < 0x80) {
+        *p++ = data[0];
+        return p;
+    }
+    p = put_header(p, len, STRING);
+    if (len != 0) std::memcpy(p, data, len);
+    return p + len;
+}
+
+uint8_t* put_uint(uint8_t* p, uint64_t v) noexcept {
+    if (v < 0x80 && v != 0) {
+        *p++ = static_cast<uint8_t>(v);
+        return p;
+    }
+    const size_t n = be_bytes(v);
+    *p++ = static_cast<uint8_t>(STRING + n);
+    return put_be(p, v, n);
+}
+
+// Access list: [[address, [key, ...]], ...]
+size_t entry_payload(const AccessListEntry& entry) noexcept {
+    const size_t keys = entry.storage_keys.size() * 33;
+    return 21 + header_size(keys) + keys;
+}
+
+size_t access_list_payload(std::span<const AccessListEntry> list) noexcept {
+    size_t payload = 0;
+    for (const AccessListEntry& entry : list) {
+        const size_t e = entry_payload(entry);
+        payload += header_size(e) + e;
+    }
+    return payload;
+}
+
+uint8_t* put_access_list(uint8_t* p, std::span<const AccessListEntry> list, size_t payload) noexcept {
+    p = put_header(p, payload, LIST);
+    for (const AccessListEntry& entry : list) {
+        p = put_header(p, entry_payload(entry), LIST);
+        p = put_string(p, entry.address.data(), entry.address.size());
+        p = put_header(p, entry.storage_keys.size() * 33, LIST);
+        for (const auto& key : entry.storage_keys) p = put_string(p, key.data(), key.size());
+    }
+    return p;
+}
+
+} // namespace rlp
+
+} // namespace
+
+// ============================================================================
+// Composer
+// ============================================================================
+
+Composer::Composer(const ComposerConfig& config) : config_(config) {
+    // exactInputSingle((tokenIn, tokenOut, fee, recipient, amountIn, amountOutMinimum, sqrtPriceLimitX96))
+    std::memcpy(swap_template_.data(), EXACT_INPUT_SINGLE_SELECTOR.data(), 4);
+    abi::store_address(swap_template_.data() + 4 + 3 * abi::WORD, config_.executor);
+
+    // flashLoanSimple(receiverAddress, asset, amount, params, referralCode)
+    uint8_t* head = flash_loan_template_.data();
+    std::memcpy(head, FLASH_LOAN_SIMPLE_SELECTOR.data(), 4);
+    abi::store_u64(head + 4 + 3 * abi::WORD, 5 * abi::WORD);   // params offset
+}
+
+void Composer::write_swap(uint8_t* out, const std::array<uint8_t, 20>& token_in,
+                          const std::array<uint8_t, 20>& token_out, uint32_t fee,
+                          uint64_t amount_in, uint64_t amount_out_min) const noexcept {
+    std::memcpy(out, swap_template_.data(), SWAP_CALL_BYTES);
+    uint8_t* words = out + 4;
+    abi::store_address(words, token_in);
+    abi::store_address(words + abi::WORD, token_out);
+    abi::store_u64(words + 2 * abi::WORD, fee);
+    abi::store_u64(words + 4 * abi::WORD, amount_in);
+    abi::store_u64(words + 5 * abi::WORD, amount_out_min);
+}
+
+void Composer::write_flash_loan_head(uint8_t* out, const std::array<uint8_t, 20>& receiver,
+                                     const std::array<uint8_t, 20>& asset, uint64_t amount,
+                                     size_t params_bytes) const noexcept {
+    std::memcpy(out, flash_loan_template_.data(), FLASH_LOAN_HEAD_BYTES);
+    uint8_t* words = out + 4;
+    abi::store_address(words, receiver);
+    abi::store_address(words + abi::WORD, asset);
+    abi::store_u64(words + 2 * abi::WORD, amount);
+    abi::store_u64(words + 5 * abi::WORD, params_bytes);
+}
+
+uint8_t* Composer::write_multicall_head(uint8_t* out, size_t calls, uint64_t deadline) noexcept {
+    if (deadline != 0) {
+        std::memcpy(out, MULTICALL_DEADLINE_SELECTOR.data(), 4);
+        abi::store_u64(out + 4, deadline);
+        abi::store_u64(out + 4 + abi::WORD, 2 * abi::WORD);   // bytes[] offset
+    } else {
+        std::memcpy(out, MULTICALL_SELECTOR.data(), 4);
+        abi::store_u64(out + 4, abi::WORD);
+    }
+    uint8_t* const length = out + multicall_head_bytes(deadline != 0) - abi::WORD;
+    abi::store_u64(length, calls);
+    return length + abi::WORD;   // Element offsets start here
+}
+
+std::optional<RawTransaction> Composer::compose_arbitrage(
+    const FlashLoanParams& flash_loan,
+    std::span<const SwapParams> swaps,
+    uint64_t gas_limit,
+    uint64_t max_priority_fee,
+    uint64_t max_fee,
+    ByteWriter& calldata,
+    uint64_t deadline
+) const noexcept {
+    if (swaps.empty()) return std::nullopt;
+    telemetry::StageTimer timer(telemetry::Stage::COMPOSE);
+
+    const size_t n = swaps.size();
+    const bool has_deadline = deadline != 0;
+    constexpr size_t CALL_SLOT = abi::WORD + abi::padded(SWAP_CALL_BYTES);   // Length word + padded call
+    const size_t params_bytes = multicall_bytes(n, abi::padded(SWAP_CALL_BYTES), has_deadline);
+    const size_t total = arbitrage_calldata_bytes(n, has_deadline);
+
+    uint8_t* const out = calldata.claim(total);
+    if (!out) return std::nullopt;
+
+    write_flash_loan_head(out, config_.executor, flash_loan.asset, flash_loan.amount, params_bytes);
+
+    // params = multicall([deadline,] bytes[] swaps)
+    uint8_t* const offsets = write_multicall_head(out + FLASH_LOAN_HEAD_BYTES, n, deadline);
+    for (size_t i = 0; i < n; ++i) {
+        const SwapParams& swap = swaps[i];
+        abi::store_u64(offsets + i * abi::WORD, n * abi::WORD + i * CALL_SLOT);
+        uint8_t* const call = out + swap_call_offset(n, i, has_deadline);
+        abi::store_u64(call - abi::WORD, SWAP_CALL_BYTES);
+        write_swap(call, swap.token_in, swap.token_out, swap.fee, swap.amount_in, swap.min_amount_out);
+        std::memset(call + SWAP_CALL_BYTES, 0, CALL_SLOT - abi::WORD - SWAP_CALL_BYTES);
+    }
+    uint8_t* const end = out + FLASH_LOAN_HEAD_BYTES + params_bytes;
+    std::memset(end, 0, static_cast<size_t>(out + total - end));
+
+    return arbitrage_transaction({out, total}, gas_limit, max_priority_fee, max_fee);
+}
+
+RawTransaction Composer::arbitrage_transaction(
+    std::span<const uint8_t> calldata,
+    uint64_t gas_limit,
+    uint64_t max_priority_fee,
+    uint64_t max_fee
+) const noexcept {
+    RawTransaction tx;
+    tx.type = TxType::EIP1559;
+    tx.chain_id = config_.chain_id;
+    tx.max_priority_fee_per_gas = max_priority_fee;
+    tx.max_fee_per_gas = max_fee;
+    tx.gas_limit = gas_limit;
+    tx.to = config_.flash_loan_pool;
+    tx.data = calldata;
+    return tx;
+}
+
+Composer::FieldSizes Composer::field_sizes(const RawTransaction& tx, bool with_signature) noexcept {
+    const bool typed = tx.type != TxType::LEGACY;
+    const std::span<const uint8_t> r = rlp::scalar(tx.r);
+    const std::span<const uint8_t> s = rlp::scalar(tx.s);
+    const uint64_t v = typed ? tx.v : tx.chain_id * 2 + 35 + tx.v;
+    const size_t access_list = rlp::access_list_payload(tx.access_list);
+
+    size_t payload = rlp::uint_size(tx.nonce) + rlp::uint_size(tx.max_fee_per_gas) + rlp::uint_size(tx.gas_limit) +
+                     21 + rlp::uint_size(tx.value) + rlp::string_size(tx.data.data(), tx.data.size());
+    if (typed) payload += rlp::uint_size(tx.chain_id) + rlp::header_size(access_list) + access_list;
+    if (tx.type == TxType::EIP1559) payload += rlp::uint_size(tx.max_priority_fee_per_gas);
+    if (with_signature) {
+        payload += rlp::uint_size(v) + rlp::string_size(r.data(), r.size()) + rlp::string_size(s.data(), s.size());
+    } else if (!typed) {
+        payload += rlp::uint_size(tx.chain_id) + 2;   // chain_id, 0, 0
+    }
+    return {payload, (typed ? 1 : 0) + rlp::header_size(payload) + payload};
+}
+
+std::span<const uint8_t> Composer::encode_fields(const RawTransaction& tx, bool with_signature,
+                                                 ByteWriter& out) const noexcept {
+    const bool typed = tx.type != TxType::LEGACY;
+    const bool legacy_unsigned = !typed && !with_signature;
+    const std::span<const uint8_t> r = rlp::scalar(tx.r);
+    const std::span<const uint8_t> s = rlp::scalar(tx.s);
+    const uint64_t v = typed ? tx.v : tx.chain_id * 2 + 35 + tx.v;   // EIP-155
+    const size_t access_list = rlp::access_list_payload(tx.access_list);
+
+    // Sizing pass
+    const auto [payload, total] = field_sizes(tx, with_signature);
+    uint8_t* p = out.claim(total);
+    if (!p) return {};
+    uint8_t* const start = p;
+
+    // Writing pass
+    if (typed) *p++ = static_cast<uint8_t>(tx.type);
+    p = rlp::put_header(p, payload, rlp::LIST);
+    if (typed) p = rlp::put_uint(p, tx.chain_id);
+    p = rlp::put_uint(p, tx.nonce);
+    if (tx.type == TxType::EIP1559) p = rlp::put_uint(p, tx.max_priority_fee_per_gas);
+    p = rlp::put_uint(p, tx.max_fee_per_gas);
+    p = rlp::put_uint(p, tx.gas_limit);
+    p = rlp::put_string(p, tx.to.data(), tx.to.size());
+    p = rlp::put_uint(p, tx.value);
+    p = rlp::put_string(p, tx.data.data(), tx.data.size());
+    if (typed) p = rlp::put_access_list(p, tx.access_list, access_list);
+    if (with_signature) {
+        p = rlp::put_uint(p, v);
+        p = rlp::put_string(p, r.data(), r.size());
+        p = rlp::put_string(p, s.data(), s.size());
+    } else if (legacy_unsigned) {
+        p = rlp::put_uint(p, tx.chain_id);
+        *p++ = rlp::STRING;
+        *p++ = rlp::STRING;
+    }
+    return {start, total};
+}
+
+std::span<const uint8_t> Composer::encode_rlp(const RawTransaction& tx, ByteWriter& out) const noexcept {
+    return encode_fields(tx, true, out);
+}
+
+std::span<const uint8_t> Composer::encode_signing_payload(const RawTransaction& tx, ByteWriter& out) const noexcept {
+    return encode_fields(tx, false, out);
+}
+
+size_t Composer::signing_payload_bytes(const RawTransaction& tx) noexcept {
+    return field_sizes(tx, false).total;
+}
+
+Hash256 Composer::hash_for_signing(const RawTransaction& tx) const {
+    constexpr size_t STACK_BYTES = 4096;
+    const size_t bytes = signing_payload_bytes(tx);
+
+    uint8_t stack[STACK_BYTES];
+    std::unique_ptr<uint8_t[]> heap;
+    uint8_t* buf = stack;
+    if (bytes > STACK_BYTES) {
+        heap = std::make_unique_for_overwrite<uint8_t[]>(bytes);
+        buf = heap.get();
+    }
+    ByteWriter out(buf, bytes);
+    return keccak256(encode_signing_payload(tx, out));
+}
+
+std::span<const uint8_t> Composer::encode_aave_flash_loan(
+    const std::array<uint8_t, 20>& receiver,
+    const std::array<uint8_t, 20>& asset,
+    uint64_t amount,
+    std::span<const uint8_t> params,
+    ByteWriter& out
+) const noexcept {
+    const size_t total = FLASH_LOAN_HEAD_BYTES + abi::padded(params.size());
+    uint8_t* p = out.claim(total);
+    if (!p) return {};
+
+    write_flash_loan_head(p, receiver, asset, amount, params.size());
+    if (!params.empty()) std::memcpy(p + FLASH_LOAN_HEAD_BYTES, params.data(), params.size());
+    std::memset(p + FLASH_LOAN_HEAD_BYTES + params.size(), 0, total - FLASH_LOAN_HEAD_BYTES - params.size());
+    return {p, total};
+}
+
+std::span<const uint8_t> Composer::encode_uniswap_swap(
+    const std::array<uint8_t, 20>& token_in,
+    const std::array<uint8_t, 20>& token_out,
+    uint32_t fee,
+    uint64_t amount_in,
+    uint64_t amount_out_min,
+    ByteWriter& out
+) const noexcept {
+    uint8_t* p = out.claim(SWAP_CALL_BYTES);
+    if (!p) return {};
+    write_swap(p, token_in, token_out, fee, amount_in, amount_out_min);
+    return {p, SWAP_CALL_BYTES};
+}
+
+std::span<const uint8_t> Composer::encode_multicall(
+    std::span<const std::span<const uint8_t>> calls,
+    ByteWriter& out,
+    uint64_t deadline
+) const noexcept {
+    const size_t n = calls.size();
+    size_t total = multicall_head_bytes(deadline != 0) + n * 2 * abi::WORD;
+    for (const auto& call : calls) total += abi::padded(call.size());
+
+    uint8_t* p = out.claim(total);
+    if (!p) return {};
+
+    uint8_t* const offsets = write_multicall_head(p, n, deadline);   // Element offsets are relative to here
+    size_t offset = n * abi::WORD;
+    for (size_t i = 0; i < n; ++i) {
+        const std::span<const uint8_t> call = calls[i];
+        const size_t padded = abi::padded(call.size());
+        abi::store_u64(offsets + i * abi::WORD, offset);
+
+        uint8_t* const element = offsets + offset;
+        abi::store_u64(element, call.size());
+        if (!call.empty()) std::memcpy(element + abi::WORD, call.data(), call.size());
+        std::memset(element + abi::WORD + call.size(), 0, padded - call.size());
+        offset += abi::WORD + padded;
+    }
+    return {p, total};
+}
 
 } // namespace matrix::tx
@@ -0,0 +1,209 @@
+#include "tx/Keccak.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace matrix::tx {
+
+namespace {
+
+constexpr size_t RATE = 136;                 // 1088-bit rate of Keccak-256
+constexpr size_t RATE_LANES = RATE / 8;
+
+constexpr uint64_t ROUND_CONSTANTS[24] = {
+    0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808aULL, 0x8000000080008000ULL,
+    0x000000000000808bULL, 0x0000000080000001ULL, 0x8000000080008081ULL, 0x8000000000008009ULL,
+    0x000000000000008aULL, 0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000aULL,
+    0x000000008000808bULL, 0x800000000000008bULL, 0x8000000000008089ULL, 0x8000000000008003ULL,
+    0x8000000000008002ULL, 0x8000000000000080ULL, 0x000000000000800aULL, 0x800000008000000aULL,
+    0x8000000080008081ULL, 0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL};
+
+// rho rotation of lane PI[i], walked along the pi permutation
+constexpr int RHO[24] = {1, 3, 6, 10, 15, 21, 28, 36, 45, 55, 2, 14,
+                         27, 41, 56, 8, 25, 43, 62, 18, 39, 61, 20, 44};
+constexpr int PI[24] = {10, 7, 11, 17, 18, 3, 5, 16, 8, 21, 24, 4,
+                        15, 23, 19, 13, 12, 2, 20, 14, 22, 9, 6, 1};
+
+inline uint64_t rotl(uint64_t x, int n) noexcept {
+    return (x << n) | (x >> (64 - n));
+}
+
+inline uint64_t load_le(const uint8_t* p) noexcept {
+    uint64_t v;
+    std::memcpy(&v, p, 8);   // x86 and aarch64 lanes are little-endian
+    return v;
+}
+
+// Final (padded) block of a message whose full blocks have been absorbed
+void pad_tail(const uint8_t* tail, size_t len, uint8_t (&block)[RATE]) noexcept {
+    std::memset(block, 0, RATE);
+    if (len != 0) std::memcpy(block, tail, len);
+    block[len] ^= 0x01;
+    block[RATE - 1] ^= 0x80;
+}
+
+void store_digest(const uint64_t* lanes, Hash256& out) noexcept {
+    std::memcpy(out.data(), lanes, 32);
+}
+
+#if defined(__AVX2__)
+
+template<int N>
+inline __m256i rotl4(__m256i x) noexcept {
+#if defined(__AVX512VL__)
+    return _mm256_rol_epi64(x, N);
+#else
+    return _mm256_or_si256(_mm256_slli_epi64(x, N), _mm256_srli_epi64(x, 64 - N));
+#endif
+}
+
+template<size_t... I>
+inline void rho_pi(__m256i (&a)[25], std::index_sequence<I...>) noexcept {
+    __m256i current = a[1];
+    ((void)([&] {
+        const __m256i next = a[PI[I]];
+        a[PI[I]] = rotl4<RHO[I]>(current);
+        current = next;
+    }()), ...);
+}
+
+inline __m256i andnot_xor(__m256i a, __m256i b, __m256i c) noexcept {
+    return _mm256_xor_si256(a, _mm256_andnot_si256(b, c));
+}
+
+void keccak_f1600_x4(__m256i (&a)[25]) noexcept {
+    for (int round = 0; round < 24; ++round) {
+        // theta
+        __m256i c[5];
+        for (int x = 0; x < 5; ++x) {
+            c[x] = _mm256_xor_si256(_mm256_xor_si256(a[x], a[x + 5]),
+                                    _mm256_xor_si256(_mm256_xor_si256(a[x + 10], a[x + 15]), a[x + 20]));
+        }
+        for (int x = 0; x < 5; ++x) {
+            const __m256i d = _mm256_xor_si256(c[(x + 4) % 5], rotl4<1>(c[(x + 1) % 5]));
+            for (int y = 0; y < 25; y += 5) a[y + x] = _mm256_xor_si256(a[y + x], d);
+        }
+        rho_pi(a, std::make_index_sequence<24>{});
+        // chi
+        for (int y = 0; y < 25; y += 5) {
+            const __m256i a0 = a[y], a1 = a[y + 1], a2 = a[y + 2], a3 = a[y + 3], a4 = a[y + 4];
+            a[y] = andnot_xor(a0, a1, a2);
+            a[y + 1] = andnot_xor(a1, a2, a3);
+            a[y + 2] = andnot_xor(a2, a3, a4);
+            a[y + 3] = andnot_xor(a3, a4, a0);
+            a[y + 4] = andnot_xor(a4, a0, a1);
+        }
+        // iota
+        a[0] = _mm256_xor_si256(a[0], _mm256_set1_epi64x(static_cast<long long>(ROUND_CONSTANTS[round])));
+    }
+}
+
+#endif
+
+} // namespace
+
+void keccak_f1600(uint64_t (&a)[25]) noexcept {
+    for (int round = 0; round < 24; ++round) {
+        uint64_t c[5];
+        for (int x = 0; x < 5; ++x) c[x] = a[x] ^ a[x + 5] ^ a[x + 10] ^ a[x + 15] ^ a[x + 20];
+        for (int x = 0; x < 5; ++x) {
+            const uint64_t d = c[(x + 4) % 5] ^ rotl(c[(x + 1) % 5], 1);
+            for (int y = 0; y < 25; y += 5) a[y + x] ^= d;
+        }
+
+        uint64_t current = a[1];
+        for (int i = 0; i < 24; ++i) {
+            const uint64_t next = a[PI[i]];
+            a[PI[i]] = rotl(current, RHO[i]);
+            current = next;
+        }
+
+        for (int y = 0; y < 25; y += 5) {
+            const uint64_t a0 = a[y], a1 = a[y + 1], a2 = a[y + 2], a3 = a[y + 3], a4 = a[y + 4];
+            a[y] = a0 ^ (~a1 & a2);
+            a[y + 1] = a1 ^ (~a2 & a3);
+            a[y + 2] = a2 ^ (~a3 & a4);
+            a[y + 3] = a3 ^ (~a4 & a0);
+            a[y + 4] = a4 ^ (~a0 & a1);
+        }
+
+        a[0] ^= ROUND_CONSTANTS[round];
+    }
+}
+
+Hash256 keccak256(std::span<const uint8_t> data) noexcept {
+    uint64_t state[25] = {};
+    const uint8_t* p = data.data();
+    size_t len = data.size();
+
+    for (; len >= RATE; p += RATE, len -= RATE) {
+        for (size_t i = 0; i < RATE_LANES; ++i) state[i] ^= load_le(p + 8 * i);
+        keccak_f1600(state);
+    }
+
+    uint8_t block[RATE];
+    pad_tail(p, len, block);
+    for (size_t i = 0; i < RATE_LANES; ++i) state[i] ^= load_le(block + 8 * i);
+    keccak_f1600(state);
+
+    Hash256 out;
+    store_digest(state, out);
+    return out;
+}
+
+void keccak256_x4(const std::array<std::span<const uint8_t>, 4>& inputs,
+                  std::array<Hash256, 4>& out) noexcept {
+#if defined(__AVX2__)
+    // Message j is absorbed in blocks[j] blocks, the last one padded
+    size_t blocks[4];
+    size_t max_blocks = 0;
+    for (size_t j = 0; j < 4; ++j) {
+        blocks[j] = inputs[j].size() / RATE + 1;
+        max_blocks = std::max(max_blocks, blocks[j]);
+    }
+
+    alignas(32) uint8_t tails[4][RATE];
+    for (size_t j = 0; j < 4; ++j) {
+        const size_t full = (blocks[j] - 1) * RATE;
+        pad_tail(inputs[j].data() + full, inputs[j].size() - full, tails[j]);
+    }
+
+    static constexpr uint8_t ZERO_BLOCK[RATE] = {};
+    __m256i a[25];
+    for (auto& lane : a) lane = _mm256_setzero_si256();
+
+    for (size_t b = 0; b < max_blocks; ++b) {
+        const uint8_t* src[4];
+        for (size_t j = 0; j < 4; ++j) {
+            // Finished messages keep absorbing zeros; their digest is already out
+            src[j] = b + 1 < blocks[j] ? inputs[j].data() + b * RATE
+                   : b + 1 == blocks[j] ? tails[j]
+                   : ZERO_BLOCK;
+        }
+        for (size_t i = 0; i < RATE_LANES; ++i) {
+            const __m256i words = _mm256_set_epi64x(
+                static_cast<long long>(load_le(src[3] + 8 * i)), static_cast<long long>(load_le(src[2] + 8 * i)),
+                static_cast<long long>(load_le(src[1] + 8 * i)), static_cast<long long>(load_le(src[0] + 8 * i)));
+            a[i] = _mm256_xor_si256(a[i], words);
+        }
+        keccak_f1600_x4(a);
+
+        for (size_t j = 0; j < 4; ++j) {
+            if (b + 1 != blocks[j]) continue;
+            alignas(32) uint64_t lanes[4][4];
+            for (size_t i = 0; i < 4; ++i) _mm256_store_si256(reinterpret_cast<__m256i*>(lanes[i]), a[i]);
+            const uint64_t digest[4] = {lanes[0][j], lanes[1][j], lanes[2][j], lanes[3][j]};
+            store_digest(digest, out[j]);
+        }
+    }
+#else
+    for (size_t j = 0; j < 4; ++j) out[j] = keccak256(inputs[j]);
+#endif
+}
+
+} // namespace matrix::tx
@@ -0,0 +1,141 @@
+#include "tx/RouteCache.hpp"
+
+#include <cstring>
+#include <new>
+#include <optional>
+
+#include "telemetry/Telemetry.hpp"
+
+namespace matrix::tx {
+
+namespace {
+
+uint64_t fold_address(uint64_t h, const std::array<uint8_t, 20>& address) noexcept {
+    uint64_t w0, w1;
+    uint32_t w2;
+    std::memcpy(&w0, address.data(), 8);
+    std::memcpy(&w1, address.data() + 8, 8);
+    std::memcpy(&w2, address.data() + 16, 4);
+    return orderbook::mix64(h ^ w0 ^ orderbook::mix64(w1 ^ w2));
+}
+
+} // namespace
+
+RouteCache::RouteCache(const Composer& composer, memory::Arena& arena, size_t max_routes)
+    : composer_(composer)
+    , index_(arena, max_routes)
+    , templates_(static_cast<Template*>(arena.allocate(max_routes * sizeof(Template), alignof(Template))))
+    , max_routes_(max_routes) {
+    if (!templates_) throw std::bad_alloc();
+}
+
+uint64_t RouteCache::route_key(uint64_t chain_id, const FlashLoanParams& flash_loan,
+                               std::span<const SwapParams> swaps, bool deadline) noexcept {
+    uint64_t h = orderbook::mix64(chain_id ^ (static_cast<uint64_t>(swaps.size()) << 40) ^
+                                  (static_cast<uint64_t>(deadline) << 48));
+    h = fold_address(h, flash_loan.asset);
+    for (const SwapParams& swap : swaps) h = fold_address(h ^ static_cast<uint64_t>(swap.dex), swap.pool);
+    return h;
+}
+
+bool RouteCache::matches(const Route& route, const FlashLoanParams& flash_loan,
+                         std::span<const SwapParams> swaps, bool deadline) noexcept {
+    if (route.hops != swaps.size() || route.deadline != deadline || route.asset != flash_loan.asset) return false;
+    for (size_t i = 0; i < swaps.size(); ++i) {
+        const Hop& hop = route.hop[i];
+        const SwapParams& swap = swaps[i];
+        if (hop.pool != swap.pool || hop.token_in != swap.token_in || hop.token_out != swap.token_out ||
+            hop.fee != swap.fee || hop.dex != swap.dex) {
+            return false;
+        }
+    }
+    return true;
+}
+
+const RouteCache::Template* RouteCache::compile(uint64_t key, const FlashLoanParams& flash_loan,
+                                                std::span<const SwapParams> swaps, uint64_t deadline) noexcept {
+    Template& t = templates_[size_];
+    ByteWriter writer(t.bytes, sizeof(t.bytes));
+    const auto tx = composer_.compose_arbitrage(flash_loan, swaps, 0, 0, 0, writer, deadline);
+    if (!tx) return nullptr;
+
+    const size_t n = swaps.size();
+    const bool has_deadline = deadline != 0;
+    t.route.chain_id = composer_.config().chain_id;
+    t.route.asset = flash_loan.asset;
+    t.route.hops = static_cast<uint32_t>(n);
+    t.route.deadline = has_deadline;
+    for (size_t i = 0; i < n; ++i) {
+        t.route.hop[i] = {swaps[i].pool, swaps[i].token_in, swaps[i].token_out, swaps[i].fee, swaps[i].dex};
+    }
+    t.size = static_cast<uint16_t>(tx->data.size());
+    t.deadline_offset = has_deadline ? static_cast<uint16_t>(Composer::DEADLINE_OFFSET) : 0;
+    t.amount_offset = static_cast<uint16_t>(Composer::FLASH_LOAN_AMOUNT_OFFSET);
+    for (size_t i = 0; i < n; ++i) {
+        t.amount_in_offsets[i] = static_cast<uint16_t>(
+            Composer::swap_word_offset(n, i, Composer::SWAP_AMOUNT_IN_WORD, has_deadline));
+        t.min_out_offsets[i] = static_cast<uint16_t>(
+            Composer::swap_word_offset(n, i, Composer::SWAP_MIN_OUT_WORD, has_deadline));
+    }
+
+    if (!index_.insert(key, static_cast<uint32_t>(size_)).first) return nullptr;
+    ++size_;
+    return &t;
+}
+
+std::optional<RawTransaction> RouteCache::compose_arbitrage(
+    const FlashLoanParams& flash_loan,
+    std::span<const SwapParams> swaps,
+    uint64_t gas_limit,
+    uint64_t max_priority_fee,
+    uint64_t max_fee,
+    ByteWriter& calldata,
+    uint64_t deadline
+) noexcept {
+    if (swaps.empty() || swaps.size() > MAX_HOPS) {
+        ++stats_.uncached;
+        return composer_.compose_arbitrage(flash_loan, swaps, gas_limit, max_priority_fee, max_fee,
+                                           calldata, deadline);
+    }
+
+    const bool has_deadline = deadline != 0;
+    const uint64_t key = route_key(composer_.config().chain_id, flash_loan, swaps, has_deadline);
+
+    // A miss is timed by the composition that compiles it: one COMPOSE sample
+    // per call either way
+    std::optional<telemetry::StageTimer> timer;
+    const Template* t = nullptr;
+    if (const uint32_t* slot = index_.find(key)) {
+        t = &templates_[*slot];
+        if (!matches(t->route, flash_loan, swaps, has_deadline)) {
+            t = nullptr;   // Key collision
+        } else {
+            timer.emplace(telemetry::Stage::COMPOSE);
+            ++stats_.hits;
+        }
+    } else if (size_ < max_routes_) {
+        t = compile(key, flash_loan, swaps, deadline);
+        if (t) ++stats_.misses;
+    }
+
+    if (!t) {
+        ++stats_.uncached;
+        return composer_.compose_arbitrage(flash_loan, swaps, gas_limit, max_priority_fee, max_fee,
+                                           calldata, deadline);
+    }
+
+    uint8_t* const out = calldata.claim(t->size);
+    if (!out) return std::nullopt;
+
+    std::memcpy(out, t->bytes, t->size);
+    abi::store_u64(out + t->amount_offset, flash_loan.amount);
+    for (size_t i = 0; i < swaps.size(); ++i) {
+        abi::store_u64(out + t->amount_in_offsets[i], swaps[i].amount_in);
+        abi::store_u64(out + t->min_out_offsets[i], swaps[i].min_amount_out);
+    }
+    if (t->deadline_offset != 0) abi::store_u64(out + t->deadline_offset, deadline);
+
+    return composer_.arbitrage_transaction({out, t->size}, gas_limit, max_priority_fee, max_fee);
+}
+
+} // namespace matrix::tx
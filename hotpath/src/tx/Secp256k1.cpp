@@ -0,0 +1,631 @@
+#include "tx/Secp256k1.hpp"
+
+#include <cstring>
+
+namespace matrix::tx::secp256k1 {
+
+namespace {
+
+using u128 = unsigned __int128;
+
+// ============================================================================
+// 256-bit limbs (little-endian), shared by the field and the scalar ring
+// ============================================================================
+
+struct U256 {
+    uint64_t v[4];
+};
+
+inline uint64_t mask_if(uint64_t bit) noexcept {   // bit in {0, 1} -> all zeros / all ones
+    return 0 - bit;
+}
+
+inline U256 select(uint64_t mask, const U256& a, const U256& b) noexcept {   // mask ? a : b
+    U256 r;
+    for (int i = 0; i < 4; ++i) r.v[i] = (a.v[i] & mask) | (b.v[i] & ~mask);
+    return r;
+}
+
+U256 from_be(const uint8_t* bytes) noexcept {
+    U256 r;
+    for (int i = 0; i < 4; ++i) {
+        uint64_t w = 0;
+        for (int b = 0; b < 8; ++b) w = (w << 8) | bytes[(3 - i) * 8 + b];
+        r.v[i] = w;
+    }
+    return r;
+}
+
+void to_be(const U256& a, uint8_t* bytes) noexcept {
+    for (int i = 0; i < 4; ++i) {
+        for (int b = 0; b < 8; ++b) bytes[(3 - i) * 8 + b] = static_cast<uint8_t>(a.v[i] >> (56 - 8 * b));
+    }
+}
+
+// r = a + c (c < 2^64 added at limb 0), returns carry
+inline uint64_t add_small(const U256& a, uint64_t c, U256& r) noexcept {
+    u128 acc = c;
+    for (int i = 0; i < 4; ++i) {
+        acc += a.v[i];
+        r.v[i] = static_cast<uint64_t>(acc);
+        acc >>= 64;
+    }
+    return static_cast<uint64_t>(acc);
+}
+
+inline uint64_t add(const U256& a, const U256& b, U256& r) noexcept {
+    u128 acc = 0;
+    for (int i = 0; i < 4; ++i) {
+        acc += static_cast<u128>(a.v[i]) + b.v[i];
+        r.v[i] = static_cast<uint64_t>(acc);
+        acc >>= 64;
+    }
+    return static_cast<uint64_t>(acc);
+}
+
+// r = a - b, returns borrow
+inline uint64_t sub(const U256& a, const U256& b, U256& r) noexcept {
+    uint64_t borrow = 0;
+    for (int i = 0; i < 4; ++i) {
+        const u128 d = static_cast<u128>(a.v[i]) - b.v[i] - borrow;
+        r.v[i] = static_cast<uint64_t>(d);
+        borrow = static_cast<uint64_t>(d >> 64) & 1;
+    }
+    return borrow;
+}
+
+// Product scanning: one column of the 512-bit product at a time into a
+// 192-bit accumulator, so the carry chains stay short
+inline void mac(u128& acc, uint64_t& top, uint64_t x, uint64_t y) noexcept {
+    const u128 p = static_cast<u128>(x) * y;
+    acc += p;
+    top += acc < p;
+}
+
+inline void mac2(u128& acc, uint64_t& top, uint64_t x, uint64_t y) noexcept {   // acc += 2xy
+    const u128 p = static_cast<u128>(x) * y;
+    acc += p;
+    top += acc < p;
+    acc += p;
+    top += acc < p;
+}
+
+inline uint64_t take_column(u128& acc, uint64_t& top) noexcept {
+    const uint64_t low = static_cast<uint64_t>(acc);
+    acc = (acc >> 64) | (static_cast<u128>(top) << 64);
+    top = 0;
+    return low;
+}
+
+void mul_wide(const U256& a, const U256& b, uint64_t (&r)[8]) noexcept {
+    u128 acc = 0;
+    uint64_t top = 0;
+    mac(acc, top, a.v[0], b.v[0]);
+    r[0] = take_column(acc, top);
+    mac(acc, top, a.v[0], b.v[1]);
+    mac(acc, top, a.v[1], b.v[0]);
+    r[1] = take_column(acc, top);
+    mac(acc, top, a.v[0], b.v[2]);
+    mac(acc, top, a.v[1], b.v[1]);
+    mac(acc, top, a.v[2], b.v[0]);
+    r[2] = take_column(acc, top);
+    mac(acc, top, a.v[0], b.v[3]);
+    mac(acc, top, a.v[1], b.v[2]);
+    mac(acc, top, a.v[2], b.v[1]);
+    mac(acc, top, a.v[3], b.v[0]);
+    r[3] = take_column(acc, top);
+    mac(acc, top, a.v[1], b.v[3]);
+    mac(acc, top, a.v[2], b.v[2]);
+    mac(acc, top, a.v[3], b.v[1]);
+    r[4] = take_column(acc, top);
+    mac(acc, top, a.v[2], b.v[3]);
+    mac(acc, top, a.v[3], b.v[2]);
+    r[5] = take_column(acc, top);
+    mac(acc, top, a.v[3], b.v[3]);
+    r[6] = take_column(acc, top);
+    r[7] = static_cast<uint64_t>(acc);
+}
+
+// a^2: each cross product once, doubled (10 multiplies instead of 16)
+void sqr_wide(const U256& a, uint64_t (&r)[8]) noexcept {
+    u128 acc = 0;
+    uint64_t top = 0;
+    mac(acc, top, a.v[0], a.v[0]);
+    r[0] = take_column(acc, top);
+    mac2(acc, top, a.v[0], a.v[1]);
+    r[1] = take_column(acc, top);
+    mac2(acc, top, a.v[0], a.v[2]);
+    mac(acc, top, a.v[1], a.v[1]);
+    r[2] = take_column(acc, top);
+    mac2(acc, top, a.v[0], a.v[3]);
+    mac2(acc, top, a.v[1], a.v[2]);
+    r[3] = take_column(acc, top);
+    mac2(acc, top, a.v[1], a.v[3]);
+    mac(acc, top, a.v[2], a.v[2]);
+    r[4] = take_column(acc, top);
+    mac2(acc, top, a.v[2], a.v[3]);
+    r[5] = take_column(acc, top);
+    mac(acc, top, a.v[3], a.v[3]);
+    r[6] = take_column(acc, top);
+    r[7] = static_cast<uint64_t>(acc);
+}
+
+// ============================================================================
+// Field: integers mod p = 2^256 - 2^32 - 977
+// ============================================================================
+
+constexpr uint64_t FIELD_C = 0x1000003D1ULL;   // 2^256 - p
+
+// (carry * 2^256 + t) mod p, for values below 2p
+inline U256 fe_normalize(const U256& t, uint64_t carry) noexcept {
+    U256 u;
+    const uint64_t over = add_small(t, FIELD_C, u);   // t - p (mod 2^256), overflows iff t >= p
+    return select(mask_if(carry | over), u, t);
+}
+
+inline U256 fe_add(const U256& a, const U256& b) noexcept {
+    U256 t;
+    const uint64_t carry = add(a, b, t);
+    return fe_normalize(t, carry);
+}
+
+inline U256 fe_sub(const U256& a, const U256& b) noexcept {
+    U256 t;
+    const uint64_t borrow = sub(a, b, t);
+    U256 u;
+    sub(t, U256{{FIELD_C, 0, 0, 0}}, u);   // t + p (mod 2^256)
+    return select(mask_if(borrow), u, t);
+}
+
+// 512-bit product mod p: 2^256 = C (mod p), so fold the high half in twice
+U256 fe_reduce(const uint64_t (&r)[8]) noexcept {
+    U256 t;
+    u128 acc = 0;
+    for (int i = 0; i < 4; ++i) {
+        acc += static_cast<u128>(r[i + 4]) * FIELD_C + r[i];
+        t.v[i] = static_cast<uint64_t>(acc);
+        acc >>= 64;
+    }
+    acc = static_cast<u128>(static_cast<uint64_t>(acc)) * FIELD_C;
+    for (int i = 0; i < 4; ++i) {
+        acc += t.v[i];
+        t.v[i] = static_cast<uint64_t>(acc);
+        acc >>= 64;
+    }
+    return fe_normalize(t, static_cast<uint64_t>(acc));
+}
+
+inline U256 fe_mul(const U256& a, const U256& b) noexcept {
+    uint64_t r[8];
+    mul_wide(a, b, r);
+    return fe_reduce(r);
+}
+
+inline U256 fe_sqr(const U256& a) noexcept {
+    uint64_t r[8];
+    sqr_wide(a, r);
+    return fe_reduce(r);
+}
+
+inline U256 fe_sqr_n(U256 a, int n) noexcept {
+    for (int i = 0; i < n; ++i) a = fe_sqr(a);
+    return a;
+}
+
+// a^(p-2), addition chain of 255 squarings and 15 multiplications
+U256 fe_inv(const U256& a) noexcept {
+    const U256 x2 = fe_mul(fe_sqr_n(a, 1), a);
+    const U256 x3 = fe_mul(fe_sqr_n(x2, 1), a);
+    const U256 x6 = fe_mul(fe_sqr_n(x3, 3), x3);
+    const U256 x9 = fe_mul(fe_sqr_n(x6, 3), x3);
+    const U256 x11 = fe_mul(fe_sqr_n(x9, 2), x2);
+    const U256 x22 = fe_mul(fe_sqr_n(x11, 11), x11);
+    const U256 x44 = fe_mul(fe_sqr_n(x22, 22), x22);
+    const U256 x88 = fe_mul(fe_sqr_n(x44, 44), x44);
+    const U256 x176 = fe_mul(fe_sqr_n(x88, 88), x88);
+    const U256 x220 = fe_mul(fe_sqr_n(x176, 44), x44);
+    const U256 x223 = fe_mul(fe_sqr_n(x220, 3), x3);
+    U256 t = fe_mul(fe_sqr_n(x223, 23), x22);
+    t = fe_mul(fe_sqr_n(t, 5), a);
+    t = fe_mul(fe_sqr_n(t, 3), x2);
+    return fe_mul(fe_sqr_n(t, 2), a);
+}
+
+// ============================================================================
+// Scalars: integers mod the group order n
+// ============================================================================
+
+constexpr U256 ORDER = {{0xBFD25E8CD0364141ULL, 0xBAAEDCE6AF48A03BULL, 0xFFFFFFFFFFFFFFFEULL, 0xFFFFFFFFFFFFFFFFULL}};
+constexpr U256 HALF_ORDER = {{0xDFE92F46681B20A0ULL, 0x5D576E7357A4501DULL, 0xFFFFFFFFFFFFFFFFULL, 0x7FFFFFFFFFFFFFFFULL}};
+constexpr uint64_t ORDER_C[3] = {0x402DA1732FC9BEBFULL, 0x4551231950B75FC4ULL, 1};   // 2^256 - n
+
+// (carry * 2^256 + t) mod n, for values below 2n
+inline U256 sc_normalize(const U256& t, uint64_t carry) noexcept {
+    U256 u;
+    const uint64_t borrow = sub(t, ORDER, u);
+    return select(mask_if(carry | (borrow ^ 1)), u, t);
+}
+
+inline U256 sc_reduce(const U256& a) noexcept {   // a < 2^256 < 2n
+    return sc_normalize(a, 0);
+}
+
+inline U256 sc_add(const U256& a, const U256& b) noexcept {
+    U256 t;
+    const uint64_t carry = add(a, b, t);
+    return sc_normalize(t, carry);
+}
+
+// out = in[0..3] + in[4..in_limbs) * (2^256 - n); out has in_limbs - 1 limbs
+template<size_t IN>
+void sc_fold(const uint64_t (&in)[IN], uint64_t (&out)[IN - 1]) noexcept {
+    static_assert(IN > 4);
+    constexpr size_t HIGH = IN - 4;
+    for (auto& w : out) w = 0;
+    for (size_t i = 0; i < 4; ++i) out[i] = in[i];
+    for (size_t i = 0; i < HIGH; ++i) {
+        u128 carry = 0;
+        for (size_t j = 0; j < 3; ++j) {
+            carry += static_cast<u128>(in[4 + i]) * ORDER_C[j] + out[i + j];
+            out[i + j] = static_cast<uint64_t>(carry);
+            carry >>= 64;
+        }
+        for (size_t k = i + 3; k < IN - 1; ++k) {
+            carry += out[k];
+            out[k] = static_cast<uint64_t>(carry);
+            carry >>= 64;
+        }
+    }
+}
+
+// 512-bit product mod n: 512 -> 385 -> 258 -> 256 bits
+U256 sc_reduce_wide(const uint64_t (&r)[8]) noexcept {
+    uint64_t r7[7];
+    sc_fold(r, r7);
+    uint64_t r6[6];
+    sc_fold(r7, r6);
+    uint64_t r5[5];
+    sc_fold(r6, r5);
+    return sc_normalize(U256{{r5[0], r5[1], r5[2], r5[3]}}, r5[4]);
+}
+
+inline U256 sc_mul(const U256& a, const U256& b) noexcept {
+    uint64_t r[8];
+    mul_wide(a, b, r);
+    return sc_reduce_wide(r);
+}
+
+inline U256 sc_sqr(const U256& a) noexcept {
+    uint64_t r[8];
+    sqr_wide(a, r);
+    return sc_reduce_wide(r);
+}
+
+// a^(n-2) with fixed 4-bit windows over the (public) exponent
+U256 sc_inv(const U256& a) noexcept {
+    U256 powers[16];
+    powers[0] = {{1, 0, 0, 0}};
+    powers[1] = a;
+    for (int i = 2; i < 16; ++i) powers[i] = sc_mul(powers[i - 1], a);
+
+    U256 e;
+    sub(ORDER, U256{{2, 0, 0, 0}}, e);
+    U256 r = powers[e.v[3] >> 60];
+    for (int w = 62; w >= 0; --w) {
+        r = sc_sqr(sc_sqr(sc_sqr(sc_sqr(r))));
+        const uint64_t digit = (e.v[w / 16] >> (4 * (w % 16))) & 0xF;
+        if (digit != 0) r = sc_mul(r, powers[digit]);
+    }
+    return r;
+}
+
+inline bool is_zero(const U256& a) noexcept {
+    return (a.v[0] | a.v[1] | a.v[2] | a.v[3]) == 0;
+}
+
+// ============================================================================
+// Points: projective (X : Y : Z), y^2 = x^3 + 7
+// ============================================================================
+
+struct Point {
+    U256 x, y, z;
+};
+
+constexpr U256 B3 = {{21, 0, 0, 0}};   // 3 * b
+
+// Complete addition for a = 0 (Renes, Costello, Batina 2016, algorithm 7):
+// valid for every input pair, identity and doubling included
+Point point_add(const Point& p, const Point& q) noexcept {
+    U256 t0 = fe_mul(p.x, q.x);
+    U256 t1 = fe_mul(p.y, q.y);
+    U256 t2 = fe_mul(p.z, q.z);
+    U256 t3 = fe_mul(fe_add(p.x, p.y), fe_add(q.x, q.y));
+    U256 t4 = fe_add(t0, t1);
+    t3 = fe_sub(t3, t4);
+    t4 = fe_mul(fe_add(p.y, p.z), fe_add(q.y, q.z));
+    U256 x3 = fe_add(t1, t2);
+    t4 = fe_sub(t4, x3);
+    x3 = fe_mul(fe_add(p.x, p.z), fe_add(q.x, q.z));
+    U256 y3 = fe_add(t0, t2);
+    y3 = fe_sub(x3, y3);
+    x3 = fe_add(t0, t0);
+    t0 = fe_add(x3, t0);
+    t2 = fe_mul(B3, t2);
+    U256 z3 = fe_add(t1, t2);
+    t1 = fe_sub(t1, t2);
+    y3 = fe_mul(B3, y3);
+    x3 = fe_mul(t4, y3);
+    t2 = fe_mul(t3, t1);
+    x3 = fe_sub(t2, x3);
+    y3 = fe_mul(y3, t0);
+    t1 = fe_mul(t1, z3);
+    y3 = fe_add(t1, y3);
+    t0 = fe_mul(t0, t3);
+    z3 = fe_mul(z3, t4);
+    z3 = fe_add(z3, t0);
+    return {x3, y3, z3};
+}
+
+constexpr Point IDENTITY = {{{0, 0, 0, 0}}, {{1, 0, 0, 0}}, {{0, 0, 0, 0}}};
+
+constexpr Point GENERATOR = {
+    {{0x59F2815B16F81798ULL, 0x029BFCDB2DCE28D9ULL, 0x55A06295CE870B07ULL, 0x79BE667EF9DCBBACULL}},
+    {{0x9C47D08FFB10D4B8ULL, 0xFD17B448A6855419ULL, 0x5DA4FBFC0E1108A8ULL, 0x483ADA7726A3C465ULL}},
+    {{1, 0, 0, 0}}};
+
+void to_affine(const Point& p, U256& x, U256& y) noexcept {
+    const U256 z_inv = fe_inv(p.z);
+    x = fe_mul(p.x, z_inv);
+    y = fe_mul(p.y, z_inv);
+}
+
+// k * G from the window table (entries are 8 limbs: x then y)
+Point multiply_generator(const uint64_t* table, const U256& k) noexcept {
+    Point r = IDENTITY;
+    for (size_t w = 0; w < Context::WINDOWS; ++w) {
+        const uint64_t digit = (k.v[w / 16] >> (4 * (w % 16))) & 0xF;
+        const uint64_t* window = table + w * Context::ENTRIES * 8;
+
+        // Read every entry, keep the selected one
+        Point t = {{{0, 0, 0, 0}}, {{0, 0, 0, 0}}, {{0, 0, 0, 0}}};
+        for (uint64_t j = 0; j < Context::ENTRIES; ++j) {
+            const uint64_t m = mask_if(((j ^ digit) - 1) >> 63);
+            for (int i = 0; i < 4; ++i) {
+                t.x.v[i] |= window[j * 8 + i] & m;
+                t.y.v[i] |= window[j * 8 + 4 + i] & m;
+            }
+        }
+        t.z.v[0] = ((0 - digit) >> 63);   // Entry 0 is the identity (0 : 1 : 0)
+        r = point_add(r, t);
+    }
+    return r;
+}
+
+// ============================================================================
+// RFC 6979 nonces (HMAC-SHA256)
+// ============================================================================
+
+class Sha256 {
+public:
+    Sha256() noexcept { std::memcpy(h_, INIT, sizeof(h_)); }
+
+    void update(const uint8_t* data, size_t len) noexcept {
+        total_ += len;
+        while (len > 0) {
+            const size_t take = len < 64 - used_ ? len : 64 - used_;
+            std::memcpy(block_ + used_, data, take);
+            used_ += take;
+            data += take;
+            len -= take;
+            if (used_ == 64) {
+                compress();
+                used_ = 0;
+            }
+        }
+    }
+
+    void finish(uint8_t (&out)[32]) noexcept {
+        const uint64_t bits = total_ * 8;
+        const uint8_t one = 0x80;
+        update(&one, 1);
+        const uint8_t zero = 0;
+        while (used_ != 56) update(&zero, 1);
+        uint8_t length[8];
+        for (int i = 0; i < 8; ++i) length[i] = static_cast<uint8_t>(bits >> (56 - 8 * i));
+        update(length, 8);
+        for (int i = 0; i < 8; ++i) {
+            for (int b = 0; b < 4; ++b) out[4 * i + b] = static_cast<uint8_t>(h_[i] >> (24 - 8 * b));
+        }
+    }
+
+private:
+    static constexpr uint32_t INIT[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                                         0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+    static constexpr uint32_t K[64] = {
+        0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+        0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+        0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+        0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+        0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+        0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+        0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+        0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+
+    static uint32_t rotr(uint32_t x, int n) noexcept { return (x >> n) | (x << (32 - n)); }
+
+    void compress() noexcept {
+        uint32_t w[64];
+        for (int i = 0; i < 16; ++i) {
+            w[i] = (static_cast<uint32_t>(block_[4 * i]) << 24) | (static_cast<uint32_t>(block_[4 * i + 1]) << 16) |
+                   (static_cast<uint32_t>(block_[4 * i + 2]) << 8) | block_[4 * i + 3];
+        }
+        for (int i = 16; i < 64; ++i) {
+            const uint32_t s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+            const uint32_t s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+            w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+        }
+        uint32_t a = h_[0], b = h_[1], c = h_[2], d = h_[3], e = h_[4], f = h_[5], g = h_[6], h = h_[7];
+        for (int i = 0; i < 64; ++i) {
+            const uint32_t t1 = h + (rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25)) + ((e & f) ^ (~e & g)) + K[i] + w[i];
+            const uint32_t t2 = (rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+            h = g;
+            g = f;
+            f = e;
+            e = d + t1;
+            d = c;
+            c = b;
+            b = a;
+            a = t1 + t2;
+        }
+        h_[0] += a; h_[1] += b; h_[2] += c; h_[3] += d;
+        h_[4] += e; h_[5] += f; h_[6] += g; h_[7] += h;
+    }
+
+    uint32_t h_[8];
+    uint8_t block_[64];
+    size_t used_ = 0;
+    uint64_t total_ = 0;
+};
+
+struct Bytes {
+    const uint8_t* data;
+    size_t len;
+};
+
+// HMAC-SHA256 with a 32-byte key over the concatenation of `parts`
+template<size_t N>
+void hmac(const uint8_t (&key)[32], const Bytes (&parts)[N], uint8_t (&out)[32]) noexcept {
+    uint8_t pad[64];
+    Sha256 inner;
+    for (int i = 0; i < 64; ++i) pad[i] = static_cast<uint8_t>((i < 32 ? key[i] : 0) ^ 0x36);
+    inner.update(pad, 64);
+    for (const Bytes& part : parts) inner.update(part.data, part.len);
+    uint8_t inner_hash[32];
+    inner.finish(inner_hash);
+
+    Sha256 outer;
+    for (int i = 0; i < 64; ++i) pad[i] = static_cast<uint8_t>((i < 32 ? key[i] : 0) ^ 0x5c);
+    outer.update(pad, 64);
+    outer.update(inner_hash, 32);
+    outer.finish(out);
+}
+
+/**
+ * Deterministic nonce stream of RFC 6979 section 3.2 (qlen = hlen = 256)
+ */
+class NonceGenerator {
+public:
+    NonceGenerator(const uint8_t (&key)[32], const uint8_t (&message)[32]) noexcept {
+        std::memset(v_, 0x01, 32);
+        std::memset(k_, 0x00, 32);
+        for (uint8_t tag = 0; tag < 2; ++tag) {
+            hmac(k_, {Bytes{v_, 32}, Bytes{&tag, 1}, Bytes{key, 32}, Bytes{message, 32}}, k_);
+            hmac(k_, {Bytes{v_, 32}}, v_);
+        }
+    }
+
+    // Next candidate in [1, n)
+    U256 next() noexcept {
+        while (true) {
+            if (!first_) {
+                const uint8_t zero = 0;
+                hmac(k_, {Bytes{v_, 32}, Bytes{&zero, 1}}, k_);
+                hmac(k_, {Bytes{v_, 32}}, v_);
+            }
+            first_ = false;
+            hmac(k_, {Bytes{v_, 32}}, v_);
+            const U256 k = from_be(v_);
+            U256 unused;
+            if (!is_zero(k) && sub(k, ORDER, unused) == 1) return k;
+        }
+    }
+
+private:
+    uint8_t v_[32];
+    uint8_t k_[32];
+    bool first_ = true;
+};
+
+} // namespace
+
+// ============================================================================
+// Context
+// ============================================================================
+
+Context::Context() {
+    Point base = GENERATOR;   // 16^w * G
+    for (size_t w = 0; w < WINDOWS; ++w) {
+        Point multiple = IDENTITY;
+        for (size_t j = 0; j < ENTRIES; ++j) {
+            AffinePoint& entry = table_[w][j];
+            if (j == 0) {
+                std::memset(&entry, 0, sizeof(entry));
+                entry.y[0] = 1;
+            } else {
+                multiple = point_add(multiple, base);
+                U256 x, y;
+                to_affine(multiple, x, y);
+                std::memcpy(entry.x, x.v, sizeof(entry.x));
+                std::memcpy(entry.y, y.v, sizeof(entry.y));
+            }
+        }
+        for (int d = 0; d < 4; ++d) base = point_add(base, base);
+    }
+}
+
+const Context& Context::instance() {
+    static const Context context;
+    return context;
+}
+
+bool Context::valid_private_key(const Scalar& key) noexcept {
+    const U256 k = from_be(key.data());
+    U256 unused;
+    return !is_zero(k) && sub(k, ORDER, unused) == 1;
+}
+
+std::array<uint8_t, 64> Context::public_key(const Scalar& key) const noexcept {
+    const Point p = multiply_generator(table_[0][0].x, from_be(key.data()));
+    U256 x, y;
+    to_affine(p, x, y);
+    std::array<uint8_t, 64> out;
+    to_be(x, out.data());
+    to_be(y, out.data() + 32);
+    return out;
+}
+
+Signature Context::sign(const Scalar& key, const std::array<uint8_t, 32>& hash) const noexcept {
+    const U256 d = from_be(key.data());
+    const U256 z = sc_reduce(from_be(hash.data()));
+
+    uint8_t key_bytes[32], message[32];
+    std::memcpy(key_bytes, key.data(), 32);
+    to_be(z, message);
+    NonceGenerator nonces(key_bytes, message);
+
+    while (true) {
+        const U256 k = nonces.next();
+        U256 x, y;
+        to_affine(multiply_generator(table_[0][0].x, k), x, y);
+
+        // r = x mod n; s = k^-1 (z + r d) mod n
+        const U256 r = sc_reduce(x);
+        U256 s = sc_mul(sc_inv(k), sc_add(z, sc_mul(r, d)));
+        if (is_zero(r) || is_zero(s)) continue;   // Probability ~2^-256
+
+        // Low-s: s > n/2 -> n - s, which flips the parity of R
+        U256 unused;
+        const uint64_t high = sub(HALF_ORDER, s, unused);
+        U256 negated;
+        sub(ORDER, s, negated);
+        s = select(mask_if(high), negated, s);
+
+        Signature sig;
+        to_be(r, sig.r.data());
+        to_be(s, sig.s.data());
+        sig.v = static_cast<uint8_t>((y.v[0] & 1) ^ high);
+        return sig;
+    }
+}
+
+} // namespace matrix::tx::secp256k1
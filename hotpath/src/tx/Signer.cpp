@@ -0,0 +1,41 @@
+#include "tx/Composer.hpp"
+
+#include <cstring>
+#include <stdexcept>
+
+#include "telemetry/Telemetry.hpp"
+
+namespace matrix::tx {
+
+Signer::Signer(const std::array<uint8_t, 32>& private_key)
+    : context_(secp256k1::Context::instance())
+    , private_key_(private_key) {
+    if (!secp256k1::Context::valid_private_key(private_key_)) {
+        throw std::invalid_argument("Signer: private key out of range");
+    }
+    // Address = last 20 bytes of keccak256(X || Y)
+    const auto public_key = context_.public_key(private_key_);
+    const Hash256 hash = keccak256(public_key);
+    std::memcpy(address_.data(), hash.data() + 12, address_.size());
+}
+
+void Signer::sign(RawTransaction& tx) const {
+    apply(sign_hash(encoder_.hash_for_signing(tx)), tx);
+}
+
+secp256k1::Signature Signer::sign_hash(const Hash256& hash) const noexcept {
+    telemetry::StageTimer timer(telemetry::Stage::SIGN);
+    return context_.sign(private_key_, hash);
+}
+
+void Signer::apply(const secp256k1::Signature& signature, RawTransaction& tx) noexcept {
+    tx.v = signature.v;
+    tx.r = signature.r;
+    tx.s = signature.s;
+}
+
+std::array<uint8_t, 20> Signer::address() const {
+    return address_;
+}
+
+} // namespace matrix::tx
@@ -0,0 +1,111 @@
+#include "tx/SpeculativeSigner.hpp"
+
+#include "orderbook/WaitStrategy.hpp"
+
+namespace matrix::tx {
+
+SpeculativeSigner::SpeculativeSigner(const Signer& signer, size_t workers, size_t scratch_bytes)
+    : signer_(signer)
+    , scratch_(std::make_unique_for_overwrite<uint8_t[]>(scratch_bytes))
+    , scratch_bytes_(scratch_bytes) {
+    threads_.reserve(workers);
+    for (size_t i = 0; i < workers; ++i) threads_.emplace_back([this] { worker_loop(); });
+}
+
+SpeculativeSigner::~SpeculativeSigner() {
+    finish();
+    stop_.store(true, std::memory_order_release);
+    round_.fetch_add(1, std::memory_order_acq_rel);
+    round_.notify_all();
+    for (auto& thread : threads_) thread.join();
+}
+
+bool SpeculativeSigner::start(std::span<RawTransaction> candidates) noexcept {
+    finish();
+    const size_t count = candidates.size();
+    if (count > MAX_CANDIDATES) return false;
+
+    // Encode every payload, then hash four at a time
+    ByteWriter scratch(scratch_.get(), scratch_bytes_);
+    std::array<std::span<const uint8_t>, MAX_CANDIDATES> payloads{};
+    for (size_t i = 0; i < count; ++i) {
+        payloads[i] = encoder_.encode_signing_payload(candidates[i], scratch);
+        if (payloads[i].empty()) return false;
+    }
+    for (size_t i = 0; i < count; i += 4) {
+        std::array<Hash256, 4> out;
+        keccak256_x4({payloads[i], payloads[i + 1], payloads[i + 2], payloads[i + 3]}, out);
+        for (size_t j = 0; j < 4 && i + j < count; ++j) hashes_[i + j] = out[j];
+    }
+
+    candidates_ = candidates.data();
+    for (size_t i = 0; i < count; ++i) done_[i].store(0, std::memory_order_relaxed);
+    pending_.store(static_cast<uint32_t>(count), std::memory_order_relaxed);
+
+    // Publish the round: claims are only made against a ticket of this round
+    const uint32_t round = round_.load(std::memory_order_relaxed) + 1;
+    ticket_.store(uint64_t{round} << ROUND_SHIFT | uint64_t{count} << 8, std::memory_order_release);
+    round_.store(round, std::memory_order_release);
+    round_.notify_all();
+    return true;
+}
+
+bool SpeculativeSigner::sign_next(uint32_t round) noexcept {
+    uint64_t ticket = ticket_.load(std::memory_order_acquire);
+    while (true) {
+        const size_t index = ticket & 0xFF;
+        const size_t count = (ticket >> 8) & 0xFF;
+        if ((ticket >> ROUND_SHIFT) != round || index >= count) return false;
+        if (ticket_.compare_exchange_weak(ticket, ticket + 1, std::memory_order_acq_rel, std::memory_order_acquire)) {
+            break;
+        }
+    }
+
+    const size_t index = ticket & 0xFF;
+    Signer::apply(signer_.sign_hash(hashes_[index]), candidates_[index]);
+    done_[index].store(1, std::memory_order_release);
+    done_[index].notify_all();
+    if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) pending_.notify_all();
+    return true;
+}
+
+const RawTransaction& SpeculativeSigner::wait(size_t index) noexcept {
+    const uint32_t round = round_.load(std::memory_order_acquire);
+    while (done_[index].load(std::memory_order_acquire) == 0) {
+        // Sign queued candidates ourselves; once all are claimed, sleep
+        if (!sign_next(round)) done_[index].wait(0, std::memory_order_acquire);
+    }
+    return candidates_[index];
+}
+
+void SpeculativeSigner::finish() noexcept {
+    const uint32_t round = round_.load(std::memory_order_acquire);
+    while (sign_next(round)) {}
+    for (uint32_t left = pending_.load(std::memory_order_acquire); left != 0;
+         left = pending_.load(std::memory_order_acquire)) {
+        pending_.wait(left, std::memory_order_acquire);
+    }
+}
+
+void SpeculativeSigner::worker_loop() noexcept {
+    // Round 0 (construction), not round_.load(): a thread that first runs
+    // after a start() or the destructor must still see that round change
+    uint32_t seen = 0;
+    while (true) {
+        // Spin through short gaps between rounds, then sleep
+        uint32_t round = round_.load(std::memory_order_acquire);
+        for (uint32_t spins = 0; round == seen && spins < orderbook::WaitStrategy::PARK_SPIN_LIMIT; ++spins) {
+            orderbook::cpu_relax();
+            round = round_.load(std::memory_order_acquire);
+        }
+        if (round == seen) {
+            round_.wait(seen, std::memory_order_acquire);
+            continue;
+        }
+        if (stop_.load(std::memory_order_acquire)) return;
+        seen = round;
+        while (sign_next(round)) {}
+    }
+}
+
+} // namespace matrix::tx
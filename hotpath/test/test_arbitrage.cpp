@@ -0,0 +1,760 @@
+/**
+ * Unit tests for the token graph and arbitrage calculator
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <set>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+
+#include "arbitrage/Calculator.hpp"
+#include "arbitrage/TokenGraph.hpp"
+#include "memory/Arena.hpp"
+#include "memory/ArenaResource.hpp"
+#include "orderbook/OrderBook.hpp"
+
+using namespace matrix;
+using namespace matrix::arbitrage;
+using namespace matrix::orderbook;
+
+namespace {
+
+PriceUpdate make_update(uint64_t pool, uint64_t token0, uint64_t token1,
+                        uint64_t reserve0 = 1000, uint64_t reserve1 = 1000,
+                        ChainId chain = ChainId::ETHEREUM) {
+    PriceUpdate update{};
+    update.timestamp_ns = 1;
+    update.pool_hash = pool;
+    update.chain_id = static_cast<uint32_t>(chain);
+    update.dex_id = static_cast<uint32_t>(DexId::UNISWAP_V3);
+    update.token0 = token0;
+    update.token1 = token1;
+    update.reserve0 = reserve0;
+    update.reserve1 = reserve1;
+    return update;
+}
+
+class ArbitrageTest : public ::testing::Test {
+protected:
+    memory::Arena arena_;
+    std::unique_ptr<OrderBook> book_ = std::make_unique<OrderBook>(arena_);
+
+    // (from, to, pool) triples of the graph, as token hashes
+    std::set<std::tuple<uint64_t, uint64_t, uint64_t>> edge_set(const TokenGraph& graph) const {
+        std::set<std::tuple<uint64_t, uint64_t, uint64_t>> edges;
+        for (uint32_t t = 0; t < graph.node_count(); ++t) {
+            for (const Edge& e : graph.edges(t)) {
+                edges.emplace(book_->token_hash(t), book_->token_hash(e.to),
+                              book_->pool(e.pool_id).pool_address_hash);
+            }
+        }
+        return edges;
+    }
+};
+
+} // namespace
+
+// ============================================================================
+// TokenGraph
+// ============================================================================
+
+TEST_F(ArbitrageTest, GraphHasEdgeInEachDirection) {
+    book_->update_pool(make_update(0xA1, 10, 20));
+    book_->update_pool(make_update(0xA2, 30, 20));
+
+    TokenGraph graph;
+    EXPECT_EQ(graph.sync(*book_), 2u);
+    EXPECT_EQ(graph.node_count(), 3u);
+    EXPECT_EQ(graph.edge_count(), 4u);
+
+    const auto from_20 = graph.edges(book_->token_id(20));
+    ASSERT_EQ(from_20.size(), 2u);
+    EXPECT_EQ(book_->token_hash(from_20[0].to), 10u);
+    EXPECT_FALSE(from_20[0].zero_for_one);
+    EXPECT_EQ(book_->token_hash(from_20[1].to), 30u);
+    EXPECT_FALSE(from_20[1].zero_for_one);
+
+    const auto from_30 = graph.edges(book_->token_id(30));
+    ASSERT_EQ(from_30.size(), 1u);
+    EXPECT_TRUE(from_30[0].zero_for_one);
+    EXPECT_TRUE(graph.edges(999).empty());
+}
+
+TEST_F(ArbitrageTest, ReserveUpdatesLeaveTopologyUntouched) {
+    book_->update_pool(make_update(0xA1, 10, 20));
+    TokenGraph graph;
+    graph.sync(*book_);
+    const uint64_t version = graph.version();
+
+    book_->update_pool(make_update(0xA1, 10, 20, 5000, 7000));
+    EXPECT_EQ(graph.sync(*book_), 0u);
+    EXPECT_EQ(graph.version(), version);
+}
+
+TEST_F(ArbitrageTest, IncrementalSyncMatchesFullBuild) {
+    uint64_t x = 0xB5AD4ECEDA1CE2A9ULL;
+    const auto next = [&] { x ^= x << 13; x ^= x >> 7; x ^= x << 17; return x; };
+
+    TokenGraph incremental;
+    for (uint64_t pool = 1; pool <= 2000; ++pool) {
+        const uint64_t t0 = next() % 150;
+        const uint64_t t1 = next() % 150;
+        book_->update_pool(make_update(pool, t0, t1));
+        if (pool % 97 == 0) incremental.sync(*book_);  // Uneven batches
+    }
+    incremental.sync(*book_);
+
+    TokenGraph full;
+    full.sync(*book_);
+
+    EXPECT_EQ(incremental.node_count(), full.node_count());
+    EXPECT_EQ(incremental.edge_count(), full.edge_count());
+    EXPECT_EQ(edge_set(incremental), edge_set(full));
+
+    // Runs stay in pool creation order
+    for (uint32_t t = 0; t < incremental.node_count(); ++t) {
+        const auto edges = incremental.edges(t);
+        EXPECT_TRUE(std::is_sorted(edges.begin(), edges.end(),
+            [](const Edge& a, const Edge& b) { return a.pool_id < b.pool_id; }));
+    }
+}
+
+TEST(CsrListsTest, AppendsKeepBatchOrderAcrossMovesAndCompactions) {
+    uint64_t x = 0x2545F4914F6CDD1DULL;
+    const auto next = [&] { x ^= x << 13; x ^= x >> 7; x ^= x << 17; return x; };
+
+    // A tiny reservation forces row moves and compactions early
+    CsrLists<uint32_t> lists;
+    lists.reserve(4, 16);
+    std::vector<std::vector<uint32_t>> expected;
+    std::vector<CsrLists<uint32_t>::Entry> batch;
+    uint32_t value = 0;
+    for (int round = 0; round < 200; ++round) {
+        const size_t rows = std::min<size_t>(expected.size() + 1 + next() % 2, 64);
+        expected.resize(std::max(rows, expected.size()));
+        batch.clear();
+        for (uint64_t n = next() % 40; n > 0; --n) {
+            const auto row = static_cast<uint32_t>(next() % expected.size());
+            batch.push_back({row, value});
+            expected[row].push_back(value++);
+        }
+        lists.merge(batch, rows);
+
+        ASSERT_EQ(lists.row_count(), expected.size());
+        ASSERT_EQ(lists.value_count(), value);
+        for (uint32_t r = 0; r < expected.size(); ++r) {
+            const auto run = lists.row(r);
+            ASSERT_TRUE(std::equal(run.begin(), run.end(), expected[r].begin(), expected[r].end()));
+        }
+    }
+    EXPECT_TRUE(lists.row(static_cast<uint32_t>(expected.size())).empty());
+}
+
+TEST_F(ArbitrageTest, DegeneratePoolAddsNoEdges) {
+    book_->update_pool(make_update(0xA1, 10, 10));
+    TokenGraph graph;
+    EXPECT_EQ(graph.sync(*book_), 1u);
+    EXPECT_EQ(graph.edge_count(), 0u);
+}
+
+// ============================================================================
+// OpportunityBuffer
+// ============================================================================
+
+TEST(OpportunityBufferTest, KeepsTheMostProfitableSorted) {
+    OpportunityBuffer buffer(8);
+    std::vector<uint64_t> profits;
+    uint64_t x = 0x9E3779B97F4A7C15ULL;
+    for (uint64_t i = 0; i < 500; ++i) {
+        x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+        Opportunity opp{};
+        opp.id = i;
+        opp.profit_wei = x % 100'000;
+        profits.push_back(opp.profit_wei);
+        buffer.offer(opp);
+    }
+    buffer.finish();
+
+    std::sort(profits.begin(), profits.end(), std::greater<>());
+    ASSERT_EQ(buffer.size(), 8u);
+    for (size_t i = 0; i < buffer.size(); ++i) EXPECT_EQ(buffer[i].profit_wei, profits[i]) << i;
+    EXPECT_EQ(buffer.discarded(), 492u);
+
+    // Reused: clear() keeps the storage
+    const Opportunity* storage = buffer.view().data();
+    buffer.clear();
+    Opportunity one{};
+    one.profit_wei = 1;
+    EXPECT_TRUE(buffer.offer(one));
+    buffer.finish();
+    EXPECT_EQ(buffer.size(), 1u);
+    EXPECT_EQ(buffer.view().data(), storage);
+}
+
+TEST_F(ArbitrageTest, ScanIntoArenaBackedBufferMatchesVectorScan) {
+    constexpr uint64_t R = 1'000'000;
+    // Four profitable triangles through WETH with different edges
+    for (uint64_t k = 0; k < 4; ++k) {
+        const uint64_t a = 0x100 + 2 * k, b = 0x101 + 2 * k;
+        book_->update_pool(make_update(0xA0 + k, WETH_MAINNET, a, R, 2 * R + k * R / 4));
+        book_->update_pool(make_update(0xB0 + k, a, b, R, R));
+        book_->update_pool(make_update(0xC0 + k, b, WETH_MAINNET, R, R));
+    }
+
+    Calculator calculator(*book_);
+    const auto all = calculator.scan(ChainId::ETHEREUM);
+    ASSERT_EQ(all.size(), 4u);
+
+    memory::Arena scratch(1 << 20);
+    memory::ArenaResource resource(scratch);
+    OpportunityBuffer top(2, &resource);
+    const size_t used = scratch.used();
+    for (int round = 0; round < 3; ++round) {
+        calculator.scan(top, ChainId::ETHEREUM);
+        ASSERT_EQ(top.size(), 2u);
+        EXPECT_EQ(top[0].path[0].pool_hash, all[0].path[0].pool_hash);
+        EXPECT_EQ(top[1].path[0].pool_hash, all[1].path[0].pool_hash);
+        EXPECT_GE(top[0].profit_wei, top[1].profit_wei);
+    }
+    EXPECT_EQ(scratch.used(), used);   // No allocation after the reserve
+}
+
+// ============================================================================
+// Calculator
+// ============================================================================
+
+TEST_F(ArbitrageTest, ScanTriangularFindsProfitableCycleThroughBase) {
+    constexpr uint64_t kUsdc = 0x100;
+    constexpr uint64_t kDai = 0x200;
+    // USDC is cheap in 0xA1: WETH -> USDC -> DAI -> WETH gains, the reverse loses
+    book_->update_pool(make_update(0xA1, WETH_MAINNET, kUsdc, 1'000'000, 2'000'000));
+    book_->update_pool(make_update(0xA2, kUsdc, kDai, 1'000'000, 1'000'000));
+    book_->update_pool(make_update(0xA3, kDai, WETH_MAINNET, 1'000'000, 1'000'000));
+    // Same tokens on another chain must not leak in
+    book_->update_pool(make_update(0xB1, kUsdc, 0x300, 1000, 1000, ChainId::ARBITRUM));
+
+    Calculator calculator(*book_);
+    const auto opps = calculator.scan_triangular(ChainId::ETHEREUM, WETH_MAINNET);
+
+    ASSERT_EQ(opps.size(), 1u);
+    const auto& opp = opps[0];
+    EXPECT_EQ(opp.path_length, 3u);
+    EXPECT_EQ(opp.path[0].pool_hash, 0xA1u);
+    EXPECT_EQ(opp.path[1].pool_hash, 0xA2u);
+    EXPECT_EQ(opp.path[2].pool_hash, 0xA3u);
+    EXPECT_EQ(opp.path[0].token_in, WETH_MAINNET);
+    EXPECT_EQ(opp.path[0].token_out, kUsdc);
+    EXPECT_EQ(opp.path[1].token_out, kDai);
+    EXPECT_EQ(opp.path[2].token_out, WETH_MAINNET);
+
+    // Hop amounts chain and the profit is what the last hop returns
+    EXPECT_EQ(opp.path[0].amount_in, opp.flash_loan_amount);
+    EXPECT_EQ(opp.path[1].amount_in, opp.path[0].amount_out);
+    EXPECT_EQ(opp.path[2].amount_in, opp.path[1].amount_out);
+    EXPECT_GT(opp.profit_wei, 0u);
+    EXPECT_EQ(opp.profit_wei, opp.path[2].amount_out - opp.flash_loan_amount);
+
+    // New pools are picked up without an explicit rebuild
+    book_->update_pool(make_update(0xA4, kUsdc, kDai, 1'000'000, 1'000'000));
+    EXPECT_EQ(calculator.scan_triangular(ChainId::ETHEREUM, WETH_MAINNET).size(), 2u);
+    EXPECT_EQ(calculator.graph().pools_seen(), 5u);
+}
+
+TEST(OpportunityTest, NetProfitSaturatesInsteadOfWrapping) {
+    Opportunity opp{};
+    opp.gas_estimate = 500000;
+    opp.profit_wei = UINT64_MAX;
+    EXPECT_EQ(opp.net_profit(50), INT64_MAX);
+    EXPECT_TRUE(opp.is_profitable(50, UINT64_MAX / 4));
+
+    // Costs past 2^64 wei are a loss, not a wrapped-around profit
+    opp.profit_wei = 1'000'000;
+    EXPECT_EQ(opp.net_profit(UINT64_MAX / 1000), INT64_MIN);
+    EXPECT_FALSE(opp.is_profitable(UINT64_MAX / 1000));
+
+    // A minimum above INT64_MAX is never met by a positive int64 net
+    opp.profit_wei = uint64_t{1} << 63;
+    EXPECT_FALSE(opp.is_profitable(0, UINT64_MAX));
+    EXPECT_EQ(saturating_difference(0, uint64_t{1} << 63), INT64_MIN);
+    EXPECT_EQ(saturating_difference(5, 7), -2);
+}
+
+TEST(OpportunityTest, FlashLoanPremiumIsExactForAnyAmount) {
+    for (const uint64_t amount : {uint64_t{0}, uint64_t{1999}, uint64_t{2000}, uint64_t{1'000'000'007},
+                                  UINT64_MAX / 5, UINT64_MAX / 5 + 1, UINT64_MAX}) {
+        EXPECT_EQ(flash_loan_premium(amount),
+                  static_cast<uint64_t>(static_cast<unsigned __int128>(amount) * 5 / 10000));
+    }
+}
+
+TEST_F(ArbitrageTest, SimulatePathChainsPoolQuotes) {
+    book_->update_pool(make_update(0xA1, 10, 20, 1'000'000, 3'000'000));
+    book_->update_pool(make_update(0xA2, 30, 20, 5'000'000, 2'000'000));  // Reversed orientation
+
+    Calculator calculator(*book_);
+    std::array<Opportunity::Hop, 4> path{};
+    path[0] = {0xA1, 10, 20, 0, 0};
+    path[1] = {0xA2, 20, 30, 0, 0};
+
+    const uint64_t mid = book_->find_pool(0xA1)->get_amount_out(10'000, true);
+    const uint64_t out = book_->find_pool(0xA2)->get_amount_out(mid, false);
+    EXPECT_EQ(calculator.simulate_path(path, 2, 10'000), out);
+
+    path[1].pool_hash = 0xDEAD;  // Unknown pool
+    EXPECT_EQ(calculator.simulate_path(path, 2, 10'000), 0u);
+}
+
+TEST_F(ArbitrageTest, OptimizeAmountMatchesExhaustiveSearch) {
+    // Two pools on the same pair at different prices: sell token 10 where it
+    // fetches the most token 20, buy it back where it is cheapest
+    book_->update_pool(make_update(0xA1, 10, 20, 200'000, 400'000));
+    book_->update_pool(make_update(0xA2, 10, 20, 300'000, 500'000));
+    auto curve = make_update(0xC1, 10, 20, 200'000, 400'000);
+    curve.dex_id = static_cast<uint32_t>(DexId::CURVE);
+    book_->update_pool(curve);
+    auto curve2 = make_update(0xC2, 10, 20, 300'000, 500'000);
+    curve2.dex_id = static_cast<uint32_t>(DexId::CURVE);
+    book_->update_pool(curve2);
+
+    Calculator calculator(*book_);
+    const auto check = [&](uint64_t buy, uint64_t sell, uint64_t max_input) {
+        std::array<Opportunity::Hop, 4> path{};
+        path[0] = {sell, 10, 20, 0, 0};
+        path[1] = {buy, 20, 10, 0, 0};
+
+        int64_t best = 0;
+        for (uint64_t x = 1; x <= max_input; ++x) {
+            const auto out = static_cast<int64_t>(calculator.simulate_path(path, 2, x));
+            best = std::max(best, out - static_cast<int64_t>(x));
+        }
+
+        const uint64_t amount = calculator.optimize_amount(path, 2, max_input);
+        ASSERT_GT(amount, 0u);
+        ASSERT_LE(amount, max_input);
+        const auto profit = static_cast<int64_t>(calculator.simulate_path(path, 2, amount)) -
+                            static_cast<int64_t>(amount);
+        // Closed form lands on (or within rounding of) the exact optimum
+        EXPECT_GE(profit, best - 1) << "max_input=" << max_input;
+    };
+
+    check(0xA2, 0xA1, 60'000);   // Closed form, optimum inside the range
+    check(0xA2, 0xA1, 2'000);    // Closed form, clamped to max_input
+    check(0xC2, 0xC1, 60'000);   // Ternary fallback
+
+    // Unprofitable direction sizes to zero
+    std::array<Opportunity::Hop, 4> reverse{};
+    reverse[0] = {0xA2, 10, 20, 0, 0};
+    reverse[1] = {0xA1, 20, 10, 0, 0};
+    EXPECT_EQ(calculator.optimize_amount(reverse, 2, 60'000), 0u);
+}
+
+// ============================================================================
+// CycleIndex / incremental scan
+// ============================================================================
+
+namespace {
+
+// Reference: all directed simple cycles of `length` hops through base
+size_t brute_force_cycles(const OrderBook& book, uint32_t base, size_t length) {
+    struct Hop { uint32_t from, to; };
+    std::vector<Hop> hops;
+    for (uint32_t id = 0; id < book.pool_count(); ++id) {
+        const auto t = book.pool_token_ids(id);
+        if (t.token0 == t.token1) continue;
+        hops.push_back({t.token0, t.token1});
+        hops.push_back({t.token1, t.token0});
+    }
+
+    size_t count = 0;
+    std::vector<uint32_t> path{base};
+    const auto walk = [&](auto& self, uint32_t at) -> void {
+        for (const Hop& h : hops) {
+            if (h.from != at) continue;
+            if (path.size() == length) {
+                count += h.to == base;
+            } else if (std::find(path.begin(), path.end(), h.to) == path.end()) {
+                path.push_back(h.to);
+                self(self, h.to);
+                path.pop_back();
+            }
+        }
+    };
+    walk(walk, base);
+    return count;
+}
+
+} // namespace
+
+TEST_F(ArbitrageTest, CycleIndexMatchesBruteForceEnumeration) {
+    uint64_t x = 0x9E3779B97F4A7C15ULL;
+    const auto next = [&] { x ^= x << 13; x ^= x >> 7; x ^= x << 17; return x; };
+
+    TokenGraph graph;
+    CycleIndex index;
+    const BaseToken bases[] = {{WETH_MAINNET, ChainId::ETHEREUM}};
+
+    const uint64_t tokens[] = {WETH_MAINNET, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16};
+    for (uint64_t pool = 1; pool <= 60; ++pool) {
+        const uint64_t t0 = tokens[next() % 7];
+        const uint64_t t1 = tokens[next() % 7];
+        book_->update_pool(make_update(pool, t0, t1));
+        if (pool % 7 == 0) {
+            graph.sync(*book_);
+            index.sync(*book_, graph, bases);
+        }
+    }
+    graph.sync(*book_);
+    index.sync(*book_, graph, bases);
+
+    const uint32_t base = book_->token_id(WETH_MAINNET);
+    const size_t expected = brute_force_cycles(*book_, base, 3) + brute_force_cycles(*book_, base, 4);
+    ASSERT_GT(expected, 0u);
+    EXPECT_EQ(index.cycle_count(), expected);
+    EXPECT_EQ(index.dropped_cycles(), 0u);
+
+    // Membership lists exactly the cycles each pool appears in
+    for (uint32_t c = 0; c < index.cycle_count(); ++c) {
+        const Cycle& cycle = index.cycle(c);
+        EXPECT_EQ(cycle.tokens[0], base);
+        EXPECT_EQ(cycle.tokens[cycle.length], base);
+        for (uint8_t h = 0; h < cycle.length; ++h) {
+            const auto list = index.cycles_of(cycle.pool_ids[h]);
+            EXPECT_NE(std::find(list.begin(), list.end(), c), list.end());
+        }
+    }
+}
+
+TEST_F(ArbitrageTest, CycleIndexSkipsOtherChains) {
+    book_->update_pool(make_update(0xA1, WETH_MAINNET, 0x100));
+    book_->update_pool(make_update(0xA2, 0x100, 0x200));
+    book_->update_pool(make_update(0xA3, 0x200, WETH_MAINNET, 1000, 1000, ChainId::ARBITRUM));
+
+    Calculator calculator(*book_);
+    const auto opps = calculator.scan_incremental(book_->dirty_pools());
+    EXPECT_TRUE(opps.empty());
+    EXPECT_EQ(calculator.cycles().cycle_count(), 0u);
+}
+
+TEST_F(ArbitrageTest, ScanIncrementalOnlyEvaluatesDirtyCycles) {
+    constexpr uint64_t kUsdc = 0x100;
+    constexpr uint64_t kDai = 0x200;
+    constexpr uint64_t kUsdt = 0x300;
+    constexpr uint64_t kFrax = 0x400;
+    constexpr uint64_t R = 1'000'000;
+    // Two profitable triangles sharing only WETH
+    book_->update_pool(make_update(0xA1, WETH_MAINNET, kUsdc, R, 2 * R));
+    book_->update_pool(make_update(0xA2, kUsdc, kDai, R, R));
+    book_->update_pool(make_update(0xA3, kDai, WETH_MAINNET, R, R));
+    book_->update_pool(make_update(0xB1, WETH_MAINNET, kUsdt, R, 2 * R));
+    book_->update_pool(make_update(0xB2, kUsdt, kFrax, R, R));
+    book_->update_pool(make_update(0xB3, kFrax, WETH_MAINNET, R, R));
+
+    Calculator calculator(*book_);
+    EXPECT_EQ(calculator.scan_incremental(book_->dirty_pools()).size(), 2u);
+    book_->clear_dirty();
+    EXPECT_EQ(calculator.cycles().cycle_count(), 4u);  // Both directions indexed
+
+    // Reserve update on one pool re-evaluates only its triangle
+    book_->update_pool(make_update(0xA2, kUsdc, kDai, R, R + R / 10));
+    const auto opps = calculator.scan_incremental(book_->dirty_pools());
+    book_->clear_dirty();
+    ASSERT_EQ(opps.size(), 1u);
+    EXPECT_EQ(opps[0].path[0].pool_hash, 0xA1u);
+    EXPECT_EQ(opps[0].path[1].pool_hash, 0xA2u);
+
+    // Offsetting the DAI move in 0xA1 removes the opportunity
+    book_->update_pool(make_update(0xA1, WETH_MAINNET, kUsdc, R + R / 10, R));
+    EXPECT_TRUE(calculator.scan_incremental(book_->dirty_pools()).empty());
+    book_->clear_dirty();
+
+    // A pool bridging both triangles closes one new triangle and two
+    // 4-hop cycles, each in both directions
+    book_->update_pool(make_update(0xC1, kUsdc, kUsdt, R, R));
+    (void)calculator.scan_incremental(book_->dirty_pools());
+    EXPECT_EQ(calculator.cycles().cycle_count(), 10u);
+
+    // Nothing dirty, nothing evaluated
+    book_->clear_dirty();
+    EXPECT_TRUE(calculator.scan_incremental(book_->dirty_pools()).empty());
+}
+
+TEST_F(ArbitrageTest, ScanFindsFourHopCyclesFromEveryBaseToken) {
+    constexpr uint64_t R = 1'000'000;
+    // WETH -> 0x100 -> 0x101 -> 0x102 -> WETH: no triangle, one 4-hop gain
+    book_->update_pool(make_update(0xA1, WETH_MAINNET, 0x100, R, 2 * R));
+    book_->update_pool(make_update(0xA2, 0x100, 0x101, R, R));
+    book_->update_pool(make_update(0xA3, 0x101, 0x102, R, R));
+    book_->update_pool(make_update(0xA4, 0x102, WETH_MAINNET, R, R));
+    // A triangle that never touches WETH, only USDC (priced through 0xB0)
+    book_->update_pool(make_update(0xB0, WETH_MAINNET, USDC_MAINNET, R, 2 * R));
+    book_->update_pool(make_update(0xB1, USDC_MAINNET, 0x200, R, 2 * R));
+    book_->update_pool(make_update(0xB2, 0x200, 0x201, R, R));
+    book_->update_pool(make_update(0xB3, 0x201, USDC_MAINNET, R, R));
+    // Optimism and BSC triangles through their own base tokens
+    book_->update_pool(make_update(0xC1, WETH_OPTIMISM, 0x300, R, 2 * R, ChainId::OPTIMISM));
+    book_->update_pool(make_update(0xC2, 0x300, 0x301, R, R, ChainId::OPTIMISM));
+    book_->update_pool(make_update(0xC3, 0x301, WETH_OPTIMISM, R, R, ChainId::OPTIMISM));
+    book_->update_pool(make_update(0xD1, WBNB_BSC, 0x400, R, 2 * R, ChainId::BSC));
+    book_->update_pool(make_update(0xD2, 0x400, 0x401, R, R, ChainId::BSC));
+    book_->update_pool(make_update(0xD3, 0x401, WBNB_BSC, R, R, ChainId::BSC));
+
+    Calculator calculator(*book_);
+    EXPECT_TRUE(calculator.scan_triangular(ChainId::ETHEREUM, WETH_MAINNET).empty());
+
+    const auto mainnet = calculator.scan(ChainId::ETHEREUM);
+    ASSERT_EQ(mainnet.size(), 2u);
+    std::map<uint64_t, Opportunity> by_base;
+    for (const auto& opp : mainnet) by_base[opp.flash_loan_token] = opp;
+    ASSERT_TRUE(by_base.count(WETH_MAINNET));
+    ASSERT_TRUE(by_base.count(USDC_MAINNET));
+    EXPECT_EQ(by_base[WETH_MAINNET].path_length, 4u);
+    EXPECT_EQ(by_base[WETH_MAINNET].path[3].pool_hash, 0xA4u);
+    EXPECT_EQ(by_base[WETH_MAINNET].path[3].token_out, WETH_MAINNET);
+    EXPECT_EQ(by_base[USDC_MAINNET].path_length, 3u);
+
+    const auto optimism = calculator.scan(ChainId::OPTIMISM);
+    ASSERT_EQ(optimism.size(), 1u);
+    EXPECT_EQ(optimism[0].flash_loan_token, WETH_OPTIMISM);
+    EXPECT_EQ(calculator.scan(ChainId::BSC).size(), 1u);
+    EXPECT_EQ(calculator.scan().size(), 4u);
+
+    // The incremental path indexes the same bases
+    EXPECT_EQ(calculator.scan_incremental(book_->dirty_pools()).size(), 4u);
+}
+
+TEST_F(ArbitrageTest, ScanUsesOnlyTheConfiguredBaseTokens) {
+    constexpr uint64_t R = 1'000'000;
+    book_->update_pool(make_update(0xA1, WETH_MAINNET, USDC_MAINNET, R, 2 * R));
+    book_->update_pool(make_update(0xA2, USDC_MAINNET, 0x100, R, R));
+    book_->update_pool(make_update(0xA3, 0x100, WETH_MAINNET, R, R));
+
+    CalculatorConfig config;
+    config.bases = {{USDC_MAINNET, ChainId::ETHEREUM}};
+    Calculator calculator(*book_, config);
+    const auto opps = calculator.scan();
+    ASSERT_EQ(opps.size(), 1u);
+    EXPECT_EQ(opps[0].flash_loan_token, USDC_MAINNET);
+    EXPECT_EQ(opps[0].path[0].token_in, USDC_MAINNET);
+
+    config.scan_threads = 0;
+    EXPECT_THROW(Calculator(*book_, config), std::invalid_argument);
+}
+
+TEST_F(ArbitrageTest, StablecoinProfitsArePricedInNativeWei) {
+    // 10 WETH : 20k USDC (6 decimals), so 1 USDC unit = 5e8 wei
+    constexpr uint64_t WEI_PER_USDC_UNIT = 500'000'000;
+    book_->update_pool(make_update(0xE0, USDC_MAINNET, WETH_MAINNET, 20'000'000'000, 10'000'000'000'000'000'000ULL));
+    // A 2x USDC triangle, and a 2% WETH triangle whose profit is more raw
+    // units but fewer wei
+    constexpr uint64_t U = 10'000'000'000;
+    book_->update_pool(make_update(0xA1, USDC_MAINNET, 0x100, U, 2 * U));
+    book_->update_pool(make_update(0xA2, 0x100, 0x200, U, U));
+    book_->update_pool(make_update(0xA3, 0x200, USDC_MAINNET, U, U));
+    constexpr uint64_t W = 1'000'000'000'000'000'000;
+    book_->update_pool(make_update(0xB1, WETH_MAINNET, 0x300, W, W + W / 50));
+    book_->update_pool(make_update(0xB2, 0x300, 0x301, W, W));
+    book_->update_pool(make_update(0xB3, 0x301, WETH_MAINNET, W, W));
+
+    Calculator calculator(*book_);
+    const auto opps = calculator.scan(ChainId::ETHEREUM);
+    ASSERT_EQ(opps.size(), 2u);
+
+    // Ranked by wei: the USDC cycle's raw profit is the smaller number
+    const Opportunity& usdc = opps[0];
+    const Opportunity& weth = opps[1];
+    ASSERT_EQ(usdc.flash_loan_token, USDC_MAINNET);
+    ASSERT_EQ(weth.flash_loan_token, WETH_MAINNET);
+    const uint64_t raw_profit = usdc.path[2].amount_out - usdc.flash_loan_amount;
+    EXPECT_LT(raw_profit, weth.profit_wei);
+    EXPECT_EQ(usdc.profit_wei, raw_profit * WEI_PER_USDC_UNIT);
+    EXPECT_EQ(usdc.flash_loan_fee, flash_loan_premium(usdc.flash_loan_amount) * WEI_PER_USDC_UNIT);
+    EXPECT_EQ(weth.profit_wei, weth.path[2].amount_out - weth.flash_loan_amount);
+    EXPECT_TRUE(usdc.is_profitable(50, Calculator::MIN_PROFIT_WEI));
+
+    // No USDC/WETH pool, no price: the USDC cycle is not offered at all
+    memory::Arena arena;
+    OrderBook unpriced(arena);
+    for (const uint64_t pool : {0xA1, 0xA2, 0xA3}) {
+        const PoolState state = *book_->find_pool(pool);
+        unpriced.update_pool(make_update(pool, state.token0_hash, state.token1_hash, state.reserve0, state.reserve1));
+    }
+    EXPECT_TRUE(Calculator(unpriced).scan(ChainId::ETHEREUM).empty());
+}
+
+TEST_F(ArbitrageTest, NativePricingStaysOnTheCyclesChain) {
+    // One token hash on both OP Stack chains, like their shared WETH: the
+    // Optimism pool would sell it for 5x what Base's does
+    constexpr uint64_t kShared = 0x777;
+    book_->update_pool(make_update(0xE0, kShared, WETH_BASE, 1'000'000'000, 2'000'000'000, ChainId::BASE));
+    book_->update_pool(make_update(0xE1, kShared, WETH_OPTIMISM, 1'000'000'000, 10'000'000'000, ChainId::OPTIMISM));
+    constexpr uint64_t R = 1'000'000;
+    book_->update_pool(make_update(0xA1, kShared, 0x100, R, 2 * R, ChainId::BASE));
+    book_->update_pool(make_update(0xA2, 0x100, 0x200, R, R, ChainId::BASE));
+    book_->update_pool(make_update(0xA3, 0x200, kShared, R, R, ChainId::BASE));
+
+    CalculatorConfig config;
+    config.bases = {{kShared, ChainId::BASE}, {kShared, ChainId::OPTIMISM}};
+    Calculator calculator(*book_, config);
+    EXPECT_TRUE(calculator.scan(ChainId::OPTIMISM).empty());
+    const auto opps = calculator.scan(ChainId::BASE);
+    ASSERT_EQ(opps.size(), 1u);
+    EXPECT_EQ(opps[0].profit_wei, 2 * (opps[0].path[2].amount_out - opps[0].flash_loan_amount));
+    EXPECT_EQ(opps[0].flash_loan_fee, 2 * flash_loan_premium(opps[0].flash_loan_amount));
+}
+
+TEST_F(ArbitrageTest, ParallelScanMatchesSingleThreadedScan) {
+    // A dense little market: every token pair among WETH, USDC and eight
+    // others, with prices skewed per pool
+    constexpr uint64_t R = 1'000'000;
+    const uint64_t tokens[] = {WETH_MAINNET, USDC_MAINNET, 0x100, 0x101, 0x102, 0x103, 0x104, 0x105, 0x106, 0x107};
+    uint64_t pool = 0x1000;
+    for (size_t i = 0; i < std::size(tokens); ++i) {
+        for (size_t j = i + 1; j < std::size(tokens); ++j) {
+            const uint64_t skew = (i * 7 + j * 13) % 11;
+            book_->update_pool(make_update(pool++, tokens[i], tokens[j], R, R + skew * R / 20));
+        }
+    }
+
+    const auto signature = [](const std::vector<Opportunity>& opps) {
+        std::multiset<std::tuple<uint64_t, uint64_t, uint64_t, uint8_t>> set;
+        for (const auto& opp : opps) {
+            set.emplace(opp.profit_wei, opp.flash_loan_token, opp.path[0].pool_hash, opp.path_length);
+        }
+        return set;
+    };
+
+    Calculator serial(*book_);
+    CalculatorConfig config;
+    config.scan_threads = 4;
+    Calculator parallel(*book_, config);
+    EXPECT_EQ(parallel.scan_threads(), 4u);
+
+    const auto expected = serial.scan(ChainId::ETHEREUM);
+    ASSERT_FALSE(expected.empty());
+    for (int round = 0; round < 3; ++round) {
+        const auto found = parallel.scan(ChainId::ETHEREUM);
+        ASSERT_EQ(found.size(), expected.size());
+        EXPECT_EQ(signature(found), signature(expected));
+        EXPECT_TRUE(std::is_sorted(found.begin(), found.end(), [](const auto& a, const auto& b) {
+            return a.profit_wei > b.profit_wei;
+        }));
+    }
+}
+
+// ============================================================================
+// NegativeCycleDetector
+// ============================================================================
+
+TEST_F(ArbitrageTest, NegativeCycleDetectorFindsArbitrageOfAnyLength) {
+    constexpr uint64_t R = 1'000'000;
+    // 0x100 -> ... -> 0x105 -> 0x100 gains about 2x over six hops; a spur
+    // and a parallel fair pool must not end up in the cycle
+    for (uint64_t i = 0; i < 6; ++i) {
+        const uint64_t out = i == 0 ? 2 * R : R;
+        book_->update_pool(make_update(0xA0 + i, 0x100 + i, 0x100 + (i + 1) % 6, R, out));
+    }
+    book_->update_pool(make_update(0xB0, 0x102, 0x200, R, R));
+    book_->update_pool(make_update(0xB1, 0x103, 0x104, R, R));
+    book_->update_pool(make_update(0xC0, 0x300, 0x301, R, 2 * R, ChainId::ARBITRUM));
+
+    TokenGraph graph;
+    graph.sync(*book_);
+    NegativeCycleDetector detector(ChainId::ETHEREUM);
+    ASSERT_EQ(detector.detect(*book_, graph), 1u);
+    EXPECT_EQ(detector.edge_count(), 2u * 8);
+    EXPECT_GT(detector.last_passes(), 1u);
+
+    const auto cycle = detector.cycle(0);
+    ASSERT_EQ(cycle.size(), 6u);
+    std::set<uint64_t> pools;
+    for (size_t h = 0; h < cycle.size(); ++h) {
+        EXPECT_EQ(cycle[h].to, cycle[(h + 1) % cycle.size()].from);
+        const PoolState pool = book_->pool(cycle[h].pool_id);
+        pools.insert(pool.pool_address_hash);
+        // Every hop runs in the profitable direction, token n -> n + 1
+        const uint64_t from = book_->token_hash(cycle[h].from);
+        EXPECT_EQ(cycle[h].zero_for_one, from == book_->token_hash(book_->pool_token_ids(cycle[h].pool_id).token0));
+        EXPECT_EQ(book_->token_hash(cycle[h].to), 0x100 + (from - 0x100 + 1) % 6);
+    }
+    EXPECT_EQ(pools, (std::set<uint64_t>{0xA0, 0xA1, 0xA2, 0xA3, 0xA4, 0xA5}));
+    EXPECT_LT(detector.cycle_weight(0), -0.6);   // About -log(2) after six fees
+
+    // Balancing the skewed pool removes it; the fair graph converges early
+    book_->update_pool(make_update(0xA0, 0x100, 0x101, R, R));
+    EXPECT_EQ(detector.detect(*book_, graph), 0u);
+    EXPECT_LT(detector.last_passes(), detector.max_passes());
+}
+
+TEST_F(ArbitrageTest, NegativeCycleDetectorConvergesOnAFairMarket) {
+    // Every pair quoted at consistent prices (token i is worth i + 1 units)
+    // with a fee: every cycle loses, however long
+    constexpr uint64_t R = 1'000'000;
+    uint64_t pool = 0x1000;
+    for (uint64_t i = 0; i < 12; ++i) {
+        for (uint64_t j = i + 1; j < 12; ++j) {
+            book_->update_pool(make_update(pool++, 0x100 + i, 0x100 + j, R * (j + 1), R * (i + 1)));
+        }
+    }
+
+    TokenGraph graph;
+    graph.sync(*book_);
+    NegativeCycleDetector detector(ChainId::ETHEREUM);
+    EXPECT_EQ(detector.detect(*book_, graph), 0u);
+    EXPECT_EQ(detector.cycle_count(), 0u);
+    EXPECT_LT(detector.last_passes(), detector.max_passes());
+}
+
+TEST_F(ArbitrageTest, ScanNegativeCyclesSizesRoutableCycles) {
+    constexpr uint64_t R = 1'000'000;
+    // The ScanFindsFourHopCyclesFromEveryBaseToken market: a WETH 4-cycle
+    // and a USDC triangle (priced through 0xB0), plus an Optimism triangle
+    book_->update_pool(make_update(0xA1, WETH_MAINNET, 0x100, R, 2 * R));
+    book_->update_pool(make_update(0xA2, 0x100, 0x101, R, R));
+    book_->update_pool(make_update(0xA3, 0x101, 0x102, R, R));
+    book_->update_pool(make_update(0xA4, 0x102, WETH_MAINNET, R, R));
+    book_->update_pool(make_update(0xB0, WETH_MAINNET, USDC_MAINNET, R, 2 * R));
+    book_->update_pool(make_update(0xB1, USDC_MAINNET, 0x200, R, 2 * R));
+    book_->update_pool(make_update(0xB2, 0x200, 0x201, R, R));
+    book_->update_pool(make_update(0xB3, 0x201, USDC_MAINNET, R, R));
+    book_->update_pool(make_update(0xC1, WETH_OPTIMISM, 0x300, R, 2 * R, ChainId::OPTIMISM));
+    book_->update_pool(make_update(0xC2, 0x300, 0x301, R, R, ChainId::OPTIMISM));
+    book_->update_pool(make_update(0xC3, 0x301, WETH_OPTIMISM, R, R, ChainId::OPTIMISM));
+
+    const auto signature = [](const std::vector<Opportunity>& opps) {
+        std::multiset<std::tuple<uint64_t, uint64_t, uint64_t, uint8_t, uint64_t>> set;
+        for (const auto& opp : opps) {
+            set.emplace(opp.profit_wei, opp.flash_loan_token, opp.path[0].pool_hash, opp.path_length,
+                        opp.flash_loan_amount);
+        }
+        return set;
+    };
+
+    Calculator calculator(*book_);
+    const auto mainnet = calculator.scan_negative_cycles(ChainId::ETHEREUM);
+    ASSERT_EQ(mainnet.size(), 2u);
+    EXPECT_EQ(signature(mainnet), signature(calculator.scan(ChainId::ETHEREUM)));
+    EXPECT_EQ(calculator.negative_cycle_count(), 2u);
+    EXPECT_EQ(calculator.unroutable_cycle_count(), 0u);
+
+    const auto all = calculator.scan_negative_cycles();
+    EXPECT_EQ(all.size(), 3u);
+    EXPECT_EQ(signature(all), signature(calculator.scan()));
+
+    // Arbitrage no base token can borrow into, and a 5-hop one through USDT
+    book_->update_pool(make_update(0xD1, 0x400, 0x401, R, 2 * R));
+    book_->update_pool(make_update(0xD2, 0x401, 0x402, R, R));
+    book_->update_pool(make_update(0xD3, 0x402, 0x400, R, R));
+    for (uint64_t i = 0; i < 5; ++i) {
+        const auto token = [](uint64_t k) { return k % 5 == 0 ? USDT_MAINNET : 0x500 + k; };
+        book_->update_pool(make_update(0xE0 + i, token(i), token(i + 1), R, i == 0 ? 2 * R : R));
+    }
+    const uint64_t before = calculator.unroutable_cycle_count();
+    EXPECT_EQ(calculator.scan_negative_cycles(ChainId::ETHEREUM).size(), 2u);
+    EXPECT_EQ(calculator.unroutable_cycle_count() - before, 2u);
+}
@@ -0,0 +1,435 @@
+/**
+ * Unit tests for the arena, object pools and update queues
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <memory_resource>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "memory/Arena.hpp"
+#include "memory/ArenaResource.hpp"
+#include "memory/ConcurrentObjectPool.hpp"
+#include "orderbook/MPMCQueue.hpp"
+#include "orderbook/SPSCQueue.hpp"
+#include "orderbook/UpdateCoalescer.hpp"
+#include "orderbook/WaitStrategy.hpp"
+
+using namespace matrix;
+using namespace matrix::orderbook;
+
+namespace {
+
+PriceUpdate make_update(uint64_t pool, uint64_t token0, uint64_t token1,
+                        uint64_t reserve0, uint64_t reserve1) {
+    PriceUpdate update{};
+    update.pool_hash = pool;
+    update.token0 = token0;
+    update.token1 = token1;
+    update.reserve0 = reserve0;
+    update.reserve1 = reserve1;
+    return update;
+}
+
+} // namespace
+
+// ============================================================================
+// Arena
+// ============================================================================
+
+TEST(ArenaTest, FreshMemoryReadsAsZero) {
+    memory::Arena arena(1 << 20);
+    const auto* bytes = static_cast<const uint8_t*>(arena.allocate(arena.capacity(), 1));
+    ASSERT_NE(bytes, nullptr);
+    EXPECT_TRUE(std::all_of(bytes, bytes + arena.capacity(), [](uint8_t b) { return b == 0; }));
+    EXPECT_EQ(arena.allocate(1), nullptr);
+}
+
+TEST(ArenaTest, HugePageOptionFallsBackWhenNoneAreReserved) {
+    memory::Arena arena(3 * 1024 * 1024, {.huge_pages = true, .prefault = true});
+    void* block = arena.allocate(arena.capacity(), 1);
+    ASSERT_NE(block, nullptr);
+    std::memset(block, 0xAB, arena.capacity());
+}
+
+TEST(ArenaTest, ScopeRewindsToItsMark) {
+    memory::Arena arena(64 * 1024);
+    void* kept = arena.allocate(100);
+    const size_t mark = arena.used();
+    {
+        memory::ArenaScope frame(arena);
+        EXPECT_NE(arena.allocate(1000), nullptr);
+        {
+            memory::ArenaScope inner(arena);
+            EXPECT_NE(arena.allocate(1000), nullptr);
+        }
+        EXPECT_GT(arena.used(), mark);
+    }
+    EXPECT_EQ(arena.used(), mark);
+    EXPECT_NE(arena.allocate(1), kept);
+}
+
+TEST(ArenaTest, ThreadArenasCarveDisjointBlocks) {
+    memory::Arena parent(1 << 20);
+    constexpr size_t THREADS = 4;
+    constexpr size_t BLOCK = 64 * 1024;
+
+    std::vector<std::vector<uint64_t*>> allocations(THREADS);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < THREADS; ++t) {
+        threads.emplace_back([&, t] {
+            memory::ThreadArena local(parent, BLOCK);
+            for (size_t round = 0; round < 100; ++round) {
+                memory::ArenaScope frame(local);
+                for (size_t i = 0; i < 64; ++i) {
+                    auto* value = local.create<uint64_t>(t);
+                    ASSERT_NE(value, nullptr);
+                    if (round == 0) allocations[t].push_back(value);
+                }
+            }
+            EXPECT_EQ(local.used(), 0u);
+        });
+    }
+    for (auto& thread : threads) thread.join();
+
+    std::vector<uint64_t*> all;
+    for (const auto& mine : allocations) all.insert(all.end(), mine.begin(), mine.end());
+    std::sort(all.begin(), all.end());
+    EXPECT_EQ(std::adjacent_find(all.begin(), all.end()), all.end());
+    EXPECT_EQ(parent.used(), THREADS * BLOCK);
+
+    memory::ThreadArena local(parent, parent.remaining());
+    EXPECT_EQ(local.allocate(local.capacity() + 1, 1), nullptr);
+    EXPECT_THROW(memory::ThreadArena(parent, 1), std::bad_alloc);
+}
+
+TEST(ArenaTest, ResourceBacksPmrContainersAndThrowsWhenExhausted) {
+    memory::Arena arena(64 * 1024);
+    memory::ArenaResource resource(arena);
+    {
+        memory::ArenaScope frame(arena);
+        std::pmr::vector<uint64_t> values(&resource);
+        values.reserve(1000);
+        for (uint64_t i = 0; i < 1000; ++i) values.push_back(i);
+        EXPECT_GE(arena.used(), 8000u);
+        EXPECT_EQ(values[999], 999u);
+    }
+    EXPECT_EQ(arena.used(), 0u);
+
+    std::pmr::vector<uint8_t> too_big(&resource);
+    EXPECT_THROW(too_big.reserve(128 * 1024), std::bad_alloc);
+}
+
+// ============================================================================
+// Object pools
+// ============================================================================
+
+TEST(ObjectPoolTest, AvailableTracksAcquireAndRelease) {
+    auto pool = std::make_unique<memory::ObjectPool<uint64_t, 8>>();
+    std::vector<uint64_t*> out;
+    for (int i = 0; i < 8; ++i) out.push_back(pool->acquire(i));
+    EXPECT_EQ(pool->available(), 0u);
+    EXPECT_EQ(pool->acquire(0), nullptr);
+    pool->release(out.back());
+    EXPECT_EQ(pool->available(), 1u);
+}
+
+TEST(ConcurrentObjectPoolTest, GrowsInArenaSlabsUpToMaxCapacity) {
+    memory::Arena arena(1 << 20);
+    memory::ConcurrentObjectPool<uint64_t> pool(arena, 16, 40);
+    EXPECT_EQ(pool.capacity(), 16u);
+    EXPECT_EQ(pool.available(), 16u);
+
+    std::vector<uint64_t*> out;
+    for (uint64_t i = 0; i < 32; ++i) {
+        uint64_t* value = pool.acquire(i);
+        ASSERT_NE(value, nullptr);
+        out.push_back(value);
+    }
+    EXPECT_EQ(pool.capacity(), 32u);
+    EXPECT_EQ(pool.acquire(0), nullptr);   // Another slab would pass 40
+    EXPECT_EQ(pool.in_use(), 32u);
+    EXPECT_EQ(pool.high_water(), 32u);
+
+    for (auto* value : out) pool.release(value);
+    EXPECT_EQ(pool.available(), 32u);
+    EXPECT_EQ(pool.in_use(), 0u);
+    EXPECT_EQ(pool.high_water(), 32u);
+}
+
+TEST(ConcurrentObjectPoolTest, CachesHandObjectsAcrossThreads) {
+    // Scan-thread -> submit-thread shape: acquired on one side, released on the other
+    using Pool = memory::ConcurrentObjectPool<uint64_t>;
+    constexpr uint64_t COUNT = 200'000;
+    Pool pool(256);
+    auto handoff = std::make_unique<SPSCQueue<uint64_t*, 128>>();
+    std::atomic<uint64_t> sum{0};
+
+    std::thread consumer([&] {
+        Pool::Cache cache(pool);
+        uint64_t received = 0, local = 0;
+        while (received < COUNT) {
+            uint64_t* item;
+            if (!handoff->try_pop(item)) {
+                std::this_thread::yield();
+                continue;
+            }
+            local += *item;
+            cache.release(item);
+            ++received;
+        }
+        sum.store(local);
+    });
+
+    {
+        Pool::Cache cache(pool);
+        for (uint64_t i = 0; i < COUNT; ++i) {
+            uint64_t* item;
+            while (!(item = cache.acquire(i))) std::this_thread::yield();
+            while (!handoff->push(item)) std::this_thread::yield();
+        }
+    }
+    consumer.join();
+
+    EXPECT_EQ(sum.load(), COUNT * (COUNT - 1) / 2);
+    EXPECT_EQ(pool.available(), 256u);
+    EXPECT_LE(pool.high_water(), 256u);
+}
+
+TEST(ConcurrentObjectPoolTest, ContendedAcquireReleaseNeverSharesASlot) {
+    using Pool = memory::ConcurrentObjectPool<uint64_t>;
+    constexpr size_t THREADS = 4;
+    Pool pool(64);
+    std::atomic<bool> corrupted{false};
+
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < THREADS; ++t) {
+        threads.emplace_back([&, t] {
+            Pool::Cache cache(pool);
+            for (uint64_t i = 0; i < 50'000; ++i) {
+                const uint64_t tag = t << 32 | i;
+                uint64_t* a = (i & 1) ? pool.acquire(tag) : cache.acquire(tag);
+                if (!a) continue;
+                std::this_thread::yield();
+                if (*a != tag) corrupted.store(true);
+                if (i & 2) pool.release(a); else cache.release(a);
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+
+    EXPECT_FALSE(corrupted.load());
+    EXPECT_EQ(pool.available(), 64u);
+}
+
+// ============================================================================
+// SPSCQueue
+// ============================================================================
+
+TEST(SPSCQueueTest, BulkPushPopWrapsAround) {
+    auto queue = std::make_unique<SPSCQueue<uint64_t, 8>>();
+    std::vector<uint64_t> in = {1, 2, 3, 4, 5, 6};
+    std::vector<uint64_t> out(8);
+
+    EXPECT_EQ(queue->push_bulk(in), 6u);
+    EXPECT_EQ(queue->pop_bulk(std::span<uint64_t>(out.data(), 4)), 4u);
+
+    // 2 queued, 6 free: the next run crosses the end of the ring
+    in = {7, 8, 9, 10, 11, 12, 13};
+    EXPECT_EQ(queue->push_bulk(in), 6u);
+    EXPECT_EQ(queue->size(), 8u);
+    EXPECT_FALSE(queue->push(uint64_t{99}));
+
+    EXPECT_EQ(queue->pop_bulk(out), 8u);
+    EXPECT_EQ(out, (std::vector<uint64_t>{5, 6, 7, 8, 9, 10, 11, 12}));
+    EXPECT_EQ(queue->pop_bulk(out), 0u);
+    EXPECT_TRUE(queue->empty());
+}
+
+TEST(SPSCQueueTest, ConsumeVisitsItemsInPlace) {
+    auto queue = std::make_unique<SPSCQueue<uint64_t, 16>>();
+    for (uint64_t i = 0; i < 10; ++i) {
+        ASSERT_TRUE(queue->push(i));
+    }
+
+    uint64_t sum = 0;
+    EXPECT_EQ(queue->consume([&](uint64_t& v) { sum += v; }, 4), 4u);
+    EXPECT_EQ(sum, 0u + 1 + 2 + 3);
+    EXPECT_EQ(queue->size(), 6u);
+
+    std::vector<uint64_t> rest;
+    EXPECT_EQ(queue->consume([&](uint64_t& v) { rest.push_back(v); }), 6u);
+    EXPECT_EQ(rest, (std::vector<uint64_t>{4, 5, 6, 7, 8, 9}));
+    EXPECT_FALSE(queue->pop().has_value());
+}
+
+TEST(SPSCQueueTest, CrossThreadBulkTransferKeepsOrder) {
+    constexpr uint64_t kCount = 200'000;
+    auto queue = std::make_unique<SPSCQueue<uint64_t, 1024>>();
+
+    std::thread producer([&] {
+        std::vector<uint64_t> batch;
+        uint64_t next = 0;
+        while (next < kCount) {
+            // Vary the batch size so runs straddle the ring boundary
+            batch.clear();
+            const uint64_t size = 1 + next % 37;
+            for (uint64_t i = 0; i < size && next + i < kCount; ++i) batch.push_back(next + i);
+
+            size_t done = 0;
+            while (done < batch.size()) {
+                done += queue->push_bulk(std::span<const uint64_t>(batch).subspan(done));
+            }
+            next += batch.size();
+        }
+    });
+
+    WaitStrategy waiter(WaitKind::PARK);
+    uint64_t expected = 0;
+    bool ordered = true;
+    while (expected < kCount) {
+        const size_t n = queue->consume([&](uint64_t& v) { ordered &= v == expected++; });
+        if (n == 0) {
+            waiter.wait(*queue);
+        } else {
+            waiter.reset();
+        }
+    }
+    producer.join();
+
+    EXPECT_TRUE(ordered);
+    EXPECT_TRUE(queue->empty());
+}
+
+TEST(SPSCQueueTest, CloseReleasesParkedConsumer) {
+    auto queue = std::make_unique<SPSCQueue<uint64_t, 16>>();
+    std::atomic<bool> woke{false};
+
+    std::thread consumer([&] {
+        queue->park();
+        woke.store(true);
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    queue->close();
+    consumer.join();
+
+    EXPECT_TRUE(woke.load());
+    EXPECT_TRUE(queue->closed());
+    queue->park();  // Never blocks once closed
+}
+
+// ============================================================================
+// MPMCQueue
+// ============================================================================
+
+TEST(MPMCQueueTest, CountsBackpressurePerProducer) {
+    auto queue = std::make_unique<MPMCQueue<uint64_t, 8, 2>>();
+    auto flood = queue->add_producer();
+    auto quiet = queue->add_producer();
+    EXPECT_THROW((void)queue->add_producer(), std::length_error);
+
+    for (uint64_t i = 0; i < 12; ++i) {
+        (void)flood.push(i);
+    }
+    EXPECT_FALSE(quiet.push(uint64_t{100}));
+
+    EXPECT_EQ(queue->producer_stats(flood.id()).pushed, 8u);
+    EXPECT_EQ(queue->producer_stats(flood.id()).rejected, 4u);
+    EXPECT_EQ(queue->producer_stats(quiet.id()).pushed, 0u);
+    EXPECT_EQ(queue->producer_stats(quiet.id()).rejected, 1u);
+
+    uint64_t v = 0;
+    ASSERT_TRUE(queue->try_pop(v));
+    EXPECT_EQ(v, 0u);
+    EXPECT_TRUE(quiet.push(uint64_t{100}));
+    EXPECT_EQ(queue->size(), 8u);
+}
+
+TEST(MPMCQueueTest, ProducersAndConsumersExchangeEveryItemOnce) {
+    constexpr uint32_t kProducers = 4;
+    constexpr uint64_t kPerProducer = 50'000;
+    auto queue = std::make_unique<MPMCQueue<uint64_t, 1024>>();
+
+    // Item = producer << 32 | sequence
+    std::vector<std::thread> threads;
+    for (uint32_t p = 0; p < kProducers; ++p) {
+        threads.emplace_back([producer = queue->add_producer()]() mutable {
+            for (uint64_t i = 0; i < kPerProducer; ++i) {
+                const uint64_t item = (static_cast<uint64_t>(producer.id()) << 32) | i;
+                while (!producer.push(item)) std::this_thread::yield();
+            }
+        });
+    }
+
+    std::vector<std::vector<uint64_t>> seen(2);
+    std::atomic<uint64_t> consumed{0};
+    for (auto& out : seen) {
+        threads.emplace_back([&] {
+            while (consumed.load() < kProducers * kPerProducer) {
+                const size_t n = queue->consume([&](uint64_t& v) { out.push_back(v); }, 64);
+                consumed.fetch_add(n);
+                if (n == 0) std::this_thread::yield();
+            }
+        });
+    }
+    for (auto& t : threads) t.join();
+
+    // Each consumer sees each producer's items in push order; together, all of them once
+    std::vector<uint64_t> all;
+    for (const auto& out : seen) {
+        std::vector<int64_t> last(kProducers, -1);
+        for (uint64_t v : out) {
+            const auto producer = static_cast<uint32_t>(v >> 32);
+            const auto seq = static_cast<int64_t>(v & 0xFFFF'FFFF);
+            EXPECT_GT(seq, last[producer]);
+            last[producer] = seq;
+        }
+        all.insert(all.end(), out.begin(), out.end());
+    }
+    std::sort(all.begin(), all.end());
+    ASSERT_EQ(all.size(), kProducers * kPerProducer);
+    EXPECT_EQ(std::adjacent_find(all.begin(), all.end()), all.end());
+}
+
+// ============================================================================
+// UpdateCoalescer
+// ============================================================================
+
+TEST(UpdateCoalescerTest, KeepsLastSnapshotPerPoolInFirstSeenOrder) {
+    auto batch = std::make_unique<UpdateCoalescer<4>>();
+    EXPECT_TRUE(batch->add(make_update(0xA, 1, 2, 10, 10)));
+    EXPECT_TRUE(batch->add(make_update(0xB, 1, 3, 20, 20)));
+    EXPECT_TRUE(batch->add(make_update(0xA, 1, 2, 11, 12)));
+    EXPECT_TRUE(batch->add(make_update(0xA, 1, 2, 13, 14)));
+
+    ASSERT_EQ(batch->size(), 2u);
+    EXPECT_EQ(batch->conflated(), 2u);
+    EXPECT_EQ(batch->updates()[0].pool_hash, 0xAu);
+    EXPECT_EQ(batch->updates()[0].reserve0, 13u);
+    EXPECT_EQ(batch->updates()[0].reserve1, 14u);
+    EXPECT_EQ(batch->updates()[1].pool_hash, 0xBu);
+
+    // Full: repeats still fold in, new pools are refused
+    EXPECT_TRUE(batch->add(make_update(0xC, 1, 4, 1, 1)));
+    EXPECT_TRUE(batch->add(make_update(0xD, 1, 5, 1, 1)));
+    EXPECT_TRUE(batch->full());
+    EXPECT_FALSE(batch->add(make_update(0xE, 1, 6, 1, 1)));
+    EXPECT_TRUE(batch->add(make_update(0xB, 1, 3, 21, 21)));
+    EXPECT_EQ(batch->updates()[1].reserve0, 21u);
+
+    // A new batch forgets the old pools
+    batch->clear();
+    EXPECT_TRUE(batch->empty());
+    EXPECT_TRUE(batch->add(make_update(0xA, 1, 2, 30, 30)));
+    EXPECT_EQ(batch->size(), 1u);
+    EXPECT_EQ(batch->updates()[0].reserve0, 30u);
+    EXPECT_EQ(batch->conflated(), 3u);
+}
@@ -0,0 +1,564 @@
+/**
+ * Unit tests for WebSocket framing and the feed client
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "memory/Arena.hpp"
+#include "network/FeedDecoder.hpp"
+#include "network/FrameParser.hpp"
+#include "network/Handshake.hpp"
+#include "network/JsonScan.hpp"
+#include "network/WebSocket.hpp"
+
+using namespace matrix;
+using namespace matrix::network;
+using namespace matrix::network::ws;
+
+namespace {
+
+std::vector<uint8_t> make_frame(Opcode opcode, std::string_view payload, bool fin = true, bool masked = false) {
+    static constexpr uint8_t MASK[4] = {0x12, 0x34, 0x56, 0x78};
+    std::vector<uint8_t> frame(MAX_HEADER_BYTES + payload.size());
+    const size_t header = encode_header(frame.data(), opcode, payload.size(), masked ? MASK : nullptr);
+    if (!fin) frame[0] &= 0x7F;
+    std::memcpy(frame.data() + header, payload.data(), payload.size());
+    if (masked) {
+        uint8_t mask[4];
+        std::memcpy(mask, MASK, 4);
+        unmask(frame.data() + header, payload.size(), mask);
+    }
+    frame.resize(header + payload.size());
+    return frame;
+}
+
+struct Delivered {
+    Opcode opcode;
+    std::string payload;
+};
+
+RxBuffer::Status feed(RxBuffer& rx, const std::vector<uint8_t>& bytes, std::vector<Delivered>& out) {
+    EXPECT_TRUE(rx.append(bytes.data(), bytes.size()));
+    return rx.process([&](Opcode op, std::span<const uint8_t> payload) {
+        out.push_back({op, std::string(reinterpret_cast<const char*>(payload.data()), payload.size())});
+    });
+}
+
+} // namespace
+
+// ============================================================================
+// Frame header
+// ============================================================================
+
+TEST(FrameParserTest, HeaderRoundTripsEveryLengthEncoding) {
+    const uint8_t mask[4] = {1, 2, 3, 4};
+    for (uint64_t len : {0ULL, 125ULL, 126ULL, 65535ULL, 65536ULL, 1ULL << 40}) {
+        for (const uint8_t* m : {static_cast<const uint8_t*>(nullptr), mask}) {
+            uint8_t buf[MAX_HEADER_BYTES];
+            const size_t written = encode_header(buf, Opcode::BINARY, len, m);
+
+            FrameHeader h;
+            ASSERT_EQ(parse_header(buf, written, h), ParseStatus::OK);
+            EXPECT_TRUE(h.fin);
+            EXPECT_EQ(h.opcode, Opcode::BINARY);
+            EXPECT_EQ(h.payload_len, len);
+            EXPECT_EQ(h.header_len, written);
+            EXPECT_EQ(h.masked, m != nullptr);
+
+            // Every shorter prefix asks for more
+            for (size_t prefix = 0; prefix < written; ++prefix) {
+                EXPECT_EQ(parse_header(buf, prefix, h), ParseStatus::NEED_MORE);
+            }
+        }
+    }
+}
+
+TEST(FrameParserTest, RejectsMalformedHeaders) {
+    FrameHeader h;
+    const uint8_t rsv[] = {0xC1, 0x00};              // RSV1 set
+    const uint8_t opcode[] = {0x83, 0x00};           // Reserved opcode 3
+    const uint8_t fragmented_ping[] = {0x09, 0x00};  // FIN clear on control
+    const uint8_t long_ping[] = {0x89, 126, 0x00, 0x7E};
+    EXPECT_EQ(parse_header(rsv, 2, h), ParseStatus::PROTOCOL_ERROR);
+    EXPECT_EQ(parse_header(opcode, 2, h), ParseStatus::PROTOCOL_ERROR);
+    EXPECT_EQ(parse_header(fragmented_ping, 2, h), ParseStatus::PROTOCOL_ERROR);
+    EXPECT_EQ(parse_header(long_ping, 4, h), ParseStatus::PROTOCOL_ERROR);
+}
+
+TEST(FrameParserTest, UnmaskIsItsOwnInverse) {
+    const uint8_t mask[4] = {0xA5, 0x5A, 0xFF, 0x01};
+    std::vector<uint8_t> data(37);
+    for (size_t i = 0; i < data.size(); ++i) data[i] = static_cast<uint8_t>(i * 7);
+    const std::vector<uint8_t> original = data;
+
+    unmask(data.data(), data.size(), mask);
+    for (size_t i = 0; i < data.size(); ++i) EXPECT_EQ(data[i], original[i] ^ mask[i & 3]);
+    unmask(data.data(), data.size(), mask);
+    EXPECT_EQ(data, original);
+}
+
+TEST(HandshakeTest, AcceptKeyMatchesRfcExample) {
+    // RFC 6455 section 1.3
+    EXPECT_EQ(accept_key("dGhlIHNhbXBsZSBub25jZQ=="), "s3pPLMBiTxaQ9kYGzzhZRbK+xOo=");
+}
+
+// ============================================================================
+// RxBuffer
+// ============================================================================
+
+TEST(RxBufferTest, DeliversMessagesInPlaceAcrossPartialReads) {
+    RxBuffer rx(4096);
+    std::vector<uint8_t> stream;
+    for (const auto& frame : {make_frame(Opcode::TEXT, "first", true, true),
+                              make_frame(Opcode::BINARY, std::string(300, 'x'))}) {
+        stream.insert(stream.end(), frame.begin(), frame.end());
+    }
+
+    // One byte per read: nothing is delivered until a frame is complete
+    std::vector<Delivered> out;
+    for (uint8_t byte : stream) {
+        ASSERT_EQ(feed(rx, {byte}, out), RxBuffer::Status::OK);
+    }
+    ASSERT_EQ(out.size(), 2u);
+    EXPECT_EQ(out[0].opcode, Opcode::TEXT);
+    EXPECT_EQ(out[0].payload, "first");
+    EXPECT_EQ(out[1].opcode, Opcode::BINARY);
+    EXPECT_EQ(out[1].payload, std::string(300, 'x'));
+    EXPECT_EQ(rx.buffered(), 0u);
+}
+
+TEST(RxBufferTest, ReassemblesFragmentsAroundControlFrames) {
+    RxBuffer rx(4096);
+    std::vector<Delivered> out;
+
+    ASSERT_EQ(feed(rx, make_frame(Opcode::TEXT, "hel", false), out), RxBuffer::Status::OK);
+    ASSERT_EQ(feed(rx, make_frame(Opcode::PING, "p"), out), RxBuffer::Status::OK);
+    ASSERT_EQ(feed(rx, make_frame(Opcode::CONTINUATION, "lo ", false, true), out), RxBuffer::Status::OK);
+    ASSERT_EQ(feed(rx, make_frame(Opcode::CONTINUATION, "world"), out), RxBuffer::Status::OK);
+
+    ASSERT_EQ(out.size(), 2u);
+    EXPECT_EQ(out[0].opcode, Opcode::PING);
+    EXPECT_EQ(out[0].payload, "p");
+    EXPECT_EQ(out[1].opcode, Opcode::TEXT);
+    EXPECT_EQ(out[1].payload, "hello world");
+}
+
+TEST(RxBufferTest, CompactsSoLongStreamsFitASmallBuffer) {
+    RxBuffer rx(256);
+    std::vector<Delivered> out;
+    size_t received = 0;
+
+    // Far more bytes than the buffer, with frames straddling every offset
+    for (int i = 0; i < 200; ++i) {
+        const std::string payload(static_cast<size_t>(i % 97), static_cast<char>('a' + i % 26));
+        const auto frame = make_frame(Opcode::TEXT, payload);
+        const size_t split = frame.size() / 2;
+        ASSERT_EQ(feed(rx, {frame.begin(), frame.begin() + static_cast<long>(split)}, out), RxBuffer::Status::OK);
+        ASSERT_EQ(feed(rx, {frame.begin() + static_cast<long>(split), frame.end()}, out), RxBuffer::Status::OK);
+        ASSERT_EQ(out.size(), ++received);
+        EXPECT_EQ(out.back().payload, payload);
+    }
+}
+
+TEST(RxBufferTest, RejectsProtocolViolationsAndOversizedMessages) {
+    std::vector<Delivered> out;
+
+    RxBuffer stray(256);
+    EXPECT_EQ(feed(stray, make_frame(Opcode::CONTINUATION, "x"), out), RxBuffer::Status::PROTOCOL_ERROR);
+
+    RxBuffer interleaved(256);
+    ASSERT_EQ(feed(interleaved, make_frame(Opcode::TEXT, "a", false), out), RxBuffer::Status::OK);
+    EXPECT_EQ(feed(interleaved, make_frame(Opcode::TEXT, "b"), out), RxBuffer::Status::PROTOCOL_ERROR);
+
+    RxBuffer small(64);
+    std::vector<uint8_t> header(MAX_HEADER_BYTES);
+    header.resize(encode_header(header.data(), Opcode::BINARY, 1000, nullptr));
+    EXPECT_EQ(feed(small, header, out), RxBuffer::Status::MESSAGE_TOO_BIG);
+    EXPECT_TRUE(out.empty());
+}
+
+// ============================================================================
+// WebSocketClient over loopback
+// ============================================================================
+
+namespace {
+
+/**
+ * One-connection WebSocket server: upgrades, sends `frames` (the first in
+ * the same write as the 101 response), expects a masked pong for each ping
+ * and finishes with a close
+ */
+class LoopbackServer {
+public:
+    explicit LoopbackServer(std::vector<std::vector<uint8_t>> frames) : frames_(std::move(frames)) {
+        listen_fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        EXPECT_EQ(::bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)), 0);
+        EXPECT_EQ(::listen(listen_fd_, 1), 0);
+        socklen_t len = sizeof(addr);
+        ::getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&addr), &len);
+        port_ = ntohs(addr.sin_port);
+        thread_ = std::thread([this] { serve(); });
+    }
+
+    ~LoopbackServer() {
+        join();
+        ::close(listen_fd_);
+    }
+
+    void join() {
+        if (thread_.joinable()) thread_.join();
+    }
+
+    [[nodiscard]] std::string url() const { return "ws://127.0.0.1:" + std::to_string(port_) + "/feed"; }
+
+    std::vector<std::string> pongs;
+    std::string request_path;
+
+private:
+    bool read_exact(int fd, uint8_t* out, size_t len) {
+        while (len > 0) {
+            const ssize_t n = ::recv(fd, out, len, 0);
+            if (n <= 0) return false;
+            out += n;
+            len -= static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    // Read one client frame and unmask it
+    bool read_frame(int fd, Opcode& opcode, std::string& payload) {
+        uint8_t head[MAX_HEADER_BYTES];
+        size_t have = 2;
+        if (!read_exact(fd, head, 2)) return false;
+        FrameHeader h;
+        ParseStatus status;
+        while ((status = parse_header(head, have, h)) == ParseStatus::NEED_MORE) {
+            if (!read_exact(fd, head + have, 1)) return false;
+            ++have;
+        }
+        if (status != ParseStatus::OK || !h.masked) return false;
+        std::vector<uint8_t> body(h.payload_len);
+        if (!read_exact(fd, body.data(), body.size())) return false;
+        unmask(body.data(), body.size(), h.mask);
+        opcode = h.opcode;
+        payload.assign(body.begin(), body.end());
+        return true;
+    }
+
+    void serve() {
+        const int fd = ::accept(listen_fd_, nullptr, nullptr);
+        ASSERT_GE(fd, 0);
+
+        std::string request;
+        char buf[1024];
+        while (request.find("\r\n\r\n") == std::string::npos) {
+            const ssize_t n = ::recv(fd, buf, sizeof(buf), 0);
+            ASSERT_GT(n, 0);
+            request.append(buf, static_cast<size_t>(n));
+        }
+        request_path = request.substr(4, request.find(' ', 4) - 4);
+        const size_t key_at = request.find("Sec-WebSocket-Key: ") + 19;
+        const std::string key = request.substr(key_at, request.find("\r\n", key_at) - key_at);
+
+        std::string response =
+            "HTTP/1.1 101 Switching Protocols\r\n"
+            "upgrade: WebSocket\r\n"
+            "Connection: Upgrade\r\n"
+            "Sec-WebSocket-Accept: " + accept_key(key) + "\r\n\r\n";
+        response.append(frames_.front().begin(), frames_.front().end());
+        ::send(fd, response.data(), response.size(), MSG_NOSIGNAL);
+
+        for (size_t i = 1; i < frames_.size(); ++i) {
+            ::send(fd, frames_[i].data(), frames_[i].size(), MSG_NOSIGNAL);
+            if ((frames_[i][0] & 0x0F) == static_cast<uint8_t>(Opcode::PING)) {
+                Opcode opcode;
+                std::string payload;
+                ASSERT_TRUE(read_frame(fd, opcode, payload));
+                ASSERT_EQ(opcode, Opcode::PONG);
+                pongs.push_back(payload);
+            }
+        }
+
+        const auto close = make_frame(Opcode::CLOSE, std::string("\x03\xE8", 2));
+        ::send(fd, close.data(), close.size(), MSG_NOSIGNAL);
+        Opcode opcode;
+        std::string payload;
+        EXPECT_TRUE(read_frame(fd, opcode, payload));
+        EXPECT_EQ(opcode, Opcode::CLOSE);
+        ::close(fd);
+    }
+
+    int listen_fd_ = -1;
+    uint16_t port_ = 0;
+    std::vector<std::vector<uint8_t>> frames_;
+    std::thread thread_;
+};
+
+void run_client_against_loopback(bool use_io_uring) {
+    const std::string big(70000, 'B');
+    LoopbackServer server({
+        make_frame(Opcode::TEXT, "hello"),                      // Rides along with the 101
+        make_frame(Opcode::TEXT, std::string(300, 'm')),        // 16-bit length
+        make_frame(Opcode::BINARY, big),                        // 64-bit length
+        make_frame(Opcode::TEXT, "frag", false),
+        make_frame(Opcode::PING, "are you there"),
+        make_frame(Opcode::CONTINUATION, "mented"),
+    });
+
+    WebSocketClient::Config config;
+    config.url = server.url();
+    config.use_io_uring = use_io_uring;
+    config.rx_buffer_bytes = 128 * 1024;
+    WebSocketClient client(config);
+
+    std::vector<std::string> messages;
+    std::vector<std::string> errors;
+    client.on_message([&](std::string_view message) { messages.emplace_back(message); });
+    client.on_error([&](const std::string& error) { errors.push_back(error); });
+
+    client.connect();
+    ASSERT_TRUE(client.is_connected()) << (errors.empty() ? "" : errors.front());
+    EXPECT_EQ(client.using_io_uring(), use_io_uring);
+
+    // The server's close frame ends the session
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (client.is_connected() && std::chrono::steady_clock::now() < deadline) {
+        client.poll(100);
+    }
+    EXPECT_FALSE(client.is_connected());
+
+    ASSERT_EQ(messages.size(), 4u);
+    EXPECT_EQ(messages[0], "hello");
+    EXPECT_EQ(messages[1], std::string(300, 'm'));
+    EXPECT_EQ(messages[2], big);
+    EXPECT_EQ(messages[3], "fragmented");
+    EXPECT_EQ(client.messages_received(), 4u);
+    EXPECT_GT(client.bytes_received(), big.size());
+    EXPECT_GT(client.latency_ns(), 0u);   // Kernel receive timestamps made it through
+
+    server.join();
+    EXPECT_EQ(server.request_path, "/feed");
+    ASSERT_EQ(server.pongs.size(), 1u);
+    EXPECT_EQ(server.pongs[0], "are you there");
+}
+
+} // namespace
+
+TEST(WebSocketClientTest, ReceivesFramesOverIoUring) {
+    run_client_against_loopback(true);
+}
+
+TEST(WebSocketClientTest, ReceivesFramesOverEpoll) {
+    run_client_against_loopback(false);
+}
+
+TEST(WebSocketClientTest, ReportsUnsupportedSchemes) {
+    WebSocketClient::Config config;
+    config.url = "wss://example.invalid/feed";
+    WebSocketClient client(config);
+
+    std::string error;
+    client.on_error([&](const std::string& e) { error = e; });
+    client.connect();
+    EXPECT_FALSE(client.is_connected());
+    EXPECT_NE(error.find("wss"), std::string::npos);
+}
+
+// ============================================================================
+// Feed decoding
+// ============================================================================
+
+namespace {
+
+using u128 = __uint128_t;
+
+constexpr std::string_view POOL = "0xB4e16d0168e52d35CaCD2c6185b44281Ec28C9Dc";
+constexpr std::string_view SYNC = "0x1c411e9a96e071241c2f21f7726b17ae89e3cab4c78be50e062b03a9fffbbad1";
+constexpr std::string_view V3_SWAP = "0xc42079f94a6350d7e6235f29174924f928cc2ac818eb64fed8004e115fbcca67";
+
+std::string hex_word(u128 value, uint32_t high = 0) {
+    static constexpr char DIGITS[] = "0123456789abcdef";
+    std::string word(64, '0');
+    for (int i = 0; i < 32; ++i) {
+        word[63 - i] = DIGITS[static_cast<unsigned>(value >> (4 * i)) & 0xF];
+        word[31 - i] = DIGITS[(i < 8 ? high >> (4 * i) : 0) & 0xF];
+    }
+    return word;
+}
+
+std::string log_message(std::string_view address, std::string_view topic0, const std::string& data,
+                        bool removed = false) {
+    return R"({"jsonrpc":"2.0","method":"eth_subscription","params":{"subscription":"0x9ce59a13059e417087c02d3236a0b1cc",)"
+           R"("result":{"address":")" + std::string(address) + R"(","topics":[")" + std::string(topic0) +
+           R"("],"data":"0x)" + data + R"(","blockNumber":"0x10d4f","transactionHash":"0x8e2b",)"
+           R"("logIndex":"0x1","removed":)" + (removed ? "true" : "false") + "}}}";
+}
+
+PoolInfo v2_pool() {
+    PoolInfo info{};
+    info.token0 = 0xA0;
+    info.token1 = 0xC0;
+    info.dex = orderbook::DexId::SUSHISWAP;
+    info.event = PoolEvent::V2_SYNC;
+    return info;
+}
+
+} // namespace
+
+TEST(JsonScanTest, IndexesUnescapedQuotesAcrossBlocks) {
+    // Escaped quotes and backslash runs straddling the 64-byte block edge
+    std::string json = R"({"k":")" + std::string(52, 'x') + R"(\\\"y\\","z":"w"})";
+    ASSERT_GT(json.size(), 64u);
+
+    uint32_t quotes[16];
+    const size_t n = scan::index_quotes(json.data(), json.size(), quotes, 16);
+    std::vector<uint32_t> expected;
+    bool escaped = false;
+    for (size_t i = 0; i < json.size(); ++i) {
+        if (!escaped && json[i] == '"') expected.push_back(static_cast<uint32_t>(i));
+        escaped = !escaped && json[i] == '\\';
+    }
+    ASSERT_EQ(n, expected.size());
+    EXPECT_TRUE(std::equal(expected.begin(), expected.end(), quotes));
+    EXPECT_EQ(scan::index_quotes(json.data(), json.size(), quotes, 2), SIZE_MAX);
+}
+
+TEST(JsonScanTest, DecodesMixedCaseHexAndRejectsNonHex) {
+    const std::string hex = "00FFa5C3" + std::string("0123456789abcdefABCDEF0123456789") + "7e";
+    uint8_t out[21];
+    ASSERT_TRUE(scan::decode_hex(hex.data(), 21, out));
+    EXPECT_EQ(out[0], 0x00);
+    EXPECT_EQ(out[1], 0xFF);
+    EXPECT_EQ(out[2], 0xA5);
+    EXPECT_EQ(out[3], 0xC3);
+    EXPECT_EQ(out[4], 0x01);
+    EXPECT_EQ(out[11], 0xEF);
+    EXPECT_EQ(out[12], 0xAB);
+    EXPECT_EQ(out[20], 0x7E);
+
+    for (size_t bad = 0; bad < hex.size(); bad += 7) {
+        std::string corrupt = hex;
+        corrupt[bad] = 'g';
+        EXPECT_FALSE(scan::decode_hex(corrupt.data(), 21, out)) << bad;
+    }
+}
+
+TEST(FeedDecoderTest, DecodesV2SyncIntoScaledReserves) {
+    memory::Arena arena(1 << 20);
+    FeedDecoder decoder(orderbook::ChainId::ETHEREUM, arena, 16);
+    PoolInfo info = v2_pool();
+    info.scale0 = 1'000'000'000;   // 18-decimal token -> gwei units
+    ASSERT_TRUE(decoder.add_pool(POOL, info));
+
+    const u128 reserve0 = static_cast<u128>(1000) * 1'000'000'000'000'000'000ULL;   // 1000e18 > 2^64
+    const u128 reserve1 = 2'000'000'000'000ULL;
+    orderbook::PriceUpdate update{};
+    ASSERT_EQ(decoder.decode(log_message(POOL, SYNC, hex_word(reserve0) + hex_word(reserve1)), 77, update),
+              DecodeStatus::DECODED);
+
+    uint8_t address[20];
+    ASSERT_TRUE(parse_address(POOL, address));
+    EXPECT_EQ(update.pool_hash, address_hash(address));
+    EXPECT_EQ(update.timestamp_ns, 77u);
+    EXPECT_EQ(update.chain_id, static_cast<uint32_t>(orderbook::ChainId::ETHEREUM));
+    EXPECT_EQ(update.dex_id, static_cast<uint32_t>(orderbook::DexId::SUSHISWAP));
+    EXPECT_EQ(update.token0, 0xA0u);
+    EXPECT_EQ(update.token1, 0xC0u);
+    EXPECT_EQ(update.reserve0, 1'000'000'000'000ULL);
+    EXPECT_EQ(update.reserve1, 2'000'000'000'000ULL);
+    EXPECT_EQ(update.price, 2'000'000'000'000'000'000ULL);
+}
+
+TEST(FeedDecoderTest, DecodesV3SwapAsVirtualReserves) {
+    memory::Arena arena(1 << 20);
+    FeedDecoder decoder(orderbook::ChainId::ARBITRUM, arena, 16);
+    PoolInfo info = v2_pool();
+    info.dex = orderbook::DexId::UNISWAP_V3;
+    info.event = PoolEvent::V3_SWAP;
+    ASSERT_TRUE(decoder.add_pool(POOL, info));
+
+    const std::string amounts = hex_word(~static_cast<u128>(0), ~0u) + hex_word(12345);
+    orderbook::PriceUpdate update{};
+
+    // sqrtP = 1.0 (2^96): both virtual reserves equal L
+    const u128 q96 = static_cast<u128>(1) << 96;
+    ASSERT_EQ(decoder.decode(log_message(POOL, V3_SWAP, amounts + hex_word(q96) + hex_word(1'000'000) + hex_word(0)),
+                             1, update),
+              DecodeStatus::DECODED);
+    EXPECT_EQ(update.reserve0, 1'000'000u);
+    EXPECT_EQ(update.reserve1, 1'000'000u);
+
+    // sqrtP = 2^44 (stored as 2^140, above 128 bits): L / sqrtP = 2^16, L * sqrtP = 2^104
+    const std::string high_price = amounts + hex_word(0, 1u << 12) + hex_word(static_cast<u128>(1) << 60) + hex_word(0);
+    EXPECT_EQ(decoder.decode(log_message(POOL, V3_SWAP, high_price), 1, update), DecodeStatus::OUT_OF_RANGE);
+
+    memory::Arena scaled_arena(1 << 20);
+    FeedDecoder scaled(orderbook::ChainId::ARBITRUM, scaled_arena, 16);
+    info.scale1 = 1ULL << 50;
+    ASSERT_TRUE(scaled.add_pool(POOL, info));
+    ASSERT_EQ(scaled.decode(log_message(POOL, V3_SWAP, high_price), 1, update), DecodeStatus::DECODED);
+    EXPECT_EQ(update.reserve0, 1u << 16);
+    EXPECT_EQ(update.reserve1, 1ULL << 54);
+}
+
+TEST(FeedDecoderTest, ClassifiesEverythingElse) {
+    memory::Arena arena(1 << 20);
+    FeedDecoder decoder(orderbook::ChainId::ETHEREUM, arena, 16);
+    ASSERT_TRUE(decoder.add_pool(POOL, v2_pool()));
+    EXPECT_FALSE(decoder.add_pool("0x1234", v2_pool()));
+
+    const std::string sync_data = hex_word(100) + hex_word(200);
+    orderbook::PriceUpdate update{};
+    EXPECT_EQ(decoder.decode(R"({"jsonrpc":"2.0","id":1,"result":"0x9ce59a13059e417087c02d3236a0b1cc"})", 0, update),
+              DecodeStatus::NOT_A_LOG);
+    EXPECT_EQ(decoder.decode(log_message(POOL, SYNC, sync_data, true), 0, update), DecodeStatus::IGNORED);
+    EXPECT_EQ(decoder.decode(log_message(POOL, V3_SWAP, sync_data), 0, update), DecodeStatus::IGNORED);
+    EXPECT_EQ(decoder.decode(log_message("0x0000000000000000000000000000000000000001", SYNC, sync_data), 0, update),
+              DecodeStatus::UNKNOWN_POOL);
+    EXPECT_EQ(decoder.decode(log_message(POOL, SYNC, hex_word(100)), 0, update), DecodeStatus::MALFORMED);
+    EXPECT_EQ(decoder.decode(log_message(POOL, SYNC, hex_word(100, 1) + hex_word(200)), 0, update),
+              DecodeStatus::MALFORMED);
+
+    // Whitespace between tokens is fine
+    std::string spaced = log_message(POOL, SYNC, sync_data);
+    for (size_t pos = 0; (pos = spaced.find("\":", pos)) != std::string::npos; pos += 4) spaced.replace(pos, 2, "\" : ");
+    EXPECT_EQ(decoder.decode(spaced, 0, update), DecodeStatus::DECODED);
+    EXPECT_EQ(update.reserve1, 200u);
+
+    const DecodeStats& stats = decoder.stats();
+    EXPECT_EQ(stats.messages, 7u);
+    EXPECT_EQ(stats.decoded, 1u);
+    EXPECT_EQ(stats.not_a_log, 1u);
+    EXPECT_EQ(stats.ignored, 2u);
+    EXPECT_EQ(stats.unknown_pool, 1u);
+    EXPECT_EQ(stats.malformed, 2u);
+}
+
+TEST(FeedDecoderTest, PushesDecodedUpdatesIntoThePriceQueue) {
+    memory::Arena arena(1 << 20);
+    FeedDecoder decoder(orderbook::ChainId::ETHEREUM, arena, 16);
+    ASSERT_TRUE(decoder.add_pool(POOL, v2_pool()));
+
+    auto queue = std::make_unique<orderbook::PriceQueue>();
+    EXPECT_TRUE(decoder.decode_into(log_message(POOL, SYNC, hex_word(5) + hex_word(7)), 9, *queue));
+    EXPECT_FALSE(decoder.decode_into(log_message(POOL, V3_SWAP, hex_word(5) + hex_word(7)), 9, *queue));
+
+    orderbook::PriceUpdate update{};
+    ASSERT_TRUE(queue->try_pop(update));
+    EXPECT_EQ(update.reserve0, 5u);
+    EXPECT_EQ(update.reserve1, 7u);
+    EXPECT_TRUE(queue->empty());
+}
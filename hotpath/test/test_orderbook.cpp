@@ -0,0 +1,666 @@
+/**
+ * Unit tests for the order book and its flat indexes
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <span>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "memory/Arena.hpp"
+#include "orderbook/BookSnapshot.hpp"
+#include "orderbook/FlatHashMap.hpp"
+#include "orderbook/OrderBook.hpp"
+#include "orderbook/SPSCQueue.hpp"
+
+using namespace matrix;
+using namespace matrix::orderbook;
+
+namespace {
+
+PriceUpdate make_update(uint64_t pool, uint64_t token0, uint64_t token1,
+                        uint64_t reserve0, uint64_t reserve1, uint64_t ts = 1) {
+    PriceUpdate update{};
+    update.timestamp_ns = ts;
+    update.pool_hash = pool;
+    update.chain_id = static_cast<uint32_t>(ChainId::ETHEREUM);
+    update.dex_id = static_cast<uint32_t>(DexId::UNISWAP_V3);
+    update.token0 = token0;
+    update.token1 = token1;
+    update.reserve0 = reserve0;
+    update.reserve1 = reserve1;
+    return update;
+}
+
+class OrderBookTest : public ::testing::Test {
+protected:
+    memory::Arena arena_;
+    std::unique_ptr<OrderBook> book_ = std::make_unique<OrderBook>(arena_);
+};
+
+} // namespace
+
+// ============================================================================
+// FlatHashMap
+// ============================================================================
+
+TEST(FlatHashMapTest, InsertAndFind) {
+    memory::Arena arena(1024 * 1024);
+    FlatHashMap<uint64_t, uint32_t, U64Hash> map(arena, 1000);
+
+    for (uint64_t k = 0; k < 1000; ++k) {
+        auto [value, inserted] = map.insert(k * 7919, static_cast<uint32_t>(k));
+        ASSERT_TRUE(inserted);
+        ASSERT_NE(value, nullptr);
+        EXPECT_EQ(*value, k);
+    }
+    EXPECT_EQ(map.size(), 1000u);
+
+    for (uint64_t k = 0; k < 1000; ++k) {
+        const uint32_t* value = map.find(k * 7919);
+        ASSERT_NE(value, nullptr);
+        EXPECT_EQ(*value, k);
+    }
+    EXPECT_EQ(map.find(1), nullptr);
+}
+
+TEST(FlatHashMapTest, DuplicateInsertKeepsFirstValue) {
+    memory::Arena arena(64 * 1024);
+    FlatHashMap<uint64_t, uint32_t, U64Hash> map(arena, 16);
+
+    EXPECT_TRUE(map.insert(42, 1).second);
+    auto [value, inserted] = map.insert(42, 2);
+    EXPECT_FALSE(inserted);
+    EXPECT_EQ(*value, 1u);
+    EXPECT_EQ(map.size(), 1u);
+}
+
+TEST(FlatHashMapTest, RejectsInsertWhenFull) {
+    memory::Arena arena(64 * 1024);
+    FlatHashMap<uint64_t, uint32_t, U64Hash> map(arena, 4);
+
+    for (uint64_t k = 0; k < 4; ++k) {
+        EXPECT_TRUE(map.insert(k, 0).second);
+    }
+    auto [value, inserted] = map.insert(99, 0);
+    EXPECT_FALSE(inserted);
+    EXPECT_EQ(value, nullptr);
+    EXPECT_TRUE(map.full());
+}
+
+TEST(FlatHashMapTest, MatchesUnorderedMapUnderRandomKeys) {
+    memory::Arena arena(4 * 1024 * 1024);
+    FlatHashMap<uint64_t, uint32_t, U64Hash> map(arena, 20000);
+    std::unordered_map<uint64_t, uint32_t> reference;
+
+    uint64_t x = 0x9E3779B97F4A7C15ULL;
+    for (uint32_t i = 0; i < 20000; ++i) {
+        x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+        const uint64_t key = x & 0xFFFFF;  // Force plenty of duplicates
+        map.insert(key, i);
+        reference.emplace(key, i);
+    }
+
+    EXPECT_EQ(map.size(), reference.size());
+    for (const auto& [key, value] : reference) {
+        const uint32_t* found = map.find(key);
+        ASSERT_NE(found, nullptr);
+        EXPECT_EQ(*found, value);
+    }
+}
+
+TEST(FlatHashMapTest, ThrowsWhenArenaExhausted) {
+    memory::Arena arena(4096);
+    using Map = FlatHashMap<uint64_t, uint32_t, U64Hash>;
+    EXPECT_THROW(Map(arena, 100000), std::bad_alloc);
+}
+
+// ============================================================================
+// Pool kernels
+// ============================================================================
+
+TEST(PoolKernelsTest, ArgMaxMatchesScalarReference) {
+    uint64_t x = 0x243F6A8885A308D3ULL;
+    const auto next = [&] { x ^= x << 13; x ^= x >> 7; x ^= x << 17; return x; };
+
+    for (size_t n : {0u, 1u, 3u, 4u, 7u, 8u, 9u, 31u, 64u, 100u}) {
+        std::vector<uint64_t> rin(n), rout(n);
+        std::vector<uint32_t> fee(n);
+        for (size_t i = 0; i < n; ++i) {
+            rin[i] = next() >> 4;
+            rout[i] = i % 5 == 0 ? 0 : next() >> 4;  // Some empty pools
+            fee[i] = static_cast<uint32_t>(next() % 100);
+        }
+        if (n > 2) rout[n - 1] = rout[1], rin[n - 1] = rin[1], fee[n - 1] = fee[1];  // A tie
+
+        for (uint64_t amount : {0ull, 1ull << 40}) {
+            const auto ref = kernels::detail::argmax_scalar(
+                rin.data(), rout.data(), fee.data(), 0, n, static_cast<double>(amount), {});
+            const auto got = kernels::argmax_output(rin.data(), rout.data(), fee.data(), n, amount);
+            EXPECT_EQ(got.index, ref.index) << "n=" << n << " amount=" << amount;
+            EXPECT_EQ(got.value, ref.value) << "n=" << n << " amount=" << amount;
+        }
+    }
+}
+
+// ============================================================================
+// PoolState
+// ============================================================================
+
+TEST(PoolStateTest, AmountOutIsExactWhenProductOverflows128Bits) {
+    // 18-decimal reserves: amount * 9970 * reserve_out is ~1.5e41 > 2^128
+    PoolState pool{};
+    pool.reserve0 = 10'000'000'000'000'000'000ULL;
+    pool.reserve1 = 15'000'000'000'000'000'000ULL;
+    pool.fee_bps = 30;
+
+    EXPECT_EQ(pool.get_amount_out(1'000'000'000'000'000'000ULL, true), 1'359'916'340'820'223'697ULL);
+
+    pool.reserve0 = 18'000'000'000'000'000'000ULL;
+    pool.reserve1 = 17'999'999'999'999'999'999ULL;
+    EXPECT_EQ(pool.get_amount_out(12'345'678'901'234'567'890ULL, true), 7'309'979'594'329'306'268ULL);
+    EXPECT_EQ(pool.get_amount_out(0, true), 0u);
+}
+
+// ============================================================================
+// OrderBook
+// ============================================================================
+
+TEST_F(OrderBookTest, CreatesPoolOnFirstUpdate) {
+    book_->update_pool(make_update(0xA1, 1, 2, 1000, 2000));
+
+    EXPECT_EQ(book_->pool_count(), 1u);
+    EXPECT_EQ(book_->token_count(), 2u);
+    EXPECT_EQ(book_->pair_count(), 1u);
+
+    const auto pool = book_->find_pool(0xA1);
+    ASSERT_TRUE(pool.has_value());
+    EXPECT_EQ(pool->reserve0, 1000u);
+    EXPECT_EQ(pool->reserve1, 2000u);
+    EXPECT_EQ(pool->token0_hash, 1u);
+    EXPECT_EQ(pool->token1_hash, 2u);
+}
+
+TEST_F(OrderBookTest, ReserveUpdateDoesNotDuplicatePool) {
+    book_->update_pool(make_update(0xA1, 1, 2, 1000, 2000, 1));
+    book_->update_pool(make_update(0xA1, 1, 2, 1100, 1900, 2));
+
+    EXPECT_EQ(book_->pool_count(), 1u);
+    EXPECT_EQ(book_->get_pools(1, 2).size(), 1u);
+    EXPECT_EQ(book_->find_pool(0xA1)->reserve0, 1100u);
+    EXPECT_EQ(book_->last_update_ns(), 2u);
+}
+
+TEST_F(OrderBookTest, GetPoolsIgnoresTokenOrder) {
+    book_->update_pool(make_update(0xA1, 1, 2, 1000, 2000));
+    book_->update_pool(make_update(0xA2, 2, 1, 3000, 1000));
+    book_->update_pool(make_update(0xA3, 1, 3, 1000, 1000));
+
+    EXPECT_EQ(book_->pair_count(), 2u);
+
+    std::vector<uint64_t> forward;
+    for (const PoolState pool : book_->get_pools(1, 2)) forward.push_back(pool.pool_address_hash);
+    std::vector<uint64_t> reverse;
+    for (const PoolState pool : book_->get_pools(2, 1)) reverse.push_back(pool.pool_address_hash);
+
+    EXPECT_EQ(forward, (std::vector<uint64_t>{0xA1, 0xA2}));
+    EXPECT_EQ(forward, reverse);
+    EXPECT_EQ(book_->get_pools(1, 3).size(), 1u);
+    EXPECT_TRUE(book_->get_pools(2, 3).empty());
+}
+
+TEST_F(OrderBookTest, GetBestPricePicksHighestSpotPrice) {
+    book_->update_pool(make_update(0xA1, 1, 2, 1000, 2000));
+    book_->update_pool(make_update(0xA2, 1, 2, 1000, 3000));
+    book_->update_pool(make_update(0xA3, 1, 2, 1000, 2500));
+
+    const auto best = book_->get_best_price(1, 2);
+    ASSERT_TRUE(best.has_value());
+    EXPECT_EQ(best->pool_address_hash, 0xA2u);
+    EXPECT_FALSE(book_->get_best_price(1, 9).has_value());
+
+    // Selling token 2 favours the pool with the least token 1 per token 2
+    EXPECT_EQ(book_->get_best_price(2, 1)->pool_address_hash, 0xA1u);
+}
+
+TEST_F(OrderBookTest, ReversedPoolKeepsItsOwnTokenOrder) {
+    book_->update_pool(make_update(0xA1, 1, 2, 1000, 2000));
+    book_->update_pool(make_update(0xA2, 2, 1, 5000, 1000));
+
+    const auto pool = book_->find_pool(0xA2);
+    ASSERT_TRUE(pool.has_value());
+    EXPECT_EQ(pool->token0_hash, 2u);
+    EXPECT_EQ(pool->token1_hash, 1u);
+    EXPECT_EQ(pool->reserve0, 5000u);
+    EXPECT_EQ(pool->reserve1, 1000u);
+
+    // 0xA2 pays 5 token 2 per token 1 against 2 from 0xA1
+    EXPECT_EQ(book_->get_best_price(1, 2)->pool_address_hash, 0xA2u);
+    EXPECT_EQ(book_->get_best_price(2, 1)->pool_address_hash, 0xA1u);
+}
+
+TEST_F(OrderBookTest, BestPoolForAmountAccountsForDepth) {
+    // Shallow pool has the better spot price but poor depth
+    book_->update_pool(make_update(0xA1, 1, 2, 1'000, 2'100));
+    book_->update_pool(make_update(0xA2, 1, 2, 1'000'000, 2'000'000));
+
+    EXPECT_EQ(book_->get_best_price(1, 2)->pool_address_hash, 0xA1u);
+    EXPECT_EQ(book_->get_best_pool_for_amount(1, 2, 10'000)->pool_address_hash, 0xA2u);
+}
+
+TEST_F(OrderBookTest, SegmentGrowthKeepsPoolsAddressable) {
+    // Interleave two pairs so every segment doubling relocates past the other
+    constexpr uint64_t kPools = 300;
+    for (uint64_t i = 0; i < kPools; ++i) {
+        book_->update_pool(make_update(0x1000 + i, 1, 2, 1000, 1000 + i));
+        book_->update_pool(make_update(0x2000 + i, 3, 1, 1000 + i, 1000));
+    }
+
+    EXPECT_EQ(book_->get_pools(1, 2).size(), kPools);
+    EXPECT_EQ(book_->get_pools(1, 3).size(), kPools);
+    for (uint64_t i = 0; i < kPools; ++i) {
+        const auto a = book_->find_pool(0x1000 + i);
+        const auto b = book_->find_pool(0x2000 + i);
+        ASSERT_TRUE(a.has_value());
+        ASSERT_TRUE(b.has_value());
+        EXPECT_EQ(a->reserve1, 1000 + i);
+        EXPECT_EQ(b->token0_hash, 3u);
+        EXPECT_EQ(b->reserve0, 1000 + i);
+    }
+
+    // Reserve updates after relocation land in the moved slot
+    book_->update_pool(make_update(0x1000, 1, 2, 1000, 9999));
+    EXPECT_EQ(book_->find_pool(0x1000)->reserve1, 9999u);
+    EXPECT_EQ(book_->get_best_price(1, 2)->pool_address_hash, 0x1000u);
+    EXPECT_EQ(book_->get_best_price(1, 3)->pool_address_hash, 0x2000u + kPools - 1);
+}
+
+TEST_F(OrderBookTest, FillsToMaxPoolsWithMultiPoolPairs) {
+    // 17 pools per pair is a worst case for segment growth: each pair
+    // outgrows segments of 1..16 and lands in one of 32 (63 slots, well
+    // past 3 per pool). Pairs share token 1 to stay under MAX_TOKENS
+    constexpr uint64_t kPerPair = 17;
+    for (uint64_t i = 0; i < OrderBook::MAX_POOLS; ++i) {
+        book_->update_pool(make_update(i + 1, 1, i / kPerPair + 2, 1000, 1000 + i));
+    }
+    EXPECT_EQ(book_->pool_count(), OrderBook::MAX_POOLS);
+    EXPECT_EQ(book_->rejected_updates(), 0u);
+    EXPECT_EQ(book_->get_pools(1, 2).size(), kPerPair);
+    EXPECT_EQ(book_->find_pool(OrderBook::MAX_POOLS)->reserve1, 1000 + OrderBook::MAX_POOLS - 1);
+
+    // Pool storage, not column storage, is what runs out
+    book_->update_pool(make_update(OrderBook::MAX_POOLS + 1, 1, 2, 1000, 1000));
+    EXPECT_EQ(book_->rejected_updates(), 1u);
+}
+
+TEST_F(OrderBookTest, ProcessUpdatesDrainsQueue) {
+    auto queue = std::make_unique<PriceQueue>();
+    for (uint64_t i = 0; i < 10; ++i) {
+        ASSERT_TRUE(queue->push(make_update(0x100 + i, 1, 2 + i, 1000, 1000)));
+    }
+
+    EXPECT_EQ(book_->process_updates(*queue), 10u);
+    EXPECT_EQ(book_->pool_count(), 10u);
+    EXPECT_EQ(book_->token_count(), 11u);
+    EXPECT_TRUE(queue->empty());
+}
+
+TEST_F(OrderBookTest, DirtySetListsEachUpdatedPoolOnce) {
+    book_->update_pool(make_update(0xA1, 1, 2, 1000, 2000));
+    book_->update_pool(make_update(0xA2, 1, 3, 1000, 2000));
+    book_->update_pool(make_update(0xA1, 1, 2, 1100, 1900));
+
+    const auto dirty = book_->dirty_pools();
+    ASSERT_EQ(dirty.size(), 2u);
+    EXPECT_EQ(dirty[0], book_->find_pool_id(0xA1));
+    EXPECT_EQ(dirty[1], book_->find_pool_id(0xA2));
+
+    book_->clear_dirty();
+    EXPECT_TRUE(book_->dirty_pools().empty());
+
+    book_->update_pool(make_update(0xA2, 1, 3, 900, 2100));
+    ASSERT_EQ(book_->dirty_pools().size(), 1u);
+    EXPECT_EQ(book_->dirty_pools()[0], book_->find_pool_id(0xA2));
+}
+
+TEST_F(OrderBookTest, RepeatedUpdatesInOneBatchCoalesce) {
+    book_->update_pool(make_update(0xA1, 1, 2, 1000, 2000));
+    book_->update_pool(make_update(0xA1, 1, 2, 1100, 2100));
+    book_->update_pool(make_update(0xA1, 1, 2, 1200, 2200));
+    book_->update_pool(make_update(0xA2, 1, 3, 1000, 2000));
+
+    EXPECT_EQ(book_->dirty_pools().size(), 2u);
+    EXPECT_EQ(book_->coalesced_updates(), 2u);
+    EXPECT_EQ(book_->find_pool(0xA1)->reserve0, 1200u);
+
+    // Next batch: the first update of a pool is not a coalescing
+    book_->clear_dirty();
+    book_->update_pool(make_update(0xA1, 1, 2, 1300, 2300));
+    EXPECT_EQ(book_->coalesced_updates(), 2u);
+}
+
+TEST_F(OrderBookTest, GetPoolsByChainFilters) {
+    auto update = make_update(0xA1, 1, 2, 1000, 2000);
+    book_->update_pool(update);
+    update.pool_hash = 0xB1;
+    update.chain_id = static_cast<uint32_t>(ChainId::ARBITRUM);
+    book_->update_pool(update);
+
+    EXPECT_EQ(book_->get_pools_by_chain(ChainId::ETHEREUM).size(), 1u);
+    EXPECT_EQ(book_->get_pools_by_chain(ChainId::ARBITRUM).size(), 1u);
+    EXPECT_TRUE(book_->get_pools_by_chain(ChainId::BASE).empty());
+}
+
+TEST_F(OrderBookTest, RejectsPoolsOnceTokenIndexIsFull) {
+    // Each pool introduces two fresh tokens
+    for (uint64_t i = 0; i < OrderBook::MAX_TOKENS / 2; ++i) {
+        book_->update_pool(make_update(i + 1, 2 * i + 1, 2 * i + 2, 1, 1));
+    }
+    EXPECT_EQ(book_->token_count(), OrderBook::MAX_TOKENS);
+    EXPECT_EQ(book_->rejected_updates(), 0u);
+
+    book_->update_pool(make_update(0xFFFF'FFFF, 0xDEAD, 0xBEEF, 1, 1));
+    EXPECT_EQ(book_->rejected_updates(), 1u);
+    EXPECT_FALSE(book_->find_pool(0xFFFF'FFFF).has_value());
+
+    // Pools between already-known tokens are still accepted
+    book_->update_pool(make_update(0xFFFF'FFFE, 1, 4, 1, 1));
+    EXPECT_TRUE(book_->find_pool(0xFFFF'FFFE).has_value());
+}
+
+TEST_F(OrderBookTest, ReadersSeeWholeUpdatesWhileTheWriterRuns) {
+    // Every update keeps reserve1 == 3 * reserve0; a torn read breaks it.
+    // New pools keep landing on pair (1, 2), so its segment moves under
+    // the readers too.
+    constexpr uint64_t kPools = 512;
+    constexpr uint64_t kRounds = 200;
+    const auto update = [](uint64_t pool, uint64_t k) {
+        return pool % 2 ? make_update(0x5000 + pool, 2, 1, 3 * k, k, k)      // Reversed order
+                        : make_update(0x5000 + pool, 1, 2, k, 3 * k, k);
+    };
+    book_->update_pool(update(0, 1));
+
+    std::atomic<bool> done{false};
+    std::atomic<int> started{0};
+    std::atomic<uint64_t> torn{0};
+    std::atomic<uint64_t> reads{0};
+    const auto reader = [&] {
+        uint64_t local_reads = 0;
+        started.fetch_add(1, std::memory_order_release);
+        do {
+            const auto pools = static_cast<uint32_t>(book_->pool_count());
+            for (uint32_t id = 0; id < pools; ++id) {
+                const PoolState pool = book_->pool(id);
+                torn.fetch_add(pool.reserve1 != 3 * pool.reserve0 && pool.reserve0 != 3 * pool.reserve1,
+                               std::memory_order_relaxed);
+            }
+            for (const PoolState& pool : book_->get_pools(1, 2)) {
+                const uint64_t lo = std::min(pool.reserve0, pool.reserve1);
+                torn.fetch_add(std::max(pool.reserve0, pool.reserve1) != 3 * lo, std::memory_order_relaxed);
+            }
+            const uint32_t last = book_->find_pool_id(0x5000 + pools - 1);
+            torn.fetch_add(last == OrderBook::INVALID_INDEX || last >= book_->pool_count(),
+                           std::memory_order_relaxed);
+            local_reads += pools;
+        } while (!done.load(std::memory_order_acquire));
+        reads.fetch_add(local_reads, std::memory_order_relaxed);
+    };
+    std::thread readers[] = {std::thread(reader), std::thread(reader)};
+    while (started.load(std::memory_order_acquire) < 2) std::this_thread::yield();
+
+    for (uint64_t round = 1; round <= kRounds; ++round) {
+        const uint64_t live = std::min<uint64_t>(kPools, 1 + round * kPools / kRounds);
+        for (uint64_t pool = 0; pool < live; ++pool) {
+            book_->update_pool(update(pool, round * 1000 + pool));
+        }
+        book_->clear_dirty();
+        if (round % 16 == 0) std::this_thread::yield();  // Interleave on a single core too
+    }
+    done.store(true, std::memory_order_release);
+    for (auto& t : readers) t.join();
+
+    EXPECT_EQ(torn.load(), 0u);
+    EXPECT_GT(reads.load(), 0u);
+    EXPECT_EQ(book_->pool_count(), kPools);
+    EXPECT_EQ(book_->get_pools(1, 2).size(), kPools);
+}
+
+TEST_F(OrderBookTest, BestPoolSelectionScoresWholeUpdates) {
+    // Pool 0xB0 always prices token 2 at 4 per token 1; the others at 3,
+    // with depth flipping between shallow and deep on every update. A torn
+    // read (shallow input, deep output) would price one far above 4.
+    constexpr uint64_t kFlipping = 16;
+    constexpr uint64_t kRounds = 2000;
+    book_->update_pool(make_update(0xB0, 1, 2, 1'000'000, 4'000'000));
+    for (uint64_t pool = 0; pool < kFlipping; ++pool) {
+        book_->update_pool(make_update(0xB1 + pool, 1, 2, 1000, 3000));
+    }
+
+    std::atomic<bool> done{false};
+    std::atomic<int> started{0};
+    std::atomic<uint64_t> wrong{0};
+    const auto reader = [&] {
+        started.fetch_add(1, std::memory_order_release);
+        do {
+            const auto best = book_->get_best_pool_for_amount(1, 2, 1);
+            wrong.fetch_add(!best || best->pool_address_hash != 0xB0, std::memory_order_relaxed);
+        } while (!done.load(std::memory_order_acquire));
+    };
+    std::thread readers[] = {std::thread(reader), std::thread(reader)};
+    while (started.load(std::memory_order_acquire) < 2) std::this_thread::yield();
+
+    for (uint64_t round = 1; round <= kRounds; ++round) {
+        const uint64_t reserve = round % 2 ? 1'000'000'000 : 1000;
+        for (uint64_t pool = 0; pool < kFlipping; ++pool) {
+            book_->update_pool(make_update(0xB1 + pool, 1, 2, reserve, 3 * reserve));
+        }
+        // Worse pools keep joining, so the pair's segment moves too
+        if (round % 100 == 0) book_->update_pool(make_update(0xC000 + round, 1, 2, 1000, 2000));
+        book_->clear_dirty();
+        if (round % 64 == 0) std::this_thread::yield();
+    }
+    done.store(true, std::memory_order_release);
+    for (auto& t : readers) t.join();
+
+    EXPECT_EQ(wrong.load(), 0u);
+}
+
+TEST_F(OrderBookTest, PoolRangeOutlivesSegmentMoves) {
+    book_->update_pool(make_update(0xA1, 1, 2, 1000, 2000));
+    const PoolRange before = book_->get_pools(1, 2);
+
+    // Outgrow the segment: it moves, the old view keeps its pool readable
+    book_->update_pool(make_update(0xA2, 1, 2, 1000, 2000));
+    book_->update_pool(make_update(0xA3, 1, 2, 1000, 2000));
+    ASSERT_NE(book_->get_pools(1, 2).first_slot(), before.first_slot());
+    ASSERT_EQ(before.size(), 1u);
+    EXPECT_EQ((*before.begin()).pool_address_hash, 0xA1u);
+
+    // Updates go to the new slot; pool() and fresh ranges see them
+    book_->update_pool(make_update(0xA1, 1, 2, 5000, 6000));
+    EXPECT_EQ(book_->pool(book_->find_pool_id(0xA1)).reserve0, 5000u);
+    EXPECT_EQ((*book_->get_pools(1, 2).begin()).reserve0, 5000u);
+    EXPECT_EQ((*before.begin()).reserve0, 1000u);
+}
+
+// ============================================================================
+// Snapshots
+// ============================================================================
+
+namespace {
+
+std::vector<std::byte> snapshot_image(const OrderBook& book) {
+    std::vector<std::byte> image(book.snapshot_size());
+    EXPECT_EQ(book.write_snapshot(image), image.size());
+    EXPECT_TRUE(seal_snapshot(image));
+    return image;
+}
+
+void fill_book(OrderBook& book, uint64_t pools) {
+    for (uint64_t i = 0; i < pools; ++i) {
+        book.update_pool(make_update(0x1000 + i, 1 + i % 7, 2 + i % 5, 1000 + i, 2000 + i, 10 + i));
+    }
+}
+
+} // namespace
+
+TEST_F(OrderBookTest, SnapshotRestoresPoolsIndexesAndTokens) {
+    fill_book(*book_, 64);
+    const auto image = snapshot_image(*book_);
+
+    memory::Arena arena;
+    OrderBook restored(arena);
+    ASSERT_TRUE(restored.restore_snapshot(image));
+
+    EXPECT_EQ(restored.pool_count(), book_->pool_count());
+    EXPECT_EQ(restored.token_count(), book_->token_count());
+    EXPECT_EQ(restored.last_update_ns(), book_->last_update_ns());
+    for (uint64_t i = 0; i < 64; ++i) {
+        const auto original = book_->find_pool(0x1000 + i);
+        const auto copy = restored.find_pool(0x1000 + i);
+        ASSERT_TRUE(copy.has_value());
+        EXPECT_EQ(copy->reserve0, original->reserve0);
+        EXPECT_EQ(copy->reserve1, original->reserve1);
+        EXPECT_EQ(restored.find_pool_id(0x1000 + i), book_->find_pool_id(0x1000 + i));
+    }
+    for (uint64_t token = 1; token <= 8; ++token) {
+        EXPECT_EQ(restored.token_id(token), book_->token_id(token));
+    }
+    EXPECT_EQ(restored.get_pools(1, 2).size(), book_->get_pools(1, 2).size());
+    EXPECT_EQ(restored.dirty_pools().size(), restored.pool_count());
+
+    // The restored book keeps working: updates land in place, new pools append
+    restored.clear_dirty();
+    restored.update_pool(make_update(0x1000, 1, 2, 5, 6, 100));
+    restored.update_pool(make_update(0x9999, 1, 9, 7, 8, 101));
+    EXPECT_EQ(restored.find_pool(0x1000)->reserve0, 5u);
+    EXPECT_EQ(restored.pool_count(), book_->pool_count() + 1);
+    EXPECT_EQ(restored.dirty_pools().size(), 2u);
+}
+
+TEST_F(OrderBookTest, SnapshotRejectsCorruptImagesAndNonEmptyBooks) {
+    fill_book(*book_, 16);
+    auto image = snapshot_image(*book_);
+    EXPECT_TRUE(verify_snapshot(image));
+
+    // A book that already has pools is left alone
+    EXPECT_FALSE(book_->restore_snapshot(image));
+
+    memory::Arena arena;
+    OrderBook restored(arena);
+    image[image.size() / 2] ^= std::byte{0x40};
+    EXPECT_FALSE(verify_snapshot(image));
+    EXPECT_FALSE(restored.restore_snapshot(image));
+    EXPECT_FALSE(restored.restore_snapshot(std::span(image).first(sizeof(BookSnapshotHeader) - 1)));
+    EXPECT_EQ(restored.pool_count(), 0u);
+    EXPECT_FALSE(restored.find_pool(0x1000).has_value());
+}
+
+TEST_F(OrderBookTest, SnapshotFileMapsBackIntoABook) {
+    const std::string path = ::testing::TempDir() + "matrix_book.snap";
+    fill_book(*book_, 32);
+    ASSERT_TRUE(save_snapshot(*book_, path));
+
+    {
+        MappedSnapshot mapped(path);
+        EXPECT_EQ(mapped.bytes().size(), book_->snapshot_size());
+        EXPECT_TRUE(verify_snapshot(mapped.bytes()));
+    }
+
+    memory::Arena arena;
+    OrderBook restored(arena);
+    ASSERT_TRUE(load_snapshot(restored, path));
+    EXPECT_EQ(restored.pool_count(), 32u);
+    EXPECT_EQ(restored.find_pool(0x1010)->reserve1, book_->find_pool(0x1010)->reserve1);
+
+    EXPECT_FALSE(load_snapshot(restored, path + ".missing"));
+    EXPECT_THROW(MappedSnapshot(path + ".missing"), std::runtime_error);
+    std::remove(path.c_str());
+}
+
+TEST_F(OrderBookTest, SnapshotWriterWritesCapturesInTheBackground) {
+    const std::string path = ::testing::TempDir() + "matrix_book_writer.snap";
+    std::remove(path.c_str());
+    fill_book(*book_, 8);
+
+    uint64_t captured = 0;
+    {
+        SnapshotWriter writer(*book_, path);
+        captured += writer.capture();
+        for (int i = 0; i < 200 && writer.written() == 0; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        EXPECT_EQ(writer.written(), 1u);
+
+        // Keeps mutating while writes are in flight; the last capture wins
+        fill_book(*book_, 24);
+        captured += writer.capture();
+        captured += writer.capture();
+        EXPECT_EQ(captured + writer.skipped(), 3u);
+    }   // Flushes the pending capture
+
+    memory::Arena arena;
+    OrderBook restored(arena);
+    ASSERT_TRUE(load_snapshot(restored, path));
+    EXPECT_EQ(restored.pool_count(), 24u);
+    std::remove(path.c_str());
+}
+
+TEST_F(OrderBookTest, SnapshotCopiedOffThreadIsConsistent) {
+    // As in the reader test, reserve1 == 3 * reserve0 and pool (1, 2)'s
+    // segment keeps moving; every image a copier thread gets must restore
+    // to whole updates and a complete topology
+    constexpr uint64_t kPools = 512;
+    constexpr uint64_t kRounds = 200;
+    const auto update = [](uint64_t pool, uint64_t k) {
+        return pool % 2 ? make_update(0x5000 + pool, 2, 1, 3 * k, k, k)
+                        : make_update(0x5000 + pool, 1, 2, k, 3 * k, k);
+    };
+    book_->update_pool(update(0, 1));
+
+    std::atomic<bool> done{false};
+    std::atomic<bool> started{false};
+    std::vector<std::vector<std::byte>> images;
+    std::thread copier([&] {
+        std::vector<std::byte> buffer(book_->max_snapshot_size());
+        started.store(true, std::memory_order_release);
+        do {
+            const size_t length = book_->write_snapshot(buffer);
+            if (length != 0 && images.size() < 16) images.emplace_back(buffer.begin(), buffer.begin() + length);
+        } while (!done.load(std::memory_order_acquire));
+    });
+    while (!started.load(std::memory_order_acquire)) std::this_thread::yield();
+
+    for (uint64_t round = 1; round <= kRounds; ++round) {
+        const uint64_t live = std::min<uint64_t>(kPools, 1 + round * kPools / kRounds);
+        for (uint64_t pool = 0; pool < live; ++pool) {
+            book_->update_pool(update(pool, round * 1000 + pool));
+        }
+        book_->clear_dirty();
+        if (round % 16 == 0) std::this_thread::yield();
+    }
+    done.store(true, std::memory_order_release);
+    copier.join();
+
+    ASSERT_FALSE(images.empty());
+    for (auto& image : images) {
+        ASSERT_TRUE(seal_snapshot(image));
+        memory::Arena arena;
+        OrderBook restored(arena);
+        ASSERT_TRUE(restored.restore_snapshot(image));
+        EXPECT_EQ(restored.get_pools(1, 2).size(), restored.pool_count());
+        for (uint32_t id = 0; id < restored.pool_count(); ++id) {
+            const PoolState pool = restored.pool(id);
+            EXPECT_EQ(pool.pool_address_hash, 0x5000u + id);
+            EXPECT_TRUE(pool.reserve1 == 3 * pool.reserve0 || pool.reserve0 == 3 * pool.reserve1);
+        }
+    }
+}
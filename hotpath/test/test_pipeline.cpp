@@ -0,0 +1,420 @@
+/**
+ * Unit tests for the per-chain scan pipeline
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "arbitrage/Calculator.hpp"
+#include "orderbook/MPMCQueue.hpp"
+#include "runtime/EventLog.hpp"
+#include "runtime/Pipeline.hpp"
+#include "runtime/Replay.hpp"
+#include "runtime/WorkStealingPool.hpp"
+
+using namespace matrix;
+using namespace matrix::arbitrage;
+using namespace matrix::orderbook;
+using namespace matrix::runtime;
+
+namespace {
+
+PriceUpdate make_update(uint64_t pool, uint64_t token0, uint64_t token1,
+                        uint64_t reserve0, uint64_t reserve1, ChainId chain) {
+    PriceUpdate update{};
+    update.timestamp_ns = 1;
+    update.pool_hash = pool;
+    update.chain_id = static_cast<uint32_t>(chain);
+    update.dex_id = static_cast<uint32_t>(DexId::UNISWAP_V3);
+    update.token0 = token0;
+    update.token1 = token1;
+    update.reserve0 = reserve0;
+    update.reserve1 = reserve1;
+    return update;
+}
+
+PipelineConfig two_chain_config() {
+    PipelineConfig config;
+    config.shards.push_back({ChainId::ETHEREUM});
+    config.shards.push_back({ChainId::ARBITRUM});
+    return config;
+}
+
+// Spin until `done` holds or a generous deadline passes
+template<typename Pred>
+bool wait_for(Pred done) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!done()) {
+        if (std::chrono::steady_clock::now() > deadline) return false;
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    return true;
+}
+
+// WETH -> USDC -> DAI -> WETH gains through the cheap USDC pool
+void push_profitable_triangle(std::vector<PriceUpdate>& out, uint64_t base, ChainId chain, uint64_t salt) {
+    constexpr uint64_t kUsdc = 0x100;
+    constexpr uint64_t kDai = 0x200;
+    out.push_back(make_update(salt + 1, base, kUsdc, 1'000'000, 2'000'000, chain));
+    out.push_back(make_update(salt + 2, kUsdc, kDai, 1'000'000, 1'000'000, chain));
+    out.push_back(make_update(salt + 3, kDai, base, 1'000'000, 1'000'000, chain));
+}
+
+} // namespace
+
+TEST(PipelineTest, RejectsDuplicateChains) {
+    PipelineConfig config;
+    config.shards.push_back({ChainId::ETHEREUM});
+    config.shards.push_back({ChainId::ETHEREUM});
+    EXPECT_THROW(Pipeline{config}, std::invalid_argument);
+}
+
+TEST(PipelineTest, RouteDemuxesUpdatesByChain) {
+    Pipeline pipeline(two_chain_config());
+    pipeline.start();
+
+    std::vector<PriceUpdate> updates;
+    push_profitable_triangle(updates, WETH_MAINNET, ChainId::ETHEREUM, 0xE00);
+    updates.push_back(make_update(0xA01, 0x300, 0x400, 1000, 1000, ChainId::ARBITRUM));
+    for (const auto& update : updates) {
+        EXPECT_TRUE(pipeline.route(update));
+    }
+    // No shard serves BASE
+    EXPECT_FALSE(pipeline.route(make_update(0xB01, 0x300, 0x400, 1000, 1000, ChainId::BASE)));
+    EXPECT_EQ(pipeline.unrouted_updates(), 1u);
+
+    ASSERT_TRUE(wait_for([&] {
+        return pipeline.shard_stats(0).pool_count == 3 && pipeline.shard_stats(1).pool_count == 1;
+    }));
+
+    // Only the Ethereum shard sees the triangle
+    std::vector<Opportunity> found;
+    ASSERT_TRUE(wait_for([&] {
+        pipeline.drain_opportunities([&](const Opportunity& opp) { found.push_back(opp); });
+        return !found.empty();
+    }));
+    for (const auto& opp : found) {
+        EXPECT_EQ(opp.chain, ChainId::ETHEREUM);
+        EXPECT_EQ(opp.path_length, 3u);
+        EXPECT_GT(opp.profit_wei, 0u);
+    }
+    EXPECT_EQ(pipeline.shard_stats(1).opportunities, 0u);
+
+    pipeline.stop();
+    EXPECT_FALSE(pipeline.running());
+}
+
+TEST(PipelineTest, RouterDrainsFeedQueue) {
+    auto feed = std::make_unique<PriceFeedQueue>();
+    auto producer = feed->add_producer();
+    Pipeline pipeline(two_chain_config());
+    pipeline.start(*feed);
+
+    std::vector<PriceUpdate> updates;
+    push_profitable_triangle(updates, WETH_MAINNET, ChainId::ETHEREUM, 0xE00);
+    push_profitable_triangle(updates, WETH_ARBITRUM, ChainId::ARBITRUM, 0xA00);
+    for (const auto& update : updates) {
+        ASSERT_TRUE(producer.push(update));
+    }
+
+    ASSERT_TRUE(wait_for([&] {
+        return pipeline.shard_stats(0).updates_processed == 3 &&
+               pipeline.shard_stats(1).updates_processed == 3;
+    }));
+    EXPECT_TRUE(feed->empty());
+
+    // Each chain's triangle is found by its own shard
+    bool seen_eth = false;
+    bool seen_arb = false;
+    ASSERT_TRUE(wait_for([&] {
+        pipeline.drain_opportunities([&](const Opportunity& opp) {
+            seen_eth |= opp.chain == ChainId::ETHEREUM;
+            seen_arb |= opp.chain == ChainId::ARBITRUM;
+        });
+        return seen_eth && seen_arb;
+    }));
+}
+
+TEST(PipelineTest, RouterConflatesBurstsPerPool) {
+    auto feed = std::make_unique<PriceFeedQueue>();
+    auto producer = feed->add_producer();
+
+    // Queued before the router starts, so it sees the burst in one batch
+    std::vector<PriceUpdate> updates;
+    push_profitable_triangle(updates, WETH_MAINNET, ChainId::ETHEREUM, 0xE00);
+    for (uint64_t i = 0; i < 5; ++i) {
+        updates.push_back(make_update(0xE01, WETH_MAINNET, 0x100, 1'000'000, 2'000'000 + i, ChainId::ETHEREUM));
+    }
+    for (const auto& update : updates) {
+        ASSERT_TRUE(producer.push(update));
+    }
+
+    Pipeline pipeline(two_chain_config());
+    pipeline.start(*feed);
+
+    ASSERT_TRUE(wait_for([&] {
+        const auto stats = pipeline.shard_stats(0);
+        return stats.updates_conflated == 5 && stats.pool_count == 3;
+    }));
+    EXPECT_EQ(pipeline.shard_stats(0).updates_processed, 3u);
+}
+
+// ============================================================================
+// EventLog Tests
+// ============================================================================
+
+namespace {
+
+Opportunity make_opportunity(uint64_t id) {
+    Opportunity opp{};
+    opp.id = id;
+    opp.timestamp_ns = 1;
+    opp.profit_wei = id * 1'000'000'000'000'000ULL;
+    opp.gas_estimate = 250'000;
+    opp.chain = ChainId::ARBITRUM;
+    opp.path_length = 3;
+    return opp;
+}
+
+} // namespace
+
+TEST(PipelineTest, ShardWarmStartsFromItsSnapshot) {
+    const std::string path = ::testing::TempDir() + "matrix_shard.snap";
+    std::remove(path.c_str());
+    PipelineConfig config;
+    ShardConfig shard{ChainId::ETHEREUM};
+    shard.snapshot_path = path;
+    shard.snapshot_interval_ms = 0;  // Only the snapshot taken on stop
+    config.shards.push_back(shard);
+
+    {
+        Pipeline pipeline(config);
+        pipeline.start();
+        std::vector<PriceUpdate> updates;
+        push_profitable_triangle(updates, WETH_MAINNET, ChainId::ETHEREUM, 0xE00);
+        for (const auto& update : updates) {
+            EXPECT_TRUE(pipeline.route(update));
+        }
+        ASSERT_TRUE(wait_for([&] { return pipeline.shard_stats(0).pool_count == 3; }));
+        EXPECT_EQ(pipeline.shard_stats(0).restored_pools, 0u);
+        pipeline.stop();
+    }
+
+    // The restart has the pools before any update arrives
+    Pipeline pipeline(config);
+    pipeline.start();
+    EXPECT_EQ(pipeline.shard_stats(0).restored_pools, 3u);
+    EXPECT_EQ(pipeline.shard_stats(0).pool_count, 3u);
+
+    // The first update re-scans every restored pool
+    std::vector<PriceUpdate> updates;
+    push_profitable_triangle(updates, WETH_MAINNET, ChainId::ETHEREUM, 0xE00);
+    EXPECT_TRUE(pipeline.route(updates[0]));
+    std::vector<Opportunity> found;
+    ASSERT_TRUE(wait_for([&] {
+        pipeline.drain_opportunities([&](const Opportunity& opp) { found.push_back(opp); });
+        return !found.empty();
+    }));
+    pipeline.stop();
+    std::remove(path.c_str());
+}
+
+TEST(EventLogTest, FormatsEachRecordKind) {
+    char line[256];
+    EventLog::format(LogRecord::from(make_opportunity(7)), line, sizeof(line));
+    EXPECT_NE(std::string(line).find("[OPPORTUNITY] Chain=42161 Id=7 Profit=7 finney Path=3 hops"), std::string::npos)
+        << line;
+
+    ShardStats stats{};
+    stats.updates_processed = 10;
+    stats.updates_conflated = 2;
+    stats.updates_coalesced = 1;
+    stats.pool_count = 4;
+    EventLog::format(LogRecord::from(ChainId::ETHEREUM, stats), line, sizeof(line));
+    EXPECT_NE(std::string(line).find("[STATS] Chain=1 Updates=10 Dropped=0 Conflated=3 Scans=0 Pools=4"),
+              std::string::npos) << line;
+
+    telemetry::LatencyHistogram histogram;
+    histogram.record(20);
+    telemetry::LatencyHistogram::Snapshot latency;
+    histogram.add_to(latency);
+    EventLog::format(LogRecord::from(telemetry::Stage::SCAN, latency), line, sizeof(line));
+    EXPECT_STREQ(line, "[LATENCY] scan n=1 p50=20 p99=20 p99.9=20 max=20ns");
+
+    // Truncates to the buffer
+    char small[12];
+    EXPECT_EQ(EventLog::format(LogRecord::from(make_opportunity(1)), small, sizeof(small)), sizeof(small) - 1);
+    EXPECT_EQ(std::string(small), "[OPPORTUNIT");
+}
+
+TEST(EventLogTest, WriterDrainsRingAndJournalReplays) {
+    const std::string text_path = ::testing::TempDir() + "matrix_event_log.txt";
+    const std::string journal_path = ::testing::TempDir() + "matrix_event_log.bin";
+    std::remove(journal_path.c_str());
+
+    constexpr uint64_t RECORDS = 1000;
+    std::FILE* text = std::fopen(text_path.c_str(), "w+");
+    ASSERT_NE(text, nullptr);
+    {
+        EventLogConfig config;
+        config.text = text;
+        config.journal_path = journal_path;
+        EventLog log(config);
+        for (uint64_t i = 1; i <= RECORDS; ++i) {
+            ASSERT_TRUE(log.log(make_opportunity(i)));
+        }
+        log.stop();                                 // Writes out everything queued
+        EXPECT_EQ(log.written(), RECORDS);
+        EXPECT_EQ(log.dropped(), 0u);
+    }
+
+    std::rewind(text);
+    size_t lines = 0;
+    char line[256];
+    while (std::fgets(line, sizeof(line), text)) ++lines;
+    std::fclose(text);
+    std::remove(text_path.c_str());
+    EXPECT_EQ(lines, RECORDS);
+
+    uint64_t expected = 1;
+    const int64_t replayed = EventLog::replay(journal_path, [&](const LogRecord& record) {
+        EXPECT_EQ(record.kind, LogKind::OPPORTUNITY);
+        EXPECT_EQ(record.chain, static_cast<uint32_t>(ChainId::ARBITRUM));
+        EXPECT_EQ(record.opportunity.id, expected++);
+        EXPECT_GT(record.logged_ns, 0u);
+    });
+    EXPECT_EQ(replayed, static_cast<int64_t>(RECORDS));
+
+    // A second run appends to the same journal
+    {
+        EventLogConfig config;
+        config.text = nullptr;
+        config.journal_path = journal_path;
+        EventLog log(config);
+        ASSERT_TRUE(log.log(make_opportunity(RECORDS + 1)));
+    }
+    EXPECT_EQ(EventLog::replay(journal_path, [](const LogRecord&) {}), static_cast<int64_t>(RECORDS + 1));
+    std::remove(journal_path.c_str());
+
+    EXPECT_EQ(EventLog::replay(journal_path, [](const LogRecord&) {}), -1);
+    EventLogConfig bad;
+    bad.journal_path = "/nonexistent-dir/journal.bin";
+    EXPECT_THROW(EventLog{bad}, std::runtime_error);
+}
+
+// ============================================================================
+// Replay Tests
+// ============================================================================
+
+TEST(ReplayTest, TraceFilesRoundTrip) {
+    SyntheticTraceConfig config;
+    config.blocks = 4;
+    const auto trace = synthesize_trace(config);
+    ASSERT_EQ(trace.size(), config.pools + config.blocks * config.updates_per_block);
+    EXPECT_EQ(synthesize_trace(config).back().reserve0, trace.back().reserve0);   // Deterministic
+
+    const std::string path = ::testing::TempDir() + "matrix_replay_trace.bin";
+    ASSERT_TRUE(save_trace(path, trace));
+    const auto loaded = load_trace(path);
+    ASSERT_EQ(loaded.size(), trace.size());
+    for (size_t i = 0; i < trace.size(); ++i) {
+        ASSERT_EQ(loaded[i].pool_hash, trace[i].pool_hash);
+        ASSERT_EQ(loaded[i].timestamp_ns, trace[i].timestamp_ns);
+        ASSERT_EQ(loaded[i].reserve1, trace[i].reserve1);
+    }
+    std::remove(path.c_str());
+
+    EXPECT_THROW((void)load_trace(path), std::runtime_error);
+    config.tokens = 1;
+    EXPECT_THROW((void)synthesize_trace(config), std::invalid_argument);
+}
+
+TEST(ReplayTest, ReplayIsDeterministicAcrossSpeeds) {
+    SyntheticTraceConfig trace_config;
+    trace_config.blocks = 8;
+    trace_config.block_interval_ns = 2'000'000;     // 8 blocks in ~16 ms
+    const auto trace = synthesize_trace(trace_config);
+
+    ReplayConfig config;
+    config.gas_price_gwei = 0;                      // Compose everything found
+    ReplayHarness fast(config);
+    const ReplayReport a = fast.run(trace);
+
+    config.speed = 1.0;
+    ReplayHarness paced(config);
+    const ReplayReport b = paced.run(trace);
+
+    EXPECT_EQ(a.updates, trace.size());
+    EXPECT_EQ(a.batches, 1 + trace_config.blocks);  // Seed block (256 pools) + one per burst
+    EXPECT_GT(a.opportunities, 0u);
+    EXPECT_GT(a.transactions, 0u);
+    EXPECT_EQ(a.updates, b.updates);
+    EXPECT_EQ(a.batches, b.batches);
+    EXPECT_EQ(a.opportunities, b.opportunities);
+    EXPECT_EQ(a.transactions, b.transactions);
+    EXPECT_EQ(a.checksum, b.checksum);
+    EXPECT_GE(b.wall_ns, trace.back().timestamp_ns - trace.front().timestamp_ns);
+    EXPECT_EQ(fast.book().pool_count(), trace_config.pools);
+
+    telemetry::Snapshot stages;
+    telemetry::LatencyHistogram::Snapshot end_to_end;
+    fast.snapshot(stages, end_to_end);
+    EXPECT_EQ(end_to_end.count, a.batches);
+    EXPECT_EQ(stages[static_cast<size_t>(telemetry::Stage::SCAN)].count, a.batches);
+    EXPECT_EQ(stages[static_cast<size_t>(telemetry::Stage::COMPOSE)].count, a.transactions);
+    EXPECT_EQ(stages[static_cast<size_t>(telemetry::Stage::SIGN)].count, 0u);
+}
+
+// ============================================================================
+// WorkStealingPool
+// ============================================================================
+
+TEST(WorkStealingPoolTest, RunsEveryTaskOnceAcrossRuns) {
+    WorkStealingPool pool(4);
+    constexpr size_t kTasks = 1000;
+    auto hits = std::make_unique<std::atomic<uint32_t>[]>(kTasks);
+
+    for (int round = 0; round < 20; ++round) {
+        const size_t tasks = kTasks - static_cast<size_t>(round) * 37;
+        std::atomic<uint64_t> spread[WorkStealingPool::MAX_WORKERS] = {};
+        pool.run(tasks, [&](size_t worker, size_t task) noexcept {
+            hits[task].fetch_add(1, std::memory_order_relaxed);
+            spread[worker].fetch_add(1, std::memory_order_relaxed);
+            // The first worker's tasks are the expensive ones
+            if (task < tasks / 4) std::this_thread::sleep_for(std::chrono::microseconds(20));
+        });
+
+        uint64_t total = 0;
+        for (size_t w = 0; w < pool.workers(); ++w) total += spread[w].load();
+        EXPECT_EQ(total, tasks);
+        for (size_t t = 0; t < tasks; ++t) {
+            ASSERT_EQ(hits[t].exchange(0), 1u) << "round " << round << " task " << t;
+        }
+    }
+    pool.run(0, [](size_t, size_t) noexcept {});
+}
+
+TEST(WorkStealingPoolTest, SingleWorkerRunsInline) {
+    WorkStealingPool pool(1);
+    const auto caller = std::this_thread::get_id();
+    size_t ran = 0;
+    pool.run(64, [&](size_t worker, size_t task) noexcept {
+        EXPECT_EQ(worker, 0u);
+        EXPECT_EQ(std::this_thread::get_id(), caller);
+        EXPECT_EQ(task, ran);   // In order, nobody to steal
+        ++ran;
+    });
+    EXPECT_EQ(ran, 64u);
+    EXPECT_EQ(pool.steals(), 0u);
+
+    EXPECT_THROW(WorkStealingPool(0), std::invalid_argument);
+    EXPECT_THROW(WorkStealingPool(WorkStealingPool::MAX_WORKERS + 1), std::invalid_argument);
+}
@@ -0,0 +1,175 @@
+/**
+ * Unit tests for the latency histogram, TSC clock and stage recorders
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <initializer_list>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "telemetry/Telemetry.hpp"
+
+using namespace matrix::telemetry;
+
+namespace {
+
+// ============================================================================
+// LatencyHistogram Tests
+// ============================================================================
+
+TEST(LatencyHistogramTest, BucketsCoverEveryValueWithBoundedError) {
+    for (const uint64_t value : std::initializer_list<uint64_t>{0, 1, 31, 32, 33, 63, 64, 1000,
+                                123456, 999999999, LatencyHistogram::MAX_VALUE}) {
+        const size_t bucket = LatencyHistogram::bucket_of(value);
+        ASSERT_LT(bucket, LatencyHistogram::BUCKETS);
+        EXPECT_LE(LatencyHistogram::bucket_lower(bucket), value);
+        EXPECT_GE(LatencyHistogram::bucket_upper(bucket), value);
+        const uint64_t width = LatencyHistogram::bucket_upper(bucket) - LatencyHistogram::bucket_lower(bucket);
+        EXPECT_LE(width * 32, std::max<uint64_t>(value, 32));
+    }
+    EXPECT_EQ(LatencyHistogram::bucket_of(~0ULL), LatencyHistogram::bucket_of(LatencyHistogram::MAX_VALUE));
+
+    // Buckets tile the range without gaps
+    for (size_t b = 1; b < LatencyHistogram::BUCKETS; ++b) {
+        ASSERT_EQ(LatencyHistogram::bucket_lower(b), LatencyHistogram::bucket_upper(b - 1) + 1) << b;
+    }
+}
+
+TEST(LatencyHistogramTest, PercentilesTrackExactValues) {
+    LatencyHistogram histogram;
+    std::mt19937_64 rng(7);
+    std::lognormal_distribution<double> dist(8.0, 1.5);
+    std::vector<uint64_t> values;
+    for (int i = 0; i < 100000; ++i) {
+        const auto v = static_cast<uint64_t>(dist(rng));
+        values.push_back(v);
+        histogram.record(v);
+    }
+    std::sort(values.begin(), values.end());
+
+    LatencyHistogram::Snapshot snap;
+    histogram.add_to(snap);
+    EXPECT_EQ(snap.count, values.size());
+    EXPECT_EQ(snap.max, values.back());
+
+    for (const double q : {0.5, 0.9, 0.99, 0.999}) {
+        const auto exact = static_cast<double>(values[static_cast<size_t>(q * values.size()) - 1]);
+        const auto approx = static_cast<double>(snap.percentile(q));
+        EXPECT_NEAR(approx, exact, exact * 0.04 + 1) << q;
+    }
+    EXPECT_EQ(snap.percentile(1.0), values.back());
+
+    LatencyHistogram::Snapshot empty;
+    EXPECT_EQ(empty.percentile(0.99), 0u);
+    EXPECT_EQ(empty.mean(), 0.0);
+}
+
+TEST(LatencyHistogramTest, SnapshotsMerge) {
+    LatencyHistogram a, b;
+    for (uint64_t i = 1; i <= 100; ++i) a.record(i);
+    b.record(5000);
+
+    LatencyHistogram::Snapshot sa, sb;
+    a.add_to(sa);
+    b.add_to(sb);
+    sa.merge(sb);
+    EXPECT_EQ(sa.count, 101u);
+    EXPECT_EQ(sa.sum, 5050u + 5000u);
+    EXPECT_EQ(sa.max, 5000u);
+    EXPECT_EQ(sa.percentile(1.0), 5000u);
+}
+
+// ============================================================================
+// Clock Tests
+// ============================================================================
+
+TEST(ClockTest, TracksRealtime) {
+    Clock::calibrate();
+    EXPECT_GT(Clock::ticks_per_ns(), 0.0);
+
+    const uint64_t tsc = Clock::now_ns();
+    const uint64_t ref = Clock::realtime_ns();
+    const uint64_t diff = tsc > ref ? tsc - ref : ref - tsc;
+    EXPECT_LT(diff, 1'000'000u);                   // Within 1 ms
+
+    const uint64_t start = Clock::ticks();
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    const uint64_t elapsed = Clock::elapsed_ns(start);
+    EXPECT_GE(elapsed, 4'500'000u);
+    EXPECT_LT(elapsed, 500'000'000u);
+}
+
+// ============================================================================
+// Recorder Tests
+// ============================================================================
+
+TEST(TelemetryTest, SnapshotMergesThreads) {
+    Snapshot before;
+    snapshot(before);
+    const uint64_t base = before[static_cast<size_t>(Stage::SIGN)].count;
+
+    constexpr int THREADS = 4;
+    constexpr int PER_THREAD = 1000;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; ++t) {
+        threads.emplace_back([t] {
+            for (int i = 0; i < PER_THREAD; ++i) record(Stage::SIGN, 1000 + t);
+        });
+    }
+    for (auto& thread : threads) thread.join();
+
+    Snapshot after;
+    snapshot(after);
+    const auto& sign = after[static_cast<size_t>(Stage::SIGN)];
+    EXPECT_EQ(sign.count, base + THREADS * PER_THREAD);
+    EXPECT_GE(sign.max, 1000u + THREADS - 1);
+    EXPECT_GE(registered_threads(), static_cast<size_t>(THREADS));
+}
+
+TEST(TelemetryTest, StageTimerRecordsScope) {
+    Snapshot before;
+    snapshot(before);
+    { StageTimer timer(Stage::COMPOSE); }
+    record_age(Stage::QUEUE_POP, 0);                // No stamp: dropped
+
+    Snapshot after;
+    snapshot(after);
+    EXPECT_EQ(after[static_cast<size_t>(Stage::COMPOSE)].count,
+              before[static_cast<size_t>(Stage::COMPOSE)].count + 1);
+    EXPECT_EQ(after[static_cast<size_t>(Stage::QUEUE_POP)].count,
+              before[static_cast<size_t>(Stage::QUEUE_POP)].count);
+}
+
+TEST(TelemetryTest, RendersPrometheusText) {
+    record(Stage::SCAN, 2500);
+    Snapshot snap;
+    snapshot(snap);
+
+    const std::string text = render_prometheus(snap);
+    EXPECT_NE(text.find("# TYPE matrix_hotpath_stage_latency_ns summary"), std::string::npos);
+    for (size_t s = 0; s < STAGE_COUNT; ++s) {
+        const std::string stage = stage_name(static_cast<Stage>(s));
+        EXPECT_NE(text.find("{stage=\"" + stage + "\",quantile=\"0.999\"}"), std::string::npos) << stage;
+        EXPECT_NE(text.find("_count{stage=\"" + stage + "\"}"), std::string::npos) << stage;
+    }
+
+    const std::string path = ::testing::TempDir() + "matrix_telemetry_test.prom";
+    ASSERT_TRUE(write_prometheus_file(path, snap));
+    std::ifstream in(path);
+    std::stringstream contents;
+    contents << in.rdbuf();
+    EXPECT_EQ(contents.str(), text);
+    std::remove(path.c_str());
+
+    EXPECT_FALSE(write_prometheus_file("/nonexistent-dir/metrics.prom", snap));
+}
+
+} // namespace
@@ -0,0 +1,530 @@
+/**
+ * Unit tests for transaction composition
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "memory/Arena.hpp"
+#include "telemetry/Telemetry.hpp"
+#include "tx/Composer.hpp"
+#include "tx/RouteCache.hpp"
+#include "tx/SpeculativeSigner.hpp"
+
+using namespace matrix;
+using namespace matrix::tx;
+
+namespace {
+
+std::string hex(std::span<const uint8_t> bytes) {
+    static constexpr char DIGITS[] = "0123456789abcdef";
+    std::string out;
+    for (uint8_t b : bytes) {
+        out += DIGITS[b >> 4];
+        out += DIGITS[b & 0xF];
+    }
+    return out;
+}
+
+std::array<uint8_t, 20> address_of(uint8_t fill) {
+    std::array<uint8_t, 20> a;
+    a.fill(fill);
+    return a;
+}
+
+uint64_t word_u64(std::span<const uint8_t> bytes, size_t offset) {
+    uint64_t v = 0;
+    for (size_t i = 24; i < 32; ++i) v = (v << 8) | bytes[offset + i];
+    return v;
+}
+
+ComposerConfig test_config() {
+    ComposerConfig config;
+    config.chain_id = 42161;
+    config.flash_loan_pool = address_of(0xAA);
+    config.executor = address_of(0xEE);
+    return config;
+}
+
+} // namespace
+
+// ============================================================================
+// RLP
+// ============================================================================
+
+TEST(ComposerTest, LegacySigningPayloadMatchesEip155Example) {
+    // EIP-155 example transaction
+    RawTransaction tx;
+    tx.type = TxType::LEGACY;
+    tx.chain_id = 1;
+    tx.nonce = 9;
+    tx.max_fee_per_gas = 20'000'000'000ULL;
+    tx.gas_limit = 21000;
+    tx.to = address_of(0x35);
+    tx.value = 1'000'000'000'000'000'000ULL;
+
+    uint8_t buf[256];
+    ByteWriter out(buf, sizeof(buf));
+    const Composer composer;
+    EXPECT_EQ(hex(composer.encode_signing_payload(tx, out)),
+              "ec098504a817c800825208943535353535353535353535353535353535353535880de0b6b3a764000080018080");
+
+    tx.v = 0;   // Parity; encoded as 37 on chain 1
+    const uint8_t r[] = {0x28, 0xef, 0x61, 0x34, 0x0b, 0xd9, 0x39, 0xbc, 0x21, 0x95, 0xfe, 0x53, 0x75, 0x67, 0x86, 0x60,
+                         0x03, 0xe1, 0xa1, 0x5d, 0x3c, 0x71, 0xff, 0x63, 0xe1, 0x59, 0x06, 0x20, 0xaa, 0x63, 0x62, 0x76};
+    const uint8_t s[] = {0x67, 0xcb, 0xe9, 0xd8, 0x99, 0x7f, 0x76, 0x1a, 0xec, 0xb7, 0x03, 0x30, 0x4b, 0x38, 0x00, 0xcc,
+                         0xf5, 0x55, 0xc9, 0xf3, 0xdc, 0x64, 0x21, 0x4b, 0x29, 0x7f, 0xb1, 0x96, 0x6a, 0x3b, 0x6d, 0x83};
+    std::memcpy(tx.r.data(), r, 32);
+    std::memcpy(tx.s.data(), s, 32);
+    out.clear();
+    EXPECT_EQ(hex(composer.encode_rlp(tx, out)),
+              "f86c098504a817c800825208943535353535353535353535353535353535353535880de0b6b3a76400008025"
+              "a028ef61340bd939bc2195fe537567866003e1a15d3c71ff63e1590620aa636276"
+              "a067cbe9d8997f761aecb703304b3800ccf555c9f3dc64214b297fb1966a3b6d83");
+}
+
+TEST(ComposerTest, Eip1559EnvelopeWithAccessList) {
+    std::array<uint8_t, 32> key1, key2;
+    key1.fill(0x01);
+    key2.fill(0x02);
+    const std::array<uint8_t, 32> keys[] = {key1, key2};
+    const AccessListEntry access_list[] = {{address_of(0xAA), keys}, {address_of(0xBB), {}}};
+    std::vector<uint8_t> data(60);
+    for (size_t i = 0; i < data.size(); ++i) data[i] = static_cast<uint8_t>(i);
+
+    RawTransaction tx;
+    tx.chain_id = 42161;
+    tx.nonce = 7;
+    tx.max_priority_fee_per_gas = 1'500'000'000;
+    tx.max_fee_per_gas = 30'000'000'000ULL;
+    tx.gas_limit = 400'000;
+    tx.to = address_of(0x35);
+    tx.data = data;
+    tx.access_list = access_list;
+
+    const std::string body =
+        "82a4b1078459682f008506fc23ac0083061a8094353535353535353535353535353535353535353580"
+        "b83c000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f202122232425262728292a2b2c2d2e2f"
+        "303132333435363738393a3b"
+        "f872f85994aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaf842"
+        "a00101010101010101010101010101010101010101010101010101010101010101"
+        "a00202020202020202020202020202020202020202020202020202020202020202"
+        "d694bbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbbc0";
+
+    uint8_t buf[512];
+    ByteWriter out(buf, sizeof(buf));
+    const Composer composer;
+    EXPECT_EQ(hex(composer.encode_signing_payload(tx, out)), "02f8db" + body);
+
+    // r with leading zero bytes is encoded as the stripped scalar
+    tx.v = 1;
+    tx.r.fill(0x11);
+    tx.r[0] = tx.r[1] = 0;
+    tx.s.fill(0x22);
+    tx.s[0] = 0x7f;
+    out.clear();
+    EXPECT_EQ(hex(composer.encode_rlp(tx, out)),
+              "02f9011c" + body + "01" + "9e" + std::string(60, '1') + "a07f" + std::string(62, '2'));
+}
+
+TEST(ComposerTest, EncodersFailCleanlyWhenTheBufferIsFull) {
+    RawTransaction tx;
+    tx.to = address_of(0x35);
+
+    uint8_t buf[16];
+    ByteWriter out(buf, sizeof(buf));
+    const Composer composer;
+    EXPECT_TRUE(composer.encode_rlp(tx, out).empty());
+    EXPECT_TRUE(composer.encode_uniswap_swap(address_of(1), address_of(2), 500, 1, 1, out).empty());
+    EXPECT_EQ(out.size(), 0u);   // Nothing half-written
+}
+
+// ============================================================================
+// ABI calldata
+// ============================================================================
+
+TEST(ComposerTest, SwapCallPatchesTheTemplate) {
+    const Composer composer(test_config());
+    uint8_t buf[512];
+    ByteWriter out(buf, sizeof(buf));
+
+    const auto call = composer.encode_uniswap_swap(address_of(0x01), address_of(0x02), 500, 1'000'000, 990'000, out);
+    ASSERT_EQ(call.size(), Composer::SWAP_CALL_BYTES);
+    EXPECT_EQ(hex(call.first(4)), "04e45aaf");
+    EXPECT_EQ(hex(call.subspan(4, 32)), std::string(24, '0') + hex(address_of(0x01)));
+    EXPECT_EQ(word_u64(call, 4 + 2 * 32), 500u);
+    EXPECT_EQ(hex(call.subspan(4 + 3 * 32 + 12, 20)), std::string(40, 'e'));   // Recipient = executor
+    EXPECT_EQ(word_u64(call, 4 + 4 * 32), 1'000'000u);
+    EXPECT_EQ(word_u64(call, 4 + 5 * 32), 990'000u);
+    EXPECT_EQ(hex(call.subspan(4 + 6 * 32, 32)), std::string(64, '0'));   // No price limit
+}
+
+TEST(ComposerTest, ArbitrageCalldataIsFlashLoanOverMulticallOfSwaps) {
+    const Composer composer(test_config());
+    const SwapParams swaps[] = {
+        {address_of(0x51), address_of(0x01), address_of(0x02), 1'000'000, 990'000, 500},
+        {address_of(0x52), address_of(0x02), address_of(0x03), 990'000, 980'000, 3000},
+        {address_of(0x53), address_of(0x03), address_of(0x01), 980'000, 1'000'001, 100},
+    };
+    const FlashLoanParams flash_loan{address_of(0x01), 1'000'000};
+
+    memory::Arena arena(1 << 20);
+    ByteWriter calldata(arena, 4096);
+    const auto tx = composer.compose_arbitrage(flash_loan, swaps, 600'000, 1'000'000, 2'000'000'000, calldata);
+    ASSERT_TRUE(tx.has_value());
+    EXPECT_EQ(tx->chain_id, 42161u);
+    EXPECT_EQ(tx->to, address_of(0xAA));
+    EXPECT_EQ(tx->gas_limit, 600'000u);
+    EXPECT_EQ(tx->data.size(), Composer::arbitrage_calldata_bytes(3));
+    EXPECT_EQ(tx->data.size() % 32, 4u);
+
+    // Same bytes as encoding the pieces one by one
+    uint8_t buf[4096];
+    ByteWriter pieces(buf, sizeof(buf));
+    std::vector<std::span<const uint8_t>> calls;
+    for (const SwapParams& swap : swaps) {
+        calls.push_back(composer.encode_uniswap_swap(swap.token_in, swap.token_out, swap.fee,
+                                                     swap.amount_in, swap.min_amount_out, pieces));
+    }
+    const auto multicall = composer.encode_multicall(calls, pieces);
+    const auto expected = composer.encode_aave_flash_loan(address_of(0xEE), flash_loan.asset, flash_loan.amount,
+                                                          multicall, pieces);
+    ASSERT_FALSE(expected.empty());
+    EXPECT_EQ(hex(tx->data), hex(expected));
+
+    // Spot-check the ABI layout
+    const auto data = tx->data;
+    EXPECT_EQ(hex(data.first(4)), "42b0b77c");
+    EXPECT_EQ(word_u64(data, 4 + 3 * 32), 5u * 32);                  // params offset
+    EXPECT_EQ(word_u64(data, 4 + 5 * 32), multicall.size());          // params length
+    const auto params = data.subspan(Composer::FLASH_LOAN_HEAD_BYTES);
+    EXPECT_EQ(hex(params.first(4)), "ac9650d8");
+    EXPECT_EQ(word_u64(params, 4), 32u);
+    EXPECT_EQ(word_u64(params, 36), 3u);
+    EXPECT_EQ(word_u64(params, 68), 3u * 32);                         // Element offsets
+    EXPECT_EQ(word_u64(params, 100), 3u * 32 + 288);
+    EXPECT_EQ(word_u64(params, 132), 3u * 32 + 2 * 288);
+    EXPECT_EQ(word_u64(params, 68 + 96), Composer::SWAP_CALL_BYTES);  // First element length
+
+    // A second transaction reuses the same writer, nothing else allocated
+    const size_t used = calldata.size();
+    ASSERT_TRUE(composer.compose_arbitrage(flash_loan, swaps, 600'000, 1'000'000, 2'000'000'000, calldata));
+    EXPECT_EQ(calldata.size(), 2 * used);
+    EXPECT_FALSE(composer.compose_arbitrage(flash_loan, {}, 1, 1, 1, calldata).has_value());
+}
+
+TEST(ComposerTest, DeadlineSelectsMulticallWithDeadline) {
+    const Composer composer(test_config());
+    const SwapParams swaps[] = {
+        {address_of(0x51), address_of(0x01), address_of(0x02), 1'000'000, 990'000, 500},
+        {address_of(0x52), address_of(0x02), address_of(0x01), 990'000, 1'000'001, 3000},
+    };
+    const FlashLoanParams flash_loan{address_of(0x01), 1'000'000};
+    constexpr uint64_t DEADLINE = 1'700'000'000;
+
+    uint8_t buf[4096];
+    ByteWriter calldata(buf, sizeof(buf));
+    const auto tx = composer.compose_arbitrage(flash_loan, swaps, 1, 1, 1, calldata, DEADLINE);
+    ASSERT_TRUE(tx.has_value());
+    EXPECT_EQ(tx->data.size(), Composer::arbitrage_calldata_bytes(2, true));
+
+    const auto params = tx->data.subspan(Composer::FLASH_LOAN_HEAD_BYTES);
+    EXPECT_EQ(hex(params.first(4)), "5ae401dc");
+    EXPECT_EQ(word_u64(params, 4), DEADLINE);
+    EXPECT_EQ(word_u64(params, 36), 64u);    // bytes[] offset past the deadline word
+    EXPECT_EQ(word_u64(params, 68), 2u);
+    EXPECT_EQ(word_u64(tx->data, Composer::swap_word_offset(2, 1, Composer::SWAP_AMOUNT_IN_WORD, true)), 990'000u);
+
+    uint8_t piece_buf[4096];
+    ByteWriter pieces(piece_buf, sizeof(piece_buf));
+    std::vector<std::span<const uint8_t>> calls;
+    for (const SwapParams& swap : swaps) {
+        calls.push_back(composer.encode_uniswap_swap(swap.token_in, swap.token_out, swap.fee,
+                                                     swap.amount_in, swap.min_amount_out, pieces));
+    }
+    const auto multicall = composer.encode_multicall(calls, pieces, DEADLINE);
+    const auto expected = composer.encode_aave_flash_loan(address_of(0xEE), flash_loan.asset, flash_loan.amount,
+                                                          multicall, pieces);
+    EXPECT_EQ(hex(tx->data), hex(expected));
+}
+
+// ============================================================================
+// Route cache
+// ============================================================================
+
+namespace {
+
+std::vector<SwapParams> route_of(uint8_t first_pool, size_t hops) {
+    std::vector<SwapParams> swaps;
+    for (size_t i = 0; i < hops; ++i) {
+        SwapParams swap{};
+        swap.pool = address_of(static_cast<uint8_t>(first_pool + i));
+        swap.token_in = address_of(static_cast<uint8_t>(1 + i));
+        swap.token_out = address_of(static_cast<uint8_t>(1 + (i + 1) % hops));
+        swap.amount_in = 1'000'000 - i;
+        swap.min_amount_out = 990'000 - i;
+        swap.fee = i % 2 == 0 ? 500 : 3000;
+        swaps.push_back(swap);
+    }
+    return swaps;
+}
+
+// Cached and direct composition must agree byte for byte
+void expect_same(RouteCache& cache, const Composer& composer, const FlashLoanParams& flash_loan,
+                 std::span<const SwapParams> swaps, uint64_t deadline) {
+    uint8_t a[4096], b[4096];
+    ByteWriter cached_out(a, sizeof(a)), direct_out(b, sizeof(b));
+    const auto cached = cache.compose_arbitrage(flash_loan, swaps, 600'000, 7, 9, cached_out, deadline);
+    const auto direct = composer.compose_arbitrage(flash_loan, swaps, 600'000, 7, 9, direct_out, deadline);
+    ASSERT_TRUE(cached.has_value());
+    ASSERT_TRUE(direct.has_value());
+    EXPECT_EQ(hex(cached->data), hex(direct->data));
+    EXPECT_EQ(cached->to, direct->to);
+    EXPECT_EQ(cached->gas_limit, direct->gas_limit);
+    EXPECT_EQ(cached->max_fee_per_gas, direct->max_fee_per_gas);
+}
+
+} // namespace
+
+TEST(RouteCacheTest, RepeatedRoutesArePatchedFromTheTemplate) {
+    const Composer composer(test_config());
+    memory::Arena arena(1 << 20);
+    RouteCache cache(composer, arena, 16);
+
+    auto swaps = route_of(0x50, 3);
+    expect_same(cache, composer, {address_of(0x01), 1'000'000}, swaps, 0);
+    EXPECT_EQ(cache.stats().misses, 1u);
+    EXPECT_EQ(cache.size(), 1u);
+
+    // New amounts on the same route: a hit, still identical to direct composition
+    for (uint64_t k = 1; k <= 3; ++k) {
+        for (auto& swap : swaps) {
+            swap.amount_in += 12345 * k;
+            swap.min_amount_out += 777 * k;
+        }
+        expect_same(cache, composer, {address_of(0x01), 1'000'000 + k}, swaps, 0);
+    }
+    EXPECT_EQ(cache.stats().hits, 3u);
+    EXPECT_EQ(cache.stats().misses, 1u);
+
+    // The deadline variant and a different hop count are separate templates
+    expect_same(cache, composer, {address_of(0x01), 5}, swaps, 1'700'000'000);
+    expect_same(cache, composer, {address_of(0x01), 5}, swaps, 1'700'000'060);
+    expect_same(cache, composer, {address_of(0x01), 5}, route_of(0x50, 2), 0);
+    EXPECT_EQ(cache.stats().misses, 3u);
+    EXPECT_EQ(cache.stats().hits, 4u);
+    EXPECT_EQ(cache.stats().uncached, 0u);
+}
+
+TEST(RouteCacheTest, EachCompositionIsTimedOnce) {
+    const Composer composer(test_config());
+    memory::Arena arena(1 << 20);
+    RouteCache cache(composer, arena, 16);
+    const auto compose_samples = [] {
+        telemetry::Snapshot snap;
+        telemetry::snapshot(snap);
+        return snap[static_cast<size_t>(telemetry::Stage::COMPOSE)].count;
+    };
+
+    uint8_t buf[4096];
+    const auto swaps = route_of(0x50, 3);
+    for (int call = 0; call < 2; ++call) {                  // Miss, then hit
+        ByteWriter out(buf, sizeof(buf));
+        const uint64_t before = compose_samples();
+        ASSERT_TRUE(cache.compose_arbitrage({address_of(0x01), 1}, swaps, 1, 1, 1, out).has_value());
+        EXPECT_EQ(compose_samples(), before + 1);
+    }
+    EXPECT_EQ(cache.stats().misses, 1u);
+    EXPECT_EQ(cache.stats().hits, 1u);
+}
+
+TEST(RouteCacheTest, RouteIdentityIncludesDexAndTokens) {
+    const Composer composer(test_config());
+    memory::Arena arena(1 << 20);
+    RouteCache cache(composer, arena, 16);
+
+    const auto swaps = route_of(0x50, 2);
+    expect_same(cache, composer, {address_of(0x01), 1}, swaps, 0);
+
+    auto other_dex = swaps;
+    other_dex[1].dex = orderbook::DexId::PANCAKESWAP;
+    expect_same(cache, composer, {address_of(0x01), 1}, other_dex, 0);
+    EXPECT_EQ(cache.stats().misses, 2u);
+
+    // Same key (pools, DEXes, asset) but a different fee tier: never patched
+    // from the wrong template
+    auto other_fee = swaps;
+    other_fee[0].fee = 100;
+    expect_same(cache, composer, {address_of(0x01), 1}, other_fee, 0);
+    EXPECT_EQ(cache.stats().uncached, 1u);
+    EXPECT_EQ(cache.stats().hits, 0u);
+}
+
+TEST(RouteCacheTest, FallsBackToDirectCompositionWhenItCannotCache) {
+    const Composer composer(test_config());
+    memory::Arena arena(1 << 20);
+    RouteCache cache(composer, arena, 1);
+
+    expect_same(cache, composer, {address_of(0x01), 1}, route_of(0x50, 3), 0);
+    expect_same(cache, composer, {address_of(0x01), 1}, route_of(0x60, 3), 0);                       // Full
+    expect_same(cache, composer, {address_of(0x01), 1}, route_of(0x70, RouteCache::MAX_HOPS + 1), 0); // Too long
+    EXPECT_EQ(cache.stats().misses, 1u);
+    EXPECT_EQ(cache.stats().uncached, 2u);
+
+    // Too-small output buffer fails without consuming it
+    uint8_t buf[64];
+    ByteWriter small(buf, sizeof(buf));
+    EXPECT_FALSE(cache.compose_arbitrage({address_of(0x01), 1}, route_of(0x50, 3), 1, 1, 1, small).has_value());
+    EXPECT_EQ(small.size(), 0u);
+}
+
+// ============================================================================
+// Keccak
+// ============================================================================
+
+TEST(KeccakTest, MatchesReferenceDigests) {
+    std::vector<uint8_t> long_message(512);
+    for (size_t i = 0; i < long_message.size(); ++i) long_message[i] = static_cast<uint8_t>(i);
+    const uint8_t abc[] = {'a', 'b', 'c'};
+    const std::vector<uint8_t> zeros_135(135), zeros_136(136);
+
+    EXPECT_EQ(hex(keccak256({})), "c5d2460186f7233c927e7db2dcc703c0e500b653ca82273b7bfad8045d85a470");
+    EXPECT_EQ(hex(keccak256(abc)), "4e03657aea45a94fc7d47ba826c8d667c0d1e6e33a64a036ec44f58fa12d6c45");
+    EXPECT_EQ(hex(keccak256(long_message)), "f55ba327291604f0e5be6651752398b7be2331aad65f5763ce067df95cc13be1");
+    // Padding byte in the last rate byte / a whole extra block
+    EXPECT_EQ(hex(keccak256(zeros_135)), "29e3704feeca7fb9ba229f0fa04d9b36449cf3ad6e1d85d9cfff3a10df9abc3e");
+    EXPECT_EQ(hex(keccak256(zeros_136)), "3a5912a7c5faa06ee4fe906253e339467a9ce87d533c65be3c15cb231cdb25f9");
+}
+
+TEST(KeccakTest, FourWayMatchesScalarForMixedLengths) {
+    std::vector<uint8_t> data(2000);
+    for (size_t i = 0; i < data.size(); ++i) data[i] = static_cast<uint8_t>(i * 7 + 3);
+    const std::span<const uint8_t> all(data);
+
+    const size_t lengths[][4] = {{0, 1, 135, 136}, {1500, 3, 272, 2000}, {64, 64, 64, 64}};
+    for (const auto& set : lengths) {
+        const std::array<std::span<const uint8_t>, 4> inputs = {
+            all.first(set[0]), all.subspan(1, set[1]), all.first(set[2]), all.first(set[3])};
+        std::array<Hash256, 4> out;
+        keccak256_x4(inputs, out);
+        for (size_t j = 0; j < 4; ++j) EXPECT_EQ(hex(out[j]), hex(keccak256(inputs[j]))) << set[j];
+    }
+}
+
+// ============================================================================
+// Signer
+// ============================================================================
+
+namespace {
+
+std::array<uint8_t, 32> key_of(uint8_t fill) {
+    std::array<uint8_t, 32> key;
+    key.fill(fill);
+    return key;
+}
+
+RawTransaction eip155_example() {
+    RawTransaction tx;
+    tx.type = TxType::LEGACY;
+    tx.chain_id = 1;
+    tx.nonce = 9;
+    tx.max_fee_per_gas = 20'000'000'000ULL;
+    tx.gas_limit = 21000;
+    tx.to = address_of(0x35);
+    tx.value = 1'000'000'000'000'000'000ULL;
+    return tx;
+}
+
+} // namespace
+
+TEST(SignerTest, SignsTheEip155Example) {
+    RawTransaction tx = eip155_example();
+    const Composer composer;
+    EXPECT_EQ(hex(composer.hash_for_signing(tx)), "daf5a779ae972f972197303d7b574746c7ef83eadac0f2791ad23db92e4c8e53");
+
+    const Signer signer(key_of(0x46));
+    EXPECT_EQ(hex(signer.address()), "9d8a62f656a8d1615c1294fd71e9cfb3e4855a4f");
+
+    signer.sign(tx);
+    EXPECT_EQ(tx.v, 0);
+    EXPECT_EQ(hex(tx.r), "28ef61340bd939bc2195fe537567866003e1a15d3c71ff63e1590620aa636276");
+    EXPECT_EQ(hex(tx.s), "67cbe9d8997f761aecb703304b3800ccf555c9f3dc64214b297fb1966a3b6d83");
+
+    uint8_t buf[256];
+    ByteWriter out(buf, sizeof(buf));
+    EXPECT_EQ(hex(composer.encode_rlp(tx, out)),
+              "f86c098504a817c800825208943535353535353535353535353535353535353535880de0b6b3a76400008025"
+              "a028ef61340bd939bc2195fe537567866003e1a15d3c71ff63e1590620aa636276"
+              "a067cbe9d8997f761aecb703304b3800ccf555c9f3dc64214b297fb1966a3b6d83");
+}
+
+TEST(SignerTest, DeterministicLowSSignatures) {
+    std::array<uint8_t, 32> one{};
+    one[31] = 1;
+    const Signer signer(one);
+    EXPECT_EQ(hex(signer.address()), "7e5f4552091a69125d5dfcb7b8c2659029395bdf");
+
+    const uint8_t text[] = {'m', 'a', 't', 'r', 'i', 'x'};
+    const auto sig = signer.sign_hash(keccak256(text));
+    EXPECT_EQ(sig.v, 1);
+    EXPECT_EQ(hex(sig.r), "0df1100a17194ee56d3fadc82bc52d619b81474f3e4741a9f8678f22b20faffe");
+    EXPECT_EQ(hex(sig.s), "73cc5b4a544c6d35343ecfe84b2e3cb93dd5f29c223e25e36c9d4129b5dd2382");
+    EXPECT_LT(sig.s[0], 0x80);
+}
+
+TEST(SignerTest, RejectsKeysOutsideTheGroupOrder) {
+    EXPECT_THROW(Signer(key_of(0x00)), std::invalid_argument);
+    EXPECT_THROW(Signer(key_of(0xFF)), std::invalid_argument);
+    // n itself
+    const std::array<uint8_t, 32> order = {
+        0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xfe,
+        0xba, 0xae, 0xdc, 0xe6, 0xaf, 0x48, 0xa0, 0x3b, 0xbf, 0xd2, 0x5e, 0x8c, 0xd0, 0x36, 0x41, 0x41};
+    EXPECT_THROW(Signer{order}, std::invalid_argument);
+    auto below = order;
+    below[31] = 0x40;
+    EXPECT_NO_THROW(Signer{below});
+}
+
+TEST(SpeculativeSignerTest, SignsEveryCandidateLikeTheSigner) {
+    const Composer composer(test_config());
+    const Signer signer(key_of(0x46));
+    const SwapParams swaps[] = {
+        {address_of(0x51), address_of(0x01), address_of(0x02), 1'000'000, 990'000, 500},
+        {address_of(0x52), address_of(0x02), address_of(0x01), 990'000, 1'000'001, 3000},
+    };
+
+    for (size_t workers : {0, 2}) {
+        SpeculativeSigner speculative(signer, workers);
+        for (int round = 0; round < 3; ++round) {
+            memory::Arena arena(1 << 20);
+            ByteWriter calldata(arena, 64 * 1024);
+            std::vector<RawTransaction> candidates;
+            for (uint64_t k = 0; k < 6; ++k) {
+                auto tx = composer.compose_arbitrage({address_of(0x01), 1'000'000 + k + round}, swaps,
+                                                     600'000, 1'000'000, 2'000'000'000, calldata);
+                ASSERT_TRUE(tx.has_value());
+                tx->nonce = 40 + k;
+                candidates.push_back(*tx);
+            }
+            std::vector<RawTransaction> expected = candidates;
+            for (auto& tx : expected) signer.sign(tx);
+
+            ASSERT_TRUE(speculative.start(candidates));
+            const RawTransaction& winner = speculative.wait(4);
+            EXPECT_EQ(winner.r, expected[4].r);
+            speculative.finish();
+            for (size_t i = 0; i < candidates.size(); ++i) {
+                EXPECT_EQ(candidates[i].v, expected[i].v) << i;
+                EXPECT_EQ(candidates[i].r, expected[i].r) << i;
+                EXPECT_EQ(candidates[i].s, expected[i].s) << i;
+            }
+        }
+
+        std::vector<RawTransaction> too_many(SpeculativeSigner::MAX_CANDIDATES + 1);
+        EXPECT_FALSE(speculative.start(too_many));
+    }
+}